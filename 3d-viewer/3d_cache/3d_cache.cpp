@@ -29,6 +29,8 @@
 #include <fstream>
 #include <utility>
 #include <iterator>
+#include <mutex>
+#include <set>
 
 #include <wx/datetime.h>
 #include <wx/filename.h>
@@ -47,8 +49,11 @@
 #include <glm/ext.hpp>
 
 #include "common.h"
+#include "profile.h"
+#include "thread_pool.h"
 #include "3d_cache.h"
 #include "3d_info.h"
+#include "3d_model_file.h"
 #include "sg/scenegraph.h"
 #include "filename_resolver.h"
 #include "3d_plugin_manager.h"
@@ -57,7 +62,9 @@
 
 #define MASK_3D_CACHE "3D_CACHE"
 
-static wxCriticalSection lock3D_cache;
+// guards the list of plugins; the models are loaded without it: the plugin
+// loader itself runs the plugins which are not thread safe one at a time
+static std::mutex lock3D_plugins;
 
 
 static bool isSHA1Same( const unsigned char* shaA, const unsigned char* shaB )
@@ -76,11 +83,35 @@ static bool checkTag( const char* aTag, void* aPluginMgrPtr )
         return false;
 
     S3D_PLUGIN_MANAGER *pp = (S3D_PLUGIN_MANAGER*) aPluginMgrPtr;
+    std::lock_guard<std::mutex> pluginLock( lock3D_plugins );
 
     return pp->CheckTag( aTag );
 }
 
 
+// the data of checkCacheTag(): keeps the tag of the cache file it accepts
+struct CACHE_TAG_CHECK
+{
+    S3D_PLUGIN_MANAGER* plugins;
+    std::string         tag;
+};
+
+
+static bool checkCacheTag( const char* aTag, void* aTagCheckPtr )
+{
+    if( NULL == aTag || NULL == aTagCheckPtr )
+        return false;
+
+    CACHE_TAG_CHECK* tc = (CACHE_TAG_CHECK*) aTagCheckPtr;
+
+    if( !checkTag( aTag, tc->plugins ) )
+        return false;
+
+    tc->tag = aTag;
+    return true;
+}
+
+
 static const wxString sha1ToWXString( const unsigned char* aSHA1Sum )
 {
     unsigned char uc;
@@ -131,11 +162,17 @@ public:
     void SetSHA1( const unsigned char* aSHA1Sum );
     const wxString GetCacheBaseName( void );
 
+    // frees the render data, whether it was built or read from a model file
+    void FreeRenderData( void );
+
+    wxString      fileName;     // full path of the model file
     wxDateTime    modTime;      // file modification time
     unsigned char sha1sum[20];
     std::string   pluginInfo;   // PluginName:Version string
-    SCENEGRAPH*   sceneData;
+    SCENEGRAPH*   sceneData;    // may be NULL if renderData was read from modelFile
     S3DMODEL*     renderData;
+    std::unique_ptr<S3D_MODEL_FILE> modelFile;   // holds renderData if read from a file
+    std::mutex    lock;         // held while the data above is read or loaded
 };
 
 
@@ -152,8 +189,7 @@ S3D_CACHE_ENTRY::~S3D_CACHE_ENTRY()
     if( NULL != sceneData )
         delete sceneData;
 
-    if( NULL != renderData )
-        S3D::Destroy3DModel( &renderData );
+    FreeRenderData();
 }
 
 
@@ -168,6 +204,7 @@ void S3D_CACHE_ENTRY::SetSHA1( const unsigned char* aSHA1Sum )
     }
 
     memcpy( sha1sum, aSHA1Sum, 20 );
+    m_CacheBaseName.clear();
     return;
 }
 
@@ -181,7 +218,24 @@ const wxString S3D_CACHE_ENTRY::GetCacheBaseName( void )
 }
 
 
-S3D_CACHE::S3D_CACHE()
+void S3D_CACHE_ENTRY::FreeRenderData( void )
+{
+    if( modelFile )
+    {
+        // the model belongs to the model file
+        modelFile.reset();
+        renderData = NULL;
+    }
+    else if( NULL != renderData )
+    {
+        S3D::Destroy3DModel( &renderData );
+    }
+}
+
+
+S3D_CACHE::S3D_CACHE() :
+    m_PluginLoads( 0 ),
+    m_PluginTime( 0 )
 {
     m_DirtyCache = false;
     m_FNResolver = new FILENAME_RESOLVER;
@@ -205,11 +259,9 @@ S3D_CACHE::~S3D_CACHE()
 }
 
 
-SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr )
+S3D_CACHE_ENTRY* S3D_CACHE::load( const wxString& aModelFile,
+                                  std::unique_lock<std::mutex>& aEntryLock )
 {
-    if( aCachePtr )
-        *aCachePtr = NULL;
-
     wxString full3Dpath = m_FNResolver->ResolvePath( aModelFile );
 
     if( full3Dpath.empty() )
@@ -220,134 +272,164 @@ SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCach
         return NULL;
     }
 
-    // check cache if file is already loaded
-    wxCriticalSectionLocker lock( lock3D_cache );
-    std::map< wxString, S3D_CACHE_ENTRY*, rsort_wxString >::iterator mi;
-    mi = m_CacheMap.find( full3Dpath );
+    return loadEntry( full3Dpath, aEntryLock );
+}
 
-    if( mi != m_CacheMap.end() )
-    {
-        wxFileName fname( full3Dpath );
 
-        if( fname.FileExists() )    // Only check if file exists. If not, it will
-        {                           // use the same model in cache.
-            bool reload = false;
-            wxDateTime fmdate = fname.GetModificationTime();
+S3D_CACHE_ENTRY* S3D_CACHE::loadEntry( const wxString& aFullPath,
+                                       std::unique_lock<std::mutex>& aEntryLock )
+{
+    bool created = false;
+    S3D_CACHE_ENTRY* ep = checkCache( aFullPath, aEntryLock, &created );
 
-            if( fmdate != mi->second->modTime )
-            {
-                unsigned char hashSum[20];
-                getSHA1( full3Dpath, hashSum );
-                mi->second->modTime = fmdate;
-
-                if( !isSHA1Same( hashSum, mi->second->sha1sum ) )
-                {
-                    mi->second->SetSHA1( hashSum );
-                    reload = true;
-                }
-            }
+    // a new entry was just loaded
+    if( NULL == ep || created )
+        return ep;
 
-            if( reload )
-            {
-                if( NULL != mi->second->sceneData )
-                {
-                    S3D::DestroyNode( mi->second->sceneData );
-                    mi->second->sceneData = NULL;
-                }
+    wxFileName fname( aFullPath );
 
-                if( NULL != mi->second->renderData )
-                    S3D::Destroy3DModel( &mi->second->renderData );
+    if( fname.FileExists() )    // Only check if file exists. If not, it will
+    {                           // use the same model in cache.
+        bool reload = false;
+        wxDateTime fmdate = fname.GetModificationTime();
 
-                mi->second->sceneData = m_Plugins->Load3DModel( full3Dpath, mi->second->pluginInfo );
+        if( fmdate != ep->modTime )
+        {
+            unsigned char hashSum[20];
+            getSHA1( aFullPath, hashSum );
+            ep->modTime = fmdate;
+
+            if( !isSHA1Same( hashSum, ep->sha1sum ) )
+            {
+                ep->SetSHA1( hashSum );
+                reload = true;
             }
         }
 
-        if( NULL != aCachePtr )
-            *aCachePtr = mi->second;
+        if( reload )
+        {
+            if( NULL != ep->sceneData )
+            {
+                S3D::DestroyNode( ep->sceneData );
+                ep->sceneData = NULL;
+            }
 
-        return mi->second->sceneData;
+            ep->FreeRenderData();
+            ep->sceneData = loadFromPlugins( aFullPath, ep->pluginInfo );
+        }
     }
 
-    // a cache item does not exist; search the Filename->Cachename map
-    return checkCache( full3Dpath, aCachePtr );
+    return ep;
 }
 
 
 SCENEGRAPH* S3D_CACHE::Load( const wxString& aModelFile )
 {
-    return load( aModelFile );
+    std::unique_lock<std::mutex> entryLock;
+    S3D_CACHE_ENTRY* ep = load( aModelFile, entryLock );
+
+    if( NULL == ep )
+        return NULL;
+
+    // only the render data was read from the model file
+    if( NULL == ep->sceneData && ep->modelFile )
+        loadSceneData( ep );
+
+    return ep->sceneData;
 }
 
 
-SCENEGRAPH* S3D_CACHE::checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr )
+S3D_CACHE_ENTRY* S3D_CACHE::checkCache( const wxString& aFileName,
+                                        std::unique_lock<std::mutex>& aEntryLock,
+                                        bool* aCreated )
 {
-    if( aCachePtr )
-        *aCachePtr = NULL;
-
-    unsigned char sha1sum[20];
+    S3D_CACHE_ENTRY* ep = NULL;
+    bool created = false;
 
-    if( !getSHA1( aFileName, sha1sum ) || m_CacheDir.empty() )
     {
-        // just in case we can't get a hash digest (for example, on access issues)
-        // or we do not have a configured cache file directory, we create an
-        // entry to prevent further attempts at loading the file
-        S3D_CACHE_ENTRY* ep = new S3D_CACHE_ENTRY;
-        m_CacheList.push_back( ep );
-        wxFileName fname( aFileName );
-        ep->modTime = fname.GetModificationTime();
-
-        if( m_CacheMap.insert( std::pair< wxString, S3D_CACHE_ENTRY* >
-            ( aFileName, ep ) ).second == false )
-        {
-            wxLogTrace( MASK_3D_CACHE, "%s:%s:%d\n * [BUG] duplicate entry in map file; key = '%s'",
-                        __FILE__, __FUNCTION__, __LINE__, aFileName );
+        std::lock_guard<std::mutex> cacheLock( m_CacheLock );
+        std::map< wxString, S3D_CACHE_ENTRY*, rsort_wxString >::iterator mi;
+        mi = m_CacheMap.find( aFileName );
 
-            m_CacheList.pop_back();
-            delete ep;
+        if( mi == m_CacheMap.end() )
+        {
+            // a cache item does not exist; the new entry is locked before it is
+            // visible, so that other threads wait until it is loaded
+            ep = new S3D_CACHE_ENTRY;
+            ep->fileName = aFileName;
+            aEntryLock = std::unique_lock<std::mutex>( ep->lock );
+
+            m_CacheList.push_back( ep );
+            m_CacheMap.insert( std::pair< wxString, S3D_CACHE_ENTRY* >( aFileName, ep ) );
+            created = true;
         }
         else
         {
-            if( aCachePtr )
-                *aCachePtr = ep;
-
+            ep = mi->second;
         }
-
-        return NULL;
     }
 
-    S3D_CACHE_ENTRY* ep = new S3D_CACHE_ENTRY;
-    m_CacheList.push_back( ep );
+    if( created )
+        loadModel( aFileName, ep );
+    else
+        aEntryLock = std::unique_lock<std::mutex>( ep->lock );
+
+    if( aCreated )
+        *aCreated = created;
+
+    return ep;
+}
+
+
+void S3D_CACHE::loadModel( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheItem )
+{
     wxFileName fname( aFileName );
-    ep->modTime = fname.GetModificationTime();
+    aCacheItem->modTime = fname.GetModificationTime();
 
-    if( m_CacheMap.insert( std::pair< wxString, S3D_CACHE_ENTRY* >
-                               ( aFileName, ep ) ).second == false )
-    {
-        wxLogTrace( MASK_3D_CACHE, "%s:%s:%d\n * [BUG] duplicate entry in map file; key = '%s'",
-                    __FILE__, __FUNCTION__, __LINE__, aFileName );
+    unsigned char sha1sum[20];
 
-        m_CacheList.pop_back();
-        delete ep;
-        return NULL;
+    if( !getSHA1( aFileName, sha1sum ) || m_CacheDir.empty() )
+    {
+        // just in case we can't get a hash digest (for example, on access issues)
+        // or we do not have a configured cache file directory, the empty entry
+        // prevents further attempts at loading the file
+        return;
     }
 
-    if( aCachePtr )
-        *aCachePtr = ep;
+    aCacheItem->SetSHA1( sha1sum );
 
-    ep->SetSHA1( sha1sum );
+    // the renderers only need the render data; the scene data is loaded by Load()
+    if( loadModelData( aCacheItem ) )
+        return;
+
+    loadSceneData( aCacheItem );
+}
 
-    wxString bname = ep->GetCacheBaseName();
+
+void S3D_CACHE::loadSceneData( S3D_CACHE_ENTRY* aCacheItem )
+{
+    wxString bname = aCacheItem->GetCacheBaseName();
     wxString cachename = m_CacheDir + bname + wxT( ".3dc" );
 
-    if( wxFileName::FileExists( cachename ) && loadCacheData( ep ) )
-        return ep->sceneData;
+    if( wxFileName::FileExists( cachename ) && loadCacheData( aCacheItem ) )
+        return;
 
-    ep->sceneData = m_Plugins->Load3DModel( aFileName, ep->pluginInfo );
+    aCacheItem->sceneData = loadFromPlugins( aCacheItem->fileName, aCacheItem->pluginInfo );
 
-    if( NULL != ep->sceneData )
-        saveCacheData( ep );
+    if( NULL != aCacheItem->sceneData )
+        saveCacheData( aCacheItem );
+}
 
-    return ep->sceneData;
+
+SCENEGRAPH* S3D_CACHE::loadFromPlugins( const wxString& aFileName, std::string& aPluginInfo )
+{
+    unsigned start = GetRunningMicroSecs();
+    SCENEGRAPH* sp = m_Plugins->Load3DModel( aFileName, aPluginInfo );
+
+    m_PluginLoads++;
+    m_PluginTime += GetRunningMicroSecs() - start;
+
+    return sp;
 }
 
 
@@ -439,11 +521,17 @@ bool S3D_CACHE::loadCacheData( S3D_CACHE_ENTRY* aCacheItem )
     if( NULL != aCacheItem->sceneData )
         S3D::DestroyNode( (SGNODE*) aCacheItem->sceneData );
 
-    aCacheItem->sceneData = (SCENEGRAPH*)S3D::ReadCache( fname.ToUTF8(), m_Plugins, checkTag );
+    CACHE_TAG_CHECK tagCheck;
+    tagCheck.plugins = m_Plugins;
+
+    aCacheItem->sceneData = (SCENEGRAPH*)S3D::ReadCache( fname.ToUTF8(), &tagCheck,
+                                                          checkCacheTag );
 
     if( NULL == aCacheItem->sceneData )
         return false;
 
+    // the model file written from this scene data gets the same tag
+    aCacheItem->pluginInfo = tagCheck.tag;
     return true;
 }
 
@@ -502,6 +590,61 @@ bool S3D_CACHE::saveCacheData( S3D_CACHE_ENTRY* aCacheItem )
 }
 
 
+bool S3D_CACHE::loadModelData( S3D_CACHE_ENTRY* aCacheItem )
+{
+    if( m_CacheDir.empty() )
+        return false;
+
+    wxString fname = m_CacheDir + aCacheItem->GetCacheBaseName() + wxT( ".3dm" );
+    std::unique_ptr<S3D_MODEL_FILE> modelFile( new S3D_MODEL_FILE );
+
+    if( !modelFile->Read( fname ) )
+        return false;
+
+    // as for the cache files, the model must have been loaded by an available
+    // version of its plugin
+    if( !checkTag( modelFile->GetPluginInfo().c_str(), m_Plugins ) )
+    {
+        wxLogTrace( MASK_3D_CACHE, " * [3D model] model file of another plugin version '%s'",
+                    fname );
+
+        return false;
+    }
+
+    aCacheItem->FreeRenderData();
+    aCacheItem->pluginInfo = modelFile->GetPluginInfo();
+    aCacheItem->renderData = modelFile->GetModel();
+    aCacheItem->modelFile = std::move( modelFile );
+
+    return true;
+}
+
+
+bool S3D_CACHE::saveModelData( S3D_CACHE_ENTRY* aCacheItem )
+{
+    if( m_CacheDir.empty() || NULL == aCacheItem->renderData || aCacheItem->modelFile )
+        return false;
+
+    wxString fname = m_CacheDir + aCacheItem->GetCacheBaseName() + wxT( ".3dm" );
+
+    return S3D_MODEL_FILE::Write( fname, *aCacheItem->renderData, aCacheItem->pluginInfo );
+}
+
+
+S3DMODEL* S3D_CACHE::getRenderData( S3D_CACHE_ENTRY* aCacheItem )
+{
+    if( aCacheItem->renderData || NULL == aCacheItem->sceneData )
+        return aCacheItem->renderData;
+
+    aCacheItem->renderData = S3D::GetModel( aCacheItem->sceneData );
+
+    if( aCacheItem->renderData )
+        saveModelData( aCacheItem );
+
+    return aCacheItem->renderData;
+}
+
+
 bool S3D_CACHE::Set3DConfigDir( const wxString& aConfigDir )
 {
     if( !m_ConfigDir.empty() )
@@ -647,6 +790,7 @@ bool S3D_CACHE::SetProjectDir( const wxString& aProjDir )
 
     if( m_FNResolver->SetProjectDir( aProjDir, &hasChanged ) && hasChanged )
     {
+        std::lock_guard<std::mutex> cacheLock( m_CacheLock );
         m_CacheMap.clear();
 
         std::list< S3D_CACHE_ENTRY* >::iterator sL = m_CacheList.begin();
@@ -694,6 +838,7 @@ std::list< wxString > const* S3D_CACHE::GetFileFilters( void ) const
 
 void S3D_CACHE::FlushCache( bool closePlugins )
 {
+    std::unique_lock<std::mutex> cacheLock( m_CacheLock );
     std::list< S3D_CACHE_ENTRY* >::iterator sCL = m_CacheList.begin();
     std::list< S3D_CACHE_ENTRY* >::iterator eCL = m_CacheList.end();
 
@@ -705,6 +850,7 @@ void S3D_CACHE::FlushCache( bool closePlugins )
 
     m_CacheList.clear();
     m_CacheMap.clear();
+    cacheLock.unlock();
 
     if( closePlugins )
         ClosePlugins();
@@ -715,6 +861,8 @@ void S3D_CACHE::FlushCache( bool closePlugins )
 
 void S3D_CACHE::ClosePlugins( void )
 {
+    std::lock_guard<std::mutex> pluginLock( lock3D_plugins );
+
     if( NULL != m_Plugins )
         m_Plugins->ClosePlugins();
 
@@ -724,28 +872,61 @@ void S3D_CACHE::ClosePlugins( void )
 
 S3DMODEL* S3D_CACHE::GetModel( const wxString& aModelFileName )
 {
-    S3D_CACHE_ENTRY* cp = NULL;
-    SCENEGRAPH* sp = load( aModelFileName, &cp );
+    std::unique_lock<std::mutex> entryLock;
+    S3D_CACHE_ENTRY* cp = load( aModelFileName, entryLock );
 
-    if( !sp )
+    if( !cp )
         return NULL;
 
-    if( !cp )
+    return getRenderData( cp );
+}
+
+
+void S3D_CACHE::PrefetchModels( const std::vector<wxString>& aModelFileNames )
+{
+    PROF_COUNTER totalTime;
+    unsigned pluginLoads = m_PluginLoads;
+    unsigned pluginTime = m_PluginTime;
+
+    // resolve the unique file names first, to load each model once
+    std::set<wxString> fileNames( aModelFileNames.begin(), aModelFileNames.end() );
+    std::set<wxString> resolved;
+    std::vector<wxString> fullPaths;
+
+    for( const wxString& fileName : fileNames )
     {
-        wxLogTrace( MASK_3D_CACHE,
-                    "%s:%s:%d\n  * [BUG] model loaded with no associated S3D_CACHE_ENTRY",
-                    __FILE__, __FUNCTION__, __LINE__ );
+        if( fileName.empty() )
+            continue;
 
-        return NULL;
-    }
+        wxString full3Dpath = m_FNResolver->ResolvePath( fileName );
 
-    if( cp->renderData )
-        return cp->renderData;
+        if( !full3Dpath.empty() && resolved.insert( full3Dpath ).second )
+            fullPaths.push_back( full3Dpath );
+    }
 
-    S3DMODEL* mp = S3D::GetModel( sp );
-    cp->renderData = mp;
+    // hash, load (from the model files when possible) and translate the models;
+    // each one is done under the lock of its own cache entry
+    TASK_GROUP tasks;
 
-    return mp;
+    tasks.RunForEach( fullPaths.size(),
+            [&]( size_t aIndex )
+            {
+                std::unique_lock<std::mutex> entryLock;
+                S3D_CACHE_ENTRY* cp = loadEntry( fullPaths[aIndex], entryLock );
+
+                if( cp )
+                    getRenderData( cp );
+            } );
+
+    tasks.Wait();
+    totalTime.Stop();
+
+    // the first load of a board is bound by the plugins, the next ones by the cache reads;
+    // the plugin time is summed over the threads
+    wxLogTrace( MASK_3D_CACHE, "Prefetched %u models in %.1f ms, %u of them parsed by the "
+                "plugins (%.1f ms in and waiting for the plugins)",
+                (unsigned) fullPaths.size(), totalTime.msecs(), m_PluginLoads - pluginLoads,
+                ( m_PluginTime - pluginTime ) / 1000.0 );
 }
 
 
@@ -756,16 +937,9 @@ wxString S3D_CACHE::GetModelHash( const wxString& aModelFileName )
     if( full3Dpath.empty() || !wxFileName::FileExists( full3Dpath ) )
         return wxEmptyString;
 
-    // check cache if file is already loaded
-    std::map< wxString, S3D_CACHE_ENTRY*, rsort_wxString >::iterator mi;
-    mi = m_CacheMap.find( full3Dpath );
-
-    if( mi != m_CacheMap.end() )
-        return mi->second->GetCacheBaseName();
-
-    // a cache item does not exist; search the Filename->Cachename map
-    S3D_CACHE_ENTRY* cp = NULL;
-    checkCache( full3Dpath, &cp );
+    // find the cache item, or create it
+    std::unique_lock<std::mutex> entryLock;
+    S3D_CACHE_ENTRY* cp = checkCache( full3Dpath, entryLock );
 
     if( NULL != cp )
         return cp->GetCacheBaseName();
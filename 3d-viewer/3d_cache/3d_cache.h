@@ -29,8 +29,11 @@
 #ifndef CACHE_3D_H
 #define CACHE_3D_H
 
+#include <atomic>
 #include <list>
 #include <map>
+#include <mutex>
+#include <vector>
 #include <wx/string.h>
 #include "kicad_string.h"
 #include "filename_resolver.h"
@@ -73,18 +76,28 @@ private:
     /// current KiCad project dir
     wxString m_ProjDir;
 
+    /// lock of the cache list and map; the data of each entry has its own lock
+    std::mutex m_CacheLock;
+
+    /// number of models parsed by the plugins, and time spent in and waiting for them (us)
+    std::atomic<unsigned> m_PluginLoads;
+    std::atomic<unsigned> m_PluginTime;
+
     /** Find or create cache entry for file name
      *
      * Searches the cache list for the given filename and retrieves
-     * the cache data; a cache entry is created if one does not
-     * already exist.
+     * the cache data; a cache entry is created and loaded if one does
+     * not already exist.
      *
-     * @param[in]   aFileName   file name (full or partial path)
-     * @param[out]  aCachePtr   optional return address for cache entry pointer
-     * @return      SCENEGRAPH object associated with file name
+     * @param[in]   aFileName   file name (full path)
+     * @param[out]  aEntryLock  holds the lock of the returned entry
+     * @param[out]  aCreated    optional, set to true if the entry was created
+     * @return      cache entry associated with file name
      * @retval      NULL    on error
      */
-    SCENEGRAPH* checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr = NULL );
+    S3D_CACHE_ENTRY* checkCache( const wxString& aFileName,
+                                 std::unique_lock<std::mutex>& aEntryLock,
+                                 bool* aCreated = NULL );
 
     /**
      * Function getSHA1
@@ -97,14 +110,36 @@ private:
      */
     bool getSHA1( const wxString& aFileName, unsigned char* aSHA1Sum );
 
+    // load the data of a new cache entry, from the model file, the cache file or the plugins
+    void loadModel( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheItem );
+
+    // load scene data from the cache file or the plugins
+    void loadSceneData( S3D_CACHE_ENTRY* aCacheItem );
+
+    // load render data from a model file (see S3D_MODEL_FILE)
+    bool loadModelData( S3D_CACHE_ENTRY* aCacheItem );
+
+    // save render data to a model file
+    bool saveModelData( S3D_CACHE_ENTRY* aCacheItem );
+
+    // return the render data, translating the scene data into it if needed
+    S3DMODEL* getRenderData( S3D_CACHE_ENTRY* aCacheItem );
+
+    // load scene data from a model file with the plugins, which are called one at a time
+    SCENEGRAPH* loadFromPlugins( const wxString& aFileName, std::string& aPluginInfo );
+
     // load scene data from a cache file
     bool loadCacheData( S3D_CACHE_ENTRY* aCacheItem );
 
     // save scene data to a cache file
     bool saveCacheData( S3D_CACHE_ENTRY* aCacheItem );
 
-    // the real load function (can supply a cache entry pointer to member functions)
-    SCENEGRAPH* load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr = NULL );
+    // find or create the cache entry of a resolved file name, reloading it if the file changed
+    S3D_CACHE_ENTRY* loadEntry( const wxString& aFullPath,
+                                std::unique_lock<std::mutex>& aEntryLock );
+
+    // the real load function (returns the cache entry, locked by aEntryLock)
+    S3D_CACHE_ENTRY* load( const wxString& aModelFile, std::unique_lock<std::mutex>& aEntryLock );
 
 public:
     S3D_CACHE();
@@ -200,6 +235,23 @@ public:
      */
     S3DMODEL* GetModel( const wxString& aModelFileName );
 
+    /**
+     * Function PrefetchModels
+     * loads the models of a list of files, and translates them into their
+     * S3D_MODEL structures, so that the next calls to GetModel() for these
+     * files only read the cache.
+     *
+     * The unique models are hashed, read from the cache files and translated
+     * in parallel.  The models which are not cached yet are parsed in parallel
+     * too by the thread safe plugins (VRML, X3D and IDF); the other plugins
+     * (e.g. STEP) parse their files one at a time.  The timings are traced
+     * under the "3D_CACHE" trace mask.
+     *
+     * @param aModelFileNames is the list of the partial or full paths of the
+     * models, which may hold duplicates
+     */
+    void PrefetchModels( const std::vector<wxString>& aModelFileNames );
+
     wxString GetModelHash( const wxString& aModelFileName );
 };
 
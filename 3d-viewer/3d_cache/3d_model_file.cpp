@@ -0,0 +1,294 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include <wx/filename.h>
+
+#include "ki_exception.h"
+#include "mapped_file.h"
+#include "3d_model_file.h"
+
+
+/// Change this whenever the layout of the file changes: files of other versions are ignored
+#define MODEL_FILE_VERSION      1
+
+static const char s_magic[8] = { 'K', 'I', '3', 'D', 'M', 'D', 'L', '\n' };
+
+// the arrays of the file are used in place, as arrays of these types
+static_assert( sizeof( SFVEC2F ) == 2 * sizeof( float ), "unexpected SFVEC2F layout" );
+static_assert( sizeof( SFVEC3F ) == 3 * sizeof( float ), "unexpected SFVEC3F layout" );
+static_assert( sizeof( SMATERIAL ) == 14 * sizeof( float ), "unexpected SMATERIAL layout" );
+
+
+namespace
+{
+
+struct FILE_HEADER
+{
+    char     m_Magic[8];
+    uint32_t m_Version;
+    uint32_t m_MaterialsSize;
+    uint32_t m_MeshesSize;
+    uint32_t m_PluginInfoSize;  ///< the plugin info follows, padded to 4 bytes
+};
+
+
+enum MESH_FLAGS
+{
+    MESH_NORMALS   = 1,
+    MESH_TEXCOORDS = 2,
+    MESH_COLORS    = 4
+};
+
+
+/// An entry of the mesh table; the arrays of the meshes follow the table, in order
+struct MESH_RECORD
+{
+    uint32_t m_VertexSize;
+    uint32_t m_FaceIdxSize;
+    uint32_t m_MaterialIdx;
+    uint32_t m_Flags;
+};
+
+
+/**
+ * Points aArray to the next aCount items of the file, checking they are within the file
+ */
+template<typename T>
+bool mapArray( const char* aData, size_t aSize, size_t& aPos, size_t aCount, T*& aArray )
+{
+    if( aCount > ( aSize - aPos ) / sizeof( T ) )
+        return false;
+
+    // the model is never written to, the const_cast only matches the S3DMODEL types
+    aArray = reinterpret_cast<T*>( const_cast<char*>( aData + aPos ) );
+    aPos += aCount * sizeof( T );
+    return true;
+}
+
+
+/// The size of the plugin info in the file, which keeps the arrays aligned
+size_t padded( size_t aSize )
+{
+    return ( aSize + 3 ) & ~(size_t) 3;
+}
+
+
+bool writeData( FILE* aFile, const void* aData, size_t aSize )
+{
+    return aSize == 0 || fwrite( aData, 1, aSize, aFile ) == aSize;
+}
+
+}
+
+
+S3D_MODEL_FILE::S3D_MODEL_FILE()
+{
+    clear();
+}
+
+
+S3D_MODEL_FILE::~S3D_MODEL_FILE()
+{
+}
+
+
+void S3D_MODEL_FILE::clear()
+{
+    m_file.reset();
+    m_meshes.clear();
+    m_pluginInfo.clear();
+
+    m_model.m_MeshesSize = 0;
+    m_model.m_Meshes = NULL;
+    m_model.m_MaterialsSize = 0;
+    m_model.m_Materials = NULL;
+}
+
+
+bool S3D_MODEL_FILE::Write( const wxString& aFileName, const S3DMODEL& aModel,
+                            const std::string& aPluginInfo )
+{
+    FILE_HEADER header;
+
+    memcpy( header.m_Magic, s_magic, sizeof( s_magic ) );
+    header.m_Version = MODEL_FILE_VERSION;
+    header.m_MaterialsSize = aModel.m_MaterialsSize;
+    header.m_MeshesSize = aModel.m_MeshesSize;
+    header.m_PluginInfoSize = aPluginInfo.size();
+
+    std::string pluginInfo = aPluginInfo;
+
+    pluginInfo.resize( padded( pluginInfo.size() ), '\0' );
+
+    std::vector<MESH_RECORD> records( aModel.m_MeshesSize );
+
+    for( unsigned int i = 0; i < aModel.m_MeshesSize; ++i )
+    {
+        const SMESH& mesh = aModel.m_Meshes[i];
+
+        records[i].m_VertexSize = mesh.m_VertexSize;
+        records[i].m_FaceIdxSize = mesh.m_FaceIdxSize;
+        records[i].m_MaterialIdx = mesh.m_MaterialIdx;
+        records[i].m_Flags = ( mesh.m_Normals ? MESH_NORMALS : 0 )
+                             | ( mesh.m_Texcoords ? MESH_TEXCOORDS : 0 )
+                             | ( mesh.m_Color ? MESH_COLORS : 0 );
+    }
+
+    // Write a temporary file and rename it, so that no reader can see a partial file
+    wxString tempFileName = wxFileName::CreateTempFileName( aFileName );
+
+    if( tempFileName.IsEmpty() )
+        return false;
+
+    FILE* fp = wxFopen( tempFileName, wxT( "wb" ) );
+    bool  ok = fp != NULL
+               && writeData( fp, &header, sizeof( header ) )
+               && writeData( fp, pluginInfo.data(), pluginInfo.size() )
+               && writeData( fp, aModel.m_Materials, aModel.m_MaterialsSize * sizeof( SMATERIAL ) )
+               && writeData( fp, records.data(), records.size() * sizeof( MESH_RECORD ) );
+
+    for( unsigned int i = 0; ok && i < aModel.m_MeshesSize; ++i )
+    {
+        const SMESH& mesh = aModel.m_Meshes[i];
+        size_t       vertexSize = mesh.m_VertexSize;
+
+        ok = writeData( fp, mesh.m_Positions, vertexSize * sizeof( SFVEC3F ) )
+             && ( !mesh.m_Normals
+                  || writeData( fp, mesh.m_Normals, vertexSize * sizeof( SFVEC3F ) ) )
+             && ( !mesh.m_Texcoords
+                  || writeData( fp, mesh.m_Texcoords, vertexSize * sizeof( SFVEC2F ) ) )
+             && ( !mesh.m_Color
+                  || writeData( fp, mesh.m_Color, vertexSize * sizeof( SFVEC3F ) ) )
+             && writeData( fp, mesh.m_FaceIdx, mesh.m_FaceIdxSize * sizeof( unsigned int ) );
+    }
+
+    if( fp && fclose( fp ) != 0 )
+        ok = false;
+
+    if( !ok || !wxRenameFile( tempFileName, aFileName, true ) )
+    {
+        wxRemoveFile( tempFileName );
+        return false;
+    }
+
+    return true;
+}
+
+
+bool S3D_MODEL_FILE::Read( const wxString& aFileName )
+{
+    clear();
+
+    if( !wxFileName::FileExists( aFileName ) )
+        return false;
+
+    try
+    {
+        m_file.reset( new MAPPED_FILE( aFileName ) );
+    }
+    catch( const IO_ERROR& )
+    {
+        return false;
+    }
+
+    const char* data = m_file->Data();
+    size_t      size = m_file->Size();
+    size_t      pos = sizeof( FILE_HEADER );
+    FILE_HEADER header;
+
+    if( size < sizeof( header ) )
+    {
+        clear();
+        return false;
+    }
+
+    memcpy( &header, data, sizeof( header ) );
+
+    const char*        pluginInfo = NULL;
+    const MESH_RECORD* records = NULL;
+
+    if( memcmp( header.m_Magic, s_magic, sizeof( s_magic ) )
+            || header.m_Version != MODEL_FILE_VERSION
+            || header.m_MaterialsSize == 0 || header.m_MeshesSize == 0
+            || !mapArray( data, size, pos, padded( header.m_PluginInfoSize ), pluginInfo )
+            || !mapArray( data, size, pos, header.m_MaterialsSize, m_model.m_Materials )
+            || !mapArray( data, size, pos, header.m_MeshesSize, records ) )
+    {
+        clear();
+        return false;
+    }
+
+    m_pluginInfo.assign( pluginInfo, header.m_PluginInfoSize );
+    m_model.m_MaterialsSize = header.m_MaterialsSize;
+    m_meshes.resize( header.m_MeshesSize );
+
+    for( unsigned int i = 0; i < header.m_MeshesSize; ++i )
+    {
+        const MESH_RECORD& record = records[i];
+        SMESH&             mesh = m_meshes[i];
+
+        mesh.m_VertexSize = record.m_VertexSize;
+        mesh.m_FaceIdxSize = record.m_FaceIdxSize;
+        mesh.m_MaterialIdx = record.m_MaterialIdx;
+        mesh.m_Normals = NULL;
+        mesh.m_Texcoords = NULL;
+        mesh.m_Color = NULL;
+
+        bool ok = record.m_MaterialIdx < header.m_MaterialsSize
+                  && record.m_FaceIdxSize % 3 == 0
+                  && mapArray( data, size, pos, record.m_VertexSize, mesh.m_Positions )
+                  && ( !( record.m_Flags & MESH_NORMALS )
+                       || mapArray( data, size, pos, record.m_VertexSize, mesh.m_Normals ) )
+                  && ( !( record.m_Flags & MESH_TEXCOORDS )
+                       || mapArray( data, size, pos, record.m_VertexSize, mesh.m_Texcoords ) )
+                  && ( !( record.m_Flags & MESH_COLORS )
+                       || mapArray( data, size, pos, record.m_VertexSize, mesh.m_Color ) )
+                  && mapArray( data, size, pos, record.m_FaceIdxSize, mesh.m_FaceIdx );
+
+        // the renderers index the vertex arrays without checking the indices
+        for( unsigned int j = 0; ok && j < mesh.m_FaceIdxSize; ++j )
+            ok = mesh.m_FaceIdx[j] < mesh.m_VertexSize;
+
+        if( !ok )
+        {
+            clear();
+            return false;
+        }
+    }
+
+    if( pos != size )
+    {
+        clear();
+        return false;
+    }
+
+    m_model.m_MeshesSize = m_meshes.size();
+    m_model.m_Meshes = m_meshes.data();
+
+    return true;
+}
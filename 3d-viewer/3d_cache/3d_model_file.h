@@ -0,0 +1,98 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file 3d_model_file.h
+ * defines a binary cache file holding the render data of a 3D model
+ */
+
+#ifndef MODEL_FILE_3D_H
+#define MODEL_FILE_3D_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <wx/string.h>
+#include "plugins/3dapi/c3dmodel.h"
+
+
+class MAPPED_FILE;
+
+
+/**
+ * Class S3D_MODEL_FILE
+ * stores an S3DMODEL, as built by S3D::GetModel() from a scene graph, in a flat
+ * binary file: the materials table, the mesh table, then the arrays of each mesh.
+ *
+ * The file is read mapped in memory, and the arrays of the model point into the
+ * mapped file, so that loading a model allocates nothing but the mesh table.  The
+ * file is written in the native byte order, since it is a local cache; files of
+ * another version, or which are not valid, are ignored.
+ */
+class S3D_MODEL_FILE
+{
+public:
+    S3D_MODEL_FILE();
+    ~S3D_MODEL_FILE();
+
+    /**
+     * Function Write
+     * writes the model @a aModel, loaded by the plugin @a aPluginInfo, in the
+     * file @a aFileName
+     *
+     * @return true on success
+     */
+    static bool Write( const wxString& aFileName, const S3DMODEL& aModel,
+                       const std::string& aPluginInfo );
+
+    /**
+     * Function Read
+     * maps the file @a aFileName in memory and checks it
+     *
+     * @return false if the file cannot be read or is not a valid model file
+     */
+    bool Read( const wxString& aFileName );
+
+    /**
+     * Function GetModel
+     * returns the model read from the file, which is valid as long as this object
+     * exists; its arrays are read only.
+     */
+    S3DMODEL* GetModel() { return m_file ? &m_model : NULL; }
+
+    /**
+     * Function GetPluginInfo
+     * returns the PluginName:Version string of the plugin which loaded the model
+     */
+    const std::string& GetPluginInfo() const { return m_pluginInfo; }
+
+private:
+    void clear();
+
+    std::unique_ptr<MAPPED_FILE> m_file;
+    std::vector<SMESH>           m_meshes;
+    std::string                  m_pluginInfo;
+    S3DMODEL                     m_model;
+};
+
+#endif  // MODEL_FILE_3D_H
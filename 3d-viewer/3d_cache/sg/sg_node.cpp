@@ -45,7 +45,8 @@ static const std::string node_names[S3D::SGTYPE_END + 1] = {
 };
 
 
-static unsigned int node_counts[S3D::SGTYPE_END] = { 1, 1, 1, 1, 1, 1, 1, 1, 1 };
+// per thread, since the scene graphs of different models may be built concurrently
+static thread_local unsigned int node_counts[S3D::SGTYPE_END] = { 1, 1, 1, 1, 1, 1, 1, 1, 1 };
 
 
 char const* S3D::GetNodeTypeName( S3D::SGTYPES aType )
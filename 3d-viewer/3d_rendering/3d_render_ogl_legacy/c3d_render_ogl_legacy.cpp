@@ -28,6 +28,7 @@
  */
 
 
+#include <GL/glew.h>    // Must be included first
 #include "c3d_render_ogl_legacy.h"
 #include "ogl_legacy_utils.h"
 #include "common_ogl/ogl_utils.h"
@@ -43,6 +44,15 @@
   */
 #define UNITS3D_TO_UNITSPCB (IU_PER_MM)
 
+/**
+  * A vertex of the lines of the 3D grid
+  */
+struct GRID_VERTEX
+{
+    SFVEC3F m_pos;
+    SFVEC4F m_color;
+};
+
 C3D_RENDER_OGL_LEGACY::C3D_RENDER_OGL_LEGACY( CINFO3D_VISU &aSettings ) :
                        C3D_RENDER_BASE( aSettings )
 {
@@ -64,7 +74,7 @@ C3D_RENDER_OGL_LEGACY::C3D_RENDER_OGL_LEGACY( CINFO3D_VISU &aSettings ) :
     m_ogl_disp_list_vias_and_pad_holes_outer_contourn_and_caps = NULL;
 
     m_ogl_circle_texture = 0;
-    m_ogl_disp_list_grid = 0;
+    m_ogl_grid_buffer = NULL;
     m_last_grid_type = GRID3D_NONE;
 
     m_3dmodel_map.clear();
@@ -470,6 +480,8 @@ bool C3D_RENDER_OGL_LEGACY::Redraw( bool aIsMoving,
             return false;
     }
 
+    C_OGL_BUFFER::ResetDrawCallCount();
+
     if( m_reloadRequested )
     {
         std::unique_ptr<BUSY_INDICATOR> busy = CreateBusyIndicator();
@@ -744,8 +756,30 @@ bool C3D_RENDER_OGL_LEGACY::Redraw( bool aIsMoving,
     {
         glDisable( GL_LIGHTING );
 
-        if( glIsList( m_ogl_disp_list_grid ) )
-            glCallList( m_ogl_disp_list_grid );
+        if( m_ogl_grid_buffer )
+        {
+            const char *vertexs = m_ogl_grid_buffer->Bind();
+
+            glEnableClientState( GL_VERTEX_ARRAY );
+            glEnableClientState( GL_COLOR_ARRAY );
+            glVertexPointer( 3, GL_FLOAT, sizeof( GRID_VERTEX ),
+                             vertexs + offsetof( GRID_VERTEX, m_pos ) );
+            glColorPointer( 4, GL_FLOAT, sizeof( GRID_VERTEX ),
+                            vertexs + offsetof( GRID_VERTEX, m_color ) );
+
+            glEnable( GL_BLEND );
+            glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
+
+            C_OGL_BUFFER::DrawArrays( GL_LINES, 0,
+                                      m_ogl_grid_buffer->GetSize() / sizeof( GRID_VERTEX ) );
+
+            glDisable( GL_BLEND );
+
+            glDisableClientState( GL_COLOR_ARRAY );
+            glDisableClientState( GL_VERTEX_ARRAY );
+
+            m_ogl_grid_buffer->Unbind();
+        }
 
         glEnable( GL_LIGHTING );
     }
@@ -761,6 +795,9 @@ bool C3D_RENDER_OGL_LEGACY::Redraw( bool aIsMoving,
     // /////////////////////////////////////////////////////////////////////////
     glViewport( 0, 0, m_windowSize.x, m_windowSize.y );
 
+    wxLogTrace( m_logTrace, wxT( "C3D_RENDER_OGL_LEGACY::Redraw %u draw calls" ),
+                C_OGL_BUFFER::GetDrawCallCount() );
+
     return false;
 }
 
@@ -834,10 +871,8 @@ void C3D_RENDER_OGL_LEGACY::ogl_set_arrow_material()
 
 void C3D_RENDER_OGL_LEGACY::ogl_free_all_display_lists()
 {
-    if( glIsList( m_ogl_disp_list_grid ) )
-        glDeleteLists( m_ogl_disp_list_grid, 1 );
-
-    m_ogl_disp_list_grid = 0;
+    delete m_ogl_grid_buffer;
+    m_ogl_grid_buffer = NULL;
 
     for( MAP_OGL_DISP_LISTS::const_iterator ii = m_ogl_disp_lists_layers.begin();
          ii != m_ogl_disp_lists_layers.end();
@@ -979,6 +1014,10 @@ void C3D_RENDER_OGL_LEGACY::render_solder_mask_layer( PCB_LAYER_ID aLayerID,
 void C3D_RENDER_OGL_LEGACY::render_3D_models( bool aRenderTopOrBot,
                                               bool aRenderTransparentOnly )
 {
+    // Collect the transformations of all the instances of each model, so that
+    // each model binds its buffers and sets its materials once per frame
+    OGL_3DMODEL_INSTANCES instances;
+
     // Go for all modules
     if( m_settings.GetBoard()->m_Modules.GetCount() )
     {
@@ -990,41 +1029,92 @@ void C3D_RENDER_OGL_LEGACY::render_3D_models( bool aRenderTopOrBot,
                 if( m_settings.ShouldModuleBeDisplayed( (MODULE_ATTR_T)module->GetAttributes() ) )
                     if( ( aRenderTopOrBot && !module->IsFlipped()) ||
                         (!aRenderTopOrBot &&  module->IsFlipped()) )
-                        render_3D_module( module, aRenderTransparentOnly );
+                        get_3D_module_instances( module, aRenderTransparentOnly, instances );
+        }
+    }
+
+    for( const auto &model : instances.models )
+    {
+        const C_OGL_3DMODEL *modelPtr = model.first;
+        const std::vector<glm::mat4> &transforms = model.second;
+
+        if( aRenderTransparentOnly )
+            modelPtr->Draw_transparent( transforms );
+        else
+            modelPtr->Draw_opaque( transforms );
+
+        if( m_settings.GetFlag( FL_RENDER_OPENGL_SHOW_MODEL_BBOX ) )
+        {
+            for( const glm::mat4 &transform : transforms )
+            {
+                glPushMatrix();
+                glMultMatrixf( glm::value_ptr( transform ) );
+
+                glEnable( GL_BLEND );
+                glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
+
+                glLineWidth( 1 );
+                modelPtr->Draw_bboxes();
+
+                glDisable( GL_LIGHTING );
+
+                glColor4f( 0.0f, 1.0f, 0.0f, 1.0f );
+
+                glLineWidth( 4 );
+                modelPtr->Draw_bbox();
+
+                glEnable( GL_LIGHTING );
+
+                glPopMatrix();
+            }
         }
     }
 }
 
 
-void C3D_RENDER_OGL_LEGACY::render_3D_module( const MODULE* module,
-                                              bool aRenderTransparentOnly )
+void C3D_RENDER_OGL_LEGACY::get_3D_module_instances( const MODULE* module,
+                                                     bool aRenderTransparentOnly,
+                                                     OGL_3DMODEL_INSTANCES &aInstances )
 {
     if( !module->Models().empty() )
     {
         const double zpos = m_settings.GetModulesZcoord3DIU( module->IsFlipped() );
 
-        glPushMatrix();
-
         wxPoint pos = module->GetPosition();
 
-        glTranslatef(  pos.x * m_settings.BiuTo3Dunits(),
-                      -pos.y * m_settings.BiuTo3Dunits(),
-                       zpos );
+        glm::mat4 moduleMatrix = glm::mat4( 1.0f );
+
+        moduleMatrix = glm::translate( moduleMatrix,
+                                       SFVEC3F( pos.x * m_settings.BiuTo3Dunits(),
+                                               -pos.y * m_settings.BiuTo3Dunits(),
+                                                zpos ) );
 
         if( module->GetOrientation() )
-            glRotated( (double) module->GetOrientation() / 10.0, 0.0, 0.0, 1.0 );
+        {
+            moduleMatrix = glm::rotate( moduleMatrix,
+                                        ( (float)(module->GetOrientation() / 10.0f) / 180.0f ) *
+                                        glm::pi<float>(),
+                                        SFVEC3F( 0.0f, 0.0f, 1.0f ) );
+        }
 
         if( module->IsFlipped() )
         {
-            glRotatef( 180.0f, 0.0f, 1.0f, 0.0f );
-            glRotatef( 180.0f, 0.0f, 0.0f, 1.0f );
+            moduleMatrix = glm::rotate( moduleMatrix,
+                                        glm::pi<float>(),
+                                        SFVEC3F( 0.0f, 1.0f, 0.0f ) );
+
+            moduleMatrix = glm::rotate( moduleMatrix,
+                                        glm::pi<float>(),
+                                        SFVEC3F( 0.0f, 0.0f, 1.0f ) );
         }
 
-        double modelunit_to_3d_units_factor = m_settings.BiuTo3Dunits() * UNITS3D_TO_UNITSPCB;
+        const double modelunit_to_3d_units_factor = m_settings.BiuTo3Dunits() *
+                                                    UNITS3D_TO_UNITSPCB;
 
-        glScaled( modelunit_to_3d_units_factor,
-                  modelunit_to_3d_units_factor,
-                  modelunit_to_3d_units_factor );
+        moduleMatrix = glm::scale( moduleMatrix,
+                                   SFVEC3F( modelunit_to_3d_units_factor,
+                                            modelunit_to_3d_units_factor,
+                                            modelunit_to_3d_units_factor ) );
 
         // Get the list of model files for this model
         auto sM = module->Models().begin();
@@ -1035,50 +1125,45 @@ void C3D_RENDER_OGL_LEGACY::render_3D_module( const MODULE* module,
             if( !sM->m_Filename.empty() )
             {
                 // Check if the model is present in our cache map
-                if( m_3dmodel_map.find( sM->m_Filename ) != m_3dmodel_map.end() )
+                MAP_3DMODEL::const_iterator cache_i = m_3dmodel_map.find( sM->m_Filename );
+
+                if( cache_i != m_3dmodel_map.end() )
                 {
-                    // It is not present, try get it from cache
-                    const C_OGL_3DMODEL *modelPtr = m_3dmodel_map[ sM->m_Filename ];
+                    const C_OGL_3DMODEL *modelPtr = cache_i->second;
 
                     if( modelPtr )
                     {
                         if( ( (!aRenderTransparentOnly) && modelPtr->Have_opaque() ) ||
                             ( aRenderTransparentOnly && modelPtr->Have_transparent() ) )
                         {
-                            glPushMatrix();
-
-                            glTranslatef( sM->m_Offset.x, sM->m_Offset.y, sM->m_Offset.z );
-
-                            glRotatef( -sM->m_Rotation.z, 0.0f, 0.0f, 1.0f );
-                            glRotatef( -sM->m_Rotation.y, 0.0f, 1.0f, 0.0f );
-                            glRotatef( -sM->m_Rotation.x, 1.0f, 0.0f, 0.0f );
-
-                            glScalef( sM->m_Scale.x, sM->m_Scale.y, sM->m_Scale.z );
-
-                            if( aRenderTransparentOnly )
-                                modelPtr->Draw_transparent();
-                            else
-                                modelPtr->Draw_opaque();
-
-                            if( m_settings.GetFlag( FL_RENDER_OPENGL_SHOW_MODEL_BBOX ) )
-                            {
-                                glEnable( GL_BLEND );
-                                glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
-
-                                glLineWidth( 1 );
-                                modelPtr->Draw_bboxes();
-
-                                glDisable( GL_LIGHTING );
-
-                                glColor4f( 0.0f, 1.0f, 0.0f, 1.0f );
-
-                                glLineWidth( 4 );
-                                modelPtr->Draw_bbox();
-
-                                glEnable( GL_LIGHTING );
-                            }
-
-                            glPopMatrix();
+                            glm::mat4 modelMatrix = moduleMatrix;
+
+                            modelMatrix = glm::translate( modelMatrix,
+                                                          SFVEC3F( sM->m_Offset.x,
+                                                                   sM->m_Offset.y,
+                                                                   sM->m_Offset.z ) );
+
+                            modelMatrix = glm::rotate( modelMatrix,
+                                                       (float)-( sM->m_Rotation.z / 180.0f ) *
+                                                       glm::pi<float>(),
+                                                       SFVEC3F( 0.0f, 0.0f, 1.0f ) );
+
+                            modelMatrix = glm::rotate( modelMatrix,
+                                                       (float)-( sM->m_Rotation.y / 180.0f ) *
+                                                       glm::pi<float>(),
+                                                       SFVEC3F( 0.0f, 1.0f, 0.0f ) );
+
+                            modelMatrix = glm::rotate( modelMatrix,
+                                                       (float)-( sM->m_Rotation.x / 180.0f ) *
+                                                       glm::pi<float>(),
+                                                       SFVEC3F( 1.0f, 0.0f, 0.0f ) );
+
+                            modelMatrix = glm::scale( modelMatrix,
+                                                      SFVEC3F( sM->m_Scale.x,
+                                                               sM->m_Scale.y,
+                                                               sM->m_Scale.z ) );
+
+                            aInstances.Add( modelPtr, modelMatrix );
                         }
                     }
                 }
@@ -1086,34 +1171,20 @@ void C3D_RENDER_OGL_LEGACY::render_3D_module( const MODULE* module,
 
             ++sM;
         }
-
-        glPopMatrix();
     }
 }
 
 
-// create a 3D grid to an openGL display list: an horizontal grid (XY plane and Z = 0,
+// create a 3D grid to an openGL vertex buffer: an horizontal grid (XY plane and Z = 0,
 // and a vertical grid (XZ plane and Y = 0)
 void C3D_RENDER_OGL_LEGACY::generate_new_3DGrid( GRID3D_TYPE aGridType )
 {
-    if( glIsList( m_ogl_disp_list_grid ) )
-        glDeleteLists( m_ogl_disp_list_grid, 1 );
-
-    m_ogl_disp_list_grid = 0;
+    delete m_ogl_grid_buffer;
+    m_ogl_grid_buffer = NULL;
 
     if( aGridType == GRID3D_NONE )
         return;
 
-    m_ogl_disp_list_grid = glGenLists( 1 );
-
-    if( !glIsList( m_ogl_disp_list_grid ) )
-        return;
-
-    glNewList( m_ogl_disp_list_grid, GL_COMPILE );
-
-    glEnable( GL_BLEND );
-    glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
-
     const double zpos = 0.0;
 
     // Color of grid lines
@@ -1145,7 +1216,22 @@ void C3D_RENDER_OGL_LEGACY::generate_new_3DGrid( GRID3D_TYPE aGridType )
         break;
     }
 
-    glNormal3f( 0.0, 0.0, 1.0 );
+    // The grid is rendered without lighting, so the lines have no normals
+    std::vector<GRID_VERTEX> lines;
+    SFVEC4F color;
+
+    auto addLine = [&]( double x1, double y1, double z1, double x2, double y2, double z2 )
+    {
+        GRID_VERTEX vertex;
+
+        vertex.m_color = color;
+
+        vertex.m_pos = SFVEC3F( x1, y1, z1 );
+        lines.push_back( vertex );
+
+        vertex.m_pos = SFVEC3F( x2, y2, z2 );
+        lines.push_back( vertex );
+    };
 
     const wxSize  brd_size = m_settings.GetBoardSizeBIU();
     wxPoint brd_center_pos = m_settings.GetBoardPosBIU();
@@ -1167,44 +1253,33 @@ void C3D_RENDER_OGL_LEGACY::generate_new_3DGrid( GRID3D_TYPE aGridType )
     for( int ii = 0; ; ii++ )
     {
         if( (ii % 5) )
-            glColor4f( gridColor.r, gridColor.g, gridColor.b, transparency );
+            color = SFVEC4F( gridColor, transparency );
         else
-            glColor4f( gridColor_marker.r,
-                       gridColor_marker.g,
-                       gridColor_marker.b,
-                       transparency );
+            color = SFVEC4F( gridColor_marker, transparency );
 
         const int delta = KiROUND( ii * griSizeMM * IU_PER_MM );
 
         if( delta <= xsize / 2 )    // Draw grid lines parallel to X axis
         {
-            glBegin( GL_LINES );
-            glVertex3f( (brd_center_pos.x + delta) * scale, -ymin, zpos );
-            glVertex3f( (brd_center_pos.x + delta) * scale, -ymax, zpos );
-            glEnd();
+            addLine( (brd_center_pos.x + delta) * scale, -ymin, zpos,
+                     (brd_center_pos.x + delta) * scale, -ymax, zpos );
 
             if( ii != 0 )
             {
-                glBegin( GL_LINES );
-                glVertex3f( (brd_center_pos.x - delta) * scale, -ymin, zpos );
-                glVertex3f( (brd_center_pos.x - delta) * scale, -ymax, zpos );
-                glEnd();
+                addLine( (brd_center_pos.x - delta) * scale, -ymin, zpos,
+                         (brd_center_pos.x - delta) * scale, -ymax, zpos );
             }
         }
 
         if( delta <= ysize / 2 )    // Draw grid lines parallel to Y axis
         {
-            glBegin( GL_LINES );
-            glVertex3f( xmin, -(brd_center_pos.y + delta) * scale, zpos );
-            glVertex3f( xmax, -(brd_center_pos.y + delta) * scale, zpos );
-            glEnd();
+            addLine( xmin, -(brd_center_pos.y + delta) * scale, zpos,
+                     xmax, -(brd_center_pos.y + delta) * scale, zpos );
 
             if( ii != 0 )
             {
-                glBegin( GL_LINES );
-                glVertex3f( xmin, -(brd_center_pos.y - delta) * scale, zpos );
-                glVertex3f( xmax, -(brd_center_pos.y - delta) * scale, zpos );
-                glEnd();
+                addLine( xmin, -(brd_center_pos.y - delta) * scale, zpos,
+                         xmax, -(brd_center_pos.y - delta) * scale, zpos );
             }
         }
 
@@ -1213,37 +1288,28 @@ void C3D_RENDER_OGL_LEGACY::generate_new_3DGrid( GRID3D_TYPE aGridType )
     }
 
     // Draw vertical grid on Z axis
-    glNormal3f( 0.0, -1.0, 0.0 );
-
     // Draw vertical grid lines (parallel to Z axis)
     double posy = -brd_center_pos.y * scale;
 
     for( int ii = 0; ; ii++ )
     {
         if( (ii % 5) )
-            glColor4f( gridColor.r, gridColor.g, gridColor.b, transparency );
+            color = SFVEC4F( gridColor, transparency );
         else
-            glColor4f( gridColor_marker.r,
-                       gridColor_marker.g,
-                       gridColor_marker.b,
-                       transparency );
+            color = SFVEC4F( gridColor_marker, transparency );
 
         const double delta = ii * griSizeMM * IU_PER_MM;
 
-        glBegin( GL_LINES );
         xmax = (brd_center_pos.x + delta) * scale;
 
-        glVertex3f( xmax, posy, zmin );
-        glVertex3f( xmax, posy, zmax );
-        glEnd();
+        addLine( xmax, posy, zmin,
+                 xmax, posy, zmax );
 
         if( ii != 0 )
         {
-            glBegin( GL_LINES );
             xmin = (brd_center_pos.x - delta) * scale;
-            glVertex3f( xmin, posy, zmin );
-            glVertex3f( xmin, posy, zmax );
-            glEnd();
+            addLine( xmin, posy, zmin,
+                     xmin, posy, zmax );
         }
 
         if( delta > xsize / 2.0f )
@@ -1254,38 +1320,31 @@ void C3D_RENDER_OGL_LEGACY::generate_new_3DGrid( GRID3D_TYPE aGridType )
     for( int ii = 0; ; ii++ )
     {
         if( (ii % 5) )
-            glColor4f( gridColor.r, gridColor.g, gridColor.b, transparency );
+            color = SFVEC4F( gridColor, transparency );
         else
-            glColor4f( gridColor_marker.r,
-                       gridColor_marker.g,
-                       gridColor_marker.b,
-                       transparency );
+            color = SFVEC4F( gridColor_marker, transparency );
 
         const double delta = ii * griSizeMM * IU_PER_MM * scale;
 
         if( delta <= zmax )
         {
             // Draw grid lines on Z axis (positive Z axis coordinates)
-            glBegin( GL_LINES );
-            glVertex3f( xmin, posy, delta );
-            glVertex3f( xmax, posy, delta );
-            glEnd();
+            addLine( xmin, posy, delta,
+                     xmax, posy, delta );
         }
 
         if( delta <= -zmin && ( ii != 0 ) )
         {
             // Draw grid lines on Z axis (negative Z axis coordinates)
-            glBegin( GL_LINES );
-            glVertex3f( xmin, posy, -delta );
-            glVertex3f( xmax, posy, -delta );
-            glEnd();
+            addLine( xmin, posy, -delta,
+                     xmax, posy, -delta );
         }
 
         if( ( delta > zmax ) && ( delta > -zmin ) )
             break;
     }
 
-    glDisable( GL_BLEND );
-
-    glEndList();
+    m_ogl_grid_buffer = new C_OGL_BUFFER( GL_ARRAY_BUFFER_ARB,
+                                          lines.data(),
+                                          lines.size() * sizeof( GRID_VERTEX ) );
 }
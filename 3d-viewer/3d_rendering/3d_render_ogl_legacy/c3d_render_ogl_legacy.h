@@ -45,12 +45,42 @@
 #include "3d_cache/3d_info.h"
 
 #include <map>
+#include <unordered_map>
+#include <vector>
 
 
 typedef std::map< PCB_LAYER_ID, CLAYERS_OGL_DISP_LISTS* > MAP_OGL_DISP_LISTS;
 typedef std::map< PCB_LAYER_ID, CLAYER_TRIANGLES * > MAP_TRIANGLES;
 typedef std::map< wxString, C_OGL_3DMODEL * > MAP_3DMODEL;
 
+/**
+ * @brief The transformations of the instances of each 3D model. The models are kept
+ * in the order they are first added, so that the drawing order of the transparent
+ * models does not depend on their addresses
+ */
+struct OGL_3DMODEL_INSTANCES
+{
+    /// the models and the transformations of their instances
+    std::vector< std::pair< const C_OGL_3DMODEL *, std::vector<glm::mat4> > > models;
+
+    /// the index of each model in models
+    std::unordered_map< const C_OGL_3DMODEL *, size_t > index;
+
+    void Add( const C_OGL_3DMODEL *aModel, const glm::mat4 &aTransform )
+    {
+        auto it = index.find( aModel );
+
+        if( it == index.end() )
+        {
+            it = index.emplace( aModel, models.size() ).first;
+            models.emplace_back( aModel, std::vector<glm::mat4>() );
+        }
+
+        models[it->second].second.push_back( aTransform );
+    }
+};
+
+
 #define SIZE_OF_CIRCLE_TEXTURE 1024
 
 /**
@@ -97,7 +127,7 @@ private:
 
     GLuint m_ogl_circle_texture;
 
-    GLuint m_ogl_disp_list_grid;    ///< oGL list that stores current grid
+    C_OGL_BUFFER *m_ogl_grid_buffer; ///< oGL vertex buffer that stores current grid lines
 
     GRID3D_TYPE m_last_grid_type;   ///< Stores the last grid computed
 
@@ -184,7 +214,13 @@ private:
      */
     void render_3D_models( bool aRenderTopOrBot, bool aRenderTransparentOnly );
 
-    void render_3D_module( const MODULE* module, bool aRenderTransparentOnly );
+    /**
+     * @brief get_3D_module_instances - add the transformations of the 3D models of
+     * a module to the instances of the models
+     */
+    void get_3D_module_instances( const MODULE* module,
+                                  bool aRenderTransparentOnly,
+                                  OGL_3DMODEL_INSTANCES &aInstances );
 
     void setLight_Front( bool enabled );
     void setLight_Top( bool enabled );
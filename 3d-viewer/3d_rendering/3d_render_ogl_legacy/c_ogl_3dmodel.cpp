@@ -27,19 +27,28 @@
  * @brief
  */
 
+#include <GL/glew.h>    // Must be included first
 #include "c_ogl_3dmodel.h"
 #include "ogl_legacy_utils.h"
 #include "../common_ogl/ogl_utils.h"
 #include "../3d_math.h"
 #include <wx/debug.h>
+#include <cstddef>
+
+
+static GLubyte color_to_ubyte( float aColor )
+{
+    return (GLubyte)( glm::clamp( aColor, 0.0f, 1.0f ) * 255.0f + 0.5f );
+}
 
 
 C_OGL_3DMODEL::C_OGL_3DMODEL( const S3DMODEL &a3DModel,
                               MATERIAL_MODE aMaterialMode )
 {
-    m_ogl_idx_list_meshes = 0;
-    m_ogl_idx_list_opaque = 0;
-    m_ogl_idx_list_transparent = 0;
+    m_vertex_buffer = NULL;
+    m_index_buffer = NULL;
+    m_have_opaque_meshes = false;
+    m_have_transparent_meshes = false;
     m_nr_meshes = 0;
     m_meshs_bbox = NULL;
 
@@ -56,260 +65,115 @@ C_OGL_3DMODEL::C_OGL_3DMODEL( const S3DMODEL &a3DModel,
 
         m_meshs_bbox = new CBBOX[a3DModel.m_MeshesSize];
 
-        // Generate m_MeshesSize auxiliar lists to render the meshes
-        m_ogl_idx_list_meshes = glGenLists( a3DModel.m_MeshesSize );
+        // The vertexes and the indexes of all the meshes are stored in a single
+        // vertex buffer and a single index buffer, so that each instance of the
+        // model is rendered with a draw call per mesh, without rebinding the
+        // arrays. The texture coordinates are not stored: the models are
+        // rendered without textures.
+        std::vector<VERTEX> vertexes;
+        std::vector<GLuint> indexes;
 
-        // Render each mesh of the model
+        // Add each mesh of the model
         // /////////////////////////////////////////////////////////////////////
         for( unsigned int mesh_i = 0; mesh_i < a3DModel.m_MeshesSize; ++mesh_i )
         {
-            if( glIsList( m_ogl_idx_list_meshes + mesh_i ) )
-            {
-                const SMESH &mesh = a3DModel.m_Meshes[mesh_i];
+            const SMESH &mesh = a3DModel.m_Meshes[mesh_i];
 
-                // Validate the mesh pointers
-                wxASSERT( mesh.m_Positions != NULL );
-                wxASSERT( mesh.m_FaceIdx != NULL );
-                wxASSERT( mesh.m_Normals != NULL );
+            // Validate the mesh pointers
+            wxASSERT( mesh.m_Positions != NULL );
+            wxASSERT( mesh.m_FaceIdx != NULL );
+            wxASSERT( mesh.m_Normals != NULL );
 
-                if( (mesh.m_Positions != NULL) &&
-                    (mesh.m_Normals != NULL) &&
-                    (mesh.m_FaceIdx != NULL) &&
-                    (mesh.m_FaceIdxSize > 0) && (mesh.m_VertexSize > 0) )
-                {
-                    SFVEC4F *pColorRGBA = NULL;
-
-                    // Create the bbox for this mesh
-                    // /////////////////////////////////////////////////////////
-                    m_meshs_bbox[mesh_i].Reset();
-
-                    for( unsigned int vertex_i = 0;
-                         vertex_i < mesh.m_VertexSize;
-                         ++vertex_i )
-                    {
-                        m_meshs_bbox[mesh_i].Union( mesh.m_Positions[vertex_i] );
-                    }
-
-                    // Make sure we start with client state disabled
-                    // /////////////////////////////////////////////////////////
-                    glDisableClientState( GL_TEXTURE_COORD_ARRAY );
-                    glDisableClientState( GL_COLOR_ARRAY );
-
-
-                    // Enable arrays client states
-                    // /////////////////////////////////////////////////////////
-                    glEnableClientState( GL_VERTEX_ARRAY );
-                    glEnableClientState( GL_NORMAL_ARRAY );
-
-                    glVertexPointer( 3, GL_FLOAT, 0, mesh.m_Positions );
-                    glNormalPointer( GL_FLOAT, 0, mesh.m_Normals );
-
-                    if( mesh.m_Color != NULL )
-                    {
-                        glEnableClientState( GL_COLOR_ARRAY );
-
-                        float transparency = 0.0f;
-
-                        if( mesh.m_MaterialIdx < a3DModel.m_MaterialsSize )
-                            transparency = a3DModel.m_Materials[mesh.m_MaterialIdx].m_Transparency;
-
-                        if( (transparency > FLT_EPSILON) &&
-                            (aMaterialMode ==  MATERIAL_MODE_NORMAL) )
-                        {
-                            // Create a new array of RGBA colors
-                            pColorRGBA = new SFVEC4F[mesh.m_VertexSize];
-
-                            // Copy RGB array and add the Alpha value
-                            for( unsigned int i = 0; i < mesh.m_VertexSize; ++i )
-                                pColorRGBA[i] = SFVEC4F( mesh.m_Color[i],
-                                                         1.0f - transparency );
-
-                            // Load an RGBA array
-                            glColorPointer( 4, GL_FLOAT, 0, pColorRGBA );
-                        }
-                        else
-                        {
-                            switch( aMaterialMode )
-                            {
-                            case MATERIAL_MODE_NORMAL:
-                            case MATERIAL_MODE_DIFFUSE_ONLY:
-                                // load the original RGB color array
-                                glColorPointer( 3, GL_FLOAT, 0, mesh.m_Color );
-                                break;
-                            case MATERIAL_MODE_CAD_MODE:
-                                // Create a new array of RGBA colors
-                                pColorRGBA = new SFVEC4F[mesh.m_VertexSize];
-
-                                // Copy RGB array and add the Alpha value
-                                for( unsigned int i = 0; i < mesh.m_VertexSize; ++i )
-                                {
-                                    pColorRGBA[i] =
-                                            SFVEC4F( MaterialDiffuseToColorCAD( mesh.m_Color[i] ),
-                                                     1.0f );
-                                }
-
-                                // Load an RGBA array
-                                glColorPointer( 4, GL_FLOAT, 0, pColorRGBA );
-                                break;
-                            default:
-                                break;
-                            }
-                        }
-                    }
-
-                    if( mesh.m_Texcoords != NULL )
-                    {
-                        glEnableClientState( GL_TEXTURE_COORD_ARRAY );
-                        glTexCoordPointer( 2, GL_FLOAT, 0, mesh.m_Texcoords );
-                    }
-
-                    // Compile the display list to store triangles
-                    // /////////////////////////////////////////////////////////
-                    glNewList( m_ogl_idx_list_meshes + mesh_i, GL_COMPILE );
-
-                    // Set material properties
-                    // /////////////////////////////////////////////////////////
-
-                    if( mesh.m_Color != NULL )
-                    {
-                        // This enables the use of the Color Pointer information
-                        glEnable( GL_COLOR_MATERIAL );
-                        glColorMaterial( GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE );
-                    }
-                    else
-                    {
-                        glDisable( GL_COLOR_MATERIAL );
-                    }
-
-                    if( mesh.m_MaterialIdx < a3DModel.m_MaterialsSize )
-                    {
-                        switch( aMaterialMode )
-                        {
-                        case MATERIAL_MODE_NORMAL:
-                            OGL_SetMaterial( a3DModel.m_Materials[mesh.m_MaterialIdx] );
-                            break;
-                        case MATERIAL_MODE_DIFFUSE_ONLY:
-                            OGL_SetDiffuseOnlyMaterial(
-                                        a3DModel.m_Materials[mesh.m_MaterialIdx].m_Diffuse );
-                            break;
-                        case MATERIAL_MODE_CAD_MODE:
-                            OGL_SetDiffuseOnlyMaterial(
-                                        MaterialDiffuseToColorCAD(
-                                            a3DModel.m_Materials[mesh.m_MaterialIdx].m_Diffuse ) );
-                            break;
-                        default:
-                            break;
-                        }
-                    }
-
-                    // Draw mesh
-                    // /////////////////////////////////////////////////////////
-                    glDrawElements( GL_TRIANGLES, mesh.m_FaceIdxSize,
-                                    GL_UNSIGNED_INT, mesh.m_FaceIdx );
-
-                    glDisable( GL_COLOR_MATERIAL );
-
-                    glEndList();
-
-                    // Disable arrays client states
-                    // /////////////////////////////////////////////////////////
-                    glDisableClientState( GL_TEXTURE_COORD_ARRAY );
-                    glDisableClientState( GL_COLOR_ARRAY );
-                    glDisableClientState( GL_NORMAL_ARRAY );
-                    glDisableClientState( GL_VERTEX_ARRAY );
-
-                    glFlush();
-
-                    delete [] pColorRGBA;
-                }
+            if( (mesh.m_Positions == NULL) ||
+                (mesh.m_Normals == NULL) ||
+                (mesh.m_FaceIdx == NULL) ||
+                (mesh.m_FaceIdxSize == 0) || (mesh.m_VertexSize == 0) )
+                continue;
+
+            // Create the bbox for this mesh
+            // /////////////////////////////////////////////////////////////////
+            m_meshs_bbox[mesh_i].Reset();
+
+            for( unsigned int vertex_i = 0;
+                 vertex_i < mesh.m_VertexSize;
+                 ++vertex_i )
+            {
+                m_meshs_bbox[mesh_i].Union( mesh.m_Positions[vertex_i] );
             }
-        }// for each mesh
 
+            // Only the meshes with a valid material are rendered
+            if( mesh.m_MaterialIdx >= a3DModel.m_MaterialsSize )
+                continue;
 
-        m_ogl_idx_list_opaque = glGenLists( 1 );
+            const SMATERIAL &material = a3DModel.m_Materials[mesh.m_MaterialIdx];
 
-        // Check if the generated list is valid
-        if( glIsList( m_ogl_idx_list_opaque ) )
-        {
-            bool have_opaque_meshes = false;
-            bool have_transparent_meshes = false;
+            MESH_DRAW meshDraw;
 
-            // Compile the model display list
-            glNewList( m_ogl_idx_list_opaque, GL_COMPILE );
+            meshDraw.m_first_index = indexes.size();
+            meshDraw.m_nr_indexes = mesh.m_FaceIdxSize;
+            meshDraw.m_have_color = mesh.m_Color != NULL;
+            meshDraw.m_diffuse_only = aMaterialMode != MATERIAL_MODE_NORMAL;
+            meshDraw.m_transparent = material.m_Transparency != 0.0f;
+            meshDraw.m_material = material;
 
-            // Render each mesh display list (opaque first)
-            // /////////////////////////////////////////////////////////////////
-            for( unsigned int mesh_i = 0; mesh_i < a3DModel.m_MeshesSize; ++mesh_i )
-            {
-                const SMESH &mesh = a3DModel.m_Meshes[mesh_i];
+            if( aMaterialMode == MATERIAL_MODE_CAD_MODE )
+                meshDraw.m_material.m_Diffuse = MaterialDiffuseToColorCAD( material.m_Diffuse );
 
-                if( mesh.m_MaterialIdx < a3DModel.m_MaterialsSize )
-                {
-                    const SMATERIAL &material = a3DModel.m_Materials[mesh.m_MaterialIdx];
-
-                    if( material.m_Transparency == 0.0f )
-                    {
-                        have_opaque_meshes = true; // Flag that we have at least one opaque mesh
-                        glCallList( m_ogl_idx_list_meshes + mesh_i );
-                    }
-                    else
-                    {
-                        have_transparent_meshes = true; // Flag that we found a transparent mesh
-                    }
-                }
-            }
+            // The alpha of the colors is only used for the transparent materials
+            // in the normal mode
+            float alpha = 1.0f;
 
-            glEndList();
+            if( (material.m_Transparency > FLT_EPSILON) &&
+                (aMaterialMode == MATERIAL_MODE_NORMAL) )
+                alpha = 1.0f - material.m_Transparency;
 
-            if( !have_opaque_meshes )
-            {
-                // If we dont have opaque meshes, we can free the list
-                glDeleteLists( m_ogl_idx_list_opaque, 1 );
-                m_ogl_idx_list_opaque = 0;
-            }
+            const unsigned int first_vertex = vertexes.size();
 
-            if( have_transparent_meshes )
+            for( unsigned int vertex_i = 0; vertex_i < mesh.m_VertexSize; ++vertex_i )
             {
-                m_ogl_idx_list_transparent = glGenLists( 1 );
+                VERTEX vertex;
 
-                // Check if the generated list is valid
-                if( glIsList( m_ogl_idx_list_transparent ) )
+                vertex.m_pos = mesh.m_Positions[vertex_i];
+                vertex.m_nrm = mesh.m_Normals[vertex_i];
+
+                SFVEC3F color( 1.0f );
+
+                if( mesh.m_Color != NULL )
                 {
-                    // Compile the model display list
-                    glNewList( m_ogl_idx_list_transparent, GL_COMPILE );
+                    color = mesh.m_Color[vertex_i];
+
+                    if( aMaterialMode == MATERIAL_MODE_CAD_MODE )
+                        color = MaterialDiffuseToColorCAD( color );
+                }
 
-                    glEnable( GL_BLEND );
-                    glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
+                vertex.m_color[0] = color_to_ubyte( color.r );
+                vertex.m_color[1] = color_to_ubyte( color.g );
+                vertex.m_color[2] = color_to_ubyte( color.b );
+                vertex.m_color[3] = color_to_ubyte( alpha );
 
-                    // Render each mesh display list
-                    // /////////////////////////////////////////////////////////
-                    for( unsigned mesh_i = 0; mesh_i < a3DModel.m_MeshesSize; ++mesh_i )
-                    {
-                        const SMESH &mesh = a3DModel.m_Meshes[mesh_i];
+                vertexes.push_back( vertex );
+            }
 
-                        if( mesh.m_MaterialIdx < a3DModel.m_MaterialsSize )
-                        {
-                            const SMATERIAL &material = a3DModel.m_Materials[mesh.m_MaterialIdx];
+            for( unsigned int idx_i = 0; idx_i < mesh.m_FaceIdxSize; ++idx_i )
+                indexes.push_back( first_vertex + mesh.m_FaceIdx[idx_i] );
 
-                            // Render the transparent mesh if it have a transparency value
-                            if( material.m_Transparency != 0.0f )
-                                glCallList( m_ogl_idx_list_meshes + mesh_i );
-                        }
-                    }
+            if( meshDraw.m_transparent )
+                m_have_transparent_meshes = true;
+            else
+                m_have_opaque_meshes = true;
 
-                    glDisable( GL_BLEND );
+            m_meshes.push_back( meshDraw );
+        }// for each mesh
 
-                    glEndList();
-                }
-                else
-                {
-                    m_ogl_idx_list_transparent = 0;
-                }
-            }
-        }
-        else
+        if( !m_meshes.empty() )
         {
-            m_ogl_idx_list_opaque = 0;
+            m_vertex_buffer = new C_OGL_BUFFER( GL_ARRAY_BUFFER_ARB,
+                                                vertexes.data(),
+                                                vertexes.size() * sizeof( VERTEX ) );
+
+            m_index_buffer = new C_OGL_BUFFER( GL_ELEMENT_ARRAY_BUFFER_ARB,
+                                               indexes.data(),
+                                               indexes.size() * sizeof( GLuint ) );
         }
 
         // Create the main bbox
@@ -318,40 +182,108 @@ C_OGL_3DMODEL::C_OGL_3DMODEL( const S3DMODEL &a3DModel,
 
         for( unsigned int mesh_i = 0; mesh_i < a3DModel.m_MeshesSize; ++mesh_i )
             m_model_bbox.Union( m_meshs_bbox[mesh_i] );
-
-        glFlush();
     }
 }
 
 
-void C_OGL_3DMODEL::Draw_opaque() const
+void C_OGL_3DMODEL::set_material( const MESH_DRAW &aMesh ) const
 {
-    if( glIsList( m_ogl_idx_list_opaque ) )
-        glCallList( m_ogl_idx_list_opaque );
+    if( aMesh.m_have_color )
+    {
+        // This enables the use of the Color Pointer information
+        glEnableClientState( GL_COLOR_ARRAY );
+        glEnable( GL_COLOR_MATERIAL );
+        glColorMaterial( GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE );
+    }
+    else
+    {
+        glDisableClientState( GL_COLOR_ARRAY );
+        glDisable( GL_COLOR_MATERIAL );
+    }
+
+    if( aMesh.m_diffuse_only )
+        OGL_SetDiffuseOnlyMaterial( aMesh.m_material.m_Diffuse );
+    else
+        OGL_SetMaterial( aMesh.m_material );
 }
 
 
-void C_OGL_3DMODEL::Draw_transparent() const
+void C_OGL_3DMODEL::draw( bool aTransparent,
+                          const glm::mat4 *aTransforms,
+                          size_t aNrTransforms ) const
 {
-    if( glIsList( m_ogl_idx_list_transparent ) )
-        glCallList( m_ogl_idx_list_transparent );
+    if( !( aTransparent ? m_have_transparent_meshes : m_have_opaque_meshes ) )
+        return;
+
+    if( aTransparent )
+    {
+        glEnable( GL_BLEND );
+        glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
+    }
+
+    const char *vertexes = m_vertex_buffer->Bind();
+
+    glEnableClientState( GL_VERTEX_ARRAY );
+    glEnableClientState( GL_NORMAL_ARRAY );
+
+    glVertexPointer( 3, GL_FLOAT, sizeof( VERTEX ), vertexes + offsetof( VERTEX, m_pos ) );
+    glNormalPointer( GL_FLOAT, sizeof( VERTEX ), vertexes + offsetof( VERTEX, m_nrm ) );
+    glColorPointer( 4, GL_UNSIGNED_BYTE, sizeof( VERTEX ),
+                    vertexes + offsetof( VERTEX, m_color ) );
+
+    const char *indexes = m_index_buffer->Bind();
+
+    // Render the meshes one by one, each one for all the instances, so that the
+    // materials are only set once
+    for( const MESH_DRAW &mesh : m_meshes )
+    {
+        if( mesh.m_transparent != aTransparent )
+            continue;
+
+        set_material( mesh );
+
+        const char *meshIndexes = indexes + mesh.m_first_index * sizeof( GLuint );
+
+        if( aTransforms == NULL )
+        {
+            C_OGL_BUFFER::DrawElements( GL_TRIANGLES, mesh.m_nr_indexes, meshIndexes );
+            continue;
+        }
+
+        for( size_t i = 0; i < aNrTransforms; ++i )
+        {
+            glPushMatrix();
+            glMultMatrixf( glm::value_ptr( aTransforms[i] ) );
+
+            C_OGL_BUFFER::DrawElements( GL_TRIANGLES, mesh.m_nr_indexes, meshIndexes );
+
+            glPopMatrix();
+        }
+    }
+
+    glDisable( GL_COLOR_MATERIAL );
+
+    // Disable arrays client states
+    // /////////////////////////////////////////////////////////////////////////
+    glDisableClientState( GL_COLOR_ARRAY );
+    glDisableClientState( GL_NORMAL_ARRAY );
+    glDisableClientState( GL_VERTEX_ARRAY );
+
+    m_index_buffer->Unbind();
+    m_vertex_buffer->Unbind();
+
+    if( aTransparent )
+        glDisable( GL_BLEND );
 }
 
 
 C_OGL_3DMODEL::~C_OGL_3DMODEL()
 {
-    if( glIsList( m_ogl_idx_list_opaque ) )
-        glDeleteLists( m_ogl_idx_list_opaque, 1 );
-
-    if( glIsList( m_ogl_idx_list_transparent ) )
-        glDeleteLists( m_ogl_idx_list_transparent, 1 );
-
-    if( glIsList( m_ogl_idx_list_meshes ) )
-        glDeleteLists( m_ogl_idx_list_meshes, m_nr_meshes );
+    delete m_vertex_buffer;
+    m_vertex_buffer = NULL;
 
-    m_ogl_idx_list_meshes = 0;
-    m_ogl_idx_list_opaque = 0;
-    m_ogl_idx_list_transparent = 0;
+    delete m_index_buffer;
+    m_index_buffer = NULL;
 
     delete[] m_meshs_bbox;
     m_meshs_bbox = NULL;
@@ -373,11 +305,11 @@ void C_OGL_3DMODEL::Draw_bboxes() const
 
 bool C_OGL_3DMODEL::Have_opaque() const
 {
-    return glIsList( m_ogl_idx_list_opaque );
+    return m_have_opaque_meshes;
 }
 
 
 bool C_OGL_3DMODEL::Have_transparent() const
 {
-    return glIsList( m_ogl_idx_list_transparent );
+    return m_have_transparent_meshes;
 }
@@ -34,6 +34,8 @@
 #include "../../common_ogl/openGL_includes.h"
 #include "../3d_render_raytracing/shapes3D/cbbox.h"
 #include "../../3d_enums.h"
+#include "c_ogl_buffer.h"
+#include <vector>
 
 /// 
 class  C_OGL_3DMODEL
@@ -51,12 +53,32 @@ public:
     /**
      * @brief Draw_opaque - render the model into the current context
      */
-    void Draw_opaque() const;
+    void Draw_opaque() const { draw( false, NULL, 0 ); }
 
     /**
      * @brief Draw_transparent - render the model into the current context
      */
-    void Draw_transparent() const;
+    void Draw_transparent() const { draw( true, NULL, 0 ); }
+
+    /**
+     * @brief Draw_opaque - render instances of the model into the current context,
+     * binding the buffers and setting the materials once for all the instances
+     * @param aTransforms: the transformation of each instance, applied to the
+     *                     current modelview matrix
+     */
+    void Draw_opaque( const std::vector<glm::mat4> &aTransforms ) const
+    {
+        draw( false, aTransforms.data(), aTransforms.size() );
+    }
+
+    /**
+     * @brief Draw_transparent - render instances of the model into the current
+     * context, see Draw_opaque
+     */
+    void Draw_transparent( const std::vector<glm::mat4> &aTransforms ) const
+    {
+        draw( true, aTransforms.data(), aTransforms.size() );
+    }
 
     /**
      * @brief Have_opaque - return true if have opaque meshs to render
@@ -85,9 +107,34 @@ public:
     const CBBOX &GetBBox() const { return m_model_bbox; }
 
 private:
-    GLuint  m_ogl_idx_list_opaque;      ///< display list for rendering opaque meshes
-    GLuint  m_ogl_idx_list_transparent; ///< display list for rendering transparent meshes
-    GLuint  m_ogl_idx_list_meshes;      ///< display lists for all meshes.
+    /// A vertex of the vertex buffer, which holds the vertexes of all the meshes
+    struct VERTEX
+    {
+        SFVEC3F m_pos;
+        SFVEC3F m_nrm;
+        GLubyte m_color[4];
+    };
+
+    /// The range of a mesh in the index buffer, and how to render it
+    struct MESH_DRAW
+    {
+        unsigned int m_first_index;     ///< first index of the mesh in the index buffer
+        unsigned int m_nr_indexes;
+        bool         m_have_color;      ///< the vertexes have colors
+        bool         m_diffuse_only;    ///< only the diffuse color of the material is used
+        bool         m_transparent;
+        SMATERIAL    m_material;
+    };
+
+    void draw( bool aTransparent, const glm::mat4 *aTransforms, size_t aNrTransforms ) const;
+
+    void set_material( const MESH_DRAW &aMesh ) const;
+
+    C_OGL_BUFFER *m_vertex_buffer;      ///< vertexes of all meshes
+    C_OGL_BUFFER *m_index_buffer;       ///< indexes of all meshes, in the vertex buffer
+    std::vector<MESH_DRAW> m_meshes;    ///< meshes to render
+    bool    m_have_opaque_meshes;
+    bool    m_have_transparent_meshes;
     unsigned int m_nr_meshes;           ///< number of meshes of this model
 
     CBBOX   m_model_bbox;               ///< global bounding box for this model
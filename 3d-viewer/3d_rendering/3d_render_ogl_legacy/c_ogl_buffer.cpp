@@ -0,0 +1,102 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file  c_ogl_buffer.cpp
+ * @brief
+ */
+
+#include <GL/glew.h>    // Must be included first
+#include "c_ogl_buffer.h"
+
+
+unsigned int C_OGL_BUFFER::s_draw_calls = 0;
+
+
+C_OGL_BUFFER::C_OGL_BUFFER( GLenum aTarget, const void *aData, size_t aSize )
+{
+    m_target = aTarget;
+    m_buffer_id = 0;
+    m_size = aSize;
+
+    // GLEW is not initialized in all the contexts (i.e.: the 3D model preview), so
+    // the buffer objects are only used when they are known to be supported
+    if( GLEW_ARB_vertex_buffer_object )
+    {
+        glGenBuffersARB( 1, &m_buffer_id );
+        glBindBufferARB( m_target, m_buffer_id );
+        glBufferDataARB( m_target, aSize, aData, GL_STATIC_DRAW_ARB );
+        glBindBufferARB( m_target, 0 );
+    }
+
+    if( m_buffer_id == 0 )
+    {
+        const char *data = static_cast<const char *>( aData );
+
+        m_data.assign( data, data + aSize );
+    }
+}
+
+
+C_OGL_BUFFER::~C_OGL_BUFFER()
+{
+    if( m_buffer_id )
+        glDeleteBuffersARB( 1, &m_buffer_id );
+
+    m_buffer_id = 0;
+}
+
+
+const char *C_OGL_BUFFER::Bind() const
+{
+    if( m_buffer_id )
+    {
+        glBindBufferARB( m_target, m_buffer_id );
+
+        // The gl*Pointer functions take offsets in the bound buffer
+        return NULL;
+    }
+
+    return m_data.data();
+}
+
+
+void C_OGL_BUFFER::Unbind() const
+{
+    if( m_buffer_id )
+        glBindBufferARB( m_target, 0 );
+}
+
+
+void C_OGL_BUFFER::DrawArrays( GLenum aMode, GLint aFirst, GLsizei aCount )
+{
+    glDrawArrays( aMode, aFirst, aCount );
+    s_draw_calls++;
+}
+
+
+void C_OGL_BUFFER::DrawElements( GLenum aMode, GLsizei aCount, const char *aIndexes )
+{
+    glDrawElements( aMode, aCount, GL_UNSIGNED_INT, aIndexes );
+    s_draw_calls++;
+}
@@ -0,0 +1,111 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file  c_ogl_buffer.h
+ * @brief vertex and index buffers of the legacy openGL render
+ */
+
+#ifndef _C_OGL_BUFFER_H_
+#define _C_OGL_BUFFER_H_
+
+#include "../../common_ogl/openGL_includes.h"
+#include <cstddef>
+#include <vector>
+
+
+/**
+ * @brief The C_OGL_BUFFER class stores vertex or index data: in an openGL buffer
+ * object (VBO) when the driver supports them, or else in memory, used as a
+ * client side array. The draw calls of the legacy render go through this class
+ * so that they can be counted.
+ */
+class C_OGL_BUFFER
+{
+public:
+    /**
+     * @brief C_OGL_BUFFER - Store the data. This must be called inside a gl context
+     * @param aTarget: GL_ARRAY_BUFFER_ARB for vertex data or
+     *                 GL_ELEMENT_ARRAY_BUFFER_ARB for indexes
+     * @param aData: the data to store
+     * @param aSize: the size of the data, in bytes
+     */
+    C_OGL_BUFFER( GLenum aTarget, const void *aData, size_t aSize );
+
+    ~C_OGL_BUFFER();
+
+    /**
+     * @brief Bind - bind the buffer to its target
+     * @return the address of the start of the data, to be used (with an offset)
+     *         for the gl*Pointer functions and glDrawElements
+     */
+    const char *Bind() const;
+
+    /**
+     * @brief Unbind - unbind the buffer from its target
+     */
+    void Unbind() const;
+
+    /**
+     * @brief IsBufferObject - return true if the data is stored in the GPU
+     */
+    bool IsBufferObject() const { return m_buffer_id != 0; }
+
+    /**
+     * @brief GetSize - return the size of the data, in bytes
+     */
+    size_t GetSize() const { return m_size; }
+
+    /**
+     * @brief DrawArrays - glDrawArrays, counted in the draw calls
+     */
+    static void DrawArrays( GLenum aMode, GLint aFirst, GLsizei aCount );
+
+    /**
+     * @brief DrawElements - glDrawElements of GL_UNSIGNED_INT indexes, counted in
+     * the draw calls
+     */
+    static void DrawElements( GLenum aMode, GLsizei aCount, const char *aIndexes );
+
+    /**
+     * @brief GetDrawCallCount - return the number of draw calls since the last
+     * ResetDrawCallCount()
+     */
+    static unsigned int GetDrawCallCount() { return s_draw_calls; }
+
+    static void ResetDrawCallCount() { s_draw_calls = 0; }
+
+private:
+    // prohibit copies, which would delete the buffer object twice
+    C_OGL_BUFFER( const C_OGL_BUFFER& );
+    C_OGL_BUFFER& operator=( const C_OGL_BUFFER& );
+
+    GLenum              m_target;
+    GLuint              m_buffer_id;    ///< buffer object, 0 if not supported
+    size_t              m_size;
+    std::vector<char>   m_data;         ///< the data, if there is no buffer object
+
+    static unsigned int s_draw_calls;
+};
+
+#endif // _C_OGL_BUFFER_H_
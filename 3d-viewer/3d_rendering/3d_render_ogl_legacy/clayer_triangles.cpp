@@ -28,8 +28,10 @@
  */
 
 
+#include <GL/glew.h>    // Must be included first
 #include "clayer_triangles.h"
 #include <wx/debug.h>   // For the wxASSERT
+#include <cstddef>
 #include <mutex>
 #include <thread>
 #include <atomic>
@@ -329,11 +331,12 @@ CLAYERS_OGL_DISP_LISTS::CLAYERS_OGL_DISP_LISTS( const CLAYER_TRIANGLES &aLayerTr
     m_zBot = aZBot;
     m_zTop = aZTop;
 
-    m_layer_top_segment_ends        = 0;
-    m_layer_top_triangles           = 0;
-    m_layer_middle_contourns_quads  = 0;
-    m_layer_bot_triangles           = 0;
-    m_layer_bot_segment_ends        = 0;
+    m_texture_seg_ends              = 0;
+    m_layer_top_segment_ends        = NULL;
+    m_layer_top_triangles           = NULL;
+    m_layer_middle_contourns_quads  = NULL;
+    m_layer_bot_triangles           = NULL;
+    m_layer_bot_segment_ends        = NULL;
 
     if( aTextureIndexForSegEnds )
     {
@@ -341,23 +344,19 @@ CLAYERS_OGL_DISP_LISTS::CLAYERS_OGL_DISP_LISTS( const CLAYER_TRIANGLES &aLayerTr
 
         if( glIsTexture( aTextureIndexForSegEnds ) )
         {
+            m_texture_seg_ends = aTextureIndexForSegEnds;
+
             m_layer_top_segment_ends =
-                    generate_top_or_bot_seg_ends( aLayerTriangles.m_layer_top_segment_ends,
-                                                  true,
-                                                  aTextureIndexForSegEnds );
+                    generate_top_or_bot_seg_ends( aLayerTriangles.m_layer_top_segment_ends );
 
             m_layer_bot_segment_ends =
-                    generate_top_or_bot_seg_ends( aLayerTriangles.m_layer_bot_segment_ends,
-                                                  false,
-                                                  aTextureIndexForSegEnds );
+                    generate_top_or_bot_seg_ends( aLayerTriangles.m_layer_bot_segment_ends );
         }
     }
 
-    m_layer_top_triangles = generate_top_or_bot_triangles( aLayerTriangles.m_layer_top_triangles,
-                                                           true );
+    m_layer_top_triangles = generate_top_or_bot_triangles( aLayerTriangles.m_layer_top_triangles );
 
-    m_layer_bot_triangles = generate_top_or_bot_triangles( aLayerTriangles.m_layer_bot_triangles,
-                                                           false );
+    m_layer_bot_triangles = generate_top_or_bot_triangles( aLayerTriangles.m_layer_bot_triangles );
 
 
     if( aLayerTriangles.m_layer_middle_contourns_quads->GetVertexSize() > 0 )
@@ -375,26 +374,17 @@ CLAYERS_OGL_DISP_LISTS::CLAYERS_OGL_DISP_LISTS( const CLAYER_TRIANGLES &aLayerTr
 
 CLAYERS_OGL_DISP_LISTS::~CLAYERS_OGL_DISP_LISTS()
 {
-    if( glIsList( m_layer_top_segment_ends ) )
-        glDeleteLists( m_layer_top_segment_ends, 1 );
-
-    if( glIsList( m_layer_top_triangles ) )
-        glDeleteLists( m_layer_top_triangles, 1 );
-
-    if( glIsList( m_layer_middle_contourns_quads ) )
-        glDeleteLists( m_layer_middle_contourns_quads, 1 );
-
-    if( glIsList( m_layer_bot_triangles ) )
-        glDeleteLists( m_layer_bot_triangles, 1 );
-
-    if( glIsList( m_layer_bot_segment_ends ) )
-        glDeleteLists( m_layer_bot_segment_ends, 1 );
+    delete m_layer_top_segment_ends;
+    delete m_layer_top_triangles;
+    delete m_layer_middle_contourns_quads;
+    delete m_layer_bot_triangles;
+    delete m_layer_bot_segment_ends;
 
-    m_layer_top_segment_ends        = 0;
-    m_layer_top_triangles           = 0;
-    m_layer_middle_contourns_quads  = 0;
-    m_layer_bot_triangles           = 0;
-    m_layer_bot_segment_ends        = 0;
+    m_layer_top_segment_ends        = NULL;
+    m_layer_top_triangles           = NULL;
+    m_layer_middle_contourns_quads  = NULL;
+    m_layer_bot_triangles           = NULL;
+    m_layer_bot_segment_ends        = NULL;
 }
 
 
@@ -402,14 +392,11 @@ void CLAYERS_OGL_DISP_LISTS::DrawTopAndMiddle() const
 {
     beginTransformation();
 
-    if( glIsList( m_layer_middle_contourns_quads ) )
-        glCallList( m_layer_middle_contourns_quads );
+    draw_middle_triangles( m_layer_middle_contourns_quads );
 
-    if( glIsList( m_layer_top_triangles ) )
-        glCallList( m_layer_top_triangles );
+    draw_top_or_bot_triangles( m_layer_top_triangles, true );
 
-    if( glIsList( m_layer_top_segment_ends ) )
-        glCallList( m_layer_top_segment_ends );
+    draw_top_or_bot_seg_ends( m_layer_top_segment_ends, true );
 
     endTransformation();
 }
@@ -419,14 +406,11 @@ void CLAYERS_OGL_DISP_LISTS::DrawBotAndMiddle() const
 {
     beginTransformation();
 
-    if( glIsList( m_layer_middle_contourns_quads ) )
-        glCallList( m_layer_middle_contourns_quads );
+    draw_middle_triangles( m_layer_middle_contourns_quads );
 
-    if( glIsList( m_layer_bot_triangles ) )
-        glCallList( m_layer_bot_triangles );
+    draw_top_or_bot_triangles( m_layer_bot_triangles, false );
 
-    if( glIsList( m_layer_bot_segment_ends ) )
-        glCallList( m_layer_bot_segment_ends );
+    draw_top_or_bot_seg_ends( m_layer_bot_segment_ends, false );
 
     endTransformation();
 }
@@ -436,11 +420,9 @@ void CLAYERS_OGL_DISP_LISTS::DrawTop() const
 {
     beginTransformation();
 
-    if( glIsList( m_layer_top_triangles ) )
-        glCallList( m_layer_top_triangles );
+    draw_top_or_bot_triangles( m_layer_top_triangles, true );
 
-    if( glIsList( m_layer_top_segment_ends ) )
-        glCallList( m_layer_top_segment_ends );
+    draw_top_or_bot_seg_ends( m_layer_top_segment_ends, true );
 
     endTransformation();
 }
@@ -450,11 +432,9 @@ void CLAYERS_OGL_DISP_LISTS::DrawBot() const
 {
     beginTransformation();
 
-    if( glIsList( m_layer_bot_triangles ) )
-        glCallList( m_layer_bot_triangles );
+    draw_top_or_bot_triangles( m_layer_bot_triangles, false );
 
-    if( glIsList( m_layer_bot_segment_ends ) )
-        glCallList( m_layer_bot_segment_ends );
+    draw_top_or_bot_seg_ends( m_layer_bot_segment_ends, false );
 
     endTransformation();
 }
@@ -464,8 +444,7 @@ void CLAYERS_OGL_DISP_LISTS::DrawMiddle() const
 {
     beginTransformation();
 
-    if( glIsList( m_layer_middle_contourns_quads ) )
-        glCallList( m_layer_middle_contourns_quads );
+    draw_middle_triangles( m_layer_middle_contourns_quads );
 
     endTransformation();
 }
@@ -476,20 +455,15 @@ void CLAYERS_OGL_DISP_LISTS::DrawAll( bool aDrawMiddle ) const
     beginTransformation();
 
     if( aDrawMiddle )
-        if( glIsList( m_layer_middle_contourns_quads ) )
-            glCallList( m_layer_middle_contourns_quads );
+        draw_middle_triangles( m_layer_middle_contourns_quads );
 
-    if( glIsList( m_layer_top_triangles ) )
-        glCallList( m_layer_top_triangles );
+    draw_top_or_bot_triangles( m_layer_top_triangles, true );
 
-    if( glIsList( m_layer_bot_triangles ) )
-        glCallList( m_layer_bot_triangles );
+    draw_top_or_bot_triangles( m_layer_bot_triangles, false );
 
-    if( glIsList( m_layer_top_segment_ends ) )
-        glCallList( m_layer_top_segment_ends );
+    draw_top_or_bot_seg_ends( m_layer_top_segment_ends, true );
 
-    if( glIsList( m_layer_bot_segment_ends ) )
-        glCallList( m_layer_bot_segment_ends );
+    draw_top_or_bot_seg_ends( m_layer_bot_segment_ends, false );
 
     endTransformation();
 }
@@ -637,10 +611,8 @@ void CLAYERS_OGL_DISP_LISTS::SetItIsTransparent( bool aSetTransparent )
 }
 
 
-GLuint CLAYERS_OGL_DISP_LISTS::generate_top_or_bot_seg_ends(
-        const CLAYER_TRIANGLE_CONTAINER *aTriangleContainer,
-        bool aIsNormalUp,
-        GLuint aTextureId ) const
+C_OGL_BUFFER *CLAYERS_OGL_DISP_LISTS::generate_top_or_bot_seg_ends(
+        const CLAYER_TRIANGLE_CONTAINER *aTriangleContainer ) const
 {
     wxASSERT( aTriangleContainer != NULL );
 
@@ -652,66 +624,34 @@ GLuint CLAYERS_OGL_DISP_LISTS::generate_top_or_bot_seg_ends(
     if( (aTriangleContainer->GetVertexSize() > 0) &&
         ((aTriangleContainer->GetVertexSize() % 3) == 0) )
     {
-        GLuint listIdx = glGenLists( 1 );
+        // Add the UV text coordinates to the vertexes
+        const SFVEC3F *vertexs = (const SFVEC3F *)aTriangleContainer->GetVertexPointer();
+        std::vector<SEG_END_VERTEX> segEnds( aTriangleContainer->GetVertexSize() );
 
-        if( glIsList( listIdx ) )
+        for( unsigned int i = 0;
+             i < aTriangleContainer->GetVertexSize();
+             i += 3 )
         {
-            // Prepare an array of UV text coordinates
-            SFVEC2F *uvArray = new SFVEC2F[aTriangleContainer->GetVertexSize()];
-
-            for( unsigned int i = 0;
-                 i < aTriangleContainer->GetVertexSize();
-                 i += 3 )
-            {
-                uvArray[i + 0] = SFVEC2F( 1.0f, 0.0f );
-                uvArray[i + 1] = SFVEC2F( 0.0f, 1.0f );
-                uvArray[i + 2] = SFVEC2F( 0.0f, 0.0f );
-            }
-
-            glEnableClientState( GL_TEXTURE_COORD_ARRAY );
-            glDisableClientState( GL_COLOR_ARRAY );
-            glDisableClientState( GL_NORMAL_ARRAY );
-            glEnableClientState( GL_VERTEX_ARRAY );
-            glVertexPointer( 3, GL_FLOAT, 0, aTriangleContainer->GetVertexPointer() );
-            glTexCoordPointer( 2, GL_FLOAT, 0, uvArray );
-
-            glNewList( listIdx, GL_COMPILE );
-
-            glDisable( GL_COLOR_MATERIAL );
-
-            glEnable( GL_TEXTURE_2D );
-            glBindTexture( GL_TEXTURE_2D, aTextureId );
-
-            setBlendfunction();
+            segEnds[i + 0].m_uv = SFVEC2F( 1.0f, 0.0f );
+            segEnds[i + 1].m_uv = SFVEC2F( 0.0f, 1.0f );
+            segEnds[i + 2].m_uv = SFVEC2F( 0.0f, 0.0f );
 
-            glAlphaFunc( GL_GREATER, 0.2f );
-            glEnable( GL_ALPHA_TEST );
-
-            glNormal3f( 0.0f, 0.0f, aIsNormalUp?1.0f:-1.0f );
-
-            glDrawArrays( GL_TRIANGLES, 0, aTriangleContainer->GetVertexSize() );
-
-            glDisable( GL_TEXTURE_2D );
-            glDisable( GL_ALPHA_TEST );
-            glDisable( GL_BLEND );
-
-            glEndList();
-
-            glDisableClientState( GL_VERTEX_ARRAY );
-            glDisableClientState( GL_TEXTURE_COORD_ARRAY );
-
-            delete [] uvArray;
-            return listIdx;
+            segEnds[i + 0].m_pos = vertexs[i + 0];
+            segEnds[i + 1].m_pos = vertexs[i + 1];
+            segEnds[i + 2].m_pos = vertexs[i + 2];
         }
+
+        return new C_OGL_BUFFER( GL_ARRAY_BUFFER_ARB,
+                                 segEnds.data(),
+                                 segEnds.size() * sizeof( SEG_END_VERTEX ) );
     }
 
-    return 0;
+    return NULL;
 }
 
 
-GLuint CLAYERS_OGL_DISP_LISTS::generate_top_or_bot_triangles(
-        const CLAYER_TRIANGLE_CONTAINER *aTriangleContainer,
-        bool aIsNormalUp ) const
+C_OGL_BUFFER *CLAYERS_OGL_DISP_LISTS::generate_top_or_bot_triangles(
+        const CLAYER_TRIANGLE_CONTAINER *aTriangleContainer ) const
 {
     wxASSERT( aTriangleContainer != NULL );
 
@@ -723,38 +663,16 @@ GLuint CLAYERS_OGL_DISP_LISTS::generate_top_or_bot_triangles(
     if( (aTriangleContainer->GetVertexSize() > 0) &&
         ( (aTriangleContainer->GetVertexSize() % 3) == 0) )
     {
-        const GLuint listIdx = glGenLists( 1 );
-
-        if( glIsList( listIdx ) )
-        {
-            glDisableClientState( GL_TEXTURE_COORD_ARRAY );
-            glDisableClientState( GL_COLOR_ARRAY );
-            glDisableClientState( GL_NORMAL_ARRAY );
-            glEnableClientState( GL_VERTEX_ARRAY );
-            glVertexPointer( 3, GL_FLOAT, 0, aTriangleContainer->GetVertexPointer() );
-
-            glNewList( listIdx, GL_COMPILE );
-
-            setBlendfunction();
-
-            glNormal3f( 0.0f, 0.0f, aIsNormalUp?1.0f:-1.0f );
-
-            glDrawArrays( GL_TRIANGLES, 0, aTriangleContainer->GetVertexSize() );
-
-            glDisable( GL_BLEND );
-            glEndList();
-
-            glDisableClientState( GL_VERTEX_ARRAY );
-
-            return listIdx;
-        }
+        return new C_OGL_BUFFER( GL_ARRAY_BUFFER_ARB,
+                                 aTriangleContainer->GetVertexPointer(),
+                                 aTriangleContainer->GetVertexSize() * sizeof( SFVEC3F ) );
     }
 
-    return 0;
+    return NULL;
 }
 
 
-GLuint CLAYERS_OGL_DISP_LISTS::generate_middle_triangles(
+C_OGL_BUFFER *CLAYERS_OGL_DISP_LISTS::generate_middle_triangles(
         const CLAYER_TRIANGLE_CONTAINER *aTriangleContainer ) const
 {
     wxASSERT( aTriangleContainer != NULL );
@@ -774,34 +692,114 @@ GLuint CLAYERS_OGL_DISP_LISTS::generate_middle_triangles(
         ( (aTriangleContainer->GetVertexSize() % 6) == 0 ) &&
         ( aTriangleContainer->GetNormalsSize() == aTriangleContainer->GetVertexSize() ) )
     {
-        const GLuint listIdx = glGenLists( 1 );
+        // Interleave the vertexes and the normals
+        const SFVEC3F *vertexs = (const SFVEC3F *)aTriangleContainer->GetVertexPointer();
+        const SFVEC3F *normals = (const SFVEC3F *)aTriangleContainer->GetNormalsPointer();
+        std::vector<MIDDLE_VERTEX> middle( aTriangleContainer->GetVertexSize() );
 
-        if( glIsList( listIdx ) )
+        for( unsigned int i = 0; i < aTriangleContainer->GetVertexSize(); ++i )
         {
-            glDisableClientState( GL_TEXTURE_COORD_ARRAY );
-            glDisableClientState( GL_COLOR_ARRAY );
-            glEnableClientState( GL_NORMAL_ARRAY );
-            glEnableClientState( GL_VERTEX_ARRAY );
-            glVertexPointer( 3, GL_FLOAT, 0, aTriangleContainer->GetVertexPointer() );
-            glNormalPointer( GL_FLOAT, 0, aTriangleContainer->GetNormalsPointer() );
+            middle[i].m_pos = vertexs[i];
+            middle[i].m_nrm = normals[i];
+        }
 
-            glNewList( listIdx, GL_COMPILE );
+        return new C_OGL_BUFFER( GL_ARRAY_BUFFER_ARB,
+                                 middle.data(),
+                                 middle.size() * sizeof( MIDDLE_VERTEX ) );
+    }
 
-            setBlendfunction();
+    return NULL;
+}
 
-            glDrawArrays( GL_TRIANGLES, 0, aTriangleContainer->GetVertexSize() );
 
-            glDisable( GL_BLEND );
-            glEndList();
+void CLAYERS_OGL_DISP_LISTS::draw_top_or_bot_seg_ends( const C_OGL_BUFFER *aBuffer,
+                                                       bool aIsNormalUp ) const
+{
+    if( aBuffer == NULL )
+        return;
 
-            glDisableClientState( GL_VERTEX_ARRAY );
-            glDisableClientState( GL_NORMAL_ARRAY );
+    const char *vertexs = aBuffer->Bind();
 
-            return listIdx;
-        }
-    }
+    glEnableClientState( GL_TEXTURE_COORD_ARRAY );
+    glEnableClientState( GL_VERTEX_ARRAY );
+    glVertexPointer( 3, GL_FLOAT, sizeof( SEG_END_VERTEX ),
+                     vertexs + offsetof( SEG_END_VERTEX, m_pos ) );
+    glTexCoordPointer( 2, GL_FLOAT, sizeof( SEG_END_VERTEX ),
+                       vertexs + offsetof( SEG_END_VERTEX, m_uv ) );
+
+    glDisable( GL_COLOR_MATERIAL );
+
+    glEnable( GL_TEXTURE_2D );
+    glBindTexture( GL_TEXTURE_2D, m_texture_seg_ends );
+
+    setBlendfunction();
+
+    glAlphaFunc( GL_GREATER, 0.2f );
+    glEnable( GL_ALPHA_TEST );
+
+    glNormal3f( 0.0f, 0.0f, aIsNormalUp?1.0f:-1.0f );
+
+    C_OGL_BUFFER::DrawArrays( GL_TRIANGLES, 0,
+                              aBuffer->GetSize() / sizeof( SEG_END_VERTEX ) );
+
+    glDisable( GL_TEXTURE_2D );
+    glDisable( GL_ALPHA_TEST );
+    glDisable( GL_BLEND );
+
+    glDisableClientState( GL_VERTEX_ARRAY );
+    glDisableClientState( GL_TEXTURE_COORD_ARRAY );
+
+    aBuffer->Unbind();
+}
+
+
+void CLAYERS_OGL_DISP_LISTS::draw_top_or_bot_triangles( const C_OGL_BUFFER *aBuffer,
+                                                        bool aIsNormalUp ) const
+{
+    if( aBuffer == NULL )
+        return;
+
+    glEnableClientState( GL_VERTEX_ARRAY );
+    glVertexPointer( 3, GL_FLOAT, 0, aBuffer->Bind() );
+
+    setBlendfunction();
+
+    glNormal3f( 0.0f, 0.0f, aIsNormalUp?1.0f:-1.0f );
+
+    C_OGL_BUFFER::DrawArrays( GL_TRIANGLES, 0, aBuffer->GetSize() / sizeof( SFVEC3F ) );
+
+    glDisable( GL_BLEND );
+
+    glDisableClientState( GL_VERTEX_ARRAY );
+
+    aBuffer->Unbind();
+}
+
+
+void CLAYERS_OGL_DISP_LISTS::draw_middle_triangles( const C_OGL_BUFFER *aBuffer ) const
+{
+    if( aBuffer == NULL )
+        return;
+
+    const char *vertexs = aBuffer->Bind();
+
+    glEnableClientState( GL_NORMAL_ARRAY );
+    glEnableClientState( GL_VERTEX_ARRAY );
+    glVertexPointer( 3, GL_FLOAT, sizeof( MIDDLE_VERTEX ),
+                     vertexs + offsetof( MIDDLE_VERTEX, m_pos ) );
+    glNormalPointer( GL_FLOAT, sizeof( MIDDLE_VERTEX ),
+                     vertexs + offsetof( MIDDLE_VERTEX, m_nrm ) );
+
+    setBlendfunction();
+
+    C_OGL_BUFFER::DrawArrays( GL_TRIANGLES, 0, aBuffer->GetSize() / sizeof( MIDDLE_VERTEX ) );
+
+    glDisable( GL_BLEND );
+
+    glDisableClientState( GL_VERTEX_ARRAY );
+    glDisableClientState( GL_NORMAL_ARRAY );
 
-    return 0;
+    aBuffer->Unbind();
 }
 
 
@@ -31,6 +31,7 @@
 #define CLAYER_TRIANGLES_H_
 
 #include "../../common_ogl/openGL_includes.h"
+#include "c_ogl_buffer.h"
 #include <plugins/3dapi/xv3d_types.h>
 #include <geometry/shape_line_chain.h>
 #include <geometry/shape_poly_set.h>
@@ -134,7 +135,7 @@ private:
 
 /**
  * @brief The CLAYER_TRIANGLES class stores arrays of triangles to be used to
- * create display lists
+ * create vertex buffers
  */
 class CLAYER_TRIANGLES
 {
@@ -186,16 +187,16 @@ public:
 
 
 /**
- * @brief The CLAYERS_OGL_DISP_LISTS class stores the openGL display lists to
+ * @brief The CLAYERS_OGL_DISP_LISTS class stores the openGL vertex buffers
  * related with a layer
  */
 class CLAYERS_OGL_DISP_LISTS
 {
 public:
     /**
-     * @brief CLAYERS_OGL_DISP_LISTS - Creates the display lists for a layer
-     * @param aLayerTriangles: contains the layers array of vertex to render to
-     *                         display lists
+     * @brief CLAYERS_OGL_DISP_LISTS - Creates the vertex buffers for a layer
+     * @param aLayerTriangles: contains the layers array of vertex to store in
+     *                         vertex buffers
      * @param aTextureIndexForSegEnds: texture index to be used by segment ends.
      *                                 It is a black and white squared texture
      *                                 with a center circle diameter of the size
@@ -207,41 +208,41 @@ public:
                             float aZTop );
 
     /**
-     * @brief ~CLAYERS_OGL_DISP_LISTS - Destroy this class while free the display
-     * lists from GPU mem
+     * @brief ~CLAYERS_OGL_DISP_LISTS - Destroy this class while free the vertex
+     * buffers from GPU mem
      */
     ~CLAYERS_OGL_DISP_LISTS();
 
     /**
-     * @brief DrawTopAndMiddle - This function calls the display lists for the
+     * @brief DrawTopAndMiddle - This function draws the buffers for the
      * top elements and middle contourns
      */
     void DrawTopAndMiddle() const;
 
     /**
-     * @brief DrawBotAndMiddle - This function calls the display lists for the
+     * @brief DrawBotAndMiddle - This function draws the buffers for the
      * botton elements and middle contourns
      */
     void DrawBotAndMiddle() const;
 
     /**
-     * @brief DrawTop - This function calls the display lists for the top elements
+     * @brief DrawTop - This function draws the buffers for the top elements
      */
     void DrawTop() const;
 
     /**
-     * @brief DrawBot - This function calls the display lists for the botton elements
+     * @brief DrawBot - This function draws the buffers for the botton elements
      */
     void DrawBot() const;
 
     /**
-     * @brief DrawMiddle - This function calls the display lists for the middle
+     * @brief DrawMiddle - This function draws the buffers for the middle
      * elements
      */
     void DrawMiddle() const;
 
     /**
-     * @brief DrawAll - This function calls all the display lists
+     * @brief DrawAll - This function draws all the buffers
      */
     void DrawAll( bool aDrawMiddle = true ) const;
 
@@ -267,14 +268,34 @@ public:
     float GetZTop() const { return m_zTop; }
 
 private:
-    GLuint generate_top_or_bot_seg_ends( const CLAYER_TRIANGLE_CONTAINER * aTriangleContainer,
-                                         bool aIsNormalUp,
-                                         GLuint aTextureId ) const;
+    /// A vertex of the segment ends, with its texture coordinates
+    struct SEG_END_VERTEX
+    {
+        SFVEC3F m_pos;
+        SFVEC2F m_uv;
+    };
 
-    GLuint generate_top_or_bot_triangles( const CLAYER_TRIANGLE_CONTAINER * aTriangleContainer,
-                                          bool aIsNormalUp ) const;
+    /// A vertex of the middle contourns, with its normal
+    struct MIDDLE_VERTEX
+    {
+        SFVEC3F m_pos;
+        SFVEC3F m_nrm;
+    };
 
-    GLuint generate_middle_triangles( const CLAYER_TRIANGLE_CONTAINER * aTriangleContainer ) const;
+    C_OGL_BUFFER *generate_top_or_bot_seg_ends(
+            const CLAYER_TRIANGLE_CONTAINER * aTriangleContainer ) const;
+
+    C_OGL_BUFFER *generate_top_or_bot_triangles(
+            const CLAYER_TRIANGLE_CONTAINER * aTriangleContainer ) const;
+
+    C_OGL_BUFFER *generate_middle_triangles(
+            const CLAYER_TRIANGLE_CONTAINER * aTriangleContainer ) const;
+
+    void draw_top_or_bot_seg_ends( const C_OGL_BUFFER *aBuffer, bool aIsNormalUp ) const;
+
+    void draw_top_or_bot_triangles( const C_OGL_BUFFER *aBuffer, bool aIsNormalUp ) const;
+
+    void draw_middle_triangles( const C_OGL_BUFFER *aBuffer ) const;
 
     void beginTransformation() const;
     void endTransformation() const;
@@ -284,11 +305,12 @@ private:
 private:
     float   m_zBot;
     float   m_zTop;
-    GLuint  m_layer_top_segment_ends;
-    GLuint  m_layer_top_triangles;
-    GLuint  m_layer_middle_contourns_quads;
-    GLuint  m_layer_bot_triangles;
-    GLuint  m_layer_bot_segment_ends;
+    GLuint  m_texture_seg_ends;     ///< texture of the segment ends, not owned
+    C_OGL_BUFFER *m_layer_top_segment_ends;
+    C_OGL_BUFFER *m_layer_top_triangles;
+    C_OGL_BUFFER *m_layer_middle_contourns_quads;
+    C_OGL_BUFFER *m_layer_bot_triangles;
+    C_OGL_BUFFER *m_layer_bot_segment_ends;
 
     bool    m_haveTransformation;
     float   m_zPositionTransformation;
@@ -1198,6 +1198,25 @@ void C3D_RENDER_RAYTRACING::add_3D_vias_and_pads_to_container()
 
 void C3D_RENDER_RAYTRACING::load_3D_models()
 {
+    // Load the models of the displayed modules in parallel first
+    std::vector<wxString> modelFiles;
+
+    for( const MODULE* module = m_settings.GetBoard()->m_Modules;
+         module;
+         module = module->Next() )
+    {
+        if( !m_settings.ShouldModuleBeDisplayed( (MODULE_ATTR_T)module->GetAttributes() ) )
+            continue;
+
+        for( const MODULE_3D_SETTINGS& model : module->Models() )
+        {
+            if( !model.m_Filename.empty() )
+                modelFiles.push_back( model.m_Filename );
+        }
+    }
+
+    m_settings.Get3DCacheManager()->PrefetchModels( modelFiles );
+
     // Go for all modules
     for( const MODULE* module = m_settings.GetBoard()->m_Modules;
          module;
@@ -30,7 +30,6 @@
 #include <GL/glew.h>
 #include <climits>
 #include <atomic>
-#include <thread>
 #include <chrono>
 
 #include "c3d_render_raytracing.h"
@@ -40,6 +39,7 @@
 #include "3d_math.h"
 #include "../common_ogl/ogl_utils.h"
 #include <profile.h>        // To use GetRunningMicroSecs or another profiling utility
+#include <thread_pool.h>
 
 // This should be used in future for the function
 // convertLinearToSRGB
@@ -369,14 +369,16 @@ void C3D_RENDER_RAYTRACING::rt_render_tracing( GLubyte *ptrPBO ,
 
     std::atomic<size_t> numBlocksRendered( 0 );
     std::atomic<size_t> currentBlock( 0 );
-    std::atomic<size_t> threadsFinished( 0 );
 
     size_t parallelThreadCount = std::min<size_t>(
-            std::max<size_t>( std::thread::hardware_concurrency(), 2 ),
+            THREAD_POOL::GetInstance().GetThreadCount(),
             m_blockPositions.size() );
+
+    TASK_GROUP tasks;
+
     for( size_t ii = 0; ii < parallelThreadCount; ++ii )
     {
-        std::thread t = std::thread( [&]()
+        tasks.Run( [&]()
         {
             for( size_t iBlock = currentBlock.fetch_add( 1 );
                         iBlock < m_blockPositions.size() && !breakLoop;
@@ -395,15 +397,10 @@ void C3D_RENDER_RAYTRACING::rt_render_tracing( GLubyte *ptrPBO ,
                         breakLoop = true;
                 }
             }
-
-            threadsFinished++;
         } );
-
-        t.detach();
     }
 
-    while( threadsFinished < parallelThreadCount )
-        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+    tasks.Wait();
 
     m_nrBlocksRenderProgress += numBlocksRendered;
 
@@ -922,12 +919,14 @@ void C3D_RENDER_RAYTRACING::rt_render_post_process_shade( GLubyte *ptrPBO,
             aStatusTextReporter->Report( _("Rendering: Post processing shader") );
 
         std::atomic<size_t> nextBlock( 0 );
-        std::atomic<size_t> threadsFinished( 0 );
 
-        size_t parallelThreadCount = std::max<size_t>( std::thread::hardware_concurrency(), 2 );
+        size_t parallelThreadCount = THREAD_POOL::GetInstance().GetThreadCount();
+
+        TASK_GROUP tasks;
+
         for( size_t ii = 0; ii < parallelThreadCount; ++ii )
         {
-            std::thread t = std::thread( [&]()
+            tasks.Run( [&]()
             {
                 for( size_t y = nextBlock.fetch_add( 1 );
                             y < m_realBufferSize.y;
@@ -941,15 +940,10 @@ void C3D_RENDER_RAYTRACING::rt_render_post_process_shade( GLubyte *ptrPBO,
                         ptr++;
                     }
                 }
-
-                threadsFinished++;
             } );
-
-            t.detach();
         }
 
-        while( threadsFinished < parallelThreadCount )
-            std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+        tasks.Wait();
 
         // Set next state
         m_rt_render_state = RT_RENDER_STATE_POST_PROCESS_BLUR_AND_FINISH;
@@ -971,12 +965,14 @@ void C3D_RENDER_RAYTRACING::rt_render_post_process_blur_finish( GLubyte *ptrPBO,
     {
         // Now blurs the shader result and compute the final color
         std::atomic<size_t> nextBlock( 0 );
-        std::atomic<size_t> threadsFinished( 0 );
 
-        size_t parallelThreadCount = std::max<size_t>( std::thread::hardware_concurrency(), 2 );
+        size_t parallelThreadCount = THREAD_POOL::GetInstance().GetThreadCount();
+
+        TASK_GROUP tasks;
+
         for( size_t ii = 0; ii < parallelThreadCount; ++ii )
         {
-            std::thread t = std::thread( [&]()
+            tasks.Run( [&]()
             {
                 for( size_t y = nextBlock.fetch_add( 1 );
                             y < m_realBufferSize.y;
@@ -1061,15 +1057,10 @@ void C3D_RENDER_RAYTRACING::rt_render_post_process_blur_finish( GLubyte *ptrPBO,
                         ptr += 4;
                     }
                 }
-
-                threadsFinished++;
             } );
-
-            t.detach();
         }
 
-        while( threadsFinished < parallelThreadCount )
-            std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+        tasks.Wait();
 
 
         // Debug code
@@ -1086,14 +1077,16 @@ void C3D_RENDER_RAYTRACING::render_preview( GLubyte *ptrPBO )
     m_isPreview = true;
 
     std::atomic<size_t> nextBlock( 0 );
-    std::atomic<size_t> threadsFinished( 0 );
 
     size_t parallelThreadCount = std::min<size_t>(
-            std::max<size_t>( std::thread::hardware_concurrency(), 2 ),
+            THREAD_POOL::GetInstance().GetThreadCount(),
             m_blockPositions.size() );
+
+    TASK_GROUP tasks;
+
     for( size_t ii = 0; ii < parallelThreadCount; ++ii )
     {
-        std::thread t = std::thread( [&]()
+        tasks.Run( [&]()
         {
             for( size_t iBlock = nextBlock.fetch_add( 1 );
                         iBlock < m_blockPositionsFast.size();
@@ -1699,15 +1692,10 @@ void C3D_RENDER_RAYTRACING::render_preview( GLubyte *ptrPBO )
                     }
                 }
             }
-
-            threadsFinished++;
         } );
-
-        t.detach();
     }
 
-    while( threadsFinished < parallelThreadCount )
-        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+    tasks.Wait();
 }
 
 
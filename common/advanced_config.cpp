@@ -72,6 +72,20 @@ static const wxChar RealtimeConnectivity[] = wxT( "RealtimeConnectivity" );
  */
 static const wxChar AllowLegacyCanvasInGtk3[] = wxT( "AllowLegacyCanvasInGtk3" );
 
+/**
+ * Use an R-tree of the board copper items in the DRC track tests, instead of testing
+ * each track against every other track, pad and zone of the board.  Both modes report
+ * the same errors; this switch is only there to compare them.
+ */
+static const wxChar DrcSpatialIndex[] = wxT( "DrcSpatialIndex" );
+
+/**
+ * Write the filled polygons of the zones, and their triangulation, in a binary file next to
+ * the saved board file, from which they are read when the board is loaded again, instead of
+ * parsing and triangulating them.  The board file still holds the fills.
+ */
+static const wxChar ZoneFillCache[] = wxT( "ZoneFillCache" );
+
 } // namespace KEYS
 
 
@@ -152,6 +166,8 @@ ADVANCED_CFG::ADVANCED_CFG()
     m_enableSvgImport = false;
     m_allowLegacyCanvasInGtk3 = false;
     m_realTimeConnectivity = true;
+    m_drcSpatialIndex = true;
+    m_zoneFillCache = false;
 
     loadFromConfigFile();
 }
@@ -194,6 +210,12 @@ void ADVANCED_CFG::loadSettings( wxConfigBase& aCfg )
     configParams.push_back(
             new PARAM_CFG_BOOL( true, AC_KEYS::RealtimeConnectivity, &m_realTimeConnectivity, false ) );
 
+    configParams.push_back(
+            new PARAM_CFG_BOOL( true, AC_KEYS::DrcSpatialIndex, &m_drcSpatialIndex, true ) );
+
+    configParams.push_back(
+            new PARAM_CFG_BOOL( true, AC_KEYS::ZoneFillCache, &m_zoneFillCache, false ) );
+
     wxConfigLoadSetups( &aCfg, configParams );
 
     dumpCfg( configParams );
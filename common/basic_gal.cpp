@@ -39,10 +39,11 @@
 
 using namespace KIGFX;
 
-KIGFX::GAL_DISPLAY_OPTIONS basic_displayOptions;
+// Each thread has its own display options, since the GAL subscribes to them
+thread_local KIGFX::GAL_DISPLAY_OPTIONS basic_displayOptions;
 
 // the basic GAL doesn't get an external display option object
-BASIC_GAL basic_gal( basic_displayOptions );
+thread_local BASIC_GAL basic_gal( basic_displayOptions );
 
 const VECTOR2D BASIC_GAL::transform( const VECTOR2D& aPoint ) const
 {
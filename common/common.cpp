@@ -72,7 +72,12 @@ void KiAssertFilter( const wxString &file, int line,
 #endif
 
 
-std::atomic<unsigned int> LOCALE_IO::m_c_count( 0 );
+unsigned int LOCALE_IO::m_c_count = 0;
+std::string  LOCALE_IO::m_user_locale;
+
+// The locale is global to the process: switching it is serialized, so that no LOCALE_IO
+// constructor returns before the "C" locale is set.
+static std::mutex s_localeMutex;
 
 
 // Note on Windows, setlocale( LC_NUMERIC, "C" ) works fine to read/write
@@ -82,7 +87,8 @@ std::atomic<unsigned int> LOCALE_IO::m_c_count( 0 );
 
 LOCALE_IO::LOCALE_IO()
 {
-    // use thread safe, atomic operation
+    std::lock_guard<std::mutex> lock( s_localeMutex );
+
     if( m_c_count++ == 0 )
     {
         // Store the user locale name, to restore this locale later, in dtor
@@ -99,7 +105,8 @@ LOCALE_IO::LOCALE_IO()
 
 LOCALE_IO::~LOCALE_IO()
 {
-    // use thread safe, atomic operation
+    std::lock_guard<std::mutex> lock( s_localeMutex );
+
     if( --m_c_count == 0 )
     {
         // revert to the user locale
@@ -206,6 +206,12 @@ void EDA_DRAW_PANEL_GAL::onPaint( wxPaintEvent& WXUNUSED( aEvent ) )
                 m_gal->DrawGrid();
 
             m_view->Redraw();
+
+            if( m_options.m_showFrameTime && m_edaFrame )
+            {
+                m_edaFrame->SetStatusText( wxString::Format( _( "Redraw: %.1f ms" ),
+                                                             m_view->GetLastRedrawTime() ) );
+            }
         }
 
         m_gal->DrawCursor( m_viewControls->GetCursorPosition() );
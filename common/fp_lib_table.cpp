@@ -268,6 +268,16 @@ void FP_LIB_TABLE::FootprintEnumerate( wxArrayString& aFootprintNames, const wxS
 }
 
 
+void FP_LIB_TABLE::EnumerateFootprintIndex( std::vector<FOOTPRINT_INDEX_ENTRY>& aEntries,
+                                            const wxString& aNickname )
+{
+    const FP_LIB_TABLE_ROW* row = FindRow( aNickname );
+    wxASSERT( (PLUGIN*) row->plugin );
+    row->plugin->EnumerateFootprintIndex( aEntries, row->GetFullURI( true ),
+                                          row->GetProperties() );
+}
+
+
 void FP_LIB_TABLE::PrefetchLib( const wxString& aNickname )
 {
     const FP_LIB_TABLE_ROW* row = FindRow( aNickname );
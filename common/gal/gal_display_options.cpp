@@ -41,6 +41,8 @@ static const wxString GalGridMaxDensityConfig( "GridMaxDensity" );
 static const wxString GalGridAxesEnabledConfig( "GridAxesEnabled" );
 static const wxString GalFullscreenCursorConfig( "CursorFullscreen" );
 static const wxString GalForceDisplayCursorConfig( "ForceDisplayCursor" );
+static const wxString GalMinTextSizeConfig( "MinTextSize" );
+static const wxString GalShowFrameTimeConfig( "ShowFrameTime" );
 
 
 static const UTIL::CFG_MAP<KIGFX::GRID_STYLE> gridStyleConfigVals =
@@ -70,6 +72,8 @@ GAL_DISPLAY_OPTIONS::GAL_DISPLAY_OPTIONS()
       m_axesEnabled( false ),
       m_fullscreenCursor( false ),
       m_forceDisplayCursor( false ),
+      m_minTextSize( 2.0 ),
+      m_showFrameTime( false ),
       m_scaleFactor( DPI_SCALING::GetDefaultScaleFactor() )
 {}
 
@@ -91,6 +95,8 @@ void GAL_DISPLAY_OPTIONS::ReadAppConfig( wxConfigBase& aCfg, const wxString& aBa
     aCfg.Read( baseName + GalGridAxesEnabledConfig, &m_axesEnabled, false );
     aCfg.Read( baseName + GalFullscreenCursorConfig, &m_fullscreenCursor, false );
     aCfg.Read( baseName + GalForceDisplayCursorConfig, &m_forceDisplayCursor, true );
+    aCfg.Read( baseName + GalMinTextSizeConfig, &m_minTextSize, 2.0 );
+    aCfg.Read( baseName + GalShowFrameTimeConfig, &m_showFrameTime, false );
 
     NotifyChanged();
 }
@@ -143,6 +149,8 @@ void GAL_DISPLAY_OPTIONS::WriteConfig( wxConfigBase& aCfg, const wxString& aBase
     aCfg.Write( baseName + GalGridAxesEnabledConfig, m_axesEnabled );
     aCfg.Write( baseName + GalFullscreenCursorConfig, m_fullscreenCursor );
     aCfg.Write( baseName + GalForceDisplayCursorConfig, m_forceDisplayCursor );
+    aCfg.Write( baseName + GalMinTextSizeConfig, m_minTextSize );
+    aCfg.Write( baseName + GalShowFrameTimeConfig, m_showFrameTime );
 }
 
 
@@ -66,6 +66,8 @@ GAL::GAL( GAL_DISPLAY_OPTIONS& aDisplayOptions ) :
     gridStyle = GRID_STYLE::LINES;
     gridMinSpacing = 10;
 
+    minTextSize = options.m_minTextSize;
+
     // Initialize the cursor shape
     SetCursorColor( COLOR4D( 1.0, 1.0, 1.0, 1.0 ) );
     fullscreenCursor = false;
@@ -136,6 +138,12 @@ bool GAL::updatedGalDisplayOptions( const GAL_DISPLAY_OPTIONS& aOptions )
         refresh = true;
     }
 
+    if( options.m_minTextSize != minTextSize )
+    {
+        minTextSize = options.m_minTextSize;
+        refresh = true;
+    }
+
     // tell the derived class if the base class needs an update or not
     return refresh;
 }
@@ -34,6 +34,7 @@
 #include <gal/opengl/vertex_item.h>
 #include <gal/opengl/utils.h>
 
+#include <algorithm>
 #include <list>
 #include <cassert>
 
@@ -218,16 +219,30 @@ bool CACHED_CONTAINER::reallocate( unsigned int aSize )
     wxLogDebug( wxT( "Resize %p from %d to %d" ), m_item, itemSize, aSize );
 #endif
 
-    // Find a free space chunk >= aSize
-    FREE_CHUNK_MAP::iterator newChunk = m_freeChunks.lower_bound( aSize );
+    // Items are made of many small allocations (a few vertices per primitive), so a growing
+    // item reserves room for the next ones instead of moving at each allocation and leaving
+    // a trail of small free chunks.  FinishItem() returns the unused space to the pool.
+    unsigned int chunkSize = std::max( aSize, 2 * itemSize );
+
+    // Find a free space chunk >= chunkSize, or at least >= aSize
+    FREE_CHUNK_MAP::iterator newChunk = m_freeChunks.lower_bound( chunkSize );
+
+    if( newChunk == m_freeChunks.end() )
+        newChunk = m_freeChunks.lower_bound( aSize );
 
     // Is there enough space to store vertices?
     if( newChunk == m_freeChunks.end() )
     {
         bool result;
 
+        // Is the free space only fragmented?
+        if( aSize <= m_freeSpace && m_freeSpace >= m_currentSize / 4 )
+        {
+            // Yes: defragment without growing the container
+            result = defragmentResize( m_currentSize );
+        }
         // Would it be enough to double the current space?
-        if( aSize < m_freeSpace + m_currentSize )
+        else if( aSize < m_freeSpace + m_currentSize )
         {
             // Yes: exponential growing
             result = defragmentResize( m_currentSize * 2 );
@@ -241,7 +256,11 @@ bool CACHED_CONTAINER::reallocate( unsigned int aSize )
         if( !result )
             return false;
 
-        newChunk = m_freeChunks.lower_bound( aSize );
+        newChunk = m_freeChunks.lower_bound( chunkSize );
+
+        if( newChunk == m_freeChunks.end() )
+            newChunk = m_freeChunks.lower_bound( aSize );
+
         assert( newChunk != m_freeChunks.end() );
     }
 
@@ -72,11 +72,22 @@ const float SHADER_LINE_C               = 7.0;
 const float SHADER_LINE_D               = 8.0;
 const float SHADER_LINE_E               = 9.0;
 const float SHADER_LINE_F               = 10.0;
+const float SHADER_ARC                  = 11.0;
+
+// Instance types
+const float SHADER_INSTANCE_FILLED_CIRCLE   = 12.0;
+const float SHADER_INSTANCE_STROKED_CIRCLE  = 13.0;
+const float SHADER_INSTANCE_SEGMENT         = 14.0;
+const float SHADER_INSTANCE_ARC             = -1.0;
+
+const float PI = 3.14159265358979;
 
 // Minimum line width
 const float MIN_WIDTH = 1.0;
 
 attribute vec4 attrShaderParams;
+attribute vec3 attrInstance;
+attribute vec4 attrInstanceColor;
 varying vec4 shaderParams;
 varying vec2 circleCoords;
 uniform float worldPixelSize;
@@ -95,14 +106,13 @@ vec4 roundv( vec4 x, vec2 t)
     return vec4( roundr(x.x, t.x), roundr(x.y, t.y), x.z, x.w );
 }
 
-void computeLineCoords( bool posture, vec2 vs, vec2 vp, vec2 texcoord, vec2 dir, float lineWidth, bool endV )
+void computeLineCoords( vec4 vertex, vec4 color, bool posture, vec2 vs, vec2 vp, vec2 texcoord, vec2 dir, float lineWidth, bool endV )
 {
     float lineLength = length(vs);
-    vec4 screenPos = gl_ModelViewProjectionMatrix * gl_Vertex + vec4(1, 1, 0, 0);
+    vec4 screenPos = gl_ModelViewProjectionMatrix * vertex + vec4(1, 1, 0, 0);
     float w = ((lineWidth == 0.0) ? worldPixelSize : lineWidth );
     float pixelWidth = roundr( w / worldPixelSize, 1.0 );
     float aspect = ( lineLength + w ) / w;
-    vec4 color = gl_Color;
     vec2 s = sign( vec2( gl_ModelViewProjectionMatrix[0][0], gl_ModelViewProjectionMatrix[1][1] ) );
 
 
@@ -144,14 +154,14 @@ void computeLineCoords( bool posture, vec2 vs, vec2 vp, vec2 texcoord, vec2 dir,
     shaderParams[1] = aspect;
 
     gl_TexCoord[0].st = vec2(aspect * texcoord.x, texcoord.y);
-    gl_FrontColor = gl_Color;
+    gl_FrontColor = color;
 }
 
 
-void computeCircleCoords( float mode, float vertexIndex, float radius, float lineWidth )
+void computeCircleCoords( vec4 vertex, vec4 color, float mode, float vertexIndex, float radius, float lineWidth )
 {
     vec4 delta;
-    vec4 center = roundv( gl_ModelViewProjectionMatrix * gl_Vertex + vec4(1, 1, 0, 0), screenPixelSize );
+    vec4 center = roundv( gl_ModelViewProjectionMatrix * vertex + vec4(1, 1, 0, 0), screenPixelSize );
     float pixelWidth = roundr( lineWidth / worldPixelSize, 1.0);
     float pixelR = roundr( radius / worldPixelSize, 1.0);
 
@@ -201,44 +211,119 @@ void computeCircleCoords( float mode, float vertexIndex, float radius, float lin
     delta.y *= screenPixelSize.y;
 
     gl_Position = center + delta + adjust;
-    gl_FrontColor = gl_Color;
+    gl_FrontColor = color;
 }
 
 
-void main()
+void computeArcCoords( vec4 center, vec4 color, vec2 corner, float radius, float width, float startAngle, float endAngle )
 {
-    float mode = attrShaderParams[0];
+    float halfWidth = max( width, worldPixelSize ) / 2.0;
+    float halfSweep = ( endAngle - startAngle ) / 2.0;
+    float midAngle = startAngle + halfSweep;
+    vec2 along = vec2( cos( midAngle ), sin( midAngle ) );
+    vec2 across = vec2( -along.y, along.x );
+    float outer = radius + halfWidth + worldPixelSize;
+    float minAlong = -outer;
+    float maxAcross = outer;
+
+    // Bounding box of the arc, aligned on its middle, as arcs are often thin and short
+    if( halfSweep <= PI / 2.0 )
+    {
+        minAlong = radius * cos( halfSweep ) - halfWidth - worldPixelSize;
+        maxAcross = radius * sin( halfSweep ) + halfWidth + worldPixelSize;
+    }
 
-    // Pass attributes to the fragment shader
-    shaderParams = attrShaderParams;
+    vec2 offset = along * mix( minAlong, outer, ( corner.x + 1.0 ) / 2.0 ) + across * corner.y * maxAcross;
+
+    // Coordinates relative to the center, to be checked by the fragment shader
+    circleCoords = offset;
+    shaderParams = vec4( SHADER_ARC, 0.0, 0.0, 0.0 );
+    gl_TexCoord[0] = vec4( radius, halfWidth, startAngle, endAngle - startAngle );
+
+    gl_Position = gl_ModelViewProjectionMatrix * vec4( center.xy + offset, center.zw );
+    gl_FrontColor = color;
+}
 
+
+void computeCoords( float mode, vec4 vertex, vec4 color )
+{
     float lineWidth = shaderParams.y;
     vec2 vs = shaderParams.zw;
     vec2 vp = vec2(-vs.y, vs.x);
     bool posture = abs( vs.x ) < abs(vs.y);
 
     if( mode == SHADER_LINE_A )
-        computeLineCoords( posture,  -vs, vp,  vec2( -1, -1 ), vec2( -1, 0 ), lineWidth, false );
+        computeLineCoords( vertex, color, posture,  -vs, vp,  vec2( -1, -1 ), vec2( -1, 0 ), lineWidth, false );
     else if( mode == SHADER_LINE_B )
-        computeLineCoords( posture,  -vs, -vp, vec2( -1,  1 ), vec2(  1, 0 ), lineWidth, false );
+        computeLineCoords( vertex, color, posture,  -vs, -vp, vec2( -1,  1 ), vec2(  1, 0 ), lineWidth, false );
     else if( mode == SHADER_LINE_C )
-        computeLineCoords( posture,  vs, -vp,  vec2(  1,  1 ), vec2(  1, 0 ), lineWidth, true );
+        computeLineCoords( vertex, color, posture,  vs, -vp,  vec2(  1,  1 ), vec2(  1, 0 ), lineWidth, true );
     else if( mode == SHADER_LINE_D )
-        computeLineCoords( posture,  vs, -vp,  vec2( -1, -1 ), vec2(  1, 0 ), lineWidth, true );
+        computeLineCoords( vertex, color, posture,  vs, -vp,  vec2( -1, -1 ), vec2(  1, 0 ), lineWidth, true );
     else if( mode == SHADER_LINE_E )
-        computeLineCoords( posture,  vs, vp,   vec2( -1,  1 ), vec2( -1, 0 ), lineWidth, true );
+        computeLineCoords( vertex, color, posture,  vs, vp,   vec2( -1,  1 ), vec2( -1, 0 ), lineWidth, true );
     else if( mode == SHADER_LINE_F )
-        computeLineCoords( posture,  -vs, vp,  vec2(  1,  1 ), vec2( -1, 0 ), lineWidth, false );
+        computeLineCoords( vertex, color, posture,  -vs, vp,  vec2(  1,  1 ), vec2( -1, 0 ), lineWidth, false );
     else if( mode == SHADER_FILLED_CIRCLE || mode == SHADER_STROKED_CIRCLE)
-        computeCircleCoords( mode, shaderParams.y, shaderParams.z, shaderParams.w );
+        computeCircleCoords( vertex, color, mode, shaderParams.y, shaderParams.z, shaderParams.w );
     else
     {
         // Pass through the coordinates like in the fixed pipeline
         gl_Position = ftransform();
-        gl_FrontColor = gl_Color;
+        gl_FrontColor = color;
+
+    }
+}
+
+
+/**
+ * Make a vertex of an instance record, stored at attrInstance with its parameters in
+ * shaderParams. gl_Vertex is the corner of the instance, and its index in z.
+ *
+ * Segments and circles are expanded to the vertices drawLineQuad() and DrawCircle() would
+ * have made, so they are drawn the same way.
+ */
+void computeInstanceCoords( float mode )
+{
+    float corner = gl_Vertex.z;
+    vec4 center = vec4( attrInstance, 1.0 );
+
+    if( mode == SHADER_INSTANCE_SEGMENT )
+    {
+        // Vertices A, B & F are at the start point, C, D & E at the end point
+        if( corner >= 2.0 && corner <= 4.0 )
+            center.xy += shaderParams.zw;
 
+        shaderParams[0] = SHADER_LINE_A + corner;
+        computeCoords( shaderParams[0], center, attrInstanceColor );
+    }
+    else if( mode == SHADER_INSTANCE_FILLED_CIRCLE || mode == SHADER_INSTANCE_STROKED_CIRCLE )
+    {
+        // A single triangle contains the circle, the second one is degenerated
+        shaderParams[0] = ( mode == SHADER_INSTANCE_FILLED_CIRCLE ) ? SHADER_FILLED_CIRCLE
+                                                                    : SHADER_STROKED_CIRCLE;
+        shaderParams[1] = ( corner < 3.0 ) ? corner + 1.0 : 1.0;
+        computeCoords( shaderParams[0], center, attrInstanceColor );
+    }
+    else
+    {
+        computeArcCoords( center, attrInstanceColor, gl_Vertex.xy, shaderParams[1],
+                          SHADER_INSTANCE_ARC - mode, shaderParams[2], shaderParams[3] );
     }
+}
+
+
+void main()
+{
+    float mode = attrShaderParams[0];
 
+    // Pass attributes to the fragment shader
+    shaderParams = attrShaderParams;
+
+    if( mode >= SHADER_INSTANCE_FILLED_CIRCLE || mode <= SHADER_INSTANCE_ARC )
+        computeInstanceCoords( mode );
+    else
+        computeCoords( mode, gl_Vertex, gl_Color );
 }
 
 )SHADER_SOURCE";
@@ -283,6 +368,7 @@ const float SHADER_STROKED_CIRCLE       = 3.0;
 const float SHADER_FONT                 = 4.0;
 const float SHADER_LINE_A               = 5.0;
 const float SHADER_LINE_B               = 6.0;
+const float SHADER_ARC                  = 11.0;
 
 varying vec4 shaderParams;
 varying vec2 circleCoords;
@@ -352,6 +438,30 @@ void drawLine( vec2 aCoord )
         discard;
 }
 
+
+void arc( vec2 aCoord, float aRadius, float aHalfWidth, float aStartAngle, float aSweep )
+{
+    float angle = mod( atan( aCoord.y, aCoord.x ) - aStartAngle, 2.0 * 3.14159265358979 );
+    float dist;
+
+    if( angle <= aSweep )
+    {
+        dist = abs( length( aCoord ) - aRadius );
+    }
+    else
+    {
+        // Round ends
+        vec2 start = aRadius * vec2( cos( aStartAngle ), sin( aStartAngle ) );
+        vec2 end = aRadius * vec2( cos( aStartAngle + aSweep ), sin( aStartAngle + aSweep ) );
+        dist = min( distance( aCoord, start ), distance( aCoord, end ) );
+    }
+
+    if( dist <= aHalfWidth )
+        gl_FragColor = gl_Color;
+    else
+        discard;
+}
+
 #ifdef USE_MSDF
 float median( vec3 v )
 {
@@ -373,6 +483,10 @@ void main()
     {
         strokedCircle( circleCoords, shaderParams[2], shaderParams[3] );
     }
+    else if( shaderParams[0] == SHADER_ARC )
+    {
+        arc( circleCoords, gl_TexCoord[0].x, gl_TexCoord[0].y, gl_TexCoord[0].z, gl_TexCoord[0].w );
+    }
     else if( shaderParams[0] == SHADER_FONT )
     {
         vec2 tex           = shaderParams.yz;
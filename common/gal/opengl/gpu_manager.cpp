@@ -29,6 +29,7 @@
 #include <gal/opengl/shader.h>
 #include <gal/opengl/utils.h>
 
+#include <algorithm>
 #include <typeinfo>
 #include <confirm.h>
 
@@ -49,7 +50,8 @@ GPU_MANAGER* GPU_MANAGER::MakeManager( VERTEX_CONTAINER* aContainer )
 
 
 GPU_MANAGER::GPU_MANAGER( VERTEX_CONTAINER* aContainer ) :
-    m_isDrawing( false ), m_container( aContainer ), m_shader( NULL ), m_shaderAttrib( 0 ), m_enableDepthTest( true )
+    m_isDrawing( false ), m_container( aContainer ), m_shader( NULL ), m_shaderAttrib( 0 ),
+    m_instanceAttrib( -1 ), m_instanceColorAttrib( -1 ), m_enableDepthTest( true )
 {
 }
 
@@ -68,13 +70,16 @@ void GPU_MANAGER::SetShader( SHADER& aShader )
     {
         DisplayError( NULL, wxT( "Could not get the shader attribute location" ) );
     }
+
+    m_instanceAttrib = m_shader->GetAttribute( "attrInstance" );
+    m_instanceColorAttrib = m_shader->GetAttribute( "attrInstanceColor" );
 }
 
 
 // Cached manager
 GPU_CACHED_MANAGER::GPU_CACHED_MANAGER( VERTEX_CONTAINER* aContainer ) :
     GPU_MANAGER( aContainer ), m_buffersInitialized( false ), m_indicesPtr( NULL ),
-    m_indicesBuffer( 0 ), m_indicesSize( 0 ), m_indicesCapacity( 0 )
+    m_indicesBuffer( 0 ), m_indicesSize( 0 ), m_indicesCapacity( 0 ), m_cornersBuffer( 0 )
 {
     // Allocate the biggest possible buffer for indices
     resizeIndices( aContainer->GetSize() );
@@ -87,6 +92,7 @@ GPU_CACHED_MANAGER::~GPU_CACHED_MANAGER()
     {
         glBindBuffer( GL_ARRAY_BUFFER, 0 );
         glDeleteBuffers( 1, &m_indicesBuffer );
+        glDeleteBuffers( 1, &m_cornersBuffer );
     }
 }
 
@@ -99,6 +105,20 @@ void GPU_CACHED_MANAGER::BeginDrawing()
     {
         glGenBuffers( 1, &m_indicesBuffer );
         checkGlError( "generating vertices buffer" );
+
+        // Corners of the two triangles made of an instance record, with their index in the
+        // third coordinate (see the vertex shader)
+        const GLfloat corners[INSTANCE_VERTICES * 3] = {
+            -1.0f, -1.0f, 0.0f,     1.0f, -1.0f, 1.0f,      1.0f, 1.0f, 2.0f,
+            -1.0f, -1.0f, 3.0f,     1.0f,  1.0f, 4.0f,     -1.0f, 1.0f, 5.0f
+        };
+
+        glGenBuffers( 1, &m_cornersBuffer );
+        glBindBuffer( GL_ARRAY_BUFFER, m_cornersBuffer );
+        glBufferData( GL_ARRAY_BUFFER, sizeof( corners ), corners, GL_STATIC_DRAW );
+        glBindBuffer( GL_ARRAY_BUFFER, 0 );
+        checkGlError( "generating instance corners buffer" );
+
         m_buffersInitialized = true;
     }
 
@@ -109,6 +129,7 @@ void GPU_CACHED_MANAGER::BeginDrawing()
     m_indicesSize = 0;
     // Set the indices pointer to the beginning of the indices-to-draw buffer
     m_indicesPtr = m_indices.get();
+    m_instanceRanges.clear();
 
     m_isDrawing = true;
 }
@@ -125,6 +146,14 @@ void GPU_CACHED_MANAGER::DrawIndices( unsigned int aOffset, unsigned int aSize )
 }
 
 
+void GPU_CACHED_MANAGER::DrawInstances( unsigned int aOffset, unsigned int aSize )
+{
+    wxASSERT( m_isDrawing );
+
+    m_instanceRanges.emplace_back( aOffset, aSize );
+}
+
+
 void GPU_CACHED_MANAGER::DrawAll()
 {
     wxASSERT( m_isDrawing );
@@ -148,7 +177,7 @@ void GPU_CACHED_MANAGER::EndDrawing()
     if( cached->IsMapped() )
         cached->Unmap();
 
-    if( m_indicesSize == 0 )
+    if( m_indicesSize == 0 && m_instanceRanges.empty() )
     {
         m_isDrawing = false;
         return;
@@ -176,14 +205,22 @@ void GPU_CACHED_MANAGER::EndDrawing()
                                VERTEX_SIZE, (GLvoid*) SHADER_OFFSET );
     }
 
-    glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, m_indicesBuffer );
-    glBufferData( GL_ELEMENT_ARRAY_BUFFER, m_indicesSize * sizeof(int),
-            (GLvoid*) m_indices.get(), GL_DYNAMIC_DRAW );
+    if( m_indicesSize > 0 )
+    {
+        glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, m_indicesBuffer );
+        glBufferData( GL_ELEMENT_ARRAY_BUFFER, m_indicesSize * sizeof(int),
+                (GLvoid*) m_indices.get(), GL_DYNAMIC_DRAW );
 
-    glDrawElements( GL_TRIANGLES, m_indicesSize, GL_UNSIGNED_INT, 0 );
+        glDrawElements( GL_TRIANGLES, m_indicesSize, GL_UNSIGNED_INT, 0 );
+    }
+
+    // Instance records are expanded by the shader
+    if( !m_instanceRanges.empty() && m_shader != NULL )
+        drawInstances( cached->GetBufferHandle() );
 
 #ifdef __WXDEBUG__
-    wxLogTrace( "GAL_PROFILE", wxT( "Cached manager size: %d" ), m_indicesSize );
+    wxLogTrace( "GAL_PROFILE", wxT( "Cached manager size: %d, instance ranges: %d" ),
+                m_indicesSize, (int) m_instanceRanges.size() );
 #endif /* __WXDEBUG__ */
 
     glBindBuffer( GL_ARRAY_BUFFER, 0 );
@@ -220,6 +257,61 @@ void GPU_CACHED_MANAGER::resizeIndices( unsigned int aNewSize )
 }
 
 
+void GPU_CACHED_MANAGER::drawInstances( GLuint aBuffer )
+{
+    // Merge the ranges of items stored next to each other, so there are less draw calls.
+    // Drawing the items in another order does not matter, as the items of a layer have the
+    // same depth and the order of the items of a layer is not defined anyway.
+    std::sort( m_instanceRanges.begin(), m_instanceRanges.end() );
+
+    unsigned int last = 0;
+
+    for( unsigned int i = 1; i < m_instanceRanges.size(); ++i )
+    {
+        std::pair<unsigned int, unsigned int>& range = m_instanceRanges[last];
+
+        if( range.first + range.second == m_instanceRanges[i].first )
+            range.second += m_instanceRanges[i].second;
+        else
+            m_instanceRanges[++last] = m_instanceRanges[i];
+    }
+
+    m_instanceRanges.resize( last + 1 );
+
+    // The vertices of an instance are its corners, the records are read once per instance
+    glDisableClientState( GL_COLOR_ARRAY );
+    glBindBuffer( GL_ARRAY_BUFFER, m_cornersBuffer );
+    glVertexPointer( 3, GL_FLOAT, 0, 0 );
+    glBindBuffer( GL_ARRAY_BUFFER, aBuffer );
+
+    glEnableVertexAttribArray( m_instanceAttrib );
+    glEnableVertexAttribArray( m_instanceColorAttrib );
+    glVertexAttribDivisorARB( m_instanceAttrib, 1 );
+    glVertexAttribDivisorARB( m_instanceColorAttrib, 1 );
+    glVertexAttribDivisorARB( m_shaderAttrib, 1 );
+
+    for( const std::pair<unsigned int, unsigned int>& range : m_instanceRanges )
+    {
+        size_t offset = range.first * VERTEX_SIZE;
+
+        glVertexAttribPointer( m_instanceAttrib, COORD_STRIDE, GL_FLOAT, GL_FALSE,
+                               VERTEX_SIZE, (GLvoid*) ( offset + COORD_OFFSET ) );
+        glVertexAttribPointer( m_instanceColorAttrib, COLOR_STRIDE, GL_UNSIGNED_BYTE, GL_TRUE,
+                               VERTEX_SIZE, (GLvoid*) ( offset + COLOR_OFFSET ) );
+        glVertexAttribPointer( m_shaderAttrib, SHADER_STRIDE, GL_FLOAT, GL_FALSE,
+                               VERTEX_SIZE, (GLvoid*) ( offset + SHADER_OFFSET ) );
+
+        glDrawArraysInstancedARB( GL_TRIANGLES, 0, INSTANCE_VERTICES, range.second );
+    }
+
+    glVertexAttribDivisorARB( m_shaderAttrib, 0 );
+    glVertexAttribDivisorARB( m_instanceColorAttrib, 0 );
+    glVertexAttribDivisorARB( m_instanceAttrib, 0 );
+    glDisableVertexAttribArray( m_instanceColorAttrib );
+    glDisableVertexAttribArray( m_instanceAttrib );
+}
+
+
 // Noncached manager
 GPU_NONCACHED_MANAGER::GPU_NONCACHED_MANAGER( VERTEX_CONTAINER* aContainer ) :
     GPU_MANAGER( aContainer )
@@ -239,6 +331,12 @@ void GPU_NONCACHED_MANAGER::DrawIndices( unsigned int aOffset, unsigned int aSiz
 }
 
 
+void GPU_NONCACHED_MANAGER::DrawInstances( unsigned int aOffset, unsigned int aSize )
+{
+    wxASSERT_MSG( false, wxT( "Not implemented yet" ) );
+}
+
+
 void GPU_NONCACHED_MANAGER::DrawAll()
 {
     // This is the default use case, nothing has to be done
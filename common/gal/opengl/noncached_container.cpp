@@ -57,7 +57,8 @@ void NONCACHED_CONTAINER::SetItem( VERTEX_ITEM* aItem )
 
 VERTEX* NONCACHED_CONTAINER::Allocate( unsigned int aSize )
 {
-    if( m_freeSpace < aSize )
+    // A single request may need the space to be doubled more than once
+    while( m_freeSpace < aSize )
     {
         // Double the space
         VERTEX* newVertices = static_cast<VERTEX*>( realloc( m_vertices,
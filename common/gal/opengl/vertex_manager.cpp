@@ -35,12 +35,21 @@
 #include <gal/opengl/vertex_item.h>
 #include <confirm.h>
 
+#include <cstring>
+
 using namespace KIGFX;
 
 VERTEX_MANAGER::VERTEX_MANAGER( bool aCached ) :
-    m_noTransform( true ), m_transform( 1.0f ), m_reserved( NULL ), m_reservedSpace( 0 )
+    VERTEX_MANAGER( VERTEX_CONTAINER::MakeContainer( aCached ) )
+{
+}
+
+
+VERTEX_MANAGER::VERTEX_MANAGER( VERTEX_CONTAINER* aContainer ) :
+    m_noTransform( true ), m_transform( 1.0f ), m_reserved( NULL ), m_reservedSpace( 0 ),
+    m_instancing( false ), m_item( NULL )
 {
-    m_container.reset( VERTEX_CONTAINER::MakeContainer( aCached ) );
+    m_container.reset( aContainer );
     m_gpu.reset( GPU_MANAGER::MakeManager( m_container.get() ) );
 
     // There is no shader used by default
@@ -154,15 +163,71 @@ bool VERTEX_MANAGER::Vertices( const VERTEX aVertices[], unsigned int aSize )
 }
 
 
-void VERTEX_MANAGER::SetItem( VERTEX_ITEM& aItem ) const
+bool VERTEX_MANAGER::CopyVertices( const VERTEX aVertices[], unsigned int aSize )
+{
+    // flag to avoid hanging by calling DisplayError too many times:
+    static bool show_err = true;
+
+    VERTEX* newVertices = m_container->Allocate( aSize );
+
+    if( newVertices == NULL )
+    {
+        if( show_err )
+        {
+            DisplayError( NULL, wxT( "VERTEX_MANAGER::CopyVertices: Vertex allocation error" ) );
+            show_err = false;
+        }
+
+        return false;
+    }
+
+    memcpy( newVertices, aVertices, aSize * VERTEX_SIZE );
+
+    return true;
+}
+
+
+void VERTEX_MANAGER::Instance( GLfloat aX, GLfloat aY, GLfloat aZ )
+{
+    assert( m_instancing );
+
+    m_instances.emplace_back();
+    putVertex( m_instances.back(), aX, aY, aZ );
+}
+
+
+void VERTEX_MANAGER::CopyInstances( const VERTEX aInstances[], unsigned int aSize )
+{
+    assert( m_instancing );
+
+    m_instances.insert( m_instances.end(), aInstances, aInstances + aSize );
+}
+
+
+void VERTEX_MANAGER::SetItem( VERTEX_ITEM& aItem )
 {
+    m_item = &aItem;
     m_container->SetItem( &aItem );
 }
 
 
-void VERTEX_MANAGER::FinishItem() const
+unsigned int VERTEX_MANAGER::FinishItem()
 {
+    unsigned int instances = m_instances.size();
+
+    // Instance records go after the vertices, so that the item is still one chunk
+    if( instances > 0 && !CopyVertices( m_instances.data(), instances ) )
+        instances = 0;
+
+    m_instances.clear();
+
+    if( m_item )
+        m_item->setInstanceCount( instances );
+
+    m_item = NULL;
     m_container->FinishItem();
+
+    return instances;
 }
 
 
@@ -238,10 +303,14 @@ void VERTEX_MANAGER::BeginDrawing() const
 
 void VERTEX_MANAGER::DrawItem( const VERTEX_ITEM& aItem ) const
 {
-    int size = aItem.GetSize();
+    int instances = aItem.GetInstanceCount();
+    int size = aItem.GetSize() - instances;
     int offset = aItem.GetOffset();
 
     m_gpu->DrawIndices( offset, size );
+
+    if( instances > 0 )
+        m_gpu->DrawInstances( offset + size, instances );
 }
 
 
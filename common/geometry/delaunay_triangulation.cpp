@@ -0,0 +1,506 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Modifications Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ *
+ * Based on the sweep-hull algorithm of the Delaunator library by Vladimir Agafonkin
+ * (https://github.com/mapbox/delaunator).
+ *
+ * Code derived from:
+ * delaunator which is Copyright (c) 2017, Mapbox, ISC
+ *
+ * ISC License:
+ * Permission to use, copy, modify, and/or distribute this software for any purpose
+ * with or without fee is hereby granted, provided that the above copyright notice
+ * and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH
+ * REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT,
+ * INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS
+ * OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF
+ * THIS SOFTWARE.
+ *
+ */
+
+#include <geometry/delaunay_triangulation.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+
+static const int INVALID = -1;
+
+
+/**
+ * @return true if r is on the right of the line from p to q.  The coordinates are integers,
+ * so colinear points give exactly 0.
+ */
+static inline bool orient( const VECTOR2I& p, const VECTOR2I& q, const VECTOR2I& r )
+{
+    return ( (double) q.y - p.y ) * ( (double) r.x - q.x )
+           - ( (double) q.x - p.x ) * ( (double) r.y - q.y ) < 0.0;
+}
+
+
+/**
+ * @return true if p is inside the circumcircle of the triangle a, b, c.
+ */
+static inline bool inCircle( const VECTOR2I& a, const VECTOR2I& b, const VECTOR2I& c,
+                             const VECTOR2I& p )
+{
+    double dx = (double) a.x - p.x;
+    double dy = (double) a.y - p.y;
+    double ex = (double) b.x - p.x;
+    double ey = (double) b.y - p.y;
+    double fx = (double) c.x - p.x;
+    double fy = (double) c.y - p.y;
+
+    double ap = dx * dx + dy * dy;
+    double bp = ex * ex + ey * ey;
+    double cp = fx * fx + fy * fy;
+
+    return dx * ( ey * cp - bp * fy ) - dy * ( ex * cp - bp * fx ) + ap * ( ex * fy - ey * fx )
+           < 0.0;
+}
+
+
+/**
+ * @return the squared radius of the circumcircle of a, b, c, or the largest double if they
+ * are colinear.
+ */
+static double circumradius( const VECTOR2I& a, const VECTOR2I& b, const VECTOR2I& c )
+{
+    double dx = (double) b.x - a.x;
+    double dy = (double) b.y - a.y;
+    double ex = (double) c.x - a.x;
+    double ey = (double) c.y - a.y;
+
+    double bl = dx * dx + dy * dy;
+    double cl = ex * ex + ey * ey;
+    double det = dx * ey - dy * ex;
+
+    if( det == 0.0 )
+        return std::numeric_limits<double>::max();
+
+    double d = 0.5 / det;
+    double x = ( ey * bl - dy * cl ) * d;
+    double y = ( dx * cl - ex * bl ) * d;
+
+    return x * x + y * y;
+}
+
+
+static double squaredDistance( const VECTOR2I& a, double aX, double aY )
+{
+    double dx = a.x - aX;
+    double dy = a.y - aY;
+
+    return dx * dx + dy * dy;
+}
+
+
+/**
+ * @return a value in [0, 1) monotonic with the angle of (dx, dy)
+ */
+static inline double pseudoAngle( double dx, double dy )
+{
+    double sum = std::abs( dx ) + std::abs( dy );
+
+    if( sum == 0.0 )
+        return 0.0;
+
+    double p = dx / sum;
+
+    return ( dy > 0.0 ? 3.0 - p : 1.0 + p ) / 4.0;
+}
+
+
+int DELAUNAY_TRIANGULATION::hashKey( const VECTOR2I& aP ) const
+{
+    int key = (int) std::floor( pseudoAngle( aP.x - m_centerX, aP.y - m_centerY ) * m_hashSize );
+
+    return std::min( std::max( key, 0 ), m_hashSize - 1 );
+}
+
+
+void DELAUNAY_TRIANGULATION::link( int aA, int aB )
+{
+    if( aA == (int) m_halfedges.size() )
+        m_halfedges.push_back( aB );
+    else
+        m_halfedges[aA] = aB;
+
+    if( aB != INVALID )
+        m_halfedges[aB] = aA;
+}
+
+
+int DELAUNAY_TRIANGULATION::addTriangle( int aI0, int aI1, int aI2, int aA, int aB, int aC )
+{
+    int t = m_triangles.size();
+
+    m_triangles.push_back( aI0 );
+    m_triangles.push_back( aI1 );
+    m_triangles.push_back( aI2 );
+
+    link( t, aA );
+    link( t + 1, aB );
+    link( t + 2, aC );
+
+    return t;
+}
+
+
+int DELAUNAY_TRIANGULATION::legalize( int aA )
+{
+    const std::vector<VECTOR2I>& points = *m_points;
+    int                          a = aA;
+    int                          ar = 0;
+
+    m_edgeStack.clear();
+
+    while( true )
+    {
+        int b = m_halfedges[a];
+
+        /* If the pair of triangles doesn't satisfy the Delaunay condition (p1 is inside the
+         * circumcircle of [p0, pl, pr]), flip them, then do the same check/flip recursively
+         * for the new pair of triangles:
+         *
+         *           pl                    pl
+         *          /||\                  /  \
+         *       al/ || \bl            al/    \a
+         *        /  ||  \              /      \
+         *       /  a||b  \    flip    /___ar___\
+         *     p0\   ||   /p1   =>   p0\---bl---/p1
+         *        \  ||  /              \      /
+         *       ar\ || /br             b\    /br
+         *          \||/                  \  /
+         *           pr                    pr
+         */
+        int a0 = a - a % 3;
+        ar = a0 + ( a + 2 ) % 3;
+
+        if( b == INVALID )
+        {
+            // convex hull edge
+            if( m_edgeStack.empty() )
+                break;
+
+            a = m_edgeStack.back();
+            m_edgeStack.pop_back();
+            continue;
+        }
+
+        int b0 = b - b % 3;
+        int al = a0 + ( a + 1 ) % 3;
+        int bl = b0 + ( b + 2 ) % 3;
+
+        int p0 = m_triangles[ar];
+        int pr = m_triangles[a];
+        int pl = m_triangles[al];
+        int p1 = m_triangles[bl];
+
+        if( inCircle( points[p0], points[pr], points[pl], points[p1] ) )
+        {
+            m_triangles[a] = p1;
+            m_triangles[b] = p0;
+
+            int hbl = m_halfedges[bl];
+
+            // The edge swapped on the other side of the hull (rare): fix the half-edge
+            // reference of the hull
+            if( hbl == INVALID )
+            {
+                int e = m_hullStart;
+
+                do
+                {
+                    if( m_hullTri[e] == bl )
+                    {
+                        m_hullTri[e] = a;
+                        break;
+                    }
+
+                    e = m_hullPrev[e];
+                } while( e != m_hullStart );
+            }
+
+            link( a, hbl );
+            link( b, m_halfedges[ar] );
+            link( ar, bl );
+
+            m_edgeStack.push_back( b0 + ( b + 1 ) % 3 );
+        }
+        else
+        {
+            if( m_edgeStack.empty() )
+                break;
+
+            a = m_edgeStack.back();
+            m_edgeStack.pop_back();
+        }
+    }
+
+    return ar;
+}
+
+
+bool DELAUNAY_TRIANGULATION::Triangulate( const std::vector<VECTOR2I>& aPoints )
+{
+    const int n = aPoints.size();
+
+    m_points = &aPoints;
+    m_triangles.clear();
+    m_halfedges.clear();
+
+    if( n < 3 )
+        return false;
+
+    // The seed triangle: the point closest to the center of the bounding box, the point
+    // closest to it, and the point making the smallest circumcircle with them
+    double minX = std::numeric_limits<double>::max();
+    double minY = std::numeric_limits<double>::max();
+    double maxX = std::numeric_limits<double>::lowest();
+    double maxY = std::numeric_limits<double>::lowest();
+
+    for( const VECTOR2I& p : aPoints )
+    {
+        minX = std::min<double>( minX, p.x );
+        minY = std::min<double>( minY, p.y );
+        maxX = std::max<double>( maxX, p.x );
+        maxY = std::max<double>( maxY, p.y );
+    }
+
+    double cx = ( minX + maxX ) / 2.0;
+    double cy = ( minY + maxY ) / 2.0;
+    double minDist = std::numeric_limits<double>::max();
+    int    i0 = INVALID;
+    int    i1 = INVALID;
+    int    i2 = INVALID;
+
+    for( int i = 0; i < n; i++ )
+    {
+        double d = squaredDistance( aPoints[i], cx, cy );
+
+        if( d < minDist )
+        {
+            i0 = i;
+            minDist = d;
+        }
+    }
+
+    minDist = std::numeric_limits<double>::max();
+
+    for( int i = 0; i < n; i++ )
+    {
+        if( i == i0 )
+            continue;
+
+        double d = squaredDistance( aPoints[i], aPoints[i0].x, aPoints[i0].y );
+
+        if( d < minDist && d > 0.0 )
+        {
+            i1 = i;
+            minDist = d;
+        }
+    }
+
+    if( i1 == INVALID )
+        return false;
+
+    double minRadius = std::numeric_limits<double>::max();
+
+    for( int i = 0; i < n; i++ )
+    {
+        if( i == i0 || i == i1 )
+            continue;
+
+        double r = circumradius( aPoints[i0], aPoints[i1], aPoints[i] );
+
+        if( r < minRadius )
+        {
+            i2 = i;
+            minRadius = r;
+        }
+    }
+
+    // All the points are colinear
+    if( i2 == INVALID )
+        return false;
+
+    if( orient( aPoints[i0], aPoints[i1], aPoints[i2] ) )
+        std::swap( i1, i2 );
+
+    // The points are added in the order of their distance to the circumcenter of the seed
+    const VECTOR2I& a = aPoints[i0];
+    const VECTOR2I& b = aPoints[i1];
+    const VECTOR2I& c = aPoints[i2];
+    double          dx = (double) b.x - a.x;
+    double          dy = (double) b.y - a.y;
+    double          ex = (double) c.x - a.x;
+    double          ey = (double) c.y - a.y;
+    double          bl = dx * dx + dy * dy;
+    double          cl = ex * ex + ey * ey;
+    double          d = 0.5 / ( dx * ey - dy * ex );
+
+    m_centerX = a.x + ( ey * bl - dy * cl ) * d;
+    m_centerY = a.y + ( dx * cl - ex * bl ) * d;
+
+    std::vector<double> dists( n );
+    std::vector<int>    ids( n );
+
+    for( int i = 0; i < n; i++ )
+        dists[i] = squaredDistance( aPoints[i], m_centerX, m_centerY );
+
+    std::iota( ids.begin(), ids.end(), 0 );
+    std::sort( ids.begin(), ids.end(),
+               [&dists]( int aI, int aJ )
+               {
+                   return dists[aI] < dists[aJ] || ( dists[aI] == dists[aJ] && aI < aJ );
+               } );
+
+    m_hashSize = (int) std::ceil( std::sqrt( (double) n ) );
+    m_hullPrev.assign( n, INVALID );
+    m_hullNext.assign( n, INVALID );
+    m_hullTri.assign( n, INVALID );
+    m_hullHash.assign( m_hashSize, INVALID );
+
+    m_hullStart = i0;
+
+    m_hullNext[i0] = m_hullPrev[i2] = i1;
+    m_hullNext[i1] = m_hullPrev[i0] = i2;
+    m_hullNext[i2] = m_hullPrev[i1] = i0;
+
+    m_hullTri[i0] = 0;
+    m_hullTri[i1] = 1;
+    m_hullTri[i2] = 2;
+
+    m_hullHash[hashKey( aPoints[i0] )] = i0;
+    m_hullHash[hashKey( aPoints[i1] )] = i1;
+    m_hullHash[hashKey( aPoints[i2] )] = i2;
+
+    int maxTriangles = std::max( 2 * n - 5, 1 );
+
+    m_triangles.reserve( maxTriangles * 3 );
+    m_halfedges.reserve( maxTriangles * 3 );
+
+    addTriangle( i0, i1, i2, INVALID, INVALID, INVALID );
+
+    for( int k = 0; k < n; k++ )
+    {
+        const int       i = ids[k];
+        const VECTOR2I& p = aPoints[i];
+
+        if( i == i0 || i == i1 || i == i2 )
+            continue;
+
+        // Find a visible edge of the hull, starting from the hull point nearest in angle
+        int start = 0;
+        int key = hashKey( p );
+
+        for( int j = 0; j < m_hashSize; j++ )
+        {
+            start = m_hullHash[( key + j ) % m_hashSize];
+
+            if( start != INVALID && start != m_hullNext[start] )
+                break;
+        }
+
+        start = m_hullPrev[start];
+
+        int e = start;
+        int q;
+
+        while( q = m_hullNext[e], !orient( p, aPoints[e], aPoints[q] ) )
+        {
+            e = q;
+
+            if( e == start )
+            {
+                e = INVALID;
+                break;
+            }
+        }
+
+        // Only possible for a point (nearly) on the hull
+        if( e == INVALID )
+            continue;
+
+        // Add the first triangle from the point
+        int t = addTriangle( e, i, m_hullNext[e], INVALID, INVALID, m_hullTri[e] );
+
+        m_hullTri[i] = legalize( t + 2 );
+        m_hullTri[e] = t;
+
+        // Walk forward through the hull, adding more triangles and flipping recursively
+        int next = m_hullNext[e];
+
+        while( q = m_hullNext[next], orient( p, aPoints[next], aPoints[q] ) )
+        {
+            t = addTriangle( next, i, q, m_hullTri[i], INVALID, m_hullTri[next] );
+            m_hullTri[i] = legalize( t + 2 );
+            m_hullNext[next] = next;    // removed from the hull
+            next = q;
+        }
+
+        // Walk backward from the other side, adding more triangles and flipping
+        if( e == start )
+        {
+            while( q = m_hullPrev[e], orient( p, aPoints[q], aPoints[e] ) )
+            {
+                t = addTriangle( q, i, e, INVALID, m_hullTri[e], m_hullTri[q] );
+                legalize( t + 2 );
+                m_hullTri[q] = t;
+                m_hullNext[e] = e;      // removed from the hull
+                e = q;
+            }
+        }
+
+        // Update the hull
+        m_hullStart = m_hullPrev[i] = e;
+        m_hullNext[e] = m_hullPrev[next] = i;
+        m_hullNext[i] = next;
+
+        m_hullHash[hashKey( p )] = i;
+        m_hullHash[hashKey( aPoints[e] )] = e;
+    }
+
+    return true;
+}
+
+
+void DELAUNAY_TRIANGULATION::GetEdges( std::vector<std::pair<int, int>>& aEdges ) const
+{
+    for( int e = 0; e < (int) m_triangles.size(); e++ )
+    {
+        // Each inner edge has two half-edges: take the one with the larger index
+        if( m_halfedges[e] < e )
+        {
+            int next = ( e % 3 == 2 ) ? e - 2 : e + 1;
+
+            aEdges.emplace_back( m_triangles[e], m_triangles[next] );
+        }
+    }
+}
@@ -0,0 +1,416 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <geometry/poly_edge_index.h>
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+#include <geometry/shape_line_chain.h>
+#include <geometry/shape_poly_set.h>
+#include <math/math_util.h>
+
+
+/// Sets with fewer edges are scanned linearly faster than the index is built
+static const int MIN_INDEXED_EDGES = 64;
+
+/// SEG::Distance() rounds the nearest point and truncates the distance, so it can be up to
+/// this much smaller than the true distance; box queries are inflated accordingly
+static const int DISTANCE_ROUNDING = 2;
+
+
+static inline uint64_t contourKey( int aPolygon, int aContour )
+{
+    return ( (uint64_t) aPolygon << 32 ) | (uint32_t) aContour;
+}
+
+
+// Same test as SHAPE_LINE_CHAIN::EdgeContainingPoint() with no extra accuracy
+static inline bool isOnEdge( const SEG& aSeg, const VECTOR2I& aP )
+{
+    return aSeg.A == aP || aSeg.B == aP || aSeg.Distance( aP ) <= 1;
+}
+
+
+bool POLY_EDGE_INDEX::CanIndex( const SHAPE_POLY_SET& aSet )
+{
+    int edgeCount = 0;
+
+    for( int ii = 0; ii < aSet.OutlineCount(); ++ii )
+    {
+        for( const SHAPE_LINE_CHAIN& contour : aSet.CPolygon( ii ) )
+        {
+            // SHAPE_LINE_CHAIN::PointInside() is false for these ones, whatever the point
+            if( !contour.IsClosed() || contour.PointCount() < 3 )
+                return false;
+
+            edgeCount += contour.SegmentCount();
+        }
+    }
+
+    return edgeCount >= MIN_INDEXED_EDGES;
+}
+
+
+POLY_EDGE_INDEX::POLY_EDGE_INDEX( const SHAPE_POLY_SET& aSet ) :
+        m_left( INT_MAX ),
+        m_top( INT_MAX ),
+        m_right( INT_MIN ),
+        m_bottom( INT_MIN )
+{
+    for( int polyIdx = 0; polyIdx < aSet.OutlineCount(); ++polyIdx )
+    {
+        const SHAPE_POLY_SET::POLYGON& polygon = aSet.CPolygon( polyIdx );
+
+        for( int contourIdx = 0; contourIdx < (int) polygon.size(); ++contourIdx )
+        {
+            const SHAPE_LINE_CHAIN& contour = polygon[contourIdx];
+
+            for( int ii = 0; ii < contour.SegmentCount(); ++ii )
+                m_edges.push_back( { contour.CSegment( ii ), polyIdx, contourIdx } );
+
+            for( int ii = 0; ii < contour.PointCount(); ++ii )
+            {
+                const VECTOR2I& pt = contour.CPoint( ii );
+
+                m_left = std::min( m_left, pt.x );
+                m_top = std::min( m_top, pt.y );
+                m_right = std::max( m_right, pt.x );
+                m_bottom = std::max( m_bottom, pt.y );
+            }
+        }
+    }
+
+    if( m_edges.empty() )
+    {
+        m_left = m_top = m_right = m_bottom = 0;
+    }
+
+    // About two edges per cell, the cells being as square as possible
+    int64_t width = (int64_t) m_right - m_left + 1;
+    int64_t height = (int64_t) m_bottom - m_top + 1;
+    int     cellCount = std::max<int>( m_edges.size() / 2, 1 );
+
+    m_columns = (int) std::lround( std::sqrt( (double) cellCount * width / height ) );
+    m_columns = std::max( 1, std::min( m_columns, cellCount ) );
+    m_rows = std::max( 1, std::min<int>( ( cellCount + m_columns - 1 ) / m_columns, height ) );
+    m_columns = std::max( 1, std::min<int>( m_columns, width ) );
+
+    m_cellWidth = (int) ( ( width + m_columns - 1 ) / m_columns );
+    m_cellHeight = (int) ( ( height + m_rows - 1 ) / m_rows );
+
+    // Fill the cells and rows in two passes: count their edges, then store them
+    m_cellStart.assign( (size_t) m_columns * m_rows + 1, 0 );
+    m_rowStart.assign( m_rows + 1, 0 );
+
+    for( int pass = 0; pass < 2; ++pass )
+    {
+        std::vector<int> cellFill( m_cellStart.begin(), m_cellStart.end() - 1 );
+        std::vector<int> rowFill( m_rowStart.begin(), m_rowStart.end() - 1 );
+
+        for( int edgeIdx = 0; edgeIdx < (int) m_edges.size(); ++edgeIdx )
+        {
+            const SEG& seg = m_edges[edgeIdx].m_seg;
+            int        firstRow = row( std::min( seg.A.y, seg.B.y ) );
+            int        lastRow = row( std::max( seg.A.y, seg.B.y ) );
+            int        firstColumn = column( std::min( seg.A.x, seg.B.x ) );
+            int        lastColumn = column( std::max( seg.A.x, seg.B.x ) );
+
+            for( int r = firstRow; r <= lastRow; ++r )
+            {
+                // Horizontal edges never cross the ray cast by the point in polygon test
+                if( seg.A.y != seg.B.y )
+                {
+                    if( pass == 0 )
+                        m_rowStart[r + 1]++;
+                    else
+                        m_rowEdges[rowFill[r]++] = edgeIdx;
+                }
+
+                for( int c = firstColumn; c <= lastColumn; ++c )
+                {
+                    size_t cell = (size_t) r * m_columns + c;
+
+                    if( pass == 0 )
+                        m_cellStart[cell + 1]++;
+                    else
+                        m_cellEdges[cellFill[cell]++] = edgeIdx;
+                }
+            }
+        }
+
+        if( pass == 0 )
+        {
+            for( size_t ii = 1; ii < m_cellStart.size(); ++ii )
+                m_cellStart[ii] += m_cellStart[ii - 1];
+
+            for( size_t ii = 1; ii < m_rowStart.size(); ++ii )
+                m_rowStart[ii] += m_rowStart[ii - 1];
+
+            m_cellEdges.resize( m_cellStart.back() );
+            m_rowEdges.resize( m_rowStart.back() );
+        }
+    }
+}
+
+
+int POLY_EDGE_INDEX::column( int64_t aX ) const
+{
+    int64_t c = ( aX - m_left ) / m_cellWidth;
+
+    return (int) std::max<int64_t>( 0, std::min<int64_t>( c, m_columns - 1 ) );
+}
+
+
+int POLY_EDGE_INDEX::row( int64_t aY ) const
+{
+    int64_t r = ( aY - m_top ) / m_cellHeight;
+
+    return (int) std::max<int64_t>( 0, std::min<int64_t>( r, m_rows - 1 ) );
+}
+
+
+template <typename VISITOR>
+bool POLY_EDGE_INDEX::visit( int64_t aLeft, int64_t aTop, int64_t aRight, int64_t aBottom,
+                             VISITOR aVisitor ) const
+{
+    if( aRight < m_left || aLeft > m_right || aBottom < m_top || aTop > m_bottom )
+        return true;
+
+    int firstColumn = column( aLeft );
+    int lastColumn = column( aRight );
+    int lastRow = row( aBottom );
+
+    for( int r = row( aTop ); r <= lastRow; ++r )
+    {
+        for( int c = firstColumn; c <= lastColumn; ++c )
+        {
+            size_t cell = (size_t) r * m_columns + c;
+
+            for( int ii = m_cellStart[cell]; ii < m_cellStart[cell + 1]; ++ii )
+            {
+                if( !aVisitor( m_edges[m_cellEdges[ii]] ) )
+                    return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+
+template <typename DISTANCE>
+int POLY_EDGE_INDEX::edgeDistance( int64_t aLeft, int64_t aTop, int64_t aRight, int64_t aBottom,
+                                   int aSubpolyIndex, DISTANCE aDistance ) const
+{
+    // Search growing boxes around the query object.  Edges outside of a box are farther
+    // than its margin: the search stops once an edge closer than that is found.
+    int64_t gap = std::max( { (int64_t) 0, m_left - aRight, aLeft - m_right,
+                              m_top - aBottom, aTop - m_bottom } );
+    int64_t margin = std::max( { (int64_t) m_cellWidth, (int64_t) m_cellHeight, gap } );
+
+    while( true )
+    {
+        int best = INT_MAX;
+
+        visit( aLeft - margin, aTop - margin, aRight + margin, aBottom + margin,
+               [&]( const EDGE& aEdge ) -> bool
+               {
+                   if( aSubpolyIndex < 0 || aEdge.m_polygon == aSubpolyIndex )
+                       best = std::min( best, aDistance( aEdge.m_seg ) );
+
+                   return best > 0;
+               } );
+
+        bool coversAll = aLeft - margin <= m_left && aTop - margin <= m_top
+                         && aRight + margin >= m_right && aBottom + margin >= m_bottom;
+
+        if( coversAll || (int64_t) best + DISTANCE_ROUNDING <= margin )
+            return best;
+
+        margin *= 2;
+    }
+}
+
+
+bool POLY_EDGE_INDEX::Contains( const VECTOR2I& aP, int aSubpolyIndex, bool aIgnoreHoles ) const
+{
+    if( aP.x < m_left || aP.x > m_right || aP.y < m_top || aP.y > m_bottom )
+        return false;
+
+    // The contours around aP are the ones crossed an odd number of times by a ray cast from
+    // aP towards +x, with the same crossing test as SHAPE_LINE_CHAIN::PointInside()
+    std::vector<uint64_t> crossed;
+    int                   r = row( aP.y );
+
+    for( int ii = m_rowStart[r]; ii < m_rowStart[r + 1]; ++ii )
+    {
+        const EDGE& edge = m_edges[m_rowEdges[ii]];
+
+        if( aSubpolyIndex >= 0 && edge.m_polygon != aSubpolyIndex )
+            continue;
+
+        const VECTOR2I& p1 = edge.m_seg.A;
+        const VECTOR2I& p2 = edge.m_seg.B;
+        const VECTOR2I  diff = p2 - p1;
+        const int       d = rescale( diff.x, ( aP.y - p1.y ), diff.y );
+
+        if( ( ( p1.y > aP.y ) != ( p2.y > aP.y ) ) && ( aP.x - p1.x < d ) )
+            crossed.push_back( contourKey( edge.m_polygon, edge.m_contour ) );
+    }
+
+    std::sort( crossed.begin(), crossed.end() );
+
+    std::vector<uint64_t> around;
+
+    for( size_t ii = 0; ii < crossed.size(); )
+    {
+        size_t next = ii + 1;
+
+        while( next < crossed.size() && crossed[next] == crossed[ii] )
+            ++next;
+
+        if( ( next - ii ) % 2 )
+            around.push_back( crossed[ii] );
+
+        ii = next;
+    }
+
+    if( around.empty() )
+        return false;
+
+    // A point on the edge of a contour is not inside it
+    std::vector<uint64_t> touched;
+
+    visit( aP.x - DISTANCE_ROUNDING - 1, aP.y - DISTANCE_ROUNDING - 1,
+           aP.x + DISTANCE_ROUNDING + 1, aP.y + DISTANCE_ROUNDING + 1,
+           [&]( const EDGE& aEdge ) -> bool
+           {
+               if( isOnEdge( aEdge.m_seg, aP ) )
+                   touched.push_back( contourKey( aEdge.m_polygon, aEdge.m_contour ) );
+
+               return true;
+           } );
+
+    std::sort( touched.begin(), touched.end() );
+
+    auto offEdge = [&]( uint64_t aKey ) -> bool
+    {
+        return !std::binary_search( touched.begin(), touched.end(), aKey );
+    };
+
+    // Keys are sorted by polygon, the outline first: same test as SHAPE_POLY_SET::containsSingle()
+    for( size_t ii = 0; ii < around.size(); )
+    {
+        int    polygon = (int) ( around[ii] >> 32 );
+        size_t next = ii + 1;
+
+        while( next < around.size() && (int) ( around[next] >> 32 ) == polygon )
+            ++next;
+
+        if( around[ii] == contourKey( polygon, 0 ) && offEdge( around[ii] ) )
+        {
+            bool inHole = false;
+
+            for( size_t jj = ii + 1; jj < next && !aIgnoreHoles && !inHole; ++jj )
+                inHole = offEdge( around[jj] );
+
+            if( !inHole )
+                return true;
+        }
+
+        ii = next;
+    }
+
+    return false;
+}
+
+
+bool POLY_EDGE_INDEX::PointOnEdge( const VECTOR2I& aP ) const
+{
+    return !visit( aP.x - DISTANCE_ROUNDING - 1, aP.y - DISTANCE_ROUNDING - 1,
+                   aP.x + DISTANCE_ROUNDING + 1, aP.y + DISTANCE_ROUNDING + 1,
+                   [&]( const EDGE& aEdge ) -> bool
+                   {
+                       return !isOnEdge( aEdge.m_seg, aP );
+                   } );
+}
+
+
+bool POLY_EDGE_INDEX::IntersectsEdge( const SEG& aSeg ) const
+{
+    return !visit( std::min( aSeg.A.x, aSeg.B.x ) - 1, std::min( aSeg.A.y, aSeg.B.y ) - 1,
+                   std::max( aSeg.A.x, aSeg.B.x ) + 1, std::max( aSeg.A.y, aSeg.B.y ) + 1,
+                   [&]( const EDGE& aEdge ) -> bool
+                   {
+                       return !aEdge.m_seg.Intersect( aSeg, true );
+                   } );
+}
+
+
+bool POLY_EDGE_INDEX::IsEdgeCloser( const VECTOR2I& aP, int aDist ) const
+{
+    int64_t margin = (int64_t) aDist + DISTANCE_ROUNDING;
+
+    return !visit( aP.x - margin, aP.y - margin, aP.x + margin, aP.y + margin,
+                   [&]( const EDGE& aEdge ) -> bool
+                   {
+                       return aEdge.m_seg.Distance( aP ) > aDist;
+                   } );
+}
+
+
+bool POLY_EDGE_INDEX::IsEdgeCloser( const SEG& aSeg, int aDist ) const
+{
+    int64_t margin = (int64_t) aDist + DISTANCE_ROUNDING;
+
+    return !visit( std::min( aSeg.A.x, aSeg.B.x ) - margin, std::min( aSeg.A.y, aSeg.B.y ) - margin,
+                   std::max( aSeg.A.x, aSeg.B.x ) + margin, std::max( aSeg.A.y, aSeg.B.y ) + margin,
+                   [&]( const EDGE& aEdge ) -> bool
+                   {
+                       return aEdge.m_seg.Distance( aSeg ) > aDist;
+                   } );
+}
+
+
+int POLY_EDGE_INDEX::EdgeDistance( const VECTOR2I& aP, int aSubpolyIndex ) const
+{
+    return edgeDistance( aP.x, aP.y, aP.x, aP.y, aSubpolyIndex,
+                         [&]( const SEG& aEdge )
+                         {
+                             return aEdge.Distance( aP );
+                         } );
+}
+
+
+int POLY_EDGE_INDEX::EdgeDistance( const SEG& aSeg, int aSubpolyIndex ) const
+{
+    return edgeDistance( std::min( aSeg.A.x, aSeg.B.x ), std::min( aSeg.A.y, aSeg.B.y ),
+                         std::max( aSeg.A.x, aSeg.B.x ), std::max( aSeg.A.y, aSeg.B.y ),
+                         aSubpolyIndex,
+                         [&]( const SEG& aEdge )
+                         {
+                             return aEdge.Distance( aSeg );
+                         } );
+}
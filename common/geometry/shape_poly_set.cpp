@@ -41,6 +41,7 @@
 #include <make_unique.h>
 
 #include <geometry/geometry_utils.h>
+#include <geometry/poly_edge_index.h>
 #include <geometry/shape.h>
 #include <geometry/shape_line_chain.h>
 #include <geometry/shape_poly_set.h>
@@ -48,6 +49,10 @@
 
 using namespace ClipperLib;
 
+/// Number of queries after which a set is indexed (when it has enough edges): a set queried
+/// only once or twice is faster scanned than indexed
+static const int EDGE_INDEX_MIN_QUERIES = 4;
+
 SHAPE_POLY_SET::SHAPE_POLY_SET() :
     SHAPE( SH_POLY_SET )
 {
@@ -137,7 +142,7 @@ bool SHAPE_POLY_SET::GetGlobalIndex( SHAPE_POLY_SET::VERTEX_INDEX aRelativeIndic
 
         for( unsigned int polygonIdx = 0; polygonIdx < selectedPolygon; polygonIdx++ )
         {
-            currentPolygon = Polygon( polygonIdx );
+            currentPolygon = CPolygon( polygonIdx );
 
             for( unsigned int contourIdx = 0; contourIdx < currentPolygon.size(); contourIdx++ )
             {
@@ -145,7 +150,7 @@ bool SHAPE_POLY_SET::GetGlobalIndex( SHAPE_POLY_SET::VERTEX_INDEX aRelativeIndic
             }
         }
 
-        currentPolygon = Polygon( selectedPolygon );
+        currentPolygon = CPolygon( selectedPolygon );
 
         for( unsigned int contourIdx = 0; contourIdx < selectedContour; contourIdx++ )
         {
@@ -165,6 +170,8 @@ bool SHAPE_POLY_SET::GetGlobalIndex( SHAPE_POLY_SET::VERTEX_INDEX aRelativeIndic
 
 int SHAPE_POLY_SET::NewOutline()
 {
+    invalidateEdgeIndex();
+
     SHAPE_LINE_CHAIN empty_path;
     POLYGON poly;
 
@@ -177,6 +184,8 @@ int SHAPE_POLY_SET::NewOutline()
 
 int SHAPE_POLY_SET::NewHole( int aOutline )
 {
+    invalidateEdgeIndex();
+
     SHAPE_LINE_CHAIN empty_path;
 
     empty_path.SetClosed( true );
@@ -194,6 +203,8 @@ int SHAPE_POLY_SET::NewHole( int aOutline )
 
 int SHAPE_POLY_SET::Append( int x, int y, int aOutline, int aHole, bool aAllowDuplication )
 {
+    invalidateEdgeIndex();
+
     if( aOutline < 0 )
         aOutline += m_polys.size();
 
@@ -215,6 +226,8 @@ int SHAPE_POLY_SET::Append( int x, int y, int aOutline, int aHole, bool aAllowDu
 
 void SHAPE_POLY_SET::InsertVertex( int aGlobalIndex, VECTOR2I aNewVertex )
 {
+    invalidateEdgeIndex();
+
     VERTEX_INDEX index;
 
     if( aGlobalIndex < 0 )
@@ -268,7 +281,7 @@ SHAPE_POLY_SET SHAPE_POLY_SET::Subset( int aFirstPolygon, int aLastPolygon )
 
     for( int index = aFirstPolygon; index < aLastPolygon; index++ )
     {
-        newPolySet.m_polys.push_back( Polygon( index ) );
+        newPolySet.m_polys.push_back( CPolygon( index ) );
     }
 
     return newPolySet;
@@ -277,6 +290,8 @@ SHAPE_POLY_SET SHAPE_POLY_SET::Subset( int aFirstPolygon, int aLastPolygon )
 
 VECTOR2I& SHAPE_POLY_SET::Vertex( int aIndex, int aOutline, int aHole )
 {
+    invalidateEdgeIndex();
+
     if( aOutline < 0 )
         aOutline += m_polys.size();
 
@@ -315,6 +330,8 @@ const VECTOR2I& SHAPE_POLY_SET::CVertex( int aIndex, int aOutline, int aHole ) c
 
 VECTOR2I& SHAPE_POLY_SET::Vertex( int aGlobalIndex )
 {
+    invalidateEdgeIndex();
+
     SHAPE_POLY_SET::VERTEX_INDEX index;
 
     // Assure the passed index references a legal position; abort otherwise
@@ -437,6 +454,8 @@ bool SHAPE_POLY_SET::IsSelfIntersecting()
 
 int SHAPE_POLY_SET::AddOutline( const SHAPE_LINE_CHAIN& aOutline )
 {
+    invalidateEdgeIndex();
+
     assert( aOutline.IsClosed() );
 
     POLYGON poly;
@@ -451,6 +470,8 @@ int SHAPE_POLY_SET::AddOutline( const SHAPE_LINE_CHAIN& aOutline )
 
 int SHAPE_POLY_SET::AddHole( const SHAPE_LINE_CHAIN& aHole, int aOutline )
 {
+    invalidateEdgeIndex();
+
     assert( m_polys.size() );
 
     if( aOutline < 0 )
@@ -600,6 +621,8 @@ void SHAPE_POLY_SET::Inflate( int aFactor, int aCircleSegmentsCount )
 
 void SHAPE_POLY_SET::importTree( PolyTree* tree )
 {
+    invalidateEdgeIndex();
+
     m_polys.clear();
 
     for( PolyNode* n = tree->GetFirst(); n; n = n->GetNext() )
@@ -838,6 +861,8 @@ void SHAPE_POLY_SET::fractureSingle( POLYGON& paths )
 
 void SHAPE_POLY_SET::Fracture( POLYGON_MODE aFastMode )
 {
+    invalidateEdgeIndex();
+
     Simplify( aFastMode );    // remove overlapping holes/degeneracy
 
     for( POLYGON& paths : m_polys )
@@ -1025,6 +1050,8 @@ bool SHAPE_POLY_SET::HasHoles() const
 
 void SHAPE_POLY_SET::Unfracture( POLYGON_MODE aFastMode )
 {
+    invalidateEdgeIndex();
+
     for( POLYGON& path : m_polys )
     {
         unfractureSingle( path );
@@ -1044,6 +1071,8 @@ void SHAPE_POLY_SET::Simplify( POLYGON_MODE aFastMode )
 
 int SHAPE_POLY_SET::NormalizeAreaOutlines()
 {
+    invalidateEdgeIndex();
+
     // We are expecting only one main outline, but this main outline can have holes
     // if holes: combine holes and remove them from the main outline.
     // Note also we are using SHAPE_POLY_SET::PM_STRICTLY_SIMPLE in polygon
@@ -1102,6 +1131,8 @@ const std::string SHAPE_POLY_SET::Format() const
 
 bool SHAPE_POLY_SET::Parse( std::stringstream& aStream )
 {
+    invalidateEdgeIndex();
+
     std::string tmp;
 
     aStream >> tmp;
@@ -1178,6 +1209,9 @@ const BOX2I SHAPE_POLY_SET::BBox( int aClearance ) const
 
 bool SHAPE_POLY_SET::PointOnEdge( const VECTOR2I& aP ) const
 {
+    if( std::shared_ptr<const POLY_EDGE_INDEX> index = edgeIndex() )
+        return index->PointOnEdge( aP );
+
     // Iterate through all the polygons in the set
     for( const POLYGON& polygon : m_polys )
     {
@@ -1195,24 +1229,25 @@ bool SHAPE_POLY_SET::PointOnEdge( const VECTOR2I& aP ) const
 
 bool SHAPE_POLY_SET::Collide( const SEG& aSeg, int aClearance ) const
 {
-
-    SHAPE_POLY_SET polySet = SHAPE_POLY_SET( *this );
-
-    // Inflate the polygon if necessary.
-    if( aClearance > 0 )
-    {
-        // fixme: the number of arc segments should not be hardcoded
-        polySet.Inflate( aClearance, 8 );
-    }
-
     // We are going to check to see if the segment crosses an external
     // boundary.  However, if the full segment is inside the polyset, this
     // will not be true.  So we first test to see if one of the points is
     // inside.  If true, then we collide
-    if( polySet.Contains( aSeg.A ) )
+    if( Contains( aSeg.A ) )
         return true;
 
-    for( SEGMENT_ITERATOR iterator = polySet.IterateSegmentsWithHoles(); iterator; iterator++ )
+    if( aClearance > 0 )
+    {
+        if( !isEdgeCloser( aSeg, aClearance ) )
+            return false;
+
+        return inflated( aClearance )->Collide( aSeg, 0 );
+    }
+
+    if( std::shared_ptr<const POLY_EDGE_INDEX> index = edgeIndex() )
+        return index->IntersectsEdge( aSeg );
+
+    for( CONST_SEGMENT_ITERATOR iterator = CIterateSegmentsWithHoles(); iterator; iterator++ )
     {
         SEG polygonEdge = *iterator;
 
@@ -1226,28 +1261,83 @@ bool SHAPE_POLY_SET::Collide( const SEG& aSeg, int aClearance ) const
 
 bool SHAPE_POLY_SET::Collide( const VECTOR2I& aP, int aClearance ) const
 {
-    SHAPE_POLY_SET polySet = SHAPE_POLY_SET( *this );
+    // There is a collision if and only if the point is inside of the polygon inflated by
+    // aClearance
+    if( Contains( aP ) )
+        return true;
 
-    // Inflate the polygon if necessary.
-    if( aClearance > 0 )
+    if( aClearance <= 0 || !isEdgeCloser( aP, aClearance ) )
+        return false;
+
+    return inflated( aClearance )->Contains( aP );
+}
+
+
+template <typename T>
+bool SHAPE_POLY_SET::isEdgeCloser( const T& aObject, int aClearance ) const
+{
+    // The edges of the set inflated by aClearance are at most aClearance away from the edges
+    // of the set, plus the rounding of the offset to integer coordinates
+    const int dist = aClearance + 2;
+
+    if( std::shared_ptr<const POLY_EDGE_INDEX> index = edgeIndex() )
+        return index->IsEdgeCloser( aObject, dist );
+
+    for( CONST_SEGMENT_ITERATOR iterator = CIterateSegmentsWithHoles(); iterator; iterator++ )
+    {
+        if( ( *iterator ).Distance( aObject ) <= dist )
+            return true;
+    }
+
+    return false;
+}
+
+
+struct SHAPE_POLY_SET::INFLATED_SET
+{
+    INFLATED_SET( const SHAPE_POLY_SET& aSet, int aClearance ) :
+            m_clearance( aClearance ),
+            m_set( aSet )
     {
         // fixme: the number of arc segments should not be hardcoded
-        polySet.Inflate( aClearance, 8 );
+        m_set.Inflate( aClearance, 8 );
+        m_set.EnableEdgeIndex( aSet.m_edgeIndexEnabled );
+    }
+
+    int            m_clearance;
+    SHAPE_POLY_SET m_set;
+};
+
+
+std::shared_ptr<const SHAPE_POLY_SET> SHAPE_POLY_SET::inflated( int aClearance ) const
+{
+    std::shared_ptr<const INFLATED_SET> cached = std::atomic_load( &m_inflatedSet );
+
+    if( !cached || cached->m_clearance != aClearance )
+    {
+        cached = std::make_shared<const INFLATED_SET>( *this, aClearance );
+
+        // Sets with an edge index are queried many times, mostly with the same clearance
+        if( m_edgeIndexEnabled )
+            std::atomic_store( &m_inflatedSet, cached );
     }
 
-    // There is a collision if and only if the point is inside of the polygon.
-    return polySet.Contains( aP );
+    return std::shared_ptr<const SHAPE_POLY_SET>( cached, &cached->m_set );
 }
 
 
 void SHAPE_POLY_SET::RemoveAllContours()
 {
+    invalidateEdgeIndex();
+
     m_polys.clear();
 }
 
 
 void SHAPE_POLY_SET::RemoveContour( int aContourIdx, int aPolygonIdx )
 {
+    invalidateEdgeIndex();
+
     // Default polygon is the last one
     if( aPolygonIdx < 0 )
         aPolygonIdx += m_polys.size();
@@ -1311,12 +1401,16 @@ int SHAPE_POLY_SET::RemoveNullSegments()
 
 void SHAPE_POLY_SET::DeletePolygon( int aIdx )
 {
+    invalidateEdgeIndex();
+
     m_polys.erase( m_polys.begin() + aIdx );
 }
 
 
 void SHAPE_POLY_SET::Append( const SHAPE_POLY_SET& aSet )
 {
+    invalidateEdgeIndex();
+
     m_polys.insert( m_polys.end(), aSet.m_polys.begin(), aSet.m_polys.end() );
 }
 
@@ -1400,6 +1494,9 @@ bool SHAPE_POLY_SET::Contains( const VECTOR2I& aP, int aSubpolyIndex, bool aIgno
     if( m_polys.size() == 0 ) // empty set?
         return false;
 
+    if( std::shared_ptr<const POLY_EDGE_INDEX> index = edgeIndex() )
+        return index->Contains( aP, aSubpolyIndex, aIgnoreHoles );
+
     // If there is a polygon specified, check the condition against that polygon
     if( aSubpolyIndex >= 0 )
         return containsSingle( aP, aSubpolyIndex, aIgnoreHoles );
@@ -1429,6 +1526,8 @@ void SHAPE_POLY_SET::RemoveVertex( int aGlobalIndex )
 
 void SHAPE_POLY_SET::RemoveVertex( VERTEX_INDEX aIndex )
 {
+    invalidateEdgeIndex();
+
     m_polys[aIndex.m_polygon][aIndex.m_contour].Remove( aIndex.m_vertex );
 }
 
@@ -1465,8 +1564,50 @@ bool SHAPE_POLY_SET::pointInPolygon( const VECTOR2I& aP, const SHAPE_LINE_CHAIN&
 }
 
 
+std::shared_ptr<const POLY_EDGE_INDEX> SHAPE_POLY_SET::edgeIndex() const
+{
+    if( !m_edgeIndexEnabled )
+        return nullptr;
+
+    std::shared_ptr<const POLY_EDGE_INDEX> index = std::atomic_load( &m_edgeIndex );
+
+    if( index || m_edgeIndexQueries.load( std::memory_order_relaxed ) >= EDGE_INDEX_MIN_QUERIES )
+        return index;
+
+    // Only the query reaching the threshold builds the index; concurrent ones scan the edges
+    // in the meantime.  If the set cannot be indexed, the count stays past the threshold
+    // until the next change, so the test is not repeated.
+    if( ++m_edgeIndexQueries != EDGE_INDEX_MIN_QUERIES || !POLY_EDGE_INDEX::CanIndex( *this ) )
+        return nullptr;
+
+    index = std::make_shared<const POLY_EDGE_INDEX>( *this );
+    std::atomic_store( &m_edgeIndex, index );
+
+    return index;
+}
+
+
+void SHAPE_POLY_SET::EnableEdgeIndex( bool aEnable )
+{
+    m_edgeIndexEnabled = aEnable;
+
+    if( !aEnable )
+        clearEdgeIndex();
+}
+
+
+void SHAPE_POLY_SET::clearEdgeIndex() const
+{
+    std::atomic_store( &m_edgeIndex, std::shared_ptr<const POLY_EDGE_INDEX>() );
+    std::atomic_store( &m_inflatedSet, std::shared_ptr<const INFLATED_SET>() );
+    m_edgeIndexQueries = 0;
+}
+
+
 void SHAPE_POLY_SET::Move( const VECTOR2I& aVector )
 {
+    invalidateEdgeIndex();
+
     for( POLYGON& poly : m_polys )
     {
         for( SHAPE_LINE_CHAIN& path : poly )
@@ -1479,6 +1620,8 @@ void SHAPE_POLY_SET::Move( const VECTOR2I& aVector )
 
 void SHAPE_POLY_SET::Rotate( double aAngle, const VECTOR2I& aCenter )
 {
+    invalidateEdgeIndex();
+
     for( POLYGON& poly : m_polys )
     {
         for( SHAPE_LINE_CHAIN& path : poly )
@@ -1519,8 +1662,16 @@ SHAPE_POLY_SET::POLYGON SHAPE_POLY_SET::FilletPolygon( unsigned int aRadius,
 }
 
 
-int SHAPE_POLY_SET::DistanceToPolygon( VECTOR2I aPoint, int aPolygonIndex )
+int SHAPE_POLY_SET::DistanceToPolygon( VECTOR2I aPoint, int aPolygonIndex ) const
 {
+    if( std::shared_ptr<const POLY_EDGE_INDEX> index = edgeIndex() )
+    {
+        if( index->Contains( aPoint, aPolygonIndex ) )
+            return 0;
+
+        return index->EdgeDistance( aPoint, aPolygonIndex );
+    }
+
     // We calculate the min dist between the segment and each outline segment
     // However, if the segment to test is inside the outline, and does not cross
     // any edge, it can be seen outside the polygon.
@@ -1528,7 +1679,7 @@ int SHAPE_POLY_SET::DistanceToPolygon( VECTOR2I aPoint, int aPolygonIndex )
     if( containsSingle( aPoint, aPolygonIndex ) )
         return 0;
 
-    SEGMENT_ITERATOR iterator = IterateSegmentsWithHoles( aPolygonIndex );
+    CONST_SEGMENT_ITERATOR iterator = CIterateSegmentsWithHoles( aPolygonIndex );
 
     SEG polygonEdge = *iterator;
     int minDistance = polygonEdge.Distance( aPoint );
@@ -1547,28 +1698,41 @@ int SHAPE_POLY_SET::DistanceToPolygon( VECTOR2I aPoint, int aPolygonIndex )
 }
 
 
-int SHAPE_POLY_SET::DistanceToPolygon( SEG aSegment, int aPolygonIndex, int aSegmentWidth )
+int SHAPE_POLY_SET::DistanceToPolygon( SEG aSegment, int aPolygonIndex, int aSegmentWidth ) const
 {
     // We calculate the min dist between the segment and each outline segment
     // However, if the segment to test is inside the outline, and does not cross
     // any edge, it can be seen outside the polygon.
     // Therefore test if a segment end is inside ( testing only one end is enough )
-    if( containsSingle( aSegment.A, aPolygonIndex ) )
-        return 0;
-
-    SEGMENT_ITERATOR iterator = IterateSegmentsWithHoles( aPolygonIndex );
+    std::shared_ptr<const POLY_EDGE_INDEX> index = edgeIndex();
+    int                    minDistance;
 
-    SEG polygonEdge = *iterator;
-    int minDistance = polygonEdge.Distance( aSegment );
+    if( index )
+    {
+        if( index->Contains( aSegment.A, aPolygonIndex ) )
+            return 0;
 
-    for( iterator++; iterator && minDistance > 0; iterator++ )
+        minDistance = index->EdgeDistance( aSegment, aPolygonIndex );
+    }
+    else
     {
-        polygonEdge = *iterator;
+        if( containsSingle( aSegment.A, aPolygonIndex ) )
+            return 0;
 
-        int currentDistance = polygonEdge.Distance( aSegment );
+        CONST_SEGMENT_ITERATOR iterator = CIterateSegmentsWithHoles( aPolygonIndex );
 
-        if( currentDistance < minDistance )
-            minDistance = currentDistance;
+        SEG polygonEdge = *iterator;
+        minDistance = polygonEdge.Distance( aSegment );
+
+        for( iterator++; iterator && minDistance > 0; iterator++ )
+        {
+            polygonEdge = *iterator;
+
+            int currentDistance = polygonEdge.Distance( aSegment );
+
+            if( currentDistance < minDistance )
+                minDistance = currentDistance;
+        }
     }
 
     // Take into account the width of the segment
@@ -1580,8 +1744,12 @@ int SHAPE_POLY_SET::DistanceToPolygon( SEG aSegment, int aPolygonIndex, int aSeg
 }
 
 
-int SHAPE_POLY_SET::Distance( VECTOR2I aPoint )
+int SHAPE_POLY_SET::Distance( VECTOR2I aPoint ) const
 {
+    // The index finds the closest edge of all the polygons at once
+    if( std::shared_ptr<const POLY_EDGE_INDEX> index = edgeIndex() )
+        return index->Contains( aPoint ) ? 0 : index->EdgeDistance( aPoint );
+
     int currentDistance;
     int minDistance = DistanceToPolygon( aPoint, 0 );
 
@@ -1598,8 +1766,21 @@ int SHAPE_POLY_SET::Distance( VECTOR2I aPoint )
 }
 
 
-int SHAPE_POLY_SET::Distance( const SEG& aSegment, int aSegmentWidth )
+int SHAPE_POLY_SET::Distance( const SEG& aSegment, int aSegmentWidth ) const
 {
+    if( std::shared_ptr<const POLY_EDGE_INDEX> index = edgeIndex() )
+    {
+        if( index->Contains( aSegment.A ) )
+            return 0;
+
+        int minDistance = index->EdgeDistance( aSegment );
+
+        if( aSegmentWidth > 0 )
+            minDistance -= aSegmentWidth / 2;
+
+        return minDistance < 0 ? 0 : minDistance;
+    }
+
     int currentDistance;
     int minDistance = DistanceToPolygon( aSegment, 0, aSegmentWidth );
 
@@ -1818,6 +1999,7 @@ SHAPE_POLY_SET &SHAPE_POLY_SET::operator=( const SHAPE_POLY_SET& aOther )
 {
     static_cast<SHAPE&>(*this) = aOther;
     m_polys = aOther.m_polys;
+    clearEdgeIndex();
 
     // reset poly cache:
     m_hash = MD5_HASH{};
@@ -1849,6 +2031,15 @@ bool SHAPE_POLY_SET::IsTriangulationUpToDate() const
 }
 
 
+void SHAPE_POLY_SET::SetTriangulation(
+        std::vector<std::unique_ptr<TRIANGULATED_POLYGON>>&& aPolys )
+{
+    m_triangulatedPolys = std::move( aPolys );
+    m_hash = checksum();
+    m_triangulationValid = true;
+}
+
+
 void SHAPE_POLY_SET::CacheTriangulation()
 {
     bool recalculate = !m_hash.IsValid();
@@ -0,0 +1,168 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <mapped_file.h>
+
+#include <cstdint>
+#include <cstdio>
+
+#include <wx/intl.h>
+#include <wx/filefn.h>
+
+#include <ki_exception.h>
+
+#ifdef __WINDOWS__
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+MAPPED_FILE::MAPPED_FILE( const wxString& aFileName ) :
+        m_fileName( aFileName ),
+        m_data( "" ),
+        m_size( 0 ),
+        m_view( nullptr )
+{
+    if( !map() )
+        read();
+}
+
+
+MAPPED_FILE::~MAPPED_FILE()
+{
+    if( !m_view )
+        return;
+
+#ifdef __WINDOWS__
+    UnmapViewOfFile( m_view );
+#else
+    munmap( m_view, m_size );
+#endif
+}
+
+
+#ifdef __WINDOWS__
+
+bool MAPPED_FILE::map()
+{
+    HANDLE file = CreateFileW( m_fileName.wc_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                               OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL );
+
+    if( file == INVALID_HANDLE_VALUE )
+        return false;
+
+    LARGE_INTEGER size;
+    HANDLE        mapping = NULL;
+
+    // An empty file cannot be mapped, but has nothing to read anyway
+    if( GetFileSizeEx( file, &size ) && size.QuadPart > 0
+            && (unsigned long long) size.QuadPart <= SIZE_MAX )
+    {
+        mapping = CreateFileMappingW( file, NULL, PAGE_READONLY, 0, 0, NULL );
+    }
+
+    if( mapping )
+    {
+        // The view keeps the file mapped after the handles are closed
+        m_view = MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+        CloseHandle( mapping );
+    }
+
+    CloseHandle( file );
+
+    if( !m_view )
+        return false;
+
+    m_data = static_cast<const char*>( m_view );
+    m_size = (size_t) size.QuadPart;
+    return true;
+}
+
+#else
+
+bool MAPPED_FILE::map()
+{
+    int fd = open( m_fileName.fn_str(), O_RDONLY );
+
+    if( fd < 0 )
+        return false;
+
+    struct stat st;
+
+    if( fstat( fd, &st ) == 0 && st.st_size > 0 && S_ISREG( st.st_mode ) )
+    {
+        void* view = mmap( nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+
+        if( view != MAP_FAILED )
+        {
+            // The file is read from start to end, tell the system to read ahead
+            madvise( view, st.st_size, MADV_SEQUENTIAL );
+
+            m_view = view;
+            m_data = static_cast<const char*>( view );
+            m_size = st.st_size;
+        }
+    }
+
+    // The mapping stays valid after the file is closed
+    close( fd );
+
+    return m_view != nullptr;
+}
+
+#endif
+
+
+void MAPPED_FILE::read()
+{
+    FILE* fp = wxFopen( m_fileName, wxT( "rb" ) );
+
+    if( !fp )
+    {
+        THROW_IO_ERROR( wxString::Format( _( "Unable to open filename \"%s\" for reading" ),
+                                          m_fileName.GetData() ) );
+    }
+
+    char   buffer[65536];
+    size_t count;
+
+    while( ( count = fread( buffer, 1, sizeof( buffer ), fp ) ) > 0 )
+        m_copy.insert( m_copy.end(), buffer, buffer + count );
+
+    bool failed = ferror( fp );
+
+    fclose( fp );
+
+    if( failed )
+    {
+        THROW_IO_ERROR( wxString::Format( _( "Error reading file \"%s\"" ),
+                                          m_fileName.GetData() ) );
+    }
+
+    m_data = m_copy.empty() ? "" : m_copy.data();
+    m_size = m_copy.size();
+}
@@ -0,0 +1,256 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <number_parser.h>
+
+#include <cerrno>
+#include <climits>
+#include <clocale>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+
+// Powers of 10 which are exact doubles
+static const double s_powersOf10[] =
+{
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static const int MAX_EXACT_POWER = 22;
+
+// Largest integer all the integers below which are exact doubles
+static const uint64_t MAX_EXACT_MANTISSA = uint64_t( 1 ) << 53;
+
+// Significant digits which always fit a uint64_t
+static const int MAX_MANTISSA_DIGITS = 19;
+
+
+static inline bool isDigit( char cc )
+{
+    return '0' <= cc && cc <= '9';
+}
+
+
+// The white space of isspace() in the "C" locale
+static inline bool isSpace( char cc )
+{
+    return cc == ' ' || ( '\t' <= cc && cc <= '\r' );
+}
+
+
+/**
+ * Convert with strtod() the numbers the fast path cannot convert exactly (more than 19
+ * significant digits, large exponents), and the special forms (hexadecimal, inf, nan):
+ * the number is copied with the decimal separator of the current locale.
+ */
+static double slowStrToDouble( const char* aText, const char** aEnd )
+{
+    const char* decimalPoint = localeconv()->decimal_point;
+    char        separator = ( decimalPoint && strlen( decimalPoint ) == 1 ) ? *decimalPoint : '.';
+    const char* cp = aText;
+    std::string number;
+
+    while( isSpace( *cp ) )
+        number += *cp++;
+
+    // All the characters which can be part of a number, and no decimal separator of any locale
+    for( ; isDigit( *cp ) || ( *cp >= 'a' && *cp <= 'z' ) || ( *cp >= 'A' && *cp <= 'Z' )
+               || *cp == '.' || *cp == '+' || *cp == '-';
+         ++cp )
+    {
+        number += ( *cp == '.' ) ? separator : *cp;
+    }
+
+    char*  end;
+    double value = strtod( number.c_str(), &end );
+
+    if( aEnd )
+        *aEnd = aText + ( end - number.c_str() );
+
+    return value;
+}
+
+
+double StrToDouble( const char* aText, const char** aEnd )
+{
+    const char* cp = aText;
+
+    while( isSpace( *cp ) )
+        ++cp;
+
+    bool negative = ( *cp == '-' );
+
+    if( *cp == '-' || *cp == '+' )
+        ++cp;
+
+    // Hexadecimal numbers
+    if( cp[0] == '0' && ( cp[1] == 'x' || cp[1] == 'X' ) )
+        return slowStrToDouble( aText, aEnd );
+
+    uint64_t mantissa = 0;
+    int      digits = 0;        // significant digits in mantissa
+    int      exponent = 0;
+    bool     exact = true;      // false if digits were dropped from mantissa
+    bool     anyDigit = false;
+
+    for( ; isDigit( *cp ); ++cp )
+    {
+        anyDigit = true;
+
+        if( digits < MAX_MANTISSA_DIGITS )
+        {
+            mantissa = mantissa * 10 + ( *cp - '0' );
+            digits += ( mantissa != 0 );
+        }
+        else
+        {
+            exponent++;
+            exact = exact && *cp == '0';
+        }
+    }
+
+    if( *cp == '.' )
+    {
+        for( ++cp; isDigit( *cp ); ++cp )
+        {
+            anyDigit = true;
+
+            if( digits < MAX_MANTISSA_DIGITS )
+            {
+                mantissa = mantissa * 10 + ( *cp - '0' );
+                digits += ( mantissa != 0 );
+                exponent--;
+            }
+            else
+            {
+                exact = exact && *cp == '0';
+            }
+        }
+    }
+
+    // No digits: nothing to convert, or inf and nan
+    if( !anyDigit )
+        return slowStrToDouble( aText, aEnd );
+
+    // The exponent is only part of the number if it has digits
+    if( *cp == 'e' || *cp == 'E' )
+    {
+        const char* exp = cp + 1;
+        bool        negativeExp = ( *exp == '-' );
+
+        if( *exp == '-' || *exp == '+' )
+            ++exp;
+
+        if( isDigit( *exp ) )
+        {
+            int value = 0;
+
+            for( ; isDigit( *exp ); ++exp )
+            {
+                if( value < 100000 )
+                    value = value * 10 + ( *exp - '0' );
+            }
+
+            exponent += negativeExp ? -value : value;
+            cp = exp;
+        }
+    }
+
+    double value;
+
+    if( mantissa == 0 )
+    {
+        value = 0.0;
+    }
+    else if( exact && mantissa <= MAX_EXACT_MANTISSA
+             && exponent >= -MAX_EXACT_POWER && exponent <= MAX_EXACT_POWER )
+    {
+        // Both operands are exact, so the result of the single operation is correctly rounded
+        if( exponent < 0 )
+            value = (double) mantissa / s_powersOf10[-exponent];
+        else
+            value = (double) mantissa * s_powersOf10[exponent];
+    }
+    else
+    {
+        return slowStrToDouble( aText, aEnd );
+    }
+
+    if( aEnd )
+        *aEnd = cp;
+
+    return negative ? -value : value;
+}
+
+
+long StrToLong( const char* aText, const char** aEnd )
+{
+    const char* cp = aText;
+
+    while( isSpace( *cp ) )
+        ++cp;
+
+    bool negative = ( *cp == '-' );
+
+    if( *cp == '-' || *cp == '+' )
+        ++cp;
+
+    if( !isDigit( *cp ) )
+    {
+        if( aEnd )
+            *aEnd = aText;
+
+        return 0;
+    }
+
+    unsigned long limit = negative ? (unsigned long) LONG_MAX + 1 : (unsigned long) LONG_MAX;
+    unsigned long value = 0;
+    bool          overflow = false;
+
+    for( ; isDigit( *cp ); ++cp )
+    {
+        unsigned long digit = *cp - '0';
+
+        if( value > ( limit - digit ) / 10 )
+            overflow = true;
+        else
+            value = value * 10 + digit;
+    }
+
+    if( aEnd )
+        *aEnd = cp;
+
+    if( overflow )
+    {
+        errno = ERANGE;
+        return negative ? LONG_MIN : LONG_MAX;
+    }
+
+    if( negative )
+        return ( value == (unsigned long) LONG_MAX + 1 ) ? LONG_MIN : -(long) value;
+
+    return (long) value;
+}
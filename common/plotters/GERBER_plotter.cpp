@@ -43,6 +43,44 @@
 #include <gbr_metadata.h>
 
 
+// The aperture macros of the flashed shapes which have no standard aperture.  They are
+// written in the aperture list when used, and their parameters are given by each aperture.
+static const char s_rotRectMacro[] =
+    "%AMRotRect*\n"
+    "0 Rectangle rotated around its center*\n"
+    "0 $1 width, $2 height, $3 rotation in degrees*\n"
+    "21,1,$1,$2,0,0,$3*%\n";
+
+static const char s_roundRectMacro[] =
+    "%AMRoundRect*\n"
+    "0 Rectangle with rounded corners rotated around its center*\n"
+    "0 $1 $2 size of the horizontal body, $3 $4 size of the vertical body*\n"
+    "0 $5 corner diameter, $6 $7 $8 $9 X and -X, Y and -Y corner positions*\n"
+    "0 $10 rotation in degrees*\n"
+    "21,1,$1,$2,0,0,$10*\n"
+    "21,1,$3,$4,0,0,$10*\n"
+    "1,1,$5,$6,$8,$10*\n"
+    "1,1,$5,$7,$8,$10*\n"
+    "1,1,$5,$7,$9,$10*\n"
+    "1,1,$5,$6,$9,$10*%\n";
+
+
+/**
+ * @return the rotation in degrees of a flashed rect or roundrect aperture, from a pad
+ * orientation in 0.1 degrees.  These shapes are symmetrical, so the rotation is kept in
+ * 0 .. 180 degrees, to share the apertures of pads rotated by 180 degrees.
+ */
+static double apertureMacroRotation( double aOrient )
+{
+    double rotation = fmod( aOrient, 1800.0 );
+
+    if( rotation < 0 )
+        rotation += 1800.0;
+
+    return rotation / 10.0;
+}
+
+
 GERBER_PLOTTER::GERBER_PLOTTER()
 {
     workFile  = NULL;
@@ -287,32 +325,49 @@ void GERBER_PLOTTER::SetCurrentLineWidth( int width, void* aData )
 }
 
 
-std::vector<APERTURE>::iterator GERBER_PLOTTER::getAperture( const wxSize& aSize,
-                        APERTURE::APERTURE_TYPE aType, int aApertureAttribute )
+size_t GERBER_PLOTTER::APERTURE_HASH::operator()( const APERTURE& aAperture ) const
 {
-    int last_D_code = 9;
+    size_t hash = std::hash<int>()( aAperture.m_Type );
 
-    // Search an existing aperture
-    std::vector<APERTURE>::iterator tool = apertures.begin();
+    hash = hash * 31 + std::hash<int>()( aAperture.m_Size.x );
+    hash = hash * 31 + std::hash<int>()( aAperture.m_Size.y );
+    hash = hash * 31 + std::hash<int>()( aAperture.m_Radius );
+    hash = hash * 31 + std::hash<double>()( aAperture.m_Rotation );
+    hash = hash * 31 + std::hash<int>()( aAperture.m_ApertureAttribute );
 
-    while( tool != apertures.end() )
-    {
-        last_D_code = tool->m_DCode;
+    return hash;
+}
 
-        if( (tool->m_Type == aType) && (tool->m_Size == aSize) &&
-            (tool->m_ApertureAttribute == aApertureAttribute) )
-            return tool;
 
-        ++tool;
-    }
+bool GERBER_PLOTTER::APERTURE_EQUAL::operator()( const APERTURE& aFirst,
+                                                 const APERTURE& aSecond ) const
+{
+    return aFirst.m_Type == aSecond.m_Type && aFirst.m_Size == aSecond.m_Size
+           && aFirst.m_Radius == aSecond.m_Radius && aFirst.m_Rotation == aSecond.m_Rotation
+           && aFirst.m_ApertureAttribute == aSecond.m_ApertureAttribute;
+}
 
-    // Allocate a new aperture
+
+std::vector<APERTURE>::iterator GERBER_PLOTTER::getAperture( const wxSize& aSize, int aRadius,
+                        double aRotation, APERTURE::APERTURE_TYPE aType, int aApertureAttribute )
+{
     APERTURE new_tool;
     new_tool.m_Size  = aSize;
     new_tool.m_Type  = aType;
-    new_tool.m_DCode = last_D_code + 1;
+    new_tool.m_Radius = aRadius;
+    new_tool.m_Rotation = aRotation;
     new_tool.m_ApertureAttribute = aApertureAttribute;
 
+    // Search an existing aperture
+    auto it = m_apertureIndex.find( new_tool );
+
+    if( it != m_apertureIndex.end() )
+        return apertures.begin() + it->second;
+
+    // Allocate a new aperture: the D codes are allocated in sequence, from 10
+    new_tool.m_DCode = apertures.empty() ? 10 : apertures.back().m_DCode + 1;
+
+    m_apertureIndex.emplace( new_tool, apertures.size() );
     apertures.push_back( new_tool );
 
     return apertures.end() - 1;
@@ -320,12 +375,16 @@ std::vector<APERTURE>::iterator GERBER_PLOTTER::getAperture( const wxSize& aSize
 
 
 void GERBER_PLOTTER::selectAperture( const wxSize&           aSize,
+                                     int                     aRadius,
+                                     double                  aRotation,
                                      APERTURE::APERTURE_TYPE aType,
                                      int aApertureAttribute )
 {
     bool change = ( currentAperture == apertures.end() ) ||
                   ( currentAperture->m_Type != aType ) ||
-                  ( currentAperture->m_Size != aSize );
+                  ( currentAperture->m_Size != aSize ) ||
+                  ( currentAperture->m_Radius != aRadius ) ||
+                  ( currentAperture->m_Rotation != aRotation );
 
     if( !m_useNetAttributes )
         aApertureAttribute = 0;
@@ -335,7 +394,7 @@ void GERBER_PLOTTER::selectAperture( const wxSize&           aSize,
     if( change )
     {
         // Pick an existing aperture or create a new one
-        currentAperture = getAperture( aSize, aType, aApertureAttribute );
+        currentAperture = getAperture( aSize, aRadius, aRotation, aType, aApertureAttribute );
         fprintf( outputFile, "D%d*\n", currentAperture->m_DCode );
     }
 }
@@ -351,6 +410,22 @@ void GERBER_PLOTTER::writeApertureList()
     if( !m_useX2format )
         useX1StructuredComment = true;
 
+    // Write the definitions of the aperture macros in use
+    bool useRotRect = false;
+    bool useRoundRect = false;
+
+    for( const APERTURE& tool : apertures )
+    {
+        useRotRect |= tool.m_Type == APERTURE::RotRect;
+        useRoundRect |= tool.m_Type == APERTURE::RoundRect;
+    }
+
+    if( useRotRect )
+        fputs( s_rotRectMacro, outputFile );
+
+    if( useRoundRect )
+        fputs( s_roundRectMacro, outputFile );
+
     // Init
     for( std::vector<APERTURE>::iterator tool = apertures.begin();
          tool != apertures.end(); ++tool )
@@ -401,6 +476,30 @@ void GERBER_PLOTTER::writeApertureList()
 	            tool->m_Size.x * fscale,
 		    tool->m_Size.y * fscale );
             break;
+
+        case APERTURE::RotRect:
+            sprintf( text, "RotRect,%#fX%#fX%#f*%%\n",
+                     tool->m_Size.x * fscale,
+                     tool->m_Size.y * fscale,
+                     tool->m_Rotation );
+            break;
+
+        case APERTURE::RoundRect:
+        {
+            double cornerX = tool->m_Size.x / 2.0 - tool->m_Radius;
+            double cornerY = tool->m_Size.y / 2.0 - tool->m_Radius;
+
+            sprintf( text, "RoundRect,%#fX%#fX%#fX%#fX%#fX%#fX%#fX%#fX%#fX%#f*%%\n",
+                     tool->m_Size.x * fscale,
+                     cornerY * 2 * fscale,
+                     cornerX * 2 * fscale,
+                     tool->m_Size.y * fscale,
+                     tool->m_Radius * 2 * fscale,
+                     cornerX * fscale, -cornerX * fscale,
+                     cornerY * fscale, -cornerY * fscale,
+                     tool->m_Rotation );
+        }
+            break;
         }
 
         fputs( cbuf, outputFile );
@@ -791,9 +890,22 @@ void GERBER_PLOTTER::FlashPadRect( const wxPoint& pos, const wxSize& aSize,
         }
         break;
 
-    default: // plot pad shape as polygon
+    default:
+        if( trace_mode == FILLED )
+        {
+            // Flash a rotated rect aperture, defined by an aperture macro
+            DPOINT pos_dev = userToDeviceCoordinates( pos );
+            int aperture_attrib = gbr_metadata ? gbr_metadata->GetApertureAttrib() : 0;
+            selectAperture( size, 0, apertureMacroRotation( orient ), APERTURE::RotRect,
+                            aperture_attrib );
+
+            if( gbr_metadata )
+                formatNetAttribute( &gbr_metadata->m_NetlistMetadata );
+
+            emitDcode( pos_dev, 3 );
+        }
+        else    // plot pad shape as polygon
 	{
-	    // XXX to do: use an aperture macro to declare the rotated pad
 	    wxPoint coord[4];
 	    // coord[0] is assumed the lower left
 	    // coord[1] is assumed the upper left
@@ -821,6 +933,24 @@ void GERBER_PLOTTER::FlashPadRoundRect( const wxPoint& aPadPos, const wxSize& aS
                                      EDA_DRAW_MODE_T aTraceMode, void* aData )
 
 {
+    if( aTraceMode == FILLED )
+    {
+        // Flash a roundrect aperture, defined by an aperture macro
+        GBR_METADATA* metadata = static_cast<GBR_METADATA*>( aData );
+        int radius = std::min( aCornerRadius, std::min( aSize.x, aSize.y ) / 2 );
+        DPOINT pos_dev = userToDeviceCoordinates( aPadPos );
+        int aperture_attrib = metadata ? metadata->GetApertureAttrib() : 0;
+        selectAperture( aSize, radius, apertureMacroRotation( aOrient ), APERTURE::RoundRect,
+                        aperture_attrib );
+
+        if( metadata )
+            formatNetAttribute( &metadata->m_NetlistMetadata );
+
+        emitDcode( pos_dev, 3 );
+        return;
+    }
+
+    // In sketch mode, the pad outline is plotted
     GBR_METADATA gbr_metadata;
 
     if( aData )
@@ -835,18 +965,14 @@ void GERBER_PLOTTER::FlashPadRoundRect( const wxPoint& aPadPos, const wxSize& aS
         gbr_metadata.m_NetlistMetadata.ClearAttribute( &attrname );   // not allowed on inner layers
     }
 
-    if( aTraceMode != FILLED )
-        SetCurrentLineWidth( USE_DEFAULT_LINE_WIDTH, &gbr_metadata );
+    SetCurrentLineWidth( USE_DEFAULT_LINE_WIDTH, &gbr_metadata );
 
-    // Currently, a Pad RoundRect is plotted as polygon.
-    // TODO: use Aperture macro and flash it
     SHAPE_POLY_SET outline;
     const int segmentToCircleCount = 64;
     TransformRoundChamferedRectToPolygon( outline, aPadPos, aSize, aOrient,
                                  aCornerRadius, 0.0, 0, segmentToCircleCount );
 
-    if( aTraceMode != FILLED )
-        outline.Inflate( -GetCurrentLineWidth()/2, 16 );
+    outline.Inflate( -GetCurrentLineWidth()/2, 16 );
 
     std::vector< wxPoint > cornerList;
     // TransformRoundRectToPolygon creates only one convex polygon
@@ -859,16 +985,7 @@ void GERBER_PLOTTER::FlashPadRoundRect( const wxPoint& aPadPos, const wxSize& aS
     // Close polygon
     cornerList.push_back( cornerList[0] );
 
-    PlotPoly( cornerList, aTraceMode == FILLED ? FILLED_SHAPE : NO_FILL,
-              aTraceMode == FILLED ? 0 : GetCurrentLineWidth(), &gbr_metadata );
-
-    // Now, flash a pad anchor, if a netlist attribute is set
-    // (remove me when a Aperture macro will be used)
-    if( aData && aTraceMode == FILLED )
-    {
-        int diameter = std::min( aSize.x, aSize.y );
-        FlashPadCircle( aPadPos, diameter, aTraceMode , aData );
-    }
+    PlotPoly( cornerList, NO_FILL, GetCurrentLineWidth(), &gbr_metadata );
 }
 
 void GERBER_PLOTTER::FlashPadCustom( const wxPoint& aPadPos, const wxSize& aSize,
@@ -38,6 +38,26 @@
 #include <kicad_string.h>
 #include <wx/zstream.h>
 #include <wx/mstream.h>
+#include <richio.h>
+#include <thread_pool.h>
+
+
+PDF_PLOTTER::PDF_PLOTTER() :
+    pageTreeHandle( 0 ),
+    fontResDictHandle( 0 ),
+    xObjectResDictHandle( 0 ),
+    pageStreamHandle( 0 ),
+    workStream( nullptr ),
+    savedPenWidth( 0 )
+{
+}
+
+
+PDF_PLOTTER::~PDF_PLOTTER()
+{
+    // Wait for the compressions still running (i.e. the plot was not ended)
+    encoder.reset();
+}
 
 
 /*
@@ -94,7 +114,7 @@ void PDF_PLOTTER::SetViewport( const wxPoint& aOffset, double aIusPerDecimil,
  */
 void PDF_PLOTTER::SetCurrentLineWidth( int width, void* aData )
 {
-    wxASSERT( workFile );
+    wxASSERT( workStream );
     int pen_width;
 
     if( width > 0 )
@@ -105,8 +125,8 @@ void PDF_PLOTTER::SetCurrentLineWidth( int width, void* aData )
         pen_width = defaultPenWidth;
 
     if( pen_width != currentPenWidth )
-        fprintf( workFile, "%g w\n",
-                 userToDeviceSize( pen_width ) );
+        StrPrintf( workStream, "%g w\n",
+                   userToDeviceSize( pen_width ) );
 
     currentPenWidth = pen_width;
 }
@@ -123,9 +143,9 @@ void PDF_PLOTTER::SetCurrentLineWidth( int width, void* aData )
  */
 void PDF_PLOTTER::emitSetRGBColor( double r, double g, double b )
 {
-    wxASSERT( workFile );
-    fprintf( workFile, "%g %g %g rg %g %g %g RG\n",
-             r, g, b, r, g, b );
+    wxASSERT( workStream );
+    StrPrintf( workStream, "%g %g %g rg %g %g %g RG\n",
+               r, g, b, r, g, b );
 }
 
 /**
@@ -133,24 +153,24 @@ void PDF_PLOTTER::emitSetRGBColor( double r, double g, double b )
  */
 void PDF_PLOTTER::SetDash( int dashed )
 {
-    wxASSERT( workFile );
+    wxASSERT( workStream );
     switch( dashed )
     {
     case PLOTDASHTYPE_DASH:
-        fprintf( workFile, "[%d %d] 0 d\n",
+        StrPrintf( workStream, "[%d %d] 0 d\n",
                 (int) GetDashMarkLenIU(), (int) GetDashGapLenIU() );
         break;
     case PLOTDASHTYPE_DOT:
-        fprintf( workFile, "[%d %d] 0 d\n",
+        StrPrintf( workStream, "[%d %d] 0 d\n",
                 (int) GetDotMarkLenIU(), (int) GetDashGapLenIU() );
         break;
     case PLOTDASHTYPE_DASHDOT:
-        fprintf( workFile, "[%d %d %d %d] 0 d\n",
+        StrPrintf( workStream, "[%d %d %d %d] 0 d\n",
                 (int) GetDashMarkLenIU(), (int) GetDashGapLenIU(),
                 (int) GetDotMarkLenIU(), (int) GetDashGapLenIU() );
         break;
     default:
-        fputs( "[] 0 d\n", workFile );
+        workStream->append( "[] 0 d\n" );
     }
 }
 
@@ -160,14 +180,14 @@ void PDF_PLOTTER::SetDash( int dashed )
  */
 void PDF_PLOTTER::Rect( const wxPoint& p1, const wxPoint& p2, FILL_T fill, int width )
 {
-    wxASSERT( workFile );
+    wxASSERT( workStream );
     DPOINT p1_dev = userToDeviceCoordinates( p1 );
     DPOINT p2_dev = userToDeviceCoordinates( p2 );
 
     SetCurrentLineWidth( width );
-    fprintf( workFile, "%g %g %g %g re %c\n", p1_dev.x, p1_dev.y,
-             p2_dev.x - p1_dev.x, p2_dev.y - p1_dev.y,
-             fill == NO_FILL ? 'S' : 'B' );
+    StrPrintf( workStream, "%g %g %g %g re %c\n", p1_dev.x, p1_dev.y,
+               p2_dev.x - p1_dev.x, p2_dev.y - p1_dev.y,
+               fill == NO_FILL ? 'S' : 'B' );
 }
 
 
@@ -176,7 +196,7 @@ void PDF_PLOTTER::Rect( const wxPoint& p1, const wxPoint& p2, FILL_T fill, int w
  */
 void PDF_PLOTTER::Circle( const wxPoint& pos, int diametre, FILL_T aFill, int width )
 {
-    wxASSERT( workFile );
+    wxASSERT( workStream );
     DPOINT pos_dev = userToDeviceCoordinates( pos );
     double radius = userToDeviceSize( diametre / 2.0 );
 
@@ -200,30 +220,30 @@ void PDF_PLOTTER::Circle( const wxPoint& pos, int diametre, FILL_T aFill, int wi
     double magic = radius * 0.551784; // You don't want to know where this come from
 
     // This is the convex hull for the bezier approximated circle
-    fprintf( workFile, "%g %g m "
-                       "%g %g %g %g %g %g c "
-                       "%g %g %g %g %g %g c "
-                       "%g %g %g %g %g %g c "
-                       "%g %g %g %g %g %g c %c\n",
-             pos_dev.x - radius, pos_dev.y,
-
-             pos_dev.x - radius, pos_dev.y + magic,
-             pos_dev.x - magic, pos_dev.y + radius,
-             pos_dev.x, pos_dev.y + radius,
-
-             pos_dev.x + magic, pos_dev.y + radius,
-             pos_dev.x + radius, pos_dev.y + magic,
-             pos_dev.x + radius, pos_dev.y,
-
-             pos_dev.x + radius, pos_dev.y - magic,
-             pos_dev.x + magic, pos_dev.y - radius,
-             pos_dev.x, pos_dev.y - radius,
-
-             pos_dev.x - magic, pos_dev.y - radius,
-             pos_dev.x - radius, pos_dev.y - magic,
-             pos_dev.x - radius, pos_dev.y,
-
-             aFill == NO_FILL ? 's' : 'b' );
+    StrPrintf( workStream, "%g %g m "
+                           "%g %g %g %g %g %g c "
+                           "%g %g %g %g %g %g c "
+                           "%g %g %g %g %g %g c "
+                           "%g %g %g %g %g %g c %c\n",
+               pos_dev.x - radius, pos_dev.y,
+
+               pos_dev.x - radius, pos_dev.y + magic,
+               pos_dev.x - magic, pos_dev.y + radius,
+               pos_dev.x, pos_dev.y + radius,
+
+               pos_dev.x + magic, pos_dev.y + radius,
+               pos_dev.x + radius, pos_dev.y + magic,
+               pos_dev.x + radius, pos_dev.y,
+
+               pos_dev.x + radius, pos_dev.y - magic,
+               pos_dev.x + magic, pos_dev.y - radius,
+               pos_dev.x, pos_dev.y - radius,
+
+               pos_dev.x - magic, pos_dev.y - radius,
+               pos_dev.x - radius, pos_dev.y - magic,
+               pos_dev.x - radius, pos_dev.y,
+
+               aFill == NO_FILL ? 's' : 'b' );
 }
 
 
@@ -234,7 +254,7 @@ void PDF_PLOTTER::Circle( const wxPoint& pos, int diametre, FILL_T aFill, int wi
 void PDF_PLOTTER::Arc( const wxPoint& centre, double StAngle, double EndAngle, int radius,
                       FILL_T fill, int width )
 {
-    wxASSERT( workFile );
+    wxASSERT( workStream );
     if( radius <= 0 )
     {
         Circle( centre, width, FILLED_SHAPE, 0 );
@@ -255,30 +275,30 @@ void PDF_PLOTTER::Arc( const wxPoint& centre, double StAngle, double EndAngle, i
     start.x = centre.x + KiROUND( cosdecideg( radius, -StAngle ) );
     start.y = centre.y + KiROUND( sindecideg( radius, -StAngle ) );
     DPOINT pos_dev = userToDeviceCoordinates( start );
-    fprintf( workFile, "%g %g m ", pos_dev.x, pos_dev.y );
+    StrPrintf( workStream, "%g %g m ", pos_dev.x, pos_dev.y );
     for( int ii = StAngle + delta; ii < EndAngle; ii += delta )
     {
         end.x = centre.x + KiROUND( cosdecideg( radius, -ii ) );
         end.y = centre.y + KiROUND( sindecideg( radius, -ii ) );
         pos_dev = userToDeviceCoordinates( end );
-        fprintf( workFile, "%g %g l ", pos_dev.x, pos_dev.y );
+        StrPrintf( workStream, "%g %g l ", pos_dev.x, pos_dev.y );
     }
 
     end.x = centre.x + KiROUND( cosdecideg( radius, -EndAngle ) );
     end.y = centre.y + KiROUND( sindecideg( radius, -EndAngle ) );
     pos_dev = userToDeviceCoordinates( end );
-    fprintf( workFile, "%g %g l ", pos_dev.x, pos_dev.y );
+    StrPrintf( workStream, "%g %g l ", pos_dev.x, pos_dev.y );
 
     // The arc is drawn... if not filled we stroke it, otherwise we finish
     // closing the pie at the center
     if( fill == NO_FILL )
     {
-        fputs( "S\n", workFile );
+        workStream->append( "S\n" );
     }
     else
     {
         pos_dev = userToDeviceCoordinates( centre );
-        fprintf( workFile, "%g %g l b\n", pos_dev.x, pos_dev.y );
+        StrPrintf( workStream, "%g %g l b\n", pos_dev.x, pos_dev.y );
     }
 }
 
@@ -289,34 +309,34 @@ void PDF_PLOTTER::Arc( const wxPoint& centre, double StAngle, double EndAngle, i
 void PDF_PLOTTER::PlotPoly( const std::vector< wxPoint >& aCornerList,
                            FILL_T aFill, int aWidth, void * aData )
 {
-    wxASSERT( workFile );
+    wxASSERT( workStream );
     if( aCornerList.size() <= 1 )
         return;
 
     SetCurrentLineWidth( aWidth );
 
     DPOINT pos = userToDeviceCoordinates( aCornerList[0] );
-    fprintf( workFile, "%g %g m\n", pos.x, pos.y );
+    StrPrintf( workStream, "%g %g m\n", pos.x, pos.y );
 
     for( unsigned ii = 1; ii < aCornerList.size(); ii++ )
     {
         pos = userToDeviceCoordinates( aCornerList[ii] );
-        fprintf( workFile, "%g %g l\n", pos.x, pos.y );
+        StrPrintf( workStream, "%g %g l\n", pos.x, pos.y );
     }
 
     // Close path and stroke(/fill)
-    fprintf( workFile, "%c\n", aFill == NO_FILL ? 'S' : 'b' );
+    StrPrintf( workStream, "%c\n", aFill == NO_FILL ? 'S' : 'b' );
 }
 
 
 void PDF_PLOTTER::PenTo( const wxPoint& pos, char plume )
 {
-    wxASSERT( workFile );
+    wxASSERT( workStream );
     if( plume == 'Z' )
     {
         if( penState != 'Z' )
         {
-            fputs( "S\n", workFile );
+            workStream->append( "S\n" );
             penState     = 'Z';
             penLastpos.x = -1;
             penLastpos.y = -1;
@@ -327,9 +347,9 @@ void PDF_PLOTTER::PenTo( const wxPoint& pos, char plume )
     if( penState != plume || pos != penLastpos )
     {
         DPOINT pos_dev = userToDeviceCoordinates( pos );
-        fprintf( workFile, "%g %g %c\n",
-                 pos_dev.x, pos_dev.y,
-                 ( plume=='D' ) ? 'l' : 'm' );
+        StrPrintf( workStream, "%g %g %c\n",
+                   pos_dev.x, pos_dev.y,
+                   ( plume=='D' ) ? 'l' : 'm' );
     }
     penState   = plume;
     penLastpos = pos;
@@ -341,7 +361,7 @@ void PDF_PLOTTER::PenTo( const wxPoint& pos, char plume )
 void PDF_PLOTTER::PlotImage( const wxImage & aImage, const wxPoint& aPos,
                             double aScaleFactor )
 {
-    wxASSERT( workFile );
+    wxASSERT( workStream );
     wxSize pix_size( aImage.GetWidth(), aImage.GetHeight() );
 
     // Requested size (in IUs)
@@ -364,7 +384,7 @@ void PDF_PLOTTER::PlotImage( const wxImage & aImage, const wxPoint& aPos,
        3) restore the CTM
        4) profit
      */
-    fprintf( workFile, "q %g 0 0 %g %g %g cm\n", // Step 1
+    StrPrintf( workStream, "q %g 0 0 %g %g %g cm\n", // Step 1
             userToDeviceSize( drawsize.x ),
             userToDeviceSize( drawsize.y ),
             dev_start.x, dev_start.y );
@@ -373,13 +393,13 @@ void PDF_PLOTTER::PlotImage( const wxImage & aImage, const wxPoint& aPos,
        A real ugly construct (compared with the elegance of the PDF
        format). Also it accepts some 'abbreviations', which is stupid
        since the content stream is usually compressed anyway... */
-    fprintf( workFile,
-             "BI\n"
-             "  /BPC 8\n"
-             "  /CS %s\n"
-             "  /W %d\n"
-             "  /H %d\n"
-             "ID\n", colorMode ? "/RGB" : "/G", pix_size.x, pix_size.y );
+    StrPrintf( workStream,
+               "BI\n"
+               "  /BPC 8\n"
+               "  /CS %s\n"
+               "  /W %d\n"
+               "  /H %d\n"
+               "ID\n", colorMode ? "/RGB" : "/G", pix_size.x, pix_size.y );
 
     /* Here comes the stream (in binary!). I *could* have hex or ascii84
        encoded it, but who cares? I'll go through zlib anyway */
@@ -390,22 +410,21 @@ void PDF_PLOTTER::PlotImage( const wxImage & aImage, const wxPoint& aPos,
             unsigned char r = aImage.GetRed( x, y ) & 0xFF;
             unsigned char g = aImage.GetGreen( x, y ) & 0xFF;
             unsigned char b = aImage.GetBlue( x, y ) & 0xFF;
-            // As usual these days, stdio buffering has to suffeeeeerrrr
             if( colorMode )
             {
-            putc( r, workFile );
-            putc( g, workFile );
-            putc( b, workFile );
+            workStream->push_back( r );
+            workStream->push_back( g );
+            workStream->push_back( b );
             }
             else
             {
                 // Grayscale conversion
-                putc( (r + g + b) / 3, workFile );
+                workStream->push_back( (r + g + b) / 3 );
             }
         }
     }
 
-    fputs( "EI Q\n", workFile ); // Finish step 2 and do step 3
+    workStream->append( "EI Q\n" ); // Finish step 2 and do step 3
 }
 
 
@@ -428,7 +447,6 @@ int PDF_PLOTTER::allocPdfObject()
 int PDF_PLOTTER::startPdfObject(int handle)
 {
     wxASSERT( outputFile );
-    wxASSERT( !workFile );
 
     if( handle < 0)
         handle = allocPdfObject();
@@ -445,135 +463,307 @@ int PDF_PLOTTER::startPdfObject(int handle)
 void PDF_PLOTTER::closePdfObject()
 {
     wxASSERT( outputFile );
-    wxASSERT( !workFile );
     fputs( "endobj\n", outputFile );
 }
 
 
 /**
- * Starts a PDF stream (for the page). Returns the object handle opened
- * Pass -1 (default) for a fresh object. Especially from PDF 1.5 streams
- * can contain a lot of things, but for the moment we only handle page
- * content.
+ * DEFLATE aData in place
  */
-int PDF_PLOTTER::startPdfStream(int handle)
+static void compressPdfStream( std::string& aData )
 {
-    wxASSERT( outputFile );
-    wxASSERT( !workFile );
-    handle = startPdfObject( handle );
+    // NULL means memos owns the memory, but provide a hint on optimum size needed.
+    wxMemoryOutputStream    memos( NULL, std::max( (size_t) 2000, aData.size() ) );
 
-    // This is guaranteed to be handle+1 but needs to be allocated since
-    // you could allocate more object during stream preparation
-    streamLengthHandle = allocPdfObject();
-    fprintf( outputFile,
-             "<< /Length %d 0 R /Filter /FlateDecode >>\n" // Length is deferred
-             "stream\n", handle + 1 );
+    {
+        /* Somewhat standard parameters to compress in DEFLATE. The PDF spec is
+         * misleading, it says it wants a DEFLATE stream but it really want a ZLIB
+         * stream! (a DEFLATE stream would be generated with -15 instead of 15)
+         * rc = deflateInit2( &zstrm, Z_BEST_COMPRESSION, Z_DEFLATED, 15,
+         *                    8, Z_DEFAULT_STRATEGY );
+         */
 
-    // Open a temporary file to accumulate the stream
-    workFilename = filename + wxT(".tmp");
-    workFile = wxFopen( workFilename, wxT( "w+b" ));
-    wxASSERT( workFile );
-    return handle;
+        wxZlibOutputStream      zos( memos, wxZ_BEST_COMPRESSION, wxZLIB_ZLIB );
+
+        zos.Write( aData.data(), aData.size() );
+
+    }   // flush the zip stream using zos destructor
+
+    wxStreamBuffer* sb = memos.GetOutputStreamBuffer();
+
+    aData.assign( (const char*) sb->GetBufferStart(), sb->Tell() );
 }
 
 
 /**
- * Finish the current PDF stream (writes the deferred length, too)
+ * Queue a stream object, compressed in the background. Page and form contents
+ * are plotted in RAM, so the next page can be plotted while the previous ones
+ * are compressed
  */
-void PDF_PLOTTER::closePdfStream()
+void PDF_PLOTTER::queuePdfStream( int aHandle, const std::string& aDictionary,
+                                  std::string& aData )
 {
-    wxASSERT( workFile );
+    // A deque does not move its items, which are referenced by the tasks
+    pendingStreams.emplace_back();
+
+    PDF_STREAM& stream = pendingStreams.back();
+
+    stream.m_Handle = aHandle;
+    stream.m_Dictionary = aDictionary;
+    stream.m_Data.swap( aData );
+    stream.m_Encoded = false;
 
-    long stream_len = ftell( workFile );
+    if( !encoder )
+        encoder.reset( new TASK_GROUP );
 
-    if( stream_len < 0 )
+    encoder->Run( [&stream]()
+            {
+                compressPdfStream( stream.m_Data );
+                stream.m_Encoded = true;
+            } );
+}
+
+
+/**
+ * Write the compressed streams, in the order they were queued (the length
+ * is known at this point, so it's a direct object)
+ */
+void PDF_PLOTTER::writePdfStreams( bool aWait )
+{
+    wxASSERT( outputFile );
+
+    if( aWait && encoder )
+        encoder->Wait();
+
+    while( !pendingStreams.empty() && pendingStreams.front().m_Encoded )
     {
-        wxASSERT( false );
-        return;
+        PDF_STREAM& stream = pendingStreams.front();
+
+        startPdfObject( stream.m_Handle );
+        fprintf( outputFile,
+                 "<< %s/Length %u /Filter /FlateDecode >>\n"
+                 "stream\n",
+                 stream.m_Dictionary.c_str(), (unsigned) stream.m_Data.size() );
+        fwrite( stream.m_Data.data(), 1, stream.m_Data.size(), outputFile );
+        fputs( "endstream\n", outputFile );
+        closePdfObject();
+
+        pendingStreams.pop_front();
     }
+}
 
-    // Rewind the file, read in the page stream and DEFLATE it
-    fseek( workFile, 0, SEEK_SET );
-    unsigned char *inbuf = new unsigned char[stream_len];
 
-    int rc = fread( inbuf, 1, stream_len, workFile );
-    wxASSERT( rc == stream_len );
-    (void) rc;
+/**
+ * Redirect the plot to a new form XObject. The form is drawn in the page
+ * with the graphic state of the page (color, dash), but the pen width is
+ * always set by the form itself, so that the same form can be drawn with
+ * any pen width in the page
+ */
+void PDF_PLOTTER::startForm()
+{
+    wxASSERT( workStream == &pageStream );
 
-    // We are done with the temporary file, junk it
-    fclose( workFile );
-    workFile = 0;
-    ::wxRemoveFile( workFilename );
+    // The path of the page can't go on in the form
+    PenFinish();
 
-    // NULL means memos owns the memory, but provide a hint on optimum size needed.
-    wxMemoryOutputStream    memos( NULL, std::max( 2000l, stream_len ) ) ;
+    savedPenWidth = currentPenWidth;
+    currentPenWidth = -1;
+
+    formStream.clear();
+    workStream = &formStream;
+}
+
+
+void PDF_PLOTTER::endForm( const DPOINT& aOffset, const BOX2D& aBBox )
+{
+    wxASSERT( workStream == &formStream );
+
+    PenFinish();
+
+    // The Do operator restores the graphic state of the page, pen width included
+    workStream = &pageStream;
+    currentPenWidth = savedPenWidth;
+
+    if( formStream.empty() )
+        return;
+
+    std::string dictionary = StrPrintf( "/Type /XObject /Subtype /Form /BBox [%g %g %g %g] "
+                                        "/Resources << /ProcSet [/PDF /ImageC /ImageB] >> ",
+                                        aBBox.GetOrigin().x, aBBox.GetOrigin().y,
+                                        aBBox.GetEnd().x, aBBox.GetEnd().y );
 
+    // Identical forms are output only once
+    std::string key = dictionary + formStream;
+    auto        it = formIndex.find( key );
+    int         formNumber;
+
+    if( it != formIndex.end() )
     {
-        /* Somewhat standard parameters to compress in DEFLATE. The PDF spec is
-         * misleading, it says it wants a DEFLATE stream but it really want a ZLIB
-         * stream! (a DEFLATE stream would be generated with -15 instead of 15)
-         * rc = deflateInit2( &zstrm, Z_BEST_COMPRESSION, Z_DEFLATED, 15,
-         *                    8, Z_DEFAULT_STRATEGY );
-         */
+        formNumber = it->second;
+    }
+    else
+    {
+        formNumber = formHandles.size();
+        formHandles.push_back( allocPdfObject() );
+        formIndex.emplace( std::move( key ), formNumber );
+        queuePdfStream( formHandles.back(), dictionary, formStream );
+    }
 
-        wxZlibOutputStream      zos( memos, wxZ_BEST_COMPRESSION, wxZLIB_ZLIB );
+    if( aOffset.x == 0.0 && aOffset.y == 0.0 )
+        StrPrintf( workStream, "/KicadForm%d Do\n", formNumber );
+    else
+        StrPrintf( workStream, "q 1 0 0 1 %g %g cm /KicadForm%d Do Q\n",
+                   aOffset.x, aOffset.y, formNumber );
+}
 
-        zos.Write( inbuf, stream_len );
 
-        delete[] inbuf;
+void PDF_PLOTTER::StartReusableBlock()
+{
+    startForm();
+}
 
-    }   // flush the zip stream using zos destructor
 
-    wxStreamBuffer* sb = memos.GetOutputStreamBuffer();
+void PDF_PLOTTER::EndReusableBlock()
+{
+    // The block is drawn at its place in the page, so the form covers the page
+    endForm( DPOINT( 0, 0 ), BOX2D( VECTOR2D( 0, 0 ),
+                                    VECTOR2D( paperSize.x * iuPerDeviceUnit,
+                                              paperSize.y * iuPerDeviceUnit ) ) );
+}
 
-    unsigned out_count = sb->Tell();
 
-    fwrite( sb->GetBufferStart(), 1, out_count, outputFile );
+/**
+ * Pads are plotted in a form around the origin of the device coordinates,
+ * which is then moved to the pad position. So all the pads with the same
+ * shape, size and orientation share the same form
+ */
+void PDF_PLOTTER::flashPadForm( const wxPoint& aPadPos, int aRadius,
+                                const std::function<void()>& aFlash )
+{
+    DPOINT  padPos = userToDeviceCoordinates( aPadPos );
+    wxPoint offset = plotOffset;
+    wxSize  size = paperSize;
+
+    // With a null paper size, aPadPos is the origin of the device coordinates
+    // (even with the mirror options)
+    plotOffset = aPadPos;
+    paperSize = wxSize( 0, 0 );
 
-    fputs( "endstream\n", outputFile );
-    closePdfObject();
+    startForm();
+    aFlash();
 
-    // Writing the deferred length as an indirect object
-    startPdfObject( streamLengthHandle );
-    fprintf( outputFile, "%u\n", out_count );
-    closePdfObject();
+    plotOffset = offset;
+    paperSize = size;
+
+    // Leave room for the pen of the sketch mode
+    double radius = userToDeviceSize( aRadius + defaultPenWidth );
+
+    endForm( padPos, BOX2D( VECTOR2D( -radius, -radius ), VECTOR2D( 2 * radius, 2 * radius ) ) );
+}
+
+
+void PDF_PLOTTER::FlashPadCircle( const wxPoint& aPadPos, int aDiameter,
+                                  EDA_DRAW_MODE_T aTraceMode, void* aData )
+{
+    flashPadForm( aPadPos, aDiameter / 2,
+            [&]()
+            {
+                PSLIKE_PLOTTER::FlashPadCircle( aPadPos, aDiameter, aTraceMode, aData );
+            } );
+}
+
+
+void PDF_PLOTTER::FlashPadOval( const wxPoint& aPadPos, const wxSize& aSize, double aPadOrient,
+                                EDA_DRAW_MODE_T aTraceMode, void* aData )
+{
+    flashPadForm( aPadPos, ( aSize.x + aSize.y ) / 2,
+            [&]()
+            {
+                PSLIKE_PLOTTER::FlashPadOval( aPadPos, aSize, aPadOrient, aTraceMode, aData );
+            } );
+}
+
+
+void PDF_PLOTTER::FlashPadRect( const wxPoint& aPadPos, const wxSize& aSize,
+                                double aPadOrient, EDA_DRAW_MODE_T aTraceMode, void* aData )
+{
+    flashPadForm( aPadPos, ( aSize.x + aSize.y ) / 2,
+            [&]()
+            {
+                PSLIKE_PLOTTER::FlashPadRect( aPadPos, aSize, aPadOrient, aTraceMode, aData );
+            } );
+}
+
+
+void PDF_PLOTTER::FlashPadRoundRect( const wxPoint& aPadPos, const wxSize& aSize,
+                                     int aCornerRadius, double aOrient,
+                                     EDA_DRAW_MODE_T aTraceMode, void* aData )
+{
+    flashPadForm( aPadPos, ( aSize.x + aSize.y ) / 2,
+            [&]()
+            {
+                PSLIKE_PLOTTER::FlashPadRoundRect( aPadPos, aSize, aCornerRadius, aOrient,
+                                                   aTraceMode, aData );
+            } );
+}
+
+
+void PDF_PLOTTER::FlashPadTrapez( const wxPoint& aPadPos, const wxPoint *aCorners,
+                                  double aPadOrient, EDA_DRAW_MODE_T aTraceMode, void* aData )
+{
+    int radius = 0;
+
+    for( int ii = 0; ii < 4; ii++ )
+        radius = std::max( radius, std::abs( aCorners[ii].x ) + std::abs( aCorners[ii].y ) );
+
+    flashPadForm( aPadPos, radius,
+            [&]()
+            {
+                PSLIKE_PLOTTER::FlashPadTrapez( aPadPos, aCorners, aPadOrient, aTraceMode,
+                                                aData );
+            } );
 }
 
+
 /**
  * Starts a new page in the PDF document
  */
 void PDF_PLOTTER::StartPage()
 {
     wxASSERT( outputFile );
-    wxASSERT( !workFile );
+    wxASSERT( !workStream );
 
     // Compute the paper size in IUs
     paperSize = pageInfo.GetSizeMils();
     paperSize.x *= 10.0 / iuPerDeviceUnit;
     paperSize.y *= 10.0 / iuPerDeviceUnit;
 
-    // Open the content stream; the page object will go later
-    pageStreamHandle = startPdfStream();
+    // The content stream is plotted in RAM; the page object will go later
+    pageStreamHandle = allocPdfObject();
+    pageStream.clear();
 
-    /* Now, until ClosePage *everything* must be wrote in workFile, to be
-       compressed later in closePdfStream */
+    /* Now, until ClosePage *everything* must be wrote in workStream, to be
+       compressed later */
+    workStream = &pageStream;
 
     // Default graphic settings (coordinate system, default color and line style)
-    fprintf( workFile,
-             "%g 0 0 %g 0 0 cm 1 J 1 j 0 0 0 rg 0 0 0 RG %g w\n",
-             0.0072 * plotScaleAdjX, 0.0072 * plotScaleAdjY,
-             userToDeviceSize( defaultPenWidth ) );
+    StrPrintf( workStream,
+               "%g 0 0 %g 0 0 cm 1 J 1 j 0 0 0 rg 0 0 0 RG %g w\n",
+               0.0072 * plotScaleAdjX, 0.0072 * plotScaleAdjY,
+               userToDeviceSize( defaultPenWidth ) );
 }
 
 /**
- * Close the current page in the PDF document (and emit its compressed stream)
+ * Close the current page in the PDF document (and queue its stream for compression)
  */
 void PDF_PLOTTER::ClosePage()
 {
-    wxASSERT( workFile );
+    wxASSERT( workStream == &pageStream );
 
-    // Close the page stream (and compress it)
-    closePdfStream();
+    workStream = nullptr;
+
+    // Compress the page stream while the next pages are plotted
+    queuePdfStream( pageStreamHandle, std::string(), pageStream );
 
     // Emit the page object and put it in the page list for later
     pageHandles.push_back( startPdfObject() );
@@ -593,17 +783,22 @@ void PDF_PLOTTER::ClosePage()
              "/Parent %d 0 R\n"
              "/Resources <<\n"
              "    /ProcSet [/PDF /Text /ImageC /ImageB]\n"
-             "    /Font %d 0 R >>\n"
+             "    /Font %d 0 R\n"
+             "    /XObject %d 0 R >>\n"
              "/MediaBox [0 0 %d %d]\n"
              "/Contents %d 0 R\n"
              ">>\n",
              pageTreeHandle,
              fontResDictHandle,
+             xObjectResDictHandle,
              int( ceil( psPaperSize.x * BIGPTsPERMIL ) ),
              int( ceil( psPaperSize.y * BIGPTsPERMIL ) ),
              pageStreamHandle );
     closePdfObject();
 
+    // Output the streams already compressed
+    writePdfStreams( false );
+
     // Mark the page stream as idle
     pageStreamHandle = 0;
 }
@@ -634,6 +829,11 @@ bool PDF_PLOTTER::StartPlot()
        (it *could* be inherited via the Pages tree */
     fontResDictHandle = allocPdfObject();
 
+    // And the dictionary of the forms, shared by all the pages
+    xObjectResDictHandle = allocPdfObject();
+    formIndex.clear();
+    formHandles.clear();
+
     /* Now, the PDF is read from the end, (more or less)... so we start
        with the page stream for page 1. Other more important stuff is written
        at the end */
@@ -649,6 +849,10 @@ bool PDF_PLOTTER::EndPlot()
     // Close the current page (often the only one)
     ClosePage();
 
+    // Output the streams still being compressed
+    writePdfStreams( true );
+    formIndex.clear();
+
     /* We need to declare the resources we're using (fonts in particular)
        The useful standard one is the Helvetica family. Adding external fonts
        is *very* involved! */
@@ -693,6 +897,16 @@ bool PDF_PLOTTER::EndPlot()
     fputs( ">>\n", outputFile );
     closePdfObject();
 
+    // Named form dictionary (was allocated, now we emit it)
+    startPdfObject( xObjectResDictHandle );
+    fputs( "<<\n", outputFile );
+
+    for( unsigned i = 0; i < formHandles.size(); i++ )
+        fprintf( outputFile, "    /KicadForm%u %d 0 R\n", i, formHandles[i] );
+
+    fputs( ">>\n", outputFile );
+    closePdfObject();
+
     /* The page tree: it's a B-tree but luckily we only have few pages!
        So we use just an array... The handle was allocated at the beginning,
        now we instantiate the corresponding object */
@@ -829,14 +1043,14 @@ void PDF_PLOTTER::Text( const wxPoint&              aPos,
        for the trig part of the matrix to avoid %g going in exponential
        format (which is not supported)
        render_mode 0 shows the text, render_mode 3 is invisible */
-    fprintf( workFile, "q %f %f %f %f %g %g cm BT %s %g Tf %d Tr %g Tz ",
+    StrPrintf( workStream, "q %f %f %f %f %g %g cm BT %s %g Tf %d Tr %g Tz ",
             ctm_a, ctm_b, ctm_c, ctm_d, ctm_e, ctm_f,
             fontname, heightFactor, render_mode,
             wideningFactor * 100 );
 
     // The text must be escaped correctly
-    fputsPostscriptString( workFile, aText );
-    fputs( " Tj ET\n", workFile );
+    workStream->append( encodePostscriptString( aText ) );
+    workStream->append( " Tj ET\n" );
 
     // We are in text coordinates, plot the overbars, if we're not doing phantom text
     if( use_native_font )
@@ -852,13 +1066,13 @@ void PDF_PLOTTER::Text( const wxPoint&              aPos,
                is the right function to use here... */
             DPOINT dev_from = userToDeviceSize( wxSize( pos_pairs[i], overbar_y ) );
             DPOINT dev_to = userToDeviceSize( wxSize( pos_pairs[i + 1], overbar_y ) );
-            fprintf( workFile, "%g %g m %g %g l ",
+            StrPrintf( workStream, "%g %g m %g %g l ",
                     dev_from.x, dev_from.y, dev_to.x, dev_to.y );
         }
     }
 
     // Stroke and restore the CTM
-    fputs( "S Q\n", workFile );
+    workStream->append( "S Q\n" );
 
     // Plot the stroked text (if requested)
     if( !use_native_font )
@@ -98,10 +98,16 @@ void PlotWorkSheet( PLOTTER* plotter, const TITLE_BLOCK& aTitleBlock,
     drawList.BuildWorkSheetGraphicList( aPageInfo,
                             aTitleBlock, plotColor, plotColor );
 
-    // Draw item list
+    // The graphic items are the same on all the pages: plot them as a reusable block.
+    // The texts (sheet number, file name...) are plotted after it
+    plotter->StartReusableBlock();
+
     for( WS_DRAW_ITEM_BASE* item = drawList.GetFirst(); item;
          item = drawList.GetNext() )
     {
+        if( item->GetType() == WS_DRAW_ITEM_BASE::wsg_text )
+            continue;
+
         plotter->SetCurrentLineWidth( PLOTTER::USE_DEFAULT_LINE_WIDTH );
 
         switch( item->GetType() )
@@ -125,19 +131,6 @@ void PlotWorkSheet( PLOTTER* plotter, const TITLE_BLOCK& aTitleBlock,
             }
             break;
 
-        case WS_DRAW_ITEM_BASE::wsg_text:
-            {
-                WS_DRAW_ITEM_TEXT* text = (WS_DRAW_ITEM_TEXT*) item;
-                plotter->Text( text->GetTextPos(), text->GetColor(),
-                               text->GetShownText(), text->GetTextAngle(),
-                               text->GetTextSize(),
-                               text->GetHorizJustify(), text->GetVertJustify(),
-                               text->GetPenWidth(),
-                               text->IsItalic(), text->IsBold(),
-                               text->IsMultilineAllowed() );
-            }
-            break;
-
         case WS_DRAW_ITEM_BASE::wsg_poly:
             {
                 WS_DRAW_ITEM_POLYGON* poly = (WS_DRAW_ITEM_POLYGON*) item;
@@ -160,6 +153,27 @@ void PlotWorkSheet( PLOTTER* plotter, const TITLE_BLOCK& aTitleBlock,
                                plotColor, PLOTTER::USE_DEFAULT_LINE_WIDTH );
             }
             break;
+
+        default:
+            break;
         }
     }
+
+    plotter->EndReusableBlock();
+
+    for( WS_DRAW_ITEM_BASE* item = drawList.GetFirst(); item;
+         item = drawList.GetNext() )
+    {
+        if( item->GetType() != WS_DRAW_ITEM_BASE::wsg_text )
+            continue;
+
+        WS_DRAW_ITEM_TEXT* text = (WS_DRAW_ITEM_TEXT*) item;
+        plotter->Text( text->GetTextPos(), text->GetColor(),
+                       text->GetShownText(), text->GetTextAngle(),
+                       text->GetTextSize(),
+                       text->GetHorizJustify(), text->GetVertJustify(),
+                       text->GetPenWidth(),
+                       text->IsItalic(), text->IsBold(),
+                       text->IsMultilineAllowed() );
+    }
 }
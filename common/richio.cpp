@@ -23,9 +23,12 @@
  */
 
 
+#include <algorithm>
 #include <cstdarg>
+#include <cstring>
 #include <config.h> // HAVE_FGETC_NOLOCK
 
+#include <mapped_file.h>
 #include <richio.h>
 
 
@@ -278,6 +281,125 @@ char* STRING_LINE_READER::ReadLine()
 }
 
 
+MEMORY_LINE_READER::MEMORY_LINE_READER( const char* aBuffer, size_t aSize,
+                                        const wxString& aSource, unsigned aStartingLineNumber ) :
+    LINE_READER( LINE_READER_LINE_DEFAULT_MAX ),
+    m_buffer( aBuffer ), m_size( aSize ), m_ndx( 0 ), m_startingLineNum( aStartingLineNumber ),
+    m_nextSkipped( 0 )
+{
+    m_source  = aSource;
+    m_lineNum = aStartingLineNumber;
+    m_ownLine = m_line;
+}
+
+
+MEMORY_LINE_READER::~MEMORY_LINE_READER()
+{
+    // ~LINE_READER() deletes m_line, which may be a view
+    m_line = m_ownLine;
+}
+
+
+void MEMORY_LINE_READER::Skip( size_t aStart, size_t aEnd )
+{
+    wxASSERT( aStart >= m_ndx && aStart <= aEnd && aEnd <= m_size );
+    wxASSERT( m_skipped.empty() || aStart >= m_skipped.back().second );
+
+    m_skipped.emplace_back( aStart, aEnd );
+}
+
+
+void MEMORY_LINE_READER::Rewind()
+{
+    m_ndx         = 0;
+    m_nextSkipped = 0;
+    m_lineNum     = m_startingLineNum;
+    m_line        = m_ownLine;
+    m_length      = 0;
+    m_line[0]     = 0;
+}
+
+
+char* MEMORY_LINE_READER::ReadLine()
+{
+    m_line   = m_ownLine;
+    m_length = 0;
+
+    while( m_ndx < m_size )
+    {
+        size_t end = m_size;
+
+        if( m_nextSkipped < m_skipped.size() )
+        {
+            const std::pair<size_t, size_t>& skipped = m_skipped[m_nextSkipped];
+
+            if( m_ndx == skipped.first )
+            {
+                m_lineNum += std::count( m_buffer + skipped.first, m_buffer + skipped.second, '\n' );
+                m_ndx = skipped.second;
+                m_nextSkipped++;
+                continue;
+            }
+
+            end = skipped.first;
+        }
+
+        const char* nl = (const char*) memchr( m_buffer + m_ndx, '\n', end - m_ndx );
+        size_t      count = nl ? nl - ( m_buffer + m_ndx ) + 1 : end - m_ndx;
+
+        if( m_length + count >= m_maxLineLength )
+            THROW_IO_ERROR( _("Line length exceeded") );
+
+        // A whole line: hand out a view into the buffer
+        if( nl && m_length == 0 )
+        {
+            m_line   = const_cast<char*>( m_buffer + m_ndx );
+            m_length = count;
+            m_ndx   += count;
+
+            ++m_lineNum;
+            return m_line;
+        }
+
+        if( m_length + count + 1 > m_capacity )   // +1 for terminating nul
+        {
+            expandCapacity( m_length + count + 1 );
+            m_ownLine = m_line;
+        }
+
+        memcpy( m_line + m_length, m_buffer + m_ndx, count );
+        m_length += count;
+        m_ndx += count;
+
+        if( nl )
+            break;
+    }
+
+    ++m_lineNum;      // this gets incremented even if no bytes were read
+    m_line[m_length] = 0;
+
+    return m_length ? m_line : NULL;
+}
+
+
+MMAP_LINE_READER::MMAP_LINE_READER( const wxString& aFileName ) :
+    MMAP_LINE_READER( new MAPPED_FILE( aFileName ) )
+{
+}
+
+
+MMAP_LINE_READER::MMAP_LINE_READER( MAPPED_FILE* aFile ) :
+    MEMORY_LINE_READER( aFile->Data(), aFile->Size(), aFile->GetFileName() ),
+    m_file( aFile )
+{
+}
+
+
+MMAP_LINE_READER::~MMAP_LINE_READER()
+{
+}
+
+
 INPUTSTREAM_LINE_READER::INPUTSTREAM_LINE_READER( wxInputStream* aStream, const wxString& aSource ) :
     LINE_READER( LINE_READER_LINE_DEFAULT_MAX ),
     m_stream( aStream )
@@ -0,0 +1,374 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <thread_pool.h>
+
+#include <algorithm>
+#include <chrono>
+
+#include <widgets/progress_reporter.h>
+
+
+// The pool the current thread is a worker of (if any), and its index in this pool
+static thread_local THREAD_POOL* s_currentPool = nullptr;
+static thread_local size_t       s_workerIndex = 0;
+
+// The group of the task the current thread is running (if any)
+static thread_local TASK_GROUP*  s_currentGroup = nullptr;
+
+
+THREAD_POOL& THREAD_POOL::GetInstance()
+{
+    static THREAD_POOL pool( std::max<size_t>( std::thread::hardware_concurrency(), 1 ) );
+
+    return pool;
+}
+
+
+THREAD_POOL::THREAD_POOL( size_t aThreadCount ) :
+        m_queuedTasks( 0 ),
+        m_quit( false )
+{
+    for( size_t ii = 0; ii <= aThreadCount; ++ii )
+        m_queues.emplace_back( new TASK_QUEUE );
+
+    for( size_t ii = 0; ii < aThreadCount; ++ii )
+        m_threads.emplace_back( &THREAD_POOL::workerLoop, this, ii );
+}
+
+
+THREAD_POOL::~THREAD_POOL()
+{
+    {
+        std::lock_guard<std::mutex> lock( m_sleepMutex );
+        m_quit = true;
+    }
+
+    m_wakeUp.notify_all();
+
+    for( std::thread& thread : m_threads )
+        thread.join();
+}
+
+
+void THREAD_POOL::submit( TASK&& aTask )
+{
+    size_t queue = ( s_currentPool == this ) ? s_workerIndex : m_queues.size() - 1;
+
+    {
+        std::lock_guard<std::mutex> lock( m_queues[queue]->m_mutex );
+        m_queues[queue]->m_tasks.push_back( std::move( aTask ) );
+    }
+
+    {
+        // Taking the lock ensures a worker going to sleep sees the new task
+        std::lock_guard<std::mutex> lock( m_sleepMutex );
+        m_queuedTasks++;
+    }
+
+    m_wakeUp.notify_one();
+}
+
+
+bool THREAD_POOL::popTask( TASK& aTask, const TASK_GROUP* aGroup )
+{
+    if( m_queuedTasks == 0 )
+        return false;
+
+    size_t shared = m_queues.size() - 1;
+    size_t first = 0;
+
+    // A worker runs its own tasks first, newest first: they are the ones whose data is hot
+    if( s_currentPool == this )
+    {
+        TASK_QUEUE& queue = *m_queues[s_workerIndex];
+        std::lock_guard<std::mutex> lock( queue.m_mutex );
+
+        if( takeTask( queue.m_tasks, true, aGroup, aTask ) )
+        {
+            m_queuedTasks--;
+            return true;
+        }
+
+        first = s_workerIndex + 1;
+    }
+
+    // Then the shared queue, then steal the oldest task of another worker
+    for( size_t ii = 0; ii < m_queues.size(); ++ii )
+    {
+        size_t      index = ( ii == 0 ) ? shared : ( first + ii - 1 ) % shared;
+        TASK_QUEUE& queue = *m_queues[index];
+
+        std::lock_guard<std::mutex> lock( queue.m_mutex );
+
+        if( takeTask( queue.m_tasks, false, aGroup, aTask ) )
+        {
+            m_queuedTasks--;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+bool THREAD_POOL::takeTask( std::deque<TASK>& aTasks, bool aNewest, const TASK_GROUP* aGroup,
+                            TASK& aTask )
+{
+    auto matches = [aGroup]( const TASK& aCandidate )
+    {
+        return !aGroup || aGroup->contains( aCandidate.m_group );
+    };
+
+    if( aNewest )
+    {
+        auto it = std::find_if( aTasks.rbegin(), aTasks.rend(), matches );
+
+        if( it == aTasks.rend() )
+            return false;
+
+        aTask = std::move( *it );
+        aTasks.erase( std::next( it ).base() );
+    }
+    else
+    {
+        auto it = std::find_if( aTasks.begin(), aTasks.end(), matches );
+
+        if( it == aTasks.end() )
+            return false;
+
+        aTask = std::move( *it );
+        aTasks.erase( it );
+    }
+
+    return true;
+}
+
+
+void THREAD_POOL::runTask( TASK& aTask )
+{
+    TASK_GROUP*        group = aTask.m_group;
+    std::exception_ptr exception;
+
+    {
+        // Destroy the task (and what it captured) before the group is told it is done
+        std::function<void()> func = std::move( aTask.m_func );
+
+        if( !group->IsCancelled() )
+        {
+            // Groups created by the task are nested in its group
+            TASK_GROUP* previousGroup = s_currentGroup;
+
+            s_currentGroup = group;
+
+            try
+            {
+                func();
+            }
+            catch( ... )
+            {
+                exception = std::current_exception();
+            }
+
+            s_currentGroup = previousGroup;
+        }
+    }
+
+    group->taskDone( exception );
+}
+
+
+bool THREAD_POOL::runPendingTask( const TASK_GROUP* aGroup )
+{
+    TASK task;
+
+    if( !popTask( task, aGroup ) )
+        return false;
+
+    runTask( task );
+    return true;
+}
+
+
+void THREAD_POOL::workerLoop( size_t aIndex )
+{
+    s_currentPool = this;
+    s_workerIndex = aIndex;
+
+    while( true )
+    {
+        if( runPendingTask() )
+            continue;
+
+        std::unique_lock<std::mutex> lock( m_sleepMutex );
+
+        m_wakeUp.wait( lock, [this]() { return m_quit || m_queuedTasks > 0; } );
+
+        if( m_quit )
+            return;
+    }
+}
+
+
+TASK_GROUP::TASK_GROUP( THREAD_POOL& aPool ) :
+        m_pool( aPool ),
+        m_parent( s_currentGroup ),
+        m_pendingTasks( 0 ),
+        m_cancelled( false )
+{
+}
+
+
+TASK_GROUP::~TASK_GROUP()
+{
+    // Tasks still queued (e.g. when unwinding from an exception) refer to data going away
+    if( m_pendingTasks > 0 )
+        Cancel();
+
+    try
+    {
+        wait( nullptr );
+    }
+    catch( ... )
+    {
+    }
+}
+
+
+void TASK_GROUP::Run( std::function<void()> aTask )
+{
+    m_pendingTasks++;
+    m_pool.submit( THREAD_POOL::TASK{ std::move( aTask ), this } );
+}
+
+
+void TASK_GROUP::RunForEach( size_t aCount, std::function<void( size_t aIndex )> aBody,
+                             size_t aMinItemsPerTask )
+{
+    if( aCount == 0 )
+        return;
+
+    aMinItemsPerTask = std::max<size_t>( aMinItemsPerTask, 1 );
+
+    size_t taskCount = std::min( m_pool.GetThreadCount(),
+                                 ( aCount + aMinItemsPerTask - 1 ) / aMinItemsPerTask );
+
+    auto nextItem = std::make_shared<std::atomic<size_t>>( 0 );
+    auto body = std::make_shared<std::function<void( size_t )>>( std::move( aBody ) );
+
+    for( size_t ii = 0; ii < std::max<size_t>( taskCount, 1 ); ++ii )
+    {
+        Run( [this, nextItem, body, aCount]()
+             {
+                 for( size_t i = ( *nextItem )++; i < aCount && !IsCancelled(); i = ( *nextItem )++ )
+                     ( *body )( i );
+             } );
+    }
+}
+
+
+bool TASK_GROUP::Wait( PROGRESS_REPORTER* aReporter )
+{
+    if( !aReporter )
+        return wait( nullptr );
+
+    std::function<bool()> refresh = [aReporter]() { return aReporter->KeepRefreshing(); };
+
+    return wait( &refresh );
+}
+
+
+bool TASK_GROUP::WaitAndRefresh( const std::function<bool()>& aRefresh )
+{
+    return wait( &aRefresh );
+}
+
+
+bool TASK_GROUP::wait( const std::function<bool()>* aRefresh )
+{
+    auto done = [this]() { return m_pendingTasks == 0; };
+
+    if( aRefresh )
+    {
+        std::unique_lock<std::mutex> lock( m_mutex );
+
+        while( !m_done.wait_for( lock, std::chrono::milliseconds( 100 ), done ) )
+        {
+            lock.unlock();
+
+            if( !IsCancelled() && !( *aRefresh )() )
+                Cancel();
+
+            lock.lock();
+        }
+    }
+    else
+    {
+        // Help with the queued tasks (ours, or the ones of nested groups our tasks wait for)
+        // only as long as this group has tasks left.  The tasks of other groups are left to
+        // the workers: they may take far longer than ours (e.g. loading a whole library)
+        while( !done() && m_pool.runPendingTask( this ) )
+        {
+        }
+
+        // The remaining tasks are running on other threads: sleep until the last one is done.
+        // Also taken when the group is already done: a task may still be in taskDone()
+        std::unique_lock<std::mutex> lock( m_mutex );
+
+        m_done.wait( lock, done );
+    }
+
+    if( m_exception )
+    {
+        std::exception_ptr exception = m_exception;
+
+        m_exception = nullptr;
+        std::rethrow_exception( exception );
+    }
+
+    return !m_cancelled;
+}
+
+
+bool TASK_GROUP::contains( const TASK_GROUP* aGroup ) const
+{
+    for( const TASK_GROUP* group = aGroup; group; group = group->m_parent )
+    {
+        if( group == this )
+            return true;
+    }
+
+    return false;
+}
+
+
+void TASK_GROUP::taskDone( std::exception_ptr aException )
+{
+    std::lock_guard<std::mutex> lock( m_mutex );
+
+    if( aException && !m_exception )
+        m_exception = aException;
+
+    if( --m_pendingTasks == 0 )
+        m_done.notify_all();
+}
@@ -36,10 +36,11 @@
 #include <gal/definitions.h>
 #include <gal/graphics_abstraction_layer.h>
 #include <painter.h>
-
-#ifdef __WXDEBUG__
 #include <profile.h>
-#endif /* __WXDEBUG__  */
+#include <thread_pool.h>
+
+#include <atomic>
+#include <functional>
 
 namespace KIGFX {
 
@@ -90,6 +91,7 @@ private:
     int     m_flags;            ///< Visibility flags
     int     m_requiredUpdate;   ///< Flag required for updating
     int     m_drawPriority;     ///< Order to draw this item in a layer, lowest first
+    BOX2I   m_bbox;             ///< Bounding box of the item in the R-trees of its layers
 
     ///> Helper for storing cached items group ids
     typedef std::pair<int, int> GroupPair;
@@ -293,7 +295,8 @@ VIEW::VIEW( bool aIsDynamic ) :
     m_dynamic( aIsDynamic ),
     m_useDrawPriority( false ),
     m_nextDrawPriority( 0 ),
-    m_reverseDrawOrder( false )
+    m_reverseDrawOrder( false ),
+    m_lastRedrawTime( 0.0 )
 {
     // Set m_boundary to define the max area size. The default area size
     // is defined here as the max value of a int.
@@ -355,6 +358,7 @@ void VIEW::Add( VIEW_ITEM* aItem, int aDrawPriority )
 
     aItem->m_viewPrivData->m_view = this;
     aItem->m_viewPrivData->m_drawPriority = aDrawPriority;
+    aItem->m_viewPrivData->m_bbox = aItem->ViewBBox();
 
     aItem->ViewGetLayers( layers, layers_count );
     aItem->viewPrivData()->saveLayers( layers, layers_count );
@@ -364,7 +368,7 @@ void VIEW::Add( VIEW_ITEM* aItem, int aDrawPriority )
     for( int i = 0; i < layers_count; ++i )
     {
         VIEW_LAYER& l = m_layers[layers[i]];
-        l.items->Insert( aItem );
+        l.items->Insert( aItem, aItem->m_viewPrivData->m_bbox );
         MarkTargetDirty( l.target );
     }
 
@@ -398,7 +402,7 @@ void VIEW::Remove( VIEW_ITEM* aItem )
     for( int i = 0; i < layers_count; ++i )
     {
         VIEW_LAYER& l = m_layers[layers[i]];
-        l.items->Remove( aItem );
+        l.items->Remove( aItem, viewData->m_bbox );
         MarkTargetDirty( l.target );
 
         // Clear the GAL cache
@@ -1143,9 +1147,7 @@ void VIEW::ClearTargets()
 
 void VIEW::Redraw()
 {
-#ifdef __WXDEBUG__
     PROF_COUNTER totalRealTime;
-#endif /* __WXDEBUG__ */
 
     VECTOR2D screenSize = m_gal->GetScreenPixelSize();
     BOX2D    rect( ToWorld( VECTOR2D( 0, 0 ) ),
@@ -1166,13 +1168,33 @@ void VIEW::Redraw()
     markTargetClean( TARGET_NONCACHED );
     markTargetClean( TARGET_OVERLAY );
 
-#ifdef __WXDEBUG__
     totalRealTime.Stop();
-    wxLogTrace( "GAL_PROFILE", "VIEW::Redraw(): %.1f ms", totalRealTime.msecs() );
+    m_lastRedrawTime = totalRealTime.msecs();
+
+#ifdef __WXDEBUG__
+    wxLogTrace( "GAL_PROFILE", "VIEW::Redraw(): %.1f ms", m_lastRedrawTime );
 #endif /* __WXDEBUG__ */
 }
 
 
+double VIEW::GetLODForSize( double aSize, double aPixels ) const
+{
+    // The world scale of the GAL is proportional to the VIEW scale
+    double pixels = aSize * m_gal->GetWorldScale() / m_scale;
+
+    if( pixels <= 0.0 )
+        return std::numeric_limits<double>::max();
+
+    return aPixels / pixels;
+}
+
+
+double VIEW::GetTextLOD( double aTextSize ) const
+{
+    return GetLODForSize( aTextSize, m_gal->GetMinTextSize() );
+}
+
+
 const VECTOR2I& VIEW::GetScreenPixelSize() const
 {
     return m_gal->GetScreenPixelSize();
@@ -1212,7 +1234,8 @@ void VIEW::clearGroupCache()
 }
 
 
-void VIEW::invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags )
+void VIEW::invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags,
+                           std::vector<VIEW_ITEM*>* aRedrawnItems )
 {
     if( aUpdateFlags & INITIAL_ADD )
     {
@@ -1236,12 +1259,18 @@ void VIEW::invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags )
     int layers[VIEW_MAX_LAYERS], layers_count;
     aItem->ViewGetLayers( layers, layers_count );
 
+    // The caller redraws all the cached layers of the item later
+    bool redrawLater = aRedrawnItems && ( aUpdateFlags & ( GEOMETRY | LAYERS | REPAINT ) );
+
+    if( redrawLater )
+        aRedrawnItems->push_back( aItem );
+
     // Iterate through layers used by the item and recache it immediately
     for( int i = 0; i < layers_count; ++i )
     {
         int layerId = layers[i];
 
-        if( IsCached( layerId ) )
+        if( IsCached( layerId ) && !redrawLater )
         {
             if( aUpdateFlags & ( GEOMETRY | LAYERS | REPAINT ) )
                 updateItemGeometry( aItem, layerId );
@@ -1321,19 +1350,155 @@ void VIEW::updateItemGeometry( VIEW_ITEM* aItem, int aLayer )
 }
 
 
+void VIEW::updateItemsGeometry( const std::vector<VIEW_ITEM*>& aItems )
+{
+    // A drawn group of an item: the recorder it was drawn with (-1 if the painter could not
+    // draw it) and its number in the recorder
+    struct RECORDED_GROUP
+    {
+        int layer;
+        int recorder;
+        int group;
+    };
+
+    size_t threadCount = THREAD_POOL::GetInstance().GetThreadCount();
+    std::vector<GAL*> recorders;
+    std::vector<std::unique_ptr<PAINTER>> painters;
+
+    if( aItems.size() >= MIN_PARALLEL_REDRAW && threadCount > 1 )
+    {
+        for( size_t ii = 0; ii < threadCount; ++ii )
+        {
+            GAL* recorder = m_gal->GetGroupRecorder( ii );
+            PAINTER* painter = recorder ? m_painter->Clone( recorder ) : nullptr;
+
+            if( !painter )
+                break;
+
+            recorders.push_back( recorder );
+            painters.emplace_back( painter );
+        }
+    }
+
+    auto drawSequentially = [&]( VIEW_ITEM* aItem )
+    {
+        int layers[VIEW_MAX_LAYERS], layers_count;
+        aItem->ViewGetLayers( layers, layers_count );
+
+        for( int i = 0; i < layers_count; ++i )
+        {
+            if( IsCached( layers[i] ) )
+                updateItemGeometry( aItem, layers[i] );
+        }
+    };
+
+    if( painters.size() < threadCount )
+    {
+        for( VIEW_ITEM* item : aItems )
+            drawSequentially( item );
+
+        return;
+    }
+
+    // The painters draw the items into the recorders in parallel.  All the layers of an item
+    // are drawn by the same task, as drawing an item may update its caches.
+    std::vector<std::vector<RECORDED_GROUP>> itemGroups( aItems.size() );
+    std::atomic<size_t> nextItem( 0 );
+    TASK_GROUP tasks;
+
+    auto drawTask = [&]( int aRecorder )
+    {
+        GAL*     gal = recorders[aRecorder];
+        PAINTER* painter = painters[aRecorder].get();
+
+        for( size_t ii = nextItem++; ii < aItems.size(); ii = nextItem++ )
+        {
+            VIEW_ITEM* item = aItems[ii];
+
+            if( !item->viewPrivData() )
+                continue;
+
+            int layers[VIEW_MAX_LAYERS], layers_count;
+            item->ViewGetLayers( layers, layers_count );
+
+            for( int i = 0; i < layers_count; ++i )
+            {
+                int layerId = layers[i];
+
+                if( !IsCached( layerId ) )
+                    continue;
+
+                gal->SetLayerDepth( m_layers.at( layerId ).renderingOrder );
+
+                int group = gal->BeginGroup();
+                bool drawn = painter->Draw( static_cast<EDA_ITEM*>( item ), layerId );
+                gal->EndGroup();
+
+                // Alternative drawing methods use the VIEW, they are run by the caller
+                itemGroups[ii].push_back( { layerId, drawn ? aRecorder : -1, group } );
+            }
+        }
+    };
+
+    for( size_t ii = 0; ii < recorders.size(); ++ii )
+        tasks.Run( std::bind( drawTask, (int) ii ) );
+
+    tasks.Wait();
+
+    // Only the copy of the vertices to the GAL groups is left to the calling thread
+    for( size_t ii = 0; ii < aItems.size(); ++ii )
+    {
+        auto viewData = aItems[ii]->viewPrivData();
+
+        for( const RECORDED_GROUP& recorded : itemGroups[ii] )
+        {
+            if( recorded.recorder < 0 )
+            {
+                updateItemGeometry( aItems[ii], recorded.layer );
+                continue;
+            }
+
+            VIEW_LAYER& l = m_layers.at( recorded.layer );
+
+            m_gal->SetTarget( l.target );
+
+            int group = viewData->getGroup( recorded.layer );
+
+            if( group >= 0 )
+                m_gal->DeleteGroup( group );
+
+            group = m_gal->CopyGroup( recorders[recorded.recorder], recorded.group );
+            viewData->setGroup( recorded.layer, group );
+        }
+    }
+
+    for( GAL* recorder : recorders )
+        recorder->ClearCache();
+}
+
+
 void VIEW::updateBbox( VIEW_ITEM* aItem )
 {
+    auto viewData = aItem->viewPrivData();
     int layers[VIEW_MAX_LAYERS], layers_count;
 
+    if( !viewData )
+        return;
+
+    // The item is found in the R-trees with its previous bounding box
+    const BOX2I bbox = aItem->ViewBBox();
+
     aItem->ViewGetLayers( layers, layers_count );
 
     for( int i = 0; i < layers_count; ++i )
     {
         VIEW_LAYER& l = m_layers[layers[i]];
-        l.items->Remove( aItem );
-        l.items->Insert( aItem );
+        l.items->Remove( aItem, viewData->m_bbox );
+        l.items->Insert( aItem, bbox );
         MarkTargetDirty( l.target );
     }
+
+    viewData->m_bbox = bbox;
 }
 
 
@@ -1351,7 +1516,7 @@ void VIEW::updateLayers( VIEW_ITEM* aItem )
     for( int i = 0; i < layers_count; ++i )
     {
         VIEW_LAYER& l = m_layers[layers[i]];
-        l.items->Remove( aItem );
+        l.items->Remove( aItem, viewData->m_bbox );
         MarkTargetDirty( l.target );
 
         if( IsCached( l.id ) )
@@ -1370,11 +1535,12 @@ void VIEW::updateLayers( VIEW_ITEM* aItem )
     // Add the item to new layer set
     aItem->ViewGetLayers( layers, layers_count );
     viewData->saveLayers( layers, layers_count );
+    viewData->m_bbox = aItem->ViewBBox();
 
     for( int i = 0; i < layers_count; i++ )
     {
         VIEW_LAYER& l = m_layers[layers[i]];
-        l.items->Insert( aItem );
+        l.items->Insert( aItem, viewData->m_bbox );
         MarkTargetDirty( l.target );
     }
 }
@@ -1422,6 +1588,7 @@ void VIEW::UpdateItems()
     if( m_gal->IsVisible() )
     {
         GAL_UPDATE_CONTEXT ctx( m_gal );
+        std::vector<VIEW_ITEM*> redrawnItems;
 
         for( VIEW_ITEM* item : *m_allItems )
         {
@@ -1432,10 +1599,12 @@ void VIEW::UpdateItems()
 
             if( viewData->m_requiredUpdate != NONE )
             {
-                invalidateItem( item, viewData->m_requiredUpdate );
+                invalidateItem( item, viewData->m_requiredUpdate, &redrawnItems );
                 viewData->m_requiredUpdate = NONE;
             }
         }
+
+        updateItemsGeometry( redrawnItems );
     }
 }
 
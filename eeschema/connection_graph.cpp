@@ -19,9 +19,8 @@
  */
 
 #include <list>
-#include <thread>
+#include <atomic>
 #include <algorithm>
-#include <future>
 #include <vector>
 #include <unordered_map>
 #include <profile.h>
@@ -38,6 +37,7 @@
 #include <sch_sheet.h>
 #include <sch_sheet_path.h>
 #include <sch_text.h>
+#include <thread_pool.h>
 
 #include <connection_graph.h>
 
@@ -747,11 +747,10 @@ void CONNECTION_GRAPH::buildConnectionGraph()
     // Resolve drivers for subgraphs and propagate connectivity info
 
     // We don't want to spin up a new thread for fewer than 8 nets (overhead costs)
-    size_t parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
+    size_t parallelThreadCount = std::min<size_t>( THREAD_POOL::GetInstance().GetThreadCount(),
             ( m_subgraphs.size() + 3 ) / 4 );
 
     std::atomic<size_t> nextSubgraph( 0 );
-    std::vector<std::future<size_t>> returns( parallelThreadCount );
     std::vector<CONNECTION_SUBGRAPH*> dirty_graphs;
 
     std::copy_if( m_subgraphs.begin(), m_subgraphs.end(), std::back_inserter( dirty_graphs ),
@@ -852,12 +851,13 @@ void CONNECTION_GRAPH::buildConnectionGraph()
         update_lambda();
     else
     {
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii] = std::async( std::launch::async, update_lambda );
+        TASK_GROUP tasks;
 
-        // Finalize the threads
         for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii].wait();
+            tasks.Run( update_lambda );
+
+        // Finalize the tasks
+        tasks.Wait();
     }
 
     // Now discard any non-driven subgraphs from further consideration
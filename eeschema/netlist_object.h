@@ -32,6 +32,11 @@
 #define NETLIST_OBJECT_H
 
 
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
 #include <sch_sheet_path.h>
 #include <lib_pin.h>
 #include <sch_item.h>
@@ -302,6 +307,17 @@ class NETLIST_OBJECT_LIST : public NETLIST_OBJECTS
     int m_lastBusNetCode;   // Used in intermediate calculation:
                             // last net code created for bus members
 
+    // Disjoint-set forests of the net codes merged while building the net list: the parent of
+    // each merged net code, the net codes out of the vectors are not merged.
+    std::vector<int> m_netCodeParents;
+    std::vector<int> m_busNetCodeParents;
+
+    // Index of the items of the sheet being connected (see buildSheetIndex())
+    std::unordered_map<uint64_t, std::vector<unsigned>> m_sheetEndPoints;
+    std::unordered_map<int, std::vector<unsigned>>      m_sheetHorizontalSegments;
+    std::unordered_map<int, std::vector<unsigned>>      m_sheetVerticalSegments;
+    std::vector<unsigned>                               m_sheetOtherSegments;
+
 public:
     /**
      * Constructor.
@@ -435,15 +451,53 @@ private:
      * Propagate aNewNetCode to items having an internal netcode aOldNetCode
      * used to interconnect group of items already physically connected,
      * when a new connection is found between aOldNetCode and aNewNetCode
+     * The items are not updated: the net codes are merged in a disjoint-set forest, and
+     * getNet(), getBusNet() and resolveNetCodes() give the merged net codes.
      */
     void propagateNetCode( int aOldNetCode, int aNewNetCode, bool aIsBus );
 
+    /**
+     * @return the net code aNetCode (or bus net code) was merged into.
+     */
+    int findNetCode( int aNetCode, bool aIsBus );
+
+    /**
+     * @return the current net code of aItem, after the merges.
+     */
+    int getNet( NETLIST_OBJECT* aItem )
+    {
+        aItem->SetNet( findNetCode( aItem->GetNet(), false ) );
+        return aItem->GetNet();
+    }
+
+    /**
+     * @return the current bus net code of aItem, after the merges.
+     */
+    int getBusNet( NETLIST_OBJECT* aItem )
+    {
+        aItem->m_BusNetCode = findNetCode( aItem->m_BusNetCode, true );
+        return aItem->m_BusNetCode;
+    }
+
+    /**
+     * Update the net codes and bus net codes of all the items after the merges.
+     */
+    void resolveNetCodes();
+
+    /**
+     * Index the end points and the segments of the items from aStart to aEnd, which are
+     * the items of a sheet, for pointToPointConnect() and segmentToPointConnect().
+     */
+    void buildSheetIndex( unsigned aStart, unsigned aEnd );
+
     /*
      * This function merges the net codes of groups of objects already connected
      * to labels (wires, bus, pins ... ) when 2 labels are equivalents
      * (i.e. group objects connected by labels)
+     * @param aLabels gives the indexes of the label items by name.
      */
-    void labelConnect( NETLIST_OBJECT* aLabelRef );
+    void labelConnect( NETLIST_OBJECT* aLabelRef,
+                       const std::map<wxString, std::vector<unsigned>>& aLabels );
 
     /* Comparison function to sort by increasing Netcode the list of connected items
      */
@@ -462,19 +516,25 @@ private:
     /**
      * Propagate net codes from a parent sheet to an include sheet,
      * from a pin sheet connection
+     * @param aHierLabels gives the indexes of the hierarchical label items by name.
      */
-    void sheetLabelConnect( NETLIST_OBJECT* aSheetLabel );
+    void sheetLabelConnect( NETLIST_OBJECT* aSheetLabel,
+                            const std::map<wxString, std::vector<unsigned>>& aHierLabels );
 
-    void pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus, int start );
+    /**
+     * Search the items of the sheet of aRef having an end point in common with aRef,
+     * and propagate the net code of aRef to them.
+     * The sheet must be indexed by buildSheetIndex()
+     */
+    void pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus );
 
     /**
      * Search connections between a junction and segments
      * Propagate the junction net code to objects connected by this junction.
      * The junction must have a valid net code
-     * The list of objects is expected sorted by sheets.
-     * Search is done from index aIdxStart to the last element of list
+     * The sheet of the junction must be indexed by buildSheetIndex()
      */
-    void segmentToPointConnect( NETLIST_OBJECT* aJonction, bool aIsBus, int aIdxStart );
+    void segmentToPointConnect( NETLIST_OBJECT* aJonction, bool aIsBus );
 
 
     /**
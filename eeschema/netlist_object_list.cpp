@@ -38,6 +38,7 @@
 #include <sch_text.h>
 #include <sch_sheet.h>
 #include <sch_screen.h>
+#include <trigo.h>
 #include <algorithm>
 
 #define IS_WIRE false
@@ -98,17 +99,22 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
     // Sort objects by Sheet
     SortListbySheet();
 
-    sheet = &(GetItem( 0 )->m_SheetPath);
     m_lastNetCode = m_lastBusNetCode = 1;
+    m_netCodeParents.clear();
+    m_busNetCodeParents.clear();
 
-    for( unsigned ii = 0, istart = 0; ii < size(); ii++ )
+    for( unsigned ii = 0, iend = 0; ii < size(); ii++ )
     {
         NETLIST_OBJECT* net_item = GetItem( ii );
 
-        if( net_item->m_SheetPath != *sheet )   // Sheet change
+        if( ii == iend )   // Sheet change
         {
-            sheet  = &(net_item->m_SheetPath);
-            istart = ii;
+            sheet = &(net_item->m_SheetPath);
+
+            while( iend < size() && GetItem( iend )->m_SheetPath == *sheet )
+                iend++;
+
+            buildSheetIndex( ii, iend );
         }
 
         switch( net_item->m_Type )
@@ -132,7 +138,7 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
                 m_lastNetCode++;
             }
 
-            pointToPointConnect( net_item, IS_WIRE, istart );
+            pointToPointConnect( net_item, IS_WIRE );
             break;
 
         case NET_JUNCTION:
@@ -143,7 +149,7 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
                 m_lastNetCode++;
             }
 
-            segmentToPointConnect( net_item, IS_WIRE, istart );
+            segmentToPointConnect( net_item, IS_WIRE );
 
             // Control of the junction, on BUS.
             if( net_item->m_BusNetCode == 0 )
@@ -152,7 +158,7 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
                 m_lastBusNetCode++;
             }
 
-            segmentToPointConnect( net_item, IS_BUS, istart );
+            segmentToPointConnect( net_item, IS_BUS );
             break;
 
         case NET_LABEL:
@@ -165,7 +171,7 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
                 m_lastNetCode++;
             }
 
-            segmentToPointConnect( net_item, IS_WIRE, istart );
+            segmentToPointConnect( net_item, IS_WIRE );
             break;
 
         case NET_SHEETBUSLABELMEMBER:
@@ -180,7 +186,7 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
                 m_lastBusNetCode++;
             }
 
-            pointToPointConnect( net_item, IS_BUS, istart );
+            pointToPointConnect( net_item, IS_BUS );
             break;
 
         case NET_BUSLABELMEMBER:
@@ -193,7 +199,7 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
                 m_lastBusNetCode++;
             }
 
-            segmentToPointConnect( net_item, IS_BUS, istart );
+            segmentToPointConnect( net_item, IS_BUS );
             break;
         }
     }
@@ -203,9 +209,31 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
     DumpNetTable();
 #endif
 
+    m_sheetEndPoints.clear();
+    m_sheetHorizontalSegments.clear();
+    m_sheetVerticalSegments.clear();
+    m_sheetOtherSegments.clear();
+
+    resolveNetCodes();
+
     // Updating the Bus Labels Netcode connected by Bus
     connectBusLabels();
 
+    // Index the labels by name, for labelConnect() and sheetLabelConnect()
+    std::map<wxString, std::vector<unsigned>> labels;
+    std::map<wxString, std::vector<unsigned>> hierLabels;
+
+    for( unsigned ii = 0; ii < size(); ii++ )
+    {
+        NETLIST_OBJECT* item = GetItem( ii );
+
+        if( item->IsLabelType() )
+            labels[item->m_Label].push_back( ii );
+
+        if( item->m_Type == NET_HIERLABEL || item->m_Type == NET_HIERBUSLABELMEMBER )
+            hierLabels[item->m_Label].push_back( ii );
+    }
+
     // Group objects by label.
     for( unsigned ii = 0; ii < size(); ii++ )
     {
@@ -224,7 +252,7 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
         case NET_PINLABEL:
         case NET_BUSLABELMEMBER:
         case NET_GLOBBUSLABELMEMBER:
-            labelConnect( GetItem( ii ) );
+            labelConnect( GetItem( ii ), labels );
             break;
 
         case NET_SHEETBUSLABELMEMBER:
@@ -247,9 +275,13 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
     {
         if( GetItem( ii )->m_Type == NET_SHEETLABEL
             || GetItem( ii )->m_Type == NET_SHEETBUSLABELMEMBER )
-            sheetLabelConnect( GetItem( ii ) );
+            sheetLabelConnect( GetItem( ii ), hierLabels );
     }
 
+    resolveNetCodes();
+    m_netCodeParents.clear();
+    m_busNetCodeParents.clear();
+
     // Sort objects by NetCode
     SortListbyNetcode();
 
@@ -497,27 +529,27 @@ void NETLIST_OBJECT_LIST::findBestNetNameForEachNet()
 }
 
 
-void NETLIST_OBJECT_LIST::sheetLabelConnect( NETLIST_OBJECT* SheetLabel )
+void NETLIST_OBJECT_LIST::sheetLabelConnect( NETLIST_OBJECT* SheetLabel,
+        const std::map<wxString, std::vector<unsigned>>& aHierLabels )
 {
-    if( SheetLabel->GetNet() == 0 )
+    if( getNet( SheetLabel ) == 0 )
         return;
 
-    for( unsigned ii = 0; ii < size(); ii++ )
+    auto sameName = aHierLabels.find( SheetLabel->m_Label );
+
+    if( sameName == aHierLabels.end() )
+        return;
+
+    for( unsigned ii : sameName->second )
     {
         NETLIST_OBJECT* ObjetNet = GetItem( ii );
 
         if( ObjetNet->m_SheetPath != SheetLabel->m_SheetPathInclude )
             continue;  //use SheetInclude, not the sheet!!
 
-        if( (ObjetNet->m_Type != NET_HIERLABEL ) && (ObjetNet->m_Type != NET_HIERBUSLABELMEMBER ) )
-            continue;
-
-        if( ObjetNet->GetNet() == SheetLabel->GetNet() )
+        if( getNet( ObjetNet ) == getNet( SheetLabel ) )
             continue;  //already connected.
 
-        if( ObjetNet->m_Label != SheetLabel->m_Label )
-            continue;  //different names.
-
         // Propagate Netcode having all the objects of the same Netcode.
         if( ObjetNet->GetNet() )
             propagateNetCode( ObjetNet->GetNet(), SheetLabel->GetNet(), IS_WIRE );
@@ -531,7 +563,18 @@ void NETLIST_OBJECT_LIST::connectBusLabels()
 {
     // Propagate the net code between all bus label member objects connected by they name.
     // If the net code is not yet existing, a new one is created
-    // Search is done in the entire list
+    // Search is done in the entire list, using an index of the bus label members by bus net
+    // code and member.  The bus net codes are already resolved.
+    std::map<std::pair<int, int>, std::vector<unsigned>> members;
+
+    for( unsigned ii = 0; ii < size(); ii++ )
+    {
+        NETLIST_OBJECT* Label = GetItem( ii );
+
+        if( Label->IsLabelBusMemberType() )
+            members[ std::make_pair( Label->m_BusNetCode, Label->m_Member ) ].push_back( ii );
+    }
+
     for( unsigned ii = 0; ii < size(); ii++ )
     {
         NETLIST_OBJECT* Label = GetItem( ii );
@@ -545,25 +588,20 @@ void NETLIST_OBJECT_LIST::connectBusLabels()
                 m_lastNetCode++;
             }
 
-            for( unsigned jj = ii + 1; jj < size(); jj++ )
+            const std::vector<unsigned>& sameMember =
+                    members[ std::make_pair( Label->m_BusNetCode, Label->m_Member ) ];
+
+            for( auto jj = std::upper_bound( sameMember.begin(), sameMember.end(), ii );
+                 jj != sameMember.end(); ++jj )
             {
-                NETLIST_OBJECT* LabelInTst =  GetItem( jj );
+                NETLIST_OBJECT* LabelInTst =  GetItem( *jj );
 
-                if( LabelInTst->IsLabelBusMemberType() )
-                {
-                    if( LabelInTst->m_BusNetCode != Label->m_BusNetCode )
-                        continue;
-
-                    if( LabelInTst->m_Member != Label->m_Member )
-                        continue;
-
-                    if( LabelInTst->GetNet() == 0 )
-                        // Append this object to the current net
-                        LabelInTst->SetNet( Label->GetNet() );
-                    else
-                        // Merge the 2 net codes, they are connected.
-                        propagateNetCode( LabelInTst->GetNet(), Label->GetNet(), IS_WIRE );
-                }
+                if( LabelInTst->GetNet() == 0 )
+                    // Append this object to the current net
+                    LabelInTst->SetNet( getNet( Label ) );
+                else
+                    // Merge the 2 net codes, they are connected.
+                    propagateNetCode( getNet( LabelInTst ), getNet( Label ), IS_WIRE );
             }
         }
     }
@@ -572,47 +610,112 @@ void NETLIST_OBJECT_LIST::connectBusLabels()
 
 void NETLIST_OBJECT_LIST::propagateNetCode( int aOldNetCode, int aNewNetCode, bool aIsBus )
 {
+    aOldNetCode = findNetCode( aOldNetCode, aIsBus );
+    aNewNetCode = findNetCode( aNewNetCode, aIsBus );
+
     if( aOldNetCode == aNewNetCode )
         return;
 
-    if( aIsBus == false )    // Propagate NetCode
+    // The merged net keeps aNewNetCode, as if all the items of aOldNetCode were renumbered
+    std::vector<int>& parents = aIsBus ? m_busNetCodeParents : m_netCodeParents;
+    size_t            count = std::max( aOldNetCode, aNewNetCode ) + 1;
+
+    for( size_t code = parents.size(); code < count; code++ )
+        parents.push_back( code );
+
+    parents[aOldNetCode] = aNewNetCode;
+}
+
+
+int NETLIST_OBJECT_LIST::findNetCode( int aNetCode, bool aIsBus )
+{
+    std::vector<int>& parents = aIsBus ? m_busNetCodeParents : m_netCodeParents;
+
+    if( aNetCode <= 0 || aNetCode >= (int) parents.size() )
+        return aNetCode;
+
+    // Path halving
+    while( parents[aNetCode] != aNetCode )
     {
-        for( unsigned jj = 0; jj < size(); jj++ )
-        {
-            NETLIST_OBJECT* object = GetItem( jj );
+        parents[aNetCode] = parents[parents[aNetCode]];
+        aNetCode = parents[aNetCode];
+    }
 
-            if( object->GetNet() == aOldNetCode )
-                object->SetNet( aNewNetCode );
-        }
+    return aNetCode;
+}
+
+
+void NETLIST_OBJECT_LIST::resolveNetCodes()
+{
+    for( unsigned ii = 0; ii < size(); ii++ )
+    {
+        getNet( GetItem( ii ) );
+        getBusNet( GetItem( ii ) );
     }
-    else               // Propagate BusNetCode
+}
+
+
+static uint64_t pointKey( const wxPoint& aPoint )
+{
+    return ( (uint64_t) (uint32_t) aPoint.x << 32 ) | (uint32_t) aPoint.y;
+}
+
+
+void NETLIST_OBJECT_LIST::buildSheetIndex( unsigned aStart, unsigned aEnd )
+{
+    m_sheetEndPoints.clear();
+    m_sheetHorizontalSegments.clear();
+    m_sheetVerticalSegments.clear();
+    m_sheetOtherSegments.clear();
+
+    for( unsigned ii = aStart; ii < aEnd; ii++ )
     {
-        for( unsigned jj = 0; jj < size(); jj++ )
-        {
-            NETLIST_OBJECT* object = GetItem( jj );
+        NETLIST_OBJECT* item = GetItem( ii );
 
-            if( object->m_BusNetCode == aOldNetCode )
-                object->m_BusNetCode = aNewNetCode;
-        }
+        m_sheetEndPoints[ pointKey( item->m_Start ) ].push_back( ii );
+
+        if( item->m_End != item->m_Start )
+            m_sheetEndPoints[ pointKey( item->m_End ) ].push_back( ii );
+
+        if( item->m_Type != NET_SEGMENT && item->m_Type != NET_BUS )
+            continue;
+
+        if( item->m_Start.y == item->m_End.y )
+            m_sheetHorizontalSegments[ item->m_Start.y ].push_back( ii );
+        else if( item->m_Start.x == item->m_End.x )
+            m_sheetVerticalSegments[ item->m_Start.x ].push_back( ii );
+        else
+            m_sheetOtherSegments.push_back( ii );
     }
 }
 
 
-void NETLIST_OBJECT_LIST::pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus, int start )
+void NETLIST_OBJECT_LIST::pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus )
 {
     int netCode;
 
+    // The items of the sheet having an end point of aRef, in the order of the list
+    std::vector<unsigned> candidates;
+
+    for( const wxPoint& point : { aRef->m_Start, aRef->m_End } )
+    {
+        auto it = m_sheetEndPoints.find( pointKey( point ) );
+
+        if( it != m_sheetEndPoints.end() )
+            candidates.insert( candidates.end(), it->second.begin(), it->second.end() );
+    }
+
+    std::sort( candidates.begin(), candidates.end() );
+    candidates.erase( std::unique( candidates.begin(), candidates.end() ), candidates.end() );
+
     if( aIsBus == false )    // Objects other than BUS and BUSLABELS
     {
-        netCode = aRef->GetNet();
+        netCode = getNet( aRef );
 
-        for( unsigned i = start; i < size(); i++ )
+        for( unsigned i : candidates )
         {
             NETLIST_OBJECT* item = GetItem( i );
 
-            if( item->m_SheetPath != aRef->m_SheetPath )  //used to be > (why?)
-                continue;
-
             switch( item->m_Type )
             {
             case NET_SEGMENT:
@@ -624,16 +727,10 @@ void NETLIST_OBJECT_LIST::pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus
             case NET_PINLABEL:
             case NET_JUNCTION:
             case NET_NOCONNECT:
-                if( aRef->m_Start == item->m_Start
-                    || aRef->m_Start == item->m_End
-                    || aRef->m_End   == item->m_Start
-                    || aRef->m_End   == item->m_End )
-                {
-                    if( item->GetNet() == 0 )
-                        item->SetNet( netCode );
-                    else
-                        propagateNetCode( item->GetNet(), netCode, IS_WIRE );
-                }
+                if( item->GetNet() == 0 )
+                    item->SetNet( netCode );
+                else
+                    propagateNetCode( item->GetNet(), netCode, IS_WIRE );
                 break;
 
             case NET_BUS:
@@ -648,15 +745,12 @@ void NETLIST_OBJECT_LIST::pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus
     }
     else    // Object type BUS, BUSLABELS, and junctions.
     {
-        netCode = aRef->m_BusNetCode;
+        netCode = getBusNet( aRef );
 
-        for( unsigned i = start; i < size(); i++ )
+        for( unsigned i : candidates )
         {
             NETLIST_OBJECT* item = GetItem( i );
 
-            if( item->m_SheetPath != aRef->m_SheetPath )
-                continue;
-
             switch( item->m_Type )
             {
             case NET_ITEM_UNSPECIFIED:
@@ -676,16 +770,10 @@ void NETLIST_OBJECT_LIST::pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus
             case NET_HIERBUSLABELMEMBER:
             case NET_GLOBBUSLABELMEMBER:
             case NET_JUNCTION:
-                if(  aRef->m_Start == item->m_Start
-                  || aRef->m_Start == item->m_End
-                  || aRef->m_End   == item->m_Start
-                  || aRef->m_End   == item->m_End )
-                {
-                    if( item->m_BusNetCode == 0 )
-                        item->m_BusNetCode = netCode;
-                    else
-                        propagateNetCode( item->m_BusNetCode, netCode, IS_BUS );
-                }
+                if( item->m_BusNetCode == 0 )
+                    item->m_BusNetCode = netCode;
+                else
+                    propagateNetCode( item->m_BusNetCode, netCode, IS_BUS );
                 break;
             }
         }
@@ -693,17 +781,29 @@ void NETLIST_OBJECT_LIST::pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus
 }
 
 
-void NETLIST_OBJECT_LIST::segmentToPointConnect( NETLIST_OBJECT* aJonction,
-                                                 bool aIsBus, int aIdxStart )
+void NETLIST_OBJECT_LIST::segmentToPointConnect( NETLIST_OBJECT* aJonction, bool aIsBus )
 {
-    for( unsigned i = aIdxStart; i < size(); i++ )
+    const wxPoint& point = aJonction->m_Start;
+
+    // The segments of the sheet which may contain the junction, in the order of the list
+    std::vector<unsigned> candidates( m_sheetOtherSegments );
+
+    auto horizontal = m_sheetHorizontalSegments.find( point.y );
+
+    if( horizontal != m_sheetHorizontalSegments.end() )
+        candidates.insert( candidates.end(), horizontal->second.begin(), horizontal->second.end() );
+
+    auto vertical = m_sheetVerticalSegments.find( point.x );
+
+    if( vertical != m_sheetVerticalSegments.end() )
+        candidates.insert( candidates.end(), vertical->second.begin(), vertical->second.end() );
+
+    std::sort( candidates.begin(), candidates.end() );
+
+    for( unsigned i : candidates )
     {
         NETLIST_OBJECT* segment = GetItem( i );
 
-        // if different sheets, obviously no physical connection between elements.
-        if( segment->m_SheetPath != aJonction->m_SheetPath )
-            continue;
-
         if( aIsBus == IS_WIRE )
         {
             if( segment->m_Type != NET_SEGMENT )
@@ -715,7 +815,7 @@ void NETLIST_OBJECT_LIST::segmentToPointConnect( NETLIST_OBJECT* aJonction,
                 continue;
         }
 
-        if( IsPointOnSegment( segment->m_Start, segment->m_End, aJonction->m_Start ) )
+        if( IsPointOnSegment( segment->m_Start, segment->m_End, point ) )
         {
             // Propagation Netcode has all the objects of the same Netcode.
             if( aIsBus == IS_WIRE )
@@ -723,30 +823,36 @@ void NETLIST_OBJECT_LIST::segmentToPointConnect( NETLIST_OBJECT* aJonction,
                 if( segment->GetNet() )
                     propagateNetCode( segment->GetNet(), aJonction->GetNet(), aIsBus );
                 else
-                    segment->SetNet( aJonction->GetNet() );
+                    segment->SetNet( getNet( aJonction ) );
             }
             else
             {
                 if( segment->m_BusNetCode )
                     propagateNetCode( segment->m_BusNetCode, aJonction->m_BusNetCode, aIsBus );
                 else
-                    segment->m_BusNetCode = aJonction->m_BusNetCode;
+                    segment->m_BusNetCode = getBusNet( aJonction );
             }
         }
     }
 }
 
 
-void NETLIST_OBJECT_LIST::labelConnect( NETLIST_OBJECT* aLabelRef )
+void NETLIST_OBJECT_LIST::labelConnect( NETLIST_OBJECT* aLabelRef,
+        const std::map<wxString, std::vector<unsigned>>& aLabels )
 {
-    if( aLabelRef->GetNet() == 0 )
+    if( getNet( aLabelRef ) == 0 )
+        return;
+
+    auto sameName = aLabels.find( aLabelRef->m_Label );
+
+    if( sameName == aLabels.end() )
         return;
 
-    for( unsigned i = 0; i < size(); i++ )
+    for( unsigned i : sameName->second )
     {
         NETLIST_OBJECT* item = GetItem( i );
 
-        if( item->GetNet() == aLabelRef->GetNet() )
+        if( getNet( item ) == getNet( aLabelRef ) )
             continue;
 
         if( item->m_SheetPath != aLabelRef->m_SheetPath )
@@ -766,16 +872,11 @@ void NETLIST_OBJECT_LIST::labelConnect( NETLIST_OBJECT* aLabelRef )
         // NET_LABEL are local to a sheet
         // NET_GLOBLABEL are global.
         // NET_PINLABEL is a kind of global label (generated by a power pin invisible)
-        if( item->IsLabelType() )
-        {
-            if( item->m_Label != aLabelRef->m_Label )
-                continue;
-
-            if( item->GetNet() )
-                propagateNetCode( item->GetNet(), aLabelRef->GetNet(), IS_WIRE );
-            else
-                item->SetNet( aLabelRef->GetNet() );
-        }
+        // The index only holds labels with the same name
+        if( item->GetNet() )
+            propagateNetCode( item->GetNet(), aLabelRef->GetNet(), IS_WIRE );
+        else
+            item->SetNet( aLabelRef->GetNet() );
     }
 }
 
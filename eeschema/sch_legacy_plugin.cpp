@@ -31,6 +31,7 @@
 #include <draw_graphic_text.h>
 #include <kiway.h>
 #include <kicad_string.h>
+#include <number_parser.h>
 #include <richio.h>
 #include <core/typeinfo.h>
 #include <properties.h>
@@ -151,16 +152,16 @@ static int parseInt( LINE_READER& aReader, const char* aLine, const char** aOutp
     if( !*aLine )
         SCH_PARSE_ERROR( _( "unexpected end of line" ), aReader, aLine );
 
-    // Clear errno before calling strtol() in case some other crt call set it.
+    // Clear errno before calling StrToLong() in case some other crt call set it.
     errno = 0;
 
-    long retv = strtol( aLine, (char**) aOutput, 10 );
+    long retv = StrToLong( aLine, aOutput );
 
-    // Make sure no error occurred when calling strtol().
+    // Make sure no error occurred when calling StrToLong().
     if( errno == ERANGE )
         SCH_PARSE_ERROR( "invalid integer value", aReader, aLine );
 
-    // strtol does not strip off whitespace before the next token.
+    // StrToLong does not strip off whitespace before the next token.
     if( aOutput )
     {
         const char* next = *aOutput;
@@ -240,16 +241,16 @@ static double parseDouble( LINE_READER& aReader, const char* aLine,
     if( !*aLine )
         SCH_PARSE_ERROR( _( "unexpected end of line" ), aReader, aLine );
 
-    // Clear errno before calling strtod() in case some other crt call set it.
+    // Clear errno before calling StrToDouble() in case some other crt call set it.
     errno = 0;
 
-    double retv = strtod( aLine, (char**) aOutput );
+    double retv = StrToDouble( aLine, aOutput );
 
-    // Make sure no error occurred when calling strtod().
+    // Make sure no error occurred when calling StrToDouble().
     if( errno == ERANGE )
         SCH_PARSE_ERROR( "invalid floating point number", aReader, aLine );
 
-    // strtod does not strip off whitespace before the next token.
+    // StrToDouble does not strip off whitespace before the next token.
     if( aOutput )
     {
         const char* next = *aOutput;
@@ -56,10 +56,10 @@
 #include <lib_pin.h>
 #include <symbol_lib_table.h>
 #include <tool/common_tools.h>
+#include <thread_pool.h>
 
-#include <thread>
+#include <atomic>
 #include <algorithm>
-#include <future>
 #include <array>
 
 // TODO(JE) Debugging only
@@ -1218,11 +1218,10 @@ void SCH_SCREENS::TestDanglingEnds()
     for( SCH_SCREEN* screen = GetFirst(); screen; screen = GetNext() )
         screens.push_back( screen );
 
-    size_t parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
+    size_t parallelThreadCount = std::min<size_t>( THREAD_POOL::GetInstance().GetThreadCount(),
             screens.size() );
 
     std::atomic<size_t> nextScreen( 0 );
-    std::vector<std::future<size_t>> returns( parallelThreadCount );
 
     auto update_lambda = [&screens, &nextScreen]() -> size_t
     {
@@ -1236,12 +1235,13 @@ void SCH_SCREENS::TestDanglingEnds()
         update_lambda();
     else
     {
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii] = std::async( std::launch::async, update_lambda );
+        TASK_GROUP tasks;
 
-        // Finalize the threads
         for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii].wait();
+            tasks.Run( update_lambda );
+
+        // Finalize the tasks
+        tasks.Wait();
     }
 
 }
@@ -104,8 +104,8 @@ void AM_PRIMITIVE::DrawBasicShape( const GERBER_DRAW_ITEM* aParent,
                             aShapeBuffer.Append( polybuffer[0].x, polybuffer[0].y );}
 
     // Draw the primitive shape for flashed items.
-    static std::vector<wxPoint> polybuffer;     // create a static buffer to avoid a lot of memory reallocation
-    polybuffer.clear();
+    // Not a static buffer: shapes can be built by several threads at the same time
+    std::vector<wxPoint> polybuffer;
 
     wxPoint curPos = aShapePos;
     D_CODE* tool   = aParent->GetDcodeDescr();
@@ -40,6 +40,7 @@
 #include <gerbview_layer_widget.h>
 #include <wildcards_and_files_ext.h>
 #include <widgets/progress_reporter.h>
+#include <thread_pool.h>
 
 // HTML Messages used more than one time:
 #define MSG_NO_MORE_LAYER\
@@ -278,6 +279,8 @@ bool GERBVIEW_FRAME::loadListOfGerberAndDrillFiles( const wxString& aPath,
     auto startTime = wxGetUTCTimeMillis();
     std::unique_ptr<WX_PROGRESS_REPORTER> progress = nullptr;
 
+    std::vector<wxFileName> filenames;
+
     for( unsigned ii = 0; ii < aFilenameList.GetCount(); ii++ )
     {
         filename = aFilenameList[ii];
@@ -285,6 +288,64 @@ bool GERBVIEW_FRAME::loadListOfGerberAndDrillFiles( const wxString& aPath,
         if( !filename.IsAbsolute() )
             filename.SetPath( aPath );
 
+        filenames.push_back( filename );
+    }
+
+    // Read the gerber files in parallel, each one in its own image.  The images are only
+    // attached to the layers and the view below, in the order of the list.
+    std::vector<std::unique_ptr<GERBER_FILE_IMAGE>> images( filenames.size() );
+
+    {
+        // Switch the locale once for all the reader threads
+        LOCALE_IO          toggle;
+        TASK_GROUP         tasks;
+        std::atomic<int>   readCount( 0 );
+        int                reportedCount = 0;
+
+        tasks.RunForEach( filenames.size(),
+                [&]( size_t ii )
+                {
+                    if( ( !aFileType || (*aFileType)[ii] != 1 ) && filenames[ii].FileExists() )
+                    {
+                        std::unique_ptr<GERBER_FILE_IMAGE> image(
+                                new GERBER_FILE_IMAGE( UNDEFINED_LAYER ) );
+
+                        if( image->LoadGerberFile( filenames[ii].GetFullPath() ) )
+                            images[ii] = std::move( image );
+                    }
+
+                    readCount++;
+                } );
+
+        tasks.WaitAndRefresh(
+                [&]()
+                {
+                    if( !progress && wxGetUTCTimeMillis() - startTime > progressShowDelay )
+                    {
+                        progress = std::make_unique<WX_PROGRESS_REPORTER>( this,
+                                        _( "Loading Gerber files..." ), 1, false );
+                        progress->SetMaxProgress( filenames.size() );
+                        progress->Report( _("Loading Gerber files..." ) );
+                    }
+
+                    if( progress )
+                    {
+                        for( ; reportedCount < readCount; reportedCount++ )
+                            progress->AdvanceProgress();
+
+                        progress->KeepRefreshing();
+                    }
+
+                    return true;
+                } );
+    }
+
+    progress.reset();
+
+    for( unsigned ii = 0; ii < aFilenameList.GetCount(); ii++ )
+    {
+        filename = filenames[ii];
+
         // Check for non existing files, to avoid creating broken or useless data
         // and report all in one error list:
         if( !filename.FileExists() )
@@ -297,18 +358,6 @@ bool GERBVIEW_FRAME::loadListOfGerberAndDrillFiles( const wxString& aPath,
             continue;
         }
 
-        if( !progress && wxGetUTCTimeMillis() - startTime > progressShowDelay )
-        {
-            progress = std::make_unique<WX_PROGRESS_REPORTER>( this,
-                            _( "Loading Gerber files..." ), 1, false );
-            progress->SetMaxProgress( aFilenameList.GetCount() - 1 );
-            progress->Report( _("Loading Gerber files..." ) );
-        }
-        else if( progress )
-        {
-            progress->KeepRefreshing();
-        }
-
         m_lastFileName = filename.GetFullPath();
 
         SetActiveLayer( layer, false );
@@ -322,7 +371,7 @@ bool GERBVIEW_FRAME::loadListOfGerberAndDrillFiles( const wxString& aPath,
         }
         else
         {
-            if( Read_GERBER_File( filename.GetFullPath() ) )
+            if( Read_GERBER_File( filename.GetFullPath(), images[ii].release() ) )
             {
                 UpdateFileHistory( m_lastFileName );
 
@@ -347,9 +396,6 @@ bool GERBVIEW_FRAME::loadListOfGerberAndDrillFiles( const wxString& aPath,
                 SetActiveLayer( layer, false );
             }
         }
-
-        if( progress )
-            progress->AdvanceProgress();
     }
 
     if( !success )
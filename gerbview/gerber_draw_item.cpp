@@ -41,6 +41,10 @@
 #include <gerber_file_image_list.h>
 #include <kicad_string.h>
 
+// The net attributes of the items which have none
+static const GBR_NETLIST_METADATA s_noNetAttributes;
+
+
 GERBER_DRAW_ITEM::GERBER_DRAW_ITEM( GERBER_FILE_IMAGE* aGerberImageFile ) :
     EDA_ITEM( (EDA_ITEM*)NULL, GERBER_DRAW_ITEM_T )
 {
@@ -55,6 +59,7 @@ GERBER_DRAW_ITEM::GERBER_DRAW_ITEM( GERBER_FILE_IMAGE* aGerberImageFile ) :
     m_mirrorB       = false;
     m_drawScale.x   = m_drawScale.y = 1.0;
     m_lyrRotation   = 0;
+    m_netAttributes = &s_noNetAttributes;
 
     if( m_GerberImageFile )
         SetLayerParameters();
@@ -68,14 +73,7 @@ GERBER_DRAW_ITEM::~GERBER_DRAW_ITEM()
 
 void GERBER_DRAW_ITEM::SetNetAttributes( const GBR_NETLIST_METADATA& aNetAttributes )
 {
-    m_netAttributes = aNetAttributes;
-
-    if( ( m_netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_CMP ) ||
-        ( m_netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_PAD ) )
-        m_GerberImageFile->m_ComponentsList.insert( std::make_pair( m_netAttributes.m_Cmpref, 0 ) );
-
-    if( ( m_netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_NET ) )
-        m_GerberImageFile->m_NetnamesList.insert( std::make_pair( m_netAttributes.m_Netname, 0 ) );
+    m_netAttributes = m_GerberImageFile->InternNetAttributes( aNetAttributes );
 }
 
 
@@ -728,35 +726,35 @@ void GERBER_DRAW_ITEM::GetMsgPanelInfo( EDA_UNITS_T aUnits, std::vector< MSG_PAN
     aList.push_back( MSG_PANEL_ITEM( _( "AB axis" ), msg, DARKRED ) );
 
     // Display net info, if exists
-    if( m_netAttributes.m_NetAttribType == GBR_NETLIST_METADATA::GBR_NETINFO_UNSPECIFIED )
+    if( m_netAttributes->m_NetAttribType == GBR_NETLIST_METADATA::GBR_NETINFO_UNSPECIFIED )
         return;
 
     // Build full net info:
     wxString net_msg;
     wxString cmp_pad_msg;
 
-    if( ( m_netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_NET ) )
+    if( ( m_netAttributes->m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_NET ) )
     {
         net_msg = _( "Net:" );
         net_msg << " ";
 
-        if( m_netAttributes.m_Netname.IsEmpty() )
+        if( m_netAttributes->m_Netname.IsEmpty() )
             net_msg << "<no net>";
         else
-            net_msg << UnescapeString( m_netAttributes.m_Netname );
+            net_msg << UnescapeString( m_netAttributes->m_Netname );
     }
 
-    if( ( m_netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_PAD ) )
+    if( ( m_netAttributes->m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_PAD ) )
     {
         cmp_pad_msg.Printf( _( "Cmp: %s;  Pad: %s" ),
-                                m_netAttributes.m_Cmpref,
-                                m_netAttributes.m_Padname );
+                                m_netAttributes->m_Cmpref,
+                                m_netAttributes->m_Padname );
     }
 
-    else if( ( m_netAttributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_CMP ) )
+    else if( ( m_netAttributes->m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_CMP ) )
     {
         cmp_pad_msg = _( "Cmp:" );
-        cmp_pad_msg << " " << m_netAttributes.m_Cmpref;
+        cmp_pad_msg << " " << m_netAttributes->m_Cmpref;
     }
 
     aList.push_back( MSG_PANEL_ITEM( net_msg, cmp_pad_msg, DARKCYAN ) );
@@ -932,7 +930,7 @@ const BOX2I GERBER_DRAW_ITEM::ViewBBox() const
 }
 
 
-unsigned int GERBER_DRAW_ITEM::ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const
+double GERBER_DRAW_ITEM::ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const
 {
     // DCodes will be shown only if zoom is appropriate:
     // Returns the level of detail of the item.
@@ -110,9 +110,10 @@ private:
     wxRealPoint m_drawScale;                // A and B scaling factor
     wxPoint     m_layerOffset;              // Offset for A and B axis, from OF parameter
     double      m_lyrRotation;              // Fine rotation, from OR parameter, in degrees
-    GBR_NETLIST_METADATA m_netAttributes;   ///< the string given by a %TO attribute set in aperture
-                                            ///< (dcode). Stored in each item, because %TO is
-                                            ///< a dynamic object attribute
+    const GBR_NETLIST_METADATA* m_netAttributes; ///< the string given by a %TO attribute set in
+                                            ///< aperture (dcode). Given for each item, because
+                                            ///< %TO is a dynamic object attribute, but shared
+                                            ///< by all the items of the image using it
 
 public:
     GERBER_DRAW_ITEM( GERBER_FILE_IMAGE* aGerberparams );
@@ -122,7 +123,7 @@ public:
     GERBER_DRAW_ITEM* Back() const { return static_cast<GERBER_DRAW_ITEM*>( Pback ); }
 
     void SetNetAttributes( const GBR_NETLIST_METADATA& aNetAttributes );
-    const GBR_NETLIST_METADATA& GetNetAttributes() const { return m_netAttributes; }
+    const GBR_NETLIST_METADATA& GetNetAttributes() const { return *m_netAttributes; }
 
     /**
      * Function GetLayer
@@ -317,7 +318,7 @@ public:
     virtual const BOX2I ViewBBox() const override;
 
     /// @copydoc VIEW_ITEM::ViewGetLOD()
-    virtual unsigned int ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const override;
+    virtual double ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const override;
 
     ///> @copydoc EDA_ITEM::Visit()
     SEARCH_RESULT Visit( INSPECTOR inspector, void* testData, const KICAD_T scanTypes[] ) override;
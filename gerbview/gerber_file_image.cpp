@@ -98,6 +98,7 @@ GERBER_FILE_IMAGE::GERBER_FILE_IMAGE( int aLayer ) :
 
     m_Selected_Tool = 0;
     m_FileFunction = NULL;          // file function parameters
+    m_lastNetAttributes = NULL;
 
     ResetDefaultValues();
 
@@ -376,6 +377,37 @@ void GERBER_FILE_IMAGE::DisplayImageInfo(  GERBVIEW_FRAME* aMainFrame  )
 }
 
 
+const GBR_NETLIST_METADATA* GERBER_FILE_IMAGE::InternNetAttributes(
+        const GBR_NETLIST_METADATA& aNetAttributes )
+{
+    // Consecutive items nearly always have the same attributes: avoid the lookup
+    NET_ATTRIBUTES_LESS less;
+
+    if( m_lastNetAttributes && !less( aNetAttributes, *m_lastNetAttributes )
+            && !less( *m_lastNetAttributes, aNetAttributes ) )
+    {
+        return m_lastNetAttributes;
+    }
+
+    auto inserted = m_netAttributesPool.insert( aNetAttributes );
+    const GBR_NETLIST_METADATA& attributes = *inserted.first;
+
+    if( inserted.second )
+    {
+        if( ( attributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_CMP ) ||
+            ( attributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_PAD ) )
+            m_ComponentsList.insert( std::make_pair( attributes.m_Cmpref, 0 ) );
+
+        if( ( attributes.m_NetAttribType & GBR_NETLIST_METADATA::GBR_NETINFO_NET ) )
+            m_NetnamesList.insert( std::make_pair( attributes.m_Netname, 0 ) );
+    }
+
+    m_lastNetAttributes = &attributes;
+
+    return m_lastNetAttributes;
+}
+
+
 void GERBER_FILE_IMAGE::RemoveAttribute( X2_ATTRIBUTE& aAttribute )
 {
     /* Called when a %TD command is found
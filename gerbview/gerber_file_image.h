@@ -177,6 +177,36 @@ public:
     std::map<wxString, int> m_NetnamesList;                     // list of net names
 
 private:
+    /// Orders the net attributes sets of the pool of an image
+    struct NET_ATTRIBUTES_LESS
+    {
+        bool operator()( const GBR_NETLIST_METADATA& aFirst,
+                         const GBR_NETLIST_METADATA& aSecond ) const
+        {
+            if( aFirst.m_NetAttribType != aSecond.m_NetAttribType )
+                return aFirst.m_NetAttribType < aSecond.m_NetAttribType;
+
+            if( aFirst.m_NotInNet != aSecond.m_NotInNet )
+                return aSecond.m_NotInNet;
+
+            int diff = aFirst.m_Netname.Cmp( aSecond.m_Netname );
+
+            if( diff == 0 )
+                diff = aFirst.m_Cmpref.Cmp( aSecond.m_Cmpref );
+
+            if( diff == 0 )
+                diff = aFirst.m_Padname.Cmp( aSecond.m_Padname );
+
+            return diff < 0;
+        }
+    };
+
+    // The net attributes of the items of this image.  A %TO attribute usually applies to
+    // many items, so each distinct set is stored once here and shared by its items, which
+    // saves the copy (152 bytes on 64 bit GTK builds) and the string buffers of each item
+    std::set<GBR_NETLIST_METADATA, NET_ATTRIBUTES_LESS> m_netAttributesPool;
+    const GBR_NETLIST_METADATA* m_lastNetAttributes;            // the last interned set
+
     wxArrayString      m_messagesList;                          // A list of messages created when reading a file
     int                m_hasNegativeItems;                      // true if the image is negative or has some negative items
                                                                 // Used to optimize drawing, because when there are no
@@ -378,6 +408,16 @@ public:
      */
     void            StepAndRepeatItem( const GERBER_DRAW_ITEM& aItem );
 
+    /**
+     * Function InternNetAttributes
+     * returns the copy of aNetAttributes shared by the items of this image, and adds it
+     * to the pool (and its component and net names to m_ComponentsList and m_NetnamesList)
+     * the first time this set of attributes is used.
+     * The returned pointer is valid as long as the image exists.
+     * @param aNetAttributes = the net attributes of an item
+     */
+    const GBR_NETLIST_METADATA* InternNetAttributes( const GBR_NETLIST_METADATA& aNetAttributes );
+
     /**
      * Function DisplayImageInfo
      * has knowledge about the frame and how and where to put status information
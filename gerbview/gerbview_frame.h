@@ -584,7 +584,17 @@ public:
      * @return true if file was opened successfully.
      */
     bool LoadGerberFiles( const wxString& aFileName );
-    bool Read_GERBER_File( const wxString&   GERBER_FullFileName );
+
+    /**
+     * function Read_GERBER_File
+     * Load a Gerber file on the active layer.
+     * @param GERBER_FullFileName - the file name with full path
+     * @param aImage - the image already read from the file, which the frame then owns,
+     *                 or NULL to read the file now
+     * @return true if the file was loaded
+     */
+    bool Read_GERBER_File( const wxString& GERBER_FullFileName,
+                           GERBER_FILE_IMAGE* aImage = nullptr );
 
     /**
      * function LoadExcellonFiles
@@ -37,7 +37,8 @@
 
 /* Read a gerber file, RS274D, RS274X or RS274X2 format.
  */
-bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
+bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName,
+                                       GERBER_FILE_IMAGE* aImage )
 {
     wxString msg;
 
@@ -50,11 +51,20 @@ bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
         Erase_Current_DrawLayer( false );
     }
 
-    gerber = new GERBER_FILE_IMAGE( layer );
+    // Read the gerber file, unless it was already read. The image will be added only if
+    // it can be read to avoid broken data.
+    bool success = true;
 
-    // Read the gerber file. The image will be added only if it can be read
-    // to avoid broken data.
-    bool success = gerber->LoadGerberFile( GERBER_FullFileName );
+    if( aImage )
+    {
+        gerber = aImage;
+        gerber->m_GraphicLayer = layer;
+    }
+    else
+    {
+        gerber = new GERBER_FILE_IMAGE( layer );
+        success = gerber->LoadGerberFile( GERBER_FullFileName );
+    }
 
     if( !success )
     {
@@ -111,8 +121,6 @@ bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
 // size of a single line of text from a gerber file.
 // warning: some files can have *very long* lines, so the buffer must be large.
 #define GERBER_BUFZ 1000000
-// A large buffer to store one line
-static char lineBuffer[GERBER_BUFZ+1];
 
 bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
 {
@@ -120,6 +128,11 @@ bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
     int      D_commande = 0;       // command number for D commands like D02
     char*    text;
 
+    // A large buffer to store one line.  Each call has its own, so that several files
+    // can be read at the same time.
+    std::vector<char> buffer( GERBER_BUFZ + 1 );
+    char*             lineBuffer = buffer.data();
+
     ClearMessageList( );
     ResetDefaultValues();
 
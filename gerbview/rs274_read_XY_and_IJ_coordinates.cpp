@@ -27,6 +27,7 @@
 
 #include <gerber_file_image.h>
 #include <base_units.h>
+#include <number_parser.h>
 
 
 /* These routines read the text string point from Text.
@@ -113,9 +114,9 @@ wxPoint GERBER_FILE_IMAGE::ReadXYCoord( char*& Text, bool aExcellonMode )
             {
                 // When X or Y (or A) values are float numbers, they are given in mm or inches
                 if( m_GerbMetric )  // units are mm
-                    current_coord = KiROUND( atof( line ) * IU_PER_MILS / 0.0254 );
+                    current_coord = KiROUND( StrToDouble( line ) * IU_PER_MILS / 0.0254 );
                 else    // units are inches
-                    current_coord = KiROUND( atof( line ) * IU_PER_MILS * 1000 );
+                    current_coord = KiROUND( StrToDouble( line ) * IU_PER_MILS * 1000 );
             }
             else
             {
@@ -147,7 +148,7 @@ wxPoint GERBER_FILE_IMAGE::ReadXYCoord( char*& Text, bool aExcellonMode )
                     *text = 0;
                 }
 
-                current_coord = atoi( line );
+                current_coord = (int) StrToLong( line );
                 double real_scale = scale_list[fmt_scale];
 
                 if( m_GerbMetric )
@@ -225,9 +226,9 @@ wxPoint GERBER_FILE_IMAGE::ReadIJCoord( char*& Text )
             {
                 // When X or Y values are float numbers, they are given in mm or inches
                 if( m_GerbMetric )  // units are mm
-                    current_coord = KiROUND( atof( line ) * IU_PER_MILS / 0.0254 );
+                    current_coord = KiROUND( StrToDouble( line ) * IU_PER_MILS / 0.0254 );
                 else    // units are inches
-                    current_coord = KiROUND( atof( line ) * IU_PER_MILS * 1000 );
+                    current_coord = KiROUND( StrToDouble( line ) * IU_PER_MILS * 1000 );
             }
             else
             {
@@ -247,7 +248,7 @@ wxPoint GERBER_FILE_IMAGE::ReadIJCoord( char*& Text )
                     *text = 0;
                 }
 
-                current_coord = atoi( line );
+                current_coord = (int) StrToLong( line );
 
                 double real_scale = scale_list[fmt_scale];
 
@@ -290,7 +291,7 @@ int ReadInt( char*& text, bool aSkipSeparator = true )
 {
     int ret;
 
-    // For strtol, a string starting by 0X or 0x is a valid number in hexadecimal or octal.
+    // For StrToLong, a string starting by 0X or 0x is a valid number in hexadecimal or octal.
     // However, 'X'  is a separator in Gerber strings with numbers.
     // We need to detect that
     if( strncasecmp( text, "0X", 2 ) == 0 )
@@ -299,7 +300,7 @@ int ReadInt( char*& text, bool aSkipSeparator = true )
         ret = 0;
     }
     else
-        ret = (int) strtol( text, &text, 10 );
+        ret = (int) StrToLong( text, &text );
 
     if( *text == ',' || isspace( *text ) )
     {
@@ -324,7 +325,7 @@ double ReadDouble( char*& text, bool aSkipSeparator = true )
 {
     double ret;
 
-    // For strtod, a string starting by 0X or 0x is a valid number in hexadecimal or octal.
+    // For StrToDouble, a string starting by 0X or 0x is a valid number in hexadecimal or octal.
     // However, 'X'  is a separator in Gerber strings with numbers.
     // We need to detect that
     if( strncasecmp( text, "0X", 2 ) == 0 )
@@ -333,7 +334,7 @@ double ReadDouble( char*& text, bool aSkipSeparator = true )
         ret = 0.0;
     }
     else
-        ret = strtod( text, &text );
+        ret = StrToDouble( text, &text );
 
     if( *text == ',' || isspace( *text ) )
     {
@@ -339,8 +339,9 @@ static void fillArcPOLY(  GERBER_DRAW_ITEM* aGbrItem,
 {
     /* in order to calculate arc parameters, we use fillArcGBRITEM
      * so we muse create a dummy track and use its geometric parameters
+     * (not a static one: several files can be read at the same time)
      */
-    static GERBER_DRAW_ITEM dummyGbrItem( NULL );
+    GERBER_DRAW_ITEM dummyGbrItem( NULL );
 
     aGbrItem->SetLayerPolarity( aLayerNegative );
 
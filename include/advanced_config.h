@@ -78,6 +78,16 @@ public:
      */
     bool m_realTimeConnectivity;
 
+    /**
+     * Use a spatial index to find the items to test against each track in DRC
+     */
+    bool m_drcSpatialIndex;
+
+    /**
+     * Write the zone fills of the saved boards in a binary cache file next to the board file
+     */
+    bool m_zoneFillCache;
+
     /**
      * Helper to determine if legacy canvas is allowed (according to platform
      * and config)
@@ -165,6 +165,8 @@ private:
 };
 
 
-extern BASIC_GAL basic_gal;
+/// One BASIC_GAL per thread: texts can be converted or plotted by several threads at the same
+/// time (for instance when plotting the layers of a board in parallel)
+extern thread_local BASIC_GAL basic_gal;
 
 #endif      // define BASIC_GAL_H
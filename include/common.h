@@ -181,12 +181,13 @@ public:
     ~LOCALE_IO();
 
 private:
-    // allow for nesting of LOCALE_IO instantiations
-    static std::atomic<unsigned int> m_c_count;
+    // allow for nesting of LOCALE_IO instantiations, also from several threads: the
+    // locale is switched by the first one and restored by the last one, in any order
+    static unsigned int m_c_count;
 
     // The locale in use before switching to the "C" locale
     // (the locale can be set by user, and is not always the system locale)
-    std::string m_user_locale;
+    static std::string m_user_locale;
 };
 
 /**
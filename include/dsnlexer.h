@@ -107,6 +107,7 @@ protected:
 
     int                 curTok;                 ///< the current token obtained on last NextTok()
     std::string         curText;                ///< the text of the current token
+    std::string         curLine;                ///< a nul terminated copy of the current line
 
     const KEYWORD*      keywords;               ///< table sorted by CMake for bsearch()
     unsigned            keywordCount;           ///< count of keywords table
@@ -512,11 +513,13 @@ public:
     /**
      * Function CurLine
      * returns the current line of text, from which the CurText() would return
-     * its token.
+     * its token.  The line is copied, since the lines of some LINE_READERs are
+     * not nul terminated (see MEMORY_LINE_READER).
      */
     const char* CurLine()
     {
-        return (const char*)(*reader);
+        curLine.assign( reader->Line(), reader->Length() );
+        return curLine.c_str();
     }
 
     /**
@@ -152,6 +152,19 @@ public:
      */
     void FootprintEnumerate( wxArrayString& aFootprintNames, const wxString& aNickname );
 
+    /**
+     * Return the name, description, keywords and pad counts of the footprints of the library
+     * given by @a aNickname, without loading the footprints when the library is indexed.
+     *
+     * @param aEntries is the list to fill with the entries of the footprints of \a aNickname
+     *
+     * @param aNickname is a locator for the "library", it is a "name" in LIB_TABLE_ROW.
+     *
+     * @throw IO_ERROR if the library cannot be found, or footprints cannot be loaded.
+     */
+    void EnumerateFootprintIndex( std::vector<FOOTPRINT_INDEX_ENTRY>& aEntries,
+                                  const wxString& aNickname );
+
     /**
      * Generate a hashed timestamp representing the last-mod-times of the library indicated
      * by \a aNickname, or all libraries if \a aNickname is NULL.
@@ -126,6 +126,12 @@ namespace KIGFX
         ///> Force cursor display
         bool m_forceDisplayCursor;
 
+        ///> Screen size (pixels) of the texts below which they are not drawn (0 draws them all)
+        double m_minTextSize;
+
+        ///> Show the duration of each redraw of the view in the status bar
+        bool m_showFrameTime;
+
         ///> The pixel scale factor (>1 for hi-DPI scaled displays)
         double m_scaleFactor;
     };
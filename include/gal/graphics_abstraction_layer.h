@@ -598,6 +598,27 @@ public:
      */
     virtual void ClearCache() {};
 
+    /**
+     * @brief Get a GAL drawing groups into memory, to be copied later with CopyGroup().
+     *
+     * A recorder has no window, so groups can be drawn with it in another thread, each thread
+     * using its own recorder. It uses the view settings of this GAL at the time of the call.
+     * Recorders are owned by this GAL, their groups are kept until their ClearCache().
+     *
+     * @param aIndex is the index of the recorder.
+     * @return the recorder, or nullptr if groups cannot be recorded.
+     */
+    virtual GAL* GetGroupRecorder( unsigned int aIndex ) { return nullptr; };
+
+    /**
+     * @brief Copy a group drawn with a recorder to a new group of this GAL.
+     *
+     * @param aRecorder is a recorder returned by GetGroupRecorder().
+     * @param aGroupNumber is the number of the group in the recorder.
+     * @return the number of the new group.
+     */
+    virtual int CopyGroup( GAL* aRecorder, int aGroupNumber ) { return 0; };
+
     // --------------------------------------------------------
     // Handling the world <-> screen transformation
     // --------------------------------------------------------
@@ -768,6 +789,16 @@ public:
         return worldScale;
     }
 
+    /**
+     * @brief Get the screen size of the texts below which they are not drawn.
+     *
+     * @return the minimal text size, in pixels.
+     */
+    inline double GetMinTextSize() const
+    {
+        return minTextSize;
+    }
+
     /**
      * @brief Sets flipping of the screen.
      *
@@ -1090,6 +1121,9 @@ protected:
     int                gridMinSpacing;         ///< Minimum screen size of the grid (pixels)
                                                ///< below which the grid is not drawn
 
+    double             minTextSize;            ///< Minimum screen size of the texts (pixels)
+                                               ///< below which they are not drawn
+
     // Cursor settings
     bool               isCursorEnabled;        ///< Is the cursor enabled?
     bool               forceDisplayCursor;     ///< Always show cursor
@@ -27,6 +27,8 @@
 
 #include <gal/opengl/vertex_common.h>
 #include <boost/scoped_array.hpp>
+#include <utility>
+#include <vector>
 
 namespace KIGFX
 {
@@ -60,6 +62,14 @@ public:
      */
     virtual void DrawIndices( unsigned int aOffset, unsigned int aSize ) = 0;
 
+    /**
+     * Function DrawInstances()
+     * Makes the GPU draw given range of instance records (see VERTEX_MANAGER::Instance()).
+     * @param aOffset is the beginning of the range.
+     * @param aSize is the number of instance records to be drawn.
+     */
+    virtual void DrawInstances( unsigned int aOffset, unsigned int aSize ) = 0;
+
     /**
      * Function DrawIndices()
      * Makes the GPU draw all the vertices stored in the container.
@@ -100,6 +110,10 @@ protected:
     ///> Location of shader attributes (for glVertexAttribPointer)
     int m_shaderAttrib;
 
+    ///> Location of the coordinates and the color of instance records
+    int m_instanceAttrib;
+    int m_instanceColorAttrib;
+
     ///> true: enable Z test when drawing
     bool m_enableDepthTest;
 };
@@ -117,6 +131,9 @@ public:
     ///> @copydoc GPU_MANAGER::DrawIndices()
     virtual void DrawIndices( unsigned int aOffset, unsigned int aSize ) override;
 
+    ///> @copydoc GPU_MANAGER::DrawInstances()
+    virtual void DrawInstances( unsigned int aOffset, unsigned int aSize ) override;
+
     ///> @copydoc GPU_MANAGER::DrawAll()
     virtual void DrawAll() override;
 
@@ -133,6 +150,9 @@ protected:
     ///> Resizes the indices buffer to aNewSize if necessary
     void resizeIndices( unsigned int aNewSize );
 
+    ///> Draws the instance records of the ranges set with DrawInstances()
+    void drawInstances( GLuint aBuffer );
+
     ///> Buffers initialization flag
     bool m_buffersInitialized;
 
@@ -150,6 +170,12 @@ protected:
 
     ///> Current indices buffer size
     unsigned int m_indicesCapacity;
+
+    ///> Ranges of instance records to be drawn (offset and number of records)
+    std::vector< std::pair<unsigned int, unsigned int> > m_instanceRanges;
+
+    ///> Handle to the buffer with the corners of the instances
+    GLuint  m_cornersBuffer;
 };
 
 
@@ -164,6 +190,9 @@ public:
     ///> @copydoc GPU_MANAGER::DrawIndices()
     virtual void DrawIndices( unsigned int aOffset, unsigned int aSize ) override;
 
+    ///> @copydoc GPU_MANAGER::DrawInstances()
+    virtual void DrawInstances( unsigned int aOffset, unsigned int aSize ) override;
+
     ///> @copydoc GPU_MANAGER::DrawAll()
     virtual void DrawAll() override;
 
@@ -49,7 +49,17 @@ enum SHADER_MODE
     SHADER_LINE_C = 7,
     SHADER_LINE_D = 8,
     SHADER_LINE_E = 9,
-    SHADER_LINE_F = 10
+    SHADER_LINE_F = 10,
+    SHADER_ARC = 11,
+
+    // Instance records, expanded into triangles by the vertex shader (see VERTEX_MANAGER::Instance())
+    SHADER_INSTANCE_FILLED_CIRCLE = 12,     ///< {type, unused, radius, unused} at the center
+    SHADER_INSTANCE_STROKED_CIRCLE = 13,    ///< {type, unused, radius, line width} at the center
+    SHADER_INSTANCE_SEGMENT = 14,           ///< {type, width, end - start} at the start point
+
+    ///> {type - width, radius, start angle, end angle} at the center: the arc width is stored
+    ///> in the type, as any type not greater than SHADER_INSTANCE_ARC is an arc
+    SHADER_INSTANCE_ARC = -1
 };
 
 ///> Data structure for vertices {X,Y,Z,R,G,B,A,shader&param}
@@ -78,6 +88,9 @@ static constexpr size_t SHADER_STRIDE = SHADER_SIZE / sizeof(GLfloat);
 
 static constexpr size_t INDEX_SIZE    = sizeof(GLuint);
 
+///> Number of vertices the vertex shader makes of an instance record (two triangles)
+static constexpr unsigned int INSTANCE_VERTICES = 6;
+
 } // namespace KIGFX
 
 #endif /* VERTEX_COMMON_H_ */
@@ -0,0 +1,327 @@
+/*
+ * This program source code file is part of KICAD, a free EDA CAD application.
+ *
+ * Copyright (C) 2012 Torsten Hueter, torstenhtr <at> gmx.de
+ * Copyright (C) 2012-2019 Kicad Developers, see AUTHORS.txt for contributors.
+ * Copyright (C) 2013-2017 CERN
+ * @author Maciej Suminski <maciej.suminski@cern.ch>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef VERTEX_GAL_H_
+#define VERTEX_GAL_H_
+
+#include <gal/graphics_abstraction_layer.h>
+#include <gal/opengl/vertex_manager.h>
+
+#include <boost/smart_ptr/shared_array.hpp>
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#ifndef CALLBACK
+#define CALLBACK
+#endif
+
+namespace KIGFX
+{
+class NONCACHED_CONTAINER;
+
+/**
+ * @brief Class VERTEX_GAL is the part of the OpenGL GAL turning the drawing commands into
+ * vertices.
+ *
+ * The vertices are stored by currentManager. No OpenGL context is needed to make them, so the
+ * class is shared by OPENGL_GAL and by GROUP_RECORDER, which draws groups in other threads.
+ */
+class VERTEX_GAL : public GAL
+{
+public:
+    virtual ~VERTEX_GAL();
+
+    // ---------------
+    // Drawing methods
+    // ---------------
+
+    /// @copydoc GAL::DrawLine()
+    virtual void DrawLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint ) override;
+
+    /// @copydoc GAL::DrawSegment()
+    virtual void DrawSegment( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint,
+                              double aWidth ) override;
+
+    /// @copydoc GAL::DrawCircle()
+    virtual void DrawCircle( const VECTOR2D& aCenterPoint, double aRadius ) override;
+
+    /// @copydoc GAL::DrawArc()
+    virtual void DrawArc( const VECTOR2D& aCenterPoint, double aRadius,
+                          double aStartAngle, double aEndAngle ) override;
+
+    /// @copydoc GAL::DrawArcSegment()
+    virtual void DrawArcSegment( const VECTOR2D& aCenterPoint, double aRadius,
+                                 double aStartAngle, double aEndAngle, double aWidth ) override;
+
+    /// @copydoc GAL::DrawRectangle()
+    virtual void DrawRectangle( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint ) override;
+
+    /// @copydoc GAL::DrawPolyline()
+    virtual void DrawPolyline( const std::deque<VECTOR2D>& aPointList ) override;
+    virtual void DrawPolyline( const VECTOR2D aPointList[], int aListSize ) override;
+    virtual void DrawPolyline( const SHAPE_LINE_CHAIN& aLineChain ) override;
+
+    /// @copydoc GAL::DrawPolygon()
+    virtual void DrawPolygon( const std::deque<VECTOR2D>& aPointList ) override;
+    virtual void DrawPolygon( const VECTOR2D aPointList[], int aListSize ) override;
+    virtual void DrawPolygon( const SHAPE_POLY_SET& aPolySet ) override;
+    virtual void DrawPolygon( const SHAPE_LINE_CHAIN& aPolySet ) override;
+
+    /// @copydoc GAL::DrawCurve()
+    virtual void DrawCurve( const VECTOR2D& startPoint, const VECTOR2D& controlPointA,
+                            const VECTOR2D& controlPointB, const VECTOR2D& endPoint ) override;
+
+    /// @copydoc GAL::BitmapText()
+    virtual void BitmapText( const wxString& aText, const VECTOR2D& aPosition,
+                             double aRotationAngle ) override;
+
+    // --------------
+    // Transformation
+    // --------------
+
+    /// @copydoc GAL::Rotate()
+    virtual void Rotate( double aAngle ) override;
+
+    /// @copydoc GAL::Translate()
+    virtual void Translate( const VECTOR2D& aTranslation ) override;
+
+    /// @copydoc GAL::Scale()
+    virtual void Scale( const VECTOR2D& aScale ) override;
+
+    /// @copydoc GAL::Save()
+    virtual void Save() override;
+
+    /// @copydoc GAL::Restore()
+    virtual void Restore() override;
+
+    /**
+     * @brief Copies the view settings (world scale, flipping, depth range...) of another GAL,
+     * so that the groups drawn with this one are the same as the groups drawn with aGal.
+     */
+    void CopyViewSettings( const VERTEX_GAL& aGal );
+
+    ///< Parameters passed to the GLU tesselator
+    typedef struct
+    {
+        /// Manager used for storing new vertices
+        VERTEX_MANAGER* vboManager;
+
+        /// Intersect points, that have to be freed after tessellation
+        std::deque< boost::shared_array<GLdouble> >& intersectPoints;
+    } TessParams;
+
+protected:
+    VERTEX_GAL( GAL_DISPLAY_OPTIONS& aDisplayOptions );
+
+    static const int    CIRCLE_POINTS   = 64;   ///< The number of points for circle approximation
+    static const int    CURVE_POINTS    = 32;   ///< The number of points for curve approximation
+
+    VERTEX_MANAGER*         currentManager;     ///< Currently used VERTEX_MANAGER (for storing VERTEX_ITEMs)
+
+    // Polygon tesselation
+    /// The tessellator
+    GLUtesselator*          tesselator;
+    /// Storage for intersecting points
+    std::deque< boost::shared_array<GLdouble> > tessIntersects;
+
+    /**
+     * @brief Draw a quad for the line.
+     *
+     * @param aStartPoint is the start point of the line.
+     * @param aEndPoint is the end point of the line.
+     */
+    void drawLineQuad( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint );
+
+    /**
+     * @brief Store a filled arc centered on the origin as an instance record, if the current
+     * manager takes instance records and the current transformation keeps the arc circular.
+     *
+     * @param aRadius is the radius of the arc.
+     * @param aStartAngle is the start angle of the arc.
+     * @param aEndAngle is the end angle of the arc, greater than aStartAngle.
+     * @param aWidth is the width of the arc.
+     * @return True if the arc was stored, otherwise it has to be drawn with lines.
+     */
+    bool instanceArc( double aRadius, double aStartAngle, double aEndAngle, double aWidth );
+
+    /**
+     * @brief Draw a semicircle. Depending on settings (isStrokeEnabled & isFilledEnabled) it runs
+     * the proper function (drawStrokedSemiCircle or drawFilledSemiCircle).
+     *
+     * @param aCenterPoint is the center point.
+     * @param aRadius is the radius of the semicircle.
+     * @param aAngle is the angle of the semicircle.
+     *
+     */
+    void drawSemiCircle( const VECTOR2D& aCenterPoint, double aRadius, double aAngle );
+
+    /**
+     * @brief Draw a filled semicircle.
+     *
+     * @param aCenterPoint is the center point.
+     * @param aRadius is the radius of the semicircle.
+     * @param aAngle is the angle of the semicircle.
+     *
+     */
+    void drawFilledSemiCircle( const VECTOR2D& aCenterPoint, double aRadius, double aAngle );
+
+    /**
+     * @brief Draw a stroked semicircle.
+     *
+     * @param aCenterPoint is the center point.
+     * @param aRadius is the radius of the semicircle.
+     * @param aAngle is the angle of the semicircle.
+     *
+     */
+    void drawStrokedSemiCircle( const VECTOR2D& aCenterPoint, double aRadius, double aAngle );
+
+    /**
+     * @brief Generic way of drawing a polyline stored in different containers.
+     * @param aPointGetter is a function to obtain coordinates of n-th vertex.
+     * @param aPointCount is the number of points to be drawn.
+     */
+    void drawPolyline( const std::function<VECTOR2D (int)>& aPointGetter, int aPointCount );
+
+    /**
+     * @brief Draws a filled polygon. It does not need the last point to have the same coordinates
+     * as the first one.
+     * @param aPoints is the vertices data (3 coordinates: x, y, z).
+     * @param aPointCount is the number of points.
+     */
+    void drawPolygon( GLdouble* aPoints, int aPointCount );
+
+    /**
+     * @brief Draws a set of polygons with a cached triangulation. Way faster than drawPolygon.
+     */
+    void drawTriangulatedPolyset( const SHAPE_POLY_SET& aPoly );
+
+
+    /**
+     * @brief Draws a single character using bitmap font.
+     * Its main purpose is to be used in BitmapText() function.
+     *
+     * @param aChar is the character to be drawn.
+     * @return Width of the drawn glyph.
+     */
+    int drawBitmapChar( unsigned long aChar );
+
+    /**
+     * @brief Draws an overbar over the currently drawn text.
+     * Its main purpose is to be used in BitmapText() function.
+     * This method requires appropriate scaling to be applied (as is done in BitmapText() function).
+     * The current X coordinate will be the overbar ending.
+     *
+     * @param aLength is the width of the overbar.
+     * @param aHeight is the height for the overbar.
+     */
+    void drawBitmapOverbar( double aLength, double aHeight );
+
+    /**
+     * @brief Computes a size of text drawn using bitmap font with current text setting applied.
+     *
+     * @param aText is the text to be drawn.
+     * @return Pair containing text bounding box and common Y axis offset. The values are expressed
+     * as a number of pixels on the bitmap font texture and need to be scaled before drawing.
+     */
+    std::pair<VECTOR2D, float> computeBitmapTextSize( const UTF8& aText ) const;
+
+    /**
+     * @brief Compute the angle step when drawing arcs/circles approximated with lines.
+     */
+    double calcAngleStep( double aRadius ) const
+    {
+        // Bigger arcs need smaller alpha increment to make them look smooth
+        return std::min( 1e6 / aRadius, 2.0 * M_PI / CIRCLE_POINTS );
+    }
+};
+
+
+/**
+ * @brief Class GROUP_RECORDER is a GAL drawing groups into system memory.
+ *
+ * It has no window nor OpenGL context, so that groups can be drawn in other threads (see
+ * OPENGL_GAL::GetGroupRecorder()). The vertices of its groups are kept until ClearCache().
+ */
+class GROUP_RECORDER : public VERTEX_GAL
+{
+public:
+    GROUP_RECORDER( GAL_DISPLAY_OPTIONS& aDisplayOptions );
+
+    virtual bool IsOpenGlEngine() override { return true; }
+
+    /// @copydoc GAL::BeginGroup()
+    virtual int BeginGroup() override;
+
+    /// @copydoc GAL::EndGroup()
+    virtual void EndGroup() override;
+
+    /// @copydoc GAL::ClearCache()
+    virtual void ClearCache() override;
+
+    /**
+     * @brief Makes the circles, segments and arcs instance records, as they are in the
+     * manager the groups are copied to (see VERTEX_MANAGER::Instance()).
+     */
+    void EnableInstancing( bool aEnabled );
+
+    /**
+     * @brief Returns the vertices of a group, valid until the next drawing or ClearCache().
+     *
+     * @param aGroupNumber is the group number.
+     * @param aSize is set to the number of vertices of the group.
+     * @return Pointer to the vertices of the group.
+     */
+    const VERTEX* GetGroupVertices( int aGroupNumber, unsigned int& aSize ) const;
+
+    /**
+     * @brief Returns the number of instance records at the end of the vertices of a group.
+     */
+    unsigned int GetGroupInstanceCount( int aGroupNumber ) const;
+
+private:
+    ///< Initial size of the container, much smaller than the default one: there is one
+    ///< recorder per thread, and the container grows as needed
+    static const unsigned int INITIAL_SIZE = 65536;
+
+    std::unique_ptr<VERTEX_MANAGER> manager;        ///< Manager storing the recorded vertices
+    NONCACHED_CONTAINER*            container;      ///< Container of the manager
+
+    struct GROUP
+    {
+        unsigned int offset;        ///< First vertex of the group
+        unsigned int size;          ///< Number of vertices, instance records included
+        unsigned int instances;     ///< Number of instance records, after the other vertices
+    };
+
+    std::vector<GROUP>              groups;         ///< Recorded groups
+};
+} // namespace KIGFX
+
+#endif  // VERTEX_GAL_H_
@@ -45,7 +45,7 @@ public:
     friend class CACHED_CONTAINER_GPU;
     friend class VERTEX_MANAGER;
 
-    explicit VERTEX_ITEM( const VERTEX_MANAGER& aManager );
+    explicit VERTEX_ITEM( VERTEX_MANAGER& aManager );
     virtual ~VERTEX_ITEM();
 
     /**
@@ -68,6 +68,16 @@ public:
         return m_offset;
     }
 
+    /**
+     * Function GetInstanceCount()
+     * Returns the number of instance records stored after the vertices of the item.
+     * @return Number of instance records (included in the size).
+     */
+    inline unsigned int GetInstanceCount() const
+    {
+        return m_instances;
+    }
+
     /**
      * Function GetVertices()
      * Returns pointer to the data used by the VERTEX_ITEM.
@@ -75,9 +85,10 @@ public:
     VERTEX* GetVertices() const;
 
 private:
-    const VERTEX_MANAGER&   m_manager;
+    VERTEX_MANAGER&         m_manager;
     unsigned int            m_offset;
     unsigned int            m_size;
+    unsigned int            m_instances;
 
     /**
      * Function SetOffset()
@@ -98,6 +109,16 @@ private:
     {
         m_size = aSize;
     }
+
+    /**
+     * Function setInstanceCount()
+     * Sets the number of instance records stored after the vertices of the item.
+     * @param aInstances is the number of instance records.
+     */
+    inline void setInstanceCount( unsigned int aInstances )
+    {
+        m_instances = aInstances;
+    }
 };
 } // namespace KIGFX
 
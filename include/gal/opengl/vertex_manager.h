@@ -38,6 +38,7 @@
 #include <gal/color4d.h>
 #include <stack>
 #include <memory>
+#include <vector>
 #include <wx/log.h>
 
 namespace KIGFX
@@ -58,6 +59,13 @@ public:
      */
     VERTEX_MANAGER( bool aCached );
 
+    /**
+     * @brief Constructor of a manager storing vertices in a given container.
+     *
+     * @param aContainer is the container, owned by the manager from now on.
+     */
+    VERTEX_MANAGER( VERTEX_CONTAINER* aContainer );
+
     /**
      * Function Map()
      * maps vertex buffer.
@@ -134,6 +142,64 @@ public:
      */
     bool Vertices( const VERTEX aVertices[], unsigned int aSize );
 
+    /**
+     * Function CopyVertices()
+     * adds vertices to the currently set item as they are: unlike Vertices(), the current
+     * color, shader and transformation are not applied, so vertices made by another manager
+     * are copied unchanged.
+     *
+     * @param aVertices contains vertices to be added
+     * @param aSize is the number of vertices to be added.
+     * @return True if successful, false otherwise.
+     */
+    bool CopyVertices( const VERTEX aVertices[], unsigned int aSize );
+
+    /**
+     * Function EnableInstancing()
+     * allows storing instance records with Instance(). They are drawn with instanced rendering,
+     * so it has to be supported by the GPU.
+     *
+     * @param aEnabled tells if instance records may be stored.
+     */
+    inline void EnableInstancing( bool aEnabled )
+    {
+        m_instancing = aEnabled;
+    }
+
+    /**
+     * Function IsInstancing()
+     * returns true if instance records may be stored, otherwise shapes have to be made of
+     * vertices.
+     */
+    inline bool IsInstancing() const
+    {
+        return m_instancing;
+    }
+
+    /**
+     * Function Instance()
+     * adds an instance record (a circle, a segment or an arc, see SHADER_MODE) to the currently
+     * set item. The vertex shader expands it into triangles, so a record replaces the vertices
+     * of a shape. Color & shader parameters set by Color() and Shader() functions are used, the
+     * coordinates have the current transformation matrix applied. Records are stored after the
+     * vertices of the item, when the item is finished.
+     *
+     * @param aX is the X coordinate of the instance.
+     * @param aY is the Y coordinate of the instance.
+     * @param aZ is the Z coordinate of the instance.
+     */
+    void Instance( GLfloat aX, GLfloat aY, GLfloat aZ );
+
+    /**
+     * Function CopyInstances()
+     * adds instance records to the currently set item as they are, as CopyVertices() does
+     * for vertices.
+     *
+     * @param aInstances contains the instance records to be added.
+     * @param aSize is the number of instance records to be added.
+     */
+    void CopyInstances( const VERTEX aInstances[], unsigned int aSize );
+
     /**
      * Function Color()
      * changes currently used color that will be applied to newly added vertices.
@@ -268,13 +334,16 @@ public:
      *
      * @param aItem is the item that is going to store vertices in the container.
      */
-    void SetItem( VERTEX_ITEM& aItem ) const;
+    void SetItem( VERTEX_ITEM& aItem );
 
     /**
      * Function FinishItem()
-     * does the cleaning after adding an item.
+     * stores the instance records added to the item, then does the cleaning after adding
+     * an item.
+     *
+     * @return The number of instance records stored after the vertices of the item.
      */
-    void FinishItem() const;
+    unsigned int FinishItem();
 
     /**
      * Function FreeItem()
@@ -390,6 +459,13 @@ protected:
 
     /// Currently available reserved space
     unsigned int            m_reservedSpace;
+
+    /// True if instance records may be stored
+    bool                    m_instancing;
+    /// Item being modified (set by SetItem())
+    VERTEX_ITEM*            m_item;
+    /// Instance records of the current item, stored by FinishItem()
+    std::vector<VERTEX>     m_instances;
 };
 
 } // namespace KIGFX
@@ -0,0 +1,108 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef __DELAUNAY_TRIANGULATION_H
+#define __DELAUNAY_TRIANGULATION_H
+
+#include <utility>
+#include <vector>
+
+#include <math/vector2d.h>
+
+
+/**
+ * Class DELAUNAY_TRIANGULATION
+ *
+ * Computes the Delaunay triangulation of a set of points with a sweep-hull algorithm (points
+ * are added in the order of their distance to a seed triangle, the triangles are legalized by
+ * edge flips, and the convex hull is kept in a linked list with an angular hash for the
+ * visibility queries).  Everything is stored in flat index arrays: a triangle is 3 consecutive
+ * point indices, and each half-edge knows its opposite half-edge, so a triangulation only
+ * costs a few allocations whatever the number of points.
+ *
+ * Its edges contain the Euclidean minimum spanning tree of the points, which is what the
+ * ratsnest is built from.
+ */
+class DELAUNAY_TRIANGULATION
+{
+public:
+    DELAUNAY_TRIANGULATION() :
+        m_points( nullptr ),
+        m_hashSize( 0 ),
+        m_hullStart( 0 ),
+        m_centerX( 0.0 ),
+        m_centerY( 0.0 )
+    {}
+
+    /**
+     * Triangulate aPoints, which must be distinct.
+     *
+     * @return false, leaving no triangles, if there are less than 3 points or if all the
+     * points are colinear.
+     */
+    bool Triangulate( const std::vector<VECTOR2I>& aPoints );
+
+    /**
+     * @return the triangles, as triples of indices in the points.
+     */
+    const std::vector<int>& GetTriangles() const { return m_triangles; }
+
+    /**
+     * Appends each edge of the triangulation once to aEdges, as a pair of indices in the
+     * points.
+     */
+    void GetEdges( std::vector<std::pair<int, int>>& aEdges ) const;
+
+private:
+    int  addTriangle( int aI0, int aI1, int aI2, int aA, int aB, int aC );
+    void link( int aA, int aB );
+    int  legalize( int aA );
+    int  hashKey( const VECTOR2I& aP ) const;
+
+    const std::vector<VECTOR2I>* m_points;
+
+    ///> point indices, three per triangle
+    std::vector<int>    m_triangles;
+
+    ///> the opposite half-edge of each half-edge, -1 for the hull edges
+    std::vector<int>    m_halfedges;
+
+    ///> the convex hull, as a doubly linked list of point indices
+    std::vector<int>    m_hullPrev;
+    std::vector<int>    m_hullNext;
+
+    ///> the triangle half-edge of each hull edge, by the index of its first point
+    std::vector<int>    m_hullTri;
+
+    ///> points of the hull, by the pseudo-angle around the center
+    std::vector<int>    m_hullHash;
+
+    std::vector<int>    m_edgeStack;
+
+    int    m_hashSize;
+    int    m_hullStart;
+    double m_centerX;
+    double m_centerY;
+};
+
+#endif // __DELAUNAY_TRIANGULATION_H
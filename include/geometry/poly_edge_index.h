@@ -0,0 +1,140 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef __POLY_EDGE_INDEX_H
+#define __POLY_EDGE_INDEX_H
+
+#include <cstdint>
+#include <vector>
+
+#include <geometry/seg.h>
+
+class SHAPE_POLY_SET;
+
+
+/**
+ * Class POLY_EDGE_INDEX
+ *
+ * A spatial index of the edges of all the contours of a SHAPE_POLY_SET, which the set builds
+ * on demand to speed up its point and segment queries when it has many vertices (typically
+ * a zone fill).
+ *
+ * The edges are stored in a uniform grid of cells, each cell listing the edges whose bounding
+ * box overlaps it, for the proximity queries; and in horizontal bands (the rows of the grid),
+ * each band listing the non-horizontal edges spanning it, for the ray casting of the point in
+ * polygon test.  Queries return exactly the same results as the linear scans of SHAPE_POLY_SET
+ * and SHAPE_LINE_CHAIN.
+ *
+ * The index is a snapshot of the set: it is not updated when the set changes.  It is never
+ * modified once built, so it can be queried from several threads.
+ */
+class POLY_EDGE_INDEX
+{
+public:
+    POLY_EDGE_INDEX( const SHAPE_POLY_SET& aSet );
+
+    /**
+     * @return true if aSet is worth indexing and can be indexed: it has enough edges, and
+     * all its contours are closed and have at least 3 vertices.
+     */
+    static bool CanIndex( const SHAPE_POLY_SET& aSet );
+
+    ///> @copydoc SHAPE_POLY_SET::Contains()
+    bool Contains( const VECTOR2I& aP, int aSubpolyIndex = -1, bool aIgnoreHoles = false ) const;
+
+    ///> @copydoc SHAPE_POLY_SET::PointOnEdge()
+    bool PointOnEdge( const VECTOR2I& aP ) const;
+
+    /**
+     * @return true if aSeg crosses an edge of the set, i.e. SEG::Intersect( aSeg, true )
+     * finds an intersection.
+     */
+    bool IntersectsEdge( const SEG& aSeg ) const;
+
+    /**
+     * @return true if an edge of the set is closer than aDist (SEG::Distance() <= aDist)
+     * to the point or segment.
+     */
+    bool IsEdgeCloser( const VECTOR2I& aP, int aDist ) const;
+    bool IsEdgeCloser( const SEG& aSeg, int aDist ) const;
+
+    /**
+     * @return the distance from the point or segment to the closest edge of the
+     * aSubpolyIndex-th polygon of the set (of any polygon if aSubpolyIndex < 0), whether
+     * it is inside the polygon or not.
+     */
+    int EdgeDistance( const VECTOR2I& aP, int aSubpolyIndex = -1 ) const;
+    int EdgeDistance( const SEG& aSeg, int aSubpolyIndex = -1 ) const;
+
+private:
+    struct EDGE
+    {
+        SEG m_seg;
+        int m_polygon;
+        int m_contour;      ///< 0 for the outline, 1 + index of the hole for holes
+    };
+
+    /**
+     * Call aVisitor( EDGE ) for the edges whose bounding box may overlap the given box,
+     * some of them more than once, until aVisitor returns false.
+     * @return false if aVisitor stopped the visit.
+     */
+    template <typename VISITOR>
+    bool visit( int64_t aLeft, int64_t aTop, int64_t aRight, int64_t aBottom,
+                VISITOR aVisitor ) const;
+
+    /**
+     * Find the smallest aDistance( SEG ) over the edges of the aSubpolyIndex-th polygon, for
+     * a query object whose bounding box is given.
+     */
+    template <typename DISTANCE>
+    int edgeDistance( int64_t aLeft, int64_t aTop, int64_t aRight, int64_t aBottom,
+                      int aSubpolyIndex, DISTANCE aDistance ) const;
+
+    int column( int64_t aX ) const;
+    int row( int64_t aY ) const;
+
+    std::vector<EDGE> m_edges;
+
+    // Bounding box of the set
+    int               m_left;
+    int               m_top;
+    int               m_right;
+    int               m_bottom;
+
+    int               m_columns;
+    int               m_rows;
+    int               m_cellWidth;
+    int               m_cellHeight;
+
+    /// The edges of the cell ii are m_cellEdges[ m_cellStart[ii] .. m_cellStart[ii + 1] - 1 ],
+    /// cells being stored row by row
+    std::vector<int>  m_cellStart;
+    std::vector<int>  m_cellEdges;
+
+    /// Same for the edges spanning each row
+    std::vector<int>  m_rowStart;
+    std::vector<int>  m_rowEdges;
+};
+
+#endif  // __POLY_EDGE_INDEX_H
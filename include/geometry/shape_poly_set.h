@@ -26,6 +26,7 @@
 #ifndef __SHAPE_POLY_SET_H
 #define __SHAPE_POLY_SET_H
 
+#include <atomic>
 #include <vector>
 #include <cstdio>
 #include <memory>
@@ -34,6 +35,7 @@
 
 #include <md5_hash.h>
 
+class POLY_EDGE_INDEX;
 
 /**
  * Class SHAPE_POLY_SET
@@ -49,7 +51,11 @@
  *      outline or a hole.
  *      - Vertex (or corner): each one of the points that define a contour.
  *
- * TODO: add convex partitioning & spatial index
+ * Large sets queried many times (e.g. zone fills in DRC) can use a spatial index of their edges
+ * (see POLY_EDGE_INDEX) to answer Contains(), PointOnEdge(), Collide() and Distance() queries
+ * without scanning all edges: see EnableEdgeIndex().
+ *
+ * TODO: add convex partitioning
  */
 class SHAPE_POLY_SET : public SHAPE
 {
@@ -110,6 +116,16 @@ class SHAPE_POLY_SET : public SHAPE
                 return m_vertices.size();
             }
 
+            const TRI& GetTri( int index ) const
+            {
+                return m_triangles[ index ];
+            }
+
+            const VECTOR2I& GetVertex( int index ) const
+            {
+                return m_vertices[ index ];
+            }
+
         private:
 
             std::deque<TRI> m_triangles;
@@ -226,7 +242,7 @@ class SHAPE_POLY_SET : public SHAPE
 
             T& Get()
             {
-                return m_poly->Polygon( m_currentPolygon )[m_currentContour].Point( m_currentVertex );
+                return m_poly->m_polys[m_currentPolygon][m_currentContour].Point( m_currentVertex );
             }
 
             T& operator*()
@@ -348,7 +364,7 @@ class SHAPE_POLY_SET : public SHAPE
 
             T Get()
             {
-                return m_poly->Polygon( m_currentPolygon )[m_currentContour].Segment( m_currentSegment );
+                return m_poly->CPolygon( m_currentPolygon )[m_currentContour].CSegment( m_currentSegment );
             }
 
             T operator*()
@@ -574,6 +590,7 @@ class SHAPE_POLY_SET : public SHAPE
         ///> Returns the reference to aIndex-th outline in the set
         SHAPE_LINE_CHAIN& Outline( int aIndex )
         {
+            invalidateEdgeIndex();
             return m_polys[aIndex][0];
         }
 
@@ -596,12 +613,14 @@ class SHAPE_POLY_SET : public SHAPE
         ///> Returns the reference to aHole-th hole in the aIndex-th outline
         SHAPE_LINE_CHAIN& Hole( int aOutline, int aHole )
         {
+            invalidateEdgeIndex();
             return m_polys[aOutline][aHole + 1];
         }
 
         ///> Returns the aIndex-th subpolygon in the set
         POLYGON& Polygon( int aIndex )
         {
+            invalidateEdgeIndex();
             return m_polys[aIndex];
         }
 
@@ -644,6 +663,8 @@ class SHAPE_POLY_SET : public SHAPE
         {
             ITERATOR iter;
 
+            invalidateEdgeIndex();
+
             iter.m_poly = this;
             iter.m_currentPolygon = aFirst;
             iter.m_lastPolygon = aLast < 0 ? OutlineCount() - 1 : aLast;
@@ -756,6 +777,8 @@ class SHAPE_POLY_SET : public SHAPE
         {
             SEGMENT_ITERATOR iter;
 
+            invalidateEdgeIndex();
+
             iter.m_poly = this;
             iter.m_currentPolygon = aFirst;
             iter.m_lastPolygon = aLast < 0 ? OutlineCount() - 1 : aLast;
@@ -790,6 +813,35 @@ class SHAPE_POLY_SET : public SHAPE
             return IterateSegments( aOutline, aOutline, true );
         }
 
+        ///> Returns an iterator object, for iterating between aFirst and aLast outline, with or
+        /// without holes (default: without), which cannot modify the set
+        CONST_SEGMENT_ITERATOR CIterateSegments( int aFirst, int aLast,
+                                                 bool aIterateHoles = false ) const
+        {
+            CONST_SEGMENT_ITERATOR iter;
+
+            iter.m_poly = const_cast<SHAPE_POLY_SET*>( this );
+            iter.m_currentPolygon = aFirst;
+            iter.m_lastPolygon = aLast < 0 ? OutlineCount() - 1 : aLast;
+            iter.m_currentContour = 0;
+            iter.m_currentSegment = 0;
+            iter.m_iterateHoles = aIterateHoles;
+
+            return iter;
+        }
+
+        ///> Returns a const iterator object, for all outlines in the set (with holes)
+        CONST_SEGMENT_ITERATOR CIterateSegmentsWithHoles() const
+        {
+            return CIterateSegments( 0, OutlineCount() - 1, true );
+        }
+
+        ///> Returns a const iterator object, for the aOutline-th outline in the set (with holes)
+        CONST_SEGMENT_ITERATOR CIterateSegmentsWithHoles( int aOutline ) const
+        {
+            return CIterateSegments( aOutline, aOutline, true );
+        }
+
         /** operations on polygons use a aFastMode param
          * if aFastMode is PM_FAST (true) the result can be a weak polygon
          * if aFastMode is PM_STRICTLY_SIMPLE (false) (default) the result is (theorically) a strictly
@@ -1061,7 +1113,7 @@ class SHAPE_POLY_SET : public SHAPE
          * @return int -  The minimum distance between aPoint and all the segments of the aIndex-th
          *                polygon. If the point is contained in the polygon, the distance is zero.
          */
-        int DistanceToPolygon( VECTOR2I aPoint, int aIndex );
+        int DistanceToPolygon( VECTOR2I aPoint, int aIndex ) const;
 
         /**
          * Function DistanceToPolygon
@@ -1075,7 +1127,7 @@ class SHAPE_POLY_SET : public SHAPE
          *                  aIndex-th polygon. If the point is contained in the polygon, the
          *                  distance is zero.
          */
-        int DistanceToPolygon( SEG aSegment, int aIndex, int aSegmentWidth = 0 );
+        int DistanceToPolygon( SEG aSegment, int aIndex, int aSegmentWidth = 0 ) const;
 
         /**
          * Function DistanceToPolygon
@@ -1084,7 +1136,7 @@ class SHAPE_POLY_SET : public SHAPE
          * @return int -  The minimum distance between aPoint and all the polygons in the set. If
          *                the point is contained in any of the polygons, the distance is zero.
          */
-        int Distance( VECTOR2I aPoint );
+        int Distance( VECTOR2I aPoint ) const;
 
         /**
          * Function DistanceToPolygon
@@ -1094,7 +1146,7 @@ class SHAPE_POLY_SET : public SHAPE
          * @return int -    The minimum distance between aSegment and all the polygons in the set.
          *                  If the point is contained in the polygon, the distance is zero.
          */
-        int Distance( const SEG& aSegment, int aSegmentWidth = 0 );
+        int Distance( const SEG& aSegment, int aSegmentWidth = 0 ) const;
 
         /**
          * Function IsVertexInHole.
@@ -1149,6 +1201,42 @@ class SHAPE_POLY_SET : public SHAPE
          */
         bool containsSingle( const VECTOR2I& aP, int aSubpolyIndex, bool aIgnoreHoles = false ) const;
 
+        /**
+         * Function edgeIndex
+         * @return the edge index of the set, building it if it is enabled and the set has been
+         * queried often enough since its last change to be worth it, or nullptr if the queries
+         * must scan the edges.  The caller shares the ownership of the index, which another
+         * thread may drop meanwhile.
+         */
+        std::shared_ptr<const POLY_EDGE_INDEX> edgeIndex() const;
+
+        ///> Drops the edge index, before a change of the set
+        void invalidateEdgeIndex()
+        {
+            if( m_edgeIndexQueries.load( std::memory_order_relaxed ) != 0 )
+                clearEdgeIndex();
+        }
+
+        void clearEdgeIndex() const;
+
+        /**
+         * Function isEdgeCloser
+         * @return true if an edge of the set is closer to the point or segment than aClearance,
+         * plus the error of Inflate().  A point or segment outside of the set, for which it is
+         * false, does not collide with the set inflated by aClearance.
+         */
+        template <typename T>
+        bool isEdgeCloser( const T& aObject, int aClearance ) const;
+
+        /**
+         * Function inflated
+         * @return a copy of the set inflated by aClearance with 8 segments per circle, as
+         * tested by Collide().  A set with an edge index keeps the last one it has built.
+         */
+        std::shared_ptr<const SHAPE_POLY_SET> inflated( int aClearance ) const;
+
+        struct INFLATED_SET;
+
         /**
          * Operations ChamferPolygon and FilletPolygon are computed under the private chamferFillet
          * method; this enum is defined to make the necessary distinction when calling this method
@@ -1193,6 +1281,26 @@ class SHAPE_POLY_SET : public SHAPE
         void CacheTriangulation();
         bool IsTriangulationUpToDate() const;
 
+        /**
+         * Function SetTriangulation
+         * replaces the cached triangulation by aPolys, a triangulation of the current polygons
+         * computed earlier by CacheTriangulation() (e.g. stored in a file), so that it is not
+         * computed again.
+         */
+        void SetTriangulation( std::vector<std::unique_ptr<TRIANGULATED_POLYGON>>&& aPolys );
+
+        /**
+         * Function EnableEdgeIndex
+         * lets the Contains(), PointOnEdge(), Collide() and Distance() queries use an index of
+         * the edges of the set, built once the set has been queried a few times since its last
+         * change.  It is worth it for large sets queried many times, e.g. the zone fills tested
+         * against each other by the DRC.
+         * The index is dropped by the methods modifying the set, including the ones returning
+         * non-const references to its contours or vertices: such references must not be kept
+         * to change the set after it has been queried.
+         */
+        void EnableEdgeIndex( bool aEnable = true );
+
         MD5_HASH GetHash() const;
 
     private:
@@ -1203,6 +1311,17 @@ class SHAPE_POLY_SET : public SHAPE
         bool m_triangulationValid = false;
         MD5_HASH m_hash;
 
+        /// See EnableEdgeIndex()
+        bool m_edgeIndexEnabled = false;
+
+        /// Built by the const queries, hence the atomic accesses: several threads may query
+        /// the set.  Only read and written with std::atomic_load() and std::atomic_store().
+        mutable std::shared_ptr<const POLY_EDGE_INDEX> m_edgeIndex;
+        mutable std::atomic<int> m_edgeIndexQueries{ 0 };
+
+        /// See inflated().  Dropped with the edge index.
+        mutable std::shared_ptr<const INFLATED_SET> m_inflatedSet;
+
 };
 
 #endif
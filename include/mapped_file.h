@@ -0,0 +1,67 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <vector>
+
+#include <wx/string.h>
+
+
+/**
+ * Class MAPPED_FILE
+ * maps a whole file in memory, read only, so it can be read by several threads at once
+ * without copying it.  If the system cannot map the file, it is read into memory instead.
+ */
+class MAPPED_FILE
+{
+public:
+    /**
+     * @throw IO_ERROR if the file cannot be opened or read.
+     */
+    MAPPED_FILE( const wxString& aFileName );
+    ~MAPPED_FILE();
+
+    MAPPED_FILE( const MAPPED_FILE& ) = delete;
+    MAPPED_FILE& operator=( const MAPPED_FILE& ) = delete;
+
+    const char* Data() const { return m_data; }
+    size_t Size() const { return m_size; }
+
+    const wxString& GetFileName() const { return m_fileName; }
+
+private:
+    bool map();
+    void read();
+
+    wxString          m_fileName;
+    const char*       m_data;
+    size_t            m_size;
+
+    void*             m_view;       ///< the mapped view, if the file is mapped
+    std::vector<char> m_copy;       ///< the file contents, if the file could not be mapped
+};
+
+#endif  // MAPPED_FILE_H
@@ -0,0 +1,73 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file number_parser.h
+ * @brief Locale independent conversions of text to numbers, for the file readers.
+ *
+ * These behave like strtod() and strtol() (base 10) in the "C" locale, whatever the current
+ * locale is: the decimal separator is always a dot.  Most numbers found in KiCad and Gerber
+ * files are converted without calling the C library, several times faster than strtod();
+ * the others are handed over to strtod().
+ */
+
+#ifndef NUMBER_PARSER_H
+#define NUMBER_PARSER_H
+
+
+/**
+ * Function StrToDouble
+ * converts the text at @a aText to a double, like strtod() in the "C" locale.
+ *
+ * @param aText is the text to convert.  Leading white space is skipped.
+ * @param aEnd if not NULL, is set to the character following the number, or to @a aText if
+ *  there is no number.
+ * @return the converted value, correctly rounded.  errno is set to ERANGE if the value
+ *  overflows or underflows, and left untouched otherwise.
+ */
+double StrToDouble( const char* aText, const char** aEnd = nullptr );
+
+inline double StrToDouble( char* aText, char** aEnd )
+{
+    return StrToDouble( aText, const_cast<const char**>( aEnd ) );
+}
+
+
+/**
+ * Function StrToLong
+ * converts the text at @a aText to a long, like strtol() in base 10.
+ *
+ * @param aText is the text to convert.  Leading white space is skipped.
+ * @param aEnd if not NULL, is set to the character following the number, or to @a aText if
+ *  there is no number.
+ * @return the converted value.  On overflow, LONG_MAX or LONG_MIN is returned and errno is
+ *  set to ERANGE; errno is left untouched otherwise.
+ */
+long StrToLong( const char* aText, const char** aEnd = nullptr );
+
+inline long StrToLong( char* aText, char** aEnd )
+{
+    return StrToLong( aText, const_cast<const char**>( aEnd ) );
+}
+
+#endif  // NUMBER_PARSER_H
@@ -354,6 +354,18 @@ public:
      */
     virtual bool Draw( const VIEW_ITEM* aItem, int aLayer ) = 0;
 
+    /**
+     * Function Clone
+     * Creates a copy of the painter, with the same settings, drawing on another GAL. Copies
+     * are used to draw items in other threads, so they must not share any mutable state.
+     * @param aGal is the GAL used by the copy.
+     * @return The copy (owned by the caller), or nullptr if the painter cannot be copied.
+     */
+    virtual PAINTER* Clone( GAL* aGal ) const
+    {
+        return nullptr;
+    }
+
 protected:
     /// Instance of graphic abstraction layer that gives an interface to call
     /// commands used to draw (eg. DrawLine, DrawCircle, etc.)
@@ -32,7 +32,13 @@
 #ifndef PLOT_COMMON_H_
 #define PLOT_COMMON_H_
 
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
 #include <vector>
+#include <unordered_map>
 #include <math/box2.h>
 #include <draw_graphic_text.h>
 #include <page_info.h>
@@ -41,6 +47,7 @@
 class SHAPE_POLY_SET;
 class SHAPE_LINE_CHAIN;
 class GBR_NETLIST_METADATA;
+class TASK_GROUP;
 
 /**
  * Enum PlotFormat
@@ -453,6 +460,21 @@ public:
      */
     virtual void EndBlock( void* aData ) {}
 
+    /**
+     * Start a group of drawing items plotted the same way several times in the same
+     * plot (e.g. the frame of the worksheet on each page), which plotters able to
+     * reference a previously plotted group (PDF form XObjects) output only once.
+     * The group must not contain texts, and the pen must be up.
+     * for most of plotters: do nothing
+     */
+    virtual void StartReusableBlock() {}
+
+    /**
+     * End the group of drawing items started by StartReusableBlock()
+     * for most of plotters: do nothing
+     */
+    virtual void EndReusableBlock() {}
+
 
 protected:
     // These are marker subcomponents
@@ -734,6 +756,9 @@ protected:
                                       std::vector<int> *pos_pairs );
     void fputsPostscriptString(FILE *fout, const wxString& txt);
 
+    /// @return txt escaped for postscript/PDF, with its enclosing parentheses
+    std::string encodePostscriptString( const wxString& txt );
+
     /// Virtual primitive for emitting the setrgbcolor operator
     virtual void emitSetRGBColor( double r, double g, double b ) = 0;
 
@@ -812,12 +837,8 @@ protected:
 class PDF_PLOTTER : public PSLIKE_PLOTTER
 {
 public:
-    PDF_PLOTTER() : pageStreamHandle( 0 ), workFile( NULL )
-    {
-        // Avoid non initialized variables:
-        pageStreamHandle = streamLengthHandle = fontResDictHandle = 0;
-        pageTreeHandle = 0;
-    }
+    PDF_PLOTTER();
+    ~PDF_PLOTTER();
 
     virtual PlotFormat GetPlotterType() const override
     {
@@ -880,21 +901,83 @@ public:
     virtual void PlotImage( const wxImage& aImage, const wxPoint& aPos,
                             double aScaleFactor ) override;
 
+    /**
+     * The items of the block are plotted once in a form XObject, shared by all
+     * the identical blocks of the document
+     */
+    virtual void StartReusableBlock() override;
+    virtual void EndReusableBlock() override;
+
+    // Pads of the same shape share a form XObject, flashed at the pad position
+    virtual void FlashPadCircle( const wxPoint& aPadPos, int aDiameter,
+                                 EDA_DRAW_MODE_T aTraceMode, void* aData ) override;
+    virtual void FlashPadOval( const wxPoint& aPadPos, const wxSize& aSize, double aPadOrient,
+                               EDA_DRAW_MODE_T aTraceMode, void* aData ) override;
+    virtual void FlashPadRect( const wxPoint& aPadPos, const wxSize& aSize,
+                               double aPadOrient, EDA_DRAW_MODE_T aTraceMode,
+                               void* aData ) override;
+    virtual void FlashPadRoundRect( const wxPoint& aPadPos, const wxSize& aSize,
+                                    int aCornerRadius, double aOrient,
+                                    EDA_DRAW_MODE_T aTraceMode, void* aData ) override;
+    virtual void FlashPadTrapez( const wxPoint& aPadPos, const wxPoint *aCorners,
+                                 double aPadOrient, EDA_DRAW_MODE_T aTraceMode,
+                                 void* aData ) override;
 
 protected:
+    /// A stream object, waiting for its content to be compressed
+    struct PDF_STREAM
+    {
+        int         m_Handle;       ///< The handle of the stream object
+        std::string m_Dictionary;   ///< The entries of the stream dictionary, but the length
+        std::string m_Data;         ///< The content, compressed once m_Encoded is set
+        std::atomic<bool> m_Encoded;
+    };
+
     virtual void emitSetRGBColor( double r, double g, double b ) override;
     int allocPdfObject();
     int startPdfObject(int handle = -1);
     void closePdfObject();
-    int startPdfStream(int handle = -1);
-    void closePdfStream();
+
+    /**
+     * Queue the compression of the stream aData, written later as the object aHandle
+     * with the dictionary entries aDictionary
+     */
+    void queuePdfStream( int aHandle, const std::string& aDictionary, std::string& aData );
+
+    /**
+     * Write the compressed streams, in order, waiting for them if aWait is true
+     * (else only the ones already compressed)
+     */
+    void writePdfStreams( bool aWait );
+
+    void startForm();
+
+    /**
+     * Close the form started by startForm(), and draw it (translated by aOffset)
+     * in the page
+     * @param aBBox is the bounding box of the form content, in device units
+     */
+    void endForm( const DPOINT& aOffset, const BOX2D& aBBox );
+
+    /**
+     * Plot a pad with aFlash, in a form XObject drawn at aPadPos
+     * @param aRadius is the radius of a circle around the pad
+     */
+    void flashPadForm( const wxPoint& aPadPos, int aRadius, const std::function<void()>& aFlash );
+
     int pageTreeHandle;		 /// Handle to the root of the page tree object
     int fontResDictHandle;	 /// Font resource dictionary
+    int xObjectResDictHandle;    /// Form XObject resource dictionary
     std::vector<int> pageHandles;/// Handles to the page objects
     int pageStreamHandle;	 /// Handle of the page content object
-    int streamLengthHandle;      /// Handle to the deferred stream length
-    wxString workFilename;
-    FILE* workFile;  	         /// Temporary file to costruct the stream before zipping
+    std::string pageStream;      /// Content of the current page, before zipping
+    std::string formStream;      /// Content of the current form, before zipping
+    std::string* workStream;     /// The stream being plotted (page or form)
+    int savedPenWidth;           /// The page pen width, while plotting a form
+    std::unordered_map<std::string, int> formIndex; /// Form numbers by content
+    std::vector<int> formHandles;/// Handles to the form XObjects
+    std::deque<PDF_STREAM> pendingStreams; /// Streams not written yet
+    std::unique_ptr<TASK_GROUP> encoder;   /// Compression of the streams
     std::vector<long> xrefTable; /// The PDF xref offset table
 };
 
@@ -1012,14 +1095,18 @@ class APERTURE
 {
 public:
     enum APERTURE_TYPE {
-        Circle   = 1,
-        Rect     = 2,
-        Plotting = 3,
-        Oval     = 4
+        Circle    = 1,
+        Rect      = 2,
+        Plotting  = 3,
+        Oval      = 4,
+        RotRect   = 5,        // rotated rect, defined by an aperture macro
+        RoundRect = 6         // rotated rect with rounded corners, defined by an aperture macro
     };
 
     wxSize        m_Size;     // horiz and Vert size
     APERTURE_TYPE m_Type;     // Type ( Line, rect , circulaire , ovale .. )
+    int           m_Radius;   // corner radius of RoundRect apertures
+    double        m_Rotation; // rotation in degrees of RotRect and RoundRect apertures
     int           m_DCode;    // code number ( >= 10 );
     int           m_ApertureAttribute;  // the attribute attached to this aperture
                                         // Only one attribute is allowed by aperture
@@ -1109,17 +1196,14 @@ public:
     virtual void FlashPadOval( const wxPoint& pos, const wxSize& size, double orient,
                                EDA_DRAW_MODE_T trace_mode, void* aData ) override;
     /**
-     * Filled rect flashes are handled as aperture in the 0 90 180 or 270 degree orientation only
-     * and as polygon for other orientations
-     * TODO: always use flashed shapes (aperture macros)
+     * Filled rect flashes are handled as aperture in the 0 90 180 or 270 degree orientation,
+     * and as a rotated rect aperture macro for other orientations
      */
     virtual void FlashPadRect( const wxPoint& pos, const wxSize& size,
                                double orient, EDA_DRAW_MODE_T trace_mode, void* aData ) override;
 
     /**
-     * Roundrect pad at the moment are not handled as aperture, since
-     * they require aperture macros
-     * TODO: always use flashed shapes (aperture macros)
+     * Filled roundrect flashes are handled as a roundrect aperture macro
      */
     virtual void FlashPadRoundRect( const wxPoint& aPadPos, const wxSize& aSize,
                                     int aCornerRadius, double aOrient,
@@ -1178,7 +1262,18 @@ protected:
      * write the DCode selection on gerber file
      */
     void selectAperture( const wxSize& aSize, APERTURE::APERTURE_TYPE aType,
-                         int aApertureAttribute );
+                         int aApertureAttribute )
+    {
+        selectAperture( aSize, 0, 0.0, aType, aApertureAttribute );
+    }
+
+    /**
+     * Pick an existing aperture or create a new one, matching the size, corner radius,
+     * rotation, type and attributes (for the apertures defined by a macro)
+     * write the DCode selection on gerber file
+     */
+    void selectAperture( const wxSize& aSize, int aRadius, double aRotation,
+                         APERTURE::APERTURE_TYPE aType, int aApertureAttribute );
 
     /**
      * Emit a D-Code record, using proper conversions
@@ -1206,12 +1301,14 @@ protected:
      * Function getAperture returns a reference to the aperture which meets the size anf type of tool
      * if the aperture does not exist, it is created and entered in aperture list
      * @param aSize = the size of tool
+     * @param aRadius = the corner radius of tool (RoundRect only)
+     * @param aRotation = the rotation of tool, in degrees (RotRect and RoundRect only)
      * @param aType = the type ( shape ) of tool
      * @param aApertureAttribute = an aperture attribute of the tool (a tool can have onlu one attribute)
      * 0 = no specific attribute
      */
-    std::vector<APERTURE>::iterator getAperture( const wxSize& aSize,
-                    APERTURE::APERTURE_TYPE aType, int aApertureAttribute );
+    std::vector<APERTURE>::iterator getAperture( const wxSize& aSize, int aRadius,
+                    double aRotation, APERTURE::APERTURE_TYPE aType, int aApertureAttribute );
 
     // the attributes dictionnary created/modifed by %TO, attached the objects, when they are created
     // by D01, D03 G36/G37 commands
@@ -1234,9 +1331,24 @@ protected:
      */
     void writeApertureList();
 
+    /// Hash and comparison of the shape and attribute of apertures (the D code is ignored)
+    struct APERTURE_HASH
+    {
+        size_t operator()( const APERTURE& aAperture ) const;
+    };
+
+    struct APERTURE_EQUAL
+    {
+        bool operator()( const APERTURE& aFirst, const APERTURE& aSecond ) const;
+    };
+
     std::vector<APERTURE>           apertures;
     std::vector<APERTURE>::iterator currentAperture;
 
+    /// The index in apertures of each aperture, so that finding the aperture of an item
+    /// does not depend on the number of apertures
+    std::unordered_map<APERTURE, size_t, APERTURE_HASH, APERTURE_EQUAL> m_apertureIndex;
+
     bool     m_gerberUnitInch;  // true if the gerber units are inches, false for mm
     int      m_gerberUnitFmt;   // number of digits in mantissa.
                                 // usually 6 in Inches and 5 or 6  in mm
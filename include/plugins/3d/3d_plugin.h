@@ -39,7 +39,7 @@
 // Note: the plugin class name must match the name expected by the loader
 #define KICAD_PLUGIN_CLASS "PLUGIN_3D"
 #define MAJOR 1
-#define MINOR 0
+#define MINOR 1
 #define REVISION 0
 #define PATCH 0
 
@@ -131,4 +131,15 @@ KICAD_PLUGIN_EXPORT bool CanRender( void );
  */
 KICAD_PLUGIN_EXPORT SCENEGRAPH* Load( char const* aFileName );
 
+/**
+ * Function IsThreadSafe
+ * is optional (since version 1.1): the plugins which do not export it are
+ * called by one thread at a time.
+ *
+ * @return true if Load() may be called by several threads at once, that is if
+ * the plugin switches no process wide state (such as the locale) and fills no
+ * shared tables while it reads a model
+ */
+KICAD_PLUGIN_EXPORT bool IsThreadSafe( void );
+
 #endif  // PLUGIN_3D_H
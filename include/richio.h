@@ -29,6 +29,7 @@
 // "richio" after its author, Richard Hollenbeck, aka Dick Hollenbeck.
 
 
+#include <memory>
 #include <vector>
 #include <utf8.h>
 
@@ -39,6 +40,8 @@
 
 #include <ki_exception.h>
 
+class MAPPED_FILE;
+
 
 /**
  * Function StrPrintf
@@ -283,6 +286,100 @@ public:
 };
 
 
+/**
+ * Class MEMORY_LINE_READER
+ * is a LINE_READER that reads from a buffer it does not own, typically a MAPPED_FILE.
+ * Ranges of the buffer can be skipped, so that they can be read by other readers (e.g. from
+ * other threads) while this one reads the text around them.
+ * <p>
+ * Lines are not copied: unlike the other LINE_READERs, the returned line is a read only view
+ * into the buffer, which ends with its '\n' but is <b>not nul terminated</b>; use Length().
+ * Only the last line of the buffer, if it has no '\n', and the lines joined around skipped
+ * ranges are copied, and are nul terminated.
+ */
+class MEMORY_LINE_READER : public LINE_READER
+{
+protected:
+    const char*     m_buffer;
+    size_t          m_size;
+    size_t          m_ndx;
+    unsigned        m_startingLineNum;
+
+    /// Ranges [first, second) of the buffer which are not read, sorted
+    std::vector< std::pair<size_t, size_t> > m_skipped;
+    size_t          m_nextSkipped;
+
+    char*           m_ownLine;      ///< the line buffer, when m_line is a view into m_buffer
+
+public:
+
+    /**
+     * Constructor MEMORY_LINE_READER
+     *
+     * @param aBuffer is the text to read, which must outlive the reader.
+     * @param aSize is the number of bytes of aBuffer.
+     * @param aSource describes the source of the text for error reporting purposes.
+     * @param aStartingLineNumber is the line number of the line before aBuffer, when aBuffer
+     *  is a part of a file.  The first reported line number is one greater.
+     */
+    MEMORY_LINE_READER( const char* aBuffer, size_t aSize, const wxString& aSource,
+                        unsigned aStartingLineNumber = 0 );
+
+    ~MEMORY_LINE_READER();
+
+    char* ReadLine() override;
+
+    /**
+     * Function Rewind
+     * restarts reading at the beginning of the buffer, and resets the line number back to
+     * the starting line number.  Skipped ranges are still skipped.
+     */
+    void Rewind();
+
+    /**
+     * Function Skip
+     * leaves out the bytes [aStart, aEnd) of the buffer: the line holding aStart is
+     * continued by the text following aEnd.  Line numbers still count the lines of the
+     * skipped text.  Ranges must be given in increasing order, after the text read so far.
+     */
+    void Skip( size_t aStart, size_t aEnd );
+
+    const char* Buffer() const { return m_buffer; }
+    size_t Size() const { return m_size; }
+
+    /**
+     * Function Position
+     * returns the offset in the buffer of the first byte not read yet.
+     */
+    size_t Position() const { return m_ndx; }
+};
+
+
+/**
+ * Class MMAP_LINE_READER
+ * is a MEMORY_LINE_READER which reads a whole file mapped in memory, see MAPPED_FILE.
+ * Its lines are views into the mapped file, so reading a file does not copy it.
+ */
+class MMAP_LINE_READER : public MEMORY_LINE_READER
+{
+    std::unique_ptr<MAPPED_FILE> m_file;
+
+    MMAP_LINE_READER( MAPPED_FILE* aFile );
+
+public:
+
+    /**
+     * Constructor MMAP_LINE_READER
+     * maps the file @a aFileName.
+     *
+     * @throw IO_ERROR if the file cannot be opened or read.
+     */
+    MMAP_LINE_READER( const wxString& aFileName );
+
+    ~MMAP_LINE_READER();
+};
+
+
 /**
  * Class INPUTSTREAM_LINE_READER
  * is a LINE_READER that reads from a wxInputStream object.
@@ -0,0 +1,207 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class PROGRESS_REPORTER;
+class TASK_GROUP;
+
+
+/**
+ * Class THREAD_POOL
+ *
+ * A fixed set of worker threads, started once, which run the tasks of TASK_GROUPs.
+ *
+ * Each worker has its own task queue: tasks queued from a worker go to the worker's own
+ * queue, tasks queued from any other thread go to a shared queue, and an idle worker
+ * steals the oldest task of a busy one.  A thread waiting for a TASK_GROUP runs the queued
+ * tasks of this group and of the groups nested in it itself instead of blocking, so nested
+ * parallel loops do not need extra threads and cannot deadlock the pool.  It never runs the
+ * tasks of unrelated groups, which may take much longer than the ones it waits for.
+ */
+class THREAD_POOL
+{
+public:
+    /**
+     * @return the pool shared by all the parallel algorithms of the program, with one
+     * worker per hardware thread.
+     */
+    static THREAD_POOL& GetInstance();
+
+    THREAD_POOL( size_t aThreadCount );
+    ~THREAD_POOL();
+
+    THREAD_POOL( const THREAD_POOL& ) = delete;
+    THREAD_POOL& operator=( const THREAD_POOL& ) = delete;
+
+    /**
+     * @return the number of worker threads, i.e. the number of tasks worth queueing at
+     * once for a parallel loop.
+     */
+    size_t GetThreadCount() const { return m_threads.size(); }
+
+private:
+    friend class TASK_GROUP;
+
+    struct TASK
+    {
+        std::function<void()> m_func;
+        TASK_GROUP*           m_group;
+    };
+
+    struct TASK_QUEUE
+    {
+        std::mutex       m_mutex;
+        std::deque<TASK> m_tasks;
+    };
+
+    void submit( TASK&& aTask );
+
+    /**
+     * Run one queued task, if any: the newest one of the calling worker's queue, else the
+     * oldest one of the shared queue, else one stolen from another worker.
+     * @param aGroup if not null, only run a task of this group or of a group nested in it.
+     * @return false if there was nothing to run.
+     */
+    bool runPendingTask( const TASK_GROUP* aGroup = nullptr );
+
+    bool popTask( TASK& aTask, const TASK_GROUP* aGroup );
+
+    /**
+     * Move a task of aGroup (or of any group if aGroup is null) out of aTasks, searching
+     * from the newest task if aNewest is true, else from the oldest one.
+     */
+    static bool takeTask( std::deque<TASK>& aTasks, bool aNewest, const TASK_GROUP* aGroup,
+                          TASK& aTask );
+
+    void runTask( TASK& aTask );
+    void workerLoop( size_t aIndex );
+
+    /// One queue per worker, the last one being the shared queue
+    std::vector<std::unique_ptr<TASK_QUEUE>> m_queues;
+    std::vector<std::thread>                 m_threads;
+
+    std::mutex                               m_sleepMutex;
+    std::condition_variable                  m_wakeUp;
+    std::atomic<size_t>                      m_queuedTasks;
+    bool                                     m_quit;
+};
+
+
+/**
+ * Class TASK_GROUP
+ *
+ * A set of tasks run on a THREAD_POOL, which can be waited for and cancelled together.
+ *
+ * The group must outlive its tasks: the destructor waits for the queued tasks to finish.
+ */
+class TASK_GROUP
+{
+public:
+    TASK_GROUP( THREAD_POOL& aPool = THREAD_POOL::GetInstance() );
+    ~TASK_GROUP();
+
+    TASK_GROUP( const TASK_GROUP& ) = delete;
+    TASK_GROUP& operator=( const TASK_GROUP& ) = delete;
+
+    /**
+     * Queue aTask on the pool.
+     */
+    void Run( std::function<void()> aTask );
+
+    /**
+     * Queue tasks calling aBody( ii ) for each ii in [0, aCount), at most one task per
+     * worker thread and at least aMinItemsPerTask items per task.
+     * Items are taken in increasing order, and not taken any more once the group is cancelled.
+     */
+    void RunForEach( size_t aCount, std::function<void( size_t aIndex )> aBody,
+                     size_t aMinItemsPerTask = 1 );
+
+    /**
+     * Wait for all the tasks of the group to finish.
+     *
+     * Without a reporter, the calling thread runs the queued tasks of the group (and of the
+     * groups created by these tasks) while the group has tasks left, then sleeps until its
+     * tasks running on other threads are done.  With a reporter, it refreshes the reporter
+     * every 100ms instead (so it *MUST* be the main thread), and cancels the group if the
+     * user clicked Cancel.
+     *
+     * If a task threw an exception, it is rethrown here.
+     * @return false if the group was cancelled.
+     */
+    bool Wait( PROGRESS_REPORTER* aReporter = nullptr );
+
+    /**
+     * Wait for all the tasks of the group to finish, calling aRefresh every 100ms from the
+     * calling thread (e.g. to update a progress dialog).  The group is cancelled if aRefresh
+     * returns false.
+     * @return false if the group was cancelled.
+     */
+    bool WaitAndRefresh( const std::function<bool()>& aRefresh );
+
+    /**
+     * Skip the tasks of the group which have not started yet.  Running tasks finish,
+     * unless they test IsCancelled() to stop early.
+     */
+    void Cancel() { m_cancelled = true; }
+
+    bool IsCancelled() const { return m_cancelled; }
+
+private:
+    friend class THREAD_POOL;
+
+    bool wait( const std::function<bool()>* aRefresh );
+
+    /**
+     * @return true if aGroup is this group, or a group created by one of its tasks (at any
+     * depth).
+     */
+    bool contains( const TASK_GROUP* aGroup ) const;
+
+    void taskDone( std::exception_ptr aException );
+
+    THREAD_POOL&            m_pool;
+
+    /// The group of the task which created this group, if any
+    const TASK_GROUP*       m_parent;
+
+    std::atomic<size_t>     m_pendingTasks;
+    std::atomic<bool>       m_cancelled;
+
+    std::mutex              m_mutex;
+    std::condition_variable m_done;
+    std::exception_ptr      m_exception;
+};
+
+#endif  // THREAD_POOL_H
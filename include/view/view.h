@@ -372,6 +372,24 @@ public:
      */
     double ToScreen( double aSize ) const;
 
+    /**
+     * Function GetLODForSize()
+     * Returns the level of detail (i.e. the VIEW scale) above which a feature of a given
+     * size is at least a given number of pixels large on the screen.
+     * @param aSize: the size of the feature, in world units.
+     * @param aPixels: the screen size below which the feature is not shown.
+     * @see VIEW_ITEM::ViewGetLOD()
+     */
+    double GetLODForSize( double aSize, double aPixels ) const;
+
+    /**
+     * Function GetTextLOD()
+     * Returns the level of detail above which a text is drawn: texts smaller than the minimal
+     * text size of the GAL display options are not worth drawing.
+     * @param aTextSize: the height of the text, in world units.
+     */
+    double GetTextLOD( double aTextSize ) const;
+
     /**
      * Function GetScreenPixelSize()
      * Returns the size of the our rendering area, in pixels.
@@ -544,6 +562,16 @@ public:
      */
     virtual void Redraw();
 
+    /**
+     * Function GetLastRedrawTime()
+     * @return the duration of the last call to Redraw(), in milliseconds. With the OpenGL
+     * GAL, this is the time taken to issue the drawing commands, not to execute them.
+     */
+    double GetLastRedrawTime() const
+    {
+        return m_lastRedrawTime;
+    }
+
     /**
      * Function RecacheAllItems()
      * Rebuilds GAL display lists.
@@ -711,6 +739,9 @@ public:
 
     static constexpr int VIEW_MAX_LAYERS = 512;      ///< maximum number of layers that may be shown
 
+    ///< minimum number of items redrawn at once to draw them in parallel
+    static constexpr size_t MIN_PARALLEL_REDRAW = 1000;
+
 protected:
     struct VIEW_LAYER
     {
@@ -792,8 +823,11 @@ protected:
      * Manages dirty flags & redraw queueing when updating an item.
      * @param aItem is the item to be updated.
      * @param aUpdateFlags determines the way an item is refreshed.
+     * @param aRedrawnItems if not null, the item is added to it instead of being redrawn, when
+     * its geometry has to be updated (see updateItemsGeometry()).
      */
-    void invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags );
+    void invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags,
+                         std::vector<VIEW_ITEM*>* aRedrawnItems = nullptr );
 
     /// Updates colors that are used for an item to be drawn
     void updateItemColor( VIEW_ITEM* aItem, int aLayer );
@@ -801,6 +835,13 @@ protected:
     /// Updates all informations needed to draw an item
     void updateItemGeometry( VIEW_ITEM* aItem, int aLayer );
 
+    /**
+     * Function updateItemsGeometry()
+     * Redraws the cached layers of a set of items. Large sets are drawn in parallel with the
+     * group recorders of the GAL, and only copied to the GAL groups by the calling thread.
+     */
+    void updateItemsGeometry( const std::vector<VIEW_ITEM*>& aItems );
+
     /// Updates bounding box of an item
     void updateBbox( VIEW_ITEM* aItem );
 
@@ -882,6 +923,9 @@ protected:
     /// m_printMode > 0 is a printing mode (currently means "we are in printing mode")
     int m_printMode;
 
+    /// Duration of the last Redraw(), in milliseconds
+    double m_lastRedrawTime;
+
     VIEW( const VIEW& ) = delete;
 };
 } // namespace KIGFX
@@ -136,8 +136,9 @@ public:
      * @param aView: pointer to the VIEW device we are drawing on
      * @return the level of detail. 0 always show the item, because the
      * actual zoom level (or VIEW scale) is always > 0
+     * @see VIEW::GetLODForSize()
      */
-    virtual unsigned int ViewGetLOD( int aLayer, VIEW* aView ) const
+    virtual double ViewGetLOD( int aLayer, VIEW* aView ) const
     {
         // By default always show the item
         return 0;
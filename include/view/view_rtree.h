@@ -44,27 +44,48 @@ public:
 
     /**
      * Function Insert()
-     * Inserts an item into the tree. Item's bounding box is taken via its ViewBBox() method.
+     * Inserts an item into the tree, with the bounding box aBBox.
+     * The same box must be given to remove the item.
      */
-    void Insert( VIEW_ITEM* aItem )
+    void Insert( VIEW_ITEM* aItem, const BOX2I& aBBox )
     {
-        const BOX2I&    bbox    = aItem->ViewBBox();
-        const int       mmin[2] = { bbox.GetX(), bbox.GetY() };
-        const int       mmax[2] = { bbox.GetRight(), bbox.GetBottom() };
+        const int       mmin[2] = { aBBox.GetX(), aBBox.GetY() };
+        const int       mmax[2] = { aBBox.GetRight(), aBBox.GetBottom() };
 
         VIEW_RTREE_BASE::Insert( mmin, mmax, aItem );
     }
 
+    /**
+     * Function Insert()
+     * Inserts an item into the tree. Item's bounding box is taken via its ViewBBox() method.
+     */
+    void Insert( VIEW_ITEM* aItem )
+    {
+        Insert( aItem, aItem->ViewBBox() );
+    }
+
     /**
      * Function Remove()
      * Removes an item from the tree. Removal is done by comparing pointers, attepmting to remove a copy
      * of the item will fail.
+     * Only the branches overlapping aBBox, the box the item was inserted with, are searched.
      */
-    void Remove( VIEW_ITEM* aItem )
+    void Remove( VIEW_ITEM* aItem, const BOX2I& aBBox )
     {
-        // const BOX2I&    bbox    = aItem->ViewBBox();
+        const int       mmin[2] = { aBBox.GetX(), aBBox.GetY() };
+        const int       mmax[2] = { aBBox.GetRight(), aBBox.GetBottom() };
 
-        // FIXME: use cached bbox or ptr_map to speed up pointer <-> node lookups.
+        // Remove() returns true if the item was not found
+        if( VIEW_RTREE_BASE::Remove( mmin, mmax, aItem ) )
+            Remove( aItem );
+    }
+
+    /**
+     * Function Remove()
+     * Removes an item from the tree, searching the whole tree for it.
+     */
+    void Remove( VIEW_ITEM* aItem )
+    {
         const int       mmin[2] = { INT_MIN, INT_MIN };
         const int       mmax[2] = { INT_MAX, INT_MAX };
 
@@ -456,9 +456,9 @@ void EDGE_MODULE::Move( const wxPoint& aMoveVector )
     SetDrawCoord();
 }
 
-unsigned int EDGE_MODULE::ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const
+double EDGE_MODULE::ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const
 {
-    const int HIDE = std::numeric_limits<unsigned int>::max();
+    const double HIDE = std::numeric_limits<double>::max();
 
     if( !aView )
         return 0;
@@ -984,7 +984,7 @@ void MODULE::ViewGetLayers( int aLayers[], int& aCount ) const
 }
 
 
-unsigned int MODULE::ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const
+double MODULE::ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const
 {
     int layer = ( m_Layer == F_Cu ) ? LAYER_MOD_FR :
                 ( m_Layer == B_Cu ) ? LAYER_MOD_BK : LAYER_ANCHOR;
@@ -993,7 +993,7 @@ unsigned int MODULE::ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const
     if( aView->IsLayerVisible( layer ) )
         return 3;
 
-    return std::numeric_limits<unsigned int>::max();
+    return std::numeric_limits<double>::max();
 }
 
 
@@ -1364,12 +1364,12 @@ void D_PAD::ViewGetLayers( int aLayers[], int& aCount ) const
 }
 
 
-unsigned int D_PAD::ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const
+double D_PAD::ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const
 {
     if( aView->GetPrintMode() > 0 )  // In printing mode the pad is always drawable
         return 0;
 
-    const int HIDE = std::numeric_limits<unsigned int>::max();
+    const double HIDE = std::numeric_limits<double>::max();
     BOARD* board = GetBoard();
 
     // Handle Render tab switches
@@ -1406,6 +1406,10 @@ unsigned int D_PAD::ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const
         return ( Millimeter2iu( 10 ) / divisor );
     }
 
+    // Holes are not shown when smaller than a pixel
+    if( aLayer == LAYER_PADS_PLATEDHOLES || aLayer == LAYER_NON_PLATEDHOLES )
+        return aView->GetLODForSize( std::min( m_Drill.x, m_Drill.y ), 1.0 );
+
     // Other layers are shown without any conditions
     return 0;
 }
@@ -797,7 +797,7 @@ public:
 
     virtual void ViewGetLayers( int aLayers[], int& aCount ) const override;
 
-    virtual unsigned int ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const override;
+    virtual double ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const override;
 
     virtual const BOX2I ViewBBox() const override;
 
@@ -44,6 +44,7 @@
 
 #include <class_board.h>
 #include <class_pcb_text.h>
+#include <view/view.h>
 
 
 TEXTE_PCB::TEXTE_PCB( BOARD_ITEM* parent ) :
@@ -204,6 +205,17 @@ EDA_ITEM* TEXTE_PCB::Clone() const
     return new TEXTE_PCB( *this );
 }
 
+
+double TEXTE_PCB::ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const
+{
+    // In printing mode the text is always drawable, otherwise it is only drawn when readable
+    if( aView->GetPrintMode() > 0 )
+        return 0;
+
+    return aView->GetTextLOD( GetTextHeight() );
+}
+
+
 void TEXTE_PCB::SwapData( BOARD_ITEM* aImage )
 {
     assert( aImage->Type() == PCB_TEXT_T );
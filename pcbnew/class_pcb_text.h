@@ -124,6 +124,8 @@ public:
 
     EDA_ITEM* Clone() const override;
 
+    virtual double ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const override;
+
     virtual void SwapData( BOARD_ITEM* aImage ) override;
 
 #if defined(DEBUG)
@@ -505,9 +505,9 @@ void TEXTE_MODULE::ViewGetLayers( int aLayers[], int& aCount ) const
 }
 
 
-unsigned int TEXTE_MODULE::ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const
+double TEXTE_MODULE::ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const
 {
-    const int HIDE = std::numeric_limits<unsigned int>::max();
+    const double HIDE = std::numeric_limits<double>::max();
 
     if( !aView )
         return 0;
@@ -538,8 +538,11 @@ unsigned int TEXTE_MODULE::ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const
     if( IsBackLayer( m_Layer ) && !aView->IsLayerVisible( LAYER_MOD_TEXT_BK ) )
         return HIDE;
 
-    // Other layers are shown without any conditions
-    return 0;
+    // In printing mode the text is always drawable, otherwise it is only drawn when readable
+    if( aView->GetPrintMode() > 0 )
+        return 0;
+
+    return aView->GetTextLOD( GetTextHeight() );
 }
 
 
@@ -667,9 +667,9 @@ void TRACK::ViewGetLayers( int aLayers[], int& aCount ) const
 }
 
 
-unsigned int TRACK::ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const
+double TRACK::ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const
 {
-    const int HIDE = std::numeric_limits<unsigned int>::max();
+    const double HIDE = std::numeric_limits<double>::max();
 
     if( !aView->IsLayerVisible( LAYER_TRACKS ) )
         return HIDE;
@@ -937,9 +937,9 @@ void VIA::ViewGetLayers( int aLayers[], int& aCount ) const
 }
 
 
-unsigned int VIA::ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const
+double VIA::ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const
 {
-    constexpr unsigned int HIDE = std::numeric_limits<unsigned int>::max();
+    constexpr double HIDE = std::numeric_limits<double>::max();
 
     // Netnames will be shown only if zoom is appropriate
     if( IsNetnameLayer( aLayer ) )
@@ -949,10 +949,14 @@ unsigned int VIA::ViewGetLOD( int aLayer, KIGFX::VIEW* aView ) const
     BOARD* board = GetBoard();
 
     // Only draw the via if at least one of the layers it crosses is being displayed
-    if( board && ( board->GetVisibleLayers() & GetLayerSet() ).any() )
-        return 0;
+    if( !board || !( board->GetVisibleLayers() & GetLayerSet() ).any() )
+        return HIDE;
+
+    // The hole is not shown when smaller than a pixel
+    if( aLayer == LAYER_VIAS_HOLES && aView->GetPrintMode() <= 0 )
+        return aView->GetLODForSize( GetDrillValue(), 1.0 );
 
-    return HIDE;
+    return 0;
 }
 
 
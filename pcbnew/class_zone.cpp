@@ -99,6 +99,7 @@ ZONE_CONTAINER::ZONE_CONTAINER( const ZONE_CONTAINER& aZone ) :
     m_ThermalReliefGap = aZone.m_ThermalReliefGap;
     m_ThermalReliefCopperBridge = aZone.m_ThermalReliefCopperBridge;
     m_FilledPolysList.Append( aZone.m_FilledPolysList );
+    m_fillDependencyHash = aZone.m_fillDependencyHash;
     m_FillSegmList = aZone.m_FillSegmList;      // vector <> copy
 
     m_isKeepout = aZone.m_isKeepout;
@@ -141,6 +142,7 @@ ZONE_CONTAINER& ZONE_CONTAINER::operator=( const ZONE_CONTAINER& aOther )
     m_HatchLines = aOther.m_HatchLines;     // copy vector <SEG>
     m_FilledPolysList.RemoveAllContours();
     m_FilledPolysList.Append( aOther.m_FilledPolysList );
+    m_fillDependencyHash = aOther.m_fillDependencyHash;
     m_FillSegmList.clear();
     m_FillSegmList = aOther.m_FillSegmList;
 
@@ -596,6 +596,17 @@ public:
         m_FilledPolysList = aPolysList;
     }
 
+    /**
+     * Function SetFilledPolysTriangulation
+     * sets the triangulation of the filled polygons, e.g. read from the zone fill cache,
+     * instead of computing it again in CacheTriangulation().
+     */
+    void SetFilledPolysTriangulation(
+            std::vector<std::unique_ptr<SHAPE_POLY_SET::TRIANGULATED_POLYGON>>&& aTriangulation )
+    {
+        m_FilledPolysList.SetTriangulation( std::move( aTriangulation ) );
+    }
+
     /**
       * Function SetFilledPolysList
       * sets the list of filled polygons.
@@ -721,6 +732,14 @@ public:
      */
     void BuildHashValue() { m_filledPolysHash = m_FilledPolysList.GetHash(); }
 
+    /** @return the hash of the fill inputs (outline, settings and neighbouring items)
+     * stored by ZONE_FILLER when the zone was last filled.
+     * Invalid if the zone was never filled in this session.
+     */
+    const MD5_HASH& GetFillDependencyHash() const { return m_fillDependencyHash; }
+
+    void SetFillDependencyHash( const MD5_HASH& aHash ) { m_fillDependencyHash = aHash; }
+
 
 
 #if defined(DEBUG)
@@ -825,6 +844,8 @@ private:
     SHAPE_POLY_SET        m_RawPolysList;
     MD5_HASH              m_filledPolysHash;    // A hash value used in zone filling calculations
                                                 // to see if the filled areas are up to date
+    MD5_HASH              m_fillDependencyHash; // Hash of the items the last fill depended on,
+                                                // to skip refilling zones which are up to date
 
     HATCH_STYLE           m_hatchStyle;     // hatch style, see enum above
     int                   m_hatchPitch;     // for DIAGONAL_EDGE, distance between 2 hatch lines
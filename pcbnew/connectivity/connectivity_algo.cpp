@@ -25,11 +25,11 @@
 #include <connectivity/connectivity_algo.h>
 #include <widgets/progress_reporter.h>
 #include <geometry/geometry_utils.h>
+#include <thread_pool.h>
 
-#include <thread>
+#include <atomic>
 #include <mutex>
 #include <algorithm>
-#include <future>
 
 #ifdef PROFILE
 #include <profile.h>
@@ -197,6 +197,19 @@ void CN_CONNECTIVITY_ALGO::searchConnections()
 
     m_itemList.RemoveInvalidItems( garbage );
 
+    // The clusters of the items which were connected to the removed ones may have been split,
+    // and the cluster of a removed item has to be dropped, even if the item changed nets since
+    for( auto item : garbage )
+    {
+        MarkNetAsDirty( item->ClusterNet() );
+
+        for( auto neighbour : item->ConnectedItems() )
+        {
+            if( neighbour->Valid() )
+                MarkNetAsDirty( neighbour->Net() );
+        }
+    }
+
     for( auto item : garbage )
         delete item;
 
@@ -217,11 +230,10 @@ void CN_CONNECTIVITY_ALGO::searchConnections()
 
     if( m_itemList.IsDirty() )
     {
-        size_t parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
+        size_t parallelThreadCount = std::min<size_t>( THREAD_POOL::GetInstance().GetThreadCount(),
                 ( dirtyItems.size() + 7 ) / 8 );
 
         std::atomic<size_t> nextItem( 0 );
-        std::vector<std::future<size_t>> returns( parallelThreadCount );
 
         auto conn_lambda = [&nextItem, &dirtyItems]
                             ( CN_LIST* aItemList, PROGRESS_REPORTER* aReporter) -> size_t
@@ -242,22 +254,13 @@ void CN_CONNECTIVITY_ALGO::searchConnections()
             conn_lambda( &m_itemList, m_progressReporter );
         else
         {
-            for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-                returns[ii] = std::async( std::launch::async, conn_lambda,
-                        &m_itemList, m_progressReporter );
+            TASK_GROUP tasks;
 
             for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            {
-                // Here we balance returns with a 100ms timeout to allow UI updating
-                std::future_status status;
-                do
-                {
-                    if( m_progressReporter )
-                        m_progressReporter->KeepRefreshing();
+                tasks.Run( [&]() { conn_lambda( &m_itemList, m_progressReporter ); } );
 
-                    status = returns[ii].wait_for( std::chrono::milliseconds( 100 ) );
-                } while( status != std::future_status::ready );
-            }
+            // The reporter is refreshed every 100ms while waiting, to allow UI updating
+            tasks.Wait( m_progressReporter );
         }
 
         if( m_progressReporter )
@@ -277,76 +280,71 @@ void CN_CONNECTIVITY_ALGO::searchConnections()
 }
 
 
-const CN_CONNECTIVITY_ALGO::CLUSTERS CN_CONNECTIVITY_ALGO::SearchClusters( CLUSTER_SEARCH_MODE aMode )
+const CN_CONNECTIVITY_ALGO::CLUSTERS CN_CONNECTIVITY_ALGO::SearchClusters( CLUSTER_SEARCH_MODE aMode,
+        bool aDirtyNetsOnly )
 {
     constexpr KICAD_T types[] = { PCB_TRACE_T, PCB_PAD_T, PCB_VIA_T, PCB_ZONE_AREA_T, PCB_MODULE_T, EOT };
     constexpr KICAD_T no_zones[] = { PCB_TRACE_T, PCB_PAD_T, PCB_VIA_T, PCB_MODULE_T, EOT };
 
     if( aMode == CSM_PROPAGATE )
-        return SearchClusters( aMode, no_zones, -1 );
+        return SearchClusters( aMode, no_zones, -1, aDirtyNetsOnly );
     else
-        return SearchClusters( aMode, types, -1 );
+        return SearchClusters( aMode, types, -1, aDirtyNetsOnly );
 }
 
 
 const CN_CONNECTIVITY_ALGO::CLUSTERS CN_CONNECTIVITY_ALGO::SearchClusters( CLUSTER_SEARCH_MODE aMode,
-        const KICAD_T aTypes[], int aSingleNet )
+        const KICAD_T aTypes[], int aSingleNet, bool aDirtyNetsOnly )
 {
     bool withinAnyNet = ( aMode != CSM_PROPAGATE );
 
     std::deque<CN_ITEM*> Q;
-    CN_ITEM* head = nullptr;
+    std::vector<CN_ITEM*> roots;
     CLUSTERS clusters;
 
     if( m_itemList.IsDirty() )
         searchConnections();
 
-    auto addToSearchList = [&head, withinAnyNet, aSingleNet, aTypes] ( CN_ITEM *aItem )
+    auto isSearched = [withinAnyNet, aSingleNet, aTypes] ( CN_ITEM *aItem )
     {
         if( withinAnyNet && aItem->Net() <= 0 )
-            return;
+            return false;
 
         if( !aItem->Valid() )
-            return;
+            return false;
 
         if( aSingleNet >=0 && aItem->Net() != aSingleNet )
-            return;
-
-        bool found = false;
+            return false;
 
         for( int i = 0; aTypes[i] != EOT; i++ )
         {
             if( aItem->Parent()->Type() == aTypes[i] )
-            {
-                found = true;
-                break;
-            }
+                return true;
         }
 
-        if( !found )
-            return;
-
-        aItem->ListClear();
-        aItem->SetVisited( false );
-
-        if( !head )
-            head = aItem;
-        else
-            head->ListInsert( aItem );
+        return false;
     };
 
-    std::for_each( m_itemList.begin(), m_itemList.end(), addToSearchList );
+    // The search can reach items which are not roots, so all the visited flags are cleared.
+    // When only the dirty nets are searched, the clusters of the other nets are left alone:
+    // none of their items were added, removed or connected to an item which was.
+    for( auto item : m_itemList )
+    {
+        item->SetVisited( false );
+
+        if( isSearched( item ) && ( !aDirtyNetsOnly || IsNetDirty( item->Net() ) ) )
+            roots.push_back( item );
+    }
 
-    while( head )
+    for( auto root : roots )
     {
+        if( root->Visited() )
+            continue;
+
         CN_CLUSTER_PTR cluster ( new CN_CLUSTER() );
 
         Q.clear();
-        CN_ITEM* root = head;
         root->SetVisited ( true );
-
-        head = root->ListRemove();
-
         Q.push_back( root );
 
         while( Q.size() )
@@ -361,11 +359,10 @@ const CN_CONNECTIVITY_ALGO::CLUSTERS CN_CONNECTIVITY_ALGO::SearchClusters( CLUST
                 if( withinAnyNet && n->Net() != root->Net() )
                     continue;
 
-                if( !n->Visited() && n->Valid() )
+                if( !n->Visited() && isSearched( n ) )
                 {
                     n->SetVisited( true );
                     Q.push_back( n );
-                    head = n->ListRemove();
                 }
             }
         }
@@ -493,7 +490,8 @@ void CN_CONNECTIVITY_ALGO::propagateConnections()
 
 void CN_CONNECTIVITY_ALGO::PropagateNets()
 {
-    m_connClusters = SearchClusters( CSM_PROPAGATE );
+    // A cluster without any item of a dirty net has already been propagated
+    m_connClusters = SearchClusters( CSM_PROPAGATE, true );
     propagateConnections();
 }
 
@@ -564,7 +562,75 @@ void CN_CONNECTIVITY_ALGO::FindIsolatedCopperIslands( std::vector<CN_ZONE_ISOLAT
 
 const CN_CONNECTIVITY_ALGO::CLUSTERS& CN_CONNECTIVITY_ALGO::GetClusters()
 {
-    m_ratsnestClusters = SearchClusters( CSM_RATSNEST );
+    // The ratsnest clusters never span several nets: only the ones of the dirty nets have to
+    // be searched again, the others are kept.
+    CLUSTERS dirtyClusters;
+    bool     searchAgain = true;
+
+    while( searchAgain )
+    {
+        dirtyClusters = SearchClusters( CSM_RATSNEST, true );
+        searchAgain = false;
+
+        // An item whose net code changed without being updated is still held by the cluster
+        // of its previous net, which has to be searched again too
+        for( const auto& cluster : dirtyClusters )
+        {
+            for( auto item : *cluster )
+            {
+                int previousNet = item->ClusterNet();
+
+                if( previousNet >= 0 && previousNet != item->Net() && !IsNetDirty( previousNet ) )
+                {
+                    MarkNetAsDirty( previousNet );
+                    searchAgain = true;
+                }
+            }
+        }
+    }
+
+    // Both lists are sorted by origin net: merge them, dropping the clusters of the dirty nets.
+    // The clusters are told apart by the net they were searched in, since a cluster without
+    // pads has no origin net.
+    CLUSTERS         clusters;
+    std::vector<int> clusterNets;
+    size_t           clean = 0;
+
+    clusters.reserve( m_ratsnestClusters.size() + dirtyClusters.size() );
+    clusterNets.reserve( m_ratsnestClusters.size() + dirtyClusters.size() );
+
+    auto addCleanClusters = [&]( const CN_CLUSTER* aNext )
+    {
+        for( ; clean < m_ratsnestClusters.size(); ++clean )
+        {
+            if( aNext && m_ratsnestClusters[clean]->OriginNet() > aNext->OriginNet() )
+                break;
+
+            if( !IsNetDirty( m_ratsnestClusterNets[clean] ) )
+            {
+                clusters.push_back( m_ratsnestClusters[clean] );
+                clusterNets.push_back( m_ratsnestClusterNets[clean] );
+            }
+        }
+    };
+
+    for( const auto& cluster : dirtyClusters )
+    {
+        int net = ( *cluster->begin() )->Net();
+
+        addCleanClusters( cluster.get() );
+
+        for( auto item : *cluster )
+            item->SetClusterNet( net );
+
+        clusters.push_back( cluster );
+        clusterNets.push_back( net );
+    }
+
+    addCleanClusters( nullptr );
+
+    m_ratsnestClusters = std::move( clusters );
+    m_ratsnestClusterNets = std::move( clusterNets );
     return m_ratsnestClusters;
 }
 
@@ -709,6 +775,7 @@ bool CN_VISITOR::operator()( CN_ITEM* aCandidate )
 void CN_CONNECTIVITY_ALGO::Clear()
 {
     m_ratsnestClusters.clear();
+    m_ratsnestClusterNets.clear();
     m_connClusters.clear();
     m_itemMap.clear();
     m_itemList.Clear();
@@ -149,6 +149,7 @@ private:
 
     CLUSTERS m_connClusters;
     CLUSTERS m_ratsnestClusters;
+    std::vector<int> m_ratsnestClusterNets;     ///< the net each ratsnest cluster was searched in
     std::vector<bool> m_dirtyNets;
     PROGRESS_REPORTER* m_progressReporter = nullptr;
 
@@ -184,7 +185,7 @@ public:
 
     bool IsNetDirty( int aNet ) const
     {
-        if( aNet < 0 )
+        if( aNet < 0 || aNet >= (int) m_dirtyNets.size() )
             return false;
 
         return m_dirtyNets[ aNet ];
@@ -220,9 +221,23 @@ public:
     bool    Remove( BOARD_ITEM* aItem );
     bool    Add( BOARD_ITEM* aItem );
 
-    const CLUSTERS  SearchClusters( CLUSTER_SEARCH_MODE aMode, const KICAD_T aTypes[], int aSingleNet );
-    const CLUSTERS  SearchClusters( CLUSTER_SEARCH_MODE aMode );
+    /**
+     * Function SearchClusters()
+     * returns the clusters of the items of types @a aTypes, sorted by net.
+     *
+     * @param aSingleNet only the items of this net are searched, if >= 0.
+     * @param aDirtyNetsOnly only the clusters holding an item of a dirty net are searched:
+     *  the clusters of the other nets are unchanged since the dirty flags were cleared.
+     */
+    const CLUSTERS  SearchClusters( CLUSTER_SEARCH_MODE aMode, const KICAD_T aTypes[],
+                                    int aSingleNet, bool aDirtyNetsOnly = false );
+    const CLUSTERS  SearchClusters( CLUSTER_SEARCH_MODE aMode, bool aDirtyNetsOnly = false );
 
+    /**
+     * Function PropagateNets()
+     * propagates the nets of the pads to the tracks and vias connected to them, in the
+     * clusters holding an item of a dirty net.
+     */
     void    PropagateNets();
     void    FindIsolatedCopperIslands( ZONE_CONTAINER* aZone, std::vector<int>& aIslands );
 
@@ -236,6 +251,11 @@ public:
 
     bool    CheckConnectivity( std::vector<CN_DISJOINT_NET_ENTRY>& aReport );
 
+    /**
+     * Function GetClusters()
+     * returns the ratsnest clusters of all the nets.  Only the clusters of the dirty nets are
+     * searched again, the ones of the other nets are those of the previous call.
+     */
     const CLUSTERS& GetClusters();
     int             GetUnconnectedCount();
 
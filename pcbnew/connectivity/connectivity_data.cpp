@@ -27,13 +27,13 @@
 #include <profile.h>
 #endif
 
-#include <thread>
+#include <atomic>
 #include <algorithm>
-#include <future>
 
 #include <connectivity/connectivity_data.h>
 #include <connectivity/connectivity_algo.h>
 #include <ratsnest_data.h>
+#include <thread_pool.h>
 
 CONNECTIVITY_DATA::CONNECTIVITY_DATA()
 {
@@ -107,11 +107,10 @@ void CONNECTIVITY_DATA::updateRatsnest()
             [] ( RN_NET* aNet ) { return aNet->IsDirty() && aNet->GetNodeCount() > 0; } );
 
     // We don't want to spin up a new thread for fewer than 8 nets (overhead costs)
-    size_t parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
+    size_t parallelThreadCount = std::min<size_t>( THREAD_POOL::GetInstance().GetThreadCount(),
             ( dirty_nets.size() + 7 ) / 8 );
 
     std::atomic<size_t> nextNet( 0 );
-    std::vector<std::future<size_t>> returns( parallelThreadCount );
 
     auto update_lambda = [&nextNet, &dirty_nets]() -> size_t
     {
@@ -125,12 +124,13 @@ void CONNECTIVITY_DATA::updateRatsnest()
         update_lambda();
     else
     {
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii] = std::async( std::launch::async, update_lambda );
+        TASK_GROUP tasks;
 
-        // Finalize the ratsnest threads
         for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii].wait();
+            tasks.Run( update_lambda );
+
+        // Finalize the ratsnest tasks
+        tasks.Wait();
     }
 
     #ifdef PROFILE
@@ -162,7 +162,9 @@ void CONNECTIVITY_DATA::RecalculateRatsnest()
             m_nets[i] = new RN_NET;
     }
 
-    auto clusters = m_connAlgo->GetClusters();
+    // Only the clusters of the dirty nets are searched again, and only the dirty RN_NETs
+    // are updated
+    const auto& clusters = m_connAlgo->GetClusters();
 
     int dirtyNets = 0;
 
@@ -222,8 +222,15 @@ void CN_LIST::RemoveInvalidItems( std::vector<CN_ITEM*>& aGarbage )
 
     m_items.resize( lastItem - m_items.begin() );
 
-    for( auto item : m_items )
-        item->RemoveInvalidRefs();
+    // The connections are symmetric: only the neighbours of the removed items can refer to them
+    for( auto item : aGarbage )
+    {
+        for( auto neighbour : item->ConnectedItems() )
+        {
+            if( neighbour->Valid() )
+                neighbour->RemoveInvalidRefs();
+        }
+    }
 
     for( auto item : aGarbage )
         m_index.Remove( item );
@@ -172,6 +172,9 @@ private:
     ///> valid flag, used to identify garbage items (we use lazy removal)
     bool m_valid;
 
+    ///> net of the ratsnest cluster the item was last found in (-1 if none)
+    int m_clusterNet;
+
     ///> mutex protecting this item's connected_items set to allow parallel connection threads
     std::mutex m_listLock;
 
@@ -194,6 +197,7 @@ public:
         m_canChangeNet = aCanChangeNet;
         m_visited = false;
         m_valid = true;
+        m_clusterNet = -1;
         m_dirty = true;
         m_anchors.reserve( 2 );
         m_layers = LAYER_RANGE( 0, PCB_LAYER_ID_COUNT );
@@ -311,6 +315,22 @@ public:
         return m_canChangeNet;
     }
 
+    void SetClusterNet( int aNet )
+    {
+        m_clusterNet = aNet;
+    }
+
+    /**
+     * Function ClusterNet()
+     *
+     * Returns the net of the ratsnest cluster the item was last found in, which is not its
+     * current net if its net code changed since, or -1 if it is not in a ratsnest cluster.
+     */
+    int ClusterNet() const
+    {
+        return m_clusterNet;
+    }
+
     void Connect( CN_ITEM* b )
     {
         std::lock_guard<std::mutex> lock( m_listLock );
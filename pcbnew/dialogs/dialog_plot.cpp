@@ -798,6 +798,8 @@ void DIALOG_PLOT::Plot( wxCommandEvent& event )
 
     wxBusyCursor dummy;
 
+    std::vector<PLOT_LAYER_JOB> jobs;
+
     for( LSEQ seq = m_plotOpts.GetLayerSelection().UIOrder();  seq;  ++seq )
     {
         PCB_LAYER_ID layer = *seq;
@@ -823,25 +825,25 @@ void DIALOG_PLOT::Plot( wxCommandEvent& event )
         wxString fullname = fn.GetFullName();
         jobfile_writer.AddGbrFile( layer, fullname );
 
-        LOCALE_IO toggle;
+        jobs.push_back( { layer, fn.GetFullPath(), false } );
+    }
 
-        PLOTTER*    plotter = StartPlotBoard( board, &m_plotOpts, layer, fn.GetFullPath(), wxEmptyString );
+    // The layers are plotted in parallel, each one in its own file
+    PlotBoardLayers( board, &m_plotOpts, jobs );
 
-        // Print diags in messages box:
+    // Print diags in messages box:
+    for( const PLOT_LAYER_JOB& job : jobs )
+    {
         wxString msg;
 
-        if( plotter )
+        if( job.m_Plotted )
         {
-            PlotOneBoardLayer( board, plotter, layer, m_plotOpts );
-            plotter->EndPlot();
-            delete plotter;
-
-            msg.Printf( _( "Plot file \"%s\" created." ), GetChars( fn.GetFullPath() ) );
+            msg.Printf( _( "Plot file \"%s\" created." ), GetChars( job.m_FileName ) );
             reporter.Report( msg, REPORTER::RPT_ACTION );
         }
         else
         {
-            msg.Printf( _( "Unable to create file \"%s\"." ), GetChars( fn.GetFullPath() ) );
+            msg.Printf( _( "Unable to create file \"%s\"." ), GetChars( job.m_FileName ) );
             reporter.Report( msg, REPORTER::RPT_ERROR );
         }
     }
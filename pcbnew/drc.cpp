@@ -27,6 +27,8 @@
  * @file drc.cpp
  */
 
+#include <atomic>
+
 #include <fctsys.h>
 #include <pcb_edit_frame.h>
 #include <trigo.h>
@@ -61,6 +63,9 @@
 #include <geometry/shape_arc.h>
 
 #include <drc/courtyard_overlap.h>
+#include <drc/drc_rtree.h>
+#include <advanced_config.h>
+#include <thread_pool.h>
 
 void DRC::ShowDRCDialog( wxWindow* aParent )
 {
@@ -111,6 +116,10 @@ void DRC::addMarkerToPcb( MARKER_PCB* aMarker )
         delete aMarker;
         m_currentMarker = nullptr;
     }
+    else if( m_markerCollector )
+    {
+        m_markerCollector->push_back( aMarker );
+    }
     else
     {
         BOARD_COMMIT commit( m_pcbEditorFrame );
@@ -132,10 +141,16 @@ void DRC::DestroyDRCDialog( int aReason )
 }
 
 
-DRC::DRC( PCB_EDIT_FRAME* aPcbWindow )
+DRC::DRC( PCB_EDIT_FRAME* aPcbWindow ) :
+        DRC( aPcbWindow, aPcbWindow->GetBoard() )
+{
+}
+
+
+DRC::DRC( PCB_EDIT_FRAME* aPcbWindow, BOARD* aPcb )
 {
     m_pcbEditorFrame = aPcbWindow;
-    m_pcb = aPcbWindow->GetBoard();
+    m_pcb = aPcb;
     m_drcDialog  = NULL;
 
     // establish initial values for everything:
@@ -147,6 +162,8 @@ DRC::DRC( PCB_EDIT_FRAME* aPcbWindow )
     m_refillZones = false;              // Only fill zones if requested by user.
     m_reportAllTrackErrors = false;
     m_testFootprints = false;
+    m_useSpatialIndex = ADVANCED_CFG::GetCfg().m_drcSpatialIndex;
+    m_parallelTests = true;
 
     m_drcRun = false;
     m_footprintsTested = false;
@@ -164,7 +181,27 @@ DRC::DRC( PCB_EDIT_FRAME* aPcbWindow )
     m_xcliphi = 0;
     m_ycliphi = 0;
 
-    m_markerFactory.SetUnitsProvider( [=]() { return aPcbWindow->GetUserUnits(); } );
+    m_markerCollector = nullptr;
+
+    // Without a frame (headless tests), the markers use the default units of the factory
+    if( aPcbWindow )
+        m_markerFactory.SetUnitsProvider( [=]() { return aPcbWindow->GetUserUnits(); } );
+}
+
+
+DRC::DRC( const DRC& aParent, std::vector<MARKER_PCB*>* aMarkerCollector ) :
+        DRC( aParent.m_pcbEditorFrame, aParent.m_pcb )
+{
+    m_doPad2PadTest = aParent.m_doPad2PadTest;
+    m_doUnconnectedTest = aParent.m_doUnconnectedTest;
+    m_doZonesTest = aParent.m_doZonesTest;
+    m_doKeepoutTest = aParent.m_doKeepoutTest;
+    m_reportAllTrackErrors = aParent.m_reportAllTrackErrors;
+    m_useSpatialIndex = aParent.m_useSpatialIndex;
+    m_parallelTests = aParent.m_parallelTests;
+    m_board_outlines = aParent.m_board_outlines;
+
+    m_markerCollector = aMarkerCollector;
 }
 
 
@@ -236,6 +273,9 @@ int DRC::TestZoneToZoneOutline( ZONE_CONTAINER* aZone, bool aCreateMarkers )
     {
         ZONE_CONTAINER* zoneRef = board->GetArea( ia );
         zoneRef->BuildSmoothedPoly( smoothed_polys[ia] );
+
+        // Each outline is tested against all the vertices of the other ones
+        smoothed_polys[ia].EnableEdgeIndex();
     }
 
     // iterate through all areas
@@ -288,7 +328,7 @@ int DRC::TestZoneToZoneOutline( ZONE_CONTAINER* aZone, bool aCreateMarkers )
                 zone2zoneClearance = 1;
 
             // test for some corners of zoneRef inside zoneToTest
-            for( auto iterator = smoothed_polys[ia].IterateWithHoles(); iterator; iterator++ )
+            for( auto iterator = smoothed_polys[ia].CIterateWithHoles(); iterator; iterator++ )
             {
                 VECTOR2I currentVertex = *iterator;
                 wxPoint pt( currentVertex.x, currentVertex.y );
@@ -304,7 +344,7 @@ int DRC::TestZoneToZoneOutline( ZONE_CONTAINER* aZone, bool aCreateMarkers )
             }
 
             // test for some corners of zoneToTest inside zoneRef
-            for( auto iterator = smoothed_polys[ia2].IterateWithHoles(); iterator; iterator++ )
+            for( auto iterator = smoothed_polys[ia2].CIterateWithHoles(); iterator; iterator++ )
             {
                 VECTOR2I currentVertex = *iterator;
                 wxPoint pt( currentVertex.x, currentVertex.y );
@@ -322,13 +362,13 @@ int DRC::TestZoneToZoneOutline( ZONE_CONTAINER* aZone, bool aCreateMarkers )
             // Iterate through all the segments of refSmoothedPoly
             std::set<wxPoint> conflictPoints;
 
-            for( auto refIt = smoothed_polys[ia].IterateSegmentsWithHoles(); refIt; refIt++ )
+            for( auto refIt = smoothed_polys[ia].CIterateSegmentsWithHoles(); refIt; refIt++ )
             {
                 // Build ref segment
                 SEG refSegment = *refIt;
 
                 // Iterate through all the segments in smoothed_polys[ia2]
-                for( auto testIt = smoothed_polys[ia2].IterateSegmentsWithHoles(); testIt; testIt++ )
+                for( auto testIt = smoothed_polys[ia2].CIterateSegmentsWithHoles(); testIt; testIt++ )
                 {
                     // Build test segment
                     SEG testSegment = *testIt;
@@ -737,20 +777,22 @@ void DRC::testPad2Pad()
     D_PAD** listEnd = &sortedPads[0] + sortedPads.size();
 
     // Test the pads
-    for( unsigned i = 0; i< sortedPads.size(); ++i )
+    auto test_pad = [&]( DRC& aWorker, size_t aIndex )
     {
-        D_PAD* pad = sortedPads[i];
+        D_PAD* pad = sortedPads[aIndex];
 
         int    x_limit = max_size + pad->GetClearance() +
                          pad->GetBoundingRadius() + pad->GetPosition().x;
 
-        if( !doPadToPadsDrc( pad, &sortedPads[i], listEnd, x_limit ) )
+        if( !aWorker.doPadToPadsDrc( pad, &sortedPads[aIndex], listEnd, x_limit ) )
         {
-            wxASSERT( m_currentMarker );
-            addMarkerToPcb ( m_currentMarker );
-            m_currentMarker = nullptr;
+            wxASSERT( aWorker.m_currentMarker );
+            aWorker.addMarkerToPcb( aWorker.m_currentMarker );
+            aWorker.m_currentMarker = nullptr;
         }
-    }
+    };
+
+    runParallelTests( sortedPads.size(), test_pad, []( size_t ) { return true; } );
 }
 
 
@@ -849,35 +891,99 @@ void DRC::testTracks( wxWindow *aActiveWindow, bool aShowProgressBar )
         progressDialog->Update( 0, wxEmptyString );
     }
 
-    int ii = 0;
-    count = 0;
-
-    for( TRACK* segm = m_pcb->m_Track; segm; segm = segm->Next() )
+    if( m_useSpatialIndex )
     {
-        if( ii++ > delta )
+        // Index the board items once, so that each segment is only tested against the items
+        // which are close enough to violate a clearance, instead of against the whole board
+        DRC_RTREE index;
+
+        index.Build( m_pcb );
+
+        // A few nanometers more for the rounding of the rotated coordinates used in
+        // doTrackDrc(): candidates beyond the clearance are harmless, missed ones are not
+        int margin = index.GetMaxClearance() + 10;
+
+        std::vector<TRACK*> segments;
+
+        for( TRACK* segm = m_pcb->m_Track; segm; segm = segm->Next() )
+            segments.push_back( segm );
+
+        // The segments are independent, so they are tested on all cores
+        auto test_segment = [&]( DRC& aWorker, size_t aIndex )
         {
-            ii = 0;
-            count++;
+            TRACK*                       segm = segments[aIndex];
+            std::vector<D_PAD*>          pads;
+            std::vector<TRACK*>          tracks;
+            std::vector<ZONE_CONTAINER*> zones;
+
+            index.QueryPads( segm, margin, pads );
+            index.QueryTracks( segm, margin, tracks );
+
+            if( aWorker.m_doZonesTest )
+                index.QueryZones( segm, margin, zones );
+
+            aWorker.doTrackDrc( segm, pads, tracks, zones );
+        };
 
-            if( progressDialog )
-            {
-                if( !progressDialog->Update( count, wxEmptyString ) )
-                    break;  // Aborted by user
 #ifdef __WXMAC__
-                // Work around a dialog z-order issue on OS X
-                if( count == deltamax )
-                    aActiveWindow->Raise();
+        bool raised = false;
 #endif
+
+        auto update_progress = [&]( size_t aDone ) -> bool
+        {
+            if( !progressDialog )
+                return true;
+
+            int progress = std::min<int>( aDone / delta, deltamax );
+
+            if( !progressDialog->Update( progress, wxEmptyString ) )
+                return false;   // Aborted by user
+
+#ifdef __WXMAC__
+            // Work around a dialog z-order issue on OS X
+            if( progress == deltamax && !raised )
+            {
+                aActiveWindow->Raise();
+                raised = true;
             }
-        }
+#endif
+            return true;
+        };
+
+        runParallelTests( segments.size(), test_segment, update_progress );
+    }
+    else
+    {
+        int ii = 0;
+        count = 0;
 
-        // Test new segment against tracks and pads, optionally against copper zones
-        if( !doTrackDrc( segm, segm->Next(), true, m_doZonesTest ) )
+        for( TRACK* segm = m_pcb->m_Track; segm; segm = segm->Next() )
         {
-            if( m_currentMarker )
+            if( ii++ > delta )
+            {
+                ii = 0;
+                count++;
+
+                if( progressDialog )
+                {
+                    if( !progressDialog->Update( count, wxEmptyString ) )
+                        break;  // Aborted by user
+#ifdef __WXMAC__
+                    // Work around a dialog z-order issue on OS X
+                    if( count == deltamax )
+                        aActiveWindow->Raise();
+#endif
+                }
+            }
+
+            // Test new segment against tracks and pads, optionally against copper zones
+            if( !doTrackDrc( segm, segm->Next(), true, m_doZonesTest ) )
             {
-                addMarkerToPcb ( m_currentMarker );
-                m_currentMarker = nullptr;
+                if( m_currentMarker )
+                {
+                    addMarkerToPcb ( m_currentMarker );
+                    m_currentMarker = nullptr;
+                }
             }
         }
     }
@@ -887,6 +993,109 @@ void DRC::testTracks( wxWindow *aActiveWindow, bool aShowProgressBar )
 }
 
 
+void DRC::runParallelTests( size_t aCount,
+                            const std::function<void( DRC& aWorker, size_t aIndex )>& aTest,
+                            const std::function<bool( size_t aDone )>& aProgress )
+{
+    // Work is handed out by blocks of consecutive items, and the markers of each block
+    // are kept apart, so that they can be added in the sequential test order
+    const size_t blockSize = 64;
+    const size_t blockCount = ( aCount + blockSize - 1 ) / blockSize;
+
+    std::vector<std::vector<MARKER_PCB*>> blockMarkers( blockCount );
+    std::atomic<size_t> nextBlock( 0 );
+    std::atomic<size_t> done( 0 );
+    TASK_GROUP          tasks;
+
+    // Pads cache their bounding radius on first use: fill the cache before sharing them
+    for( MODULE* mod : m_pcb->Modules() )
+    {
+        for( D_PAD* pad : mod->Pads() )
+            pad->GetBoundingRadius();
+    }
+
+    auto test_lambda = [&]() -> size_t
+    {
+        std::vector<MARKER_PCB*> markers;
+        DRC                      worker( *this, &markers );
+        size_t                   num = 0;
+
+        for( size_t block = nextBlock++; block < blockCount && !tasks.IsCancelled();
+             block = nextBlock++ )
+        {
+            size_t first = block * blockSize;
+            size_t last = std::min( aCount, first + blockSize );
+
+            for( size_t ii = first; ii < last; ++ii )
+                aTest( worker, ii );
+
+            blockMarkers[block].swap( markers );
+            done += last - first;
+            num += last - first;
+        }
+
+        return num;
+    };
+
+    size_t parallelThreadCount = std::min<size_t>( THREAD_POOL::GetInstance().GetThreadCount(),
+                                                   blockCount );
+
+    if( parallelThreadCount <= 1 || !m_parallelTests )
+        test_lambda();
+    else
+    {
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            tasks.Run( test_lambda );
+
+        // The progress is updated every 100ms while waiting; the tests stop if it is aborted
+        tasks.WaitAndRefresh( [&]() { return aProgress( done ); } );
+    }
+
+    // The markers are kept (or committed at once) in the order the sequential test would give
+    if( m_markerCollector )
+    {
+        for( std::vector<MARKER_PCB*>& markers : blockMarkers )
+            m_markerCollector->insert( m_markerCollector->end(), markers.begin(), markers.end() );
+
+        return;
+    }
+
+    // A single commit for all the markers
+    BOARD_COMMIT commit( m_pcbEditorFrame );
+    bool         hasMarkers = false;
+
+    for( std::vector<MARKER_PCB*>& markers : blockMarkers )
+    {
+        for( MARKER_PCB* marker : markers )
+        {
+            commit.Add( marker );
+            hasMarkers = true;
+        }
+    }
+
+    if( hasMarkers )
+        commit.Push( wxEmptyString, false, false );
+}
+
+
+std::vector<MARKER_PCB*> DRC::TestClearances( BOARD* aPCB, bool aUseSpatialIndex,
+                                              bool aParallel )
+{
+    std::vector<MARKER_PCB*> markers;
+    DRC                      drc( nullptr, aPCB );
+
+    drc.m_doZonesTest = true;
+    drc.m_useSpatialIndex = aUseSpatialIndex;
+    drc.m_parallelTests = aParallel;
+    drc.m_markerCollector = &markers;
+
+    drc.testPad2Pad();
+    drc.testTracks( nullptr, false );
+
+    return markers;
+}
+
+
 void DRC::testUnconnected()
 {
     for( DRC_ITEM* unconnectedItem : m_unconnected )
@@ -31,6 +31,7 @@
 
 #include <vector>
 #include <memory>
+#include <functional>
 #include <geometry/seg.h>
 #include <geometry/shape_poly_set.h>
 
@@ -200,6 +201,8 @@ private:
     bool     m_refillZones;             // refill zones if requested (by user).
     bool     m_reportAllTrackErrors;    // Report all tracks errors (or only 4 first errors)
     bool     m_testFootprints;          // Test footprints against schematic
+    bool     m_useSpatialIndex;         // use a DRC_RTREE to find the items to test against tracks
+    bool     m_parallelTests;           // run the tests of runParallelTests() on all cores
 
     wxString m_rptFilename;
 
@@ -247,6 +250,35 @@ private:
     bool                m_drcRun;
     bool                m_footprintsTested;
 
+    /// When not null, markers are stored here instead of being committed to the board
+    /// (used by the workers of runParallelTests())
+    std::vector<MARKER_PCB*>* m_markerCollector;
+
+    /**
+     * Create a DRC for aPcb.  aPcbWindow can be null for tests run without an editor, as long
+     * as the markers go to m_markerCollector.
+     */
+    DRC( PCB_EDIT_FRAME* aPcbWindow, BOARD* aPcb );
+
+    /**
+     * Create a worker for runParallelTests(), with the settings of aParent.  The markers
+     * found by the worker are appended to aMarkerCollector.
+     */
+    DRC( const DRC& aParent, std::vector<MARKER_PCB*>* aMarkerCollector );
+
+    /**
+     * Run aTest for each index in [0, aCount) on all available cores (or on the calling thread
+     * only if m_parallelTests is false), each thread using its own DRC worker.  The markers
+     * found are then added to the board in a single commit (or to m_markerCollector), in the
+     * index order, i.e. in the same order as a sequential run would have added them.
+     *
+     * @param aProgress is called on the calling thread with the number of tested items;
+     *                  it can return false to cancel the remaining tests
+     */
+    void runParallelTests( size_t aCount,
+                           const std::function<void( DRC& aWorker, size_t aIndex )>& aTest,
+                           const std::function<bool( size_t aDone )>& aProgress );
+
 
     /**
      * Update needed pointers from the one pointer which is known not to change.
@@ -337,6 +369,20 @@ private:
     bool doTrackDrc( TRACK* aRefSeg, TRACK* aStart,
                      bool aTestPads, bool aTestZones );
 
+    /**
+     * Test the current segment against the given candidate items.
+     *
+     * @param aRefSeg The segment to test
+     * @param aPads the pads to test against aRefSeg, in board order
+     * @param aTracks the tracks and vias to test against aRefSeg, in board order
+     * @param aZones the copper zones to test against aRefSeg, in board order
+     * @return bool - true if no problems, else false and m_currentMarker is
+     *          filled in with the problem information.
+     */
+    bool doTrackDrc( TRACK* aRefSeg, const std::vector<D_PAD*>& aPads,
+                     const std::vector<TRACK*>& aTracks,
+                     const std::vector<ZONE_CONTAINER*>& aZones );
+
     /**
      * Test the current segment or via.
      *
@@ -466,6 +512,17 @@ public:
     static void TestFootprints( NETLIST& aNetlist, BOARD* aPCB, EDA_UNITS_T aUnits,
                                 DRC_LIST& aDRCList );
 
+    /**
+     * Run the pad to pad and the track clearance tests (including the copper zones) on aPCB,
+     * without an editor frame.  The markers are not added to the board.
+     *
+     * @param aUseSpatialIndex = true to find the items to test against tracks with a DRC_RTREE
+     * @param aParallel = true to run the tests on all cores
+     * @return the markers, in the order they would be added to the board; owned by the caller
+     */
+    static std::vector<MARKER_PCB*> TestClearances( BOARD* aPCB, bool aUseSpatialIndex,
+                                                    bool aParallel );
+
     /**
      * Open a dialog and prompts the user, then if a test run button is
      * clicked, runs the test(s) and creates the MARKERS.  The dialog is only
@@ -30,6 +30,8 @@
 
 #include <drc/courtyard_overlap.h>
 
+#include <algorithm>
+
 #include <class_module.h>
 #include <drc.h>
 
@@ -96,71 +98,231 @@ bool DRC_COURTYARD_OVERLAP::RunDRC( BOARD& aBoard ) const
 
     wxLogTrace( DRC_COURTYARD_TRACE, "Checking for courtyard overlap" );
 
-    // Now test for overlapping on top layer:
-    SHAPE_POLY_SET courtyard; // temporary storage of the courtyard of current footprint
+    // Test for overlapping on top layer, then on bottom layer:
+    if( !testOverlappingCourtyards( aBoard, true ) )
+        success = false;
 
-    for( MODULE* footprint = aBoard.m_Modules; footprint; footprint = footprint->Next() )
-    {
-        if( footprint->GetPolyCourtyardFront().OutlineCount() == 0 )
-            continue; // No courtyard defined
+    if( !testOverlappingCourtyards( aBoard, false ) )
+        success = false;
 
-        for( MODULE* candidate = footprint->Next(); candidate; candidate = candidate->Next() )
-        {
-            if( candidate->GetPolyCourtyardFront().OutlineCount() == 0 )
-                continue; // No courtyard defined
+    return success;
+}
 
-            courtyard.RemoveAllContours();
-            courtyard.Append( footprint->GetPolyCourtyardFront() );
 
-            // Build the common area between footprint and the candidate:
-            courtyard.BooleanIntersection(
-                    candidate->GetPolyCourtyardFront(), SHAPE_POLY_SET::PM_FAST );
+namespace
+{
 
-            // If no overlap, courtyard is empty (no common area).
-            // Therefore if a common polygon exists, this is a DRC error
-            if( courtyard.OutlineCount() )
-            {
-                //Overlap between footprint and candidate
-                VECTOR2I& pos = courtyard.Vertex( 0, 0, -1 );
-                auto      marker = std::unique_ptr<MARKER_PCB>(
-                        marker_factory.NewMarker( wxPoint( pos.x, pos.y ), footprint, candidate,
-                                DRCE_OVERLAPPING_FOOTPRINTS ) );
-                HandleMarker( std::move( marker ) );
-                success = false;
-            }
+/**
+ * A courtyard, for the broad phase of the overlap test
+ */
+struct COURTYARD
+{
+    MODULE*               m_footprint;
+    const SHAPE_POLY_SET* m_poly;
+    BOX2I                 m_bbox;
+    int                   m_index;      ///< the index of the footprint in the board
+};
+
+}
+
+
+/**
+ * @return the orientation of the triangle a, b, c: 1 if counter-clockwise, -1 if clockwise,
+ * 0 if the points are colinear.
+ */
+static int orientation( const VECTOR2I& a, const VECTOR2I& b, const VECTOR2I& c )
+{
+    SEG::ecoord cross = ( (SEG::ecoord) b.x - a.x ) * ( (SEG::ecoord) c.y - a.y )
+                        - ( (SEG::ecoord) b.y - a.y ) * ( (SEG::ecoord) c.x - a.x );
+
+    return ( cross > 0 ) - ( cross < 0 );
+}
+
+
+/**
+ * @return true if p, which is colinear with the segment s, is on it.
+ */
+static bool onSegment( const SEG& s, const VECTOR2I& p )
+{
+    return std::min( s.A.x, s.B.x ) <= p.x && p.x <= std::max( s.A.x, s.B.x )
+           && std::min( s.A.y, s.B.y ) <= p.y && p.y <= std::max( s.A.y, s.B.y );
+}
+
+
+/**
+ * @return true if the segments have a common point, including when they only touch or are
+ * colinear and overlap (which SEG::Intersect() does not report).
+ */
+static bool segmentsTouch( const SEG& a, const SEG& b )
+{
+    int o1 = orientation( a.A, a.B, b.A );
+    int o2 = orientation( a.A, a.B, b.B );
+    int o3 = orientation( b.A, b.B, a.A );
+    int o4 = orientation( b.A, b.B, a.B );
+
+    if( o1 != o2 && o3 != o4 )
+        return true;
+
+    return ( o1 == 0 && onSegment( a, b.A ) ) || ( o2 == 0 && onSegment( a, b.B ) )
+           || ( o3 == 0 && onSegment( b, a.A ) ) || ( o4 == 0 && onSegment( b, a.B ) );
+}
+
+
+static BOX2I segmentBox( const SEG& aSeg )
+{
+    BOX2I box( aSeg.A, aSeg.B - aSeg.A );
+    box.Normalize();
+    return box;
+}
+
+
+/**
+ * The narrow phase: a cheap test which tells two courtyards whose bounding boxes overlap
+ * certainly do not overlap, unless their outlines touch or cross, or one courtyard has an
+ * outline inside the other one.  Only the courtyards which pass it need a polygon boolean.
+ *
+ * @param aEdges is a buffer for the edges of aB near aA.
+ */
+static bool mayOverlap( const COURTYARD& aA, const COURTYARD& aB, std::vector<SEG>& aEdges )
+{
+    BOX2I common = aA.m_bbox;
+    common = common.Intersect( aB.m_bbox );
+
+    aEdges.clear();
+
+    for( auto seg = aB.m_poly->CIterateSegmentsWithHoles(); seg; seg++ )
+    {
+        if( segmentBox( *seg ).Intersects( common ) )
+            aEdges.push_back( *seg );
+    }
+
+    for( auto seg = aA.m_poly->CIterateSegmentsWithHoles(); seg; seg++ )
+    {
+        const SEG segA = *seg;
+        BOX2I     boxA = segmentBox( segA );
+
+        if( !boxA.Intersects( common ) )
+            continue;
+
+        for( const SEG& segB : aEdges )
+        {
+            if( boxA.Intersects( segmentBox( segB ) ) && segmentsTouch( segA, segB ) )
+                return true;
         }
     }
 
-    // Test for overlapping on bottom layer:
-    for( MODULE* footprint = aBoard.m_Modules; footprint; footprint = footprint->Next() )
+    // The outlines are disjoint: each outline is entirely inside or outside the other
+    // courtyard
+    for( int ii = 0; ii < aA.m_poly->OutlineCount(); ii++ )
+    {
+        if( aB.m_poly->Contains( aA.m_poly->COutline( ii ).CPoint( 0 ) ) )
+            return true;
+    }
+
+    for( int ii = 0; ii < aB.m_poly->OutlineCount(); ii++ )
+    {
+        if( aA.m_poly->Contains( aB.m_poly->COutline( ii ).CPoint( 0 ) ) )
+            return true;
+    }
+
+    return false;
+}
+
+
+bool DRC_COURTYARD_OVERLAP::testOverlappingCourtyards( BOARD& aBoard, bool aFront ) const
+{
+    const DRC_MARKER_FACTORY& marker_factory = GetMarkerFactory();
+    std::vector<COURTYARD>    courtyards;
+    int                       index = 0;
+    bool                      success = true;
+
+    for( MODULE* footprint = aBoard.m_Modules; footprint; footprint = footprint->Next(), index++ )
     {
-        if( footprint->GetPolyCourtyardBack().OutlineCount() == 0 )
+        const SHAPE_POLY_SET& poly = aFront ? footprint->GetPolyCourtyardFront()
+                                            : footprint->GetPolyCourtyardBack();
+
+        if( poly.OutlineCount() == 0 )
             continue; // No courtyard defined
 
-        for( MODULE* candidate = footprint->Next(); candidate; candidate = candidate->Next() )
-        {
-            if( candidate->GetPolyCourtyardBack().OutlineCount() == 0 )
-                continue; // No courtyard defined
+        courtyards.push_back( { footprint, &poly, poly.BBox(), index } );
+    }
+
+    // The broad phase: sweep and prune along X over the bounding boxes.  Only the courtyards
+    // whose bounding boxes overlap can overlap.
+    std::sort( courtyards.begin(), courtyards.end(),
+               []( const COURTYARD& a, const COURTYARD& b )
+               {
+                   return a.m_bbox.GetLeft() < b.m_bbox.GetLeft();
+               } );
+
+    std::vector<std::pair<const COURTYARD*, const COURTYARD*>> candidates;
+    std::vector<SEG>                                           edges;
 
-            courtyard.RemoveAllContours();
-            courtyard.Append( footprint->GetPolyCourtyardBack() );
+    for( size_t ii = 0; ii < courtyards.size(); ii++ )
+    {
+        const COURTYARD& first = courtyards[ii];
+
+        for( size_t jj = ii + 1; jj < courtyards.size(); jj++ )
+        {
+            const COURTYARD& second = courtyards[jj];
 
-            // Build the common area between footprint and the candidate:
-            courtyard.BooleanIntersection(
-                    candidate->GetPolyCourtyardBack(), SHAPE_POLY_SET::PM_FAST );
+            if( second.m_bbox.GetLeft() > first.m_bbox.GetRight() )
+                break;
 
-            // If no overlap, courtyard is empty (no common area).
-            // Therefore if a common polygon exists, this is a DRC error
-            if( courtyard.OutlineCount() )
+            if( second.m_bbox.GetTop() > first.m_bbox.GetBottom()
+                    || first.m_bbox.GetTop() > second.m_bbox.GetBottom() )
             {
-                //Overlap between footprint and candidate
-                VECTOR2I& pos = courtyard.Vertex( 0, 0, -1 );
-                auto      marker = std::unique_ptr<MARKER_PCB>(
-                        marker_factory.NewMarker( wxPoint( pos.x, pos.y ), footprint, candidate,
-                                DRCE_OVERLAPPING_FOOTPRINTS ) );
-                HandleMarker( std::move( marker ) );
-                success = false;
+                continue;
             }
+
+            if( !mayOverlap( first, second, edges ) )
+                continue;
+
+            // Report the pairs in the order of the footprints of the board, as they always were
+            if( first.m_index < second.m_index )
+                candidates.emplace_back( &first, &second );
+            else
+                candidates.emplace_back( &second, &first );
+        }
+    }
+
+    std::sort( candidates.begin(), candidates.end(),
+               []( const std::pair<const COURTYARD*, const COURTYARD*>& a,
+                   const std::pair<const COURTYARD*, const COURTYARD*>& b )
+               {
+                   if( a.first->m_index != b.first->m_index )
+                       return a.first->m_index < b.first->m_index;
+
+                   return a.second->m_index < b.second->m_index;
+               } );
+
+    wxLogTrace( DRC_COURTYARD_TRACE, "%s: %zu courtyards, %zu candidate pairs",
+                aFront ? "Front" : "Back", courtyards.size(), candidates.size() );
+
+    SHAPE_POLY_SET courtyard; // temporary storage of the courtyard of current footprint
+
+    for( const auto& pair : candidates )
+    {
+        MODULE* footprint = pair.first->m_footprint;
+        MODULE* candidate = pair.second->m_footprint;
+
+        courtyard.RemoveAllContours();
+        courtyard.Append( *pair.first->m_poly );
+
+        // Build the common area between footprint and the candidate:
+        courtyard.BooleanIntersection( *pair.second->m_poly, SHAPE_POLY_SET::PM_FAST );
+
+        // If no overlap, courtyard is empty (no common area).
+        // Therefore if a common polygon exists, this is a DRC error
+        if( courtyard.OutlineCount() )
+        {
+            //Overlap between footprint and candidate
+            VECTOR2I& pos = courtyard.Vertex( 0, 0, -1 );
+            auto      marker = std::unique_ptr<MARKER_PCB>(
+                    marker_factory.NewMarker( wxPoint( pos.x, pos.y ), footprint, candidate,
+                            DRCE_OVERLAPPING_FOOTPRINTS ) );
+            HandleMarker( std::move( marker ) );
+            success = false;
         }
     }
 
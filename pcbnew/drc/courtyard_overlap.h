@@ -39,6 +39,14 @@ public:
             const DRC_MARKER_FACTORY& aMarkerFactory, MARKER_HANDLER aMarkerHandler );
 
     bool RunDRC( BOARD& aBoard ) const override;
+
+private:
+    /**
+     * Test the overlaps of the front or back courtyards of the footprints.
+     *
+     * @return false if some courtyards overlap.
+     */
+    bool testOverlappingCourtyards( BOARD& aBoard, bool aFront ) const;
 };
 
 #endif // DRC_COURTYARD_OVERLAP__H
\ No newline at end of file
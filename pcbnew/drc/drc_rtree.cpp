@@ -0,0 +1,231 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <drc/drc_rtree.h>
+
+#include <algorithm>
+
+#include <class_board.h>
+#include <class_pad.h>
+#include <class_track.h>
+#include <class_zone.h>
+
+
+DRC_RTREE::DRC_RTREE() :
+        m_maxClearance( 0 )
+{
+}
+
+
+DRC_RTREE::~DRC_RTREE()
+{
+}
+
+
+void DRC_RTREE::clear()
+{
+    m_tracks.clear();
+    m_trackIndex.clear();
+    m_pads.clear();
+    m_zones.clear();
+
+    for( int layer = 0; layer < PCB_LAYER_ID_COUNT; ++layer )
+    {
+        m_trackTrees[layer].reset();
+        m_padTrees[layer].reset();
+        m_zoneTrees[layer].reset();
+    }
+
+    m_holeTree.reset();
+    m_maxClearance = 0;
+}
+
+
+void DRC_RTREE::insert( std::unique_ptr<INDEX_RTREE>* aTrees, PCB_LAYER_ID aLayer,
+                        const EDA_RECT& aBBox, int aIndex )
+{
+    std::unique_ptr<INDEX_RTREE>& tree = aTrees[aLayer];
+
+    if( !tree )
+        tree.reset( new INDEX_RTREE() );
+
+    const int mmin[2] = { aBBox.GetLeft(), aBBox.GetTop() };
+    const int mmax[2] = { aBBox.GetRight(), aBBox.GetBottom() };
+
+    tree->Insert( mmin, mmax, aIndex );
+}
+
+
+void DRC_RTREE::query( const std::unique_ptr<INDEX_RTREE>* aTrees, const LSET& aLayers,
+                       const EDA_RECT& aBBox, std::vector<int>& aResult ) const
+{
+    const int mmin[2] = { aBBox.GetLeft(), aBBox.GetTop() };
+    const int mmax[2] = { aBBox.GetRight(), aBBox.GetBottom() };
+
+    auto collect = [&aResult]( const intptr_t& aIndex ) -> bool
+    {
+        aResult.push_back( (int) aIndex );
+        return true;
+    };
+
+    for( PCB_LAYER_ID layer : aLayers.Seq() )
+    {
+        if( aTrees[layer] )
+            aTrees[layer]->Search( mmin, mmax, collect );
+    }
+
+    // Multilayer items are found once per layer, and the tests expect the board order
+    std::sort( aResult.begin(), aResult.end() );
+    aResult.erase( std::unique( aResult.begin(), aResult.end() ), aResult.end() );
+}
+
+
+void DRC_RTREE::Build( BOARD* aBoard )
+{
+    clear();
+
+    for( TRACK* track = aBoard->m_Track; track; track = track->Next() )
+    {
+        int      index = (int) m_tracks.size();
+        EDA_RECT bbox = track->GetBoundingBox();
+
+        m_tracks.push_back( track );
+        m_trackIndex[ track ] = index;
+
+        for( PCB_LAYER_ID layer : track->GetLayerSet().Seq() )
+            insert( m_trackTrees, layer, bbox, index );
+
+        m_maxClearance = std::max( m_maxClearance, track->GetClearance() );
+    }
+
+    m_pads = aBoard->GetPads();
+
+    for( int index = 0; index < (int) m_pads.size(); ++index )
+    {
+        D_PAD*   pad = m_pads[index];
+        EDA_RECT bbox = pad->GetBoundingBox();
+
+        for( PCB_LAYER_ID layer : pad->GetLayerSet().Seq() )
+            insert( m_padTrees, layer, bbox, index );
+
+        if( pad->GetDrillSize().x )
+        {
+            EDA_RECT holeBBox( pad->GetPosition(), wxSize( 0, 0 ) );
+            holeBBox.Inflate( std::max( pad->GetDrillSize().x, pad->GetDrillSize().y ) / 2 + 1 );
+
+            if( !m_holeTree )
+                m_holeTree.reset( new INDEX_RTREE() );
+
+            const int mmin[2] = { holeBBox.GetLeft(), holeBBox.GetTop() };
+            const int mmax[2] = { holeBBox.GetRight(), holeBBox.GetBottom() };
+
+            m_holeTree->Insert( mmin, mmax, index );
+        }
+
+        m_maxClearance = std::max( m_maxClearance, pad->GetClearance() );
+    }
+
+    for( ZONE_CONTAINER* zone : aBoard->Zones() )
+    {
+        int index = (int) m_zones.size();
+
+        m_zones.push_back( zone );
+
+        // Same filter as the zone pass of DRC::doTrackDrc()
+        if( zone->GetFilledPolysList().IsEmpty() || zone->GetIsKeepout() )
+            continue;
+
+        EDA_RECT bbox = zone->GetBoundingBox();
+
+        for( PCB_LAYER_ID layer : zone->GetLayerSet().Seq() )
+            insert( m_zoneTrees, layer, bbox, index );
+
+        m_maxClearance = std::max( m_maxClearance, zone->GetClearance() );
+    }
+}
+
+
+void DRC_RTREE::QueryTracks( TRACK* aRefSeg, int aMargin, std::vector<TRACK*>& aTracks ) const
+{
+    std::vector<int> found;
+    EDA_RECT         bbox = aRefSeg->GetBoundingBox();
+
+    bbox.Inflate( aMargin );
+    query( m_trackTrees, aRefSeg->GetLayerSet(), bbox, found );
+
+    // Only tracks following aRefSeg are tested: the previous ones have already been
+    // tested against it.  An unknown aRefSeg (not in the board) is tested against all.
+    auto it = m_trackIndex.find( aRefSeg );
+    int  first = ( it != m_trackIndex.end() ) ? it->second + 1 : 0;
+
+    aTracks.clear();
+
+    for( int index : found )
+    {
+        if( index >= first )
+            aTracks.push_back( m_tracks[index] );
+    }
+}
+
+
+void DRC_RTREE::QueryPads( TRACK* aRefSeg, int aMargin, std::vector<D_PAD*>& aPads ) const
+{
+    std::vector<int> found;
+    EDA_RECT         bbox = aRefSeg->GetBoundingBox();
+
+    bbox.Inflate( aMargin );
+
+    if( m_holeTree )
+    {
+        const int mmin[2] = { bbox.GetLeft(), bbox.GetTop() };
+        const int mmax[2] = { bbox.GetRight(), bbox.GetBottom() };
+
+        m_holeTree->Search( mmin, mmax, [&found]( const intptr_t& aIndex ) -> bool
+                                        {
+                                            found.push_back( (int) aIndex );
+                                            return true;
+                                        } );
+    }
+
+    query( m_padTrees, aRefSeg->GetLayerSet(), bbox, found );
+
+    aPads.clear();
+
+    for( int index : found )
+        aPads.push_back( m_pads[index] );
+}
+
+
+void DRC_RTREE::QueryZones( TRACK* aRefSeg, int aMargin,
+                            std::vector<ZONE_CONTAINER*>& aZones ) const
+{
+    std::vector<int> found;
+    EDA_RECT         bbox = aRefSeg->GetBoundingBox();
+
+    bbox.Inflate( aMargin );
+    query( m_zoneTrees, aRefSeg->GetLayerSet(), bbox, found );
+
+    aZones.clear();
+
+    for( int index : found )
+        aZones.push_back( m_zones[index] );
+}
@@ -0,0 +1,119 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef DRC_RTREE__H
+#define DRC_RTREE__H
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <eda_rect.h>
+#include <layers_id_colors_and_visibility.h>
+
+#include <geometry/rtree.h>
+
+class BOARD;
+class D_PAD;
+class TRACK;
+class ZONE_CONTAINER;
+
+
+/**
+ * Class DRC_RTREE
+ *
+ * A spatial index of the copper items of a board (tracks, vias, pads and filled zones),
+ * built once per DRC run so that each item is only tested against the items lying
+ * within the largest clearance of the board instead of against the whole board.
+ *
+ * Items are stored in one R-tree per layer.  Query results are returned in the same
+ * order the items have in the board lists (BOARD::m_Track, BOARD::GetPads() and
+ * BOARD::Zones()), so the tests walking them report exactly the same errors, in the
+ * same order, as the tests walking the board lists.
+ *
+ * Non-owning: the board must not be modified while the index is in use.
+ */
+class DRC_RTREE
+{
+public:
+    DRC_RTREE();
+    ~DRC_RTREE();
+
+    /**
+     * Index the tracks, vias, pads and zones of aBoard, discarding any previous content.
+     */
+    void Build( BOARD* aBoard );
+
+    /**
+     * @return the largest clearance of any indexed item, i.e. the farthest distance at
+     * which two indexed items can still violate a clearance rule.
+     */
+    int GetMaxClearance() const { return m_maxClearance; }
+
+    /**
+     * Collect the tracks and vias following aRefSeg in BOARD::m_Track which share a layer
+     * with aRefSeg and whose bounding box is closer than aMargin to aRefSeg's one.
+     */
+    void QueryTracks( TRACK* aRefSeg, int aMargin, std::vector<TRACK*>& aTracks ) const;
+
+    /**
+     * Collect the pads which can be closer than aMargin to aRefSeg: pads sharing a layer
+     * with aRefSeg and drilled pads on any layer (their hole is tested on all layers).
+     */
+    void QueryPads( TRACK* aRefSeg, int aMargin, std::vector<D_PAD*>& aPads ) const;
+
+    /**
+     * Collect the filled, non-keepout zones sharing a layer with aRefSeg whose bounding
+     * box is closer than aMargin to aRefSeg's one.
+     */
+    void QueryZones( TRACK* aRefSeg, int aMargin, std::vector<ZONE_CONTAINER*>& aZones ) const;
+
+private:
+    /// Items are stored by their index in the corresponding board list (pointer sized,
+    /// as RTree stores its data in the space of a node pointer)
+    typedef RTree<intptr_t, int, 2, double> INDEX_RTREE;
+
+    void insert( std::unique_ptr<INDEX_RTREE>* aTrees, PCB_LAYER_ID aLayer,
+                 const EDA_RECT& aBBox, int aIndex );
+
+    void query( const std::unique_ptr<INDEX_RTREE>* aTrees, const LSET& aLayers,
+                const EDA_RECT& aBBox, std::vector<int>& aResult ) const;
+
+    void clear();
+
+    std::vector<TRACK*>             m_tracks;
+    std::unordered_map<TRACK*, int> m_trackIndex;
+    std::vector<D_PAD*>             m_pads;
+    std::vector<ZONE_CONTAINER*>    m_zones;
+
+    std::unique_ptr<INDEX_RTREE>    m_trackTrees[PCB_LAYER_ID_COUNT];
+    std::unique_ptr<INDEX_RTREE>    m_padTrees[PCB_LAYER_ID_COUNT];
+    std::unique_ptr<INDEX_RTREE>    m_zoneTrees[PCB_LAYER_ID_COUNT];
+
+    /// Drilled pads, whose holes must be tested whatever the layers of the reference item
+    std::unique_ptr<INDEX_RTREE>    m_holeTree;
+
+    int                             m_maxClearance;
+};
+
+#endif // DRC_RTREE__H
@@ -137,7 +137,27 @@ bool convex2pointDRC( wxPoint* aTref, int aTrefCount, wxPoint aPcompare, int aDi
 
 bool DRC::doTrackDrc( TRACK* aRefSeg, TRACK* aStart, bool aTestPads, bool aTestZones )
 {
-    TRACK*    track;
+    std::vector<D_PAD*>          pads;
+    std::vector<TRACK*>          tracks;
+    std::vector<ZONE_CONTAINER*> zones;
+
+    if( aTestPads )
+        pads = m_pcb->GetPads();
+
+    for( TRACK* track = aStart; track; track = track->Next() )
+        tracks.push_back( track );
+
+    if( aTestZones )
+        zones = m_pcb->Zones();
+
+    return doTrackDrc( aRefSeg, pads, tracks, zones );
+}
+
+
+bool DRC::doTrackDrc( TRACK* aRefSeg, const std::vector<D_PAD*>& aPads,
+                      const std::vector<TRACK*>& aTracks,
+                      const std::vector<ZONE_CONTAINER*>& aZones )
+{
     wxPoint   delta;           // length on X and Y axis of segments
     LSET layerMask;
     int       net_code_ref;
@@ -158,6 +178,10 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACK* aStart, bool aTestPads, bool aTestZ
                 markers.pop_back();
             }
         }
+        else if( m_markerCollector )
+        {
+            m_markerCollector->insert( m_markerCollector->end(), markers.begin(), markers.end() );
+        }
         else
         {
             BOARD_COMMIT commit( m_pcbEditorFrame );
@@ -354,15 +378,9 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACK* aStart, bool aTestPads, bool aTestZ
     dummypad.SetLayerSet( LSET::AllCuMask() );     // Ensure the hole is on all layers
 
     // Compute the min distance to pads
-    if( aTestPads )
     {
-        unsigned pad_count = m_pcb->GetPadCount();
-
-        auto pads = m_pcb->GetPads();
-
-        for( unsigned ii = 0; ii < pad_count; ++ii )
+        for( D_PAD* pad : aPads )
         {
-            D_PAD* pad = pads[ii];
             SEG padSeg( pad->GetPosition(), pad->GetPosition() );
 
 
@@ -431,7 +449,7 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACK* aStart, bool aTestPads, bool aTestZ
     wxPoint segStartPoint;
     wxPoint segEndPoint;
 
-    for( track = aStart; track; track = track->Next() )
+    for( TRACK* track : aTracks )
     {
         // No problem if segments have the same net code:
         if( net_code_ref == track->GetNetCode() )
@@ -708,11 +726,10 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACK* aStart, bool aTestPads, bool aTestZ
     /* Phase 3: test DRC with copper zones */
     /***************************************/
     // Can be *very* time consumming.
-    if( aTestZones )
     {
         SEG refSeg( aRefSeg->GetStart(), aRefSeg->GetEnd() );
 
-        for( ZONE_CONTAINER* zone : m_pcb->Zones() )
+        for( ZONE_CONTAINER* zone : aZones )
         {
             if( zone->GetFilledPolysList().IsEmpty() || zone->GetIsKeepout() )
                 continue;
@@ -29,6 +29,7 @@
  */
 
 #include <fctsys.h>
+#include <advanced_config.h>
 #include <class_drawpanel.h>
 #include <confirm.h>
 #include <kicad_string.h>
@@ -687,7 +688,8 @@ wxString PCB_EDIT_FRAME::createBackupFile( const wxString& aFileName )
 }
 
 
-bool PCB_EDIT_FRAME::SavePcbFile( const wxString& aFileName, bool aCreateBackupFile )
+bool PCB_EDIT_FRAME::SavePcbFile( const wxString& aFileName, bool aCreateBackupFile,
+                                  bool aAutoSave )
 {
     // please, keep it simple.  prompting goes elsewhere.
 
@@ -731,7 +733,13 @@ bool PCB_EDIT_FRAME::SavePcbFile( const wxString& aFileName, bool aCreateBackupF
 
         wxASSERT( pcbFileName.IsAbsolute() );
 
-        pi->Save( pcbFileName.GetFullPath(), GetBoard(), NULL );
+        PROPERTIES props;
+
+        // Autosave files are not worth a zone fill cache
+        if( !aAutoSave && ADVANCED_CFG::GetCfg().m_zoneFillCache )
+            props["zone_fill_cache"] = "";
+
+        pi->Save( pcbFileName.GetFullPath(), GetBoard(), &props );
     }
     catch( const IO_ERROR& ioe )
     {
@@ -866,7 +874,7 @@ bool PCB_EDIT_FRAME::doAutoSave()
 
     wxLogTrace( traceAutoSave, "Creating auto save file <" + autoSaveFileName.GetFullPath() + ">" );
 
-    if( SavePcbFile( autoSaveFileName.GetFullPath(), NO_BACKUP_FILE ) )
+    if( SavePcbFile( autoSaveFileName.GetFullPath(), NO_BACKUP_FILE, true ) )
     {
         GetScreen()->SetModify();
         GetBoard()->SetFileName( tmpFileName.GetFullPath() );
@@ -0,0 +1,338 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <footprint_index.h>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include <wx/filename.h>
+#include <wx/stdpaths.h>
+
+#include <common.h>
+#include <class_module.h>
+
+
+/// Change this whenever the layout of the file changes: files of other versions are ignored
+#define FOOTPRINT_INDEX_VERSION     1
+
+static const char s_magic[8] = { 'K', 'I', 'F', 'P', 'I', 'D', 'X', '\n' };
+
+
+FOOTPRINT_INDEX_ENTRY::FOOTPRINT_INDEX_ENTRY( const wxString& aName, const MODULE* aFootprint ) :
+    m_name( aName ),
+    m_padCount( 0 ),
+    m_uniquePadCount( 0 ),
+    m_fileTime( 0 ),
+    m_fileSize( 0 )
+{
+    if( aFootprint )    // NULL only with malformed/broken libraries
+    {
+        m_description = aFootprint->GetDescription();
+        m_keywords = aFootprint->GetKeywords();
+        m_padCount = aFootprint->GetPadCount( DO_NOT_INCLUDE_NPTH );
+        m_uniquePadCount = aFootprint->GetUniquePadCount( DO_NOT_INCLUDE_NPTH );
+    }
+}
+
+
+FOOTPRINT_INDEX::FOOTPRINT_INDEX( const wxString& aLibraryPath ) :
+    m_libraryPath( aLibraryPath )
+{
+}
+
+
+/**
+ * The directory of the index files.  Like the 3D model cache, it is in the user's cache
+ * directory, since the libraries themselves may be read only:
+ *
+ * 1. OSX: ~/Library/Caches/kicad/footprints/
+ * 2. Linux: ${XDG_CACHE_HOME}/kicad/footprints/ or ~/.cache/kicad/footprints/
+ * 3. MSWin: AppData\Local\kicad\footprints
+ */
+static wxString indexDirectory()
+{
+    wxString cacheDir;
+
+#if defined( _WIN32 )
+    wxStandardPaths::Get().UseAppInfo( wxStandardPaths::AppInfo_None );
+    cacheDir = wxStandardPaths::Get().GetUserLocalDataDir();
+    cacheDir.append( "\\kicad\\footprints" );
+#elif defined( __APPLE__ )
+    cacheDir = "${HOME}/Library/Caches/kicad/footprints";
+#else   // assume Linux
+    cacheDir = ExpandEnvVarSubstitutions( "${XDG_CACHE_HOME}" );
+
+    if( cacheDir.empty() || cacheDir == "${XDG_CACHE_HOME}" )
+        cacheDir = "${HOME}/.cache";
+
+    cacheDir.append( "/kicad/footprints" );
+#endif
+
+    return ExpandEnvVarSubstitutions( cacheDir );
+}
+
+
+wxString FOOTPRINT_INDEX::GetFileName( const wxString& aLibraryPath )
+{
+    // A FNV-1a hash of the library path names its index; the path itself is stored in the
+    // index, so that a collision only costs a rebuild.
+    std::string path( aLibraryPath.ToUTF8() );
+    uint64_t    hash = 14695981039346656037ULL;
+
+    for( unsigned char cc : path )
+    {
+        hash ^= cc;
+        hash *= 1099511628211ULL;
+    }
+
+    wxFileName fn( indexDirectory(), wxString::Format( "%016llx", (unsigned long long) hash ),
+                   wxT( "idx" ) );
+
+    return fn.GetFullPath();
+}
+
+
+namespace
+{
+
+/**
+ * Reads the fields of an index, checking each read stays within the data
+ */
+class INDEX_READER
+{
+public:
+    INDEX_READER( const std::vector<char>& aData ) :
+        m_data( aData ),
+        m_pos( 0 )
+    {}
+
+    bool Read( void* aBuffer, size_t aSize )
+    {
+        if( aSize > m_data.size() - m_pos )
+            return false;
+
+        memcpy( aBuffer, m_data.data() + m_pos, aSize );
+        m_pos += aSize;
+        return true;
+    }
+
+    template<typename T>
+    bool Read( T& aValue )
+    {
+        return Read( &aValue, sizeof( T ) );
+    }
+
+    bool Read( wxString& aString )
+    {
+        uint32_t length;
+
+        if( !Read( length ) || length > m_data.size() - m_pos )
+            return false;
+
+        aString = wxString::FromUTF8( m_data.data() + m_pos, length );
+        m_pos += length;
+        return true;
+    }
+
+    bool AtEnd() const { return m_pos == m_data.size(); }
+
+private:
+    const std::vector<char>& m_data;
+    size_t                   m_pos;
+};
+
+
+void writeString( std::string& aOut, const wxString& aString )
+{
+    wxScopedCharBuffer utf8 = aString.ToUTF8();
+    uint32_t           length = utf8.length();
+
+    aOut.append( (const char*) &length, sizeof( length ) );
+    aOut.append( utf8.data(), length );
+}
+
+
+template<typename T>
+void writeValue( std::string& aOut, T aValue )
+{
+    aOut.append( (const char*) &aValue, sizeof( T ) );
+}
+
+}
+
+
+bool FOOTPRINT_INDEX::Read( const wxString& aFileName )
+{
+    Clear();
+
+    wxString fileName = aFileName.IsEmpty() ? GetFileName( m_libraryPath ) : aFileName;
+    FILE*    fp = wxFopen( fileName, wxT( "rb" ) );
+
+    if( !fp )
+        return false;
+
+    std::vector<char> data;
+    char              buffer[65536];
+    size_t            count;
+
+    while( ( count = fread( buffer, 1, sizeof( buffer ), fp ) ) > 0 )
+        data.insert( data.end(), buffer, buffer + count );
+
+    fclose( fp );
+
+    INDEX_READER reader( data );
+    char         magic[sizeof( s_magic )];
+    uint32_t     version;
+    wxString     libraryPath;
+    uint32_t     entryCount;
+
+    if( !reader.Read( magic, sizeof( magic ) ) || memcmp( magic, s_magic, sizeof( magic ) )
+            || !reader.Read( version ) || version != FOOTPRINT_INDEX_VERSION
+            || !reader.Read( libraryPath ) || libraryPath != m_libraryPath
+            || !reader.Read( entryCount ) )
+    {
+        return false;
+    }
+
+    for( uint32_t ii = 0; ii < entryCount; ++ii )
+    {
+        FOOTPRINT_INDEX_ENTRY entry;
+        uint32_t              padCount;
+        uint32_t              uniquePadCount;
+        int64_t               fileTime;
+        int64_t               fileSize;
+
+        if( !reader.Read( entry.m_name ) || !reader.Read( entry.m_description )
+                || !reader.Read( entry.m_keywords ) || !reader.Read( padCount )
+                || !reader.Read( uniquePadCount ) || !reader.Read( fileTime )
+                || !reader.Read( fileSize ) )
+        {
+            Clear();
+            return false;
+        }
+
+        entry.m_padCount = padCount;
+        entry.m_uniquePadCount = uniquePadCount;
+        entry.m_fileTime = fileTime;
+        entry.m_fileSize = fileSize;
+
+        Add( entry );
+    }
+
+    if( !reader.AtEnd() )
+    {
+        Clear();
+        return false;
+    }
+
+    return true;
+}
+
+
+bool FOOTPRINT_INDEX::Write( const wxString& aFileName ) const
+{
+    wxString   fileName = aFileName.IsEmpty() ? GetFileName( m_libraryPath ) : aFileName;
+    wxFileName fn( fileName );
+
+    if( !fn.DirExists() && !wxFileName::Mkdir( fn.GetPath(), wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL ) )
+        return false;
+
+    std::string data( s_magic, sizeof( s_magic ) );
+
+    writeValue<uint32_t>( data, FOOTPRINT_INDEX_VERSION );
+    writeString( data, m_libraryPath );
+    writeValue<uint32_t>( data, m_entries.size() );
+
+    for( const FOOTPRINT_INDEX_ENTRY& entry : m_entries )
+    {
+        writeString( data, entry.m_name );
+        writeString( data, entry.m_description );
+        writeString( data, entry.m_keywords );
+        writeValue<uint32_t>( data, entry.m_padCount );
+        writeValue<uint32_t>( data, entry.m_uniquePadCount );
+        writeValue<int64_t>( data, entry.m_fileTime );
+        writeValue<int64_t>( data, entry.m_fileSize );
+    }
+
+    // Write a temporary file and rename it, so that no reader can see a partial index
+    wxString tempFileName = wxFileName::CreateTempFileName( fileName );
+
+    if( tempFileName.IsEmpty() )
+        return false;
+
+    FILE* fp = wxFopen( tempFileName, wxT( "wb" ) );
+    bool  ok = fp && fwrite( data.data(), 1, data.size(), fp ) == data.size();
+
+    if( fp && fclose( fp ) != 0 )
+        ok = false;
+
+    if( !ok || !wxRenameFile( tempFileName, fileName, true ) )
+    {
+        wxRemoveFile( tempFileName );
+        return false;
+    }
+
+    return true;
+}
+
+
+const FOOTPRINT_INDEX_ENTRY* FOOTPRINT_INDEX::Find( const wxString& aName, long long aFileTime,
+                                                    long long aFileSize ) const
+{
+    auto it = m_byName.find( aName );
+
+    if( it == m_byName.end() )
+        return nullptr;
+
+    const FOOTPRINT_INDEX_ENTRY& entry = m_entries[it->second];
+
+    if( entry.m_fileTime == 0 || entry.m_fileTime != aFileTime || entry.m_fileSize != aFileSize )
+        return nullptr;
+
+    return &entry;
+}
+
+
+void FOOTPRINT_INDEX::Add( const FOOTPRINT_INDEX_ENTRY& aEntry )
+{
+    auto it = m_byName.find( aEntry.m_name );
+
+    if( it != m_byName.end() )
+    {
+        m_entries[it->second] = aEntry;
+    }
+    else
+    {
+        m_byName[aEntry.m_name] = m_entries.size();
+        m_entries.push_back( aEntry );
+    }
+}
+
+
+void FOOTPRINT_INDEX::Clear()
+{
+    m_entries.clear();
+    m_byName.clear();
+}
@@ -0,0 +1,132 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file footprint_index.h
+ * @brief An on-disk index of the footprints of a library, for the footprint chooser.
+ */
+
+#ifndef FOOTPRINT_INDEX_H
+#define FOOTPRINT_INDEX_H
+
+#include <map>
+#include <vector>
+
+#include <wx/string.h>
+
+class MODULE;
+
+
+/**
+ * Struct FOOTPRINT_INDEX_ENTRY
+ * is what the footprint chooser shows of a footprint, and the stamp of the file it was read
+ * from, which tells whether the entry is still valid.
+ */
+struct FOOTPRINT_INDEX_ENTRY
+{
+    FOOTPRINT_INDEX_ENTRY() :
+        m_padCount( 0 ),
+        m_uniquePadCount( 0 ),
+        m_fileTime( 0 ),
+        m_fileSize( 0 )
+    {}
+
+    /**
+     * Build the entry of @a aFootprint, which may be NULL for a footprint which could not
+     * be read.
+     */
+    FOOTPRINT_INDEX_ENTRY( const wxString& aName, const MODULE* aFootprint );
+
+    wxString  m_name;
+    wxString  m_description;
+    wxString  m_keywords;
+    unsigned  m_padCount;           ///< pads, not counting the NPTH pads
+    unsigned  m_uniquePadCount;     ///< pads with different names, not counting the NPTH pads
+
+    long long m_fileTime;           ///< modification time of the footprint file, 0 if unknown
+    long long m_fileSize;           ///< size of the footprint file
+};
+
+
+/**
+ * Class FOOTPRINT_INDEX
+ * holds the FOOTPRINT_INDEX_ENTRY of each footprint of a library, and stores them in a
+ * compact binary file in the user cache directory, one file per library.
+ * <p>
+ * The file is a cache: it is versioned, and any file which cannot be read (other version,
+ * other library, truncated...) is ignored, so the entries are then rebuilt from the
+ * footprint files.  It is written in the native byte order, since it is never shared.
+ */
+class FOOTPRINT_INDEX
+{
+public:
+    FOOTPRINT_INDEX( const wxString& aLibraryPath );
+
+    const wxString& GetLibraryPath() const { return m_libraryPath; }
+
+    /**
+     * Function GetFileName
+     * returns the name of the index file of the library @a aLibraryPath.
+     */
+    static wxString GetFileName( const wxString& aLibraryPath );
+
+    /**
+     * Function Read
+     * replaces the entries by the ones of the file @a aFileName, or the index file of the
+     * library if empty.
+     *
+     * @return false, leaving no entries, if the file does not exist or is not a valid index
+     *  of this library.
+     */
+    bool Read( const wxString& aFileName = wxEmptyString );
+
+    /**
+     * Function Write
+     * writes the entries in the file @a aFileName, or the index file of the library if empty.
+     *
+     * @return false if the file cannot be written.  The index is only a cache, so this is not
+     *  an error.
+     */
+    bool Write( const wxString& aFileName = wxEmptyString ) const;
+
+    /**
+     * Function Find
+     * returns the entry of the footprint @a aName if it was read from a file having the
+     * given modification time and size, or NULL.
+     */
+    const FOOTPRINT_INDEX_ENTRY* Find( const wxString& aName, long long aFileTime,
+                                       long long aFileSize ) const;
+
+    void Add( const FOOTPRINT_INDEX_ENTRY& aEntry );
+
+    void Clear();
+
+    const std::vector<FOOTPRINT_INDEX_ENTRY>& GetEntries() const { return m_entries; }
+
+private:
+    wxString                           m_libraryPath;
+    std::vector<FOOTPRINT_INDEX_ENTRY> m_entries;
+    std::map<wxString, size_t>         m_byName;       ///< index of the entries by name
+};
+
+#endif  // FOOTPRINT_INDEX_H
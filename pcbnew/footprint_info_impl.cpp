@@ -26,6 +26,7 @@
 #include <common.h>
 #include <fctsys.h>
 #include <footprint_info.h>
+#include <footprint_index.h>
 #include <fp_lib_table.h>
 #include <html_messagebox.h>
 #include <io_mgr.h>
@@ -38,7 +39,6 @@
 #include <wildcards_and_files_ext.h>
 #include <widgets/progress_reporter.h>
 
-#include <thread>
 #include <mutex>
 
 
@@ -184,7 +184,7 @@ void FOOTPRINT_LIST_IMPL::StartWorkers( FP_LIB_TABLE* aTable, wxString const* aN
     m_count_finished.store( 0 );
     m_errors.clear();
     m_list.clear();
-    m_threads.clear();
+    m_loaderTasks.reset( new TASK_GROUP );
     m_queue_in.clear();
     m_queue_out.clear();
 
@@ -199,9 +199,7 @@ void FOOTPRINT_LIST_IMPL::StartWorkers( FP_LIB_TABLE* aTable, wxString const* aN
     m_loader->m_total_libs = m_queue_in.size();
 
     for( unsigned i = 0; i < aNThreads; ++i )
-    {
-        m_threads.push_back( std::thread( &FOOTPRINT_LIST_IMPL::loader_job, this ) );
-    }
+        m_loaderTasks->Run( [this]() { loader_job(); } );
 }
 
 void FOOTPRINT_LIST_IMPL::StopWorkers()
@@ -210,12 +208,9 @@ void FOOTPRINT_LIST_IMPL::StopWorkers()
 
     // To safely stop our workers, we set the cancellation flag (they will each
     // exit on their next safe loop location when this is set).  Then we need to wait
-    // for all threads to finish as closing the implementation will free the queues
-    // that the threads write to.
-    for( auto& i : m_threads )
-        i.join();
-
-    m_threads.clear();
+    // for all tasks to finish as closing the implementation will free the queues
+    // that the tasks write to.
+    m_loaderTasks.reset();
     m_queue_in.clear();
     m_count_finished.store( 0 );
 
@@ -229,16 +224,14 @@ bool FOOTPRINT_LIST_IMPL::JoinWorkers()
     {
         std::lock_guard<std::mutex> lock1( m_join );
 
-        for( auto& i : m_threads )
-            i.join();
+        if( m_loaderTasks )
+            m_loaderTasks->Wait();
 
-        m_threads.clear();
+        m_loaderTasks.reset();
         m_queue_in.clear();
         m_count_finished.store( 0 );
     }
 
-    size_t total_count = m_queue_out.size();
-
     LOCALE_IO toggle_locale;
 
     // Parse the footprints in parallel. WARNING! This requires changing the locale, which is
@@ -249,20 +242,22 @@ bool FOOTPRINT_LIST_IMPL::JoinWorkers()
     // TODO: blast LOCALE_IO into the sun
 
     SYNC_QUEUE<std::unique_ptr<FOOTPRINT_INFO>> queue_parsed;
-    std::vector<std::thread>                    threads;
+    TASK_GROUP                                  tasks;
 
-    for( size_t ii = 0; ii < std::thread::hardware_concurrency() + 1; ++ii )
+    for( size_t ii = 0; ii < THREAD_POOL::GetInstance().GetThreadCount(); ++ii )
     {
-        threads.push_back( std::thread( [this, &queue_parsed]() {
+        tasks.Run( [this, &queue_parsed, &tasks]() {
             wxString nickname;
 
-            while( this->m_queue_out.pop( nickname ) && !m_cancelled )
+            while( this->m_queue_out.pop( nickname ) && !m_cancelled && !tasks.IsCancelled() )
             {
-                wxArrayString fpnames;
+                std::vector<FOOTPRINT_INDEX_ENTRY> entries;
 
+                // Libraries with an up to date index are not parsed: the footprints are
+                // loaded when they are used
                 try
                 {
-                    m_lib_table->FootprintEnumerate( fpnames, nickname );
+                    m_lib_table->EnumerateFootprintIndex( entries, nickname );
                 }
                 catch( const IO_ERROR& ioe )
                 {
@@ -282,10 +277,14 @@ bool FOOTPRINT_LIST_IMPL::JoinWorkers()
                     }
                 }
 
-                for( unsigned jj = 0; jj < fpnames.size() && !m_cancelled; ++jj )
+                for( unsigned jj = 0; jj < entries.size() && !m_cancelled; ++jj )
                 {
-                    wxString fpname = fpnames[jj];
-                    FOOTPRINT_INFO* fpinfo = new FOOTPRINT_INFO_IMPL( this, nickname, fpname );
+                    const FOOTPRINT_INDEX_ENTRY& entry = entries[jj];
+                    FOOTPRINT_INFO* fpinfo = new FOOTPRINT_INFO_IMPL( nickname, entry.m_name,
+                                                                      entry.m_description,
+                                                                      entry.m_keywords, 0,
+                                                                      entry.m_padCount,
+                                                                      entry.m_uniquePadCount );
                     queue_parsed.move_push( std::unique_ptr<FOOTPRINT_INFO>( fpinfo ) );
                 }
 
@@ -294,19 +293,12 @@ bool FOOTPRINT_LIST_IMPL::JoinWorkers()
 
                 m_count_finished.fetch_add( 1 );
             }
-        } ) );
-    }
-
-    while( !m_cancelled && (size_t)m_count_finished.load() < total_count )
-    {
-        if( m_progress_reporter && !m_progress_reporter->KeepRefreshing() )
-            m_cancelled = true;
-
-        wxMilliSleep( 30 );
+        } );
     }
 
-    for( auto& thr : threads )
-        thr.join();
+    // The reporter is refreshed while waiting, and cancels the tasks if asked to
+    if( !tasks.Wait( m_progress_reporter ) )
+        m_cancelled = true;
 
     std::unique_ptr<FOOTPRINT_INFO> fpi;
 
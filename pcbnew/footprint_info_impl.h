@@ -23,11 +23,12 @@
 #include <atomic>
 #include <functional>
 #include <memory>
-#include <thread>
+#include <mutex>
 #include <vector>
 
 #include <footprint_info.h>
 #include <sync_queue.h>
+#include <thread_pool.h>
 
 class LOCALE_IO;
 
@@ -84,7 +85,7 @@ protected:
 class FOOTPRINT_LIST_IMPL : public FOOTPRINT_LIST
 {
     FOOTPRINT_ASYNC_LOADER*  m_loader;
-    std::vector<std::thread> m_threads;
+    std::unique_ptr<TASK_GROUP> m_loaderTasks;
     SYNC_QUEUE<wxString>     m_queue_in;
     SYNC_QUEUE<wxString>     m_queue_out;
     std::atomic_size_t       m_count_finished;
@@ -28,6 +28,7 @@
 #include <richio.h>
 #include <map>
 #include <functional>
+#include <vector>
 #include <wx/time.h>
 
 #include <config.h>
@@ -36,6 +37,7 @@ class BOARD;
 class PLUGIN;
 class MODULE;
 class PROPERTIES;
+struct FOOTPRINT_INDEX_ENTRY;
 
 
 /**
@@ -358,6 +360,31 @@ public:
     virtual void FootprintEnumerate( wxArrayString& aFootprintNames, const wxString& aLibraryPath,
                                      const PROPERTIES* aProperties = NULL );
 
+    /**
+     * Function EnumerateFootprintIndex
+     * returns what the footprint chooser shows of each footprint of a library: name,
+     * description, keywords and pad counts (see FOOTPRINT_INDEX_ENTRY).
+     *
+     * Plugins which can find them without loading every footprint, e.g. from a
+     * FOOTPRINT_INDEX, should override this; the default implementation loads the library.
+     *
+     * @param aEntries is filled with the entries of the footprints of the library.
+     *
+     * @param aLibraryPath is a locator for the "library", usually a directory, file,
+     *   or URL containing several footprints.
+     *
+     * @param aProperties is an associative array that can be used to tell the
+     *  plugin anything needed about how to perform with respect to @a aLibraryPath.
+     *  The caller continues to own this object (plugin may not delete it), and
+     *  plugins should expect it to be optionally NULL.
+     *
+     * @throw IO_ERROR if the library cannot be found, or footprints cannot be loaded.  The
+     *  entries of the footprints which could be loaded are still returned.
+     */
+    virtual void EnumerateFootprintIndex( std::vector<FOOTPRINT_INDEX_ENTRY>& aEntries,
+                                          const wxString& aLibraryPath,
+                                          const PROPERTIES* aProperties = NULL );
+
     /**
      * Generate a timestamp representing all the files in the library (including the library
      * directory).
@@ -43,7 +43,10 @@
 #include <pcb_plot_params.h>
 #include <zones.h>
 #include <kicad_plugin.h>
+#include <footprint_index.h>
 #include <pcb_parser.h>
+#include <properties.h>
+#include <zone_fill_cache.h>
 
 #include <wx/dir.h>
 #include <wx/filename.h>
@@ -361,16 +364,25 @@ void PCB_IO::Save( const wxString& aFileName, BOARD* aBoard, const PROPERTIES* a
     // Prepare net mapping that assures that net codes saved in a file are consecutive integers
     m_mapping->SetBoard( aBoard );
 
-    FILE_OUTPUTFORMATTER    formatter( aFileName );
+    {
+        FILE_OUTPUTFORMATTER    formatter( aFileName );
 
-    m_out = &formatter;     // no ownership
+        m_out = &formatter;     // no ownership
 
-    m_out->Print( 0, "(kicad_pcb (version %d) (host pcbnew %s)\n", SEXPR_BOARD_FILE_VERSION,
-                  formatter.Quotew( GetBuildVersion() ).c_str() );
+        m_out->Print( 0, "(kicad_pcb (version %d) (host pcbnew %s)\n", SEXPR_BOARD_FILE_VERSION,
+                      formatter.Quotew( GetBuildVersion() ).c_str() );
 
-    Format( aBoard, 1 );
+        Format( aBoard, 1 );
 
-    m_out->Print( 0, ")\n" );
+        m_out->Print( 0, ")\n" );
+    }   // closes the file, which the zone fill cache is the cache of
+
+    wxString fillCacheFileName = ZONE_FILL_CACHE::GetFileName( aFileName );
+
+    if( m_props && m_props->Value( "zone_fill_cache" ) )
+        ZONE_FILL_CACHE::Write( aBoard, aFileName );
+    else if( wxFileExists( fillCacheFileName ) )
+        wxRemoveFile( fillCacheFileName );
 }
 
 
@@ -1925,12 +1937,44 @@ PCB_IO::~PCB_IO()
 
 BOARD* PCB_IO::Load( const wxString& aFileName, BOARD* aAppendToMe, const PROPERTIES* aProperties )
 {
-    FILE_LINE_READER    reader( aFileName );
-
     init( aProperties );
 
+    // A board appended to another one does not have the zones of the cache
+    ZONE_FILL_CACHE fillCache;
+    BOARD*          board = parseBoard( aFileName, aAppendToMe,
+                                        aAppendToMe ? nullptr : &fillCache );
+
+    if( !fillCache.Restore( board ) )
+    {
+        // Zones were deleted while loading (on undefined layers), so the skipped fills cannot
+        // be matched with the ones of the cache: read the fills of the board file
+        delete board;
+        board = parseBoard( aFileName, aAppendToMe, nullptr );
+    }
+
+    // Give the filename to the board if it's new
+    if( !aAppendToMe )
+        board->SetFileName( aFileName );
+
+    return board;
+}
+
+
+BOARD* PCB_IO::parseBoard( const wxString& aFileName, BOARD* aAppendToMe,
+                           ZONE_FILL_CACHE* aFillCache )
+{
+    // Read from the mapped file, so that the parser can parse the items of the board in
+    // parallel, and without copying its lines
+    MMAP_LINE_READER reader( aFileName );
+
+    bool skipFills = aFillCache
+                     && aFillCache->Read( ZONE_FILL_CACHE::GetFileName( aFileName ),
+                                          reader.Buffer(), reader.Size() )
+                     && aFillCache->BoardMatches();
+
     m_parser->SetLineReader( &reader );
     m_parser->SetBoard( aAppendToMe );
+    m_parser->SetSkipZoneFills( skipFills );
 
     BOARD* board;
 
@@ -1959,10 +2003,6 @@ BOARD* PCB_IO::Load( const wxString& aFileName, BOARD* aAppendToMe, const PROPER
                 m_parser->CurLineNumber(), m_parser->CurOffset() );
     }
 
-    // Give the filename to the board if it's new
-    if( !aAppendToMe )
-        board->SetFileName( aFileName );
-
     return board;
 }
 
@@ -2023,6 +2063,100 @@ void PCB_IO::FootprintEnumerate( wxArrayString&    aFootprintNames,
 }
 
 
+void PCB_IO::EnumerateFootprintIndex( std::vector<FOOTPRINT_INDEX_ENTRY>& aEntries,
+                                      const wxString& aLibraryPath,
+                                      const PROPERTIES* aProperties )
+{
+    LOCALE_IO     toggle;     // toggles on, then off, the C locale.
+    wxDir         dir( aLibraryPath );
+
+    init( aProperties );
+
+    if( !dir.IsOpened() )
+    {
+        wxString msg = wxString::Format( _( "Footprint library path \"%s\" does not exist" ),
+                                         aLibraryPath );
+        THROW_IO_ERROR( msg );
+    }
+
+    // Only the footprint files which are not in the index, or which changed since they were
+    // indexed, are parsed.  The footprints themselves are loaded when they are used.
+    FOOTPRINT_INDEX index( aLibraryPath );
+    FOOTPRINT_INDEX updated( aLibraryPath );
+    bool            modified = !index.Read();
+
+    wxString fullName;
+    wxString fileSpec = wxT( "*." ) + KiCadFootprintFileExtension;
+    wxString errorMsg;
+
+    if( dir.GetFirst( &fullName, fileSpec ) )
+    {
+        // wxFileName construction is egregiously slow.  Construct it once and just swap out
+        // the filename thereafter.
+        WX_FILENAME fn( aLibraryPath, wxT( "dummyName" ) );
+
+        do
+        {
+            fn.SetFullName( fullName );
+
+            wxString     fpName = fn.GetName();
+            wxStructStat stat;
+            long long    fileTime = 0;
+            long long    fileSize = 0;
+
+            if( wxStat( fn.GetFullPath(), &stat ) == 0 )
+            {
+                fileTime = stat.st_mtime;
+                fileSize = stat.st_size;
+            }
+
+            const FOOTPRINT_INDEX_ENTRY* entry = index.Find( fpName, fileTime, fileSize );
+
+            if( entry )
+            {
+                updated.Add( *entry );
+                continue;
+            }
+
+            modified = true;
+
+            try
+            {
+                FILE_LINE_READER reader( fn.GetFullPath() );
+
+                m_parser->SetLineReader( &reader );
+
+                std::unique_ptr<MODULE> footprint( (MODULE*) m_parser->Parse() );
+                FOOTPRINT_INDEX_ENTRY   newEntry( fpName, footprint.get() );
+
+                newEntry.m_fileTime = fileTime;
+                newEntry.m_fileSize = fileSize;
+                updated.Add( newEntry );
+            }
+            catch( const IO_ERROR& ioe )
+            {
+                if( !errorMsg.IsEmpty() )
+                    errorMsg += "\n\n";
+
+                errorMsg += ioe.What();
+            }
+        } while( dir.GetNext( &fullName ) );
+    }
+
+    // Footprints deleted from the library
+    if( updated.GetEntries().size() != index.GetEntries().size() )
+        modified = true;
+
+    if( modified )
+        updated.Write();
+
+    aEntries.insert( aEntries.end(), updated.GetEntries().begin(), updated.GetEntries().end() );
+
+    if( !errorMsg.IsEmpty() )
+        THROW_IO_ERROR( errorMsg );
+}
+
+
 const MODULE* PCB_IO::getFootprint( const wxString& aLibraryPath,
                                     const wxString& aFootprintName,
                                     const PROPERTIES* aProperties,
@@ -34,6 +34,7 @@ class BOARD_ITEM;
 class FP_CACHE;
 class PCB_PARSER;
 class NETINFO_MAPPING;
+class ZONE_FILL_CACHE;
 
 
 /// Current s-expression file format version.  2 was the last legacy format version.
@@ -114,6 +115,11 @@ public:
         return wxT( "kicad_pcb" );
     }
 
+    /**
+     * Function Save
+     * also writes the zone fill cache of the board file (see #ZONE_FILL_CACHE) if the
+     * property "zone_fill_cache" is set in @a aProperties, and otherwise removes it.
+     */
     virtual void Save( const wxString& aFileName, BOARD* aBoard,
                const PROPERTIES* aProperties = NULL ) override;
 
@@ -123,6 +129,10 @@ public:
     void FootprintEnumerate( wxArrayString& aFootprintNames, const wxString& aLibraryPath,
                              const PROPERTIES* aProperties = NULL ) override;
 
+    void EnumerateFootprintIndex( std::vector<FOOTPRINT_INDEX_ENTRY>& aEntries,
+                                  const wxString& aLibraryPath,
+                                  const PROPERTIES* aProperties = NULL ) override;
+
     const MODULE* GetEnumeratedFootprint( const wxString& aLibraryPath,
                                           const wxString& aFootprintName,
                                           const PROPERTIES* aProperties = NULL ) override;
@@ -201,6 +211,14 @@ protected:
 
     void init( const PROPERTIES* aProperties );
 
+    /**
+     * Function parseBoard
+     * parses the board file @a aFileName, skipping the zone fills which can be read from
+     * @a aFillCache, if not NULL.
+     */
+    BOARD* parseBoard( const wxString& aFileName, BOARD* aAppendToMe,
+                       ZONE_FILL_CACHE* aFillCache );
+
     /// formats the board setup information
     void formatSetup( BOARD* aBoard, int aNestLevel = 0 ) const;
 
@@ -331,7 +331,11 @@ bool D_PAD::MergePrimitivesAsPolygon(  SHAPE_POLY_SET* aMergedPolygon,
     if ( !buildCustomPadPolygon( aMergedPolygon, aCircleToSegmentsCount ) )
         return false;
 
-    m_boundingRadius = -1;  // The current bouding radius is no more valid.
+    // The current bounding radius is no more valid only if the pad shape was rebuilt: other
+    // polygons are built without modifying the pad, so that the pads of a board can be
+    // plotted by several threads at the same time.
+    if( aMergedPolygon == &m_customShapeAsPolygon )
+        m_boundingRadius = -1;
 
     return aMergedPolygon->OutlineCount() <= 1;
 }
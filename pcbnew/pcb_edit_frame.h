@@ -926,9 +926,11 @@ public:
      * @param aCreateBackupFile Creates a back of \a aFileName if true.  Helper
      *                          definitions #CREATE_BACKUP_FILE and #NO_BACKUP_FILE
      *                          are defined for improved code readability.
+     * @param aAutoSave is true when writing an autosave file, which gets no zone fill cache.
      * @return True if file was saved successfully.
      */
-    bool SavePcbFile( const wxString& aFileName, bool aCreateBackupFile = CREATE_BACKUP_FILE );
+    bool SavePcbFile( const wxString& aFileName, bool aCreateBackupFile = CREATE_BACKUP_FILE,
+                      bool aAutoSave = false );
 
     /**
      * Function SavePcbCopy
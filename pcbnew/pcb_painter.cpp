@@ -270,6 +270,16 @@ PCB_PAINTER::PCB_PAINTER( GAL* aGal ) :
 }
 
 
+PAINTER* PCB_PAINTER::Clone( GAL* aGal ) const
+{
+    PCB_PAINTER* painter = new PCB_PAINTER( *this );
+
+    painter->SetGAL( aGal );
+
+    return painter;
+}
+
+
 int PCB_PAINTER::getLineThickness( int aActualThickness ) const
 {
     // if items have 0 thickness, draw them with the outline
@@ -235,6 +235,9 @@ public:
     /// @copydoc PAINTER::Draw()
     virtual bool Draw( const VIEW_ITEM* aItem, int aLayer ) override;
 
+    /// @copydoc PAINTER::Clone()
+    virtual PAINTER* Clone( GAL* aGal ) const override;
+
 protected:
     PCB_RENDER_SETTINGS m_pcbSettings;
 
@@ -27,6 +27,7 @@
  * @brief Pcbnew s-expression file format parser implementation.
  */
 
+#include <cstring>
 #include <errno.h>
 #include <common.h>
 #include <confirm.h>
@@ -50,10 +51,20 @@
 #include <zones.h>
 #include <pcb_parser.h>
 #include <convert_basic_shapes_to_polygon.h>    // for RECT_CHAMFER_POSITIONS definition
+#include <thread_pool.h>
 
 using namespace PCB_KEYS_T;
 
 
+/**
+ * Thrown by the parser of a worker thread for an item which can only be parsed by the main
+ * thread, because it asks the user something or modifies the board.
+ */
+struct MAIN_THREAD_ITEM
+{
+};
+
+
 void PCB_PARSER::init()
 {
     m_showLegacyZoneWarning = true;
@@ -125,11 +136,11 @@ void PCB_PARSER::pushValueIntoMap( int aIndex, int aValue )
 
 double PCB_PARSER::parseDouble()
 {
-    char* tmp;
+    const char* tmp;
 
     errno = 0;
 
-    double fval = strtod( CurText(), &tmp );
+    double fval = StrToDouble( CurText(), &tmp );
 
     if( errno )
     {
@@ -498,10 +509,33 @@ BOARD* PCB_PARSER::parseBOARD()
 
 BOARD* PCB_PARSER::parseBOARD_unchecked()
 {
-    T token;
+    T                      token;
+    std::vector<ITEM_SPAN> itemSpans;
 
     parseHeader();
 
+    // When the whole file is in memory, most of the footprints, tracks, vias and zones are
+    // skipped by the lexer, and parsed on all the cores once the board setup is known.
+    auto memoryReader = dynamic_cast<MEMORY_LINE_READER*>( reader );
+
+    if( memoryReader && !m_inWorkerThread )
+    {
+        if( !findItemSpans( memoryReader->Buffer(), memoryReader->Size(), itemSpans ) )
+            itemSpans.clear();
+
+        // Items on the lines already read cannot be skipped any more
+        auto first = std::find_if( itemSpans.begin(), itemSpans.end(),
+                                   [&]( const ITEM_SPAN& aSpan )
+                                   {
+                                       return aSpan.m_start >= memoryReader->Position();
+                                   } );
+
+        itemSpans.erase( itemSpans.begin(), first );
+
+        for( const ITEM_SPAN& span : itemSpans )
+            memoryReader->Skip( span.m_start, span.m_end );
+    }
+
     for( token = NextTok();  token != T_RIGHT;  token = NextTok() )
     {
         if( token != T_LEFT )
@@ -582,6 +616,9 @@ BOARD* PCB_PARSER::parseBOARD_unchecked()
         }
     }
 
+    if( !itemSpans.empty() )
+        parseItemSpans( *memoryReader, itemSpans );
+
     if( m_undefinedLayers.size() > 0 )
     {
         bool deleteItems;
@@ -665,6 +702,319 @@ BOARD* PCB_PARSER::parseBOARD_unchecked()
 }
 
 
+bool PCB_PARSER::findItemSpans( const char* aBuffer, size_t aSize,
+                                std::vector<ITEM_SPAN>& aSpans )
+{
+    // Follows the rules of DSNLEXER: separators, quoted strings and comment lines
+    auto isSpace = []( char cc )
+                   {
+                       return cc == ' ' || cc == '\n' || cc == '\r' || cc == '\t' || cc == '\0';
+                   };
+
+    auto isSep = [&]( char cc )
+                 {
+                     return isSpace( cc ) || cc == '(' || cc == ')';
+                 };
+
+    auto isKeyword = []( const char* aText, size_t aLength, const char* aKeyword )
+                     {
+                         return aLength == strlen( aKeyword )
+                                && !memcmp( aText, aKeyword, aLength );
+                     };
+
+    const char* end = aBuffer + aSize;
+    int         depth = 0;
+    unsigned    line = 1;
+    bool        lineStart = true;       // only blanks so far on the current line
+    bool        tokenStart = true;      // the next character starts a token
+    size_t      sectionEnd = 0;         // count of spans before the last board setup section
+    ITEM_SPAN   span = { 0, 0, 0, 0, 0 };
+    bool        isItem = false;
+    bool        isSection = false;
+    bool        isZone = false;
+    bool        inFill = false;         // in a filled_polygon of a zone
+    bool        fillEnded = false;      // another item of the zone followed its filled_polygons
+
+    for( const char* cp = aBuffer; cp < end; ++cp )
+    {
+        char cc = *cp;
+
+        if( cc == '\n' )
+        {
+            ++line;
+            lineStart = tokenStart = true;
+            continue;
+        }
+
+        if( cc == '#' && lineStart )
+        {
+            cp = (const char*) memchr( cp, '\n', end - cp );
+
+            if( !cp )
+                break;
+
+            --cp;       // the end of line is counted on next iteration
+            continue;
+        }
+
+        if( cc == '"' && tokenStart )
+        {
+            // A string cannot span several lines
+            for( ++cp; cp < end && *cp != '"'; ++cp )
+            {
+                if( *cp == '\\' )
+                    ++cp;
+
+                if( cp >= end || *cp == '\n' )
+                    return false;
+            }
+
+            if( cp >= end )
+                return false;
+
+            lineStart = false;
+            tokenStart = true;
+            continue;
+        }
+
+        if( cc == '(' )
+        {
+            if( depth == 0 )
+            {
+                const char* keyword = cp + 1;
+                size_t      length = 0;
+
+                while( keyword + length < end && !isSep( keyword[length] ) )
+                    ++length;
+
+                if( !isKeyword( keyword, length, "kicad_pcb" ) )
+                    return false;
+            }
+            else if( depth == 1 )
+            {
+                const char* keyword = cp + 1;
+                size_t      length = 0;
+
+                while( keyword + length < end && !isSep( keyword[length] ) )
+                    ++length;
+
+                span.m_start = cp - aBuffer;
+                span.m_line = line;
+                span.m_fillStart = span.m_fillEnd = 0;
+
+                isZone = isKeyword( keyword, length, "zone" );
+                fillEnded = false;
+
+                isItem = isKeyword( keyword, length, "module" )
+                         || isKeyword( keyword, length, "segment" )
+                         || isKeyword( keyword, length, "via" )
+                         || isZone;
+
+                // Drawings depend on the setup of the board but do not change it
+                isSection = !isItem
+                            && !( length > 3 && !memcmp( keyword, "gr_", 3 ) )
+                            && !isKeyword( keyword, length, "dimension" )
+                            && !isKeyword( keyword, length, "target" );
+            }
+            else if( depth == 2 && isZone && !fillEnded )
+            {
+                const char* keyword = cp + 1;
+                size_t      length = 0;
+
+                while( keyword + length < end && !isSep( keyword[length] ) )
+                    ++length;
+
+                inFill = isKeyword( keyword, length, "filled_polygon" );
+
+                if( inFill && span.m_fillEnd == 0 )
+                    span.m_fillStart = cp - aBuffer;
+                else if( !inFill && span.m_fillEnd != 0 )
+                    fillEnded = true;
+            }
+
+            ++depth;
+        }
+        else if( cc == ')' )
+        {
+            if( --depth < 0 )
+                return false;
+
+            if( depth == 0 )
+                break;      // end of the board
+
+            if( depth == 2 && inFill )
+            {
+                span.m_fillEnd = cp + 1 - aBuffer;
+                inFill = false;
+            }
+
+            if( depth == 1 )
+            {
+                span.m_end = cp + 1 - aBuffer;
+
+                if( isItem )
+                    aSpans.push_back( span );
+                else if( isSection )
+                    sectionEnd = aSpans.size();
+            }
+        }
+        else if( depth == 0 && !isSep( cc ) )
+        {
+            return false;
+        }
+
+        lineStart = lineStart && isSpace( cc );
+        tokenStart = isSep( cc );
+    }
+
+    if( depth != 0 )
+        return false;
+
+    aSpans.erase( aSpans.begin(), aSpans.begin() + sectionEnd );
+    return true;
+}
+
+
+void PCB_PARSER::parseItemSpans( const MEMORY_LINE_READER& aReader,
+                                 const std::vector<ITEM_SPAN>& aSpans )
+{
+    struct CHUNK
+    {
+        size_t              m_begin;
+        size_t              m_end;
+        size_t              m_stop;     ///< the span which could not be parsed, or m_end
+        std::exception_ptr  m_error;    ///< the error, unless the span is for the main thread
+        std::set<wxString>  m_undefinedLayers;
+    };
+
+    // Chunks of spans of about the same size, several per thread so that they all stay
+    // busy until the end
+    THREAD_POOL&       pool = THREAD_POOL::GetInstance();
+    size_t             totalSize = aSpans.back().m_end - aSpans.front().m_start;
+    size_t             chunkSize = totalSize / ( pool.GetThreadCount() * 8 ) + 1;
+    std::vector<CHUNK> chunks;
+
+    for( size_t ii = 0, size = chunkSize; ii < aSpans.size(); ++ii )
+    {
+        if( size >= chunkSize )
+        {
+            chunks.push_back( CHUNK() );
+            chunks.back().m_begin = ii;
+            size = 0;
+        }
+
+        chunks.back().m_end = ii + 1;
+        size += aSpans[ii].m_end - aSpans[ii].m_start;
+    }
+
+    std::vector<std::unique_ptr<BOARD_ITEM>> items( aSpans.size() );
+    TASK_GROUP                               tasks( pool );
+
+    tasks.RunForEach( chunks.size(),
+            [&]( size_t aChunk )
+            {
+                CHUNK&     chunk = chunks[aChunk];
+                PCB_PARSER worker;
+
+                worker.m_board = m_board;
+                worker.m_layerIndices = m_layerIndices;
+                worker.m_layerMasks = m_layerMasks;
+                worker.m_netCodes = m_netCodes;
+                worker.m_tooRecent = m_tooRecent;
+                worker.m_requiredVersion = m_requiredVersion;
+                worker.m_inWorkerThread = true;
+                worker.m_skipZoneFills = m_skipZoneFills;
+
+                for( chunk.m_stop = chunk.m_begin; chunk.m_stop < chunk.m_end; chunk.m_stop++ )
+                {
+                    try
+                    {
+                        items[chunk.m_stop].reset(
+                                worker.parseItemSpan( aReader, aSpans[chunk.m_stop] ) );
+                    }
+                    catch( const MAIN_THREAD_ITEM& )
+                    {
+                        break;
+                    }
+                    catch( ... )
+                    {
+                        chunk.m_error = std::current_exception();
+                        break;
+                    }
+                }
+
+                chunk.m_undefinedLayers.swap( worker.m_undefinedLayers );
+            } );
+
+    tasks.Wait();
+
+    // All the spans before the first one a chunk stopped at were parsed
+    size_t             stop = aSpans.size();
+    std::exception_ptr error;
+
+    for( CHUNK& chunk : chunks )
+    {
+        m_undefinedLayers.insert( chunk.m_undefinedLayers.begin(), chunk.m_undefinedLayers.end() );
+
+        if( chunk.m_stop < stop )
+        {
+            stop = chunk.m_stop;
+            error = chunk.m_error;
+        }
+    }
+
+    if( error )
+        std::rethrow_exception( error );
+
+    // From the first item needing the main thread on, parse sequentially: such an item can
+    // add a net, which the items following it may use
+    for( size_t ii = 0; ii < aSpans.size(); ++ii )
+    {
+        BOARD_ITEM* item = ( ii < stop ) ? items[ii].release()
+                                         : parseItemSpan( aReader, aSpans[ii] );
+        bool        isTrack = item->Type() == PCB_TRACE_T || item->Type() == PCB_VIA_T;
+
+        m_board->Add( item, isTrack ? ADD_INSERT : ADD_APPEND );
+    }
+}
+
+
+BOARD_ITEM* PCB_PARSER::parseItemSpan( const MEMORY_LINE_READER& aReader, const ITEM_SPAN& aSpan )
+{
+    MEMORY_LINE_READER spanReader( aReader.Buffer() + aSpan.m_start, aSpan.m_end - aSpan.m_start,
+                                   aReader.GetSource(), aSpan.m_line - 1 );
+    BOARD_ITEM*        item = nullptr;
+
+    if( m_skipZoneFills && aSpan.m_fillEnd > aSpan.m_fillStart )
+        spanReader.Skip( aSpan.m_fillStart - aSpan.m_start, aSpan.m_fillEnd - aSpan.m_start );
+
+    PushReader( &spanReader );
+
+    try
+    {
+        NeedLEFT();
+
+        switch( NextTok() )
+        {
+        case T_module:  item = parseMODULE();           break;
+        case T_segment: item = parseTRACK();            break;
+        case T_via:     item = parseVIA();              break;
+        case T_zone:    item = parseZONE_CONTAINER();   break;
+        default:        Expecting( "module, segment, via or zone" );
+        }
+    }
+    catch( ... )
+    {
+        PopReader();
+        throw;
+    }
+
+    PopReader();
+
+    return item;
+}
+
+
 void PCB_PARSER::parseHeader()
 {
     wxCHECK_RET( CurTok() == T_kicad_pcb,
@@ -3189,6 +3539,9 @@ ZONE_CONTAINER* PCB_PARSER::parseZONE_CONTAINER()
 
                     if( token == T_segment )    // deprecated
                     {
+                        if( m_inWorkerThread )
+                            throw MAIN_THREAD_ITEM();
+
                         // SEGMENT fill mode no longer supported.  Make sure user is OK with converting them.
                         if( m_showLegacyZoneWarning )
                         {
@@ -3444,6 +3797,9 @@ ZONE_CONTAINER* PCB_PARSER::parseZONE_CONTAINER()
             zone->SetNetCode( net->GetNet() );
         else    // Not existing net: add a new net to keep trace of the zone netname
         {
+            if( m_inWorkerThread )
+                throw MAIN_THREAD_ITEM();
+
             int newnetcode = m_board->GetNetCount();
             net = new NETINFO_ITEM( m_board, netnameFromfile, newnetcode );
             m_board->Add( net );
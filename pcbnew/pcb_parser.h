@@ -35,6 +35,7 @@
 #include <layers_id_colors_and_visibility.h>    // PCB_LAYER_ID
 #include <common.h>                             // KiROUND
 #include <convert_to_biu.h>                     // IU_PER_MM
+#include <number_parser.h>                      // StrToLong
 
 #include <unordered_map>
 
@@ -77,6 +78,24 @@ class PCB_PARSER : public PCB_LEXER
 
     bool                m_showLegacyZoneWarning;
 
+    ///> true for the parsers of the items of a board parsed by several threads, which must
+    ///> neither modify the board nor ask the user anything
+    bool                m_inWorkerThread;
+
+    ///> true to skip the filled polygons of the zones parsed apart from the rest of the board,
+    ///> when the zone fill cache of the board file holds them
+    bool                m_skipZoneFills;
+
+    /// A top level item of a board file held in memory, parsed apart from the rest of the file
+    struct ITEM_SPAN
+    {
+        size_t   m_start;       ///< offset of the opening parenthesis in the buffer
+        size_t   m_end;         ///< offset following the closing parenthesis
+        unsigned m_line;        ///< line number of the opening parenthesis
+        size_t   m_fillStart;   ///< offset of the first filled_polygon of a zone, if any
+        size_t   m_fillEnd;     ///< offset following the last one, which follow each other
+    };
+
     ///> Converts net code using the mapping table if available,
     ///> otherwise returns unchanged net code if < 0 or if is is out of range
     inline int getNetCode( int aNetCode )
@@ -154,6 +173,31 @@ class PCB_PARSER : public PCB_LEXER
      */
     BOARD*          parseBOARD_unchecked();
 
+    /**
+     * Function findItemSpans
+     * finds the top level footprints, tracks, vias and zones of a board file held in memory
+     * which can be parsed independently of each other: the ones following all the sections
+     * defining the layers, nets and settings of the board.
+     *
+     * @return false if the text does not look like a well formed board file, which then
+     *  has to be parsed sequentially (aSpans is then incomplete).
+     */
+    static bool findItemSpans( const char* aBuffer, size_t aSize,
+                               std::vector<ITEM_SPAN>& aSpans );
+
+    /**
+     * Function parseItemSpans
+     * parses the items of aSpans, skipped by the lexer while reading the rest of the board
+     * from aReader, on all the cores, and adds them to the board in file order.
+     */
+    void parseItemSpans( const MEMORY_LINE_READER& aReader, const std::vector<ITEM_SPAN>& aSpans );
+
+    /**
+     * Function parseItemSpan
+     * parses the footprint, track, via or zone of aSpan, in the buffer of aReader.
+     */
+    BOARD_ITEM* parseItemSpan( const MEMORY_LINE_READER& aReader, const ITEM_SPAN& aSpan );
+
 
     /**
      * Function lookUpLayer
@@ -275,7 +319,7 @@ class PCB_PARSER : public PCB_LEXER
 
     inline int parseInt()
     {
-        return (int)strtol( CurText(), NULL, 10 );
+        return (int)StrToLong( CurText() );
     }
 
     inline int parseInt( const char* aExpected )
@@ -302,7 +346,9 @@ public:
 
     PCB_PARSER( LINE_READER* aReader = NULL ) :
         PCB_LEXER( aReader ),
-        m_board( 0 )
+        m_board( 0 ),
+        m_inWorkerThread( false ),
+        m_skipZoneFills( false )
     {
         init();
     }
@@ -328,6 +374,17 @@ public:
         m_board = aBoard;
     }
 
+    /**
+     * Function SetSkipZoneFills
+     * tells the parser whether it can skip the filled polygons of the zones of the next
+     * board it parses, because they are read from the zone fill cache of the board file.
+     * Not all of them may be skipped.
+     */
+    void SetSkipZoneFills( bool aSkip )
+    {
+        m_skipZoneFills = aSkip;
+    }
+
     BOARD_ITEM* Parse();
     /**
      * Function parseMODULE
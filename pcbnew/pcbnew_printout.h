@@ -85,6 +85,9 @@ class PCB_PRINT_PAINTER : public PCB_PAINTER
 public:
     PCB_PRINT_PAINTER( GAL* aGal );
 
+    /// @copydoc PAINTER::Clone()
+    virtual PAINTER* Clone( GAL* aGal ) const override;
+
     /**
      * Set drill marks visibility and options.
      * @param aRealSize when enabled, drill marks represent actual holes. Otherwise aSize
@@ -29,6 +29,7 @@
 #ifndef PCBPLOT_H_
 #define PCBPLOT_H_
 
+#include <vector>
 #include <wx/filename.h>
 #include <pad_shapes.h>
 #include <pcb_plot_params.h>
@@ -170,6 +171,29 @@ PLOTTER* StartPlotBoard( BOARD* aBoard,
                          const wxString& aFullFileName,
                          const wxString& aSheetDesc );
 
+/**
+ * A layer to plot in its own file by PlotBoardLayers()
+ */
+struct PLOT_LAYER_JOB
+{
+    PCB_LAYER_ID m_Layer;       ///< the layer to plot
+    wxString     m_FileName;    ///< the full file name of the plot file
+    bool         m_Plotted;     ///< set by PlotBoardLayers(): false if the file was not created
+};
+
+/**
+ * Function PlotBoardLayers
+ * plot several layers, each one in its own file, as StartPlotBoard(), PlotOneBoardLayer()
+ * and PLOTTER::EndPlot() do for each layer.
+ * The files are opened one after the other, but the layers are plotted at the same time,
+ * each one by its own plotter: the files are the same as the ones plotted one by one.
+ * @param aBoard = the board to plot
+ * @param aPlotOpts = the plot options
+ * @param aJobs = the layers to plot, and their files
+ */
+void PlotBoardLayers( BOARD* aBoard, PCB_PLOT_PARAMS* aPlotOpts,
+                      std::vector<PLOT_LAYER_JOB>& aJobs );
+
 /**
  * Function PlotOneBoardLayer
  * main function to plot one copper or technical layer.
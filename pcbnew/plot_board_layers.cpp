@@ -52,6 +52,9 @@
 #include <pcbnew.h>
 #include <pcbplot.h>
 #include <gbr_metadata.h>
+#include <thread_pool.h>
+
+#include <memory>
 
 // Local
 /* Plot a solder mask layer.
@@ -362,7 +365,10 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
             wxSize extraSize = margin * 2;
             extraSize.x += width_adj;
             extraSize.y += width_adj;
-            wxSize deltaSize = pad->GetDelta(); // has meaning only for trapezoidal pads
+
+            // The plot size is set on a copy of the pad, not on the board pad itself, so that
+            // the layers of a board can be plotted by several threads at the same time
+            D_PAD plotPad( *pad );
 
             if( pad->GetShape() == PAD_SHAPE_TRAPEZOID )
             {   // The easy way is to use BuildPadPolygon to calculate
@@ -395,7 +401,7 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
                 else
                     delta.y = coord[1].x - coord[0].x;
 
-                pad->SetDelta( delta );
+                plotPad.SetDelta( delta );
             }
             else
                 padPlotsSize = pad->GetSize() + extraSize;
@@ -412,29 +418,26 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
             if( pad->GetLayerSet()[F_Cu] )
                 color = color.LegacyMix( aBoard->Colors().GetItemColor( LAYER_PAD_FR ) );
 
-            // Temporary set the pad size to the required plot size:
-            wxSize tmppadsize = pad->GetSize();
-
             switch( pad->GetShape() )
             {
             case PAD_SHAPE_CIRCLE:
             case PAD_SHAPE_OVAL:
-                pad->SetSize( padPlotsSize );
+                plotPad.SetSize( padPlotsSize );
 
                 if( aPlotOpt.GetSkipPlotNPTH_Pads() &&
-                    ( pad->GetSize() == pad->GetDrillSize() ) &&
-                    ( pad->GetAttribute() == PAD_ATTRIB_HOLE_NOT_PLATED ) )
+                    ( plotPad.GetSize() == plotPad.GetDrillSize() ) &&
+                    ( plotPad.GetAttribute() == PAD_ATTRIB_HOLE_NOT_PLATED ) )
                     break;
 
-                itemplotter.PlotPad( pad, color, plotMode );
+                itemplotter.PlotPad( &plotPad, color, plotMode );
                 break;
 
             case PAD_SHAPE_TRAPEZOID:
             case PAD_SHAPE_RECT:
             case PAD_SHAPE_ROUNDRECT:
             case PAD_SHAPE_CHAMFERED_RECT:
-                pad->SetSize( padPlotsSize );
-                itemplotter.PlotPad( pad, color, plotMode );
+                plotPad.SetSize( padPlotsSize );
+                itemplotter.PlotPad( &plotPad, color, plotMode );
                 break;
 
             case PAD_SHAPE_CUSTOM:
@@ -446,11 +449,11 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
                     // be sure the anchor pad is not bigger than the deflated shape
                     // because this anchor will be added to the pad shape when plotting
                     // the pad
-                    pad->SetSize( padPlotsSize );
+                    plotPad.SetSize( padPlotsSize );
 
-                D_PAD dummy( *pad );
+                D_PAD dummy( plotPad );
                 SHAPE_POLY_SET shape;
-                pad->MergePrimitivesAsPolygon( &shape, 64 );
+                plotPad.MergePrimitivesAsPolygon( &shape, 64 );
                 // shape polygon can have holes linked to the main outline.
                 // So use InflateWithLinkedHoles(), not Inflate() that can create
                 // bad shapes if margin.x is < 0
@@ -464,9 +467,6 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter,
                 }
                 break;
             }
-
-            pad->SetSize( tmppadsize );     // Restore the pad size
-            pad->SetDelta( deltaSize );
         }
 
         aPlotter->EndBlock( NULL );
@@ -1134,3 +1134,38 @@ PLOTTER* StartPlotBoard( BOARD *aBoard, PCB_PLOT_PARAMS *aPlotOpts,
     delete plotter;
     return NULL;
 }
+
+
+void PlotBoardLayers( BOARD* aBoard, PCB_PLOT_PARAMS* aPlotOpts,
+                      std::vector<PLOT_LAYER_JOB>& aJobs )
+{
+    // Switch the locale once for all the plotting threads
+    LOCALE_IO toggle;
+
+    // The plots are started here, one after the other: starting a plot updates the board
+    // bounding box, and plots the page layout, which are not thread safe
+    std::vector<std::unique_ptr<PLOTTER>> plotters( aJobs.size() );
+
+    for( size_t ii = 0; ii < aJobs.size(); ii++ )
+    {
+        plotters[ii].reset( StartPlotBoard( aBoard, aPlotOpts, aJobs[ii].m_Layer,
+                                            aJobs[ii].m_FileName, wxEmptyString ) );
+        aJobs[ii].m_Plotted = plotters[ii] != nullptr;
+    }
+
+    // Each layer has its own plotter and file, and plotting only reads the board
+    TASK_GROUP tasks;
+
+    tasks.RunForEach( aJobs.size(),
+            [&]( size_t ii )
+            {
+                if( !plotters[ii] )
+                    return;
+
+                PlotOneBoardLayer( aBoard, plotters[ii].get(), aJobs[ii].m_Layer, *aPlotOpts );
+                plotters[ii]->EndPlot();
+                plotters[ii].reset();
+            } );
+
+    tasks.Wait();
+}
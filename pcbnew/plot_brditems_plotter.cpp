@@ -643,9 +643,9 @@ void BRDITEMS_PLOTTER::PlotFilledAreas( ZONE_CONTAINER* aZone )
         }
     }
 
-    // We need a buffer to store corners coordinates:
-    static std::vector< wxPoint > cornerList;
-    cornerList.clear();
+    // We need a buffer to store corners coordinates (not a static one: the layers of a
+    // board can be plotted by several threads at the same time)
+    std::vector< wxPoint > cornerList;
 
     m_plotter->SetColor( getColor( aZone->GetLayer() ) );
 
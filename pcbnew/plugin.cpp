@@ -23,6 +23,7 @@
  */
 
 #include <io_mgr.h>
+#include <footprint_index.h>
 #include <properties.h>
 
 
@@ -65,6 +66,35 @@ void PLUGIN::FootprintEnumerate( wxArrayString& aFootprintNames, const wxString&
 }
 
 
+void PLUGIN::EnumerateFootprintIndex( std::vector<FOOTPRINT_INDEX_ENTRY>& aEntries,
+                                      const wxString& aLibraryPath,
+                                      const PROPERTIES* aProperties )
+{
+    wxArrayString fpnames;
+    wxString      errorMsg;
+
+    // Some of the footprints may have been loaded correctly, so their entries are returned
+    try
+    {
+        FootprintEnumerate( fpnames, aLibraryPath, aProperties );
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        errorMsg = ioe.What();
+    }
+
+    for( const wxString& fpname : fpnames )
+    {
+        const MODULE* footprint = GetEnumeratedFootprint( aLibraryPath, fpname, aProperties );
+
+        aEntries.emplace_back( fpname, footprint );
+    }
+
+    if( !errorMsg.IsEmpty() )
+        THROW_IO_ERROR( errorMsg );
+}
+
+
 void PLUGIN::PrefetchLib( const wxString& aLibraryPath, const PROPERTIES* aProperties )
 {
     (void) aLibraryPath;
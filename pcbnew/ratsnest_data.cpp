@@ -33,6 +33,7 @@
 #endif
 
 #include <ratsnest_data.h>
+#include <geometry/delaunay_triangulation.h>
 #include <functional>
 using namespace std::placeholders;
 
@@ -55,7 +56,48 @@ static bool sortWeight( const CN_EDGE& aEdge1, const CN_EDGE& aEdge2 )
 }
 
 
-static const std::vector<CN_EDGE> kruskalMST( std::list<CN_EDGE>& aEdges,
+/**
+ * Class DISJOINT_SET
+ * is a union-find of the integers [0, n), with path halving and union by size.
+ */
+class DISJOINT_SET
+{
+public:
+    DISJOINT_SET( size_t aSize ) :
+        m_parent( aSize ),
+        m_size( aSize, 1 )
+    {
+        for( size_t i = 0; i < aSize; i++ )
+            m_parent[i] = i;
+    }
+
+    int Find( int aVal )
+    {
+        while( m_parent[aVal] != aVal )
+        {
+            m_parent[aVal] = m_parent[m_parent[aVal]];
+            aVal = m_parent[aVal];
+        }
+
+        return aVal;
+    }
+
+    void Union( int aRootA, int aRootB )
+    {
+        if( m_size[aRootA] < m_size[aRootB] )
+            std::swap( aRootA, aRootB );
+
+        m_parent[aRootB] = aRootA;
+        m_size[aRootA] += m_size[aRootB];
+    }
+
+private:
+    std::vector<int> m_parent;
+    std::vector<int> m_size;
+};
+
+
+static const std::vector<CN_EDGE> kruskalMST( std::vector<CN_EDGE>& aEdges,
         std::vector<CN_ANCHOR_PTR>& aNodes )
 {
     unsigned int    nodeNumber = aNodes.size();
@@ -66,85 +108,60 @@ static const std::vector<CN_EDGE> kruskalMST( std::list<CN_EDGE>& aEdges,
     // The output
     std::vector<CN_EDGE> mst;
 
-    // Set tags for marking cycles
-    std::unordered_map<CN_ANCHOR_PTR, int> tags;
-    unsigned int tag = 0;
-
-    for( auto& node : aNodes )
-    {
-        node->SetTag( tag );
-        tags[node] = tag++;
-    }
-
-    // Lists of nodes connected together (subtrees) to detect cycles in the graph
-    std::vector<std::list<int> > cycles( nodeNumber );
-
+    // The tags index the nodes in the set of subtrees while the tree is built; they are then
+    // set to the subtree of each node once the connected items are processed.
     for( unsigned int i = 0; i < nodeNumber; ++i )
-        cycles[i].push_back( i );
+        aNodes[i]->SetTag( i );
+
+    DISJOINT_SET     subtrees( nodeNumber );
+    std::vector<int> connectedTags;
 
     // Kruskal algorithm requires edges to be sorted by their weight
-    aEdges.sort( sortWeight );
+    std::stable_sort( aEdges.begin(), aEdges.end(), sortWeight );
 
-    while( mstSize < mstExpectedSize && !aEdges.empty() )
+    for( const auto& dt : aEdges )
     {
-        //printf("mstSize %d %d\n", mstSize, mstExpectedSize);
-        auto& dt = aEdges.front();
+        if( mstSize >= mstExpectedSize )
+            break;
 
-        int srcTag  = tags[dt.GetSourceNode()];
-        int trgTag  = tags[dt.GetTargetNode()];
+        int srcTag  = subtrees.Find( dt.GetSourceNode()->GetTag() );
+        int trgTag  = subtrees.Find( dt.GetTargetNode()->GetTag() );
 
         // Check if by adding this edge we are going to join two different forests
-        if( srcTag != trgTag )
-        {
-            // Because edges are sorted by their weight, first we always process connected
-            // items (weight == 0). Once we stumble upon an edge with non-zero weight,
-            // it means that the rest of the lines are ratsnest.
-            if( !ratsnestLines && dt.GetWeight() != 0 )
-                ratsnestLines = true;
-
-            // Update tags
-            if( ratsnestLines )
-            {
-                for( auto it = cycles[trgTag].begin(); it != cycles[trgTag].end(); ++it )
-                {
-                    tags[aNodes[*it]] = srcTag;
-                }
+        if( srcTag == trgTag )
+            continue;
 
-                // Do a copy of edge, but make it RN_EDGE_MST. In contrary to RN_EDGE,
-                // RN_EDGE_MST saves both source and target node and does not require any other
-                // edges to exist for getting source/target nodes
-                CN_EDGE newEdge ( dt.GetSourceNode(), dt.GetTargetNode(), dt.GetWeight() );
+        // Because edges are sorted by their weight, first we always process connected
+        // items (weight == 0). Once we stumble upon an edge with non-zero weight,
+        // it means that the rest of the lines are ratsnest.
+        if( !ratsnestLines && dt.GetWeight() != 0 )
+        {
+            ratsnestLines = true;
 
-                assert( newEdge.GetSourceNode()->GetTag() != newEdge.GetTargetNode()->GetTag() );
-                assert( newEdge.GetWeight() > 0 );
+            connectedTags.resize( nodeNumber );
 
-                mst.push_back( newEdge );
-                ++mstSize;
-            }
-            else
-            {
-                // for( it = cycles[trgTag].begin(), itEnd = cycles[trgTag].end(); it != itEnd; ++it )
-                // for( auto it : cycles[trgTag] )
-                for( auto it = cycles[trgTag].begin(); it != cycles[trgTag].end(); ++it )
-                {
-                    tags[aNodes[*it]] = srcTag;
-                    aNodes[*it]->SetTag( srcTag );
-                }
+            for( unsigned int i = 0; i < nodeNumber; ++i )
+                connectedTags[i] = subtrees.Find( i );
+        }
 
-                // Processing a connection, decrease the expected size of the ratsnest MST
-                --mstExpectedSize;
-            }
+        if( ratsnestLines )
+        {
+            assert( dt.GetWeight() > 0 );
 
-            // Move nodes that were marked with old tag to the list marked with the new tag
-            cycles[srcTag].splice( cycles[srcTag].end(), cycles[trgTag] );
+            mst.push_back( dt );
+            ++mstSize;
+        }
+        else
+        {
+            // Processing a connection, decrease the expected size of the ratsnest MST
+            --mstExpectedSize;
         }
 
-        // Remove the edge that was just processed
-        aEdges.erase( aEdges.begin() );
+        subtrees.Union( srcTag, trgTag );
     }
 
-    // Probably we have discarded some of edges, so reduce the size
-    mst.resize( mstSize );
+    for( unsigned int i = 0; i < nodeNumber; ++i )
+        aNodes[i]->SetTag( ratsnestLines ? connectedTags[i] : subtrees.Find( i ) );
 
     return mst;
 }
@@ -155,39 +172,13 @@ class RN_NET::TRIANGULATOR_STATE
 private:
     std::vector<CN_ANCHOR_PTR>  m_allNodes;
 
-    std::list<hed::EDGE_PTR> hedTriangulation( std::vector<hed::NODE_PTR>& aNodes )
-    {
-        hed::TRIANGULATION triangulator;
-        triangulator.CreateDelaunay( aNodes.begin(), aNodes.end() );
-        std::list<hed::EDGE_PTR> edges;
-        triangulator.GetEdges( edges );
-
-        return edges;
-    }
+    ///> The distinct positions of the nodes, and the index in m_allNodes of the first node
+    ///> at each of them
+    std::vector<VECTOR2I>       m_points;
+    std::vector<int>            m_pointNodes;
 
-
-    // Checks if all nodes in aNodes lie on a single line. Requires the nodes to
-    // have unique coordinates!
-    bool areNodesColinear( const std::vector<hed::NODE_PTR>& aNodes ) const
-    {
-        if ( aNodes.size() <= 2 )
-            return true;
-
-        const auto p0 = aNodes[0]->Pos();
-        const auto v0 = aNodes[1]->Pos() - p0;
-
-        for( unsigned i = 2; i < aNodes.size(); i++ )
-        {
-            const auto v1 = aNodes[i]->Pos() - p0;
-
-            if( v0.Cross( v1 ) != 0 )
-            {
-                return false;
-            }
-        }
-
-        return true;
-    }
+    DELAUNAY_TRIANGULATION              m_triangulation;
+    std::vector<std::pair<int, int>>    m_triangEdges;
 
 public:
 
@@ -201,18 +192,8 @@ public:
         m_allNodes.push_back( aNode );
     }
 
-    const std::list<CN_EDGE> Triangulate()
+    void Triangulate( std::vector<CN_EDGE>& aEdges )
     {
-        std::list<CN_EDGE> mstEdges;
-        std::list<hed::EDGE_PTR> triangEdges;
-        std::vector<hed::NODE_PTR> triNodes;
-
-        using ANCHOR_LIST = std::vector<CN_ANCHOR_PTR>;
-        std::vector<ANCHOR_LIST> anchorChains;
-
-        triNodes.reserve( m_allNodes.size() );
-        anchorChains.reserve( m_allNodes.size() );
-
         std::sort( m_allNodes.begin(), m_allNodes.end(),
                 [] ( const CN_ANCHOR_PTR& aNode1, const CN_ANCHOR_PTR& aNode2 )
         {
@@ -227,94 +208,70 @@ public:
         }
                 );
 
-        CN_ANCHOR_PTR prev, last;
-        int id = 0;
+        m_points.clear();
+        m_pointNodes.clear();
 
-        for( auto n : m_allNodes )
+        for( unsigned int i = 0; i < m_allNodes.size(); i++ )
         {
-            anchorChains.push_back( ANCHOR_LIST() );
-        }
-
-        for( auto n : m_allNodes )
-        {
-            if( !prev || prev->Pos() != n->Pos() )
+            if( i == 0 || m_allNodes[i - 1]->Pos() != m_allNodes[i]->Pos() )
             {
-                auto tn = std::make_shared<hed::NODE> ( n->Pos().x, n->Pos().y );
-
-                tn->SetId( id );
-                triNodes.push_back( tn );
+                m_points.push_back( m_allNodes[i]->Pos() );
+                m_pointNodes.push_back( i );
             }
-
-            id++;
-            prev = n;
         }
 
-        int prevId = 0;
-
-        for( auto n : triNodes )
-        {
-            for( int i = prevId; i < n->Id(); i++ )
-                anchorChains[prevId].push_back( m_allNodes[ i ] );
-
-            prevId = n->Id();
-        }
+        if( m_points.size() == 1 )
+            return;
 
-        for( int i = prevId; i < id; i++ )
-            anchorChains[prevId].push_back( m_allNodes[ i ] );
+        m_triangEdges.clear();
 
-        if( triNodes.size() == 1 )
+        if( m_triangulation.Triangulate( m_points ) )
         {
-            return mstEdges;
+            m_triangulation.GetEdges( m_triangEdges );
         }
-        else if( areNodesColinear( triNodes ) )
+        else
         {
             // special case: all nodes are on the same line - there's no
-            // triangulation for such set. In this case, we sort along any coordinate
-            // and chain the nodes together.
-            for(int i = 0; i < (int)triNodes.size() - 1; i++ )
-            {
-                auto src = m_allNodes[ triNodes[i]->Id() ];
-                auto dst = m_allNodes[ triNodes[i + 1]->Id() ];
-                mstEdges.emplace_back( src, dst, getDistance( src, dst ) );
-            }
+            // triangulation for such set. They are sorted along the line,
+            // so they are chained together.
+            for( int i = 0; i < (int) m_points.size() - 1; i++ )
+                m_triangEdges.emplace_back( i, i + 1 );
         }
-        else
-        {
-            hed::TRIANGULATION triangulator;
-            triangulator.CreateDelaunay( triNodes.begin(), triNodes.end() );
-            triangulator.GetEdges( triangEdges );
 
-            for( auto e : triangEdges )
-            {
-                auto    src = m_allNodes[ e->GetSourceNode()->Id() ];
-                auto    dst = m_allNodes[ e->GetTargetNode()->Id() ];
+        aEdges.reserve( aEdges.size() + m_triangEdges.size() + m_allNodes.size() );
 
-                mstEdges.emplace_back( src, dst, getDistance( src, dst ) );
-            }
+        for( const auto& e : m_triangEdges )
+        {
+            const auto& src = m_allNodes[ m_pointNodes[e.first] ];
+            const auto& dst = m_allNodes[ m_pointNodes[e.second] ];
+
+            aEdges.emplace_back( src, dst, getDistance( src, dst ) );
         }
 
-        for( unsigned int i = 0; i < anchorChains.size(); i++ )
+        // Chain the nodes at the same position, the ones of the same cluster first
+        m_pointNodes.push_back( m_allNodes.size() );
+
+        for( unsigned int i = 0; i < m_points.size(); i++ )
         {
-            auto& chain = anchorChains[i];
+            auto chainBegin = m_allNodes.begin() + m_pointNodes[i];
+            auto chainEnd = m_allNodes.begin() + m_pointNodes[i + 1];
 
-            if( chain.size() < 2 )
+            if( chainEnd - chainBegin < 2 )
                 continue;
 
-            std::sort( chain.begin(), chain.end(),
+            std::sort( chainBegin, chainEnd,
                     [] ( const CN_ANCHOR_PTR& a, const CN_ANCHOR_PTR& b ) {
                 return a->GetCluster().get() < b->GetCluster().get();
             } );
 
-            for( unsigned int j = 1; j < chain.size(); j++ )
+            for( auto it = chainBegin + 1; it != chainEnd; ++it )
             {
-                const auto& prevNode    = chain[j - 1];
-                const auto& curNode     = chain[j];
+                const auto& prevNode    = *( it - 1 );
+                const auto& curNode     = *it;
                 int weight = prevNode->GetCluster() != curNode->GetCluster() ? 1 : 0;
-                mstEdges.push_back( CN_EDGE ( prevNode, curNode, weight ) );
+                aEdges.emplace_back( prevNode, curNode, weight );
             }
         }
-
-        return mstEdges;
     }
 };
 
@@ -363,16 +320,17 @@ void RN_NET::compute()
         m_triangulator->AddNode( n );
     }
 
+    std::vector<CN_EDGE> triangEdges;
+
     #ifdef PROFILE
     PROF_COUNTER cnt("triangulate");
     #endif
-    auto triangEdges = m_triangulator->Triangulate();
+    m_triangulator->Triangulate( triangEdges );
     #ifdef PROFILE
     cnt.Show();
     #endif
 
-    for( const auto& e : m_boardEdges )
-        triangEdges.push_back( e );
+    triangEdges.insert( triangEdges.end(), m_boardEdges.begin(), m_boardEdges.end() );
 
 // Get the minimal spanning tree
 #ifdef PROFILE
@@ -34,12 +34,11 @@
 #include <math/box2.h>
 
 #include <deque>
+#include <list>
+#include <memory>
 #include <unordered_set>
 #include <unordered_map>
 
-#include <ttl/halfedge/hetriang.h>
-#include <ttl/halfedge/hetraits.h>
-
 #include <connectivity/connectivity_algo.h>
 
 class BOARD;
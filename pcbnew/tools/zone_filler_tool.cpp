@@ -120,6 +120,7 @@ int ZONE_FILLER_TOOL::ZoneFillAll( const TOOL_EVENT& aEvent )
 
     ZONE_FILLER filler( board(), &commit );
     filler.SetProgressReporter( progressReporter.get() );
+    filler.SetIncremental( true );
 
     if( filler.Fill( toFill ) )
         frame()->m_ZoneFillsDirty = false;
@@ -0,0 +1,507 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <zone_fill_cache.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+
+#include <wx/filename.h>
+
+#include <common.h>
+#include <ki_exception.h>
+#include <mapped_file.h>
+#include <md5_hash.h>
+#include <thread_pool.h>
+#include <class_board.h>
+#include <class_zone.h>
+
+
+/// Change this whenever the layout of the file changes: files of other versions are ignored
+#define ZONE_FILL_CACHE_VERSION     1
+
+static const char s_magic[8] = { 'K', 'I', 'Z', 'F', 'I', 'L', 'L', '\n' };
+
+
+namespace
+{
+
+/**
+ * Reads the fields of a cache file, checking each read stays within the data
+ */
+class CACHE_READER
+{
+public:
+    CACHE_READER( const char* aData, size_t aSize, size_t aPos = 0 ) :
+        m_data( aData ),
+        m_size( aSize ),
+        m_pos( aPos )
+    {}
+
+    bool Read( void* aBuffer, size_t aSize )
+    {
+        if( aSize > m_size - m_pos )
+            return false;
+
+        memcpy( aBuffer, m_data + m_pos, aSize );
+        m_pos += aSize;
+        return true;
+    }
+
+    template<typename T>
+    bool Read( T& aValue )
+    {
+        return Read( &aValue, sizeof( T ) );
+    }
+
+    bool Read( std::string& aString )
+    {
+        uint32_t length;
+
+        if( !Read( length ) || length > m_size - m_pos )
+            return false;
+
+        aString.assign( m_data + m_pos, length );
+        m_pos += length;
+        return true;
+    }
+
+    /// Skip aCount items of aSize bytes, such as the points of an outline
+    bool Skip( uint32_t aCount, size_t aSize )
+    {
+        if( aCount > ( m_size - m_pos ) / aSize )
+            return false;
+
+        m_pos += aCount * aSize;
+        return true;
+    }
+
+    VECTOR2I ReadPoint()
+    {
+        int32_t xy[2];
+
+        Read( xy, sizeof( xy ) );
+        return VECTOR2I( xy[0], xy[1] );
+    }
+
+    size_t Position() const { return m_pos; }
+    bool AtEnd() const { return m_pos == m_size; }
+
+private:
+    const char* m_data;
+    size_t      m_size;
+    size_t      m_pos;
+};
+
+
+void writeString( std::string& aOut, const std::string& aString )
+{
+    uint32_t length = aString.size();
+
+    aOut.append( (const char*) &length, sizeof( length ) );
+    aOut.append( aString );
+}
+
+
+template<typename T>
+void writeValue( std::string& aOut, T aValue )
+{
+    aOut.append( (const char*) &aValue, sizeof( T ) );
+}
+
+
+void writePoint( std::string& aOut, const VECTOR2I& aPoint )
+{
+    writeValue<int32_t>( aOut, aPoint.x );
+    writeValue<int32_t>( aOut, aPoint.y );
+}
+
+
+std::string hashBoard( const char* aData, size_t aSize )
+{
+    MD5_HASH     hash;
+    const size_t chunkSize = 1 << 30;
+
+    for( size_t pos = 0; pos < aSize; pos += chunkSize )
+    {
+        hash.Hash( (uint8_t*) const_cast<char*>( aData + pos ),
+                   (uint32_t) std::min( chunkSize, aSize - pos ) );
+    }
+
+    hash.Finalize();
+
+    return hash.Format();
+}
+
+}
+
+
+ZONE_FILL_CACHE::ZONE_FILL_CACHE() :
+    m_boardMatches( false )
+{
+}
+
+
+ZONE_FILL_CACHE::~ZONE_FILL_CACHE()
+{
+}
+
+
+wxString ZONE_FILL_CACHE::GetFileName( const wxString& aBoardFileName )
+{
+    return aBoardFileName + wxT( "-fills" );
+}
+
+
+bool ZONE_FILL_CACHE::Write( BOARD* aBoard, const wxString& aBoardFileName,
+                             const wxString& aFileName )
+{
+    wxString    fileName = aFileName.IsEmpty() ? GetFileName( aBoardFileName ) : aFileName;
+    std::string boardHash;
+
+    try
+    {
+        MAPPED_FILE board( aBoardFileName );
+
+        boardHash = hashBoard( board.Data(), board.Size() );
+    }
+    catch( const IO_ERROR& )
+    {
+        return false;
+    }
+
+    std::string data( s_magic, sizeof( s_magic ) );
+
+    writeValue<uint32_t>( data, ZONE_FILL_CACHE_VERSION );
+    writeString( data, boardHash );
+    writeValue<uint32_t>( data, aBoard->Zones().size() );
+
+    for( ZONE_CONTAINER* zone : aBoard->Zones() )
+    {
+        const SHAPE_POLY_SET& fill = zone->GetFilledPolysList();
+
+        // The board file holds each contour of the fill as an outline, and so does the cache.
+        // Fills are fractured, so that a triangulation of a fill with holes cannot be valid
+        // for the fill read from the board file.
+        bool triangulated = !fill.HasHoles() && fill.IsTriangulationUpToDate();
+        int  contourCount = 0;
+
+        writeString( data, triangulated ? fill.GetHash().Format() : std::string() );
+
+        for( int ii = 0; ii < fill.OutlineCount(); ++ii )
+            contourCount += fill.Polygon( ii ).size();
+
+        writeValue<uint32_t>( data, contourCount );
+
+        for( int ii = 0; ii < fill.OutlineCount(); ++ii )
+        {
+            for( const SHAPE_LINE_CHAIN& contour : fill.Polygon( ii ) )
+            {
+                writeValue<uint32_t>( data, contour.PointCount() );
+
+                for( const VECTOR2I& point : contour.CPoints() )
+                    writePoint( data, point );
+            }
+        }
+
+        if( !triangulated )
+        {
+            writeValue<uint32_t>( data, 0 );
+            continue;
+        }
+
+        writeValue<uint32_t>( data, fill.TriangulatedPolyCount() );
+
+        for( unsigned ii = 0; ii < fill.TriangulatedPolyCount(); ++ii )
+        {
+            const SHAPE_POLY_SET::TRIANGULATED_POLYGON* poly = fill.TriangulatedPolygon( ii );
+
+            writeValue<uint32_t>( data, poly->GetVertexCount() );
+
+            for( size_t jj = 0; jj < poly->GetVertexCount(); ++jj )
+                writePoint( data, poly->GetVertex( jj ) );
+
+            writeValue<uint32_t>( data, poly->GetTriangleCount() );
+
+            for( size_t jj = 0; jj < poly->GetTriangleCount(); ++jj )
+            {
+                const SHAPE_POLY_SET::TRIANGULATED_POLYGON::TRI& tri = poly->GetTri( jj );
+
+                writeValue<int32_t>( data, tri.a );
+                writeValue<int32_t>( data, tri.b );
+                writeValue<int32_t>( data, tri.c );
+            }
+        }
+    }
+
+    // Write a temporary file and rename it, so that no reader can see a partial cache
+    wxString tempFileName = wxFileName::CreateTempFileName( fileName );
+
+    if( tempFileName.IsEmpty() )
+        return false;
+
+    FILE* fp = wxFopen( tempFileName, wxT( "wb" ) );
+    bool  ok = fp && fwrite( data.data(), 1, data.size(), fp ) == data.size();
+
+    if( fp && fclose( fp ) != 0 )
+        ok = false;
+
+    if( !ok || !wxRenameFile( tempFileName, fileName, true ) )
+    {
+        wxRemoveFile( tempFileName );
+        return false;
+    }
+
+    return true;
+}
+
+
+bool ZONE_FILL_CACHE::Read( const wxString& aFileName, const char* aBoard, size_t aBoardSize )
+{
+    clear();
+
+    if( !wxFileExists( aFileName ) )
+        return false;
+
+    try
+    {
+        m_file.reset( new MAPPED_FILE( aFileName ) );
+    }
+    catch( const IO_ERROR& )
+    {
+        return false;
+    }
+
+    // Only the counts are read here: the points are read from the mapped file by Restore()
+    CACHE_READER reader( m_file->Data(), m_file->Size() );
+    char         magic[sizeof( s_magic )];
+    uint32_t     version;
+    std::string  boardHash;
+    uint32_t     zoneCount;
+
+    if( !reader.Read( magic, sizeof( magic ) ) || memcmp( magic, s_magic, sizeof( magic ) )
+            || !reader.Read( version ) || version != ZONE_FILL_CACHE_VERSION
+            || !reader.Read( boardHash ) || !reader.Read( zoneCount ) )
+    {
+        clear();
+        return false;
+    }
+
+    for( uint32_t ii = 0; ii < zoneCount; ++ii )
+    {
+        ZONE_RECORD record;
+        uint32_t    count;
+
+        if( !reader.Read( record.m_fillHash ) || !reader.Read( count ) )
+        {
+            clear();
+            return false;
+        }
+
+        record.m_fill = reader.Position();
+
+        for( uint32_t jj = 0; jj < count; ++jj )
+        {
+            uint32_t pointCount;
+
+            if( !reader.Read( pointCount ) || !reader.Skip( pointCount, 2 * sizeof( int32_t ) ) )
+            {
+                clear();
+                return false;
+            }
+        }
+
+        record.m_triangulation = reader.Position();
+
+        if( !reader.Read( count ) )
+        {
+            clear();
+            return false;
+        }
+
+        for( uint32_t jj = 0; jj < count; ++jj )
+        {
+            uint32_t vertexCount;
+            uint32_t triangleCount;
+
+            if( !reader.Read( vertexCount ) || !reader.Skip( vertexCount, 2 * sizeof( int32_t ) )
+                    || !reader.Read( triangleCount )
+                    || !reader.Skip( triangleCount, 3 * sizeof( int32_t ) ) )
+            {
+                clear();
+                return false;
+            }
+        }
+
+        m_zones.push_back( std::move( record ) );
+    }
+
+    if( !reader.AtEnd() )
+    {
+        clear();
+        return false;
+    }
+
+    m_boardMatches = boardHash == hashBoard( aBoard, aBoardSize );
+
+    return true;
+}
+
+
+bool ZONE_FILL_CACHE::Restore( BOARD* aBoard ) const
+{
+    const ZONE_CONTAINERS& zones = aBoard->Zones();
+
+    if( m_boardMatches && zones.size() != m_zones.size() )
+        return false;
+
+    std::unordered_map<std::string, const ZONE_RECORD*> recordsByHash;
+
+    if( !m_boardMatches )
+    {
+        for( const ZONE_RECORD& record : m_zones )
+        {
+            if( !record.m_fillHash.empty() )
+                recordsByHash[record.m_fillHash] = &record;
+        }
+
+        if( recordsByHash.empty() )
+            return true;
+    }
+
+    TASK_GROUP tasks;
+
+    tasks.RunForEach( zones.size(),
+            [&]( size_t aIndex )
+            {
+                ZONE_CONTAINER*    zone = zones[aIndex];
+                const ZONE_RECORD* record = nullptr;
+
+                if( m_boardMatches )
+                {
+                    record = &m_zones[aIndex];
+
+                    CACHE_READER   reader( m_file->Data(), m_file->Size(), record->m_fill );
+                    SHAPE_POLY_SET fill;
+                    uint32_t       contourCount;
+
+                    reader.Read( contourCount );
+
+                    for( uint32_t ii = 0; ii < contourCount; ++ii )
+                    {
+                        uint32_t pointCount;
+
+                        reader.Read( pointCount );
+                        fill.NewOutline();
+
+                        SHAPE_LINE_CHAIN& outline = fill.Outline( ii );
+
+                        // Same as the parser, which drops repeated points
+                        for( uint32_t jj = 0; jj < pointCount; ++jj )
+                            outline.Append( reader.ReadPoint() );
+                    }
+
+                    zone->SetFilledPolysList( fill );
+                }
+
+                if( zone->GetFilledPolysList().IsEmpty()
+                        || ( record && record->m_fillHash.empty() ) )
+                {
+                    return;
+                }
+
+                zone->BuildHashValue();
+
+                MD5_HASH    hash = zone->GetHashValue();
+                std::string fillHash = hash.Format();
+
+                if( !m_boardMatches )
+                {
+                    auto it = recordsByHash.find( fillHash );
+
+                    if( it == recordsByHash.end() )
+                        return;
+
+                    record = it->second;
+                }
+                else if( fillHash != record->m_fillHash )
+                {
+                    return;
+                }
+
+                CACHE_READER reader( m_file->Data(), m_file->Size(), record->m_triangulation );
+                uint32_t     polyCount;
+
+                std::vector<std::unique_ptr<SHAPE_POLY_SET::TRIANGULATED_POLYGON>> polys;
+
+                reader.Read( polyCount );
+
+                for( uint32_t ii = 0; ii < polyCount; ++ii )
+                {
+                    auto     poly = std::make_unique<SHAPE_POLY_SET::TRIANGULATED_POLYGON>();
+                    uint32_t vertexCount;
+                    uint32_t triangleCount;
+
+                    reader.Read( vertexCount );
+
+                    for( uint32_t jj = 0; jj < vertexCount; ++jj )
+                        poly->AddVertex( reader.ReadPoint() );
+
+                    reader.Read( triangleCount );
+
+                    for( uint32_t jj = 0; jj < triangleCount; ++jj )
+                    {
+                        int32_t tri[3];
+
+                        reader.Read( tri, sizeof( tri ) );
+
+                        // A damaged triangulation is computed again when needed
+                        for( int32_t vertex : tri )
+                        {
+                            if( vertex < 0 || (uint32_t) vertex >= vertexCount )
+                                return;
+                        }
+
+                        poly->AddTriangle( tri[0], tri[1], tri[2] );
+                    }
+
+                    polys.push_back( std::move( poly ) );
+                }
+
+                zone->SetFilledPolysTriangulation( std::move( polys ) );
+            } );
+
+    tasks.Wait();
+
+    return true;
+}
+
+
+void ZONE_FILL_CACHE::clear()
+{
+    m_file.reset();
+    m_zones.clear();
+    m_boardMatches = false;
+}
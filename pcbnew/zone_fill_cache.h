@@ -0,0 +1,123 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file zone_fill_cache.h
+ * @brief A binary file next to a board file, holding the fills of its zones.
+ */
+
+#ifndef ZONE_FILL_CACHE_H
+#define ZONE_FILL_CACHE_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <wx/string.h>
+
+class BOARD;
+class MAPPED_FILE;
+
+
+/**
+ * Class ZONE_FILL_CACHE
+ * stores the filled polygons of the zones of a board, and their triangulation, in a compact
+ * binary file next to the board file, which is read mapped in memory.
+ * <p>
+ * The cache holds the hash of the board file it was written with:
+ * <ul>
+ * <li>if the board file did not change since, the parser can skip the fills of the board
+ *  file, and the zones get the fills of the cache (#BoardMatches()).
+ * <li>otherwise, the fills are read from the board file, and a zone whose fill has the same
+ *  hash (ZONE_CONTAINER::GetHashValue()) as in the cache still gets its cached triangulation.
+ * </ul>
+ * The file is versioned, and any file which cannot be read (other version, truncated...) is
+ * ignored.  It is written in the native byte order, since it is never shared.
+ */
+class ZONE_FILL_CACHE
+{
+public:
+    ZONE_FILL_CACHE();
+    ~ZONE_FILL_CACHE();
+
+    /**
+     * Function GetFileName
+     * returns the name of the cache file of the board file @a aBoardFileName.
+     */
+    static wxString GetFileName( const wxString& aBoardFileName );
+
+    /**
+     * Function Write
+     * writes the fills of the zones of @a aBoard, just saved in @a aBoardFileName, in the
+     * file @a aFileName, or the cache file of the board if empty.
+     *
+     * @return false if the file cannot be written.  The file is only a cache, so this is not
+     *  an error.
+     */
+    static bool Write( BOARD* aBoard, const wxString& aBoardFileName,
+                       const wxString& aFileName = wxEmptyString );
+
+    /**
+     * Function Read
+     * maps the file @a aFileName, and checks it against the contents of the board file, held
+     * in @a aBoard.
+     *
+     * @return false, leaving the cache empty, if the file does not exist or is not a valid
+     *  zone fill cache.
+     */
+    bool Read( const wxString& aFileName, const char* aBoard, size_t aBoardSize );
+
+    /**
+     * Function BoardMatches
+     * @return true if the cache was written with the board file it was read with, so that
+     *  the fills of the board file do not need to be parsed.
+     */
+    bool BoardMatches() const { return m_boardMatches; }
+
+    /**
+     * Function Restore
+     * gives the zones of @a aBoard, read from the board file, their fills if the board
+     * matches, and the triangulations of their fills.
+     *
+     * @return false if the board matches but its zones are not the ones of the cache: their
+     *  fills are then missing.
+     */
+    bool Restore( BOARD* aBoard ) const;
+
+private:
+    /// Where the data of a zone is in the file
+    struct ZONE_RECORD
+    {
+        std::string m_fillHash;         ///< empty if there is no triangulation
+        size_t      m_fill;             ///< offset of the outlines
+        size_t      m_triangulation;    ///< offset of the triangulated polygons
+    };
+
+    void clear();
+
+    std::unique_ptr<MAPPED_FILE> m_file;
+    std::vector<ZONE_RECORD>     m_zones;
+    bool                         m_boardMatches;
+};
+
+#endif  // ZONE_FILL_CACHE_H
@@ -23,11 +23,12 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <atomic>
 #include <cstdint>
-#include <thread>
 #include <mutex>
 #include <algorithm>
-#include <future>
+#include <set>
+#include <unordered_map>
 
 #include <class_board.h>
 #include <class_zone.h>
@@ -47,7 +48,9 @@
 #include <geometry/shape_file_io.h>
 #include <geometry/convex_hull.h>
 #include <geometry/geometry_utils.h>
+#include <geometry/rtree.h>
 #include <confirm.h>
+#include <thread_pool.h>
 
 #include "zone_filler.h"
 
@@ -84,7 +87,8 @@ static const bool s_DumpZonesWhenFilling = false;
 
 
 ZONE_FILLER::ZONE_FILLER(  BOARD* aBoard, COMMIT* aCommit ) :
-    m_board( aBoard ), m_commit( aCommit ), m_progressReporter( nullptr )
+    m_board( aBoard ), m_commit( aCommit ), m_progressReporter( nullptr ),
+    m_incremental( false )
 {
 }
 
@@ -116,12 +120,54 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck
         m_progressReporter->SetMaxProgress( toFill.size() );
     }
 
+    std::vector<ZONE_CONTAINER*> candidates;
+    std::vector<MD5_HASH> dependencies;
+    std::vector<bool> stale;
+    DEPENDENCY_INDEX index;
+
+    index.Build( m_board );
+
     for( auto zone : aZones )
     {
         // Keepout zones are not filled
         if( zone->GetIsKeepout() )
             continue;
 
+        MD5_HASH hash = computeDependencyHash( zone, index );
+        const MD5_HASH& previous = zone->GetFillDependencyHash();
+
+        candidates.push_back( zone );
+        dependencies.push_back( hash );
+        stale.push_back( !m_incremental || !zone->IsFilled() || !previous.IsValid()
+                         || previous != hash );
+    }
+
+    // The insulated islands of a zone depend on the fills of the other zones of its net
+    // (they can connect it to a pad), so a stale zone also makes its net companions stale
+    if( m_incremental )
+    {
+        std::set<int> staleNets;
+
+        for( size_t ii = 0; ii < candidates.size(); ++ii )
+        {
+            if( stale[ii] && candidates[ii]->GetNetCode() > 0 )
+                staleNets.insert( candidates[ii]->GetNetCode() );
+        }
+
+        for( size_t ii = 0; ii < candidates.size(); ++ii )
+        {
+            if( staleNets.count( candidates[ii]->GetNetCode() ) )
+                stale[ii] = true;
+        }
+    }
+
+    for( size_t ii = 0; ii < candidates.size(); ++ii )
+    {
+        ZONE_CONTAINER* zone = candidates[ii];
+
+        if( !stale[ii] )
+            continue;
+
         if( m_commit )
             m_commit->Modify( zone );
 
@@ -135,11 +181,16 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck
         // Remove existing fill first to prevent drawing invalid polygons
         // on some platforms
         zone->UnFill();
+        zone->SetFillDependencyHash( dependencies[ii] );
     }
 
+    // Nothing changed since the last fill
+    if( toFill.empty() )
+        return true;
+
     std::atomic<size_t> nextItem( 0 );
-    size_t parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(), toFill.size() );
-    std::vector<std::future<size_t>> returns( parallelThreadCount );
+    size_t parallelThreadCount = std::min<size_t>( THREAD_POOL::GetInstance().GetThreadCount(),
+                                                   toFill.size() );
 
     auto fill_lambda = [&] ( PROGRESS_REPORTER* aReporter ) -> size_t
     {
@@ -168,20 +219,20 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck
         fill_lambda( m_progressReporter );
     else
     {
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii] = std::async( std::launch::async, fill_lambda, m_progressReporter );
+        TASK_GROUP tasks;
 
         for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            tasks.Run( [&]() { fill_lambda( m_progressReporter ); } );
+
+        // The reporter is refreshed every 100ms while waiting, to allow UI updating
+        if( !tasks.Wait( m_progressReporter ) )
         {
-            // Here we balance returns with a 100ms timeout to allow UI updating
-            std::future_status status;
-            do
-            {
-                if( m_progressReporter )
-                    m_progressReporter->KeepRefreshing();
+            // Cancelled by the user: give the zones their previous fill back
+            if( m_commit )
+                m_commit->Revert();
 
-                status = returns[ii].wait_for( std::chrono::milliseconds( 100 ) );
-            } while( status != std::future_status::ready );
+            connectivity->SetProgressReporter( nullptr );
+            return false;
         }
     }
 
@@ -281,20 +332,20 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck
         tri_lambda( m_progressReporter );
     else
     {
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii] = std::async( std::launch::async, tri_lambda, m_progressReporter );
+        TASK_GROUP tasks;
 
         for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            tasks.Run( [&]() { tri_lambda( m_progressReporter ); } );
+
+        // The reporter is refreshed every 100ms while waiting, to allow UI updating
+        if( !tasks.Wait( m_progressReporter ) )
         {
-            // Here we balance returns with a 100ms timeout to allow UI updating
-            std::future_status status;
-            do
-            {
-                if( m_progressReporter )
-                    m_progressReporter->KeepRefreshing();
+            // Cancelled by the user: give the zones their previous fill back
+            if( m_commit )
+                m_commit->Revert();
 
-                status = returns[ii].wait_for( std::chrono::milliseconds( 100 ) );
-            } while( status != std::future_status::ready );
+            connectivity->SetProgressReporter( nullptr );
+            return false;
         }
     }
 
@@ -323,6 +374,442 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck
 }
 
 
+static void hashDouble( MD5_HASH& aHash, double aValue )
+{
+    aHash.Hash( (uint8_t*) &aValue, sizeof( aValue ) );
+}
+
+
+static void hashPoint( MD5_HASH& aHash, const wxPoint& aPoint )
+{
+    aHash.Hash( aPoint.x );
+    aHash.Hash( aPoint.y );
+}
+
+
+static void hashRect( MD5_HASH& aHash, const EDA_RECT& aRect )
+{
+    hashPoint( aHash, aRect.GetOrigin() );
+    aHash.Hash( aRect.GetWidth() );
+    aHash.Hash( aRect.GetHeight() );
+}
+
+
+static void hashString( MD5_HASH& aHash, const wxString& aString )
+{
+    wxScopedCharBuffer utf8 = aString.utf8_str();
+
+    aHash.Hash( (int) utf8.length() );
+    aHash.Hash( (uint8_t*) utf8.data(), utf8.length() );
+}
+
+
+static void hashLayers( MD5_HASH& aHash, const LSET& aLayers )
+{
+    for( PCB_LAYER_ID layer : aLayers.Seq() )
+        aHash.Hash( layer );
+
+    aHash.Hash( UNDEFINED_LAYER );
+}
+
+
+static void hashPolySet( MD5_HASH& aHash, const SHAPE_POLY_SET& aPolySet )
+{
+    aHash.Hash( aPolySet.OutlineCount() );
+    aHash.Hash( aPolySet.TotalVertices() );
+
+    for( auto it = aPolySet.CIterateWithHoles(); it; ++it )
+    {
+        aHash.Hash( it->x );
+        aHash.Hash( it->y );
+    }
+}
+
+
+/**
+ * The items the fill of a zone can depend on: pads, tracks, graphic items and zones.
+ *
+ * They are collected once per ZONE_FILLER::Fill() in an R-tree, so that the dependency hash
+ * of a zone only visits the items close to it and the items of its own net, instead of the
+ * whole board.  Items are known by their index in m_items, which is in board order (pads,
+ * tracks, graphic items, zones): candidates are sorted by index before being hashed, so the
+ * hash does not depend on the shape of the tree.
+ */
+struct ZONE_FILLER::DEPENDENCY_INDEX
+{
+    /// Items are stored by their index in m_items (pointer sized, as RTree stores its data
+    /// in the space of a node pointer)
+    typedef RTree<intptr_t, int, 2, double> INDEX_RTREE;
+
+    void Build( BOARD* aBoard );
+
+    /**
+     * Collect the indices of the items whose indexed bounding box intersects aBBox, of the
+     * pads and tracks of net aNetCode and of the board edges, in board order.
+     */
+    void Query( const EDA_RECT& aBBox, int aNetCode, std::vector<int>& aResult ) const;
+
+    std::vector<BOARD_ITEM*>                   m_items;
+    std::unordered_map<int, std::vector<int>>  m_netItems;     ///< pads and tracks by net
+    std::vector<int>                           m_edgeItems;    ///< Edge_Cuts graphic items
+    INDEX_RTREE                                m_tree;
+
+private:
+    void insert( BOARD_ITEM* aItem, EDA_RECT aBBox );
+};
+
+
+void ZONE_FILLER::DEPENDENCY_INDEX::insert( BOARD_ITEM* aItem, EDA_RECT aBBox )
+{
+    int index = (int) m_items.size();
+
+    m_items.push_back( aItem );
+    aBBox.Normalize();
+
+    const int mmin[2] = { aBBox.GetLeft(), aBBox.GetTop() };
+    const int mmax[2] = { aBBox.GetRight(), aBBox.GetBottom() };
+
+    m_tree.Insert( mmin, mmax, index );
+}
+
+
+void ZONE_FILLER::DEPENDENCY_INDEX::Build( BOARD* aBoard )
+{
+    for( auto module : aBoard->Modules() )
+    {
+        for( auto pad : module->Pads() )
+        {
+            // The pad part of the neighbourhood used by computeDependencyHash(): the zone
+            // part (its own thermal gap and outline thickness) is added by the query
+            EDA_RECT bbox = pad->GetBoundingBox();
+
+            if( pad->GetDrillSize().x || pad->GetDrillSize().y )
+            {
+                EDA_RECT hole( pad->GetPosition(), wxSize( 0, 0 ) );
+                hole.Inflate( std::max( pad->GetDrillSize().x, pad->GetDrillSize().y ) / 2 );
+                bbox.Merge( hole );
+            }
+
+            bbox.Inflate( std::max( pad->GetClearance(), pad->GetThermalGap() ) );
+
+            if( pad->GetNetCode() > 0 )
+                m_netItems[pad->GetNetCode()].push_back( (int) m_items.size() );
+
+            insert( pad, bbox );
+        }
+    }
+
+    for( auto track : aBoard->Tracks() )
+    {
+        if( track->GetNetCode() > 0 )
+            m_netItems[track->GetNetCode()].push_back( (int) m_items.size() );
+
+        insert( track, track->GetBoundingBox() );
+    }
+
+    auto insertGraphicItem = [&]( BOARD_ITEM* aItem )
+    {
+        if( aItem->IsOnLayer( Edge_Cuts ) )
+            m_edgeItems.push_back( (int) m_items.size() );
+
+        insert( aItem, aItem->GetBoundingBox() );
+    };
+
+    for( auto module : aBoard->Modules() )
+    {
+        insertGraphicItem( &module->Reference() );
+        insertGraphicItem( &module->Value() );
+
+        for( auto item : module->GraphicalItems() )
+            insertGraphicItem( item );
+    }
+
+    for( auto item : aBoard->Drawings() )
+        insertGraphicItem( item );
+
+    for( auto zone : aBoard->Zones() )
+        insert( zone, zone->GetBoundingBox() );
+}
+
+
+void ZONE_FILLER::DEPENDENCY_INDEX::Query( const EDA_RECT& aBBox, int aNetCode,
+                                           std::vector<int>& aResult ) const
+{
+    const int mmin[2] = { aBBox.GetLeft(), aBBox.GetTop() };
+    const int mmax[2] = { aBBox.GetRight(), aBBox.GetBottom() };
+
+    auto collect = [&aResult]( const intptr_t& aIndex ) -> bool
+    {
+        aResult.push_back( (int) aIndex );
+        return true;
+    };
+
+    aResult = m_edgeItems;
+    m_tree.Search( mmin, mmax, collect );
+
+    auto net = m_netItems.find( aNetCode );
+
+    if( aNetCode > 0 && net != m_netItems.end() )
+        aResult.insert( aResult.end(), net->second.begin(), net->second.end() );
+
+    std::sort( aResult.begin(), aResult.end() );
+    aResult.erase( std::unique( aResult.begin(), aResult.end() ), aResult.end() );
+}
+
+
+MD5_HASH ZONE_FILLER::computeDependencyHash( ZONE_CONTAINER* aZone,
+                                             const DEPENDENCY_INDEX& aIndex ) const
+{
+    MD5_HASH hash;
+    BOARD_DESIGN_SETTINGS& bds = m_board->GetDesignSettings();
+    int netcode = aZone->GetNetCode();
+
+    // The zone itself
+    hashPolySet( hash, *aZone->Outline() );
+    hashLayers( hash, aZone->GetLayerSet() );
+    hash.Hash( netcode );
+    hash.Hash( aZone->GetPriority() );
+    hash.Hash( aZone->GetClearance() );
+    hash.Hash( aZone->GetZoneClearance() );
+    hash.Hash( aZone->GetMinThickness() );
+    hash.Hash( aZone->GetArcSegmentCount() );
+    hash.Hash( aZone->GetPadConnection() );
+    hash.Hash( aZone->GetThermalReliefGap() );
+    hash.Hash( aZone->GetThermalReliefCopperBridge() );
+    hash.Hash( aZone->GetFillMode() );
+    hash.Hash( aZone->GetHatchFillTypeThickness() );
+    hash.Hash( aZone->GetHatchFillTypeGap() );
+    hashDouble( hash, aZone->GetHatchFillTypeOrientation() );
+    hash.Hash( aZone->GetHatchFillTypeSmoothingLevel() );
+    hashDouble( hash, aZone->GetHatchFillTypeSmoothingValue() );
+    hash.Hash( aZone->GetCornerSmoothingType() );
+    hash.Hash( (int) aZone->GetCornerRadius() );
+
+    // Board wide settings
+    int biggest_clearance = bds.GetBiggestClearanceValue();
+    hash.Hash( bds.m_CopperEdgeClearance );
+    hash.Hash( biggest_clearance );
+
+    /* Items of other nets are only cut from the zone if they are close to it. Use the same
+     * (or a larger) neighbourhood than buildZoneFeatureHoleList() to find them.
+     * Items of the zone net are always hashed, wherever they are, because the insulated
+     * islands removal depends on the connections of the whole net.
+     */
+    int outline_half_thickness = aZone->GetMinThickness() / 2;
+    EDA_RECT zone_boundingbox = aZone->GetBoundingBox();
+    zone_boundingbox.Inflate( std::max( { biggest_clearance,
+                                          aZone->GetClearance(),
+                                          aZone->GetZoneClearance(),
+                                          bds.m_CopperEdgeClearance } )
+                              + outline_half_thickness );
+
+    // Pads are indexed with their own clearance and thermal gap, the zone ones are added here
+    EDA_RECT query_boundingbox = zone_boundingbox;
+    query_boundingbox.Inflate( aZone->GetThermalReliefGap() + outline_half_thickness );
+
+    std::vector<int> candidates;
+    aIndex.Query( query_boundingbox, netcode, candidates );
+
+    auto sameNet = [&]( const BOARD_CONNECTED_ITEM* aItem )
+    {
+        return netcode > 0 && aItem->GetNetCode() == netcode;
+    };
+
+    auto hashPad = [&]( D_PAD* pad )
+    {
+        EDA_RECT item_boundingbox = pad->GetBoundingBox();
+
+        if( pad->GetDrillSize().x || pad->GetDrillSize().y )
+        {
+            EDA_RECT hole( pad->GetPosition(), wxSize( 0, 0 ) );
+            hole.Inflate( std::max( pad->GetDrillSize().x, pad->GetDrillSize().y ) / 2 );
+            item_boundingbox.Merge( hole );
+        }
+
+        item_boundingbox.Inflate( std::max( pad->GetClearance(),
+                                            aZone->GetThermalReliefGap( pad ) )
+                                  + outline_half_thickness );
+
+        if( !sameNet( pad ) && !item_boundingbox.Intersects( zone_boundingbox ) )
+            return;
+
+        hashPoint( hash, pad->GetPosition() );
+        hashDouble( hash, pad->GetOrientation() );
+        hash.Hash( pad->GetShape() );
+        hash.Hash( pad->GetSize().x );
+        hash.Hash( pad->GetSize().y );
+        hash.Hash( pad->GetDrillShape() );
+        hash.Hash( pad->GetDrillSize().x );
+        hash.Hash( pad->GetDrillSize().y );
+        hashPoint( hash, pad->GetOffset() );
+        hash.Hash( pad->GetDelta().x );
+        hash.Hash( pad->GetDelta().y );
+        hashLayers( hash, pad->GetLayerSet() );
+        hash.Hash( pad->GetNetCode() );
+        hash.Hash( pad->GetClearance() );
+        hash.Hash( pad->GetAttribute() );
+        hash.Hash( aZone->GetPadConnection( pad ) );
+        hash.Hash( aZone->GetThermalReliefGap( pad ) );
+        hash.Hash( aZone->GetThermalReliefCopperBridge( pad ) );
+        hashDouble( hash, pad->GetRoundRectRadiusRatio() );
+        hashDouble( hash, pad->GetChamferRectRatio() );
+        hash.Hash( pad->GetChamferPositions() );
+
+        if( pad->GetShape() == PAD_SHAPE_CUSTOM )
+        {
+            hash.Hash( pad->GetCustomShapeInZoneOpt() );
+            hashPolySet( hash, pad->GetCustomShapeAsPolygon() );
+        }
+    };
+
+    auto hashTrack = [&]( TRACK* track )
+    {
+        if( !sameNet( track ) )
+        {
+            if( !track->IsOnLayer( aZone->GetLayer() ) )
+                return;
+
+            if( !track->GetBoundingBox().Intersects( zone_boundingbox ) )
+                return;
+        }
+
+        hash.Hash( track->Type() );
+        hashPoint( hash, track->GetStart() );
+        hashPoint( hash, track->GetEnd() );
+        hash.Hash( track->GetWidth() );
+        hashLayers( hash, track->GetLayerSet() );
+        hash.Hash( track->GetNetCode() );
+        hash.Hash( track->GetClearance() );
+    };
+
+    // Graphic items on the zone layer, and the board edges which can clip no net zones
+    auto hashGraphicItem = [&]( BOARD_ITEM* aItem )
+    {
+        // The board outline is used as a whole, so the board edges are always hashed
+        if( !aItem->IsOnLayer( Edge_Cuts ) )
+        {
+            if( !aItem->IsOnLayer( aZone->GetLayer() )
+                || !aItem->GetBoundingBox().Intersects( zone_boundingbox ) )
+                return;
+        }
+
+        hash.Hash( aItem->Type() );
+        hash.Hash( aItem->GetLayer() );
+
+        switch( aItem->Type() )
+        {
+        case PCB_LINE_T:
+        case PCB_MODULE_EDGE_T:
+        {
+            DRAWSEGMENT* seg = static_cast<DRAWSEGMENT*>( aItem );
+
+            hash.Hash( seg->GetShape() );
+            hashPoint( hash, seg->GetStart() );
+            hashPoint( hash, seg->GetEnd() );
+            hash.Hash( seg->GetWidth() );
+            hashDouble( hash, seg->GetAngle() );
+
+            for( const wxPoint& pt : seg->GetBezierPoints() )
+                hashPoint( hash, pt );
+
+            // Footprint polygons are stored relative to their footprint: hash their actual
+            // position, as TransformShapeWithClearanceToPolygon() builds it
+            MODULE* module = seg->GetParentModule();
+            double orientation = module ? module->GetOrientation() : 0.0;
+            wxPoint offset = module ? module->GetPosition() : wxPoint( 0, 0 );
+
+            for( wxPoint pt : seg->BuildPolyPointsList() )
+            {
+                RotatePoint( &pt, orientation );
+                hashPoint( hash, pt + offset );
+            }
+
+            break;
+        }
+
+        case PCB_TEXT_T:
+        case PCB_MODULE_TEXT_T:
+        {
+            EDA_TEXT* text = dynamic_cast<EDA_TEXT*>( aItem );
+
+            // The knockout is the text box, but a text of the same box can be another text:
+            // hash what the box is computed from too
+            hashRect( hash, text->GetTextBox( -1 ) );
+            hashPoint( hash, text->GetTextPos() );
+            hashDouble( hash, text->GetTextAngle() );
+            hash.Hash( text->IsVisible() );
+            hashString( hash, text->GetShownText() );
+            hash.Hash( text->GetTextSize().x );
+            hash.Hash( text->GetTextSize().y );
+            hash.Hash( text->GetThickness() );
+            hash.Hash( text->IsItalic() );
+            hash.Hash( text->IsBold() );
+            hash.Hash( text->IsMirrored() );
+            hash.Hash( text->IsMultilineAllowed() );
+            hash.Hash( text->GetHorizJustify() );
+            hash.Hash( text->GetVertJustify() );
+            break;
+        }
+
+        default:
+            hashRect( hash, aItem->GetBoundingBox() );
+            break;
+        }
+    };
+
+    // Zones which can be cut from this one.  Zones of the same net are not needed here:
+    // Fill() refills all the zones of a net together.
+    auto hashZone = [&]( ZONE_CONTAINER* zone )
+    {
+        if( zone == aZone || !aZone->CommonLayerExists( zone->GetLayerSet() ) )
+            return;
+
+        if( !zone->GetBoundingBox().Intersects( zone_boundingbox ) )
+            return;
+
+        hashPolySet( hash, *zone->Outline() );
+        hashLayers( hash, zone->GetLayerSet() );
+        hash.Hash( zone->GetNetCode() );
+        hash.Hash( zone->GetPriority() );
+        hash.Hash( zone->GetClearance() );
+        hash.Hash( zone->GetIsKeepout() );
+        hash.Hash( zone->GetDoNotAllowCopperPour() );
+        hash.Hash( zone->GetCornerSmoothingType() );
+        hash.Hash( (int) zone->GetCornerRadius() );
+        hash.Hash( zone->GetArcSegmentCount() );
+    };
+
+    for( int index : candidates )
+    {
+        BOARD_ITEM* item = aIndex.m_items[index];
+
+        switch( item->Type() )
+        {
+        case PCB_PAD_T:
+            hashPad( static_cast<D_PAD*>( item ) );
+            break;
+
+        case PCB_TRACE_T:
+        case PCB_VIA_T:
+            hashTrack( static_cast<TRACK*>( item ) );
+            break;
+
+        case PCB_ZONE_AREA_T:
+            hashZone( static_cast<ZONE_CONTAINER*>( item ) );
+            break;
+
+        default:
+            hashGraphicItem( item );
+            break;
+        }
+    }
+
+    hash.Finalize();
+
+    return hash;
+}
+
+
 void ZONE_FILLER::buildZoneFeatureHoleList( const ZONE_CONTAINER* aZone,
         SHAPE_POLY_SET& aFeatures ) const
 {
@@ -788,6 +1275,9 @@ void ZONE_FILLER::computeRawFilledAreas( const ZONE_CONTAINER* aZone,
 
     if( aZone->GetNetCode() > 0 )
     {
+        // 4 points are tested per pad
+        solidAreas.EnableEdgeIndex();
+
         buildUnconnectedThermalStubsPolygonList( thermalHoles, aZone, solidAreas,
                 correctionFactor, s_thermalRot );
 
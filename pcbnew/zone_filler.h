@@ -42,10 +42,29 @@ public:
     ~ZONE_FILLER();
 
     void SetProgressReporter( WX_PROGRESS_REPORTER* aReporter );
+
+    /**
+     * In incremental mode, Fill() skips the zones whose fill inputs (outline, settings and
+     * the items they are cut by or connected to) did not change since they were last filled.
+     */
+    void SetIncremental( bool aIncremental ) { m_incremental = aIncremental; }
+
     bool Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck = false );
 
 private:
 
+    /// The items the zone fills can depend on, collected once per Fill()
+    struct DEPENDENCY_INDEX;
+
+    /**
+     * Build a hash of everything the fill of aZone depends on: its outline and settings,
+     * the other net items which can be cut from it, the items of its own net (which decide
+     * of its thermal reliefs and insulated islands), the board edges and the zones which
+     * can overlap it.
+     * @param aIndex holds the candidate items of the board, see DEPENDENCY_INDEX
+     */
+    MD5_HASH computeDependencyHash( ZONE_CONTAINER* aZone, const DEPENDENCY_INDEX& aIndex ) const;
+
     void buildZoneFeatureHoleList( const ZONE_CONTAINER* aZone,
             SHAPE_POLY_SET& aFeatures ) const;
 
@@ -111,6 +130,7 @@ private:
     BOARD* m_board;
     COMMIT* m_commit;
     WX_PROGRESS_REPORTER* m_progressReporter;
+    bool m_incremental;
 };
 
 #endif
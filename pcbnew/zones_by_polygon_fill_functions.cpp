@@ -76,6 +76,7 @@ void PCB_EDIT_FRAME::Check_All_Zones( wxWindow* aActiveWindow )
 
     ZONE_FILLER filler( GetBoard(), &commit );
     filler.SetProgressReporter( progressReporter.get() );
+    filler.SetIncremental( true );
 
     if( filler.Fill( toFill, true ) )
     {
@@ -23,7 +23,9 @@
 
 // Note: the board's bottom side is at Z = 0
 
+#include <atomic>
 #include <iostream>
+#include <locale.h>
 #include <sstream>
 #include <cmath>
 #include <string>
@@ -32,6 +34,10 @@
 #include <wx/log.h>
 #include <wx/string.h>
 
+#ifdef __APPLE__
+#include <xlocale.h>
+#endif
+
 #include "plugins/3d/3d_plugin.h"
 #include "plugins/3dapi/ifsg_all.h"
 #include "idf_parser.h"
@@ -72,18 +78,56 @@ static bool addSegment( VRML_LAYER& model, IDF_SEGMENT* seg, int icont, int iseg
 static SCENEGRAPH* vrmlToSG( VRML_LAYER& vpcb, int idxColor, SGNODE* aParent, double top, double bottom );
 
 
+// switches the numeric locale of the calling thread only: models may be loaded by
+// several threads at once, and the other threads of KiCad keep the user locale
 class LOCALESWITCH
 {
+#ifdef _WIN32
+    // the per thread locale setting of the thread and its locale, restored in dtor
+    int         m_threadLocale;
+    std::string m_locale;
+
 public:
     LOCALESWITCH()
     {
+        m_threadLocale = _configthreadlocale( _ENABLE_PER_THREAD_LOCALE );
+        m_locale = setlocale( LC_NUMERIC, 0 );
         setlocale( LC_NUMERIC, "C" );
     }
 
     ~LOCALESWITCH()
     {
-        setlocale( LC_NUMERIC, "" );
+        setlocale( LC_NUMERIC, m_locale.c_str() );
+        _configthreadlocale( m_threadLocale );
     }
+#else
+    // the "C" numeric locale of the thread, and the locale it replaced
+    locale_t m_locale;
+    locale_t m_previous;
+
+public:
+    LOCALESWITCH()
+    {
+        m_previous = uselocale( (locale_t) 0 );
+
+        locale_t base = duplocale( m_previous );
+        m_locale = base ? newlocale( LC_NUMERIC_MASK, "C", base ) : (locale_t) 0;
+
+        if( m_locale )
+            uselocale( m_locale );
+        else if( base )
+            freelocale( base );
+    }
+
+    ~LOCALESWITCH()
+    {
+        if( m_locale )
+        {
+            uselocale( m_previous );
+            freelocale( m_locale );
+        }
+    }
+#endif
 };
 
 
@@ -91,11 +135,12 @@ static SGNODE* getColor( IFSG_SHAPE& shape, int colorIdx )
 {
     IFSG_APPEARANCE material( shape );
 
-    static int cidx = 1;
+    // the next color of the palette, shared by the outlines loaded by all threads
+    static std::atomic<unsigned> cidx( 0 );
     int idx;
 
     if( colorIdx == -1 )
-        idx = cidx;
+        idx = cidx++ % NCOLORS + 1;
     else
         idx = colorIdx;
 
@@ -165,9 +210,6 @@ static SGNODE* getColor( IFSG_SHAPE& shape, int colorIdx )
         break;
     }
 
-    if( ( colorIdx == -1 ) && ( ++cidx > NCOLORS ) )
-        cidx = 1;
-
     return material.GetRawPtr();
 }
 
@@ -279,6 +321,13 @@ bool CanRender( void )
 }
 
 
+bool IsThreadSafe( void )
+{
+    // the locale is switched per thread, and the palette index is atomic
+    return true;
+}
+
+
 SCENEGRAPH* Load( char const* aFileName )
 {
     if( NULL == aFileName )
@@ -82,9 +82,46 @@ WRL1NODE* NAMEREGISTER::FindName( const std::string& aName )
 }
 
 
-typedef std::pair< std::string, WRL1NODES > NODEITEM;
+// the table is built when the plugin is loaded: the parsers, which may run in
+// several threads at once, only read it
 typedef std::map< std::string, WRL1NODES > NODEMAP;
-static NODEMAP nodenames;
+static const NODEMAP nodenames = {
+    { "AsciiText", WRL1_ASCIITEXT },
+    { "Cone", WRL1_CONE },
+    { "Coordinate3", WRL1_COORDINATE3 },
+    { "Cube", WRL1_CUBE },
+    { "Cylinder", WRL1_CYLINDER },
+    { "DirectionalLight", WRL1_DIRECTIONALLIGHT },
+    { "FontStyle", WRL1_FONTSTYLE },
+    { "Group", WRL1_GROUP },
+    { "IndexedFaceSet", WRL1_INDEXEDFACESET },
+    { "IndexedLineSet", WRL1_INDEXEDLINESET },
+    { "Info", WRL1_INFO },
+    { "LOD", WRL1_LOD },
+    { "Material", WRL1_MATERIAL },
+    { "MaterialBinding", WRL1_MATERIALBINDING },
+    { "MatrixTransform", WRL1_MATRIXTRANSFORM },
+    { "Normal", WRL1_NORMAL },
+    { "NormalBinding", WRL1_NORMALBINDING },
+    { "OrthographicCamera", WRL1_ORTHOCAMERA },
+    { "PerspectiveCamera", WRL1_PERSPECTIVECAMERA },
+    { "PointLight", WRL1_POINTLIGHT },
+    { "PointSet", WRL1_POINTSET },
+    { "Rotation", WRL1_ROTATION },
+    { "Scale", WRL1_SCALE },
+    { "Separator", WRL1_SEPARATOR },
+    { "ShapeHints", WRL1_SHAPEHINTS },
+    { "Sphere", WRL1_SPHERE },
+    { "SpotLight", WRL1_SPOTLIGHT },
+    { "Switch", WRL1_SWITCH },
+    { "Texture2", WRL1_TEXTURE2 },
+    { "Testure2Transform", WRL1_TEXTURE2TRANSFORM },
+    { "TextureCoordinate2", WRL1_TEXTURECOORDINATE2 },
+    { "Transform", WRL1_TRANSFORM },
+    { "Translation", WRL1_TRANSLATION },
+    { "WWWAnchor", WRL1_WWWANCHOR },
+    { "WWWInline", WRL1_WWWINLINE }
+};
 
 #if defined( DEBUG_VRML1 ) && ( DEBUG_VRML1 > 2 )
 std::string WRL1NODE::tabs = "";
@@ -97,45 +134,6 @@ WRL1NODE::WRL1NODE( NAMEREGISTER* aDictionary )
     m_Type = WRL1_END;
     m_dictionary = aDictionary;
 
-    if( nodenames.empty() )
-    {
-        nodenames.insert( NODEITEM( "AsciiText", WRL1_ASCIITEXT ) );
-        nodenames.insert( NODEITEM( "Cone", WRL1_CONE ) );
-        nodenames.insert( NODEITEM( "Coordinate3", WRL1_COORDINATE3 ) );
-        nodenames.insert( NODEITEM( "Cube", WRL1_CUBE ) );
-        nodenames.insert( NODEITEM( "Cylinder", WRL1_CYLINDER ) );
-        nodenames.insert( NODEITEM( "DirectionalLight", WRL1_DIRECTIONALLIGHT ) );
-        nodenames.insert( NODEITEM( "FontStyle", WRL1_FONTSTYLE ) );
-        nodenames.insert( NODEITEM( "Group", WRL1_GROUP ) );
-        nodenames.insert( NODEITEM( "IndexedFaceSet", WRL1_INDEXEDFACESET ) );
-        nodenames.insert( NODEITEM( "IndexedLineSet", WRL1_INDEXEDLINESET ) );
-        nodenames.insert( NODEITEM( "Info", WRL1_INFO ) );
-        nodenames.insert( NODEITEM( "LOD", WRL1_LOD ) );
-        nodenames.insert( NODEITEM( "Material", WRL1_MATERIAL ) );
-        nodenames.insert( NODEITEM( "MaterialBinding", WRL1_MATERIALBINDING ) );
-        nodenames.insert( NODEITEM( "MatrixTransform", WRL1_MATRIXTRANSFORM ) );
-        nodenames.insert( NODEITEM( "Normal", WRL1_NORMAL ) );
-        nodenames.insert( NODEITEM( "NormalBinding", WRL1_NORMALBINDING ) );
-        nodenames.insert( NODEITEM( "OrthographicCamera", WRL1_ORTHOCAMERA ) );
-        nodenames.insert( NODEITEM( "PerspectiveCamera", WRL1_PERSPECTIVECAMERA ) );
-        nodenames.insert( NODEITEM( "PointLight", WRL1_POINTLIGHT ) );
-        nodenames.insert( NODEITEM( "PointSet", WRL1_POINTSET ) );
-        nodenames.insert( NODEITEM( "Rotation", WRL1_ROTATION ) );
-        nodenames.insert( NODEITEM( "Scale", WRL1_SCALE ) );
-        nodenames.insert( NODEITEM( "Separator", WRL1_SEPARATOR ) );
-        nodenames.insert( NODEITEM( "ShapeHints", WRL1_SHAPEHINTS ) );
-        nodenames.insert( NODEITEM( "Sphere", WRL1_SPHERE ) );
-        nodenames.insert( NODEITEM( "SpotLight", WRL1_SPOTLIGHT ) );
-        nodenames.insert( NODEITEM( "Switch", WRL1_SWITCH ) );
-        nodenames.insert( NODEITEM( "Texture2", WRL1_TEXTURE2 ) );
-        nodenames.insert( NODEITEM( "Testure2Transform", WRL1_TEXTURE2TRANSFORM ) );
-        nodenames.insert( NODEITEM( "TextureCoordinate2", WRL1_TEXTURECOORDINATE2 ) );
-        nodenames.insert( NODEITEM( "Transform", WRL1_TRANSFORM ) );
-        nodenames.insert( NODEITEM( "Translation", WRL1_TRANSLATION ) );
-        nodenames.insert( NODEITEM( "WWWAnchor", WRL1_WWWANCHOR ) );
-        nodenames.insert( NODEITEM( "WWWInline", WRL1_WWWINLINE ) );
-    }
-
     return;
 }
 
@@ -383,7 +381,7 @@ const char* WRL1NODE::GetNodeTypeName( WRL1NODES aNodeType ) const
     if( aNodeType == WRL1_BASE )
         return "*VIRTUAL_BASE*";
 
-    NODEMAP::iterator it = nodenames.begin();
+    NODEMAP::const_iterator it = nodenames.begin();
     advance( it, (aNodeType - WRL1_BEGIN) );
 
     return it->first.c_str();
@@ -392,7 +390,7 @@ const char* WRL1NODE::GetNodeTypeName( WRL1NODES aNodeType ) const
 
 WRL1NODES WRL1NODE::getNodeTypeID( const std::string& aNodeName )
 {
-    NODEMAP::iterator it = nodenames.find( aNodeName );
+    NODEMAP::const_iterator it = nodenames.find( aNodeName );
 
     if( nodenames.end() != it )
         return it->second;
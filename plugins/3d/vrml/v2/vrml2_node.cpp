@@ -35,11 +35,82 @@
 #include "vrml2_node.h"
 
 
-static std::set< std::string > badNames;
+// the tables are built when the plugin is loaded: the parsers, which may run in
+// several threads at once, only read them
+static const std::set< std::string > badNames = {
+    "DEF",
+    "EXTERNPROTO",
+    "FALSE",
+    "IS",
+    "NULL",
+    "PROTO",
+    "ROUTE",
+    "TO",
+    "TRUE",
+    "USE",
+    "eventIn",
+    "eventOut",
+    "exposedField",
+    "field"
+};
 
-typedef std::pair< std::string, WRL2NODES > NODEITEM;
 typedef std::map< std::string, WRL2NODES > NODEMAP;
-static NODEMAP nodenames;
+static const NODEMAP nodenames = {
+    { "Anchor", WRL2_ANCHOR },
+    { "Appearance", WRL2_APPEARANCE },
+    { "Audioclip", WRL2_AUDIOCLIP },
+    { "Background", WRL2_BACKGROUND },
+    { "Billboard", WRL2_BILLBOARD },
+    { "Box", WRL2_BOX },
+    { "Collision", WRL2_COLLISION },
+    { "Color", WRL2_COLOR },
+    { "ColorInterpolator", WRL2_COLORINTERPOLATOR },
+    { "Cone", WRL2_CONE },
+    { "Coordinate", WRL2_COORDINATE },
+    { "CoordinateInterpolator", WRL2_COORDINATEINTERPOLATOR },
+    { "Cylinder", WRL2_CYLINDER },
+    { "CylinderSensor", WRL2_CYLINDERSENSOR },
+    { "DirectionalLight", WRL2_DIRECTIONALLIGHT },
+    { "ElevationGrid", WRL2_ELEVATIONGRID },
+    { "Extrusion", WRL2_EXTRUSION },
+    { "Fog", WRL2_FOG },
+    { "FontStyle", WRL2_FONTSTYLE },
+    { "Group", WRL2_GROUP },
+    { "ImageTexture", WRL2_IMAGETEXTURE },
+    { "IndexedFaceSet", WRL2_INDEXEDFACESET },
+    { "IndexedLineSet", WRL2_INDEXEDLINESET },
+    { "Inline", WRL2_INLINE },
+    { "LOD", WRL2_LOD },
+    { "Material", WRL2_MATERIAL },
+    { "MovieTexture", WRL2_MOVIETEXTURE },
+    { "NavigationInfo", WRL2_NAVIGATIONINFO },
+    { "Normal", WRL2_NORMAL },
+    { "NormalInterpolator", WRL2_NORMALINTERPOLATOR },
+    { "OrientationInterpolator", WRL2_ORIENTATIONINTERPOLATOR },
+    { "PixelTexture", WRL2_PIXELTEXTURE },
+    { "PlaneSensor", WRL2_PLANESENSOR },
+    { "PointLight", WRL2_POINTLIGHT },
+    { "PointSet", WRL2_POINTSET },
+    { "PositionInterpolator", WRL2_POSITIONINTERPOLATOR },
+    { "ProximitySensor", WRL2_PROXIMITYSENSOR },
+    { "ScalarInterpolator", WRL2_SCALARINTERPOLATOR },
+    { "Script", WRL2_SCRIPT },
+    { "Shape", WRL2_SHAPE },
+    { "Sound", WRL2_SOUND },
+    { "Sphere", WRL2_SPHERE },
+    { "SphereSensor", WRL2_SPHERESENSOR },
+    { "SpotLight", WRL2_SPOTLIGHT },
+    { "Switch", WRL2_SWITCH },
+    { "Text", WRL2_TEXT },
+    { "TextureCoordinate", WRL2_TEXTURECOORDINATE },
+    { "TextureTransform", WRL2_TEXTURETRANSFORM },
+    { "TimeSensor", WRL2_TIMESENSOR },
+    { "TouchSensor", WRL2_TOUCHSENSOR },
+    { "Transform", WRL2_TRANSFORM },
+    { "ViewPoint", WRL2_VIEWPOINT },
+    { "VisibilitySensor", WRL2_VISIBILITYSENSOR },
+    { "WorldInfo", WRL2_WORLDINFO }
+};
 
 
 WRL2NODE::WRL2NODE()
@@ -48,82 +119,6 @@ WRL2NODE::WRL2NODE()
     m_Parent = NULL;
     m_Type = WRL2_END;
 
-    if( badNames.empty() )
-    {
-        badNames.insert( "DEF" );
-        badNames.insert( "EXTERNPROTO" );
-        badNames.insert( "FALSE" );
-        badNames.insert( "IS" );
-        badNames.insert( "NULL" );
-        badNames.insert( "PROTO" );
-        badNames.insert( "ROUTE" );
-        badNames.insert( "TO" );
-        badNames.insert( "TRUE" );
-        badNames.insert( "USE" );
-        badNames.insert( "eventIn" );
-        badNames.insert( "eventOut" );
-        badNames.insert( "exposedField" );
-        badNames.insert( "field" );
-    }
-
-    if( nodenames.empty() )
-    {
-        nodenames.insert( NODEITEM( "Anchor", WRL2_ANCHOR ) );
-        nodenames.insert( NODEITEM( "Appearance", WRL2_APPEARANCE ) );
-        nodenames.insert( NODEITEM( "Audioclip", WRL2_AUDIOCLIP ) );
-        nodenames.insert( NODEITEM( "Background", WRL2_BACKGROUND ) );
-        nodenames.insert( NODEITEM( "Billboard", WRL2_BILLBOARD ) );
-        nodenames.insert( NODEITEM( "Box", WRL2_BOX ) );
-        nodenames.insert( NODEITEM( "Collision", WRL2_COLLISION ) );
-        nodenames.insert( NODEITEM( "Color", WRL2_COLOR ) );
-        nodenames.insert( NODEITEM( "ColorInterpolator", WRL2_COLORINTERPOLATOR ) );
-        nodenames.insert( NODEITEM( "Cone", WRL2_CONE ) );
-        nodenames.insert( NODEITEM( "Coordinate", WRL2_COORDINATE ) );
-        nodenames.insert( NODEITEM( "CoordinateInterpolator", WRL2_COORDINATEINTERPOLATOR ) );
-        nodenames.insert( NODEITEM( "Cylinder", WRL2_CYLINDER ) );
-        nodenames.insert( NODEITEM( "CylinderSensor", WRL2_CYLINDERSENSOR ) );
-        nodenames.insert( NODEITEM( "DirectionalLight", WRL2_DIRECTIONALLIGHT ) );
-        nodenames.insert( NODEITEM( "ElevationGrid", WRL2_ELEVATIONGRID ) );
-        nodenames.insert( NODEITEM( "Extrusion", WRL2_EXTRUSION ) );
-        nodenames.insert( NODEITEM( "Fog", WRL2_FOG ) );
-        nodenames.insert( NODEITEM( "FontStyle", WRL2_FONTSTYLE ) );
-        nodenames.insert( NODEITEM( "Group", WRL2_GROUP ) );
-        nodenames.insert( NODEITEM( "ImageTexture", WRL2_IMAGETEXTURE ) );
-        nodenames.insert( NODEITEM( "IndexedFaceSet", WRL2_INDEXEDFACESET ) );
-        nodenames.insert( NODEITEM( "IndexedLineSet", WRL2_INDEXEDLINESET ) );
-        nodenames.insert( NODEITEM( "Inline", WRL2_INLINE ) );
-        nodenames.insert( NODEITEM( "LOD", WRL2_LOD ) );
-        nodenames.insert( NODEITEM( "Material", WRL2_MATERIAL ) );
-        nodenames.insert( NODEITEM( "MovieTexture", WRL2_MOVIETEXTURE ) );
-        nodenames.insert( NODEITEM( "NavigationInfo", WRL2_NAVIGATIONINFO ) );
-        nodenames.insert( NODEITEM( "Normal", WRL2_NORMAL ) );
-        nodenames.insert( NODEITEM( "NormalInterpolator", WRL2_NORMALINTERPOLATOR ) );
-        nodenames.insert( NODEITEM( "OrientationInterpolator", WRL2_ORIENTATIONINTERPOLATOR ) );
-        nodenames.insert( NODEITEM( "PixelTexture", WRL2_PIXELTEXTURE ) );
-        nodenames.insert( NODEITEM( "PlaneSensor", WRL2_PLANESENSOR ) );
-        nodenames.insert( NODEITEM( "PointLight", WRL2_POINTLIGHT ) );
-        nodenames.insert( NODEITEM( "PointSet", WRL2_POINTSET ) );
-        nodenames.insert( NODEITEM( "PositionInterpolator", WRL2_POSITIONINTERPOLATOR ) );
-        nodenames.insert( NODEITEM( "ProximitySensor", WRL2_PROXIMITYSENSOR ) );
-        nodenames.insert( NODEITEM( "ScalarInterpolator", WRL2_SCALARINTERPOLATOR ) );
-        nodenames.insert( NODEITEM( "Script", WRL2_SCRIPT ) );
-        nodenames.insert( NODEITEM( "Shape", WRL2_SHAPE ) );
-        nodenames.insert( NODEITEM( "Sound", WRL2_SOUND ) );
-        nodenames.insert( NODEITEM( "Sphere", WRL2_SPHERE ) );
-        nodenames.insert( NODEITEM( "SphereSensor", WRL2_SPHERESENSOR ) );
-        nodenames.insert( NODEITEM( "SpotLight", WRL2_SPOTLIGHT ) );
-        nodenames.insert( NODEITEM( "Switch", WRL2_SWITCH ) );
-        nodenames.insert( NODEITEM( "Text", WRL2_TEXT ) );
-        nodenames.insert( NODEITEM( "TextureCoordinate", WRL2_TEXTURECOORDINATE ) );
-        nodenames.insert( NODEITEM( "TextureTransform", WRL2_TEXTURETRANSFORM ) );
-        nodenames.insert( NODEITEM( "TimeSensor", WRL2_TIMESENSOR ) );
-        nodenames.insert( NODEITEM( "TouchSensor", WRL2_TOUCHSENSOR ) );
-        nodenames.insert( NODEITEM( "Transform", WRL2_TRANSFORM ) );
-        nodenames.insert( NODEITEM( "ViewPoint", WRL2_VIEWPOINT ) );
-        nodenames.insert( NODEITEM( "VisibilitySensor", WRL2_VISIBILITYSENSOR ) );
-        nodenames.insert( NODEITEM( "WorldInfo", WRL2_WORLDINFO ) );
-    }
-
     return;
 }
 
@@ -232,7 +227,7 @@ bool WRL2NODE::SetName( const std::string& aName )
     if( aName.empty() )
         return false;
 
-    std::set< std::string >::iterator item = badNames.find( aName );
+    std::set< std::string >::const_iterator item = badNames.find( aName );
 
     if( item != badNames.end() )
     {
@@ -300,7 +295,7 @@ const char* WRL2NODE::GetNodeTypeName( WRL2NODES aNodeType ) const
     if( aNodeType == WRL2_BASE )
         return "*VIRTUAL_BASE*";
 
-    NODEMAP::iterator it = nodenames.begin();
+    NODEMAP::const_iterator it = nodenames.begin();
     advance( it, (aNodeType - WRL2_BEGIN) );
 
     return it->first.c_str();
@@ -309,7 +304,7 @@ const char* WRL2NODE::GetNodeTypeName( WRL2NODES aNodeType ) const
 
 WRL2NODES WRL2NODE::getNodeTypeID( const std::string& aNodeName )
 {
-    NODEMAP::iterator it = nodenames.find( aNodeName );
+    NODEMAP::const_iterator it = nodenames.find( aNodeName );
 
     if( nodenames.end() != it )
         return it->second;
@@ -32,6 +32,11 @@
  */
 
 #include <locale.h>
+
+#ifdef __APPLE__
+#include <xlocale.h>
+#endif
+
 #include <wx/log.h>
 #include <wx/filename.h>
 #include "richio.h"
@@ -156,14 +161,26 @@ bool CanRender( void )
 }
 
 
+bool IsThreadSafe( void )
+{
+    // the locale is switched per thread, and the VRML node tables are only read
+    return true;
+}
+
+
+// switches the numeric locale of the calling thread only: models may be loaded by
+// several threads at once, and the other threads of KiCad keep the user locale
 class LOCALESWITCH
 {
-    // Store the user locale name, to restore this locale later, in dtor
+#ifdef _WIN32
+    // the per thread locale setting of the thread and its locale, restored in dtor
+    int         m_threadLocale;
     std::string m_locale;
 
 public:
     LOCALESWITCH()
     {
+        m_threadLocale = _configthreadlocale( _ENABLE_PER_THREAD_LOCALE );
         m_locale = setlocale( LC_NUMERIC, 0 );
         setlocale( LC_NUMERIC, "C" );
     }
@@ -171,7 +188,36 @@ public:
     ~LOCALESWITCH()
     {
         setlocale( LC_NUMERIC, m_locale.c_str() );
+        _configthreadlocale( m_threadLocale );
+    }
+#else
+    // the "C" numeric locale of the thread, and the locale it replaced
+    locale_t m_locale;
+    locale_t m_previous;
+
+public:
+    LOCALESWITCH()
+    {
+        m_previous = uselocale( (locale_t) 0 );
+
+        locale_t base = duplocale( m_previous );
+        m_locale = base ? newlocale( LC_NUMERIC_MASK, "C", base ) : (locale_t) 0;
+
+        if( m_locale )
+            uselocale( m_locale );
+        else if( base )
+            freelocale( base );
+    }
+
+    ~LOCALESWITCH()
+    {
+        if( m_locale )
+        {
+            uselocale( m_previous );
+            freelocale( m_locale );
+        }
     }
+#endif
 };
 
 
@@ -30,10 +30,14 @@
 
 #define PLUGIN_CLASS_3D "PLUGIN_3D"
 #define PLUGIN_3D_MAJOR 1
-#define PLUGIN_3D_MINOR 0
+#define PLUGIN_3D_MINOR 1
 #define PLUGIN_3D_PATCH 0
 #define PLUGIN_3D_REVISION 0
 
+// the plugins which are not thread safe may switch process wide state (e.g. the
+// locale): only one of them loads a model at a time
+static std::mutex s_unsafePluginLock;
+
 
 KICAD_PLUGIN_LDR_3D::KICAD_PLUGIN_LDR_3D()
 {
@@ -44,6 +48,7 @@ KICAD_PLUGIN_LDR_3D::KICAD_PLUGIN_LDR_3D()
     m_getFileFilter = NULL;
     m_canRender = NULL;
     m_load = NULL;
+    m_threadSafe = false;
 
     return;
 }
@@ -94,6 +99,14 @@ bool KICAD_PLUGIN_LDR_3D::Open( const wxString& aFullFileName )
     LINK_ITEM( m_canRender, PLUGIN_3D_CAN_RENDER, "CanRender" );
     LINK_ITEM( m_load, PLUGIN_3D_LOAD, "Load" );
 
+    // IsThreadSafe() is optional: the plugins which do not export it are not thread safe
+    if( m_PluginLoader.HasSymbol( wxT( "IsThreadSafe" ) ) )
+    {
+        PLUGIN_3D_IS_THREAD_SAFE isThreadSafe;
+        LINK_ITEM( isThreadSafe, PLUGIN_3D_IS_THREAD_SAFE, "IsThreadSafe" );
+        m_threadSafe = isThreadSafe && isThreadSafe();
+    }
+
     #ifdef DEBUG
         bool fail = false;
 
@@ -250,6 +263,7 @@ void KICAD_PLUGIN_LDR_3D::Close( void )
     m_getFileFilter = NULL;
     m_canRender = NULL;
     m_load = NULL;
+    m_threadSafe = false;
     close();
 
     return;
@@ -398,6 +412,8 @@ char const* KICAD_PLUGIN_LDR_3D::GetFileFilter( int aIndex )
 
 bool KICAD_PLUGIN_LDR_3D::CanRender( void )
 {
+    std::lock_guard<std::mutex> lock( m_lock );
+
     m_error.clear();
 
     if( !ok && !reopen() )
@@ -428,29 +444,44 @@ bool KICAD_PLUGIN_LDR_3D::CanRender( void )
 
 SCENEGRAPH* KICAD_PLUGIN_LDR_3D::Load( char const* aFileName )
 {
-    m_error.clear();
+    PLUGIN_3D_LOAD load;
+    bool threadSafe;
 
-    if( !ok && !reopen() )
     {
-        if( m_error.empty() )
-            m_error = "[INFO] no open plugin / plugin could not be opened";
+        std::lock_guard<std::mutex> lock( m_lock );
 
-        return NULL;
-    }
+        m_error.clear();
 
-    if( NULL == m_load )
-    {
-        m_error = "[BUG] Load is not linked";
+        if( !ok && !reopen() )
+        {
+            if( m_error.empty() )
+                m_error = "[INFO] no open plugin / plugin could not be opened";
 
-        #ifdef DEBUG
-        std::ostringstream ostr;
-        ostr << __FILE__ << ": " << __FUNCTION__ << ": " << __LINE__ << "\n";
-        ostr << " * " << m_error;
-        wxLogTrace( MASK_PLUGINLDR, "%s\n", ostr.str().c_str() );
-        #endif
+            return NULL;
+        }
 
-        return NULL;
+        if( NULL == m_load )
+        {
+            m_error = "[BUG] Load is not linked";
+
+            #ifdef DEBUG
+            std::ostringstream ostr;
+            ostr << __FILE__ << ": " << __FUNCTION__ << ": " << __LINE__ << "\n";
+            ostr << " * " << m_error;
+            wxLogTrace( MASK_PLUGINLDR, "%s\n", ostr.str().c_str() );
+            #endif
+
+            return NULL;
+        }
+
+        load = m_load;
+        threadSafe = m_threadSafe;
     }
 
-    return m_load( aFileName );
+    if( threadSafe )
+        return load( aFileName );
+
+    std::lock_guard<std::mutex> lock( s_unsafePluginLock );
+
+    return load( aFileName );
 }
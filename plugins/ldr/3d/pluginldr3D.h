@@ -30,6 +30,8 @@
 #ifndef PLUGINLDR3D_H
 #define PLUGINLDR3D_H
 
+#include <mutex>
+
 #include "../pluginldr.h"
 
 class SCENEGRAPH;
@@ -47,6 +49,8 @@ typedef bool (*PLUGIN_3D_CAN_RENDER) ( void );
 
 typedef SCENEGRAPH* (*PLUGIN_3D_LOAD) ( char const* aFileName );
 
+typedef bool (*PLUGIN_3D_IS_THREAD_SAFE) ( void );
+
 
 class KICAD_PLUGIN_LDR_3D : public KICAD_PLUGIN_LDR
 {
@@ -58,6 +62,9 @@ private:
     PLUGIN_3D_GET_FILE_FILTER       m_getFileFilter;
     PLUGIN_3D_CAN_RENDER            m_canRender;
     PLUGIN_3D_LOAD                  m_load;
+    bool m_threadSafe;  // set TRUE if the plugin's Load() may run in several threads at once
+    std::mutex m_lock;  // guards the state of the loader (error, reopening) in CanRender()
+                        // and Load(), which may be called by several threads
 
 public:
     KICAD_PLUGIN_LDR_3D();
@@ -84,6 +91,8 @@ public:
 
     bool CanRender( void );
 
+    // may be called by several threads at once; the plugins which are not thread
+    // safe (see IsThreadSafe() in 3d_plugin.h) still load one model at a time
     SCENEGRAPH* Load( char const* aFileName );
 };
 
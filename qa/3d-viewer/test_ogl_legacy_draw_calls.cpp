@@ -0,0 +1,182 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <unit_test_utils/headless_gl_context.h>
+
+#include <3d_rendering/3d_render_ogl_legacy/c_ogl_3dmodel.h>
+#include <3d_rendering/3d_render_ogl_legacy/c_ogl_buffer.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <memory>
+#include <vector>
+
+
+/**
+ * A model of two opaque meshes and a transparent one, each of them a triangle over the
+ * center of the view
+ */
+struct OGL_LEGACY_DRAW_CALLS_FIXTURE
+{
+    OGL_LEGACY_DRAW_CALLS_FIXTURE() :
+        m_gl( VIEW_SIZE ),
+        m_positions{ SFVEC3F( -0.5f, -0.5f, 0.0f ), SFVEC3F( 0.5f, -0.5f, 0.0f ),
+                     SFVEC3F( 0.0f, 0.5f, 0.0f ) },
+        m_normals( 3, SFVEC3F( 0.0f, 0.0f, 1.0f ) ),
+        m_colors( 3, SFVEC3F( 1.0f, 0.0f, 0.0f ) ),
+        m_faces{ 0, 1, 2 },
+        m_materials( 2 ),
+        m_meshes( 3 )
+    {
+        for( SMATERIAL& material : m_materials )
+        {
+            material.m_Ambient = SFVEC3F( 0.2f );
+            material.m_Diffuse = SFVEC3F( 1.0f, 0.0f, 0.0f );
+            material.m_Emissive = SFVEC3F( 0.0f );
+            material.m_Specular = SFVEC3F( 0.0f );
+            material.m_Shininess = 0.0f;
+            material.m_Transparency = 0.0f;
+        }
+
+        m_materials[1].m_Transparency = 0.5f;
+
+        for( size_t ii = 0; ii < m_meshes.size(); ++ii )
+        {
+            SMESH& mesh = m_meshes[ii];
+
+            mesh.m_VertexSize = m_positions.size();
+            mesh.m_Positions = m_positions.data();
+            mesh.m_Normals = m_normals.data();
+            mesh.m_Texcoords = nullptr;
+            mesh.m_Color = m_colors.data();
+            mesh.m_FaceIdxSize = m_faces.size();
+            mesh.m_FaceIdx = m_faces.data();
+            mesh.m_MaterialIdx = ( ii == 2 ) ? 1 : 0;
+        }
+
+        m_model.m_MeshesSize = m_meshes.size();
+        m_model.m_Meshes = m_meshes.data();
+        m_model.m_MaterialsSize = m_materials.size();
+        m_model.m_Materials = m_materials.data();
+
+        for( unsigned int ii = 0; ii < INSTANCES; ++ii )
+        {
+            float offset = 0.01f * ii;
+
+            m_transforms.push_back(
+                    glm::translate( glm::mat4( 1.0f ), glm::vec3( offset, offset, 0.0f ) ) );
+        }
+    }
+
+    /**
+     * Read the red level of the center of the view
+     */
+    static int centerRed()
+    {
+        GLubyte pixel[4] = { 0, 0, 0, 0 };
+
+        glReadPixels( VIEW_SIZE / 2, VIEW_SIZE / 2, 1, 1,
+                      GL_RGBA, GL_UNSIGNED_BYTE, pixel );
+
+        return pixel[0];
+    }
+
+    static const unsigned int OPAQUE_MESHES = 2;
+    static const unsigned int TRANSPARENT_MESHES = 1;
+    static const unsigned int INSTANCES = 10;
+    static const int          VIEW_SIZE = 64;
+
+    HEADLESS_GL_CONTEXT    m_gl;
+
+    std::vector<SFVEC3F>   m_positions;
+    std::vector<SFVEC3F>   m_normals;
+    std::vector<SFVEC3F>   m_colors;
+    std::vector<unsigned>  m_faces;
+    std::vector<SMATERIAL> m_materials;
+    std::vector<SMESH>     m_meshes;
+    S3DMODEL               m_model;
+
+    std::vector<glm::mat4> m_transforms;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( OglLegacyDrawCalls, OGL_LEGACY_DRAW_CALLS_FIXTURE )
+
+
+/**
+ * Instances of a model take a draw call per mesh and per instance, and nothing else: the
+ * buffers are bound and the materials set once per model
+ */
+BOOST_AUTO_TEST_CASE( ModelInstances )
+{
+    if( !m_gl.m_current )
+    {
+        BOOST_TEST_MESSAGE( "No headless openGL context (EGL pixel buffer), skipping" );
+        return;
+    }
+
+    BOOST_TEST_MESSAGE( "Renderer: " << glGetString( GL_RENDERER ) << ", "
+                        << glGetString( GL_VERSION ) );
+
+    glClearColor( 0.0f, 0.0f, 0.0f, 1.0f );
+    glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
+
+    std::unique_ptr<C_OGL_3DMODEL> model( new C_OGL_3DMODEL( m_model, MATERIAL_MODE_NORMAL ) );
+
+    BOOST_REQUIRE( model->Have_opaque() );
+    BOOST_REQUIRE( model->Have_transparent() );
+
+    C_OGL_BUFFER::ResetDrawCallCount();
+    model->Draw_opaque( m_transforms );
+
+    unsigned int opaqueCalls = C_OGL_BUFFER::GetDrawCallCount();
+
+    BOOST_CHECK_EQUAL( centerRed(), 255 );
+
+    C_OGL_BUFFER::ResetDrawCallCount();
+    model->Draw_transparent( m_transforms );
+
+    unsigned int transparentCalls = C_OGL_BUFFER::GetDrawCallCount();
+
+    C_OGL_BUFFER::ResetDrawCallCount();
+    model->Draw_opaque();
+    model->Draw_transparent();
+
+    unsigned int singleCalls = C_OGL_BUFFER::GetDrawCallCount();
+
+    BOOST_TEST_MESSAGE( ( GLEW_ARB_vertex_buffer_object ? "Buffer objects" : "Client side arrays" )
+                        << ", " << INSTANCES << " instances: " << opaqueCalls
+                        << " opaque draw calls, " << transparentCalls
+                        << " transparent draw calls; " << singleCalls
+                        << " draw calls for a single model" );
+
+    BOOST_CHECK_EQUAL( opaqueCalls, OPAQUE_MESHES * INSTANCES );
+    BOOST_CHECK_EQUAL( transparentCalls, TRANSPARENT_MESHES * INSTANCES );
+    BOOST_CHECK_EQUAL( singleCalls, OPAQUE_MESHES + TRANSPARENT_MESHES );
+    BOOST_CHECK_EQUAL( glGetError(), static_cast<GLenum>( GL_NO_ERROR ) );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
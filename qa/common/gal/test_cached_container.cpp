@@ -0,0 +1,287 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <gal/opengl/cached_container.h>
+#include <gal/opengl/vertex_item.h>
+#include <gal/opengl/vertex_manager.h>
+
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+using namespace KIGFX;
+
+
+/**
+ * A cached container storing its vertices in RAM, as CACHED_CONTAINER_RAM does, but without
+ * any GL buffer, and counting the vertices moved by defragmentations.
+ */
+class TEST_CACHED_CONTAINER : public CACHED_CONTAINER
+{
+public:
+    TEST_CACHED_CONTAINER( unsigned int aSize ) :
+        CACHED_CONTAINER( aSize ),
+        m_compactions( 0 ),
+        m_growths( 0 ),
+        m_defragmentedVertices( 0 )
+    {
+        m_vertices = static_cast<VERTEX*>( malloc( aSize * VERTEX_SIZE ) );
+    }
+
+    ~TEST_CACHED_CONTAINER()
+    {
+        free( m_vertices );
+    }
+
+    unsigned int GetBufferHandle() const override
+    {
+        return 0;
+    }
+
+    bool IsMapped() const override
+    {
+        return true;
+    }
+
+    void Map() override
+    {
+    }
+
+    void Unmap() override
+    {
+    }
+
+    ///> Number of defragmentations keeping the container size
+    int m_compactions;
+
+    ///> Number of defragmentations growing the container
+    int m_growths;
+
+    ///> Number of vertices copied by the defragmentations
+    long m_defragmentedVertices;
+
+protected:
+    bool defragmentResize( unsigned int aNewSize ) override
+    {
+        if( usedSpace() > aNewSize )
+            return false;
+
+        VERTEX* newBufferMem = static_cast<VERTEX*>( malloc( aNewSize * VERTEX_SIZE ) );
+
+        if( !newBufferMem )
+            return false;
+
+        defragment( newBufferMem );
+
+        free( m_vertices );
+        m_vertices = newBufferMem;
+
+        if( aNewSize == m_currentSize )
+            m_compactions++;
+        else
+            m_growths++;
+
+        m_defragmentedVertices += usedSpace();
+
+        m_freeSpace += ( aNewSize - m_currentSize );
+        m_currentSize = aNewSize;
+
+        m_freeChunks.clear();
+        m_freeChunks.insert( std::make_pair( m_freeSpace, m_currentSize - m_freeSpace ) );
+
+        return true;
+    }
+};
+
+
+struct CACHED_CONTAINER_FIXTURE
+{
+    CACHED_CONTAINER_FIXTURE() :
+        m_manager( false ),
+        m_container( 4096 ),
+        m_allocatedVertices( 0 ),
+        m_movedVertices( 0 )
+    {
+    }
+
+    ~CACHED_CONTAINER_FIXTURE()
+    {
+        // The items are owned by m_manager, but stored in m_container
+        for( std::unique_ptr<VERTEX_ITEM>& item : m_items )
+            m_container.Delete( item.get() );
+    }
+
+    /**
+     * Value stored in all the coordinates of the vertices of an item.  Each rebuild of an item
+     * gets another value, so that data of a previous version of the item are noticed.
+     */
+    static float marker( int aItem, int aVersion )
+    {
+        return aItem * 1000 + aVersion;
+    }
+
+    /**
+     * Store an item made of many small allocations, as the GAL does when caching a group
+     * of primitives
+     */
+    void addItem( int aIndex, int aVersion, int aPrimitives )
+    {
+        std::unique_ptr<VERTEX_ITEM>& item = m_items[aIndex];
+
+        if( item )
+            m_container.Delete( item.get() );
+
+        item.reset( new VERTEX_ITEM( m_manager ) );
+        m_container.SetItem( item.get() );
+
+        for( int ii = 0; ii < aPrimitives; ++ii )
+        {
+            // Triangles and quads, as for segments and circles
+            unsigned int size = ( ii % 2 ) ? 6 : 3;
+            unsigned int oldOffset = item->GetOffset();
+            unsigned int oldSize = item->GetSize();
+
+            VERTEX* vertices = m_container.Allocate( size );
+
+            BOOST_REQUIRE( vertices );
+
+            if( oldSize > 0 && item->GetOffset() != oldOffset )
+                m_movedVertices += oldSize;
+
+            for( unsigned int jj = 0; jj < size; ++jj )
+                vertices[jj].x = vertices[jj].y = marker( aIndex, aVersion );
+
+            m_allocatedVertices += size;
+        }
+
+        m_container.FinishItem();
+        m_versions[aIndex] = aVersion;
+    }
+
+    /**
+     * Check every item still finds its own vertices at its offset, and no two items overlap
+     */
+    void checkItems()
+    {
+        std::vector<bool> used( m_container.GetSize(), false );
+
+        for( size_t ii = 0; ii < m_items.size(); ++ii )
+        {
+            const VERTEX_ITEM* item = m_items[ii].get();
+
+            BOOST_REQUIRE( item );
+            BOOST_REQUIRE( item->GetOffset() + item->GetSize() <= m_container.GetSize() );
+
+            const VERTEX* vertices = m_container.GetVertices( item->GetOffset() );
+            float         expected = marker( ii, m_versions[ii] );
+            bool          ok = true;
+
+            for( unsigned int jj = 0; jj < item->GetSize(); ++jj )
+            {
+                ok = ok && vertices[jj].x == expected && vertices[jj].y == expected
+                     && !used[item->GetOffset() + jj];
+                used[item->GetOffset() + jj] = true;
+            }
+
+            BOOST_CHECK_MESSAGE( ok, "Item " << ii << " lost its vertices" );
+        }
+    }
+
+    VERTEX_MANAGER                            m_manager;
+    TEST_CACHED_CONTAINER                     m_container;
+    std::vector<std::unique_ptr<VERTEX_ITEM>> m_items;
+    std::vector<int>                          m_versions;
+    long                                      m_allocatedVertices;
+    long                                      m_movedVertices;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( CachedContainer, CACHED_CONTAINER_FIXTURE )
+
+
+/**
+ * Items built from many small allocations keep their data when the container grows
+ */
+BOOST_AUTO_TEST_CASE( GrowingItems )
+{
+    const int itemCount = 200;
+
+    m_items.resize( itemCount );
+    m_versions.resize( itemCount );
+
+    for( int ii = 0; ii < itemCount; ++ii )
+        addItem( ii, 0, 1 + ( ii * 37 ) % 500 );
+
+    checkItems();
+
+    BOOST_CHECK_GT( m_container.m_growths, 0 );
+}
+
+
+/**
+ * Rebuilding items over and over fragments the free space, which is compacted instead of
+ * growing the container, and growing items reserve room for their next primitives instead
+ * of moving at each allocation
+ */
+BOOST_AUTO_TEST_CASE( RebuiltItems )
+{
+    const int itemCount = 300;
+
+    m_items.resize( itemCount );
+    m_versions.resize( itemCount );
+
+    for( int ii = 0; ii < itemCount; ++ii )
+        addItem( ii, 0, 1 + ( ii * 37 ) % 100 );
+
+    checkItems();
+
+    unsigned int sizeAfterFirstRound = 0;
+
+    for( int round = 1; round <= 20; ++round )
+    {
+        // Rebuild every third item, with another number of primitives
+        for( int ii = round % 3; ii < itemCount; ii += 3 )
+            addItem( ii, round, 1 + ( ii * 37 + round * 11 ) % 100 );
+
+        checkItems();
+
+        if( round == 1 )
+            sizeAfterFirstRound = m_container.GetSize();
+    }
+
+    BOOST_TEST_MESSAGE( "Container of " << m_container.GetSize() << " vertices: "
+                        << m_container.m_growths << " growths, "
+                        << m_container.m_compactions << " compactions, "
+                        << m_container.m_defragmentedVertices << " vertices defragmented, "
+                        << m_movedVertices << " moved for growing items, "
+                        << m_allocatedVertices << " allocated" );
+
+    BOOST_CHECK_GT( m_container.m_compactions, 0 );
+    BOOST_CHECK_LT( m_movedVertices, 2 * m_allocatedVertices );
+    BOOST_CHECK_LE( m_container.GetSize(), 2 * sizeAfterFirstRound );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
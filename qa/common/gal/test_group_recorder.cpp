@@ -0,0 +1,295 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <gal/gal_display_options.h>
+#include <gal/opengl/noncached_container.h>
+#include <gal/opengl/vertex_gal.h>
+#include <gal/opengl/vertex_manager.h>
+
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace KIGFX;
+
+
+/**
+ * Draw the n-th of a set of shapes, covering the tessellated primitives (circles, arcs,
+ * polygons through the GLU tesselator, bitmap and stroke texts)
+ */
+static void drawShape( GAL& aGal, int aIndex )
+{
+    const VECTOR2D center( 1000.0 * aIndex, -500.0 * aIndex );
+
+    aGal.SetIsFill( aIndex % 2 == 0 );
+    aGal.SetIsStroke( true );
+    aGal.SetLineWidth( 10.0 + aIndex );
+    aGal.SetFillColor( COLOR4D( 0.1 * ( aIndex % 10 ), 0.5, 0.2, 1.0 ) );
+    aGal.SetStrokeColor( COLOR4D( 0.8, 0.1 * ( aIndex % 10 ), 0.3, 1.0 ) );
+
+    switch( aIndex % 7 )
+    {
+    case 0:
+        aGal.DrawCircle( center, 300.0 + aIndex );
+        break;
+
+    case 1:
+        aGal.DrawSegment( center, center + VECTOR2D( 2000.0, 700.0 ), 150.0 );
+        break;
+
+    case 2:
+        aGal.DrawArcSegment( center, 800.0, 0.1 * aIndex, 0.1 * aIndex + 2.0, 100.0 );
+        break;
+
+    case 3:
+        aGal.DrawArc( center, 600.0, -1.0, 1.5 );
+        break;
+
+    case 4:
+    {
+        // Concave, so that the tesselator is needed
+        std::deque<VECTOR2D> points = { center, center + VECTOR2D( 1000, 0 ),
+                                        center + VECTOR2D( 1000, 1000 ),
+                                        center + VECTOR2D( 500, 200 ),
+                                        center + VECTOR2D( 0, 1000 ) };
+        aGal.DrawPolygon( points );
+        break;
+    }
+
+    case 5:
+        aGal.SetGlyphSize( VECTOR2D( 500.0, 500.0 ) );
+        aGal.BitmapText( wxString::Format( "R%d", aIndex ), center, 0.0 );
+        break;
+
+    default:
+        aGal.SetGlyphSize( VECTOR2D( 500.0, 500.0 ) );
+        aGal.StrokeText( wxString::Format( "~U%d~", aIndex ), center, 0.3 );
+        break;
+    }
+}
+
+
+static std::vector<VERTEX> groupVertices( const GROUP_RECORDER& aRecorder, int aGroup )
+{
+    unsigned int  size;
+    const VERTEX* vertices = aRecorder.GetGroupVertices( aGroup, size );
+
+    return std::vector<VERTEX>( vertices, vertices + size );
+}
+
+
+static bool sameVertices( const std::vector<VERTEX>& aA, const std::vector<VERTEX>& aB )
+{
+    return aA.size() == aB.size()
+           && memcmp( aA.data(), aB.data(), aA.size() * VERTEX_SIZE ) == 0;
+}
+
+
+BOOST_AUTO_TEST_SUITE( GroupRecorder )
+
+
+/**
+ * Groups drawn by recorders in parallel threads are the groups drawn by a single recorder
+ */
+BOOST_AUTO_TEST_CASE( ParallelDrawing )
+{
+    const int shapeCount = 700;
+    const int threadCount = 4;
+
+    GAL_DISPLAY_OPTIONS options;
+    GROUP_RECORDER      reference( options );
+    std::vector<int>    referenceGroups;
+
+    reference.SetLayerDepth( 10.0 );
+
+    for( int ii = 0; ii < shapeCount; ++ii )
+    {
+        referenceGroups.push_back( reference.BeginGroup() );
+        drawShape( reference, ii );
+        reference.EndGroup();
+    }
+
+    std::vector<std::unique_ptr<GROUP_RECORDER>> recorders;
+    std::vector<std::vector<int>>                groups( threadCount );
+    std::vector<std::thread>                     threads;
+
+    for( int ii = 0; ii < threadCount; ++ii )
+    {
+        recorders.emplace_back( new GROUP_RECORDER( options ) );
+        recorders.back()->CopyViewSettings( reference );
+        recorders.back()->SetLayerDepth( 10.0 );
+    }
+
+    for( int tt = 0; tt < threadCount; ++tt )
+    {
+        threads.emplace_back( [&, tt]()
+        {
+            for( int ii = tt; ii < shapeCount; ii += threadCount )
+            {
+                groups[tt].push_back( recorders[tt]->BeginGroup() );
+                drawShape( *recorders[tt], ii );
+                recorders[tt]->EndGroup();
+            }
+        } );
+    }
+
+    for( std::thread& thread : threads )
+        thread.join();
+
+    for( int ii = 0; ii < shapeCount; ++ii )
+    {
+        BOOST_TEST_CONTEXT( "Shape " << ii )
+        {
+            std::vector<VERTEX> expected = groupVertices( reference, referenceGroups[ii] );
+            std::vector<VERTEX> recorded = groupVertices( *recorders[ii % threadCount],
+                                                          groups[ii % threadCount][ii / threadCount] );
+
+            BOOST_CHECK( !expected.empty() );
+            BOOST_CHECK( sameVertices( recorded, expected ) );
+        }
+    }
+}
+
+
+/**
+ * The vertices of a group are copied unchanged, whatever the state of the target manager
+ */
+BOOST_AUTO_TEST_CASE( CopyVertices )
+{
+    GAL_DISPLAY_OPTIONS options;
+    GROUP_RECORDER      recorder( options );
+
+    int group = recorder.BeginGroup();
+    drawShape( recorder, 0 );
+    recorder.EndGroup();
+
+    std::vector<VERTEX> expected = groupVertices( recorder, group );
+
+    // A container much smaller than the group, which has to grow more than twice
+    NONCACHED_CONTAINER* container = new NONCACHED_CONTAINER( 16 );
+    VERTEX_MANAGER       manager( container );
+
+    BOOST_REQUIRE( expected.size() > 64 );
+
+    manager.Color( 0.5, 0.5, 0.5, 1.0 );
+    manager.Translate( 100.0, 100.0, 0.0 );
+    BOOST_CHECK( manager.CopyVertices( expected.data(), expected.size() ) );
+
+    std::vector<VERTEX> copied( container->GetAllVertices(),
+                                container->GetAllVertices() + container->GetSize() );
+
+    BOOST_CHECK( sameVertices( copied, expected ) );
+}
+
+
+/**
+ * Clearing a recorder frees its groups and gives it an empty container
+ */
+BOOST_AUTO_TEST_CASE( ClearCache )
+{
+    GAL_DISPLAY_OPTIONS options;
+    GROUP_RECORDER      recorder( options );
+
+    for( int ii = 0; ii < 100; ++ii )
+    {
+        recorder.BeginGroup();
+        drawShape( recorder, ii );
+        recorder.EndGroup();
+    }
+
+    recorder.ClearCache();
+
+    int group = recorder.BeginGroup();
+    recorder.EndGroup();
+
+    BOOST_CHECK_EQUAL( group, 0 );
+    BOOST_CHECK( groupVertices( recorder, group ).empty() );
+}
+
+
+/**
+ * With instancing, circles, segments and arcs are a record each, stored after the other
+ * vertices of their group
+ */
+BOOST_AUTO_TEST_CASE( InstanceRecords )
+{
+    GAL_DISPLAY_OPTIONS options;
+    GROUP_RECORDER      recorder( options );
+    const VECTOR2D      center( 1000.0, -500.0 );
+
+    recorder.EnableInstancing( true );
+    recorder.SetLayerDepth( 10.0 );
+    recorder.SetIsFill( true );
+    recorder.SetIsStroke( true );
+    recorder.SetLineWidth( 10.0 );
+
+    // Filled and stroked: two records
+    int circle = recorder.BeginGroup();
+    recorder.DrawCircle( center, 300.0 );
+    recorder.EndGroup();
+
+    recorder.SetIsStroke( false );
+
+    int segment = recorder.BeginGroup();
+    recorder.DrawSegment( center, center + VECTOR2D( 2000.0, 700.0 ), 150.0 );
+    recorder.EndGroup();
+
+    int arc = recorder.BeginGroup();
+    recorder.DrawArcSegment( center, 800.0, 0.2, 2.2, 100.0 );
+    recorder.EndGroup();
+
+    // Triangles only
+    int polygon = recorder.BeginGroup();
+    recorder.DrawPolygon( std::deque<VECTOR2D>{ center, center + VECTOR2D( 1000, 0 ),
+                                                center + VECTOR2D( 1000, 1000 ) } );
+    recorder.EndGroup();
+
+    BOOST_CHECK_EQUAL( groupVertices( recorder, circle ).size(), 2u );
+    BOOST_CHECK_EQUAL( recorder.GetGroupInstanceCount( circle ), 2u );
+    BOOST_CHECK_EQUAL( groupVertices( recorder, segment ).size(), 1u );
+    BOOST_CHECK_EQUAL( recorder.GetGroupInstanceCount( segment ), 1u );
+    BOOST_CHECK_EQUAL( recorder.GetGroupInstanceCount( polygon ), 0u );
+    BOOST_CHECK_EQUAL( groupVertices( recorder, polygon ).size(), 3u );
+
+    std::vector<VERTEX> arcVertices = groupVertices( recorder, arc );
+
+    BOOST_REQUIRE_EQUAL( arcVertices.size(), 1u );
+    BOOST_CHECK_EQUAL( recorder.GetGroupInstanceCount( arc ), 1u );
+    BOOST_CHECK_LT( arcVertices[0].shader[0], SHADER_INSTANCE_ARC );
+
+    // Clearing the cache keeps the recorder drawing records
+    recorder.ClearCache();
+
+    circle = recorder.BeginGroup();
+    recorder.DrawCircle( center, 300.0 );
+    recorder.EndGroup();
+
+    BOOST_CHECK_EQUAL( recorder.GetGroupInstanceCount( circle ), 1u );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
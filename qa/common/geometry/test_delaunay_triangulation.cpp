@@ -0,0 +1,204 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <set>
+
+#include <geometry/delaunay_triangulation.h>
+
+
+static double distance( const VECTOR2I& aA, const VECTOR2I& aB )
+{
+    return ( aA - aB ).EuclideanNorm();
+}
+
+
+static int findRoot( std::vector<int>& aParent, int aVal )
+{
+    while( aParent[aVal] != aVal )
+        aVal = aParent[aVal] = aParent[aParent[aVal]];
+
+    return aVal;
+}
+
+
+/**
+ * The length of the minimum spanning tree of the points made of the given edges
+ * (Kruskal), or -1 if they do not connect all the points.
+ */
+static double spanningTreeLength( const std::vector<VECTOR2I>&         aPoints,
+                                  std::vector<std::pair<int, int>> aEdges )
+{
+    std::sort( aEdges.begin(), aEdges.end(),
+               [&]( const std::pair<int, int>& a, const std::pair<int, int>& b )
+               {
+                   return distance( aPoints[a.first], aPoints[a.second] )
+                          < distance( aPoints[b.first], aPoints[b.second] );
+               } );
+
+    std::vector<int> parent( aPoints.size() );
+    std::iota( parent.begin(), parent.end(), 0 );
+
+    double length = 0.0;
+    size_t count = 0;
+
+    for( const auto& e : aEdges )
+    {
+        int a = findRoot( parent, e.first );
+        int b = findRoot( parent, e.second );
+
+        if( a != b )
+        {
+            parent[a] = b;
+            length += distance( aPoints[e.first], aPoints[e.second] );
+            count++;
+        }
+    }
+
+    return count + 1 == aPoints.size() ? length : -1.0;
+}
+
+
+/**
+ * The complete graph of the points, which contains all the minimum spanning trees
+ */
+static std::vector<std::pair<int, int>> allEdges( const std::vector<VECTOR2I>& aPoints )
+{
+    std::vector<std::pair<int, int>> edges;
+
+    for( int ii = 0; ii < (int) aPoints.size(); ++ii )
+    {
+        for( int jj = ii + 1; jj < (int) aPoints.size(); ++jj )
+            edges.emplace_back( ii, jj );
+    }
+
+    return edges;
+}
+
+
+/**
+ * Distinct random points, on a coarse grid (as pads and tracks are) or anywhere
+ */
+static std::vector<VECTOR2I> randomPoints( std::mt19937& aRng, int aCount, int aGrid, int aSteps )
+{
+    std::set<std::pair<int, int>> unique;
+    std::vector<VECTOR2I>         points;
+
+    while( (int) points.size() < aCount )
+    {
+        int x = ( aRng() % aSteps ) * aGrid;
+        int y = ( aRng() % aSteps ) * aGrid;
+
+        if( unique.insert( { x, y } ).second )
+            points.emplace_back( x, y );
+    }
+
+    return points;
+}
+
+
+BOOST_AUTO_TEST_SUITE( DelaunayTriangulation )
+
+
+BOOST_AUTO_TEST_CASE( Degenerate )
+{
+    DELAUNAY_TRIANGULATION triangulation;
+
+    std::vector<VECTOR2I> two = { { 0, 0 }, { 10, 0 } };
+    BOOST_CHECK( !triangulation.Triangulate( two ) );
+
+    std::vector<VECTOR2I> colinear = { { 0, 0 }, { 30, 30 }, { 10, 10 }, { -20, -20 } };
+    BOOST_CHECK( !triangulation.Triangulate( colinear ) );
+    BOOST_CHECK( triangulation.GetTriangles().empty() );
+
+    std::vector<VECTOR2I> triangle = { { 0, 0 }, { 10, 0 }, { 0, 10 } };
+    std::vector<std::pair<int, int>> edges;
+
+    BOOST_REQUIRE( triangulation.Triangulate( triangle ) );
+    BOOST_CHECK_EQUAL( triangulation.GetTriangles().size(), 3u );
+
+    triangulation.GetEdges( edges );
+    BOOST_CHECK_EQUAL( edges.size(), 3u );
+}
+
+
+/**
+ * A square grid has many co-circular points: any triangulation of it is a Delaunay one
+ */
+BOOST_AUTO_TEST_CASE( Grid )
+{
+    std::vector<VECTOR2I> points;
+
+    for( int x = 0; x < 10; ++x )
+    {
+        for( int y = 0; y < 10; ++y )
+            points.emplace_back( x * 1270000, y * 1270000 );
+    }
+
+    DELAUNAY_TRIANGULATION triangulation;
+    BOOST_REQUIRE( triangulation.Triangulate( points ) );
+
+    // 2n - 2 - h triangles, h being the number of points on the hull
+    BOOST_CHECK_EQUAL( triangulation.GetTriangles().size(), 3u * ( 2 * 100 - 2 - 36 ) );
+
+    std::vector<std::pair<int, int>> edges;
+    triangulation.GetEdges( edges );
+
+    BOOST_CHECK_CLOSE( spanningTreeLength( points, edges ), 99 * 1270000.0, 1e-9 );
+}
+
+
+/**
+ * The edges of the triangulation contain a minimum spanning tree of the points
+ */
+BOOST_AUTO_TEST_CASE( MinimumSpanningTree )
+{
+    std::mt19937           rng( 42 );
+    DELAUNAY_TRIANGULATION triangulation;
+
+    for( int ii = 0; ii < 300; ++ii )
+    {
+        BOOST_TEST_CONTEXT( "Set " << ii )
+        {
+            std::vector<VECTOR2I> points = ( ii % 2 ) ?
+                    randomPoints( rng, 3 + rng() % 150, 254000, 20 ) :
+                    randomPoints( rng, 3 + rng() % 150, 1, 1000000000 );
+
+            std::vector<std::pair<int, int>> edges;
+
+            BOOST_REQUIRE( triangulation.Triangulate( points ) );
+            triangulation.GetEdges( edges );
+
+            BOOST_CHECK_CLOSE( spanningTreeLength( points, edges ),
+                               spanningTreeLength( points, allEdges( points ) ), 1e-9 );
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,413 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <climits>
+#include <cmath>
+#include <random>
+
+#include <geometry/shape_line_chain.h>
+#include <geometry/shape_poly_set.h>
+
+#include <profile.h>
+
+
+/**
+ * Reference implementations of the SHAPE_POLY_SET queries, scanning all the edges, to
+ * check the answers of the edge index against.
+ */
+static bool refContains( const SHAPE_POLY_SET& aSet, const VECTOR2I& aP )
+{
+    for( int ii = 0; ii < aSet.OutlineCount(); ++ii )
+    {
+        if( !aSet.COutline( ii ).PointInside( aP ) )
+            continue;
+
+        bool inHole = false;
+
+        for( int jj = 0; jj < aSet.HoleCount( ii ); ++jj )
+        {
+            const SHAPE_LINE_CHAIN& hole = aSet.CHole( ii, jj );
+
+            if( hole.PointInside( aP ) && !hole.PointOnEdge( aP ) )
+                inHole = true;
+        }
+
+        if( !inHole )
+            return true;
+    }
+
+    return false;
+}
+
+
+static bool refPointOnEdge( const SHAPE_POLY_SET& aSet, const VECTOR2I& aP )
+{
+    for( int ii = 0; ii < aSet.OutlineCount(); ++ii )
+    {
+        for( const SHAPE_LINE_CHAIN& contour : aSet.CPolygon( ii ) )
+        {
+            if( contour.PointOnEdge( aP ) )
+                return true;
+        }
+    }
+
+    return false;
+}
+
+
+template <typename T>
+static int refEdgeDistance( const SHAPE_POLY_SET& aSet, const T& aObject )
+{
+    int minDistance = INT_MAX;
+
+    for( auto it = aSet.CIterateSegmentsWithHoles(); it; it++ )
+        minDistance = std::min( minDistance, ( *it ).Distance( aObject ) );
+
+    return minDistance;
+}
+
+
+static bool refIntersects( const SHAPE_POLY_SET& aSet, const SEG& aSeg )
+{
+    for( auto it = aSet.CIterateSegmentsWithHoles(); it; it++ )
+    {
+        if( ( *it ).Intersect( aSeg, true ) )
+            return true;
+    }
+
+    return false;
+}
+
+
+static SHAPE_LINE_CHAIN buildCircle( const VECTOR2I& aCenter, int aRadius, int aSegments )
+{
+    SHAPE_LINE_CHAIN circle;
+
+    for( int ii = 0; ii < aSegments; ++ii )
+    {
+        double angle = 2.0 * M_PI * ii / aSegments;
+
+        circle.Append( aCenter.x + (int) std::lround( aRadius * cos( angle ) ),
+                       aCenter.y + (int) std::lround( aRadius * sin( angle ) ) );
+    }
+
+    circle.SetClosed( true );
+    return circle;
+}
+
+
+static SHAPE_LINE_CHAIN buildRect( const VECTOR2I& aStart, const VECTOR2I& aEnd )
+{
+    SHAPE_LINE_CHAIN rect;
+
+    rect.Append( aStart.x, aStart.y );
+    rect.Append( aEnd.x, aStart.y );
+    rect.Append( aEnd.x, aEnd.y );
+    rect.Append( aStart.x, aEnd.y );
+    rect.SetClosed( true );
+
+    return rect;
+}
+
+
+/**
+ * A zone fill like polygon set: a 100 x 80 mm copper area, around the clearance holes of
+ * a grid of round pads and of some diagonal tracks (1 unit = 1 nm), with an island in one
+ * of the holes.  Its edge index is enabled.
+ */
+static SHAPE_POLY_SET buildZoneFill( bool aFracture )
+{
+    const int      mm = 1000000;
+    SHAPE_POLY_SET fill;
+    SHAPE_POLY_SET clearances;
+
+    fill.AddOutline( buildRect( { 0, 0 }, { 100 * mm, 80 * mm } ) );
+
+    for( int x = 5; x < 100; x += 5 )
+    {
+        for( int y = 5; y < 80; y += 5 )
+            clearances.AddOutline( buildCircle( { x * mm, y * mm }, 1 * mm, 32 ) );
+    }
+
+    for( int ii = 0; ii < 20; ++ii )
+    {
+        SHAPE_LINE_CHAIN track;
+        int              x = ii * 4 * mm + mm;
+
+        track.Append( x, 2 * mm );
+        track.Append( x + 17 * mm, 2 * mm + 17 * mm );
+        track.Append( x + 17 * mm + 400000, 2 * mm + 17 * mm - 400000 );
+        track.Append( x + 400000, 2 * mm - 400000 );
+        track.SetClosed( true );
+        clearances.AddOutline( track );
+    }
+
+    fill.BooleanSubtract( clearances, SHAPE_POLY_SET::PM_FAST );
+    fill.AddOutline( buildCircle( { 50 * mm, 40 * mm }, 600000, 16 ) );
+
+    if( aFracture )
+        fill.Fracture( SHAPE_POLY_SET::PM_FAST );
+
+    fill.EnableEdgeIndex();
+
+    return fill;
+}
+
+
+/**
+ * Points around the set: random ones, the vertices, the middles of the edges and points
+ * next to them.
+ */
+static std::vector<VECTOR2I> buildQueryPoints( const SHAPE_POLY_SET& aSet, size_t aRandomCount )
+{
+    std::vector<VECTOR2I> points;
+    std::mt19937          rng( 42 );
+    BOX2I                 bbox = aSet.BBox( 1000000 );
+
+    std::uniform_int_distribution<int> xDist( bbox.GetX(), bbox.GetRight() );
+    std::uniform_int_distribution<int> yDist( bbox.GetY(), bbox.GetBottom() );
+
+    for( size_t ii = 0; ii < aRandomCount; ++ii )
+        points.emplace_back( xDist( rng ), yDist( rng ) );
+
+    int edge = 0;
+
+    for( auto it = aSet.CIterateSegmentsWithHoles(); it; it++, edge++ )
+    {
+        if( edge % 7 )
+            continue;
+
+        SEG seg = *it;
+
+        points.push_back( seg.A );
+        points.push_back( seg.A + VECTOR2I( 1, 1 ) );
+        points.push_back( ( seg.A + seg.B ) / 2 );
+        points.push_back( ( seg.A + seg.B ) / 2 + VECTOR2I( 0, 2 ) );
+    }
+
+    return points;
+}
+
+
+BOOST_AUTO_TEST_SUITE( SPSEdgeIndex )
+
+
+/**
+ * Check the indexed queries give the same answers as the linear scans, on a fill with holes
+ * and on the same fill fractured
+ */
+BOOST_AUTO_TEST_CASE( MatchesLinearScan )
+{
+    for( bool fracture : { false, true } )
+    {
+        BOOST_TEST_CONTEXT( ( fracture ? "Fractured" : "With holes" ) )
+        {
+            const SHAPE_POLY_SET  fill = buildZoneFill( fracture );
+            std::vector<VECTOR2I> points = buildQueryPoints( fill, 2000 );
+
+            // Collide() with a clearance tests against the set inflated by the clearance
+            SHAPE_POLY_SET pointClearanceFill( fill );
+            SHAPE_POLY_SET segClearanceFill( fill );
+
+            pointClearanceFill.Inflate( 250000, 8 );
+            segClearanceFill.Inflate( 100000, 8 );
+
+            for( const VECTOR2I& p : points )
+            {
+                BOOST_TEST_CONTEXT( "Point " << p.x << ", " << p.y )
+                {
+                    BOOST_CHECK_EQUAL( fill.Contains( p ), refContains( fill, p ) );
+                    BOOST_CHECK_EQUAL( fill.PointOnEdge( p ), refPointOnEdge( fill, p ) );
+                    BOOST_CHECK_EQUAL( fill.Distance( p ),
+                                       refContains( fill, p ) ? 0 : refEdgeDistance( fill, p ) );
+                    BOOST_CHECK_EQUAL( fill.Collide( p, 250000 ),
+                                       refContains( pointClearanceFill, p ) );
+                }
+            }
+
+            for( size_t ii = 0; ii + 1 < points.size(); ii += 2 )
+            {
+                SEG seg( points[ii], points[ii + 1] );
+                int dist = refContains( fill, seg.A ) ? 0 : refEdgeDistance( fill, seg );
+
+                BOOST_TEST_CONTEXT( "Segment " << seg.A.x << ", " << seg.A.y << " - "
+                                               << seg.B.x << ", " << seg.B.y )
+                {
+                    BOOST_CHECK_EQUAL( fill.Distance( seg, 200000 ),
+                                       std::max( 0, dist - 100000 ) );
+                    BOOST_CHECK_EQUAL( fill.Collide( seg ),
+                                       refContains( fill, seg.A ) || refIntersects( fill, seg ) );
+                    BOOST_CHECK_EQUAL( fill.Collide( seg, 100000 ),
+                                       refContains( segClearanceFill, seg.A )
+                                               || refIntersects( segClearanceFill, seg ) );
+                }
+            }
+        }
+    }
+}
+
+
+/**
+ * Check the index does not outlive a change of the set
+ */
+BOOST_AUTO_TEST_CASE( DroppedOnChange )
+{
+    SHAPE_POLY_SET fill = buildZoneFill( true );
+    const VECTOR2I inside( 2500000, 2500000 );
+    const VECTOR2I offset( 1000000, 0 );
+
+    for( int ii = 0; ii < 10; ++ii )
+        BOOST_CHECK( fill.Contains( inside ) );
+
+    fill.Move( offset );
+
+    BOOST_CHECK( !fill.Contains( inside ) );
+    BOOST_CHECK( fill.Contains( inside + offset ) );
+
+    for( int ii = 0; ii < 10; ++ii )
+        fill.Contains( inside );
+
+    // Through a non-const reference to an outline
+    fill.Outline( 0 ).Move( VECTOR2I( -offset.x, -offset.y ) );
+
+    BOOST_CHECK_EQUAL( fill.Contains( inside ), refContains( fill, inside ) );
+    BOOST_CHECK_EQUAL( fill.Contains( inside + offset ), refContains( fill, inside + offset ) );
+}
+
+
+/**
+ * Check Collide() with a clearance gives the results of the set inflated with 8 segments per
+ * circle, with and without the index: a point closer to a corner than the clearance does not
+ * collide if it is between two vertices of the arc of the inflated set
+ */
+BOOST_AUTO_TEST_CASE( CollideMatchesInflate )
+{
+    const int      mm = 1000000;
+    const int      clearance = 1 * mm;
+    SHAPE_POLY_SET set;
+
+    set.AddOutline( buildRect( { 0, 0 }, { 10 * mm, 10 * mm } ) );
+    set.AddHole( buildRect( { 3 * mm, 3 * mm }, { 7 * mm, 7 * mm } ) );
+    set.AddOutline( buildCircle( { 20 * mm, 5 * mm }, 3 * mm, 64 ) );
+
+    SHAPE_POLY_SET inflated( set );
+
+    inflated.Inflate( clearance, 8 );
+
+    auto polar = []( double aDist, double aAngle )
+    {
+        return VECTOR2I( (int) std::lround( aDist * cos( aAngle ) ),
+                         (int) std::lround( aDist * sin( aAngle ) ) );
+    };
+
+    // Points around the corners of the square, of its hole and of the circle, from inside
+    // the clearance to outside of it
+    std::vector<VECTOR2I> points;
+
+    for( auto it = set.CIterateWithHoles(); it; it++ )
+    {
+        for( double dist : { 0.9, 0.95, 0.98, 1.0, 1.02 } )
+        {
+            for( int angle = 0; angle < 360; angle += 15 )
+                points.push_back( *it + polar( dist * clearance, angle * M_PI / 180.0 ) );
+        }
+    }
+
+    for( bool indexed : { false, true } )
+    {
+        BOOST_TEST_CONTEXT( ( indexed ? "Indexed" : "Not indexed" ) )
+        {
+            SHAPE_POLY_SET tested( set );
+
+            tested.EnableEdgeIndex( indexed );
+
+            for( const VECTOR2I& p : points )
+            {
+                BOOST_TEST_CONTEXT( "Point " << p.x << ", " << p.y )
+                {
+                    BOOST_CHECK_EQUAL( tested.Collide( p, clearance ), inflated.Contains( p ) );
+                }
+            }
+
+            for( size_t ii = 0; ii + 1 < points.size(); ++ii )
+            {
+                SEG seg( points[ii], points[ii + 1] );
+
+                BOOST_TEST_CONTEXT( "Segment " << seg.A.x << ", " << seg.A.y << " - "
+                                               << seg.B.x << ", " << seg.B.y )
+                {
+                    BOOST_CHECK_EQUAL( tested.Collide( seg, clearance ), inflated.Collide( seg ) );
+                }
+            }
+        }
+    }
+
+    // The arc around a corner has vertices every 45 degrees, its chords cut the corner
+    const VECTOR2I corner( 10 * mm, 10 * mm );
+
+    BOOST_CHECK( set.Collide( corner + polar( 0.95 * clearance, M_PI / 4 ), clearance ) );
+    BOOST_CHECK( !set.Collide( corner + polar( 0.95 * clearance, M_PI / 8 ), clearance ) );
+}
+
+
+/**
+ * Compare the time taken by the indexed queries and by the linear scans on a zone fill.
+ * Timings are only reported, as they depend on the machine.
+ */
+BOOST_AUTO_TEST_CASE( Benchmark )
+{
+    for( bool fracture : { false, true } )
+    {
+        const SHAPE_POLY_SET  fill = buildZoneFill( fracture );
+        std::vector<VECTOR2I> points = buildQueryPoints( fill, 20000 );
+
+        int64_t linearCount = 0;
+        int64_t indexedCount = 0;
+
+        PROF_COUNTER linear;
+
+        for( const VECTOR2I& p : points )
+            linearCount += refContains( fill, p ) ? 0 : refEdgeDistance( fill, p );
+
+        linear.Stop();
+
+        PROF_COUNTER indexed;
+
+        for( const VECTOR2I& p : points )
+            indexedCount += fill.Distance( p );
+
+        indexed.Stop();
+
+        BOOST_CHECK_EQUAL( indexedCount, linearCount );
+
+        BOOST_TEST_MESSAGE( ( fracture ? "Fractured" : "With holes" )
+                            << " fill, " << fill.TotalVertices() << " vertices, "
+                            << points.size() << " Contains + Distance queries: linear scan "
+                            << linear.msecs() << " ms, indexed " << indexed.msecs() << " ms" );
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
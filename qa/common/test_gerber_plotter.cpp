@@ -0,0 +1,145 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/plotting.h>
+
+#include <functional>
+
+// Code under test
+#include <common.h>
+#include <convert_to_biu.h>
+#include <plotter.h>
+
+using KI_TEST::CountOf;
+
+
+struct GERBER_PLOTTER_FIXTURE : KI_TEST::TEMP_FILE_PLOTTER_FIXTURE
+{
+    GERBER_PLOTTER_FIXTURE() : TEMP_FILE_PLOTTER_FIXTURE( wxT( "qa_gerber" ) )
+    {
+    }
+
+    /**
+     * Plot a Gerber file with aPlot, and return its text
+     */
+    std::string plot( const std::function<void( GERBER_PLOTTER& )>& aPlot )
+    {
+        LOCALE_IO      toggle;
+        GERBER_PLOTTER plotter;
+
+        plotter.SetViewport( wxPoint( 0, 0 ), IU_PER_MILS / 10, 1.0, false );
+        plotter.SetGerberCoordinatesFormat( 5 );
+
+        StartPlot( plotter );
+        aPlot( plotter );
+
+        return EndPlot( plotter );
+    }
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( GerberPlotter, GERBER_PLOTTER_FIXTURE )
+
+
+/**
+ * Each distinct aperture is defined once, with D codes allocated in sequence
+ */
+BOOST_AUTO_TEST_CASE( ApertureList )
+{
+    const int count = 500;
+
+    std::string text = plot( [&]( GERBER_PLOTTER& aPlotter )
+            {
+                for( int pass = 0; pass < 2; pass++ )
+                {
+                    for( int ii = 0; ii < count; ii++ )
+                    {
+                        aPlotter.FlashPadCircle( wxPoint( ii * 1000, 0 ), 1000 + ii * 10,
+                                                 FILLED, nullptr );
+                    }
+                }
+            } );
+
+    BOOST_CHECK_EQUAL( CountOf( text, "%ADD" ), count );
+    BOOST_CHECK_EQUAL( CountOf( text, "%ADD10C," ), 1 );
+    BOOST_CHECK_EQUAL( CountOf( text, "%ADD509C," ), 1 );
+    BOOST_CHECK_EQUAL( CountOf( text, "D03*" ), count * 2 );
+}
+
+
+/**
+ * Rotated rects are flashed with a macro aperture, shared by the pads with the same shape
+ */
+BOOST_AUTO_TEST_CASE( RotatedRect )
+{
+    std::string text = plot( []( GERBER_PLOTTER& aPlotter )
+            {
+                const wxSize size( 2 * IU_PER_MM, 1 * IU_PER_MM );
+
+                aPlotter.FlashPadRect( wxPoint( 0, 0 ), size, 300, FILLED, nullptr );
+                aPlotter.FlashPadRect( wxPoint( 0, 10000 ), size, 300, FILLED, nullptr );
+                aPlotter.FlashPadRect( wxPoint( 0, 20000 ), size, 2100, FILLED, nullptr );
+                aPlotter.FlashPadRect( wxPoint( 0, 30000 ), size, -450, FILLED, nullptr );
+
+                // Not rotated: a standard aperture
+                aPlotter.FlashPadRect( wxPoint( 0, 40000 ), size, 0, FILLED, nullptr );
+            } );
+
+    BOOST_CHECK_EQUAL( CountOf( text, "%AMRotRect*" ), 1 );
+    BOOST_CHECK_EQUAL( CountOf( text, "RotRect,2.000000X1.000000X30.000000*%" ), 1 );
+    BOOST_CHECK_EQUAL( CountOf( text, "RotRect,2.000000X1.000000X135.000000*%" ), 1 );
+    BOOST_CHECK_EQUAL( CountOf( text, "R,2.000000X1.000000*%" ), 1 );
+    BOOST_CHECK_EQUAL( CountOf( text, "D03*" ), 5 );
+    BOOST_CHECK_EQUAL( CountOf( text, "G36*" ), 0 );
+}
+
+
+/**
+ * Roundrects are flashed with a macro aperture, in any orientation
+ */
+BOOST_AUTO_TEST_CASE( RoundRect )
+{
+    std::string text = plot( []( GERBER_PLOTTER& aPlotter )
+            {
+                const wxSize size( 2 * IU_PER_MM, 1 * IU_PER_MM );
+                const int    radius = 0.25 * IU_PER_MM;
+
+                aPlotter.FlashPadRoundRect( wxPoint( 0, 0 ), size, radius, 0, FILLED, nullptr );
+                aPlotter.FlashPadRoundRect( wxPoint( 0, 10000 ), size, radius, 1800, FILLED,
+                                            nullptr );
+                aPlotter.FlashPadRoundRect( wxPoint( 0, 20000 ), size, radius, 900, FILLED,
+                                            nullptr );
+            } );
+
+    BOOST_CHECK_EQUAL( CountOf( text, "%AMRoundRect*" ), 1 );
+    BOOST_CHECK_EQUAL( CountOf( text, "RoundRect,2.000000X0.500000X1.500000X1.000000X0.500000"
+                                      "X0.750000X-0.750000X0.250000X-0.250000X0.000000*%" ),
+                       1 );
+    BOOST_CHECK_EQUAL( CountOf( text, "X0.250000X-0.250000X90.000000*%" ), 1 );
+    BOOST_CHECK_EQUAL( CountOf( text, "D03*" ), 3 );
+    BOOST_CHECK_EQUAL( CountOf( text, "%AMRotRect*" ), 0 );
+    BOOST_CHECK_EQUAL( CountOf( text, "G36*" ), 0 );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
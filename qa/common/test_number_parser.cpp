@@ -0,0 +1,190 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the locale independent number parser, and the zero copy MEMORY_LINE_READER
+ * it is used with
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <cerrno>
+#include <cstring>
+#include <random>
+
+// Code under test
+#include <number_parser.h>
+#include <richio.h>
+
+
+BOOST_AUTO_TEST_SUITE( NumberParser )
+
+
+/**
+ * Check StrToDouble() and StrToLong() give the value, end and errno strtod() and strtol()
+ * give in the "C" locale
+ */
+static void checkLikeStrtod( const char* aText )
+{
+    BOOST_TEST_CONTEXT( "\"" << aText << "\"" )
+    {
+        char*       expectedEnd;
+        const char* end;
+
+        errno = 0;
+        double expected = strtod( aText, &expectedEnd );
+        int expectedErrno = errno;
+
+        errno = 0;
+        double value = StrToDouble( aText, &end );
+
+        if( expected == expected )
+            BOOST_CHECK_EQUAL( memcmp( &value, &expected, sizeof( double ) ), 0 );
+        else
+            BOOST_CHECK( value != value );
+
+        BOOST_CHECK_EQUAL( end - aText, expectedEnd - aText );
+        BOOST_CHECK_EQUAL( errno, expectedErrno );
+
+        errno = 0;
+        long expectedLong = strtol( aText, &expectedEnd, 10 );
+        expectedErrno = errno;
+
+        errno = 0;
+        BOOST_CHECK_EQUAL( StrToLong( aText, &end ), expectedLong );
+        BOOST_CHECK_EQUAL( end - aText, expectedEnd - aText );
+        BOOST_CHECK_EQUAL( errno, expectedErrno );
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( SpecialCases )
+{
+    const char* cases[] = {
+        "", "abc", ".", "-", "+3", "- 3", "\t\n42)", "0", "-0", "1.5", "  -12.25e3x", ".5",
+        "5.", "-.e3", "1e", "1e+", "1e-5", "0x1p3", "0X10", "inf", "-nan",
+        "0.1", "0.3", "3.14159265358979323846", "9007199254740993", "1e22", "1e23",
+        "123456789012345678901234567890", "12345678901234567890.5",
+        "0.000000000000000000000000000001", "1e400", "1e-400", "4.9e-324",
+        "1.7976931348623157e308", "2.2250738585072014e-308",
+        "9223372036854775807", "9223372036854775808",
+        "-9223372036854775808", "-9223372036854775809",
+    };
+
+    for( const char* text : cases )
+        checkLikeStrtod( text );
+}
+
+
+BOOST_AUTO_TEST_CASE( RandomNumbers )
+{
+    std::mt19937_64 rng( 42 );
+    char            text[64];
+
+    for( int ii = 0; ii < 100000; ++ii )
+    {
+        switch( ii % 3 )
+        {
+        case 0:     // as written in the board files
+            snprintf( text, sizeof( text ), "%.*f", (int) ( rng() % 7 ),
+                      (double) (int64_t) ( rng() % 2000000000 - 1000000000 ) / 1e4 );
+            break;
+
+        case 1:     // any double
+        {
+            uint64_t bits = rng();
+            double   value;
+
+            memcpy( &value, &bits, sizeof( double ) );
+            snprintf( text, sizeof( text ), "%.17g", value );
+            break;
+        }
+
+        default:
+            snprintf( text, sizeof( text ), "%lld", (long long) ( rng() >> ( rng() % 64 ) ) );
+            break;
+        }
+
+        checkLikeStrtod( text );
+    }
+}
+
+
+/**
+ * Whole lines are views into the buffer, which end with their '\n', other lines are copies
+ */
+BOOST_AUTO_TEST_CASE( MemoryLineReaderViews )
+{
+    const std::string  text = "(a 1)\n(b 2.5)\n\n(c 3)";
+    MEMORY_LINE_READER reader( text.data(), text.size(), wxT( "test" ) );
+
+    BOOST_REQUIRE( reader.ReadLine() );
+    BOOST_CHECK( reader.Line() == text.data() );
+    BOOST_CHECK_EQUAL( std::string( reader.Line(), reader.Length() ), "(a 1)\n" );
+    BOOST_CHECK_EQUAL( StrToLong( reader.Line() + 3 ), 1 );
+
+    BOOST_REQUIRE( reader.ReadLine() );
+    BOOST_CHECK_EQUAL( std::string( reader.Line(), reader.Length() ), "(b 2.5)\n" );
+    BOOST_CHECK_EQUAL( StrToDouble( reader.Line() + 3 ), 2.5 );
+
+    BOOST_REQUIRE( reader.ReadLine() );
+    BOOST_CHECK_EQUAL( reader.Length(), 1u );
+
+    // The last line has no '\n', and is copied
+    BOOST_REQUIRE( reader.ReadLine() );
+    BOOST_CHECK( reader.Line() != text.data() + 15 );
+    BOOST_CHECK_EQUAL( std::string( reader.Line() ), "(c 3)" );
+    BOOST_CHECK_EQUAL( reader.LineNumber(), 4u );
+
+    BOOST_CHECK( !reader.ReadLine() );
+
+    reader.Rewind();
+
+    BOOST_REQUIRE( reader.ReadLine() );
+    BOOST_CHECK_EQUAL( reader.LineNumber(), 1u );
+    BOOST_CHECK( reader.Line() == text.data() );
+}
+
+
+/**
+ * The text around a skipped range is joined in a copied line
+ */
+BOOST_AUTO_TEST_CASE( MemoryLineReaderSkip )
+{
+    const std::string  text = "(a (b\n1) c)\n(d)\n";
+    MEMORY_LINE_READER reader( text.data(), text.size(), wxT( "test" ) );
+
+    reader.Skip( 3, 8 );
+
+    BOOST_REQUIRE( reader.ReadLine() );
+    BOOST_CHECK_EQUAL( std::string( reader.Line() ), "(a  c)\n" );
+    BOOST_CHECK_EQUAL( reader.LineNumber(), 2u );
+
+    BOOST_REQUIRE( reader.ReadLine() );
+    BOOST_CHECK( reader.Line() == text.data() + 12 );
+    BOOST_CHECK_EQUAL( reader.LineNumber(), 3u );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,167 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/plotting.h>
+
+#include <cstdlib>
+#include <functional>
+
+// Code under test
+#include <common.h>
+#include <convert_to_biu.h>
+#include <plotter.h>
+
+using KI_TEST::CountOf;
+
+
+struct PDF_PLOTTER_FIXTURE : KI_TEST::TEMP_FILE_PLOTTER_FIXTURE
+{
+    PDF_PLOTTER_FIXTURE() : TEMP_FILE_PLOTTER_FIXTURE( wxT( "qa_pdf" ) )
+    {
+    }
+
+    /**
+     * Plot a PDF file of aPageCount pages, calling aPlot for each page, and return
+     * the content of the file
+     */
+    std::string plot( int aPageCount, const std::function<void( PDF_PLOTTER&, int )>& aPlot )
+    {
+        LOCALE_IO   toggle;
+        PDF_PLOTTER plotter;
+
+        plotter.SetPageSettings( PAGE_INFO( PAGE_INFO::A4 ) );
+        plotter.SetViewport( wxPoint( 0, 0 ), IU_PER_MILS / 10, 1.0, false );
+
+        StartPlot( plotter );
+
+        for( int page = 0; page < aPageCount; page++ )
+        {
+            if( page > 0 )
+            {
+                plotter.ClosePage();
+                plotter.StartPage();
+            }
+
+            aPlot( plotter, page );
+        }
+
+        return EndPlot( plotter );
+    }
+};
+
+
+/**
+ * Check the xref table gives the offset of each object of aText
+ */
+static void checkXref( const std::string& aText )
+{
+    size_t startxref = aText.rfind( "startxref\n" );
+    BOOST_REQUIRE( startxref != std::string::npos );
+
+    size_t xref = std::strtoul( aText.c_str() + startxref + 10, nullptr, 10 );
+    BOOST_REQUIRE_EQUAL( aText.compare( xref, 5, "xref\n" ), 0 );
+
+    char* entry;
+    long  count = std::strtol( aText.c_str() + xref + 7, &entry, 10 );
+
+    // Skip the end of line and the entry of the null object
+    entry += 1 + 20;
+
+    for( long ii = 1; ii < count; ii++, entry += 20 )
+    {
+        size_t      offset = std::strtoul( entry, nullptr, 10 );
+        std::string header = std::to_string( ii ) + " 0 obj\n";
+
+        BOOST_TEST_CONTEXT( "object " << ii )
+        {
+            BOOST_CHECK_EQUAL( aText.compare( offset, header.size(), header ), 0 );
+        }
+    }
+}
+
+
+BOOST_FIXTURE_TEST_SUITE( PdfPlotter, PDF_PLOTTER_FIXTURE )
+
+
+/**
+ * The pads of the same shape, on all the pages, are plotted in the same form
+ */
+BOOST_AUTO_TEST_CASE( PadForms )
+{
+    const int pageCount = 5;
+
+    std::string text = plot( pageCount, []( PDF_PLOTTER& aPlotter, int aPage )
+            {
+                const wxSize size( 2 * IU_PER_MM, 1 * IU_PER_MM );
+
+                for( int ii = 0; ii < 100; ii++ )
+                {
+                    wxPoint pos( ii * IU_PER_MM, aPage * IU_PER_MM );
+
+                    aPlotter.FlashPadOval( pos, size, 900, FILLED, nullptr );
+                    aPlotter.FlashPadCircle( pos, 1 * IU_PER_MM, FILLED, nullptr );
+                }
+
+                aPlotter.FlashPadRect( wxPoint( 0, 0 ), size, 0, FILLED, nullptr );
+            } );
+
+    BOOST_CHECK_EQUAL( CountOf( text, "/Type /Page\n" ), pageCount );
+    BOOST_CHECK_EQUAL( CountOf( text, "/Subtype /Form" ), 3 );
+    BOOST_CHECK_EQUAL( CountOf( text, "/KicadForm2 " ), 1 );
+    BOOST_CHECK_EQUAL( CountOf( text, "/FlateDecode" ), pageCount + 3 );
+    checkXref( text );
+}
+
+
+/**
+ * Identical reusable blocks are plotted once, different ones in their own form
+ */
+BOOST_AUTO_TEST_CASE( ReusableBlocks )
+{
+    const int pageCount = 4;
+
+    std::string text = plot( pageCount, []( PDF_PLOTTER& aPlotter, int aPage )
+            {
+                aPlotter.StartReusableBlock();
+                aPlotter.Rect( wxPoint( 0, 0 ), wxPoint( 100 * IU_PER_MM, 50 * IU_PER_MM ),
+                               NO_FILL, 0.15 * IU_PER_MM );
+                aPlotter.EndReusableBlock();
+
+                // Only the last page has a different block
+                aPlotter.StartReusableBlock();
+                aPlotter.Circle( wxPoint( 0, 0 ), ( aPage == pageCount - 1 ? 2 : 1 ) * IU_PER_MM,
+                                 NO_FILL, 0.15 * IU_PER_MM );
+                aPlotter.EndReusableBlock();
+
+                // Empty blocks make no form
+                aPlotter.StartReusableBlock();
+                aPlotter.EndReusableBlock();
+            } );
+
+    BOOST_CHECK_EQUAL( CountOf( text, "/Type /Page\n" ), pageCount );
+    BOOST_CHECK_EQUAL( CountOf( text, "/Subtype /Form" ), 3 );
+    checkXref( text );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
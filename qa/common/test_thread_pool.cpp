@@ -0,0 +1,166 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <thread_pool.h>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+
+BOOST_AUTO_TEST_SUITE( ThreadPool )
+
+
+/**
+ * Check every item of a RunForEach() loop is visited exactly once
+ */
+BOOST_AUTO_TEST_CASE( RunForEachVisitsAll )
+{
+    const size_t count = 10000;
+    std::vector<std::atomic<int>> visits( count );
+
+    for( auto& visit : visits )
+        visit = 0;
+
+    TASK_GROUP group;
+    group.RunForEach( count, [&]( size_t aIndex ) { visits[aIndex]++; }, 16 );
+
+    BOOST_CHECK( group.Wait() );
+
+    for( size_t ii = 0; ii < count; ++ii )
+        BOOST_CHECK_EQUAL( visits[ii].load(), 1 );
+}
+
+
+/**
+ * Check groups run from the pool tasks complete, even with more tasks than workers
+ */
+BOOST_AUTO_TEST_CASE( NestedGroups )
+{
+    const size_t     outer = 4 * THREAD_POOL::GetInstance().GetThreadCount() + 1;
+    const size_t     inner = 100;
+    std::atomic<int> total( 0 );
+
+    TASK_GROUP group;
+
+    group.RunForEach( outer, [&]( size_t )
+    {
+        TASK_GROUP nested;
+        nested.RunForEach( inner, [&]( size_t ) { total++; } );
+        nested.Wait();
+    } );
+
+    group.Wait();
+
+    BOOST_CHECK_EQUAL( total.load(), (int) ( outer * inner ) );
+}
+
+
+/**
+ * Check an exception thrown by a task is rethrown by Wait()
+ */
+BOOST_AUTO_TEST_CASE( ExceptionPropagation )
+{
+    TASK_GROUP group;
+
+    group.Run( []() { throw std::runtime_error( "task failure" ); } );
+
+    BOOST_CHECK_THROW( group.Wait(), std::runtime_error );
+}
+
+
+/**
+ * Check the tasks of a cancelled group are skipped
+ */
+BOOST_AUTO_TEST_CASE( Cancellation )
+{
+    THREAD_POOL      pool( 1 );
+    TASK_GROUP       group( pool );
+    std::atomic<int> ran( 0 );
+
+    group.Cancel();
+
+    for( int ii = 0; ii < 10; ++ii )
+        group.Run( [&]() { ran++; } );
+
+    BOOST_CHECK( !group.Wait() );
+    BOOST_CHECK_EQUAL( ran.load(), 0 );
+}
+
+
+/**
+ * Check waiting for a group runs the queued tasks of this group and of the groups nested in
+ * it, and never the ones of other groups, even when the workers are all busy
+ */
+BOOST_AUTO_TEST_CASE( WaitRunsOnlyItsOwnTasks )
+{
+    THREAD_POOL       pool( 1 );
+    TASK_GROUP        group( pool );
+    TASK_GROUP        other( pool );
+    std::atomic<bool> started( false );
+    std::atomic<bool> release( false );
+    std::atomic<int>  otherRan( 0 );
+    std::atomic<int>  nestedRan( 0 );
+
+    // The only worker runs this task until the wait below is over
+    other.Run( [&]()
+    {
+        started = true;
+
+        while( !release )
+            std::this_thread::yield();
+    } );
+
+    while( !started )
+        std::this_thread::yield();
+
+    for( int ii = 0; ii < 100; ++ii )
+        other.Run( [&]() { otherRan++; } );
+
+    for( int ii = 0; ii < 3; ++ii )
+    {
+        group.Run( [&]()
+        {
+            TASK_GROUP nested( pool );
+
+            for( int jj = 0; jj < 10; ++jj )
+                nested.Run( [&]() { nestedRan++; } );
+
+            nested.Wait();
+        } );
+    }
+
+    BOOST_CHECK( group.Wait() );
+    BOOST_CHECK_EQUAL( nestedRan.load(), 30 );
+    BOOST_CHECK_EQUAL( otherRan.load(), 0 );
+
+    release = true;
+
+    BOOST_CHECK( other.Wait() );
+    BOOST_CHECK_EQUAL( otherRan.load(), 100 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,242 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <memory>
+#include <set>
+
+#include <profile.h>
+#include <view/view_item.h>
+#include <view/view_rtree.h>
+
+
+// All these tests are of a class in KIGFX
+using namespace KIGFX;
+
+
+namespace
+{
+
+/**
+ * A view item with a settable bounding box
+ */
+class TEST_ITEM : public VIEW_ITEM
+{
+public:
+    TEST_ITEM( const BOX2I& aBBox ) : m_bbox( aBBox )
+    {
+    }
+
+    const BOX2I ViewBBox() const override
+    {
+        return m_bbox;
+    }
+
+    void ViewGetLayers( int aLayers[], int& aCount ) const override
+    {
+        aLayers[0] = 0;
+        aCount = 1;
+    }
+
+    BOX2I m_bbox;
+};
+
+
+/**
+ * Collects the items found by a query
+ */
+struct COLLECTOR
+{
+    bool operator()( VIEW_ITEM* aItem )
+    {
+        m_items.insert( aItem );
+        return true;
+    }
+
+    std::set<VIEW_ITEM*> m_items;
+};
+
+
+/**
+ * A board-like set of items: a grid of footprint sized boxes
+ */
+std::vector<std::unique_ptr<TEST_ITEM>> buildItems( int aCount )
+{
+    std::vector<std::unique_ptr<TEST_ITEM>> items;
+    const int                               pitch = 5000000;
+    const int                               columns = 200;
+
+    for( int ii = 0; ii < aCount; ii++ )
+    {
+        VECTOR2I pos( ( ii % columns ) * pitch, ( ii / columns ) * pitch );
+
+        items.emplace_back( new TEST_ITEM( BOX2I( pos, VECTOR2I( 3000000, 2000000 ) ) ) );
+    }
+
+    return items;
+}
+
+
+std::set<VIEW_ITEM*> query( VIEW_RTREE& aTree, const BOX2I& aBox )
+{
+    COLLECTOR collector;
+
+    aTree.Query( aBox, collector );
+
+    return collector.m_items;
+}
+
+} // namespace
+
+
+BOOST_AUTO_TEST_SUITE( ViewRtree )
+
+
+/**
+ * Items are removed with the box they were inserted with
+ */
+BOOST_AUTO_TEST_CASE( RemoveWithBBox )
+{
+    auto       items = buildItems( 1000 );
+    VIEW_RTREE tree;
+
+    for( auto& item : items )
+        tree.Insert( item.get(), item->m_bbox );
+
+    for( size_t ii = 0; ii < items.size(); ii += 2 )
+        tree.Remove( items[ii].get(), items[ii]->m_bbox );
+
+    BOX2I all;
+    all.SetMaximum();
+
+    std::set<VIEW_ITEM*> found = query( tree, all );
+
+    BOOST_CHECK_EQUAL( found.size(), items.size() / 2 );
+
+    for( size_t ii = 0; ii < items.size(); ii++ )
+        BOOST_CHECK_EQUAL( found.count( items[ii].get() ), ii % 2 );
+}
+
+
+/**
+ * Moved items are found at their new place only
+ */
+BOOST_AUTO_TEST_CASE( MoveItems )
+{
+    auto       items = buildItems( 1000 );
+    VIEW_RTREE tree;
+
+    for( auto& item : items )
+        tree.Insert( item.get(), item->m_bbox );
+
+    TEST_ITEM* item = items[500].get();
+    BOX2I      oldBBox = item->m_bbox;
+
+    item->m_bbox.Move( VECTOR2I( 1000000000, 0 ) );
+
+    tree.Remove( item, oldBBox );
+    tree.Insert( item, item->m_bbox );
+
+    BOOST_CHECK_EQUAL( query( tree, oldBBox ).count( item ), 0 );
+    BOOST_CHECK_EQUAL( query( tree, item->m_bbox ).count( item ), 1 );
+
+    // An item is still removed if given the wrong box
+    tree.Remove( item, oldBBox );
+
+    BOOST_CHECK_EQUAL( query( tree, item->m_bbox ).count( item ), 0 );
+}
+
+
+/**
+ * Compare the time taken to move items (remove and insert them) with a search of the
+ * whole tree and with their previous box.
+ * Timings are only reported, as they depend on the machine.
+ */
+BOOST_AUTO_TEST_CASE( Benchmark )
+{
+    auto       items = buildItems( 20000 );
+    VIEW_RTREE fullSearchTree;
+    VIEW_RTREE bboxTree;
+
+    for( auto& item : items )
+    {
+        fullSearchTree.Insert( item.get(), item->m_bbox );
+        bboxTree.Insert( item.get(), item->m_bbox );
+    }
+
+    // Drag 500 items, ten steps
+    const int      movedCount = 500;
+    const VECTOR2I step( 100000, 100000 );
+    double         fullSearchTime = 0.0;
+    double         bboxTime = 0.0;
+
+    for( int ii = 0; ii < 10; ii++ )
+    {
+        PROF_COUNTER fullSearch;
+
+        for( int jj = 0; jj < movedCount; jj++ )
+        {
+            TEST_ITEM* item = items[jj * 37].get();
+            BOX2I      newBBox = item->m_bbox;
+
+            newBBox.Move( step );
+
+            fullSearchTree.Remove( item );
+            fullSearchTree.Insert( item, newBBox );
+        }
+
+        fullSearch.Stop();
+
+        PROF_COUNTER bbox;
+
+        for( int jj = 0; jj < movedCount; jj++ )
+        {
+            TEST_ITEM* item = items[jj * 37].get();
+            BOX2I      oldBBox = item->m_bbox;
+
+            item->m_bbox.Move( step );
+
+            bboxTree.Remove( item, oldBBox );
+            bboxTree.Insert( item, item->m_bbox );
+        }
+
+        bbox.Stop();
+
+        fullSearchTime += fullSearch.msecs();
+        bboxTime += bbox.msecs();
+    }
+
+    BOX2I all;
+    all.SetMaximum();
+
+    BOOST_CHECK_EQUAL( query( fullSearchTree, all ).size(), items.size() );
+    BOOST_CHECK_EQUAL( query( bboxTree, all ).size(), items.size() );
+
+    BOOST_TEST_MESSAGE( items.size() << " items, " << movedCount << " items moved 10 times: "
+                        << "full tree search " << fullSearchTime << " ms, "
+                        << "previous bbox " << bboxTime << " ms" );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
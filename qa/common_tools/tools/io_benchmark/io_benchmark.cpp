@@ -25,6 +25,7 @@
 
 #include <wx/wx.h>
 #include <richio.h>
+#include <number_parser.h>
 
 #include <chrono>
 #include <ios>
@@ -304,6 +305,52 @@ static void bench_wxbis_reuse( const wxFileName& aFile, int aReps, BENCH_REPORT&
     }
 }
 
+/**
+ * Converts every number of the file with the given strtod()-like function.  The file is read
+ * with a MMAP_LINE_READER, so this is mostly the conversion time.
+ */
+template<double (*STRTOD)( const char*, const char** )>
+static void bench_numbers( const wxFileName& aFile, int aReps, BENCH_REPORT& report )
+{
+    MMAP_LINE_READER fstr( aFile.GetFullPath() );
+
+    for( int i = 0; i < aReps; ++i)
+    {
+        while( fstr.ReadLine() )
+        {
+            const char* cp = fstr.Line();
+            const char* end = cp + fstr.Length();
+
+            report.linesRead++;
+
+            while( cp < end )
+            {
+                if( ( *cp >= '0' && *cp <= '9' ) || *cp == '-' || *cp == '.' )
+                {
+                    const char* next;
+                    double      value = STRTOD( cp, &next );
+
+                    report.charAcc += (unsigned) value;
+                    cp = ( next > cp ) ? next : cp + 1;
+                }
+                else
+                {
+                    ++cp;
+                }
+            }
+        }
+
+        fstr.Rewind();
+    }
+}
+
+
+static double c_strtod( const char* aText, const char** aEnd )
+{
+    return strtod( aText, (char**) aEnd );
+}
+
+
 /**
  * List of available benchmarks
  */
@@ -313,6 +360,8 @@ static std::vector<BENCHMARK> benchmarkList =
     { 'F', bench_fstream_reuse, "std::fstream, reused" },
     { 'r', bench_line_reader<FILE_LINE_READER>, "RichIO FILE_L_R" },
     { 'R', bench_line_reader_reuse<FILE_LINE_READER>, "RichIO FILE_L_R, reused" },
+    { 'm', bench_line_reader<MMAP_LINE_READER>, "RichIO MMAP_L_R" },
+    { 'M', bench_line_reader_reuse<MMAP_LINE_READER>, "RichIO MMAP_L_R, reused" },
     { 'n', bench_line_reader<IFSTREAM_LINE_READER>, "std::ifstream L_R" },
     { 'N', bench_line_reader_reuse<IFSTREAM_LINE_READER>, "std::ifstream L_R, reused" },
     { 's', bench_string_lr, "RichIO STRING_L_R"},
@@ -325,6 +374,8 @@ static std::vector<BENCHMARK> benchmarkList =
     { 'B', bench_wxbis_reuse<wxFileInputStream>, "wxFileIStream, buf'd, reused" },
     { 'c', bench_wxbis<wxFFileInputStream>, "wxFFileIStream. buf'd" },
     { 'C', bench_wxbis_reuse<wxFFileInputStream>, "wxFFileIStream, buf'd, reused" },
+    { 'd', bench_numbers<c_strtod>, "strtod() numbers" },
+    { 'D', bench_numbers<StrToDouble>, "StrToDouble() numbers" },
 };
 
 
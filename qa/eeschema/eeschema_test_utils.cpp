@@ -47,3 +47,20 @@ wxFileName KI_TEST::GetEeschemaTestDataDir()
 
     return wxFileName{ fn };
 }
+
+
+wxFileName KI_TEST::GetDemosDir()
+{
+    const char* env = std::getenv( "KICAD_TEST_DEMOS_DIR" );
+    wxString fn;
+
+    if( !env )
+        fn << QA_DEMOS_LOCATION;
+    else
+        fn << env;
+
+    // Ensure the string ends in / to force a directory interpretation
+    fn << "/";
+
+    return wxFileName{ fn };
+}
@@ -39,6 +39,16 @@ namespace KI_TEST
  */
 wxFileName GetEeschemaTestDataDir();
 
+/**
+ * Get the location of the demo projects.
+ *
+ * By default, this is the demos directory of the source tree, but can be overriden
+ * by the KICAD_TEST_DEMOS_DIR environment variable.
+ *
+ * @return a filename referring to the demos dir to use.
+ */
+wxFileName GetDemosDir();
+
 } // namespace KI_TEST
 
 #endif // QA_EESCHEMA_EESCHEMA_TEST_UTILS__H
\ No newline at end of file
@@ -0,0 +1,488 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_netlist_object_list.cpp
+ * Checks the net codes given by NETLIST_OBJECT_LIST::BuildNetListInfo() to the items of
+ * the demo schematics are the ones of a plain (quadratic) implementation of the net
+ * merging, which renumbers the items each time two nets are connected.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <memory>
+
+#include <class_library.h>
+#include <kiway.h>
+#include <netlist_object.h>
+#include <sch_component.h>
+#include <sch_legacy_plugin.h>
+#include <sch_screen.h>
+#include <sch_sheet.h>
+#include <symbol_lib_table.h>
+#include <trigo.h>
+
+#include "eeschema_test_utils.h"
+
+
+namespace
+{
+
+/**
+ * The reference implementation of the net merging
+ */
+class REFERENCE_NETLIST
+{
+public:
+    REFERENCE_NETLIST( NETLIST_OBJECT_LIST& aList ) : m_list( aList ), m_lastNetCode( 1 ),
+            m_lastBusNetCode( 1 )
+    {
+    }
+
+    void Build()
+    {
+        m_list.SortListbySheet();
+
+        unsigned istart = 0;
+
+        for( unsigned ii = 0; ii < m_list.size(); ii++ )
+        {
+            NETLIST_OBJECT* item = m_list.GetItem( ii );
+
+            if( item->m_SheetPath != m_list.GetItem( istart )->m_SheetPath )
+                istart = ii;
+
+            switch( item->m_Type )
+            {
+            case NET_PIN:
+            case NET_PINLABEL:
+            case NET_SHEETLABEL:
+            case NET_NOCONNECT:
+                if( item->GetNet() != 0 )
+                    break;
+
+                // Fall through
+            case NET_SEGMENT:
+                newNetCode( item );
+                pointToPointConnect( item, false, istart );
+                break;
+
+            case NET_JUNCTION:
+                newNetCode( item );
+                segmentToPointConnect( item, false, istart );
+
+                if( item->m_BusNetCode == 0 )
+                    item->m_BusNetCode = m_lastBusNetCode++;
+
+                segmentToPointConnect( item, true, istart );
+                break;
+
+            case NET_LABEL:
+            case NET_HIERLABEL:
+            case NET_GLOBLABEL:
+                newNetCode( item );
+                segmentToPointConnect( item, false, istart );
+                break;
+
+            case NET_SHEETBUSLABELMEMBER:
+                if( item->m_BusNetCode != 0 )
+                    break;
+
+                // Fall through
+            case NET_BUS:
+                if( item->m_BusNetCode == 0 )
+                    item->m_BusNetCode = m_lastBusNetCode++;
+
+                pointToPointConnect( item, true, istart );
+                break;
+
+            case NET_BUSLABELMEMBER:
+            case NET_HIERBUSLABELMEMBER:
+            case NET_GLOBBUSLABELMEMBER:
+                if( item->GetNet() == 0 )
+                    item->m_BusNetCode = m_lastBusNetCode++;
+
+                segmentToPointConnect( item, true, istart );
+                break;
+
+            case NET_ITEM_UNSPECIFIED:
+                break;
+            }
+        }
+
+        connectBusLabels();
+
+        for( unsigned ii = 0; ii < m_list.size(); ii++ )
+        {
+            switch( m_list.GetItemType( ii ) )
+            {
+            case NET_LABEL:
+            case NET_GLOBLABEL:
+            case NET_PINLABEL:
+            case NET_BUSLABELMEMBER:
+            case NET_GLOBBUSLABELMEMBER:
+                labelConnect( m_list.GetItem( ii ) );
+                break;
+
+            default:
+                break;
+            }
+        }
+
+        for( unsigned ii = 0; ii < m_list.size(); ii++ )
+        {
+            if( m_list.GetItemType( ii ) == NET_SHEETLABEL
+                    || m_list.GetItemType( ii ) == NET_SHEETBUSLABELMEMBER )
+            {
+                sheetLabelConnect( m_list.GetItem( ii ) );
+            }
+        }
+
+        m_list.SortListbyNetcode();
+
+        int netCode = 0;
+        int lastNetCode = 0;
+
+        for( unsigned ii = 0; ii < m_list.size(); ii++ )
+        {
+            if( m_list.GetItemNet( ii ) != lastNetCode )
+            {
+                netCode++;
+                lastNetCode = m_list.GetItemNet( ii );
+            }
+
+            m_list.GetItem( ii )->SetNet( netCode );
+        }
+    }
+
+private:
+    void newNetCode( NETLIST_OBJECT* aItem )
+    {
+        if( aItem->GetNet() == 0 )
+            aItem->SetNet( m_lastNetCode++ );
+    }
+
+    void propagateNetCode( int aOldNetCode, int aNewNetCode, bool aIsBus )
+    {
+        for( unsigned ii = 0; ii < m_list.size(); ii++ )
+        {
+            NETLIST_OBJECT* item = m_list.GetItem( ii );
+
+            if( !aIsBus && item->GetNet() == aOldNetCode )
+                item->SetNet( aNewNetCode );
+            else if( aIsBus && item->m_BusNetCode == aOldNetCode )
+                item->m_BusNetCode = aNewNetCode;
+        }
+    }
+
+    void pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus, unsigned aStart )
+    {
+        int netCode = aIsBus ? aRef->m_BusNetCode : aRef->GetNet();
+
+        for( unsigned ii = aStart; ii < m_list.size(); ii++ )
+        {
+            NETLIST_OBJECT* item = m_list.GetItem( ii );
+
+            if( item->m_SheetPath != aRef->m_SheetPath )
+                continue;
+
+            if( aRef->m_Start != item->m_Start && aRef->m_Start != item->m_End
+                    && aRef->m_End != item->m_Start && aRef->m_End != item->m_End )
+            {
+                continue;
+            }
+
+            bool busItem = item->m_Type == NET_BUS || item->IsLabelBusMemberType();
+
+            if( !aIsBus && !busItem && item->m_Type != NET_ITEM_UNSPECIFIED )
+            {
+                if( item->GetNet() == 0 )
+                    item->SetNet( netCode );
+                else
+                    propagateNetCode( item->GetNet(), netCode, false );
+            }
+            else if( aIsBus && ( busItem || item->m_Type == NET_JUNCTION ) )
+            {
+                if( item->m_BusNetCode == 0 )
+                    item->m_BusNetCode = netCode;
+                else
+                    propagateNetCode( item->m_BusNetCode, netCode, true );
+            }
+        }
+    }
+
+    void segmentToPointConnect( NETLIST_OBJECT* aJunction, bool aIsBus, unsigned aStart )
+    {
+        for( unsigned ii = aStart; ii < m_list.size(); ii++ )
+        {
+            NETLIST_OBJECT* segment = m_list.GetItem( ii );
+
+            if( segment->m_SheetPath != aJunction->m_SheetPath )
+                continue;
+
+            if( segment->m_Type != ( aIsBus ? NET_BUS : NET_SEGMENT ) )
+                continue;
+
+            if( !IsPointOnSegment( segment->m_Start, segment->m_End, aJunction->m_Start ) )
+                continue;
+
+            if( !aIsBus )
+            {
+                if( segment->GetNet() )
+                    propagateNetCode( segment->GetNet(), aJunction->GetNet(), false );
+                else
+                    segment->SetNet( aJunction->GetNet() );
+            }
+            else
+            {
+                if( segment->m_BusNetCode )
+                    propagateNetCode( segment->m_BusNetCode, aJunction->m_BusNetCode, true );
+                else
+                    segment->m_BusNetCode = aJunction->m_BusNetCode;
+            }
+        }
+    }
+
+    void connectBusLabels()
+    {
+        for( unsigned ii = 0; ii < m_list.size(); ii++ )
+        {
+            NETLIST_OBJECT* label = m_list.GetItem( ii );
+
+            if( !label->IsLabelBusMemberType() )
+                continue;
+
+            newNetCode( label );
+
+            for( unsigned jj = ii + 1; jj < m_list.size(); jj++ )
+            {
+                NETLIST_OBJECT* other = m_list.GetItem( jj );
+
+                if( !other->IsLabelBusMemberType() || other->m_BusNetCode != label->m_BusNetCode
+                        || other->m_Member != label->m_Member )
+                {
+                    continue;
+                }
+
+                if( other->GetNet() == 0 )
+                    other->SetNet( label->GetNet() );
+                else
+                    propagateNetCode( other->GetNet(), label->GetNet(), false );
+            }
+        }
+    }
+
+    void labelConnect( NETLIST_OBJECT* aLabel )
+    {
+        if( aLabel->GetNet() == 0 )
+            return;
+
+        for( unsigned ii = 0; ii < m_list.size(); ii++ )
+        {
+            NETLIST_OBJECT* item = m_list.GetItem( ii );
+
+            if( item->GetNet() == aLabel->GetNet() )
+                continue;
+
+            if( item->m_SheetPath != aLabel->m_SheetPath )
+            {
+                if( item->m_Type != NET_PINLABEL && item->m_Type != NET_GLOBLABEL
+                        && item->m_Type != NET_GLOBBUSLABELMEMBER )
+                {
+                    continue;
+                }
+
+                if( ( item->m_Type == NET_GLOBLABEL || item->m_Type == NET_GLOBBUSLABELMEMBER )
+                        && item->m_Type != aLabel->m_Type )
+                {
+                    continue;
+                }
+            }
+
+            if( !item->IsLabelType() || item->m_Label != aLabel->m_Label )
+                continue;
+
+            if( item->GetNet() )
+                propagateNetCode( item->GetNet(), aLabel->GetNet(), false );
+            else
+                item->SetNet( aLabel->GetNet() );
+        }
+    }
+
+    void sheetLabelConnect( NETLIST_OBJECT* aSheetLabel )
+    {
+        if( aSheetLabel->GetNet() == 0 )
+            return;
+
+        for( unsigned ii = 0; ii < m_list.size(); ii++ )
+        {
+            NETLIST_OBJECT* item = m_list.GetItem( ii );
+
+            if( item->m_SheetPath != aSheetLabel->m_SheetPathInclude )
+                continue;
+
+            if( item->m_Type != NET_HIERLABEL && item->m_Type != NET_HIERBUSLABELMEMBER )
+                continue;
+
+            if( item->GetNet() == aSheetLabel->GetNet() || item->m_Label != aSheetLabel->m_Label )
+                continue;
+
+            if( item->GetNet() )
+                propagateNetCode( item->GetNet(), aSheetLabel->GetNet(), false );
+            else
+                item->SetNet( aSheetLabel->GetNet() );
+        }
+    }
+
+    NETLIST_OBJECT_LIST& m_list;
+    int                  m_lastNetCode;
+    int                  m_lastBusNetCode;
+};
+
+
+/**
+ * A demo schematic, loaded with the symbols of its cache library
+ */
+class DEMO_SCHEMATIC
+{
+public:
+    DEMO_SCHEMATIC( const wxString& aDirectory, const wxString& aName ) :
+            m_kiway( nullptr, KFCTL_STANDALONE )
+    {
+        wxFileName fn = KI_TEST::GetDemosDir();
+        fn.AppendDir( aDirectory );
+        fn.SetName( aName );
+        fn.SetExt( "pro" );
+
+        m_kiway.Prj().SetProjectFullName( fn.GetFullPath() );
+
+        fn.SetExt( "sch" );
+
+        SCH_LEGACY_PLUGIN plugin;
+        m_root.reset( plugin.Load( fn.GetFullPath(), &m_kiway ) );
+
+        fn.SetName( aName + "-cache" );
+        fn.SetExt( "lib" );
+
+        std::unique_ptr<PART_LIB> cacheLib( PART_LIB::LoadLibrary( fn.GetFullPath() ) );
+        SYMBOL_LIB_TABLE          libTable;
+        SCH_SCREENS               screens( m_root.get() );
+
+        for( SCH_SCREEN* screen = screens.GetFirst(); screen; screen = screens.GetNext() )
+        {
+            for( SCH_ITEM* item = screen->GetDrawItems(); item; item = item->Next() )
+            {
+                if( item->Type() == SCH_COMPONENT_T )
+                    static_cast<SCH_COMPONENT*>( item )->Resolve( libTable, cacheLib.get() );
+            }
+        }
+    }
+
+    /**
+     * Fill aList with the items of the schematic, as BuildNetListInfo() does
+     */
+    void GetNetListItems( NETLIST_OBJECT_LIST& aList )
+    {
+        SCH_SHEET_LIST sheets( m_root.get() );
+
+        for( unsigned ii = 0; ii < sheets.size(); ii++ )
+        {
+            SCH_SHEET_PATH* sheet = &sheets[ii];
+
+            for( SCH_ITEM* item = sheet->LastScreen()->GetDrawItems(); item; item = item->Next() )
+                item->GetNetListItem( aList, sheet );
+        }
+    }
+
+    SCH_SHEET* GetRoot() { return m_root.get(); }
+
+private:
+    KIWAY                      m_kiway;
+    std::unique_ptr<SCH_SHEET> m_root;
+};
+
+} // namespace
+
+
+BOOST_AUTO_TEST_SUITE( NetlistObjectList )
+
+
+struct DEMO_CASE
+{
+    const char* m_directory;
+    const char* m_name;
+};
+
+
+static const std::vector<DEMO_CASE> demoCases = {
+    { "complex_hierarchy", "complex_hierarchy" },
+    { "ecc83", "ecc83-pp" },
+    { "flat_hierarchy", "flat_hierarchy" },
+    { "interf_u", "interf_u" },
+    { "kit-dev-coldfire-xilinx_5213", "kit-dev-coldfire-xilinx_5213" },
+    { "pic_programmer", "pic_programmer" },
+    { "video", "video" },
+};
+
+
+/**
+ * The net codes of the items of the demo schematics are the ones of the reference
+ */
+BOOST_AUTO_TEST_CASE( DemoNetCodes )
+{
+    for( const DEMO_CASE& demo : demoCases )
+    {
+        BOOST_TEST_CONTEXT( demo.m_name )
+        {
+            DEMO_SCHEMATIC schematic( demo.m_directory, demo.m_name );
+            BOOST_REQUIRE( schematic.GetRoot() );
+
+            NETLIST_OBJECT_LIST list;
+            SCH_SHEET_LIST      sheets( schematic.GetRoot() );
+            BOOST_REQUIRE( list.BuildNetListInfo( sheets ) );
+
+            NETLIST_OBJECT_LIST expected;
+            schematic.GetNetListItems( expected );
+            REFERENCE_NETLIST( expected ).Build();
+
+            // Both lists are built from the same items, sorted the same way
+            BOOST_REQUIRE_EQUAL( list.size(), expected.size() );
+
+            for( unsigned ii = 0; ii < list.size(); ii++ )
+            {
+                BOOST_TEST_CONTEXT( "item " << ii )
+                {
+                    BOOST_CHECK_EQUAL( list.GetItemType( ii ), expected.GetItemType( ii ) );
+                    BOOST_CHECK( list.GetItem( ii )->m_Start == expected.GetItem( ii )->m_Start );
+                    BOOST_CHECK( list.GetItem( ii )->m_End == expected.GetItem( ii )->m_End );
+                    BOOST_CHECK( list.GetItem( ii )->m_SheetPath
+                                 == expected.GetItem( ii )->m_SheetPath );
+                    BOOST_CHECK_EQUAL( list.GetItemNet( ii ), expected.GetItemNet( ii ) );
+                }
+            }
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
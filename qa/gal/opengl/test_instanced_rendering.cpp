@@ -0,0 +1,430 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <unit_test_utils/headless_gl_context.h>
+
+#include <gal/gal_display_options.h>
+#include <gal/opengl/shader.h>
+#include <gal/opengl/vertex_gal.h>
+#include <gal/opengl/vertex_item.h>
+#include <gal/opengl/vertex_manager.h>
+
+#include "gl_builtin_shaders.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+using namespace KIGFX;
+
+
+///< Shapes stored as instance records. They are drawn in this order in each row of the view,
+///< so that the kind of a shape is the kind of its column
+enum SHAPE_KIND
+{
+    FILLED_CIRCLE,
+    STROKED_CIRCLE,
+    SEGMENT,
+    ARC,
+    SHAPE_KINDS
+};
+
+static const int    VIEW_SIZE = 256;                    ///< Size of the view, in pixels
+static const int    CELL_SIZE = 32;                     ///< Size of the cell of a shape, in pixels
+static const int    COLUMNS = VIEW_SIZE / CELL_SIZE;
+static const double PIXEL = 100.0;                      ///< Size of a pixel, in world units
+static const int    CIRCLE_POINTS = 64;                 ///< As in VERTEX_GAL
+
+
+static SHAPE_KIND shapeKind( int aIndex )
+{
+    return static_cast<SHAPE_KIND>( aIndex % SHAPE_KINDS );
+}
+
+
+/**
+ * Draw the n-th shape in its cell, the cells wrapping around the view. Widths go from a
+ * fraction of a pixel to a few pixels.
+ */
+static void drawShape( GAL& aGal, int aIndex )
+{
+    const double   half = CELL_SIZE * PIXEL / 2.0;
+    const VECTOR2D center( ( 2 * ( aIndex % COLUMNS ) + 1 ) * half,
+                           ( 2 * ( ( aIndex / COLUMNS ) % COLUMNS ) + 1 ) * half );
+
+    aGal.SetIsFill( shapeKind( aIndex ) != STROKED_CIRCLE );
+    aGal.SetIsStroke( shapeKind( aIndex ) == STROKED_CIRCLE );
+    aGal.SetFillColor( COLOR4D( 0.2 + 0.1 * ( aIndex % 8 ), 0.5, 1.0 - 0.1 * ( aIndex % 7 ), 1.0 ) );
+    aGal.SetStrokeColor( COLOR4D( 1.0, 0.3 + 0.1 * ( aIndex % 5 ), 0.2, 1.0 ) );
+
+    switch( shapeKind( aIndex ) )
+    {
+    case FILLED_CIRCLE:
+        aGal.DrawCircle( center, half * ( 0.2 + 0.07 * ( aIndex % 11 ) ) );
+        break;
+
+    case STROKED_CIRCLE:
+        aGal.SetLineWidth( PIXEL * ( 0.5 + aIndex % 4 ) );
+        aGal.DrawCircle( center, half * ( 0.3 + 0.06 * ( aIndex % 9 ) ) );
+        break;
+
+    case SEGMENT:
+    {
+        const VECTOR2D end = VECTOR2D( half * 0.6, 0.0 ).Rotate( 0.37 * aIndex );
+
+        aGal.DrawSegment( center - end, center + end, PIXEL * ( 0.3 + 0.9 * ( aIndex % 8 ) ) );
+        break;
+    }
+
+    default:
+        aGal.DrawArcSegment( center, half * 0.6, 0.5 * aIndex,
+                             0.5 * aIndex + 0.4 + 0.5 * ( aIndex % 12 ),
+                             PIXEL * ( 0.5 + 1.5 * ( aIndex % 4 ) ) );
+        break;
+    }
+}
+
+
+/**
+ * Shapes drawn by a GROUP_RECORDER, a group each, then copied to a cached manager as
+ * OPENGL_GAL::CopyGroup() does
+ */
+struct SHAPE_SCENE
+{
+    SHAPE_SCENE( GAL_DISPLAY_OPTIONS& aOptions, SHADER& aShader, bool aInstancing,
+                 int aShapeCount ) :
+        m_manager( true ),
+        m_records( 0 ),
+        m_milliseconds( 0.0 )
+    {
+        GROUP_RECORDER   recorder( aOptions );
+        std::vector<int> groups;
+
+        recorder.EnableInstancing( aInstancing );
+        recorder.SetLayerDepth( 0.0 );
+
+        m_manager.EnableInstancing( aInstancing );
+        m_manager.SetShader( aShader );
+
+        glFinish();
+        auto start = std::chrono::steady_clock::now();
+
+        for( int ii = 0; ii < aShapeCount; ++ii )
+        {
+            groups.push_back( recorder.BeginGroup() );
+            drawShape( recorder, ii );
+            recorder.EndGroup();
+        }
+
+        m_manager.Map();
+
+        for( int group : groups )
+        {
+            unsigned int  size;
+            const VERTEX* vertices = recorder.GetGroupVertices( group, size );
+            unsigned int  instances = recorder.GetGroupInstanceCount( group );
+
+            m_items.emplace_back( new VERTEX_ITEM( m_manager ) );
+
+            if( size > instances )
+                m_manager.CopyVertices( vertices, size - instances );
+
+            if( instances > 0 )
+                m_manager.CopyInstances( vertices + size - instances, instances );
+
+            m_manager.FinishItem();
+            m_records += m_items.back()->GetSize();
+        }
+
+        m_manager.Unmap();
+        glFinish();
+
+        m_milliseconds = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start ).count();
+    }
+
+    /**
+     * Render the scene and read its pixels (RGBA, from the bottom row)
+     */
+    std::vector<GLubyte> render()
+    {
+        std::vector<GLubyte> pixels( VIEW_SIZE * VIEW_SIZE * 4 );
+
+        glClearColor( 0.0f, 0.0f, 0.0f, 1.0f );
+        glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
+
+        m_manager.BeginDrawing();
+
+        for( const std::unique_ptr<VERTEX_ITEM>& item : m_items )
+            m_manager.DrawItem( *item );
+
+        m_manager.EndDrawing();
+
+        glReadPixels( 0, 0, VIEW_SIZE, VIEW_SIZE, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data() );
+
+        return pixels;
+    }
+
+    VERTEX_MANAGER                            m_manager;
+    std::vector<std::unique_ptr<VERTEX_ITEM>> m_items;        ///< Freed before the manager
+    unsigned int                              m_records;      ///< Records of all the items
+    double                                    m_milliseconds; ///< Time to draw and upload
+};
+
+
+struct INSTANCED_RENDERING_FIXTURE
+{
+    INSTANCED_RENDERING_FIXTURE() :
+        m_gl( VIEW_SIZE )
+    {
+    }
+
+    /**
+     * Load the shaders and set the view, if the context can draw instances
+     * @return false if the test has to be skipped
+     */
+    bool init()
+    {
+        if( !m_gl.m_current )
+        {
+            BOOST_TEST_MESSAGE( "No headless openGL context (EGL pixel buffer), skipping" );
+            return false;
+        }
+
+        if( !GLEW_VERSION_2_1 || !GLEW_ARB_vertex_buffer_object
+                || !GLEW_ARB_instanced_arrays || !GLEW_ARB_draw_instanced )
+        {
+            BOOST_TEST_MESSAGE( "Instanced rendering is not supported, skipping" );
+            return false;
+        }
+
+        BOOST_TEST_MESSAGE( "Renderer: " << glGetString( GL_RENDERER ) << ", "
+                            << glGetString( GL_VERSION ) );
+
+        BOOST_REQUIRE( m_shader.LoadShaderFromStrings( SHADER_TYPE_VERTEX,
+                                                       BUILTIN_SHADERS::kicad_vertex_shader ) );
+        BOOST_REQUIRE( m_shader.LoadShaderFromStrings( SHADER_TYPE_FRAGMENT,
+                                                       BUILTIN_SHADERS::kicad_fragment_shader ) );
+        BOOST_REQUIRE( m_shader.Link() );
+
+        int worldPixelSize = m_shader.AddParameter( "worldPixelSize" );
+        int screenPixelSize = m_shader.AddParameter( "screenPixelSize" );
+        int pixelSizeMultiplier = m_shader.AddParameter( "pixelSizeMultiplier" );
+
+        m_shader.Use();
+        m_shader.SetParameter( worldPixelSize, (float) PIXEL );
+        m_shader.SetParameter( screenPixelSize, VECTOR2D( 2.0 / VIEW_SIZE, 2.0 / VIEW_SIZE ) );
+        m_shader.SetParameter( pixelSizeMultiplier, 1.0f );
+        m_shader.Deactivate();
+
+        // A pixel of the view is PIXEL world units, the shapes do not overlap
+        glViewport( 0, 0, VIEW_SIZE, VIEW_SIZE );
+        glMatrixMode( GL_PROJECTION );
+        glLoadIdentity();
+        glOrtho( 0, VIEW_SIZE, VIEW_SIZE, 0, -1, 1 );
+        glMatrixMode( GL_MODELVIEW );
+        glLoadIdentity();
+        glScaled( 1.0 / PIXEL, 1.0 / PIXEL, 1.0 );
+
+        glEnable( GL_BLEND );
+        glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
+
+        return true;
+    }
+
+    HEADLESS_GL_CONTEXT m_gl;
+    SHADER              m_shader;
+    GAL_DISPLAY_OPTIONS m_options;
+};
+
+
+static const GLubyte* pixel( const std::vector<GLubyte>& aPixels, int aX, int aY )
+{
+    return &aPixels[( aY * VIEW_SIZE + aX ) * 4];
+}
+
+
+static bool samePixel( const GLubyte* aA, const GLubyte* aB )
+{
+    return memcmp( aA, aB, 3 ) == 0;
+}
+
+
+BOOST_FIXTURE_TEST_SUITE( InstancedRendering, INSTANCED_RENDERING_FIXTURE )
+
+
+/**
+ * Instance records render the pixels of the triangles for the circles and the segments. The
+ * arcs are exact instead of a chain of segments, so their edges may move by a pixel.
+ */
+BOOST_AUTO_TEST_CASE( SamePixels )
+{
+    if( !init() )
+        return;
+
+    const int shapeCount = COLUMNS * COLUMNS;
+
+    SHAPE_SCENE triangles( m_options, m_shader, false, shapeCount );
+    SHAPE_SCENE instances( m_options, m_shader, true, shapeCount );
+
+    std::vector<GLubyte> expected = triangles.render();
+    std::vector<GLubyte> rendered = instances.render();
+
+    BOOST_CHECK_EQUAL( glGetError(), static_cast<GLenum>( GL_NO_ERROR ) );
+
+    int lit[SHAPE_KINDS] = {};
+    int different[SHAPE_KINDS] = {};
+    int unmatched = 0;
+
+    for( int y = 1; y < VIEW_SIZE - 1; ++y )
+    {
+        for( int x = 1; x < VIEW_SIZE - 1; ++x )
+        {
+            SHAPE_KIND kind = shapeKind( x / CELL_SIZE );
+            const GLubyte* a = pixel( expected, x, y );
+            const GLubyte* b = pixel( rendered, x, y );
+
+            if( a[0] || a[1] || a[2] )
+                lit[kind]++;
+
+            if( !samePixel( a, b ) )
+                different[kind]++;
+
+            // Any lit pixel of a render has to be in the other one, give or take a pixel
+            for( const GLubyte* color : { a, b } )
+            {
+                const std::vector<GLubyte>& other = ( color == a ) ? rendered : expected;
+                bool found = !( color[0] || color[1] || color[2] );
+
+                for( int dy = -1; dy <= 1 && !found; ++dy )
+                {
+                    for( int dx = -1; dx <= 1 && !found; ++dx )
+                        found = samePixel( color, pixel( other, x + dx, y + dy ) );
+                }
+
+                if( !found )
+                    unmatched++;
+            }
+        }
+    }
+
+    for( int kind = 0; kind < SHAPE_KINDS; ++kind )
+    {
+        BOOST_TEST_CONTEXT( "Shape kind " << kind )
+        {
+            BOOST_TEST_MESSAGE( "Shape kind " << kind << ": " << lit[kind] << " lit pixels, "
+                                << different[kind] << " different" );
+
+            BOOST_CHECK_GT( lit[kind], 0 );
+
+            if( kind != ARC )
+                BOOST_CHECK_EQUAL( different[kind], 0 );
+        }
+    }
+
+    BOOST_CHECK_EQUAL( unmatched, 0 );
+}
+
+
+/**
+ * A shape is a single instance record, in place of the vertices of its triangles
+ */
+BOOST_AUTO_TEST_CASE( RecordsPerShape )
+{
+    if( !init() )
+        return;
+
+    const int shapeCount = COLUMNS * COLUMNS;
+
+    SHAPE_SCENE triangles( m_options, m_shader, false, shapeCount );
+    SHAPE_SCENE instances( m_options, m_shader, true, shapeCount );
+
+    BOOST_REQUIRE_EQUAL( instances.m_items.size(), triangles.m_items.size() );
+
+    for( int ii = 0; ii < shapeCount; ++ii )
+    {
+        BOOST_TEST_CONTEXT( "Shape " << ii )
+        {
+            const VERTEX_ITEM& item = *instances.m_items[ii];
+            unsigned int       vertices = triangles.m_items[ii]->GetSize();
+
+            BOOST_CHECK_EQUAL( item.GetSize(), 1u );
+            BOOST_CHECK_EQUAL( item.GetInstanceCount(), 1u );
+            BOOST_CHECK_EQUAL( triangles.m_items[ii]->GetInstanceCount(), 0u );
+
+            switch( shapeKind( ii ) )
+            {
+            case FILLED_CIRCLE:
+            case STROKED_CIRCLE:
+                BOOST_CHECK_EQUAL( vertices, 3u );
+                break;
+
+            case SEGMENT:
+                BOOST_CHECK_EQUAL( vertices, 6u );
+                break;
+
+            default:
+            {
+                // A segment per step of VERTEX_GAL::calcAngleStep(), for these small radii
+                double sweep = 0.4 + 0.5 * ( ii % 12 );
+                unsigned int chords = std::floor( sweep * CIRCLE_POINTS / ( 2.0 * M_PI ) );
+
+                BOOST_CHECK_GE( vertices, 6 * chords );
+                break;
+            }
+            }
+        }
+    }
+}
+
+
+/**
+ * Rebuilding a board of many shapes stores an order of magnitude fewer records, and takes
+ * less time
+ */
+BOOST_AUTO_TEST_CASE( Rebuild )
+{
+    if( !init() )
+        return;
+
+    const int shapeCount = 20000;
+
+    SHAPE_SCENE triangles( m_options, m_shader, false, shapeCount );
+    SHAPE_SCENE instances( m_options, m_shader, true, shapeCount );
+
+    BOOST_TEST_MESSAGE( shapeCount << " shapes: " << triangles.m_records * VERTEX_SIZE
+                        << " bytes in " << triangles.m_milliseconds << " ms with triangles, "
+                        << instances.m_records * VERTEX_SIZE << " bytes in "
+                        << instances.m_milliseconds << " ms with instance records" );
+
+    BOOST_CHECK_EQUAL( instances.m_records, (unsigned int) shapeCount );
+    BOOST_CHECK_GE( triangles.m_records, 10 * instances.m_records );
+    BOOST_CHECK_LT( instances.m_milliseconds, triangles.m_milliseconds );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -25,6 +25,8 @@
 
 #include <pcbnew_utils/board_file_utils.h>
 
+#include <cstdlib>
+
 // For the temp directory logic: can be std::filesystem in C++17
 #include <boost/filesystem.hpp>
 #include <boost/test/unit_test.hpp>
@@ -50,4 +52,21 @@ void BOARD_DUMPER::DumpBoardToFile( BOARD& aBoard, const std::string& aName ) co
     ::KI_TEST::DumpBoardToFile( aBoard, path.string() );
 }
 
+
+wxFileName GetDemosDir()
+{
+    const char* env = std::getenv( "KICAD_TEST_DEMOS_DIR" );
+    wxString fn;
+
+    if( !env )
+        fn << QA_DEMOS_LOCATION;
+    else
+        fn << env;
+
+    // Ensure the string ends in / to force a directory interpretation
+    fn << "/";
+
+    return wxFileName{ fn };
+}
+
 } // namespace KI_TEST
\ No newline at end of file
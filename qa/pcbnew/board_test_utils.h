@@ -31,6 +31,8 @@
 
 #include <string>
 
+#include <wx/filename.h>
+
 class BOARD;
 class BOARD_ITEM;
 
@@ -58,6 +60,17 @@ public:
     const bool m_dump_boards;
 };
 
+
+/**
+ * Get the location of the demo projects.
+ *
+ * By default, this is the demos directory of the source tree, but can be overriden
+ * by the KICAD_TEST_DEMOS_DIR environment variable.
+ *
+ * @return a filename referring to the demos dir to use.
+ */
+wxFileName GetDemosDir();
+
 } // namespace KI_TEST
 
 #endif // QA_PCBNEW_BOARD_TEST_UTILS__H
\ No newline at end of file
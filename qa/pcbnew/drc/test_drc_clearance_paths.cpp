@@ -0,0 +1,173 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <class_board.h>
+#include <class_track.h>
+#include <drc.h>
+#include <kicad_plugin.h>
+
+#include "../board_test_utils.h"
+#include "drc_test_utils.h"
+
+
+/**
+ * The demo boards, as directory and file name in the demos directory
+ */
+static const std::vector<std::pair<std::string, std::string>> s_demoBoards = {
+    { "complex_hierarchy", "complex_hierarchy" },
+    { "custom_pads_test", "custom_pads_test" },
+    { "ecc83", "ecc83-pp" },
+    { "ecc83", "ecc83-pp_v2" },
+    { "flat_hierarchy", "flat_hierarchy" },
+    { "interf_u", "interf_u" },
+    { "kit-dev-coldfire-xilinx_5213", "kit-dev-coldfire-xilinx_5213" },
+    { "microwave", "microwave" },
+    { "pic_programmer", "pic_programmer" },
+    { "sonde xilinx", "sonde xilinx" },
+    { "test_pads_inside_pads", "test_pads_inside_pads" },
+    { "test_xil_95108", "carte_test" },
+    { "video", "video" },
+};
+
+
+static std::unique_ptr<BOARD> loadDemoBoard( const std::string& aDir, const std::string& aName )
+{
+    wxFileName fn = KI_TEST::GetDemosDir();
+
+    fn.AppendDir( aDir );
+    fn.SetName( aName );
+    fn.SetExt( "kicad_pcb" );
+
+    PCB_IO io;
+
+    return std::unique_ptr<BOARD>( io.Load( fn.GetFullPath(), nullptr ) );
+}
+
+
+/**
+ * Everything a marker reports, so that two runs can be compared marker by marker
+ */
+static std::string describeMarker( const MARKER_PCB& aMarker )
+{
+    const DRC_ITEM& item = aMarker.GetReporter();
+
+    wxString text = wxString::Format( "%d at (%d, %d): %s (%d, %d) / %s (%d, %d)",
+                                      item.GetErrorCode(),
+                                      aMarker.GetPos().x, aMarker.GetPos().y,
+                                      item.GetMainText(),
+                                      item.GetPointA().x, item.GetPointA().y,
+                                      item.GetAuxiliaryText(),
+                                      item.GetPointB().x, item.GetPointB().y );
+
+    return text.ToStdString();
+}
+
+
+/**
+ * Run the clearance tests on aBoard, and return the description of the markers, in order
+ */
+static std::vector<std::string> testClearances( BOARD& aBoard, bool aFast )
+{
+    std::vector<MARKER_PCB*> markers = DRC::TestClearances( &aBoard, aFast, aFast );
+    std::vector<std::string> descriptions;
+
+    for( MARKER_PCB* marker : markers )
+    {
+        descriptions.push_back( describeMarker( *marker ) );
+        delete marker;
+    }
+
+    return descriptions;
+}
+
+
+/**
+ * Check the DRC_RTREE and parallel paths give the markers of the sequential path, in the
+ * same order
+ */
+static void checkSameMarkers( BOARD& aBoard )
+{
+    std::vector<std::string> expected = testClearances( aBoard, false );
+    std::vector<std::string> markers = testClearances( aBoard, true );
+
+    BOOST_CHECK_EQUAL_COLLECTIONS( markers.begin(), markers.end(),
+                                   expected.begin(), expected.end() );
+}
+
+
+BOOST_AUTO_TEST_SUITE( DrcClearancePaths )
+
+
+/**
+ * The demo boards as saved, with their zone fills
+ */
+BOOST_AUTO_TEST_CASE( DemoBoards )
+{
+    for( const auto& demo : s_demoBoards )
+    {
+        BOOST_TEST_CONTEXT( demo.second )
+        {
+            std::unique_ptr<BOARD> board = loadDemoBoard( demo.first, demo.second );
+
+            BOOST_REQUIRE( board );
+            checkSameMarkers( *board );
+        }
+    }
+}
+
+
+/**
+ * The demo boards are (mostly) DRC clean: move some of their tracks, so that the markers
+ * of all kinds of track errors are compared too
+ */
+BOOST_AUTO_TEST_CASE( MovedTracks )
+{
+    for( const auto& demo : s_demoBoards )
+    {
+        BOOST_TEST_CONTEXT( demo.second )
+        {
+            std::unique_ptr<BOARD> board = loadDemoBoard( demo.first, demo.second );
+
+            BOOST_REQUIRE( board );
+
+            int ii = 0;
+
+            for( TRACK* track = board->m_Track; track; track = track->Next() )
+            {
+                if( ii++ % 7 == 0 )
+                    track->Move( wxPoint( Millimeter2iu( 0.2 ), Millimeter2iu( 0.1 ) ) );
+            }
+
+            checkSameMarkers( *board );
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
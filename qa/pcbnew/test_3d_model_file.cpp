@@ -0,0 +1,263 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <wx/filefn.h>
+#include <wx/filename.h>
+
+#include <3d_cache/3d_model_file.h>
+
+
+static const std::string s_pluginInfo = "PLUGIN_VRML:2.0.0";
+
+
+/**
+ * A model of two materials and two meshes: a quad with all the vertex arrays, and a triangle
+ * with positions only
+ */
+struct MODEL_FILE_FIXTURE
+{
+    MODEL_FILE_FIXTURE() :
+        m_positions{ SFVEC3F( 0, 0, 0 ), SFVEC3F( 1, 0, 0 ), SFVEC3F( 1, 1, 0 ),
+                     SFVEC3F( 0, 1, 0 ) },
+        m_normals( 4, SFVEC3F( 0, 0, 1 ) ),
+        m_texcoords{ SFVEC2F( 0, 0 ), SFVEC2F( 1, 0 ), SFVEC2F( 1, 1 ), SFVEC2F( 0, 1 ) },
+        m_colors{ SFVEC3F( 1, 0, 0 ), SFVEC3F( 0, 1, 0 ), SFVEC3F( 0, 0, 1 ),
+                  SFVEC3F( 1, 1, 1 ) },
+        m_quadFaces{ 0, 1, 2, 0, 2, 3 },
+        m_triangleFaces{ 2, 1, 0 },
+        m_materials( 2 ),
+        m_meshes( 2 )
+    {
+        for( size_t ii = 0; ii < m_materials.size(); ++ii )
+        {
+            SMATERIAL& material = m_materials[ii];
+
+            material.m_Ambient = SFVEC3F( 0.1f * ii );
+            material.m_Diffuse = SFVEC3F( 0.2f, 0.3f, 0.4f + ii );
+            material.m_Emissive = SFVEC3F( 0.0f );
+            material.m_Specular = SFVEC3F( 0.5f );
+            material.m_Shininess = 0.6f;
+            material.m_Transparency = 0.25f * ii;
+        }
+
+        SMESH& quad = m_meshes[0];
+
+        quad.m_VertexSize = m_positions.size();
+        quad.m_Positions = m_positions.data();
+        quad.m_Normals = m_normals.data();
+        quad.m_Texcoords = m_texcoords.data();
+        quad.m_Color = m_colors.data();
+        quad.m_FaceIdxSize = m_quadFaces.size();
+        quad.m_FaceIdx = m_quadFaces.data();
+        quad.m_MaterialIdx = 1;
+
+        SMESH& triangle = m_meshes[1];
+
+        triangle.m_VertexSize = 3;
+        triangle.m_Positions = m_positions.data();
+        triangle.m_Normals = nullptr;
+        triangle.m_Texcoords = nullptr;
+        triangle.m_Color = nullptr;
+        triangle.m_FaceIdxSize = m_triangleFaces.size();
+        triangle.m_FaceIdx = m_triangleFaces.data();
+        triangle.m_MaterialIdx = 0;
+
+        m_model.m_MeshesSize = m_meshes.size();
+        m_model.m_Meshes = m_meshes.data();
+        m_model.m_MaterialsSize = m_materials.size();
+        m_model.m_Materials = m_materials.data();
+
+        m_fileName = wxFileName::CreateTempFileName( wxT( "qa_3dm" ) );
+    }
+
+    ~MODEL_FILE_FIXTURE()
+    {
+        wxRemoveFile( m_fileName );
+    }
+
+    std::string readFile() const
+    {
+        std::ifstream file( m_fileName.fn_str(), std::ios::binary );
+
+        return std::string( std::istreambuf_iterator<char>( file ),
+                            std::istreambuf_iterator<char>() );
+    }
+
+    void writeFile( const std::string& aData ) const
+    {
+        std::ofstream file( m_fileName.fn_str(), std::ios::binary | std::ios::trunc );
+
+        file.write( aData.data(), aData.size() );
+    }
+
+    /**
+     * Read the file, and check it is rejected as a whole
+     */
+    void checkRejected()
+    {
+        S3D_MODEL_FILE modelFile;
+
+        BOOST_CHECK( !modelFile.Read( m_fileName ) );
+        BOOST_CHECK( modelFile.GetModel() == nullptr );
+    }
+
+    template<typename T>
+    static void checkArray( const T* aExpected, const T* aRead, unsigned int aSize )
+    {
+        BOOST_REQUIRE_EQUAL( aExpected == nullptr, aRead == nullptr );
+
+        if( aExpected )
+        {
+            BOOST_CHECK( std::vector<T>( aExpected, aExpected + aSize )
+                         == std::vector<T>( aRead, aRead + aSize ) );
+        }
+    }
+
+    std::vector<SFVEC3F>      m_positions;
+    std::vector<SFVEC3F>      m_normals;
+    std::vector<SFVEC2F>      m_texcoords;
+    std::vector<SFVEC3F>      m_colors;
+    std::vector<unsigned int> m_quadFaces;
+    std::vector<unsigned int> m_triangleFaces;
+    std::vector<SMATERIAL>    m_materials;
+    std::vector<SMESH>        m_meshes;
+    S3DMODEL                  m_model;
+
+    wxString                  m_fileName;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( ModelFile3D, MODEL_FILE_FIXTURE )
+
+
+/**
+ * A model read back is the model written, whichever vertex arrays its meshes have
+ */
+BOOST_AUTO_TEST_CASE( RoundTrip )
+{
+    BOOST_REQUIRE( S3D_MODEL_FILE::Write( m_fileName, m_model, s_pluginInfo ) );
+
+    S3D_MODEL_FILE modelFile;
+
+    BOOST_REQUIRE( modelFile.Read( m_fileName ) );
+    BOOST_CHECK_EQUAL( modelFile.GetPluginInfo(), s_pluginInfo );
+
+    const S3DMODEL* model = modelFile.GetModel();
+
+    BOOST_REQUIRE( model );
+    BOOST_REQUIRE_EQUAL( model->m_MaterialsSize, m_model.m_MaterialsSize );
+    BOOST_REQUIRE_EQUAL( model->m_MeshesSize, m_model.m_MeshesSize );
+
+    for( unsigned int ii = 0; ii < m_model.m_MaterialsSize; ++ii )
+    {
+        BOOST_TEST_CONTEXT( "Material " << ii )
+        {
+            const SMATERIAL& expected = m_model.m_Materials[ii];
+            const SMATERIAL& read = model->m_Materials[ii];
+
+            BOOST_CHECK( read.m_Ambient == expected.m_Ambient );
+            BOOST_CHECK( read.m_Diffuse == expected.m_Diffuse );
+            BOOST_CHECK( read.m_Emissive == expected.m_Emissive );
+            BOOST_CHECK( read.m_Specular == expected.m_Specular );
+            BOOST_CHECK_EQUAL( read.m_Shininess, expected.m_Shininess );
+            BOOST_CHECK_EQUAL( read.m_Transparency, expected.m_Transparency );
+        }
+    }
+
+    for( unsigned int ii = 0; ii < m_model.m_MeshesSize; ++ii )
+    {
+        BOOST_TEST_CONTEXT( "Mesh " << ii )
+        {
+            const SMESH& expected = m_model.m_Meshes[ii];
+            const SMESH& read = model->m_Meshes[ii];
+
+            BOOST_REQUIRE_EQUAL( read.m_VertexSize, expected.m_VertexSize );
+            BOOST_REQUIRE_EQUAL( read.m_FaceIdxSize, expected.m_FaceIdxSize );
+            BOOST_CHECK_EQUAL( read.m_MaterialIdx, expected.m_MaterialIdx );
+
+            checkArray( expected.m_Positions, read.m_Positions, expected.m_VertexSize );
+            checkArray( expected.m_Normals, read.m_Normals, expected.m_VertexSize );
+            checkArray( expected.m_Texcoords, read.m_Texcoords, expected.m_VertexSize );
+            checkArray( expected.m_Color, read.m_Color, expected.m_VertexSize );
+            checkArray( expected.m_FaceIdx, read.m_FaceIdx, expected.m_FaceIdxSize );
+        }
+    }
+}
+
+
+/**
+ * A file cut anywhere, from its header to its last index, is rejected
+ */
+BOOST_AUTO_TEST_CASE( Truncated )
+{
+    BOOST_REQUIRE( S3D_MODEL_FILE::Write( m_fileName, m_model, s_pluginInfo ) );
+
+    const std::string data = readFile();
+
+    BOOST_REQUIRE( !data.empty() );
+
+    for( size_t size = 0; size < data.size(); ++size )
+    {
+        BOOST_TEST_CONTEXT( "Size " << size << " of " << data.size() )
+        {
+            writeFile( data.substr( 0, size ) );
+            checkRejected();
+        }
+    }
+}
+
+
+/**
+ * A mesh using a material which does not exist rejects the file
+ */
+BOOST_AUTO_TEST_CASE( BadMaterialIndex )
+{
+    m_meshes[1].m_MaterialIdx = m_model.m_MaterialsSize;
+
+    BOOST_REQUIRE( S3D_MODEL_FILE::Write( m_fileName, m_model, s_pluginInfo ) );
+
+    checkRejected();
+}
+
+
+/**
+ * A face using a vertex which does not exist rejects the file
+ */
+BOOST_AUTO_TEST_CASE( BadFaceIndex )
+{
+    m_triangleFaces[1] = m_meshes[1].m_VertexSize;
+
+    BOOST_REQUIRE( S3D_MODEL_FILE::Write( m_fileName, m_model, s_pluginInfo ) );
+
+    checkRejected();
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,210 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <algorithm>
+
+#include <wx/ffile.h>
+#include <wx/filename.h>
+
+#include <class_board.h>
+#include <kicad_plugin.h>
+#include <pcb_parser.h>
+#include <richio.h>
+
+
+/**
+ * A board with enough footprints, tracks, vias and zones to be parsed by several threads.
+ * Tracks are not sorted by net, so that their insertion order matters.
+ */
+static std::string buildBoardText( int aItemCount )
+{
+    const int   netCount = 20;
+    std::string text;
+
+    text += "(kicad_pcb (version 20171130) (host pcbnew 5.1.0)\n"
+            "  (general (thickness 1.6))\n"
+            "  (page A4)\n"
+            "  (layers\n"
+            "    (0 F.Cu signal)\n"
+            "    (31 B.Cu signal)\n"
+            "    (37 F.SilkS user)\n"
+            "    (44 Edge.Cuts user)\n"
+            "  )\n"
+            "  (net 0 \"\")\n";
+
+    for( int net = 1; net < netCount; ++net )
+        text += StrPrintf( "  (net %d \"Net-(R%d-Pad1)\")\n", net, net );
+
+    text += "  (gr_line (start 0 0) (end 100 0) (layer Edge.Cuts) (width 0.1))\n";
+
+    for( int ii = 0; ii < aItemCount; ++ii )
+    {
+        int net = 1 + ( ii * 7 ) % ( netCount - 1 );
+
+        text += StrPrintf( "  (module R_0603 (layer F.Cu) (tedit 0) (tstamp %X)\n"
+                           "    (at %d.5 %d)\n"
+                           "    (fp_text reference R%d (at 0 -1.5) (layer F.SilkS)\n"
+                           "      (effects (font (size 1 1) (thickness 0.15)))\n"
+                           "    )\n"
+                           "    (pad 1 smd rect (at -0.8 0) (size 0.8 0.8) (layers F.Cu)\n"
+                           "      (net %d \"Net-(R%d-Pad1)\"))\n"
+                           "  )\n",
+                           ii + 1, ii % 50, ii / 50, ii, net, net );
+
+        text += StrPrintf( "  (segment (start %d 0.25) (end %d 5) (width 0.25) (layer B.Cu) "
+                           "(net %d) (tstamp %X))\n",
+                           ii, ii + 1, net, ii + 1 );
+
+        if( ii % 5 == 0 )
+        {
+            text += StrPrintf( "  (via (at %d 5) (size 0.8) (drill 0.4) (layers F.Cu B.Cu) "
+                               "(net %d))\n",
+                               ii + 1, net );
+        }
+
+        if( ii % 50 == 0 )
+        {
+            text += StrPrintf( "  (zone (net %d) (net_name \"Net-(R%d-Pad1)\") (layer B.Cu) "
+                               "(tstamp 0) (hatch edge 0.508)\n"
+                               "    (connect_pads (clearance 0.508))\n"
+                               "    (min_thickness 0.254)\n"
+                               "    (fill (arc_segments 32) (thermal_gap 0.508) "
+                               "(thermal_bridge_width 0.508))\n"
+                               "    (polygon\n"
+                               "      (pts\n"
+                               "        (xy %d 10) (xy %d 10) (xy %d 20) (xy %d 20)\n"
+                               "      )\n"
+                               "    )\n"
+                               "  )\n",
+                               net, net, ii, ii + 40, ii + 40, ii );
+        }
+    }
+
+    text += ")\n";
+
+    return text;
+}
+
+
+/**
+ * Parse a board sequentially, reading it line by line
+ */
+static std::unique_ptr<BOARD> parseSequentially( const std::string& aText )
+{
+    STRING_LINE_READER reader( aText, wxT( "test board" ) );
+    PCB_PARSER         parser( &reader );
+
+    return std::unique_ptr<BOARD>( dynamic_cast<BOARD*>( parser.Parse() ) );
+}
+
+
+/**
+ * Save a board in a temporary file, and load it with PCB_IO, which reads it in parallel
+ */
+static std::unique_ptr<BOARD> loadInParallel( const std::string& aText )
+{
+    wxString fileName = wxFileName::CreateTempFileName( wxT( "qa_pcbnew" ) );
+    wxFFile  file( fileName, wxT( "wb" ) );
+
+    file.Write( aText.data(), aText.size() );
+    file.Close();
+
+    PCB_IO                 io;
+    std::unique_ptr<BOARD> board;
+
+    try
+    {
+        board.reset( io.Load( fileName, nullptr ) );
+    }
+    catch( ... )
+    {
+        wxRemoveFile( fileName );
+        throw;
+    }
+
+    wxRemoveFile( fileName );
+    return board;
+}
+
+
+static std::string formatBoard( BOARD* aBoard )
+{
+    PCB_IO io;
+
+    io.Format( aBoard );
+    return io.GetStringOutput( true );
+}
+
+
+BOOST_AUTO_TEST_SUITE( BoardParallelLoad )
+
+
+/**
+ * Check the board loaded in parallel is the one loaded sequentially, item for item
+ */
+BOOST_AUTO_TEST_CASE( SameBoard )
+{
+    const std::string text = buildBoardText( 1000 );
+
+    std::unique_ptr<BOARD> expected = parseSequentially( text );
+    std::unique_ptr<BOARD> board = loadInParallel( text );
+
+    BOOST_REQUIRE( expected );
+    BOOST_REQUIRE( board );
+
+    BOOST_CHECK_EQUAL( board->m_Modules.GetCount(), expected->m_Modules.GetCount() );
+    BOOST_CHECK_EQUAL( board->m_Track.GetCount(), expected->m_Track.GetCount() );
+    BOOST_CHECK_EQUAL( board->GetAreaCount(), expected->GetAreaCount() );
+
+    BOOST_CHECK( formatBoard( board.get() ) == formatBoard( expected.get() ) );
+}
+
+
+/**
+ * Check an error in an item parsed by a worker thread is reported at the right line
+ */
+BOOST_AUTO_TEST_CASE( ErrorLine )
+{
+    std::string text = buildBoardText( 200 );
+    size_t      pos = text.find( "(segment (start 150 " );
+
+    BOOST_REQUIRE( pos != std::string::npos );
+    text.replace( pos, 8, "(segment (bogus 1)" );
+
+    int line = 1 + std::count( text.begin(), text.begin() + pos, '\n' );
+
+    try
+    {
+        loadInParallel( text );
+        BOOST_ERROR( "No error for an invalid segment" );
+    }
+    catch( const PARSE_ERROR& error )
+    {
+        BOOST_CHECK_EQUAL( error.lineNumber, line );
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
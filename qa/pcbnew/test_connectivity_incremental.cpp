@@ -0,0 +1,329 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <algorithm>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <class_board.h>
+#include <class_track.h>
+#include <connectivity/connectivity_algo.h>
+#include <convert_to_biu.h>
+#include <kicad_plugin.h>
+
+#include "board_test_utils.h"
+
+
+/**
+ * Describe the ratsnest clusters, independently of their order and of the order of their
+ * items, so that two searches can be compared
+ */
+static std::vector<std::string> describeClusters( const CN_CONNECTIVITY_ALGO::CLUSTERS& aClusters )
+{
+    std::vector<std::string> descriptions;
+
+    for( const auto& cluster : aClusters )
+    {
+        std::vector<const BOARD_CONNECTED_ITEM*> parents;
+
+        for( auto item : *cluster )
+        {
+            BOOST_CHECK( item->Valid() );
+            parents.push_back( item->Parent() );
+        }
+
+        std::sort( parents.begin(), parents.end() );
+
+        std::ostringstream description;
+
+        description << "net " << ( *cluster->begin() )->Net() << " (origin "
+                    << cluster->OriginNet() << "):";
+
+        for( auto parent : parents )
+            description << " " << parent;
+
+        descriptions.push_back( description.str() );
+    }
+
+    std::sort( descriptions.begin(), descriptions.end() );
+
+    return descriptions;
+}
+
+
+struct CONNECTIVITY_INCREMENTAL_FIXTURE
+{
+    CONNECTIVITY_INCREMENTAL_FIXTURE()
+    {
+        wxFileName fn = KI_TEST::GetDemosDir();
+
+        fn.AppendDir( "pic_programmer" );
+        fn.SetFullName( "pic_programmer.kicad_pcb" );
+
+        PCB_IO io;
+
+        m_board.reset( io.Load( fn.GetFullPath(), nullptr ) );
+
+        BOOST_REQUIRE( m_board );
+
+        for( auto track : m_board->Tracks() )
+        {
+            if( track->Type() == PCB_TRACE_T && track->GetNetCode() > 0 )
+                m_tracks.push_back( track );
+        }
+
+        BOOST_REQUIRE( m_tracks.size() > 100 );
+
+        m_algo.Build( m_board.get() );
+        update();
+    }
+
+    /**
+     * Update the clusters as CONNECTIVITY_DATA::RecalculateRatsnest() does
+     */
+    void update()
+    {
+        m_algo.PropagateNets();
+        m_algo.GetClusters();
+        m_algo.ClearDirtyFlags();
+    }
+
+    /**
+     * Check the clusters kept by the incremental updates are the ones of a full build
+     */
+    void checkMatchesFullBuild()
+    {
+        update();
+
+        CN_CONNECTIVITY_ALGO full;
+
+        full.Build( m_board.get() );
+
+        const auto& clusters = m_algo.GetClusters();
+        const auto& expected = full.GetClusters();
+
+        // A stale cluster holds deleted items: do not look into it
+        BOOST_REQUIRE_EQUAL( clusters.size(), expected.size() );
+
+        std::vector<std::string> descriptions = describeClusters( clusters );
+        std::vector<std::string> expectedDescriptions = describeClusters( expected );
+
+        BOOST_CHECK_EQUAL_COLLECTIONS( descriptions.begin(), descriptions.end(),
+                                       expectedDescriptions.begin(), expectedDescriptions.end() );
+    }
+
+    /**
+     * Add a track far from the other items, the only item of its cluster
+     */
+    TRACK* addIsolatedTrack( int aNetCode )
+    {
+        TRACK* track = new TRACK( m_board.get() );
+
+        track->SetLayer( B_Cu );
+        track->SetStart( wxPoint( Millimeter2iu( -100 ), Millimeter2iu( -100 ) ) );
+        track->SetEnd( wxPoint( Millimeter2iu( -90 ), Millimeter2iu( -100 ) ) );
+        track->SetWidth( Millimeter2iu( 0.25 ) );
+        track->SetNetCode( aNetCode );
+
+        m_board->Add( track );
+        m_algo.Add( track );
+
+        return track;
+    }
+
+    void removeTrack( TRACK* aTrack )
+    {
+        m_algo.Remove( aTrack );
+        m_board->Remove( aTrack );
+        delete aTrack;
+    }
+
+    /**
+     * @return a net of the board, other than aNetCode
+     */
+    int otherNet( int aNetCode )
+    {
+        for( TRACK* track : m_tracks )
+        {
+            if( track->GetNetCode() != aNetCode )
+                return track->GetNetCode();
+        }
+
+        BOOST_FAIL( "The board has a single net" );
+        return 0;
+    }
+
+    std::unique_ptr<BOARD> m_board;
+    std::vector<TRACK*>    m_tracks;
+    CN_CONNECTIVITY_ALGO   m_algo;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( ConnectivityIncremental, CONNECTIVITY_INCREMENTAL_FIXTURE )
+
+
+BOOST_AUTO_TEST_CASE( NoChange )
+{
+    checkMatchesFullBuild();
+}
+
+
+/**
+ * Tracks added over existing ones join their clusters
+ */
+BOOST_AUTO_TEST_CASE( TracksAdded )
+{
+    for( size_t ii = 0; ii < m_tracks.size(); ii += 10 )
+    {
+        TRACK* track = static_cast<TRACK*>( m_tracks[ii]->Clone() );
+
+        track->Move( wxPoint( Millimeter2iu( 0.05 ), 0 ) );
+        m_board->Add( track );
+        m_algo.Add( track );
+    }
+
+    checkMatchesFullBuild();
+}
+
+
+/**
+ * Removing tracks splits clusters
+ */
+BOOST_AUTO_TEST_CASE( TracksRemoved )
+{
+    for( size_t ii = 0; ii < m_tracks.size(); ii += 10 )
+        removeTrack( m_tracks[ii] );
+
+    checkMatchesFullBuild();
+}
+
+
+/**
+ * Tracks updated (removed and added again) after changing their nets, as a commit does
+ */
+BOOST_AUTO_TEST_CASE( NetsChanged )
+{
+    for( size_t ii = 0; ii < m_tracks.size(); ii += 10 )
+    {
+        TRACK* track = m_tracks[ii];
+
+        track->SetNetCode( otherNet( track->GetNetCode() ) );
+        m_algo.Remove( track );
+        m_algo.Add( track );
+    }
+
+    checkMatchesFullBuild();
+}
+
+
+/**
+ * An item whose net changed before it was removed: the cluster of its previous net, which
+ * is not the net marked dirty by Remove(), must not be kept
+ */
+BOOST_AUTO_TEST_CASE( NetChangedBeforeRemove )
+{
+    int    net = m_tracks[0]->GetNetCode();
+    TRACK* track = addIsolatedTrack( net );
+
+    checkMatchesFullBuild();
+
+    track->SetNetCode( otherNet( net ) );
+    removeTrack( track );
+
+    checkMatchesFullBuild();
+}
+
+
+/**
+ * An item whose net changed without being updated is found in its new net as soon as this
+ * net is searched again: it must leave the cluster of its previous net
+ */
+BOOST_AUTO_TEST_CASE( NetChangedWithoutUpdate )
+{
+    int    net = m_tracks[0]->GetNetCode();
+    int    newNet = otherNet( net );
+    TRACK* track = addIsolatedTrack( net );
+
+    checkMatchesFullBuild();
+
+    track->SetNetCode( newNet );
+
+    // Update another item of the new net, so that it is searched again
+    for( TRACK* other : m_tracks )
+    {
+        if( other->GetNetCode() == newNet )
+        {
+            m_algo.Remove( other );
+            m_algo.Add( other );
+            break;
+        }
+    }
+
+    checkMatchesFullBuild();
+
+    removeTrack( track );
+
+    checkMatchesFullBuild();
+}
+
+
+/**
+ * A sequence of edits, each checked against a full build
+ */
+BOOST_AUTO_TEST_CASE( EditSequence )
+{
+    for( size_t ii = 0; ii < 20; ++ii )
+    {
+        TRACK* track = m_tracks[( ii * 37 ) % m_tracks.size()];
+
+        BOOST_TEST_CONTEXT( "Edit " << ii )
+        {
+            switch( ii % 3 )
+            {
+            case 0:
+                track->Move( wxPoint( Millimeter2iu( 1 ), 0 ) );
+                break;
+
+            case 1:
+                track->Move( wxPoint( Millimeter2iu( -1 ), 0 ) );
+                break;
+
+            default:
+                track->SetNetCode( otherNet( track->GetNetCode() ) );
+                break;
+            }
+
+            m_algo.Remove( track );
+            m_algo.Add( track );
+
+            checkMatchesFullBuild();
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
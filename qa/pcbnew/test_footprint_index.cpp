@@ -0,0 +1,210 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <algorithm>
+
+#include <wx/ffile.h>
+#include <wx/filename.h>
+
+#include <footprint_index.h>
+#include <kicad_plugin.h>
+
+
+struct FOOTPRINT_INDEX_FIXTURE
+{
+    FOOTPRINT_INDEX_FIXTURE()
+    {
+        m_dir = wxFileName::CreateTempFileName( wxT( "qa_fp_index" ) );
+        wxRemoveFile( m_dir );
+        wxFileName::Mkdir( m_dir );
+
+        m_indexFile = wxFileName( m_dir, wxT( "test.idx" ) ).GetFullPath();
+        m_libPath = wxFileName( m_dir, wxT( "test.pretty" ) ).GetFullPath();
+        wxFileName::Mkdir( m_libPath );
+
+        // Keep the index files of the plugin out of the user's cache
+        wxGetEnv( wxT( "XDG_CACHE_HOME" ), &m_cacheHome );
+        wxSetEnv( wxT( "XDG_CACHE_HOME" ), m_dir );
+    }
+
+    ~FOOTPRINT_INDEX_FIXTURE()
+    {
+        wxSetEnv( wxT( "XDG_CACHE_HOME" ), m_cacheHome );
+        wxFileName::Rmdir( m_dir, wxPATH_RMDIR_RECURSIVE );
+    }
+
+    void writeFootprint( const wxString& aName, const char* aDescription, int aPadCount )
+    {
+        std::string text = StrPrintf( "(module %s (layer F.Cu) (tedit 0)\n"
+                                      "  (descr \"%s\")\n"
+                                      "  (tags \"r res\")\n",
+                                      TO_UTF8( aName ), aDescription );
+
+        for( int ii = 1; ii <= aPadCount; ++ii )
+        {
+            text += StrPrintf( "  (pad %d smd rect (at %d 0) (size 1 1) (layers F.Cu))\n",
+                               ii, ii );
+        }
+
+        text += ")\n";
+
+        wxFFile file( wxFileName( m_libPath, aName, wxT( "kicad_mod" ) ).GetFullPath(),
+                      wxT( "wb" ) );
+
+        file.Write( text.data(), text.size() );
+    }
+
+    wxString m_dir;
+    wxString m_indexFile;
+    wxString m_libPath;
+    wxString m_cacheHome;
+};
+
+
+static FOOTPRINT_INDEX_ENTRY makeEntry( const wxString& aName, long long aFileTime )
+{
+    FOOTPRINT_INDEX_ENTRY entry;
+
+    entry.m_name = aName;
+    entry.m_description = wxT( "R\u00e9sistance " ) + aName;
+    entry.m_keywords = wxT( "r res" );
+    entry.m_padCount = 2;
+    entry.m_uniquePadCount = 2;
+    entry.m_fileTime = aFileTime;
+    entry.m_fileSize = 200;
+
+    return entry;
+}
+
+
+BOOST_FIXTURE_TEST_SUITE( FootprintIndex, FOOTPRINT_INDEX_FIXTURE )
+
+
+BOOST_AUTO_TEST_CASE( RoundTrip )
+{
+    FOOTPRINT_INDEX index( m_libPath );
+
+    index.Add( makeEntry( wxT( "R_0402" ), 1000 ) );
+    index.Add( makeEntry( wxT( "R_0603" ), 2000 ) );
+
+    BOOST_REQUIRE( index.Write( m_indexFile ) );
+
+    FOOTPRINT_INDEX read( m_libPath );
+
+    BOOST_REQUIRE( read.Read( m_indexFile ) );
+    BOOST_REQUIRE_EQUAL( read.GetEntries().size(), 2u );
+
+    const FOOTPRINT_INDEX_ENTRY* entry = read.Find( wxT( "R_0603" ), 2000, 200 );
+
+    BOOST_REQUIRE( entry );
+    BOOST_CHECK( entry->m_description == wxT( "R\u00e9sistance R_0603" ) );
+    BOOST_CHECK( entry->m_keywords == wxT( "r res" ) );
+    BOOST_CHECK_EQUAL( entry->m_padCount, 2u );
+    BOOST_CHECK_EQUAL( entry->m_uniquePadCount, 2u );
+
+    // Changed files are not found
+    BOOST_CHECK( !read.Find( wxT( "R_0603" ), 2001, 200 ) );
+    BOOST_CHECK( !read.Find( wxT( "R_0603" ), 2000, 201 ) );
+    BOOST_CHECK( !read.Find( wxT( "R_0805" ), 2000, 200 ) );
+}
+
+
+/**
+ * Indexes of other libraries, and damaged indexes, are ignored
+ */
+BOOST_AUTO_TEST_CASE( InvalidIndex )
+{
+    FOOTPRINT_INDEX index( m_libPath );
+
+    index.Add( makeEntry( wxT( "R_0402" ), 1000 ) );
+    BOOST_REQUIRE( index.Write( m_indexFile ) );
+
+    FOOTPRINT_INDEX other( m_libPath + wxT( "2" ) );
+
+    BOOST_CHECK( !other.Read( m_indexFile ) );
+    BOOST_CHECK( other.GetEntries().empty() );
+
+    wxFFile file( m_indexFile, wxT( "rb" ) );
+    std::vector<char> data( file.Length() );
+
+    file.Read( data.data(), data.size() );
+    file.Close();
+
+    file.Open( m_indexFile, wxT( "wb" ) );
+    file.Write( data.data(), data.size() - 1 );
+    file.Close();
+
+    FOOTPRINT_INDEX truncated( m_libPath );
+
+    BOOST_CHECK( !truncated.Read( m_indexFile ) );
+    BOOST_CHECK( truncated.GetEntries().empty() );
+
+    BOOST_CHECK( !truncated.Read( m_indexFile + wxT( ".missing" ) ) );
+}
+
+
+/**
+ * The plugin indexes a library, and only updates the entries of the files which changed
+ */
+BOOST_AUTO_TEST_CASE( PluginIndex )
+{
+    writeFootprint( wxT( "R_0402" ), "small", 2 );
+    writeFootprint( wxT( "SOIC_8" ), "package", 8 );
+
+    PCB_IO                             io;
+    std::vector<FOOTPRINT_INDEX_ENTRY> entries;
+
+    io.EnumerateFootprintIndex( entries, m_libPath );
+
+    BOOST_REQUIRE_EQUAL( entries.size(), 2u );
+    BOOST_CHECK( wxFileExists( FOOTPRINT_INDEX::GetFileName( m_libPath ) ) );
+
+    // A longer description, so that the file size changes even within the same second
+    writeFootprint( wxT( "SOIC_8" ), "small outline package", 8 );
+
+    entries.clear();
+    io.EnumerateFootprintIndex( entries, m_libPath );
+
+    BOOST_REQUIRE_EQUAL( entries.size(), 2u );
+
+    std::sort( entries.begin(), entries.end(),
+               []( const FOOTPRINT_INDEX_ENTRY& a, const FOOTPRINT_INDEX_ENTRY& b )
+               {
+                   return a.m_name < b.m_name;
+               } );
+
+    BOOST_CHECK( entries[0].m_name == wxT( "R_0402" ) );
+    BOOST_CHECK( entries[0].m_description == wxT( "small" ) );
+    BOOST_CHECK_EQUAL( entries[0].m_padCount, 2u );
+
+    BOOST_CHECK( entries[1].m_name == wxT( "SOIC_8" ) );
+    BOOST_CHECK( entries[1].m_description == wxT( "small outline package" ) );
+    BOOST_CHECK( entries[1].m_keywords == wxT( "r res" ) );
+    BOOST_CHECK_EQUAL( entries[1].m_padCount, 8u );
+    BOOST_CHECK_EQUAL( entries[1].m_uniquePadCount, 8u );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
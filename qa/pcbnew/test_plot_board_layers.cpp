@@ -0,0 +1,228 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <fstream>
+#include <memory>
+#include <vector>
+
+#include <wx/filefn.h>
+#include <wx/filename.h>
+
+#include <class_board.h>
+#include <common.h>
+#include <kicad_plugin.h>
+#include <pcb_plot_params.h>
+#include <pcbplot.h>
+#include <plotter.h>
+
+#include "board_test_utils.h"
+
+
+/**
+ * The layers plotted from the demo board: copper, with pads, tracks and zones, and the
+ * technical layers, with texts and graphics
+ */
+static const PCB_LAYER_ID s_layers[] = {
+    F_Cu, B_Cu, F_SilkS, B_SilkS, F_Mask, B_Mask, F_Paste, Edge_Cuts
+};
+
+
+struct PLOT_BOARD_LAYERS_FIXTURE
+{
+    PLOT_BOARD_LAYERS_FIXTURE()
+    {
+        wxFileName fn = KI_TEST::GetDemosDir();
+
+        fn.AppendDir( "pic_programmer" );
+        fn.SetFullName( "pic_programmer.kicad_pcb" );
+
+        PCB_IO io;
+
+        m_board.reset( io.Load( fn.GetFullPath(), nullptr ) );
+
+        // Both ways plot to files of the same names (SVG files hold their own name), in
+        // their own directory
+        m_parallelDir = makeTempDir();
+        m_sequentialDir = makeTempDir();
+    }
+
+    ~PLOT_BOARD_LAYERS_FIXTURE()
+    {
+        wxFileName::Rmdir( m_parallelDir, wxPATH_RMDIR_RECURSIVE );
+        wxFileName::Rmdir( m_sequentialDir, wxPATH_RMDIR_RECURSIVE );
+    }
+
+    static wxString makeTempDir()
+    {
+        wxString dir = wxFileName::CreateTempFileName( wxT( "qa_plot" ) );
+
+        wxRemoveFile( dir );
+        wxMkdir( dir );
+
+        return dir;
+    }
+
+    std::vector<PLOT_LAYER_JOB> makeJobs( const wxString& aDir, const wxString& aExtension )
+    {
+        std::vector<PLOT_LAYER_JOB> jobs;
+
+        for( PCB_LAYER_ID layer : s_layers )
+        {
+            wxString name = BOARD::GetStandardLayerName( layer );
+
+            name.Replace( wxT( "." ), wxT( "_" ) );
+            jobs.push_back( { layer, wxFileName( aDir, name, aExtension ).GetFullPath(), false } );
+        }
+
+        return jobs;
+    }
+
+    /**
+     * Plot the layers one after the other, as the plot dialog used to
+     */
+    void plotSequentially( PCB_PLOT_PARAMS& aOpts, std::vector<PLOT_LAYER_JOB>& aJobs )
+    {
+        LOCALE_IO toggle;
+
+        for( PLOT_LAYER_JOB& job : aJobs )
+        {
+            PLOTTER* plotter = StartPlotBoard( m_board.get(), &aOpts, job.m_Layer,
+                                               job.m_FileName, wxEmptyString );
+
+            job.m_Plotted = plotter != nullptr;
+
+            if( plotter )
+            {
+                PlotOneBoardLayer( m_board.get(), plotter, job.m_Layer, aOpts );
+                plotter->EndPlot();
+                delete plotter;
+            }
+        }
+    }
+
+    /**
+     * Plot the board both ways, and check the files are the same
+     */
+    void checkSamePlots( PlotFormat aFormat, const wxString& aExtension )
+    {
+        BOOST_REQUIRE( m_board );
+
+        PCB_PLOT_PARAMS opts;
+
+        opts.SetFormat( aFormat );
+        opts.SetPlotFrameRef( false );
+
+        std::vector<PLOT_LAYER_JOB> parallel = makeJobs( m_parallelDir, aExtension );
+        std::vector<PLOT_LAYER_JOB> sequential = makeJobs( m_sequentialDir, aExtension );
+
+        PlotBoardLayers( m_board.get(), &opts, parallel );
+        plotSequentially( opts, sequential );
+
+        for( size_t ii = 0; ii < parallel.size(); ++ii )
+        {
+            BOOST_TEST_CONTEXT( "Layer " << BOARD::GetStandardLayerName( parallel[ii].m_Layer ) )
+            {
+                BOOST_REQUIRE( parallel[ii].m_Plotted );
+                BOOST_REQUIRE( sequential[ii].m_Plotted );
+
+                std::string expected = readPlot( sequential[ii].m_FileName );
+
+                BOOST_CHECK( !expected.empty() );
+                BOOST_CHECK( readPlot( parallel[ii].m_FileName ) == expected );
+            }
+        }
+    }
+
+    /**
+     * Read a plot file, without the lines holding the date of the plot
+     */
+    static std::string readPlot( const wxString& aFileName )
+    {
+        std::ifstream file( aFileName.fn_str(), std::ios::binary );
+        std::string   line;
+        std::string   data;
+
+        while( std::getline( file, line ) )
+        {
+            if( line.find( "CreationDate" ) != std::string::npos     // Gerber X2, PDF, PS
+                    || line.find( "Created by KiCad" ) != std::string::npos     // Gerber
+                    || line.find( "SVG Picture created as" ) != std::string::npos ) // SVG
+            {
+                continue;
+            }
+
+            data += line;
+            data += '\n';
+        }
+
+        return data;
+    }
+
+    std::unique_ptr<BOARD> m_board;
+    wxString               m_parallelDir;
+    wxString               m_sequentialDir;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( PlotBoardLayers, PLOT_BOARD_LAYERS_FIXTURE )
+
+
+BOOST_AUTO_TEST_CASE( Gerber )
+{
+    checkSamePlots( PLOT_FORMAT_GERBER, wxT( "gbr" ) );
+}
+
+
+BOOST_AUTO_TEST_CASE( PostScript )
+{
+    checkSamePlots( PLOT_FORMAT_POST, wxT( "ps" ) );
+}
+
+
+BOOST_AUTO_TEST_CASE( Pdf )
+{
+    checkSamePlots( PLOT_FORMAT_PDF, wxT( "pdf" ) );
+}
+
+
+BOOST_AUTO_TEST_CASE( Svg )
+{
+    checkSamePlots( PLOT_FORMAT_SVG, wxT( "svg" ) );
+}
+
+
+BOOST_AUTO_TEST_CASE( Dxf )
+{
+    checkSamePlots( PLOT_FORMAT_DXF, wxT( "dxf" ) );
+}
+
+
+BOOST_AUTO_TEST_CASE( Hpgl )
+{
+    checkSamePlots( PLOT_FORMAT_HPGL, wxT( "plt" ) );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
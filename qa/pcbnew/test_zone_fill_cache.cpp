@@ -0,0 +1,301 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <wx/ffile.h>
+#include <wx/filename.h>
+
+#include <class_board.h>
+#include <class_zone.h>
+#include <kicad_plugin.h>
+#include <properties.h>
+#include <zone_fill_cache.h>
+
+
+/**
+ * A board with a few zones, each filled with two polygons
+ */
+static std::string buildBoardText( int aZoneCount )
+{
+    std::string text;
+
+    text += "(kicad_pcb (version 20171130) (host pcbnew 5.1.0)\n"
+            "  (general (thickness 1.6))\n"
+            "  (page A4)\n"
+            "  (layers\n"
+            "    (0 F.Cu signal)\n"
+            "    (31 B.Cu signal)\n"
+            "  )\n"
+            "  (net 0 \"\")\n"
+            "  (net 1 GND)\n";
+
+    for( int ii = 0; ii < aZoneCount; ++ii )
+    {
+        int x = ii * 50;
+
+        text += StrPrintf( "  (zone (net 1) (net_name GND) (layer B.Cu) (tstamp 0) "
+                           "(hatch edge 0.508)\n"
+                           "    (connect_pads (clearance 0.508))\n"
+                           "    (min_thickness 0.254)\n"
+                           "    (fill yes (arc_segments 32) (thermal_gap 0.508) "
+                           "(thermal_bridge_width 0.508))\n"
+                           "    (polygon\n"
+                           "      (pts\n"
+                           "        (xy %d 0) (xy %d 0) (xy %d 40) (xy %d 40)\n"
+                           "      )\n"
+                           "    )\n"
+                           "    (filled_polygon\n"
+                           "      (pts\n"
+                           "        (xy %d 1) (xy %d 1) (xy %d 15) (xy %d.5 19) (xy %d 15)\n"
+                           "      )\n"
+                           "    )\n"
+                           "    (filled_polygon\n"
+                           "      (pts\n"
+                           "        (xy %d 21) (xy %d 21) (xy %d 39) (xy %d 39)\n"
+                           "      )\n"
+                           "    )\n"
+                           "  )\n",
+                           x, x + 40, x + 40, x,
+                           x + 1, x + 39, x + 39, x + 20, x + 1,
+                           x + 1, x + 39, x + 39, x + 1 );
+    }
+
+    text += ")\n";
+
+    return text;
+}
+
+
+struct ZONE_FILL_CACHE_FIXTURE
+{
+    ZONE_FILL_CACHE_FIXTURE()
+    {
+        m_boardFile = wxFileName::CreateTempFileName( wxT( "qa_zone_fills" ) );
+        m_cacheFile = ZONE_FILL_CACHE::GetFileName( m_boardFile );
+        m_cacheProps["zone_fill_cache"] = "";
+    }
+
+    ~ZONE_FILL_CACHE_FIXTURE()
+    {
+        wxRemoveFile( m_boardFile );
+        wxRemoveFile( m_cacheFile );
+    }
+
+    void writeFile( const wxString& aFileName, const std::string& aData )
+    {
+        wxFFile file( aFileName, wxT( "wb" ) );
+
+        file.Write( aData.data(), aData.size() );
+    }
+
+    std::string readFile( const wxString& aFileName )
+    {
+        wxFFile     file( aFileName, wxT( "rb" ) );
+        std::string data( file.Length(), '\0' );
+
+        file.Read( &data[0], data.size() );
+        return data;
+    }
+
+    std::unique_ptr<BOARD> load()
+    {
+        PCB_IO io;
+
+        return std::unique_ptr<BOARD>( io.Load( m_boardFile, nullptr ) );
+    }
+
+    /**
+     * Load the board text, triangulate the fills of its zones as the GAL does, and save it
+     * with its zone fill cache
+     */
+    std::unique_ptr<BOARD> saveWithCache( const std::string& aText )
+    {
+        writeFile( m_boardFile, aText );
+
+        std::unique_ptr<BOARD> board = load();
+        PCB_IO                 io;
+
+        for( ZONE_CONTAINER* zone : board->Zones() )
+            zone->CacheTriangulation();
+
+        io.Save( m_boardFile, board.get(), &m_cacheProps );
+
+        return board;
+    }
+
+    wxString   m_boardFile;
+    wxString   m_cacheFile;
+    PROPERTIES m_cacheProps;
+};
+
+
+static bool sameFill( const SHAPE_POLY_SET& aFill, const SHAPE_POLY_SET& aExpected )
+{
+    if( aFill.OutlineCount() != aExpected.OutlineCount() )
+        return false;
+
+    for( int ii = 0; ii < aFill.OutlineCount(); ++ii )
+    {
+        if( aFill.Polygon( ii ).size() != aExpected.Polygon( ii ).size() )
+            return false;
+
+        for( size_t jj = 0; jj < aFill.Polygon( ii ).size(); ++jj )
+        {
+            if( aFill.Polygon( ii )[jj].CPoints() != aExpected.Polygon( ii )[jj].CPoints() )
+                return false;
+        }
+    }
+
+    return true;
+}
+
+
+BOOST_FIXTURE_TEST_SUITE( ZoneFillCache, ZONE_FILL_CACHE_FIXTURE )
+
+
+/**
+ * A board loaded with its cache has the fills and the triangulations of the saved board
+ */
+BOOST_AUTO_TEST_CASE( RoundTrip )
+{
+    std::unique_ptr<BOARD> saved = saveWithCache( buildBoardText( 20 ) );
+
+    BOOST_REQUIRE( wxFileExists( m_cacheFile ) );
+
+    std::unique_ptr<BOARD> board = load();
+
+    BOOST_REQUIRE( board );
+    BOOST_REQUIRE_EQUAL( board->GetAreaCount(), 20 );
+
+    for( int ii = 0; ii < board->GetAreaCount(); ++ii )
+    {
+        const SHAPE_POLY_SET& fill = board->GetArea( ii )->GetFilledPolysList();
+        const SHAPE_POLY_SET& expected = saved->GetArea( ii )->GetFilledPolysList();
+
+        BOOST_CHECK_EQUAL( fill.OutlineCount(), 2 );
+        BOOST_CHECK( sameFill( fill, expected ) );
+        BOOST_CHECK( fill.IsTriangulationUpToDate() );
+        BOOST_CHECK_EQUAL( fill.TriangulatedPolyCount(), expected.TriangulatedPolyCount() );
+    }
+}
+
+
+/**
+ * The fills of a board matching the cache are the ones of the cache, not of the board file
+ */
+BOOST_AUTO_TEST_CASE( FillsFromCache )
+{
+    std::unique_ptr<BOARD> saved = saveWithCache( buildBoardText( 20 ) );
+
+    // A cache of the board file, with other fills
+    for( ZONE_CONTAINER* zone : saved->Zones() )
+    {
+        SHAPE_POLY_SET fill = zone->GetFilledPolysList();
+
+        fill.Move( VECTOR2I( 1000, 0 ) );
+        zone->SetFilledPolysList( fill );
+    }
+
+    BOOST_REQUIRE( ZONE_FILL_CACHE::Write( saved.get(), m_boardFile ) );
+
+    std::unique_ptr<BOARD> board = load();
+
+    BOOST_REQUIRE_EQUAL( board->GetAreaCount(), 20 );
+
+    for( int ii = 0; ii < board->GetAreaCount(); ++ii )
+    {
+        BOOST_CHECK( sameFill( board->GetArea( ii )->GetFilledPolysList(),
+                               saved->GetArea( ii )->GetFilledPolysList() ) );
+    }
+}
+
+
+/**
+ * A board file changed since the cache was written is read with its own fills, and the
+ * zones whose fills did not change still get their triangulations
+ */
+BOOST_AUTO_TEST_CASE( BoardChanged )
+{
+    std::string text = buildBoardText( 3 );
+
+    saveWithCache( text );
+
+    // Another fill for the second zone
+    std::string changed = readFile( m_boardFile );
+    size_t      pos = changed.find( "(xy 89 39)" );
+
+    BOOST_REQUIRE( pos != std::string::npos );
+    changed.replace( pos, 10, "(xy 88 39)" );
+    writeFile( m_boardFile, changed );
+
+    std::unique_ptr<BOARD> board = load();
+
+    BOOST_REQUIRE_EQUAL( board->GetAreaCount(), 3 );
+
+    const SHAPE_POLY_SET& fill = board->GetArea( 1 )->GetFilledPolysList();
+
+    BOOST_CHECK_EQUAL( fill.COutline( 1 ).CPoint( 2 ).x, 88000000 );
+    BOOST_CHECK( !fill.IsTriangulationUpToDate() );
+
+    BOOST_CHECK( board->GetArea( 0 )->GetFilledPolysList().IsTriangulationUpToDate() );
+    BOOST_CHECK( board->GetArea( 2 )->GetFilledPolysList().IsTriangulationUpToDate() );
+}
+
+
+/**
+ * Damaged caches are ignored, and the cache is removed when saving without it
+ */
+BOOST_AUTO_TEST_CASE( InvalidCache )
+{
+    std::unique_ptr<BOARD> saved = saveWithCache( buildBoardText( 3 ) );
+    std::string            data = readFile( m_cacheFile );
+
+    writeFile( m_cacheFile, data.substr( 0, data.size() - 1 ) );
+
+    ZONE_FILL_CACHE cache;
+    std::string     boardText = readFile( m_boardFile );
+
+    BOOST_CHECK( !cache.Read( m_cacheFile, boardText.data(), boardText.size() ) );
+    BOOST_CHECK( !cache.BoardMatches() );
+
+    std::unique_ptr<BOARD> board = load();
+
+    BOOST_REQUIRE_EQUAL( board->GetAreaCount(), 3 );
+
+    for( int ii = 0; ii < board->GetAreaCount(); ++ii )
+    {
+        const SHAPE_POLY_SET& fill = board->GetArea( ii )->GetFilledPolysList();
+
+        BOOST_CHECK( sameFill( fill, saved->GetArea( ii )->GetFilledPolysList() ) );
+        BOOST_CHECK( !fill.IsTriangulationUpToDate() );
+    }
+
+    PCB_IO io;
+
+    io.Save( m_boardFile, board.get() );
+    BOOST_CHECK( !wxFileExists( m_cacheFile ) );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
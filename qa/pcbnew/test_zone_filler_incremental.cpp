@@ -0,0 +1,269 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_pcb_text.h>
+#include <class_track.h>
+#include <class_zone.h>
+#include <convert_to_biu.h>
+#include <pcb_parser.h>
+#include <richio.h>
+#include <zone_filler.h>
+
+
+/**
+ * Two zones of different nets on F.Cu, GND on the left and VCC on the right, a footprint
+ * and a track of a third net far from both of them, and a text in the GND zone.
+ */
+static const char* s_boardText =
+        "(kicad_pcb (version 20171130) (host pcbnew 5.1.0)\n"
+        "  (general (thickness 1.6))\n"
+        "  (page A4)\n"
+        "  (layers\n"
+        "    (0 F.Cu signal)\n"
+        "    (31 B.Cu signal)\n"
+        "  )\n"
+        "  (net 0 \"\")\n"
+        "  (net 1 GND)\n"
+        "  (net 2 VCC)\n"
+        "  (net 3 SIG)\n"
+        "  (module R_0603 (layer F.Cu) (tedit 0) (tstamp 1)\n"
+        "    (at 150 100)\n"
+        "    (pad 1 smd rect (at 0 0) (size 1 1) (layers F.Cu) (net 3 SIG))\n"
+        "  )\n"
+        "  (segment (start 150 120) (end 160 120) (width 0.25) (layer F.Cu) (net 3) "
+        "(tstamp 2))\n"
+        "  (gr_text AB (at 10 10) (layer F.Cu) (tstamp 5)\n"
+        "    (effects (font (size 1 1) (thickness 0.15)))\n"
+        "  )\n"
+        "  (zone (net 1) (net_name GND) (layer F.Cu) (tstamp 3) (hatch edge 0.508)\n"
+        "    (connect_pads (clearance 0.508))\n"
+        "    (min_thickness 0.254)\n"
+        "    (fill (arc_segments 32) (thermal_gap 0.508) (thermal_bridge_width 0.508))\n"
+        "    (polygon (pts (xy 0 0) (xy 20 0) (xy 20 20) (xy 0 20)))\n"
+        "  )\n"
+        "  (zone (net 2) (net_name VCC) (layer F.Cu) (tstamp 4) (hatch edge 0.508)\n"
+        "    (connect_pads (clearance 0.508))\n"
+        "    (min_thickness 0.254)\n"
+        "    (fill (arc_segments 32) (thermal_gap 0.508) (thermal_bridge_width 0.508))\n"
+        "    (polygon (pts (xy 50 0) (xy 70 0) (xy 70 20) (xy 50 20)))\n"
+        "  )\n"
+        ")\n";
+
+
+struct ZONE_FILLER_INCREMENTAL_FIXTURE
+{
+    ZONE_FILLER_INCREMENTAL_FIXTURE()
+    {
+        STRING_LINE_READER reader( s_boardText, wxT( "test board" ) );
+        PCB_PARSER         parser( &reader );
+
+        m_board.reset( dynamic_cast<BOARD*>( parser.Parse() ) );
+        m_board->BuildConnectivity();
+
+        BOOST_REQUIRE_EQUAL( m_board->GetAreaCount(), 2 );
+
+        m_gnd = m_board->GetArea( 0 );
+        m_vcc = m_board->GetArea( 1 );
+        m_module = m_board->m_Modules.GetFirst();
+        m_track = m_board->m_Track.GetFirst();
+        m_text = nullptr;
+
+        for( BOARD_ITEM* item : m_board->Drawings() )
+        {
+            if( item->Type() == PCB_TEXT_T )
+                m_text = static_cast<TEXTE_PCB*>( item );
+        }
+
+        BOOST_REQUIRE( m_text );
+
+        // Initial fill of all the zones
+        fill();
+
+        BOOST_REQUIRE( m_gnd->IsFilled() );
+        BOOST_REQUIRE( m_vcc->IsFilled() );
+    }
+
+    void fill()
+    {
+        ZONE_FILLER filler( m_board.get() );
+
+        filler.SetIncremental( true );
+        BOOST_REQUIRE( filler.Fill( m_board->Zones() ) );
+    }
+
+    /**
+     * Replace the fill of all the zones by a marker polygon, which stays in a zone the filler
+     * does not refill
+     */
+    void markFills()
+    {
+        for( ZONE_CONTAINER* zone : m_board->Zones() )
+        {
+            SHAPE_POLY_SET marker;
+
+            marker.NewOutline();
+            marker.Append( s_marker );
+            marker.Append( s_marker.x + 10, s_marker.y );
+            marker.Append( s_marker.x, s_marker.y + 10 );
+
+            zone->SetFilledPolysList( marker );
+        }
+    }
+
+    bool isRefilled( ZONE_CONTAINER* aZone ) const
+    {
+        const SHAPE_POLY_SET& fill = aZone->GetFilledPolysList();
+
+        return aZone->IsFilled()
+               && !( fill.OutlineCount() == 1 && fill.COutline( 0 ).CPoint( 0 ) == s_marker );
+    }
+
+    static const VECTOR2I  s_marker;
+
+    std::unique_ptr<BOARD> m_board;
+    ZONE_CONTAINER*        m_gnd;
+    ZONE_CONTAINER*        m_vcc;
+    MODULE*                m_module;
+    TRACK*                 m_track;
+    TEXTE_PCB*             m_text;
+};
+
+
+const VECTOR2I ZONE_FILLER_INCREMENTAL_FIXTURE::s_marker( -1000, -1000 );
+
+
+BOOST_FIXTURE_TEST_SUITE( ZoneFillerIncremental, ZONE_FILLER_INCREMENTAL_FIXTURE )
+
+
+/**
+ * Nothing changed: no zone is refilled
+ */
+BOOST_AUTO_TEST_CASE( NoChange )
+{
+    markFills();
+    fill();
+
+    BOOST_CHECK( !isRefilled( m_gnd ) );
+    BOOST_CHECK( !isRefilled( m_vcc ) );
+}
+
+
+/**
+ * Moving a footprint or a track of another net, far from the zones, refills none of them
+ */
+BOOST_AUTO_TEST_CASE( UnrelatedChange )
+{
+    markFills();
+
+    m_module->Move( wxPoint( Millimeter2iu( 5 ), Millimeter2iu( 5 ) ) );
+    m_module->SetOrientation( 900 );
+    m_track->Move( wxPoint( Millimeter2iu( 5 ), 0 ) );
+    fill();
+
+    BOOST_CHECK( !isRefilled( m_gnd ) );
+    BOOST_CHECK( !isRefilled( m_vcc ) );
+}
+
+
+/**
+ * A track moved into a zone refills this zone only
+ */
+BOOST_AUTO_TEST_CASE( TrackMovedNear )
+{
+    markFills();
+
+    m_track->Move( wxPoint( Millimeter2iu( -145 ), Millimeter2iu( -110 ) ) );
+    fill();
+
+    BOOST_CHECK( isRefilled( m_gnd ) );
+    BOOST_CHECK( !isRefilled( m_vcc ) );
+}
+
+
+/**
+ * A pad moved into a zone refills this zone only
+ */
+BOOST_AUTO_TEST_CASE( PadMovedNear )
+{
+    markFills();
+
+    m_module->Move( wxPoint( Millimeter2iu( -90 ), Millimeter2iu( -90 ) ) );
+    fill();
+
+    BOOST_CHECK( !isRefilled( m_gnd ) );
+    BOOST_CHECK( isRefilled( m_vcc ) );
+}
+
+
+/**
+ * Changing the net of a zone refills it
+ */
+BOOST_AUTO_TEST_CASE( ZoneNetChanged )
+{
+    markFills();
+
+    m_gnd->SetNetCode( 3 );
+    fill();
+
+    BOOST_CHECK( isRefilled( m_gnd ) );
+    BOOST_CHECK( !isRefilled( m_vcc ) );
+}
+
+
+/**
+ * Changing the content or the thickness of a text refills the zone it is in, even when its
+ * bounding box does not change
+ */
+BOOST_AUTO_TEST_CASE( TextChanged )
+{
+    // The width of the box of a multiline text is the width of its first line
+    m_text->SetText( wxT( "AB\nCD" ) );
+    fill();
+
+    const EDA_RECT box = m_text->GetTextBox( -1 );
+
+    markFills();
+
+    m_text->SetText( wxT( "AB\nXY" ) );
+    BOOST_REQUIRE( m_text->GetTextBox( -1 ).GetOrigin() == box.GetOrigin() );
+    BOOST_REQUIRE( m_text->GetTextBox( -1 ).GetSize() == box.GetSize() );
+    fill();
+
+    BOOST_CHECK( isRefilled( m_gnd ) );
+    BOOST_CHECK( !isRefilled( m_vcc ) );
+
+    markFills();
+
+    m_text->SetThickness( m_text->GetThickness() + 1 );
+    fill();
+
+    BOOST_CHECK( isRefilled( m_gnd ) );
+    BOOST_CHECK( !isRefilled( m_vcc ) );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
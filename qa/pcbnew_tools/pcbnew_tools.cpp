@@ -23,6 +23,7 @@
 
 #include <qa_utils/utility_program.h>
 
+#include "tools/connectivity_benchmark/connectivity_benchmark.h"
 #include "tools/drc_tool/drc_tool.h"
 #include "tools/pcb_parser/pcb_parser_tool.h"
 #include "tools/polygon_generator/polygon_generator.h"
@@ -35,6 +36,7 @@
  * it's effective enough. When you have a new tool, add it to this list.
  */
 const static std::vector<KI_TEST::UTILITY_PROGRAM*> known_tools = {
+    &connectivity_benchmark_tool,
     &drc_tool,
     &pcb_parser_tool,
     &polygon_generator_tool,
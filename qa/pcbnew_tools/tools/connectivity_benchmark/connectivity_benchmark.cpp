@@ -0,0 +1,147 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include "connectivity_benchmark.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <class_board.h>
+#include <class_track.h>
+#include <connectivity/connectivity_data.h>
+#include <convert_to_biu.h>
+#include <profile.h>
+
+
+enum CONN_BENCH_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    NO_TRACKS,
+};
+
+
+/**
+ * Move a track, as an interactive drag would, and update the connectivity and the ratsnest
+ * like a commit does.
+ *
+ * @return the time of the update, in milliseconds
+ */
+static double moveTrack( BOARD& aBoard, TRACK* aTrack, const wxPoint& aOffset )
+{
+    auto connectivity = aBoard.GetConnectivity();
+
+    aTrack->Move( aOffset );
+
+    PROF_COUNTER update( "update" );
+
+    connectivity->Update( aTrack );
+    connectivity->RecalculateRatsnest();
+
+    update.Stop();
+
+    return update.msecs();
+}
+
+
+static void printLatencies( const char* aName, std::vector<double>& aLatencies )
+{
+    std::sort( aLatencies.begin(), aLatencies.end() );
+
+    double total = 0.0;
+
+    for( double latency : aLatencies )
+        total += latency;
+
+    printf( "%-12s mean %8.3f ms  median %8.3f ms  p99 %8.3f ms  max %8.3f ms\n", aName,
+            total / aLatencies.size(), aLatencies[aLatencies.size() / 2],
+            aLatencies[std::min( aLatencies.size() - 1, aLatencies.size() * 99 / 100 )],
+            aLatencies.back() );
+}
+
+
+int connectivity_benchmark_main( int argc, char *argv[] )
+{
+    std::string filename;
+    int         editCount = 200;
+
+    if( argc > 1 )
+        filename = argv[1];
+
+    if( argc > 2 )
+        editCount = std::max( 1, atoi( argv[2] ) );
+
+    auto brd = KI_TEST::ReadBoardFromFileOrStream( filename );
+
+    if( !brd )
+        return CONN_BENCH_RET_CODES::LOAD_FAILED;
+
+    std::vector<TRACK*> tracks;
+
+    for( auto track : brd->Tracks() )
+        tracks.push_back( track );
+
+    if( tracks.empty() )
+        return CONN_BENCH_RET_CODES::NO_TRACKS;
+
+    PROF_COUNTER build( "build" );
+    brd->BuildConnectivity();
+    build.Stop();
+
+    printf( "%u nets, %zu tracks and vias: full build %.3f ms\n", brd->GetNetCount(),
+            tracks.size(), build.msecs() );
+
+    // Edit tracks spread over the whole board, each one is moved away and back
+    std::vector<double> moves;
+    std::vector<double> restores;
+    const wxPoint       offset( Millimeter2iu( 0.5 ), Millimeter2iu( 0.5 ) );
+    const size_t        stride = std::max<size_t>( 1, tracks.size() / editCount );
+
+    for( int ii = 0; ii < editCount; ++ii )
+    {
+        TRACK* track = tracks[( ii * stride ) % tracks.size()];
+
+        moves.push_back( moveTrack( *brd, track, offset ) );
+        restores.push_back( moveTrack( *brd, track, -offset ) );
+    }
+
+    printf( "%d edits:\n", editCount );
+    printLatencies( "move", moves );
+    printLatencies( "move back", restores );
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+/*
+ * Define the tool interface
+ */
+KI_TEST::UTILITY_PROGRAM connectivity_benchmark_tool = {
+    "connectivity_benchmark",
+    "Measure the latency of the incremental connectivity updates on a PCB",
+    connectivity_benchmark_main,
+};
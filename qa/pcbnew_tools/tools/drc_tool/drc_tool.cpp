@@ -23,6 +23,7 @@
 
 #include "drc_tool.h"
 
+#include <algorithm>
 #include <cstdio>
 #include <string>
 
@@ -59,6 +60,7 @@ public:
         bool m_verbose;
         bool m_print_times;
         bool m_print_markers;
+        int  m_repeat;          ///< how many times to run the DRC, for more stable timings
     };
 
     DRC_RUNNER( const EXECUTION_CONTEXT& aExecCtx ) : m_exec_context( aExecCtx )
@@ -82,15 +84,25 @@ public:
 
         std::unique_ptr<DRC_PROVIDER> drc_prov = createDrcProvider( aBoard, marker_handler );
 
-        DRC_DURATION duration;
+        std::vector<DRC_DURATION> durations;
+
+        for( int ii = 0; ii < std::max( m_exec_context.m_repeat, 1 ); ii++ )
         {
-            SCOPED_TIMER<DRC_DURATION> timer( duration );
-            drc_prov->RunDRC( aBoard );
+            // Only keep the markers of the last run
+            markers.clear();
+
+            DRC_DURATION duration;
+            {
+                SCOPED_TIMER<DRC_DURATION> timer( duration );
+                drc_prov->RunDRC( aBoard );
+            }
+
+            durations.push_back( duration );
         }
 
         // report results
         if( m_exec_context.m_print_times )
-            reportDuration( duration );
+            reportDurations( durations );
 
         if( m_exec_context.m_print_markers )
             reportMarkers( markers );
@@ -116,9 +128,24 @@ private:
     virtual std::unique_ptr<DRC_PROVIDER> createDrcProvider(
             BOARD& aBoard, DRC_PROVIDER::MARKER_HANDLER aHandler ) = 0;
 
-    void reportDuration( const DRC_DURATION& aDuration ) const
+    void reportDurations( const std::vector<DRC_DURATION>& aDurations ) const
     {
-        std::cout << "Took: " << aDuration.count() << "us" << std::endl;
+        if( aDurations.size() == 1 )
+        {
+            std::cout << "Took: " << aDurations[0].count() << "us" << std::endl;
+            return;
+        }
+
+        DRC_DURATION total( 0 );
+
+        for( const auto& duration : aDurations )
+            total += duration;
+
+        std::cout << "Runs: " << aDurations.size() << ", min: "
+                  << std::min_element( aDurations.begin(), aDurations.end() )->count()
+                  << "us, mean: " << total.count() / aDurations.size() << "us, max: "
+                  << std::max_element( aDurations.begin(), aDurations.end() )->count() << "us"
+                  << std::endl;
     }
 
     void reportMarkers( const std::vector<std::unique_ptr<MARKER_PCB>>& aMarkers ) const
@@ -229,6 +256,14 @@ static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
             "timings",
             _( "print DRC timings" ).mb_str(),
     },
+    {
+            wxCMD_LINE_OPTION,
+            "r",
+            "repeat",
+            _( "run each DRC check N times, and print the timings of the runs (default 1)" )
+                    .mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
     {
             wxCMD_LINE_SWITCH,
             "m",
@@ -307,10 +342,14 @@ int drc_main_func( int argc, char** argv )
     if( !board )
         return PARSER_RET_CODES::PARSE_FAILED;
 
+    long repeat = 1;
+    cl_parser.Found( "repeat", &repeat );
+
     DRC_RUNNER::EXECUTION_CONTEXT exec_context{
         verbose,
         cl_parser.Found( "timings" ),
         cl_parser.Found( "print-markers" ),
+        static_cast<int>( repeat ),
     };
 
     const bool all = cl_parser.Found( "all-checks" );
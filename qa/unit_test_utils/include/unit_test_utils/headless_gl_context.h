@@ -0,0 +1,139 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file headless_gl_context.h
+ * A headless openGL context for the tests of the openGL renders. The test executables
+ * including it have to link EGL.
+ */
+
+#ifndef UNIT_TEST_UTILS_HEADLESS_GL_CONTEXT__H
+#define UNIT_TEST_UTILS_HEADLESS_GL_CONTEXT__H
+
+#include <GL/glew.h>    // Must be included first
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+
+/**
+ * A headless openGL context: a square pixel buffer of a Mesa (or any other EGL) display, so
+ * that the openGL renders can be run without a window.
+ */
+struct HEADLESS_GL_CONTEXT
+{
+    /**
+     * @param aSize is the width and the height of the pixel buffer.
+     */
+    HEADLESS_GL_CONTEXT( int aSize ) :
+        m_display( EGL_NO_DISPLAY ),
+        m_surface( EGL_NO_SURFACE ),
+        m_context( EGL_NO_CONTEXT ),
+        m_current( false )
+    {
+        m_display = getDisplay();
+
+        if( m_display == EGL_NO_DISPLAY || !eglInitialize( m_display, nullptr, nullptr ) )
+        {
+            m_display = EGL_NO_DISPLAY;
+            return;
+        }
+
+        const EGLint configAttribs[] = {
+            EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+            EGL_RED_SIZE, 8,
+            EGL_GREEN_SIZE, 8,
+            EGL_BLUE_SIZE, 8,
+            EGL_DEPTH_SIZE, 16,
+            EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+            EGL_NONE
+        };
+
+        const EGLint surfaceAttribs[] = { EGL_WIDTH, aSize, EGL_HEIGHT, aSize, EGL_NONE };
+
+        EGLConfig config;
+        EGLint    configCount = 0;
+
+        if( !eglChooseConfig( m_display, configAttribs, &config, 1, &configCount )
+                || configCount == 0 || !eglBindAPI( EGL_OPENGL_API ) )
+            return;
+
+        m_surface = eglCreatePbufferSurface( m_display, config, surfaceAttribs );
+        m_context = eglCreateContext( m_display, config, EGL_NO_CONTEXT, nullptr );
+
+        if( m_surface == EGL_NO_SURFACE || m_context == EGL_NO_CONTEXT )
+            return;
+
+        m_current = eglMakeCurrent( m_display, m_surface, m_surface, m_context );
+
+        // GLEW may not find its functions in an EGL context (i.e.: if it is built for GLX):
+        // the tests have to check the extensions they need
+        if( m_current )
+            glewInit();
+    }
+
+    ~HEADLESS_GL_CONTEXT()
+    {
+        if( m_display == EGL_NO_DISPLAY )
+            return;
+
+        eglMakeCurrent( m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT );
+
+        if( m_context != EGL_NO_CONTEXT )
+            eglDestroyContext( m_display, m_context );
+
+        if( m_surface != EGL_NO_SURFACE )
+            eglDestroySurface( m_display, m_surface );
+
+        eglTerminate( m_display );
+    }
+
+    /**
+     * Get the display without a window system if the driver can (Mesa's surfaceless
+     * platform), or else the default one
+     */
+    static EGLDisplay getDisplay()
+    {
+#ifdef EGL_PLATFORM_SURFACELESS_MESA
+        auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+                eglGetProcAddress( "eglGetPlatformDisplayEXT" ) );
+
+        if( getPlatformDisplay )
+        {
+            EGLDisplay display = getPlatformDisplay( EGL_PLATFORM_SURFACELESS_MESA,
+                                                     EGL_DEFAULT_DISPLAY, nullptr );
+
+            if( display != EGL_NO_DISPLAY )
+                return display;
+        }
+#endif
+
+        return eglGetDisplay( EGL_DEFAULT_DISPLAY );
+    }
+
+    EGLDisplay m_display;
+    EGLSurface m_surface;
+    EGLContext m_context;
+    bool       m_current;
+};
+
+#endif // UNIT_TEST_UTILS_HEADLESS_GL_CONTEXT__H
@@ -0,0 +1,94 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file plotting.h
+ * Test helpers for the plotters.
+ *
+ * This header is only usable by tests linking the plotters (i.e. libcommon).
+ */
+
+#ifndef PLOTTING__H
+#define PLOTTING__H
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <string>
+
+#include <wx/ffile.h>
+#include <wx/filename.h>
+
+#include <plotter.h>
+
+namespace KI_TEST
+{
+
+/**
+ * A fixture for plotting to a temporary file, which is removed at the end of the test,
+ * and checking the content of the file.
+ */
+struct TEMP_FILE_PLOTTER_FIXTURE
+{
+    /**
+     * @param aPrefix the prefix of the name of the temporary file
+     */
+    TEMP_FILE_PLOTTER_FIXTURE( const wxString& aPrefix )
+    {
+        m_fileName = wxFileName::CreateTempFileName( aPrefix );
+    }
+
+    ~TEMP_FILE_PLOTTER_FIXTURE()
+    {
+        wxRemoveFile( m_fileName );
+    }
+
+    /**
+     * Open the temporary file with a plotter, and start the plot
+     */
+    void StartPlot( PLOTTER& aPlotter )
+    {
+        BOOST_REQUIRE( aPlotter.OpenFile( m_fileName ) );
+        BOOST_REQUIRE( aPlotter.StartPlot() );
+    }
+
+    /**
+     * End the plot, and return the content of the file
+     */
+    std::string EndPlot( PLOTTER& aPlotter )
+    {
+        aPlotter.EndPlot();
+
+        wxFFile     file( m_fileName, wxT( "rb" ) );
+        std::string text( file.Length(), '\0' );
+
+        BOOST_REQUIRE_EQUAL( file.Read( &text[0], text.size() ), text.size() );
+
+        return text;
+    }
+
+    wxString m_fileName;
+};
+
+} // namespace KI_TEST
+
+#endif // PLOTTING__H
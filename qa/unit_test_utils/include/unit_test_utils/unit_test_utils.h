@@ -29,6 +29,7 @@
 
 #include <functional>
 #include <set>
+#include <string>
 
 /**
  * If HAVE_EXPECTED_FAILURES is defined, this means that
@@ -251,6 +252,19 @@ std::string InOutString( const IN& aIn, const OUT& aOut )
     return ss.str();
 }
 
+
+/**
+ * Count the occurrences of a pattern in a text, which do not overlap.
+ *
+ * Useful for checking the content of files written by the code under test,
+ * without parsing them.
+ *
+ * @param  aText    the text to search
+ * @param  aPattern the pattern to count
+ * @return          the number of occurrences of aPattern in aText
+ */
+int CountOf( const std::string& aText, const std::string& aPattern );
+
 } // namespace KI_TEST
 
 #endif // UNIT_TEST_UTILS__H
\ No newline at end of file
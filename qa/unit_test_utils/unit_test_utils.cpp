@@ -21,6 +21,18 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
-/*
- * Nothing here yet, but CMake requires *something*.
- */
\ No newline at end of file
+#include <unit_test_utils/unit_test_utils.h>
+
+
+int KI_TEST::CountOf( const std::string& aText, const std::string& aPattern )
+{
+    int count = 0;
+
+    for( size_t pos = aText.find( aPattern ); pos != std::string::npos;
+         pos = aText.find( aPattern, pos + aPattern.size() ) )
+    {
+        count++;
+    }
+
+    return count;
+}
\ No newline at end of file